@@ -0,0 +1,179 @@
+/**
+ * @file bench_bus.cpp
+ * @brief SPI, I2C and serial transaction benchmarks
+ *
+ * SPI runs on /dev/spidev0.0 (nothing needs to be connected; MISO reads
+ * back whatever floats). I2C needs a device at PIPINPP_BENCH_I2C_ADDR.
+ * Serial writes to PIPINPP_BENCH_SERIAL at 115200 baud. The framing
+ * benchmarks need no hardware.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "SPI.hpp"
+#include "Serial.hpp"
+#include "Wire.hpp"
+#include "serial_framing.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+// ============================================================================
+// SPI
+// ============================================================================
+
+bool beginSpi(benchmark::State& state) {
+    if (!SPI.begin()) {
+        state.SkipWithError("SPI.begin() failed; is /dev/spidev0.0 enabled?");
+        return false;
+    }
+    return true;
+}
+
+void BM_SpiTransferByte(benchmark::State& state) {
+    if (!beginSpi(state)) {
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SPI.transfer(0xA5));
+    }
+    SPI.end();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpiTransferByte);
+
+void BM_SpiTransferBuffer(benchmark::State& state) {
+    if (!beginSpi(state)) {
+        return;
+    }
+    const size_t length = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> tx(length, 0xA5);
+    std::vector<uint8_t> rx(length);
+    for (auto _ : state) {
+        SPI.transfer(tx.data(), rx.data(), length);
+        benchmark::ClobberMemory();
+    }
+    SPI.end();
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(length));
+}
+BENCHMARK(BM_SpiTransferBuffer)->RangeMultiplier(8)->Range(8, 4096);
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+bool beginWire(benchmark::State& state) {
+    if (!Wire.begin()) {
+        state.SkipWithError("Wire.begin() failed; is I2C enabled?");
+        return false;
+    }
+    if (!Wire.exists(static_cast<uint8_t>(bench::i2cAddress()))) {
+        Wire.end();
+        state.SkipWithError("No device at PIPINPP_BENCH_I2C_ADDR");
+        return false;
+    }
+    return true;
+}
+
+void BM_I2cReadRegister(benchmark::State& state) {
+    if (!beginWire(state)) {
+        return;
+    }
+    const uint8_t address = static_cast<uint8_t>(bench::i2cAddress());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Wire.readRegister(address, 0x00));
+    }
+    Wire.end();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_I2cReadRegister);
+
+// Several register reads in one I2C_RDWR ioctl vs. one ioctl each above
+void BM_I2cBatchedReads(benchmark::State& state) {
+    if (!beginWire(state)) {
+        return;
+    }
+    const uint8_t address = static_cast<uint8_t>(bench::i2cAddress());
+    const int reads = static_cast<int>(state.range(0));
+    std::vector<uint8_t> values(static_cast<size_t>(reads));
+    WireBatch batch;
+    for (auto _ : state) {
+        batch.clear();
+        for (int i = 0; i < reads; ++i) {
+            batch.readRegister(address, static_cast<uint8_t>(i), &values[static_cast<size_t>(i)]);
+        }
+        benchmark::DoNotOptimize(Wire.transfer(batch));
+    }
+    Wire.end();
+    state.SetItemsProcessed(state.iterations() * reads);
+}
+BENCHMARK(BM_I2cBatchedReads)->Arg(2)->Arg(8);
+
+// ============================================================================
+// Serial
+// ============================================================================
+
+void BM_SerialWrite(benchmark::State& state) {
+    if (!Serial.begin(115200, bench::serialDevice())) {
+        state.SkipWithError("Serial.begin() failed; set PIPINPP_BENCH_SERIAL");
+        return;
+    }
+    const size_t length = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> data(length, 'U');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Serial.write(data.data(), length));
+    }
+    Serial.end();
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(length));
+}
+BENCHMARK(BM_SerialWrite)->Arg(1)->Arg(64)->Arg(1024);
+
+// ============================================================================
+// Framing (no hardware)
+// ============================================================================
+
+void BM_FrameEncode(benchmark::State& state, FrameEncoding encoding) {
+    const size_t length = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> payload(length);
+    for (size_t i = 0; i < length; ++i) {
+        payload[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<uint8_t> out(maxEncodedFrameSize(encoding, FrameCrc::CRC16, length));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            encodeFrame(encoding, FrameCrc::CRC16, payload.data(), length, out.data(), out.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(length));
+}
+BENCHMARK_CAPTURE(BM_FrameEncode, cobs, FrameEncoding::COBS)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(BM_FrameEncode, slip, FrameEncoding::SLIP)->Arg(64)->Arg(1024);
+
+void BM_FrameDecode(benchmark::State& state, FrameEncoding encoding) {
+    const size_t length = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> payload(length);
+    for (size_t i = 0; i < length; ++i) {
+        payload[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<uint8_t> encoded(maxEncodedFrameSize(encoding, FrameCrc::CRC16, length));
+    encoded.resize(encodeFrame(encoding, FrameCrc::CRC16, payload.data(), length,
+                               encoded.data(), encoded.size()));
+
+    FrameDecoder decoder(encoding, FrameCrc::CRC16);
+    size_t frames = 0;
+    decoder.setCallback([&frames](FrameView) { ++frames; });
+    for (auto _ : state) {
+        decoder.feed(encoded.data(), encoded.size());
+    }
+    benchmark::DoNotOptimize(frames);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(length));
+}
+BENCHMARK_CAPTURE(BM_FrameDecode, cobs, FrameEncoding::COBS)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(BM_FrameDecode, slip, FrameEncoding::SLIP)->Arg(64)->Arg(1024);
+
+} // namespace
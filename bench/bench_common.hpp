@@ -0,0 +1,64 @@
+/**
+ * @file bench_common.hpp
+ * @brief Shared configuration for the Google Benchmark suite
+ *
+ * Hardware benchmarks read their wiring from the environment so the same
+ * binary runs on any board:
+ *
+ * | Variable                  | Default        | Used by                     |
+ * |---------------------------|----------------|-----------------------------|
+ * | PIPINPP_BENCH_CHIP        | gpiochip0      | Every GPIO benchmark        |
+ * | PIPINPP_BENCH_PIN         | 22             | Pin / digitalWrite          |
+ * | PIPINPP_BENCH_PWM_PIN     | 23             | PWM (and the next 3 pins)   |
+ * | PIPINPP_BENCH_LOOP_OUT    | 17             | Interrupt round trip output |
+ * | PIPINPP_BENCH_LOOP_IN     | 27             | Interrupt round trip input  |
+ * | PIPINPP_BENCH_I2C_ADDR    | 0x76           | I2C transactions            |
+ * | PIPINPP_BENCH_SERIAL      | /dev/ttyUSB0   | Serial throughput           |
+ * | PIPINPP_BENCH_SIM         | 0              | 1 = simulated hardware      |
+ *
+ * A benchmark whose hardware is missing reports an error and the rest of
+ * the suite carries on. PIPINPP_BENCH_SIM=1 supplies GPIO, SPI and I2C
+ * from SimulatedHardware (see bench_sim.cpp).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <string>
+
+namespace pipinpp {
+namespace bench {
+
+/**
+ * @brief Integer from the environment (decimal or 0x hex), or @p fallback
+ */
+inline int envInt(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    if (value == nullptr || *value == '\0') {
+        return fallback;
+    }
+    return static_cast<int>(std::strtol(value, nullptr, 0));
+}
+
+/**
+ * @brief String from the environment, or @p fallback
+ */
+inline std::string envString(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return (value == nullptr || *value == '\0') ? fallback : std::string(value);
+}
+
+inline std::string chip() { return envString("PIPINPP_BENCH_CHIP", "gpiochip0"); }
+// Not a loopback pin: digitalWrite() keeps its line requested until exit
+inline int outputPin() { return envInt("PIPINPP_BENCH_PIN", 22); }
+inline int pwmPin() { return envInt("PIPINPP_BENCH_PWM_PIN", 23); }
+inline int loopbackOut() { return envInt("PIPINPP_BENCH_LOOP_OUT", 17); }
+inline int loopbackIn() { return envInt("PIPINPP_BENCH_LOOP_IN", 27); }
+inline int i2cAddress() { return envInt("PIPINPP_BENCH_I2C_ADDR", 0x76); }
+inline std::string serialDevice() { return envString("PIPINPP_BENCH_SERIAL", "/dev/ttyUSB0"); }
+
+} // namespace bench
+} // namespace pipinpp
@@ -0,0 +1,110 @@
+/**
+ * @file bench_gpio.cpp
+ * @brief Pin, digitalWrite()/digitalRead() and timebase benchmarks
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "ArduinoCompat.hpp"
+#include "pin.hpp"
+#include <exception>
+#include <memory>
+
+using namespace pipinpp;
+
+namespace {
+
+/**
+ * @brief Output pin for one benchmark run, or nullptr after reporting why not
+ */
+std::unique_ptr<Pin> openPin(benchmark::State& state, PinDirection direction, PinBackend backend) {
+    try {
+        return std::make_unique<Pin>(bench::outputPin(), direction, bench::chip(), backend);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return nullptr;
+    }
+}
+
+void BM_PinWrite(benchmark::State& state, PinBackend backend) {
+    auto pin = openPin(state, PinDirection::OUTPUT, backend);
+    if (!pin) {
+        return;
+    }
+    if (pin->getBackend() != backend) {
+        state.SetLabel("fell back to libgpiod");
+    }
+    bool value = false;
+    for (auto _ : state) {
+        value = !value;
+        benchmark::DoNotOptimize(pin->write(value));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_PinWrite, libgpiod, PinBackend::LIBGPIOD);
+BENCHMARK_CAPTURE(BM_PinWrite, gpiomem, PinBackend::GPIOMEM);
+
+void BM_PinRead(benchmark::State& state, PinBackend backend) {
+    auto pin = openPin(state, PinDirection::INPUT, backend);
+    if (!pin) {
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pin->read());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_PinRead, libgpiod, PinBackend::LIBGPIOD);
+BENCHMARK_CAPTURE(BM_PinRead, gpiomem, PinBackend::GPIOMEM);
+
+// digitalWrite()/digitalRead() add the pin table lookup and lock on top of Pin
+void BM_DigitalWrite(benchmark::State& state) {
+    const int pin = bench::outputPin();
+    try {
+        pinMode(pin, OUTPUT);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    bool value = false;
+    for (auto _ : state) {
+        value = !value;
+        digitalWrite(pin, value);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DigitalWrite);
+
+void BM_DigitalRead(benchmark::State& state) {
+    const int pin = bench::outputPin();
+    try {
+        pinMode(pin, INPUT);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(digitalRead(pin));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DigitalRead);
+
+void BM_Micros(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(micros());
+    }
+}
+BENCHMARK(BM_Micros);
+
+void BM_Millis(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(millis());
+    }
+}
+BENCHMARK(BM_Millis);
+
+} // namespace
@@ -0,0 +1,91 @@
+/**
+ * @file bench_interrupts.cpp
+ * @brief Interrupt round-trip benchmarks over a loopback wire
+ *
+ * Connect PIPINPP_BENCH_LOOP_OUT to PIPINPP_BENCH_LOOP_IN (GPIO17 to GPIO27
+ * by default). Each iteration toggles the output and waits for the
+ * callback on the input, so the reported time is write ioctl + kernel edge
+ * detection + monitor thread wakeup + dispatch.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "interrupts.hpp"
+#include "pin.hpp"
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <thread>
+
+using namespace pipinpp;
+
+namespace {
+
+constexpr auto EDGE_TIMEOUT = std::chrono::milliseconds(100);
+
+/**
+ * @brief Spin until @p seen moves past @p previous
+ * @return false on timeout
+ */
+bool waitForEdge(const std::atomic<uint64_t>& seen, uint64_t previous) {
+    const auto deadline = std::chrono::steady_clock::now() + EDGE_TIMEOUT;
+    while (seen.load(std::memory_order_acquire) == previous) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+template <typename Attach>
+void runRoundTrip(benchmark::State& state, Attach attach) {
+    std::atomic<uint64_t> edges{0};
+    std::unique_ptr<Pin> out;
+    try {
+        out = std::make_unique<Pin>(bench::loopbackOut(), PinDirection::OUTPUT, bench::chip());
+        out->write(false);
+        attach(edges);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+
+    bool value = false;
+    for (auto _ : state) {
+        const uint64_t before = edges.load(std::memory_order_acquire);
+        value = !value;
+        out->write(value);
+        if (!waitForEdge(edges, before)) {
+            state.SkipWithError("No edge seen; is the loopback wire connected?");
+            break;
+        }
+    }
+    InterruptManager::getInstance().detachInterrupt(bench::loopbackIn());
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_InterruptRoundTrip(benchmark::State& state) {
+    runRoundTrip(state, [](std::atomic<uint64_t>& edges) {
+        InterruptManager::getInstance().attachInterrupt(
+            bench::loopbackIn(), [&edges] { edges.fetch_add(1, std::memory_order_release); },
+            InterruptMode::CHANGE, bench::chip());
+    });
+}
+BENCHMARK(BM_InterruptRoundTrip)->UseRealTime();
+
+void BM_InterruptRoundTripBatch(benchmark::State& state) {
+    runRoundTrip(state, [](std::atomic<uint64_t>& edges) {
+        InterruptManager::getInstance().attachInterruptBatch(
+            bench::loopbackIn(),
+            [&edges](EdgeEventSpan events) { edges.fetch_add(events.size(), std::memory_order_release); },
+            InterruptMode::CHANGE, DEFAULT_EVENT_BUFFER_SIZE, bench::chip());
+    });
+}
+BENCHMARK(BM_InterruptRoundTripBatch)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,136 @@
+/**
+ * @file bench_pwm.cpp
+ * @brief Software PWM scheduler benchmarks
+ *
+ * Update cost of PWMManager (map lookup + lock vs. PWMChannelHandle) and
+ * EventPWMManager, backend selection, and with PIPINPP_ENABLE_METRICS the
+ * edge lateness of the EventPWM timer thread under load.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "event_pwm.hpp"
+#include "metrics.hpp"
+#include "pwm.hpp"
+#include "pwm_backend.hpp"
+#include "pwm_timing.hpp"
+#include <chrono>
+#include <exception>
+#include <thread>
+
+using namespace pipinpp;
+
+namespace {
+
+void BM_PwmTimingFromDuty(benchmark::State& state) {
+    int duty = 0;
+    for (auto _ : state) {
+        duty = (duty + 1) & 0xFF;
+        benchmark::DoNotOptimize(PwmTiming::fromDuty8Bit(490, duty));
+    }
+}
+BENCHMARK(BM_PwmTimingFromDuty);
+
+void BM_PwmRouterSelect(benchmark::State& state) {
+    const int pin = bench::pwmPin();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PwmRouter::getInstance().select(pin, 490));
+    }
+}
+BENCHMARK(BM_PwmRouterSelect);
+
+void BM_PwmManagerSetDuty(benchmark::State& state) {
+    const int pin = bench::pwmPin();
+    auto& pwm = PWMManager::getInstance();
+    try {
+        pwm.startPWM(pin, 50);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    int duty = 0;
+    for (auto _ : state) {
+        duty = (duty + 1) % 101;
+        benchmark::DoNotOptimize(pwm.setDutyCycle(pin, duty));
+    }
+    pwm.stopPWM(pin);
+}
+BENCHMARK(BM_PwmManagerSetDuty);
+
+void BM_PwmChannelHandleSetDuty(benchmark::State& state) {
+    const int pin = bench::pwmPin();
+    auto& pwm = PWMManager::getInstance();
+    try {
+        pwm.startPWM(pin, 50);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    PWMChannelHandle channel = pwm.channel(pin);
+    int duty = 0;
+    for (auto _ : state) {
+        duty = (duty + 1) % 101;
+        benchmark::DoNotOptimize(channel.setDutyCycle(duty));
+    }
+    pwm.stopPWM(pin);
+}
+BENCHMARK(BM_PwmChannelHandleSetDuty);
+
+void BM_EventPwmUpdate(benchmark::State& state) {
+    const int pin = bench::pwmPin();
+    auto& pwm = EventPWMManager::getInstance();
+    try {
+        pwm.analogWriteEvent(pin, 128);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    int value = 1;
+    for (auto _ : state) {
+        value = (value % 254) + 1;
+        pwm.analogWriteEvent(pin, value);
+    }
+    pwm.stopPWM(pin);
+}
+BENCHMARK(BM_EventPwmUpdate);
+
+/**
+ * @brief Edge lateness of the EventPWM timer thread with range(0) channels at 1 kHz
+ */
+void BM_EventPwmLateness(benchmark::State& state) {
+    if (!metrics::instrumentationEnabled()) {
+        state.SkipWithError("Needs -DPIPINPP_ENABLE_METRICS=ON");
+        return;
+    }
+    const int channels = static_cast<int>(state.range(0));
+    const int firstPin = bench::pwmPin();
+    auto& pwm = EventPWMManager::getInstance();
+    for (auto _ : state) {
+        metrics::histogram("pwm_edge_lateness_ns").reset();
+        try {
+            for (int i = 0; i < channels; ++i) {
+                pwm.analogWriteEvent(firstPin + i, 128, 1000);
+            }
+        } catch (const std::exception& e) {
+            state.SkipWithError(e.what());
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        for (int i = 0; i < channels; ++i) {
+            pwm.stopPWM(firstPin + i);
+        }
+    }
+    const auto snap = metrics::snapshot();
+    if (const auto* lateness = snap.findHistogram("pwm_edge_lateness_ns")) {
+        state.counters["edges"] = static_cast<double>(lateness->count);
+        state.counters["p50_ns"] = static_cast<double>(lateness->quantile(0.5));
+        state.counters["p99_ns"] = static_cast<double>(lateness->quantile(0.99));
+        state.counters["max_ns"] = static_cast<double>(lateness->max);
+    }
+}
+BENCHMARK(BM_EventPwmLateness)->Arg(1)->Arg(4)->Iterations(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
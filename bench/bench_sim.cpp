@@ -0,0 +1,37 @@
+/**
+ * @file bench_sim.cpp
+ * @brief Optional simulated hardware for running the suite without a Pi
+ *
+ * With PIPINPP_BENCH_SIM=1 the suite runs against SimulatedHardware: the
+ * loopback pins are connected, /dev/spidev0.0 echoes and a register-file
+ * device sits at PIPINPP_BENCH_I2C_ADDR on /dev/i2c-1. Results then show
+ * library overhead only (no ioctl, no kernel), which is what CI on x86
+ * should compare between commits.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+#include "sim_backend.hpp"
+#include <cstdint>
+
+namespace {
+
+struct SimulatedBench {
+    SimulatedBench() {
+        if (pipinpp::bench::envInt("PIPINPP_BENCH_SIM", 0) == 0) {
+            return;
+        }
+        auto& sim = pipinpp::SimulatedHardware::getInstance();
+        sim.install();
+        sim.connect(pipinpp::bench::loopbackOut(), pipinpp::bench::loopbackIn());
+        sim.addSpiDevice(0, 0);
+        sim.addI2cDevice(1, static_cast<uint8_t>(pipinpp::bench::i2cAddress()));
+    }
+};
+
+// Installed before main() so every benchmark sees it
+const SimulatedBench simulatedBench;
+
+} // namespace
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""
+asyncio Example - Edges and a heartbeat in one event loop
+
+Prints the period of a signal on GPIO17 while a second task blinks an
+LED on GPIO18, without threads: edges wake the loop through an eventfd.
+
+Hardware:
+- Signal source (function generator, button, another pin) on GPIO17
+- LED + resistor on GPIO18
+"""
+
+import asyncio
+import pypipinpp as gpio
+from pypipinpp_asyncio import AsyncEdgeQueue
+
+SIGNAL_PIN = 17
+LED_PIN = 18
+
+
+async def measure():
+    queue = AsyncEdgeQueue()
+    queue.attach(SIGNAL_PIN, gpio.RISING)
+    last_ns = None
+    try:
+        async for pin, level, timestamp_ns, seqno in queue:
+            if last_ns is not None:
+                period_us = (timestamp_ns - last_ns) / 1000
+                print(f"GPIO{pin} period: {period_us:.1f} us")
+            last_ns = timestamp_ns
+    finally:
+        queue.close()
+
+
+async def heartbeat():
+    gpio.pinMode(LED_PIN, gpio.OUTPUT)
+    while True:
+        gpio.digitalToggle(LED_PIN)
+        await asyncio.sleep(0.5)
+
+
+async def main():
+    await asyncio.gather(measure(), heartbeat())
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        print("\nStopped")
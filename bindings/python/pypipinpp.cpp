@@ -38,6 +38,8 @@
 #include "pwm.hpp"
 #include "exceptions.hpp"
 #include "platform.hpp"
+#include "capture.hpp"
+#include "edge_queue.hpp"
 #include <map>
 #include <memory>
 
@@ -46,10 +48,75 @@ namespace py = pybind11;
 // Global map to store Python callbacks for interrupts (keeps them alive)
 static std::map<int, std::shared_ptr<py::function>> g_interrupt_callbacks;
 
+// Blocking calls (ioctls, UART waits, sleeps) drop the GIL so other Python
+// threads and interrupt callbacks run during the I/O
+using release_gil = py::call_guard<py::gil_scoped_release>;
+
+/**
+ * Contiguous bytes of any buffer-protocol object (bytes, bytearray,
+ * memoryview, array.array, numpy arrays). The view pins the memory until
+ * destroyed, so it can be used with the GIL released; destroy it with the
+ * GIL held.
+ */
+class ByteBuffer {
+public:
+    ByteBuffer(const py::buffer& object, bool writable) {
+        const int flags = PyBUF_C_CONTIGUOUS | (writable ? PyBUF_WRITABLE : 0);
+        if (PyObject_GetBuffer(object.ptr(), &view_, flags) != 0) {
+            throw py::error_already_set();
+        }
+    }
+    ~ByteBuffer() { PyBuffer_Release(&view_); }
+
+    ByteBuffer(const ByteBuffer&) = delete;
+    ByteBuffer& operator=(const ByteBuffer&) = delete;
+
+    uint8_t* data() const { return static_cast<uint8_t*>(view_.buf); }
+    size_t size() const { return static_cast<size_t>(view_.len); }
+
+private:
+    Py_buffer view_;
+};
+
+/**
+ * Return @p length bytes produced by fill(uint8_t*, size_t) straight into
+ * a new bytes object, with the GIL released. fill returns the count
+ * produced (shorter results are trimmed) or a negative value, raised as
+ * OSError with @p error.
+ */
+template <typename Fill>
+static py::bytes fillBytes(size_t length, const char* error, Fill fill) {
+    py::bytes result(nullptr, length);
+    char* data = PyBytes_AS_STRING(result.ptr());
+    long count;
+    {
+        py::gil_scoped_release release;
+        count = static_cast<long>(fill(reinterpret_cast<uint8_t*>(data), length));
+    }
+    if (count < 0) {
+        PyErr_SetString(PyExc_OSError, error);
+        throw py::error_already_set();
+    }
+    if (static_cast<size_t>(count) < length) {
+        return py::bytes(data, static_cast<size_t>(count));
+    }
+    return result;
+}
+
+// Arduino RISING/FALLING/CHANGE constant -> InterruptMode
+static InterruptMode toInterruptMode(int mode) {
+    if (mode == RISING) {
+        return InterruptMode::RISING;
+    } else if (mode == FALLING) {
+        return InterruptMode::FALLING;
+    }
+    return InterruptMode::CHANGE;
+}
+
 // NOTE: Python interrupt support uses a workaround:
 // The Arduino attachInterrupt() expects void(*)() but we need to capture pin number.
 // Solution: Store callbacks in map above, and use low-level interrupt API directly
-// by including interrupts.hpp which provides: attachInterrupt(int, std::function<void()>, InterruptMode, string)
+// by including interrupts.hpp which provides: attachInterrupt(int, InterruptCallback, InterruptMode, string)
 
 PYBIND11_MODULE(pypipinpp, m) {
     m.doc() = "PiPinPP - Arduino-compatible GPIO library for Raspberry Pi (Python bindings)";
@@ -127,19 +194,19 @@ PYBIND11_MODULE(pypipinpp, m) {
     // DIGITAL I/O FUNCTIONS
     // ========================================================================
     
-    m.def("pinMode", &pinMode, 
+    m.def("pinMode", &pinMode, release_gil(),
           py::arg("pin"), py::arg("mode"),
           "Set the mode of a GPIO pin (OUTPUT, INPUT, INPUT_PULLUP, INPUT_PULLDOWN)");
     
-    m.def("digitalWrite", &digitalWrite,
+    m.def("digitalWrite", &digitalWrite, release_gil(),
           py::arg("pin"), py::arg("value"),
           "Write a digital value (HIGH or LOW) to a GPIO pin");
     
-    m.def("digitalRead", &digitalRead,
+    m.def("digitalRead", &digitalRead, release_gil(),
           py::arg("pin"),
           "Read the digital value from a GPIO pin (returns HIGH or LOW)");
     
-    m.def("digitalToggle", &digitalToggle,
+    m.def("digitalToggle", &digitalToggle, release_gil(),
           py::arg("pin"),
           "Toggle the state of an output pin (HIGH->LOW or LOW->HIGH)");
     
@@ -163,7 +230,7 @@ PYBIND11_MODULE(pypipinpp, m) {
     // ANALOG I/O FUNCTIONS (PWM)
     // ========================================================================
     
-    m.def("analogWrite", &analogWrite,
+    m.def("analogWrite", &analogWrite, release_gil(),
           py::arg("pin"), py::arg("value"),
           "Write an analog value (PWM) to a pin (0-255)");
     
@@ -171,11 +238,11 @@ PYBIND11_MODULE(pypipinpp, m) {
     // TIMING FUNCTIONS
     // ========================================================================
     
-    m.def("delay", &delay,
+    m.def("delay", &delay, release_gil(),
           py::arg("ms"),
           "Pause execution for specified milliseconds");
     
-    m.def("delayMicroseconds", &delayMicroseconds,
+    m.def("delayMicroseconds", &delayMicroseconds, release_gil(),
           py::arg("us"),
           "Pause execution for specified microseconds");
     
@@ -195,26 +262,25 @@ PYBIND11_MODULE(pypipinpp, m) {
               g_interrupt_callbacks[pin] = std::make_shared<py::function>(callback);
               
               // Convert mode constant to InterruptMode enum
-              InterruptMode intMode;
-              if (mode == RISING) {
-                  intMode = InterruptMode::RISING;
-              } else if (mode == FALLING) {
-                  intMode = InterruptMode::FALLING;
-              } else {
-                  intMode = InterruptMode::CHANGE;
-              }
+              InterruptMode intMode = toInterruptMode(mode);
               
-              // Create callback wrapper that acquires GIL
+              // Create callback wrapper that acquires GIL (the map is only
+              // touched with the GIL held)
               InterruptCallback cpp_callback = [pin]() {
+                  py::gil_scoped_acquire acquire;
                   auto it = g_interrupt_callbacks.find(pin);
                   if (it != g_interrupt_callbacks.end() && it->second) {
-                      py::gil_scoped_acquire acquire;
-                      (*it->second)();
+                      // Copy: the callback may release the GIL and be replaced
+                      std::shared_ptr<py::function> callback = it->second;
+                      (*callback)();
                   }
               };
               
               // Call InterruptManager::getInstance().attachInterrupt() directly
-              // This avoids the Arduino wrapper that expects void(*)()
+              // This avoids the Arduino wrapper that expects void(*)().
+              // Without the GIL: a callback already running on the monitor
+              // thread may be waiting for it.
+              py::gil_scoped_release release;
               InterruptManager::getInstance().attachInterrupt(pin, cpp_callback, intMode, "gpiochip0");
           },
           py::arg("pin"), py::arg("callback"), py::arg("mode"),
@@ -222,12 +288,79 @@ PYBIND11_MODULE(pypipinpp, m) {
     
     m.def("detachInterrupt",
           [](int pin) {
-              InterruptManager::getInstance().detachInterrupt(pin);
+              {
+                  // Waits for a running callback, which needs the GIL
+                  py::gil_scoped_release release;
+                  InterruptManager::getInstance().detachInterrupt(pin);
+              }
               g_interrupt_callbacks.erase(pin);  // Clean up Python callback
           },
           py::arg("pin"),
           "Detach the interrupt handler from a pin");
     
+    // ========================================================================
+    // QUEUED INTERRUPTS
+    // ========================================================================
+    
+    // The monitor thread only copies events into a lock-free ring and wakes
+    // an eventfd; Python drains it in batches, so a busy interpreter never
+    // holds up edge dispatch (unlike attachInterrupt, which takes the GIL
+    // on the monitor thread for every edge).
+    py::class_<pipinpp::EdgeQueue>(m, "EdgeQueue")
+        .def(py::init<size_t>(), py::arg("capacity") = pipinpp::EDGE_QUEUE_DEFAULT_CAPACITY,
+             "Create a queue holding up to capacity events (extra events are dropped and counted)")
+        .def("attach",
+             [](pipinpp::EdgeQueue& self, int pin, int mode, size_t bufferSize) {
+                 py::gil_scoped_release release;
+                 self.attach(pin, toInterruptMode(mode), bufferSize);
+             },
+             py::arg("pin"), py::arg("mode") = CHANGE, py::arg("bufferSize") = 64,
+             "Queue edges from a pin (RISING, FALLING, or CHANGE)")
+        .def("detach", &pipinpp::EdgeQueue::detach, release_gil(),
+             py::arg("pin"),
+             "Stop queueing a pin (returns False if it was not attached)")
+        .def("poll",
+             [](pipinpp::EdgeQueue& self, size_t maxEvents) {
+                 // With the GIL held: Python threads share the single consumer side
+                 std::vector<EdgeEvent> events(maxEvents);
+                 events.resize(self.poll(events.data(), events.size()));
+                 py::list result(events.size());
+                 for (size_t i = 0; i < events.size(); ++i) {
+                     const EdgeEvent& e = events[i];
+                     result[i] = py::make_tuple(e.pin, e.type == EdgeType::RISING ? HIGH : LOW,
+                                                e.timestampNs, e.lineSeqno);
+                 }
+                 return result;
+             },
+             py::arg("maxEvents") = 1024,
+             "Take queued events without blocking: list of (pin, level, timestampNs, lineSeqno)")
+        .def("pollRecords",
+             [](pipinpp::EdgeQueue& self, size_t maxEvents) {
+                 std::vector<EdgeEvent> events(maxEvents);
+                 events.resize(self.poll(events.data(), events.size()));
+                 std::vector<pipinpp::CaptureRecord> records(events.size());
+                 for (size_t i = 0; i < events.size(); ++i) {
+                     records[i] = {events[i].timestampNs, static_cast<uint32_t>(events[i].lineSeqno),
+                                   static_cast<uint8_t>(events[i].pin),
+                                   static_cast<uint8_t>(events[i].type == EdgeType::RISING), 0};
+                 }
+                 return py::bytes(reinterpret_cast<const char*>(records.data()),
+                                  records.size() * sizeof(pipinpp::CaptureRecord));
+             },
+             py::arg("maxEvents") = 65536,
+             "Take queued events as packed 16-byte records for numpy.frombuffer(): "
+             "dtype [('t','<u8'),('seq','<u4'),('pin','u1'),('level','u1'),('pad','<u2')]")
+        .def("wait", &pipinpp::EdgeQueue::wait, release_gil(),
+             py::arg("timeout_ms") = -1,
+             "Sleep until events are queued (True) or the timeout passes (False)")
+        .def("fileno", &pipinpp::EdgeQueue::fd,
+             "eventfd readable while events are queued (for select/selectors/asyncio)")
+        .def("__len__", &pipinpp::EdgeQueue::size)
+        .def_property_readonly("dropped", &pipinpp::EdgeQueue::getDroppedCount,
+                               "Events dropped because the queue was full")
+        .def_property_readonly("capacity", &pipinpp::EdgeQueue::capacity)
+        .def_property_readonly("pins", &pipinpp::EdgeQueue::getPins);
+    
     // ========================================================================
     // ADVANCED I/O FUNCTIONS
     // ========================================================================
@@ -236,22 +369,23 @@ PYBIND11_MODULE(pypipinpp, m) {
           [](int pin, unsigned int frequency, unsigned long duration) {
               tone(pin, frequency, duration);
           },
+          release_gil(),
           py::arg("pin"), py::arg("frequency"), py::arg("duration") = 0,
           "Generate a tone of specified frequency on a pin (duration=0 for continuous)");
     
-    m.def("noTone", &noTone,
+    m.def("noTone", &noTone, release_gil(),
           py::arg("pin"),
           "Stop tone generation on a pin");
     
-    m.def("pulseIn", &pulseIn,
+    m.def("pulseIn", &pulseIn, release_gil(),
           py::arg("pin"), py::arg("state"), py::arg("timeout") = 1000000,
           "Measure the duration of a pulse on a pin (in microseconds)");
     
-    m.def("shiftOut", &shiftOut,
+    m.def("shiftOut", &shiftOut, release_gil(),
           py::arg("dataPin"), py::arg("clockPin"), py::arg("bitOrder"), py::arg("value"),
           "Shift out a byte of data one bit at a time (MSBFIRST or LSBFIRST)");
     
-    m.def("shiftIn", &shiftIn,
+    m.def("shiftIn", &shiftIn, release_gil(),
           py::arg("dataPin"), py::arg("clockPin"), py::arg("bitOrder"),
           "Shift in a byte of data one bit at a time (returns uint8_t)");
     
@@ -335,12 +469,12 @@ PYBIND11_MODULE(pypipinpp, m) {
     // ========================================================================
     
     py::class_<pipinpp::WireClass>(m, "WireClass")
-        .def("begin", py::overload_cast<>(&pipinpp::WireClass::begin),
+        .def("begin", py::overload_cast<>(&pipinpp::WireClass::begin), release_gil(),
              "Initialize I2C with auto-detected bus")
-        .def("begin", py::overload_cast<int>(&pipinpp::WireClass::begin),
+        .def("begin", py::overload_cast<int>(&pipinpp::WireClass::begin), release_gil(),
              py::arg("busNumber"),
              "Initialize I2C with specific bus number")
-        .def("end", &pipinpp::WireClass::end,
+        .def("end", &pipinpp::WireClass::end, release_gil(),
              "Close I2C interface")
         .def("setClock", &pipinpp::WireClass::setClock,
              py::arg("frequency"),
@@ -354,32 +488,56 @@ PYBIND11_MODULE(pypipinpp, m) {
              py::arg("data"),
              "Write a single byte")
         .def("write", 
-             [](pipinpp::WireClass& self, py::bytes data) {
-                 std::string str = data;
-                 return self.write(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+             [](pipinpp::WireClass& self, py::buffer data) {
+                 ByteBuffer bytes(data, false);
+                 return self.write(bytes.data(), bytes.size());
              },
              py::arg("data"),
-             "Write multiple bytes")
+             "Write multiple bytes (bytes, bytearray, memoryview, ...)")
         .def("endTransmission",
-             py::overload_cast<bool>(&pipinpp::WireClass::endTransmission),
+             py::overload_cast<bool>(&pipinpp::WireClass::endTransmission), release_gil(),
              py::arg("sendStop") = true,
              "End I2C transmission and return status code")
         .def("requestFrom",
-             py::overload_cast<uint8_t, size_t, bool>(&pipinpp::WireClass::requestFrom),
+             py::overload_cast<uint8_t, size_t, bool>(&pipinpp::WireClass::requestFrom), release_gil(),
              py::arg("address"), py::arg("quantity"), py::arg("sendStop") = true,
              "Request bytes from I2C device")
         .def("available", &pipinpp::WireClass::available,
              "Get number of bytes available for reading")
         .def("read", &pipinpp::WireClass::read,
              "Read a single byte")
-        .def("scan", &pipinpp::WireClass::scan,
+        .def("scan", &pipinpp::WireClass::scan, release_gil(),
              "Scan for I2C devices (returns list of addresses)")
-        .def("readRegister", &pipinpp::WireClass::readRegister,
+        .def("readRegister", &pipinpp::WireClass::readRegister, release_gil(),
              py::arg("deviceAddress"), py::arg("registerAddress"),
              "Read a single byte from a register")
-        .def("writeRegister", &pipinpp::WireClass::writeRegister,
+        .def("writeRegister", &pipinpp::WireClass::writeRegister, release_gil(),
              py::arg("deviceAddress"), py::arg("registerAddress"), py::arg("data"),
-             "Write a single byte to a register");
+             "Write a single byte to a register")
+        .def("readRegisters",
+             [](pipinpp::WireClass& self, uint8_t address, uint8_t reg, size_t length) {
+                 return fillBytes(length, "I2C register read failed", [&](uint8_t* data, size_t n) {
+                     return self.readRegisters(address, reg, data, n);
+                 });
+             },
+             py::arg("deviceAddress"), py::arg("registerAddress"), py::arg("length"),
+             "Read consecutive registers (returns bytes, raises OSError on failure)")
+        .def("readRegisters",
+             [](pipinpp::WireClass& self, uint8_t address, uint8_t reg, py::buffer buffer) {
+                 ByteBuffer out(buffer, true);
+                 py::gil_scoped_release release;
+                 return self.readRegisters(address, reg, out.data(), out.size());
+             },
+             py::arg("deviceAddress"), py::arg("registerAddress"), py::arg("buffer"),
+             "Read consecutive registers into a writable buffer (returns count, -1 on error)")
+        .def("writeRegisters",
+             [](pipinpp::WireClass& self, uint8_t address, uint8_t reg, py::buffer data) {
+                 ByteBuffer bytes(data, false);
+                 py::gil_scoped_release release;
+                 return self.writeRegisters(address, reg, bytes.data(), bytes.size());
+             },
+             py::arg("deviceAddress"), py::arg("registerAddress"), py::arg("data"),
+             "Write consecutive registers from any bytes-like object");
     
     // Global Wire instance
     m.attr("Wire") = &pipinpp::Wire;
@@ -389,12 +547,12 @@ PYBIND11_MODULE(pypipinpp, m) {
     // ========================================================================
     
     py::class_<pipinpp::SPIClass>(m, "SPIClass")
-        .def("begin", py::overload_cast<>(&pipinpp::SPIClass::begin),
+        .def("begin", py::overload_cast<>(&pipinpp::SPIClass::begin), release_gil(),
              "Initialize SPI with default bus and CS")
-        .def("begin", py::overload_cast<int, int>(&pipinpp::SPIClass::begin),
+        .def("begin", py::overload_cast<int, int>(&pipinpp::SPIClass::begin), release_gil(),
              py::arg("bus"), py::arg("cs"),
              "Initialize SPI with specific bus and CS pin")
-        .def("end", &pipinpp::SPIClass::end,
+        .def("end", &pipinpp::SPIClass::end, release_gil(),
              "Close SPI interface")
         .def("setDataMode", &pipinpp::SPIClass::setDataMode,
              py::arg("mode"),
@@ -410,18 +568,31 @@ PYBIND11_MODULE(pypipinpp, m) {
              "Set SPI clock frequency in Hz")
         .def("getClock", &pipinpp::SPIClass::getClock,
              "Get current SPI clock frequency")
-        .def("transfer", py::overload_cast<uint8_t>(&pipinpp::SPIClass::transfer),
+        .def("transfer", py::overload_cast<uint8_t>(&pipinpp::SPIClass::transfer), release_gil(),
              py::arg("data"),
              "Transfer a single byte (returns received byte)")
         .def("transfer", 
-             [](pipinpp::SPIClass& self, py::bytes data) -> py::bytes {
-                 std::string str = data;
-                 std::vector<uint8_t> buffer(str.begin(), str.end());
-                 self.transfer(buffer.data(), buffer.size());
-                 return py::bytes(reinterpret_cast<char*>(buffer.data()), buffer.size());
+             [](pipinpp::SPIClass& self, py::buffer data) -> py::bytes {
+                 ByteBuffer tx(data, false);
+                 return fillBytes(tx.size(), "SPI transfer failed", [&](uint8_t* rx, size_t n) {
+                     self.transfer(tx.data(), rx, n);
+                     return n;
+                 });
              },
              py::arg("data"),
-             "Transfer multiple bytes (returns received bytes)");
+             "Transfer any bytes-like object (returns received bytes)")
+        .def("transfer",
+             [](pipinpp::SPIClass& self, py::buffer txData, py::buffer rxData) {
+                 ByteBuffer tx(txData, false);
+                 ByteBuffer rx(rxData, true);
+                 if (rx.size() < tx.size()) {
+                     throw py::value_error("rx buffer is smaller than tx");
+                 }
+                 py::gil_scoped_release release;
+                 self.transfer(tx.data(), rx.data(), tx.size());
+             },
+             py::arg("tx"), py::arg("rx"),
+             "Transfer tx and write the received bytes into the writable buffer rx (no copies)");
     
     // Global SPI instance
     m.attr("SPI") = &pipinpp::SPI;
@@ -431,50 +602,69 @@ PYBIND11_MODULE(pypipinpp, m) {
     // ========================================================================
     
     py::class_<pipinpp::SerialPort>(m, "SerialPort")
-        .def("begin", &pipinpp::SerialPort::begin,
+        .def("begin", &pipinpp::SerialPort::begin, release_gil(),
              py::arg("baudRate"), py::arg("device") = "/dev/ttyUSB0",
              "Open serial port with specified baud rate")
-        .def("end", &pipinpp::SerialPort::end,
+        .def("end", &pipinpp::SerialPort::end, release_gil(),
              "Close serial port")
         .def("isOpen", &pipinpp::SerialPort::isOpen,
              "Check if serial port is open")
-        .def("available", &pipinpp::SerialPort::available,
+        .def("fileno", &pipinpp::SerialPort::getFd,
+             "File descriptor of the open port (-1 if closed) for select/asyncio")
+        .def("available", &pipinpp::SerialPort::available, release_gil(),
              "Get number of bytes available for reading")
-        .def("read", &pipinpp::SerialPort::read,
+        .def("read", &pipinpp::SerialPort::read, release_gil(),
              "Read a single byte (returns -1 if none available)")
-        .def("peek", &pipinpp::SerialPort::peek,
+        .def("peek", &pipinpp::SerialPort::peek, release_gil(),
              "Peek at next byte without removing it")
-        .def("write", py::overload_cast<uint8_t>(&pipinpp::SerialPort::write),
+        .def("write", py::overload_cast<uint8_t>(&pipinpp::SerialPort::write), release_gil(),
              py::arg("byte"),
              "Write a single byte")
         .def("write", 
-             [](pipinpp::SerialPort& self, py::bytes data) {
-                 std::string str = data;
-                 return self.write(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+             [](pipinpp::SerialPort& self, py::buffer data) {
+                 ByteBuffer bytes(data, false);
+                 py::gil_scoped_release release;
+                 return self.write(bytes.data(), bytes.size());
              },
              py::arg("data"),
-             "Write multiple bytes")
-        .def("print", py::overload_cast<const std::string&>(&pipinpp::SerialPort::print),
+             "Write any bytes-like object")
+        .def("readBytes",
+             [](pipinpp::SerialPort& self, size_t length) {
+                 return fillBytes(length, "Serial read failed", [&](uint8_t* data, size_t n) {
+                     return self.readBytes(data, n);
+                 });
+             },
+             py::arg("length"),
+             "Read up to length bytes, waiting up to the timeout (returns bytes)")
+        .def("readBytes",
+             [](pipinpp::SerialPort& self, py::buffer buffer) {
+                 ByteBuffer out(buffer, true);
+                 py::gil_scoped_release release;
+                 return self.readBytes(out.data(), out.size());
+             },
+             py::arg("buffer"),
+             "Read into a writable buffer, waiting up to the timeout (returns count)")
+        .def("print", py::overload_cast<const std::string&>(&pipinpp::SerialPort::print), release_gil(),
              py::arg("data"),
              "Print string without newline")
-        .def("print", py::overload_cast<int>(&pipinpp::SerialPort::print),
+        .def("print", py::overload_cast<int>(&pipinpp::SerialPort::print), release_gil(),
              py::arg("num"),
              "Print integer without newline")
-        .def("println", py::overload_cast<const std::string&>(&pipinpp::SerialPort::println),
+        .def("println", py::overload_cast<const std::string&>(&pipinpp::SerialPort::println), release_gil(),
              py::arg("data"),
              "Print string with newline")
-        .def("println", py::overload_cast<int>(&pipinpp::SerialPort::println),
+        .def("println", py::overload_cast<int>(&pipinpp::SerialPort::println), release_gil(),
              py::arg("num"),
              "Print integer with newline")
-        .def("readString", &pipinpp::SerialPort::readString,
+        .def("readString", &pipinpp::SerialPort::readString, release_gil(),
              "Read all available data as string")
-        .def("readStringUntil", &pipinpp::SerialPort::readStringUntil,
+        .def("readStringUntil", &pipinpp::SerialPort::readStringUntil, release_gil(),
              py::arg("terminator"),
              "Read string until terminator character")
         .def("setTimeout", &pipinpp::SerialPort::setTimeout,
              py::arg("timeout"),
              "Set read timeout in milliseconds")
-        .def("flush", &pipinpp::SerialPort::flush,
+        .def("flush", &pipinpp::SerialPort::flush, release_gil(),
              "Flush output buffer");
     
     // Global Serial instance
@@ -0,0 +1,204 @@
+"""
+asyncio support for PyPiPinPP
+
+Awaitable wrappers over the library's pollable file descriptors, so one
+event loop can service many pins, serial ports and buses without a thread
+per source:
+
+- Edges: an EdgeQueue (one eventfd for any number of pins, woken by the
+  interrupt thread) is watched with loop.add_reader()
+- Serial: the port's fd is watched with loop.add_reader()
+- I2C/SPI: transfers are single ioctls with no readiness to wait for, so
+  they run in the loop's executor; the bindings release the GIL during
+  the ioctl, so the loop keeps running
+
+Example:
+
+    import asyncio
+    from pypipinpp import CHANGE, Serial
+    from pypipinpp_asyncio import AsyncEdgeQueue, AsyncSerial
+
+    async def edges():
+        queue = AsyncEdgeQueue()
+        queue.attach(17, CHANGE)
+        async for pin, level, timestamp_ns, seqno in queue:
+            print(pin, level, timestamp_ns)
+
+    async def uart():
+        Serial.begin(115200, "/dev/ttyAMA0")
+        port = AsyncSerial(Serial)
+        while True:
+            print(await port.readline())
+
+    async def main():
+        await asyncio.gather(edges(), uart())
+
+    asyncio.run(main())
+"""
+
+import asyncio
+import collections
+import functools
+
+import pypipinpp
+from pypipinpp import CHANGE, EdgeQueue
+
+__all__ = [
+    "AsyncEdgeQueue",
+    "AsyncSerial",
+    "wait_for_edge",
+    "run_blocking",
+    "i2c_read_registers",
+    "i2c_write_registers",
+    "spi_transfer",
+]
+
+
+async def _readable(fd):
+    """Wait until fd is readable (level-triggered, may return spuriously)."""
+    loop = asyncio.get_running_loop()
+    future = loop.create_future()
+
+    def ready():
+        if not future.done():
+            future.set_result(None)
+
+    loop.add_reader(fd, ready)
+    try:
+        await future
+    finally:
+        loop.remove_reader(fd)
+
+
+class AsyncEdgeQueue:
+    """EdgeQueue whose events can be awaited.
+
+    Events are (pin, level, timestampNs, lineSeqno) tuples with kernel
+    timestamps, oldest first. The interrupt thread never waits for the
+    event loop; if the loop falls behind by more than capacity events,
+    the newest are dropped and counted in `dropped`.
+    """
+
+    def __init__(self, capacity=4096):
+        self.queue = EdgeQueue(capacity)
+        self._pending = collections.deque()
+
+    def attach(self, pin, mode=CHANGE, bufferSize=64):
+        self.queue.attach(pin, mode, bufferSize)
+
+    def detach(self, pin):
+        return self.queue.detach(pin)
+
+    def close(self):
+        for pin in self.queue.pins:
+            self.queue.detach(pin)
+
+    @property
+    def dropped(self):
+        return self.queue.dropped
+
+    async def get_batch(self, maxEvents=1024):
+        """Wait for events and return every queued one (up to maxEvents)."""
+        if self._pending:
+            batch = list(self._pending)
+            self._pending.clear()
+            return batch
+        while True:
+            batch = self.queue.poll(maxEvents)
+            if batch:
+                return batch
+            await _readable(self.queue.fileno())
+
+    async def get(self):
+        """Wait for and return the next event."""
+        if not self._pending:
+            self._pending.extend(await self.get_batch())
+        return self._pending.popleft()
+
+    def __aiter__(self):
+        return self
+
+    async def __anext__(self):
+        return await self.get()
+
+
+async def wait_for_edge(pin, mode=CHANGE, timeout=None):
+    """Wait for one edge on pin; returns (pin, level, timestampNs, lineSeqno).
+
+    Raises asyncio.TimeoutError after timeout seconds. For a pin watched
+    continuously, keep an AsyncEdgeQueue attached instead: attaching
+    requests the line each time.
+    """
+    queue = AsyncEdgeQueue(capacity=16)
+    queue.attach(pin, mode)
+    try:
+        return await asyncio.wait_for(queue.get(), timeout)
+    finally:
+        queue.close()
+
+
+class AsyncSerial:
+    """Awaitable reads on a SerialPort (pypipinpp.Serial by default).
+
+    Do not combine with Serial.beginRxThread(): the receive thread drains
+    the kernel buffer, so the fd never becomes readable.
+    """
+
+    def __init__(self, port=None):
+        self.port = port if port is not None else pypipinpp.Serial
+
+    def _fd(self):
+        fd = self.port.fileno()
+        if fd < 0:
+            raise OSError("serial port is not open")
+        return fd
+
+    async def read(self, n=4096):
+        """Wait for data and return 1 to n bytes."""
+        while True:
+            available = self.port.available()
+            if available > 0:
+                return self.port.readBytes(min(n, available))
+            await _readable(self._fd())
+
+    async def readexactly(self, n):
+        """Return exactly n bytes."""
+        data = bytearray()
+        while len(data) < n:
+            data += await self.read(n - len(data))
+        return bytes(data)
+
+    async def readline(self, terminator=b"\n"):
+        """Return bytes up to and including terminator."""
+        line = bytearray()
+        while not line.endswith(terminator):
+            line += await self.read(1)
+        return bytes(line)
+
+    def write(self, data):
+        """Write bytes (returns the count written)."""
+        return self.port.write(data)
+
+
+async def run_blocking(func, *args, **kwargs):
+    """Run a blocking PyPiPinPP call in the loop's default executor."""
+    loop = asyncio.get_running_loop()
+    return await loop.run_in_executor(None, functools.partial(func, *args, **kwargs))
+
+
+async def i2c_read_registers(address, register, length, wire=None):
+    """Read consecutive I2C registers without blocking the loop (returns bytes)."""
+    wire = wire if wire is not None else pypipinpp.Wire
+    return await run_blocking(wire.readRegisters, address, register, length)
+
+
+async def i2c_write_registers(address, register, data, wire=None):
+    """Write consecutive I2C registers without blocking the loop."""
+    wire = wire if wire is not None else pypipinpp.Wire
+    return await run_blocking(wire.writeRegisters, address, register, data)
+
+
+async def spi_transfer(data, spi=None):
+    """Full-duplex SPI transfer without blocking the loop (returns bytes)."""
+    spi = spi if spi is not None else pypipinpp.SPI
+    return await run_blocking(spi.transfer, data)
@@ -6,6 +6,7 @@ from setuptools import setup, Extension
 from setuptools.command.build_ext import build_ext
 import sys
 import os
+import glob
 import subprocess
 
 class get_pybind_include:
@@ -37,18 +38,8 @@ pipinpp_root = os.path.abspath(os.path.join(os.path.dirname(__file__), '../..'))
 pipinpp_include = os.path.join(pipinpp_root, 'include')
 pipinpp_src = os.path.join(pipinpp_root, 'src')
 
-# Collect all PiPinPP source files
-pipinpp_sources = [
-    os.path.join(pipinpp_src, 'ArduinoCompat.cpp'),
-    os.path.join(pipinpp_src, 'pin.cpp'),
-    os.path.join(pipinpp_src, 'pwm.cpp'),
-    os.path.join(pipinpp_src, 'interrupts.cpp'),
-    os.path.join(pipinpp_src, 'Wire.cpp'),
-    os.path.join(pipinpp_src, 'SPI.cpp'),
-    os.path.join(pipinpp_src, 'Serial.cpp'),
-    os.path.join(pipinpp_src, 'platform.cpp'),
-    os.path.join(pipinpp_src, 'event_pwm.cpp'),
-]
+# Collect all PiPinPP source files (the extension links the whole library)
+pipinpp_sources = sorted(glob.glob(os.path.join(pipinpp_src, '*.cpp')))
 
 # Extension module
 ext_modules = [
@@ -235,6 +226,7 @@ setup(
         'Tracker': 'https://github.com/Barbatos6669/PiPinPP/issues',
     },
     ext_modules=ext_modules,
+    py_modules=['pypipinpp_asyncio'],
     cmdclass={'build_ext': BuildExt},
     install_requires=['pybind11>=2.6.0'],
     setup_requires=['pybind11>=2.6.0'],
@@ -19,6 +19,7 @@
  * - Smooth LED fading (0-255 brightness range)
  * - Multiple fade patterns
  * - PWM frequency control
+ * - FadeEngine: timer-driven, gamma-corrected fades
  * 
  * Wiring:
  * ```
@@ -31,6 +32,7 @@
  */
 
 #include <ArduinoCompat.hpp>
+#include <fade_engine.hpp>
 #include <iostream>
 #include <csignal>
 #include <atomic>
@@ -108,6 +110,32 @@ void breathe(int pin, int cycles = 3) {
     std::cout << " Done!" << std::endl;
 }
 
+/**
+ * @brief Breathing effect run by FadeEngine instead of this thread
+ *
+ * fadeTo() returns at once; the engine steps the fade from its timer
+ * task with gamma correction, so the main thread only waits here.
+ */
+void breatheWithEngine(int pin, int cycles = 3) {
+    std::cout << "  Engine breathing (" << cycles << " cycles)...";
+    std::cout.flush();
+    
+    auto& fades = pipinpp::FadeEngine::getInstance();
+    for (int i = 0; i < cycles && running; i++) {
+        fades.fadeTo(pin, 255, 1200, pipinpp::FadeCurve::EASE_IN_OUT);
+        while (fades.isFading(pin) && running) {
+            delay(20);
+        }
+        fades.fadeTo(pin, 0, 1200, pipinpp::FadeCurve::EASE_IN_OUT);
+        while (fades.isFading(pin) && running) {
+            delay(20);
+        }
+    }
+    fades.stop(pin);
+    
+    std::cout << " Done!" << std::endl;
+}
+
 /**
  * @brief Demonstrate different brightness levels
  */
@@ -184,6 +212,13 @@ int main() {
                 delay(1000);
             }
             
+            // Demo 2b: Same effect, gamma-corrected, no busy user thread
+            if (running) {
+                std::cout << "\n2b. FadeEngine Breathing:" << std::endl;
+                breatheWithEngine(LED_PIN, 3);
+                delay(1000);
+            }
+            
             // Demo 3: Discrete brightness levels
             if (running) {
                 std::cout << "\n3. Brightness Levels:" << std::endl;
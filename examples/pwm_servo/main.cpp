@@ -23,6 +23,7 @@
 
 #include "HardwarePWM.hpp"
 #include "ArduinoCompat.hpp"
+#include "servo_controller.hpp"
 #include <iostream>
 #include <iomanip>
 #include <cmath>
@@ -203,6 +204,39 @@ int main()
     delay(500);
     sweepServo(servo, 30, 90, 5.0, 10);
     
+    // Test 5: Trajectory control
+    cout << "\n--- Test 5: Trajectory (ServoController) ---\n";
+    cout << "Accelerated moves through waypoints, timed by the library...\n";
+    
+    {
+        auto& controller = ServoController::getInstance();
+        ServoConfig config;
+        config.maxVelocity = 120.0;       // deg/s
+        config.maxAcceleration = 360.0;   // deg/s²
+        int id = controller.attach(servo, config, 90.0);
+        
+        ServoWaypoint left;
+        left.angle = 20.0;
+        left.dwellMs = 300;
+        ServoWaypoint right;
+        right.angle = 160.0;
+        right.maxVelocity = 60.0;         // This leg slower
+        right.dwellMs = 300;
+        controller.addWaypoint(id, left);
+        controller.addWaypoint(id, right);
+        controller.moveTo(id, 90.0);      // Replaces the path: redirects mid-move
+        delay(100);
+        controller.addWaypoint(id, left);
+        controller.addWaypoint(id, right);
+        
+        while (controller.isMoving(id)) {
+            cout << "  Angle: " << fixed << setprecision(1) << controller.getAngle(id)
+                 << "°  velocity: " << controller.getVelocity(id) << "°/s\n";
+            delay(250);
+        }
+        controller.detach(id);
+    }
+    
     // Return to center and finish
     cout << "\n--- Finishing ---\n";
     cout << "Returning to center position (90°)...\n";
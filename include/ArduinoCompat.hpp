@@ -27,7 +27,10 @@
 
 #pragma once
 #include "pin.hpp"
+#include "timebase.hpp"
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 // Arduino-style constants (simple and familiar)
 constexpr bool HIGH = true;
@@ -72,6 +75,28 @@ void digitalWrite(int pin, bool value);
  */
 int digitalRead(int pin);
 
+/**
+ * @brief digitalWrite() without exceptions (see error_code.hpp)
+ * 
+ * Lock-free like digitalWrite(); nothing is allocated on failure.
+ * 
+ * @return Empty on success; GpioErrc::INVALID_PIN, GpioErrc::NOT_CONFIGURED,
+ *         GpioErrc::WRONG_DIRECTION or the backend's errno
+ */
+std::error_code tryDigitalWrite(int pin, bool value) noexcept;
+
+/**
+ * @brief digitalRead() without exceptions
+ * 
+ * @param value Receives 1 or 0 on success
+ */
+std::error_code tryDigitalRead(int pin, int& value) noexcept;
+
+/**
+ * @brief digitalToggle() without exceptions
+ */
+std::error_code tryDigitalToggle(int pin) noexcept;
+
 /**
  * @brief Delay execution for specified milliseconds (Arduino-style function)
  * 
@@ -83,7 +108,9 @@ void delay(unsigned long ms);
 /*                        MATH FUNCTIONS                       */
 /* ------------------------------------------------------------*/
 
-// Arduino-specific math functions (functions not available in standard library)
+// Arduino-specific math functions (functions not available in standard library).
+// The scalar versions are inline constexpr so per-sample loops inline them
+// and constant arguments fold at compile time.
 /**
  * @brief Constrain a value between minimum and maximum (Arduino-specific function)
  * @param x Input value to constrain
@@ -91,7 +118,10 @@ void delay(unsigned long ms);
  * @param max Maximum allowed value
  * @return int Value constrained between min and max
  */
-int constrain(int x, int min, int max);
+constexpr int constrain(int x, int min, int max)
+{
+    return x < min ? min : (x > max ? max : x);
+}
 
 /**
  * @brief Constrain a value between minimum and maximum (Arduino-specific function)
@@ -100,7 +130,10 @@ int constrain(int x, int min, int max);
  * @param max Maximum allowed value
  * @return long Value constrained between min and max
  */
-long constrain(long x, long min, long max);
+constexpr long constrain(long x, long min, long max)
+{
+    return x < min ? min : (x > max ? max : x);
+}
 
 /**
  * @brief Constrain a value between minimum and maximum (Arduino-specific function)
@@ -109,7 +142,10 @@ long constrain(long x, long min, long max);
  * @param max Maximum allowed value
  * @return float Value constrained between min and max
  */
-float constrain(float x, float min, float max);
+constexpr float constrain(float x, float min, float max)
+{
+    return x < min ? min : (x > max ? max : x);
+}
 
 /**
  * @brief Map a value from one range to another (Arduino-specific function)
@@ -118,9 +154,41 @@ float constrain(float x, float min, float max);
  * @param in_max Maximum of input range
  * @param out_min Minimum of output range
  * @param out_max Maximum of output range
- * @return long Mapped value
+ * @return long Mapped value (out_min if the input range is empty)
+ */
+constexpr long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    // Prevent division by zero
+    if (in_max == in_min) {
+        return out_min;
+    }
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+/**
+ * @brief map() every sample of a block (in == out is allowed)
+ * 
+ * Gives exactly the scalar map() result for each sample, saturated to
+ * int16_t. The loop divides in double precision, which vectorizes (NEON
+ * on the Pi) where the 64-bit integer divide of map() cannot; ranges too
+ * large for that to be exact fall back to the scalar loop. For a divide-
+ * free version see pipinpp::FixedMap (fixed_math.hpp).
+ * 
+ * @param in Input samples
+ * @param out Output samples (@p count of them)
+ * @param count Number of samples
+ */
+void map(const int16_t* in, int16_t* out, size_t count, long in_min, long in_max, long out_min, long out_max);
+
+/**
+ * @brief constrain() every sample of a block (in == out is allowed)
  */
-long map(long x, long in_min, long in_max, long out_min, long out_max);
+void constrain(const int16_t* in, int16_t* out, size_t count, int16_t min, int16_t max);
+
+/**
+ * @brief constrain() every sample of a block (in == out is allowed)
+ */
+void constrain(const float* in, float* out, size_t count, float min, float max);
 
 // Note: For abs() function, use std::abs() from <cmath> or <cstdlib> instead
 
@@ -133,6 +201,8 @@ long map(long x, long in_min, long in_max, long out_min, long out_max);
  * 
  * Uses monotonic clock that won't jump if system time changes.
  * Resets to 0 at program start. Overflows after ~49 days.
+ * Same epoch as micros(); an inline read of the shared timebase
+ * (see timebase.hpp).
  * 
  * @return unsigned long Milliseconds elapsed since program started
  * 
@@ -141,13 +211,14 @@ long map(long x, long in_min, long in_max, long out_min, long out_max);
  * // ... do work ...
  * unsigned long elapsed = millis() - startTime;
  */
-unsigned long millis();
+inline unsigned long millis() { return static_cast<unsigned long>(pipinpp::timebaseMillis()); }
 
 /**
  * @brief Returns microseconds since program start (Arduino-style function)
  * 
  * High-precision timing using monotonic clock.
  * Resets to 0 at program start. Overflows after ~71 minutes.
+ * Same epoch as millis(); costs a few nanoseconds (see timebase.hpp).
  * 
  * @return unsigned long Microseconds elapsed since program started
  * 
@@ -156,18 +227,18 @@ unsigned long millis();
  * // ... time-critical code ...
  * unsigned long duration = micros() - start;
  */
-unsigned long micros();
+inline unsigned long micros() { return static_cast<unsigned long>(pipinpp::timebaseMicros()); }
 
 /**
  * @brief Delay execution in microseconds with high precision (Arduino-style function)
  * 
- * Uses busy-waiting for microsecond accuracy (consumes CPU).
- * Use delay() for millisecond delays (more efficient).
+ * Sleeps until a calibrated margin before the deadline and busy-waits
+ * only the remaining tail (see pipinpp::preciseDelayUs()), so long delays
+ * do not hold a core.
  * 
  * @param us Delay time in microseconds
  * 
  * @note Accurate to ±1-2 microseconds
- * @warning Uses busy-wait loop - consumes CPU during delay
  * 
  * @example
  * digitalWrite(17, HIGH);
@@ -276,14 +347,15 @@ void detachInterrupt(int pin);
  * 
  * @note Pin is automatically configured as OUTPUT
  * @note PWM frequency is 490Hz by default (matches Arduino UNO)
- * @note This is software PWM and has timing jitter (~1-10 µs)
- * @note Each PWM pin uses a dedicated busy-loop thread
+ * @note The backend is chosen per pin by pipinpp::PwmRouter: HardwarePWM
+ *       when PlatformInfo maps a free PWM channel to the pin (e.g. GPIO18/19),
+ *       DmaSoftPWM when the application has begun it, otherwise the shared
+ *       EventPWMManager timer thread
  * 
- * @warning ⚠️ CPU USAGE: Each PWM pin consumes ~10-30% CPU in busy-wait loop
- * @warning Uses std::this_thread::yield() but still busy-waits for timing accuracy
- * @warning Multiple PWM pins can cause significant CPU load
- * @warning ❌ NOT suitable for servo control - use HardwarePWM class (zero CPU usage)
- * @warning Software PWM best for LED dimming only, not precision timing
+ * @warning Timer-thread PWM has timing jitter (~1-10 µs) and wakes a core
+ *          for every edge; HardwarePWM and DmaSoftPWM use no CPU per edge
+ * @warning ❌ Timer-thread PWM is NOT suitable for servo control - use HardwarePWM
+ *          or DmaSoftPWM
  * 
  * @example
  * // Fade an LED from off to full brightness
@@ -450,6 +522,10 @@ constexpr double RAD_TO_DEG = 57.295779513082320876798154814105;
  * seeds to get different random sequences. Common practice is to seed
  * with micros() or a reading from an analog pin.
  * 
+ * Every thread has its own generator (see fast_random.hpp). Each reseeds
+ * from this value and its stream index on its next random() call, so a
+ * given seed reproduces the same numbers per thread.
+ * 
  * @param seed The seed value (any unsigned long)
  * 
  * @example
@@ -462,6 +538,7 @@ void randomSeed(unsigned long seed);
  * @brief Generate random number in range [0, max) (Arduino-inspired)
  * 
  * Returns a pseudo-random number from 0 up to (but not including) max.
+ * Lock-free: uses the calling thread's engine.
  * 
  * @param max Upper bound (exclusive) - must be positive
  * @return long Random number in range [0, max)
@@ -659,13 +736,14 @@ inline unsigned char lowByte(unsigned int x) {
  * @param timeout Maximum time to wait in microseconds (default: 1000000 = 1 second)
  * @return unsigned long Pulse length in microseconds, or 0 if timeout
  * 
- * @note Pin is automatically configured as INPUT if not already set
+ * @note Pin must be configured as INPUT first
  * @note This is a blocking function - will wait up to timeout microseconds
- * @note Accuracy depends on system load (typical accuracy ±10µs)
+ * @note Widths come from kernel edge timestamps (see pipinpp::measurePulse()),
+ *       so they do not depend on system load and no CPU is used while waiting.
+ *       If the line cannot report edges, falls back to polling digitalRead()
+ *       (100% of one core, accuracy ±10µs).
  * 
- * @warning ⚠️ CPU USAGE: Uses busy-waiting loop consuming 100% of one CPU core
- * @warning Blocks execution and consumes full CPU until pulse completes or timeout
- * @warning For non-blocking pulse measurement, consider using interrupts with timestamps
+ * @warning For continuous or non-blocking measurement, use pipinpp::PulseCapture
  * 
  * @example
  * // Read ultrasonic sensor (HC-SR04)
@@ -769,6 +847,58 @@ void shiftOut(int dataPin, int clockPin, int bitOrder, unsigned char value);
  */
 unsigned char shiftIn(int dataPin, int clockPin, int bitOrder);
 
+/**
+ * @brief Shift out a whole buffer, e.g. a daisy-chain of 74HC595s
+ * 
+ * Looks the pins up and checks their modes once for the whole buffer, then
+ * clocks every bit through Pin::shiftOut(): straight GPIO register writes
+ * when both pins use the gpiomem backend, one libgpiod call per edge
+ * otherwise. shiftOut() is this function with one byte and a 1 µs clock.
+ * 
+ * @param dataPin GPIO pin for serial data output (must be configured as OUTPUT)
+ * @param clockPin GPIO pin for clock signal output (must be configured as OUTPUT)
+ * @param bitOrder MSBFIRST or LSBFIRST, applied to every byte
+ * @param data Bytes to send; data[0] goes out first
+ * @param length Number of bytes
+ * @param clockDelayNs Data setup time and clock high time in nanoseconds
+ *        (0 = as fast as the backend allows; long or slow chains may need more)
+ * 
+ * @throws PinError if pins are not configured as OUTPUT via pinMode()
+ * @throws InvalidPinError if pin numbers are out of range (0-27)
+ * @throws std::invalid_argument if data is null and length is not 0
+ * @throws GpioAccessError if a write fails
+ * 
+ * @example
+ * // Refresh four chained 74HC595s (byte for the last chip first)
+ * uint8_t frame[4] = {0x00, 0xFF, 0x0F, 0xF0};
+ * digitalWrite(LATCH_PIN, LOW);
+ * shiftOutBuffer(DATA_PIN, CLOCK_PIN, MSBFIRST, frame, sizeof(frame));
+ * digitalWrite(LATCH_PIN, HIGH);
+ */
+void shiftOutBuffer(int dataPin, int clockPin, int bitOrder, const uint8_t* data, size_t length,
+                    unsigned int clockDelayNs = 0);
+
+/**
+ * @brief Shift in a whole buffer, e.g. a daisy-chain of 74HC165s
+ * 
+ * Same per-bit timing as shiftIn() (clock high, sample, clock low) with one
+ * pin lookup for the whole buffer.
+ * 
+ * @param dataPin GPIO pin for serial data input (must be configured as INPUT)
+ * @param clockPin GPIO pin for clock signal output (must be configured as OUTPUT)
+ * @param bitOrder MSBFIRST or LSBFIRST, applied to every byte
+ * @param data Destination; data[0] receives the first byte clocked in
+ * @param length Number of bytes
+ * @param clockDelayNs Clock high and low time in nanoseconds
+ * 
+ * @throws PinError if pins are not configured correctly via pinMode()
+ * @throws InvalidPinError if pin numbers are out of range (0-27)
+ * @throws std::invalid_argument if data is null and length is not 0
+ * @throws GpioAccessError if an access fails
+ */
+void shiftInBuffer(int dataPin, int clockPin, int bitOrder, uint8_t* data, size_t length,
+                   unsigned int clockDelayNs = 0);
+
 // Bit order constants for shiftIn/shiftOut
 constexpr int LSBFIRST = 0;  ///< Least Significant Bit First
 constexpr int MSBFIRST = 1;  ///< Most Significant Bit First
@@ -788,14 +918,15 @@ constexpr int MSBFIRST = 1;  ///< Most Significant Bit First
  * @throws std::invalid_argument if frequency is 0 or > 65535
  * 
  * @note Call pinMode(pin, OUTPUT) before using this function
- * @note Uses software PWM (50% duty cycle square wave)
+ * @note 50% duty cycle square wave on the backend pipinpp::PwmRouter picks
+ *       (HardwarePWM where available, else the shared EventPWMManager thread;
+ *       frequencies outside 50-10000 Hz use a per-pin PWMManager thread)
  * @note Only one tone can play per pin at a time
  * @note Call noTone() to stop continuous tones
  * @note Frequency range: 31Hz to 65535Hz (human hearing: ~20Hz-20kHz)
  * 
- * @warning ⚠️ CPU USAGE: Runs busy-loop thread consuming ~10-30% CPU while tone plays
- * @warning Same as analogWrite() - uses software PWM for square wave generation
- * @warning For continuous tones or music, consider hardware PWM or external audio module
+ * @warning Without hardware PWM the tone is timed by a CPU thread, so pitch has
+ *          a few µs of jitter; for music consider an external audio module
  * 
  * @example
  * // Simple beep
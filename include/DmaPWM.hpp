@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2025 HobbyHacker
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file DmaPWM.hpp
+ * @brief PWM peripheral driven directly through registers, with DMA-paced duty sequences
+ * @author Barbatos6669
+ * @date 2025-11-21
+ * 
+ * Programs the BCM283x/BCM2711 PWM block and its clock directly and feeds
+ * the PWM FIFO from a DMA control block. Every PWM period consumes one duty
+ * value from a buffer, so arbitrary waveforms (audio, LED fades, servo
+ * sweeps) play back with sample-accurate timing and no CPU involvement.
+ * 
+ * Compared to HardwarePWM (sysfs):
+ * - Duty changes every period instead of once per write() call
+ * - Sample rates up to several MHz, limited by the PWM clock and range
+ * - Requires root (/dev/mem, /dev/vcio) and a free DMA channel
+ * - Not available on Raspberry Pi 5 (PWM lives behind RP1)
+ * 
+ * Pin Mapping:
+ * - GPIO12 (ALT0), GPIO18 (ALT5) → PWM channel 0
+ * - GPIO13 (ALT0), GPIO19 (ALT5) → PWM channel 1
+ * 
+ * Example Usage:
+ * @code
+ * #include "DmaPWM.hpp"
+ * using namespace pipinpp;
+ * 
+ * int main() {
+ *     DmaPWM pwm(18);
+ *     
+ *     // 8 kHz sample rate, 0-255 duty range (PWM clock 2.04 MHz)
+ *     if (!pwm.begin(8000, 256)) return 1;
+ *     
+ *     // One period of a triangle wave, repeated
+ *     std::vector<uint32_t> wave;
+ *     for (uint32_t i = 0; i < 256; ++i) wave.push_back(i);
+ *     for (uint32_t i = 256; i-- > 0;) wave.push_back(i);
+ *     pwm.play(wave, true);
+ *     
+ *     delay(5000);
+ *     pwm.end();
+ *     return 0;
+ * }
+ * @endcode
+ * 
+ * @warning Do not use HardwarePWM, DmaSoftPWM or the kernel PWM driver on the same
+ *          PWM block at the same time.
+ * 
+ * @version 0.4.0
+ */
+
+#ifndef PIPINPP_DMA_PWM_HPP
+#define PIPINPP_DMA_PWM_HPP
+
+#include "dma.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @class DmaPWM
+ * @brief Register-level PWM output with DMA-streamed duty values
+ * 
+ * @note Thread-safe: All operations are protected by internal mutex
+ * @note The pin function is restored by end() or the destructor
+ */
+class DmaPWM {
+public:
+    /**
+     * @brief Constructor
+     * @param gpioPin GPIO pin (12, 13, 18 or 19)
+     * @param dmaChannel DMA channel to use (0-14, default 5)
+     * @throws InvalidPinError if the pin has no PWM function or the DMA channel is invalid
+     */
+    explicit DmaPWM(int gpioPin, int dmaChannel = DEFAULT_DMA_CHANNEL);
+    
+    /**
+     * @brief Destructor - stops DMA and PWM and restores the pin
+     */
+    ~DmaPWM();
+    
+    DmaPWM(const DmaPWM&) = delete;
+    DmaPWM& operator=(const DmaPWM&) = delete;
+    
+    /**
+     * @brief Map the peripherals, start the PWM clock and route the pin to PWM
+     * @param sampleRateHz Duty values consumed per second (= PWM frequency)
+     * @param range Duty resolution; a value of @p range is 100% (2 or more)
+     * @return true on success, false on error (unsupported board, no root,
+     *         clock out of range)
+     * 
+     * @note The PWM clock is sampleRateHz * range and must be reachable with
+     *       an integer divisor (2-4095) of the crystal (19.2 MHz, 54 MHz on Pi 4)
+     */
+    bool begin(uint32_t sampleRateHz, uint32_t range = 1000);
+    
+    /**
+     * @brief Stop output and restore the pin function
+     * 
+     * @note Safe to call multiple times
+     */
+    void end();
+    
+    /**
+     * @brief Check if begin() succeeded
+     */
+    bool isBegun() const;
+    
+    /**
+     * @brief Stream duty values to the PWM FIFO
+     * @param samples Duty values (0 to range; larger values are clamped)
+     * @param count Number of values
+     * @param loop Repeat the buffer until stop() instead of playing it once
+     * @return true on success, false if not begun or allocation failed
+     * 
+     * @note The buffer is copied; the caller's memory may be reused immediately
+     * @note Replaces any sequence that is playing
+     */
+    bool play(const uint32_t* samples, size_t count, bool loop = false);
+    
+    /**
+     * @brief Stream duty values to the PWM FIFO
+     * @param samples Duty values (0 to range)
+     * @param loop Repeat the buffer until stop()
+     * @return true on success, false on error
+     */
+    bool play(const std::vector<uint32_t>& samples, bool loop = false);
+    
+    /**
+     * @brief Output a constant duty cycle
+     * @param percent Duty cycle percentage (0.0-100.0)
+     * @return true on success, false on error
+     * 
+     * @note Implemented as a one-value looping sequence
+     */
+    bool setDutyCycle(double percent);
+    
+    /**
+     * @brief Stop the DMA transfer; the output goes low once the FIFO drains
+     */
+    void stop();
+    
+    /**
+     * @brief Check if a sequence is still being transferred
+     * @return true while DMA is active (always true for looping sequences)
+     */
+    bool isPlaying() const;
+    
+    /**
+     * @brief Check if the DMA channel reported an error
+     */
+    bool hasError() const;
+    
+    /**
+     * @brief Get GPIO pin number
+     */
+    int getPin() const { return pin_; }
+    
+    /**
+     * @brief Get PWM channel (0 or 1) driven by this pin
+     */
+    int getPwmChannel() const { return pwmChannel_; }
+    
+    /**
+     * @brief Get actual sample rate in Hz (after clock divisor rounding), or 0 if not begun
+     */
+    uint32_t getSampleRate() const;
+    
+    /**
+     * @brief Get duty range set by begin()
+     */
+    uint32_t getRange() const;
+    
+    /**
+     * @brief Helper: Convert GPIO pin number to PWM channel and pin function
+     * @param gpioPin GPIO pin number (12, 13, 18, or 19)
+     * @param[out] pwmChannel PWM channel (0 or 1)
+     * @param[out] altFunction GPFSEL function code selecting PWM
+     * @return true if pin supports PWM, false otherwise
+     */
+    static bool gpioToChannel(int gpioPin, int& pwmChannel, uint32_t& altFunction);
+    
+    /**
+     * @brief Helper: Clock divisor from the crystal for a sample rate and range
+     * @param oscillatorHz Crystal frequency
+     * @param sampleRateHz Requested sample rate
+     * @param range Duty range
+     * @param[out] divisor Integer divisor (2-4095)
+     * @return true if the combination can be generated, false otherwise
+     */
+    static bool computeClockDivisor(uint32_t oscillatorHz, uint32_t sampleRateHz,
+                                    uint32_t range, uint32_t& divisor);
+
+private:
+    int pin_;                                 ///< GPIO pin number
+    int dmaChannel_;                          ///< DMA channel number
+    int pwmChannel_;                          ///< PWM channel (0 or 1)
+    uint32_t altFunction_;                    ///< GPFSEL code for PWM
+    uint32_t savedFunction_;                  ///< GPFSEL code before begin()
+    uint32_t sampleRateHz_;                   ///< Actual sample rate
+    uint32_t range_;                          ///< Duty range
+    mutable std::mutex mutex_;                ///< Mutex for thread safety
+    
+    std::unique_ptr<PeripheralMap> gpio_;     ///< GPIO registers (pin function)
+    std::unique_ptr<PwmPacer> pacer_;         ///< PWM block and clock
+    std::unique_ptr<DmaChannel> dma_;         ///< DMA engine channel
+    std::unique_ptr<DmaMemory> memory_;       ///< Control block + samples
+    
+    /**
+     * @brief Set the pin's GPFSEL function code
+     */
+    void setPinFunction(uint32_t function);
+    
+    /**
+     * @brief Stop DMA (caller holds mutex_)
+     */
+    void stopLocked();
+};
+
+} // namespace pipinpp
+
+#endif // PIPINPP_DMA_PWM_HPP
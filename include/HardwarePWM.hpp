@@ -43,6 +43,7 @@
  * - Multiple polarity modes
  * - Thread-safe operations
  * - Auto-export/unexport management
+ * - Synchronized multi-channel updates (HardwarePWMGroup)
  * 
  * Example Usage:
  * @code
@@ -74,9 +75,11 @@
 #ifndef PIPINPP_HARDWARE_PWM_HPP
 #define PIPINPP_HARDWARE_PWM_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <mutex>
+#include <vector>
 
 namespace pipinpp {
 
@@ -112,8 +115,9 @@ public:
      * @brief Constructor
      * @param chip PWM chip number (usually 0 for Raspberry Pi)
      * @param channel PWM channel number (0 or 1)
+     * @param sysRoot Prefix for the /sys/class/pwm paths (empty = the running system)
      */
-    HardwarePWM(int chip = 0, int channel = 0);
+    HardwarePWM(int chip = 0, int channel = 0, const std::string& sysRoot = "");
     
     /**
      * @brief Destructor - automatically disables and unexports PWM
@@ -175,6 +179,9 @@ public:
      * pwm.setDutyCycle(50.0);  // 50% duty cycle
      * pwm.setDutyCycle(7.5);   // 7.5% for servo center position
      * @endcode
+     * 
+     * @note After begin() this is a single pwrite() to an already open
+     *       duty_cycle descriptor, with no heap allocation
      */
     bool setDutyCycle(double percent);
     
@@ -281,6 +288,9 @@ public:
     static bool gpioToPWM(int gpioPin, int& chip, int& channel);
 
 private:
+    friend class HardwarePWMGroup;
+    friend class Transaction;
+    
     int chip_;                      ///< PWM chip number
     int channel_;                   ///< PWM channel number
     bool exported_;                 ///< Whether PWM is currently exported
@@ -291,6 +301,9 @@ private:
     
     std::string basePath_;          ///< Base path: /sys/class/pwm/pwmchipN/
     std::string pwmPath_;           ///< PWM path: /sys/class/pwm/pwmchipN/pwmM/
+    int periodFd_;                  ///< Open "period" attribute (-1 if closed)
+    int dutyCycleFd_;               ///< Open "duty_cycle" attribute (-1 if closed)
+    int enableFd_;                  ///< Open "enable" attribute (-1 if closed)
     
     /**
      * @brief Export PWM channel to sysfs
@@ -304,6 +317,36 @@ private:
      */
     bool unexportPWM();
     
+    /**
+     * @brief Open period, duty_cycle and enable once the channel is exported
+     *
+     * Attributes that cannot be opened fall back to writeFile().
+     */
+    void openAttributes();
+    
+    /**
+     * @brief Close the attribute descriptors opened by openAttributes()
+     */
+    void closeAttributes();
+    
+    /**
+     * @brief Write a number to an attribute with one pwrite() and no allocation
+     * @param fd Descriptor from openAttributes(), or -1 to use writeFile()
+     * @param filename Attribute name (fallback and log messages)
+     * @param value Value to write
+     * @return true on success, false on error
+     */
+    bool writeAttribute(int fd, const char* filename, uint64_t value);
+    
+    /**
+     * @brief Apply a change merged by a Transaction, writing each attribute at most once
+     * @param frequencyHz New frequency, 0 to keep the period
+     * @param dutyPercent Duty cycle in percent of the new period, negative for none
+     * @param dutyNs Duty cycle in ns if dutyPercent is negative, UINT64_MAX for none
+     * @return true on success, false on error
+     */
+    bool applyChange(uint32_t frequencyHz, double dutyPercent, uint64_t dutyNs);
+    
     /**
      * @brief Write value to sysfs file
      * @param filename Relative filename in PWM path
@@ -321,6 +364,112 @@ private:
     bool readFile(const std::string& filename, std::string& value) const;
 };
 
+/**
+ * @class HardwarePWMGroup
+ * @brief Commit staged period/duty updates to several channels back-to-back
+ * 
+ * Motor drivers and H-bridges want both channels to change in the same
+ * PWM period. Values are converted and formatted when staged, so commit()
+ * only takes the channel locks and issues one pwrite() per attribute on
+ * the descriptors each HardwarePWM already holds open. The time between
+ * the first and the last channel's final write is reported as the commit
+ * skew.
+ * 
+ * Example:
+ * @code
+ * HardwarePWM left(0, 0), right(0, 1);
+ * left.begin(20000);
+ * right.begin(20000);
+ * 
+ * HardwarePWMGroup motors({&left, &right});
+ * motors.stageDutyCycle(0, 60.0);
+ * motors.stageDutyCycle(1, 40.0);
+ * motors.commit();
+ * uint64_t skew = motors.getLastCommitSkewNs();
+ * @endcode
+ * 
+ * @note Channels must outlive the group and be started with begin()
+ * @note Stage a new period before any percentage duty cycle that depends on it
+ */
+class HardwarePWMGroup {
+public:
+    /**
+     * @brief Group existing channels (index in the list is the channel index)
+     * @param channels Non-owning pointers, none may be nullptr
+     * @throws InvalidPinError if the list is empty or contains nullptr
+     */
+    explicit HardwarePWMGroup(const std::vector<HardwarePWM*>& channels);
+    
+    /**
+     * @brief Stage a duty cycle percentage (0.0-100.0) for one channel
+     * @return false if index is out of range or the period is unknown
+     */
+    bool stageDutyCycle(size_t index, double percent);
+    
+    /**
+     * @brief Stage a duty cycle in nanoseconds for one channel
+     * @return false if index is out of range
+     */
+    bool stageDutyCycleNs(size_t index, uint64_t nanoseconds);
+    
+    /**
+     * @brief Stage a period in nanoseconds for one channel
+     * @return false if index is out of range or nanoseconds is 0
+     */
+    bool stagePeriodNs(size_t index, uint64_t nanoseconds);
+    
+    /**
+     * @brief Drop all staged values
+     */
+    void clear();
+    
+    /**
+     * @brief Write every staged value, channels back-to-back
+     * 
+     * Period changes go first (ordered against the current duty so the
+     * kernel never sees duty > period), then all duty writes in one burst.
+     * 
+     * @return true if every write succeeded; staged values are cleared either way
+     */
+    bool commit();
+    
+    /**
+     * @brief Time between the first and last channel's final write in the last commit()
+     * @return Skew in nanoseconds (0 for single-channel commits)
+     */
+    uint64_t getLastCommitSkewNs() const { return lastSkewNs_; }
+    
+    /**
+     * @brief Number of channels in the group
+     */
+    size_t size() const { return channels_.size(); }
+
+private:
+    /**
+     * @brief Values waiting for commit(), already formatted
+     */
+    struct Staged {
+        bool hasPeriod = false;
+        bool hasDuty = false;
+        uint64_t periodNs = 0;
+        uint64_t dutyCycleNs = 0;
+        char periodText[24] = {};
+        size_t periodLength = 0;
+        char dutyText[24] = {};
+        size_t dutyLength = 0;
+    };
+    
+    /**
+     * @brief Write preformatted text to an attribute (open fd or writeFile() fallback)
+     */
+    static bool writeText(HardwarePWM& channel, int fd, const char* filename,
+                          const char* text, size_t length);
+    
+    std::vector<HardwarePWM*> channels_;   ///< Grouped channels (not owned)
+    std::vector<Staged> staged_;           ///< Pending values per channel
+    uint64_t lastSkewNs_;                  ///< Skew measured by the last commit()
+};
+
 } // namespace pipinpp
 
 #endif // PIPINPP_HARDWARE_PWM_HPP
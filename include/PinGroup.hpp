@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file PinGroup.hpp
+ * @brief Multi-line GPIO group for parallel bus writes and reads
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * PinGroup requests several GPIO lines in a single libgpiod line request,
+ * so a whole parallel bus (LCD data lines, 7-segment displays, R-2R DACs)
+ * can be updated or sampled with one ioctl instead of one per pin. Bits
+ * written in the same call change in the same kernel transaction, which
+ * removes the inter-bit skew you get from a loop of Pin::write() calls.
+ *
+ * Bit i of every mask/value corresponds to pins[i] as passed to the
+ * constructor (not to the GPIO number).
+ *
+ * Output groups keep the last written state locally (and in the chip's
+ * OutputShadow), so masked writes, setBits()/clearBits()/toggleBits() and
+ * getOutputState() never read the lines back, and lines already at the
+ * requested level are left out of the transaction.
+ *
+ * Example usage:
+ * @code
+ * #include "PinGroup.hpp"
+ *
+ * // 8-bit data bus on GPIO 5,6,12,13,16,19,20,21 (bit 0 = GPIO5)
+ * PinGroup bus({5, 6, 12, 13, 16, 19, 20, 21}, PinDirection::OUTPUT);
+ * bus.writeAll(0xA5);              // All 8 lines in one syscall
+ * bus.writeMask(0x0F, 0x03);       // Only touch the low nibble
+ *
+ * PinGroup inputs({22, 23, 24}, PinMode::INPUT_PULLUP);
+ * int64_t state = inputs.readAll(); // bit 0 = GPIO22, -1 on error
+ * @endcode
+ *
+ * @author
+ * HobbyHacker / Barbatos6669
+ * @version 0.4.0
+ * @date    2025-11-21
+ */
+
+#pragma once
+
+#include "pin.hpp"
+#include "chip_registry.hpp"
+#include <gpiod.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A group of GPIO lines controlled through a single line request
+ *
+ * All lines share one direction/mode and live on the same GPIO chip.
+ * Up to MAX_PINS lines can be grouped so that every mask fits in 64 bits.
+ */
+class PinGroup
+{
+public:
+    static constexpr size_t MAX_PINS = 64; ///< Maximum lines per group (one bit each)
+
+    /**
+     * @brief Construct a PinGroup with a direction
+     *
+     * @param pins GPIO pin numbers (0-27); bit i of masks maps to pins[i]
+     * @param direction The direction of every line in the group
+     * @param chipname The name of the GPIO chip (default: "gpiochip0")
+     * @throws InvalidPinError if the list is empty, too long, has duplicates or invalid pins
+     * @throws GpioAccessError if the chip cannot be opened or the lines cannot be requested
+     */
+    PinGroup(const std::vector<int>& pins, PinDirection direction, const std::string& chipname = "gpiochip0");
+
+    /**
+     * @brief Construct a PinGroup with a mode (including pull resistors)
+     *
+     * @param pins GPIO pin numbers (0-27); bit i of masks maps to pins[i]
+     * @param mode The pin mode applied to every line in the group
+     * @param chipname The name of the GPIO chip (default: "gpiochip0")
+     * @throws InvalidPinError if the list is empty, too long, has duplicates or invalid pins
+     * @throws GpioAccessError if the chip cannot be opened or the lines cannot be requested
+     */
+    PinGroup(const std::vector<int>& pins, PinMode mode, const std::string& chipname = "gpiochip0");
+
+    /**
+     * @brief Release the line request and close the chip
+     */
+    ~PinGroup();
+
+    PinGroup(const PinGroup&) = delete;
+    PinGroup& operator=(const PinGroup&) = delete;
+
+    /**
+     * @brief Write a subset of lines in one transaction
+     *
+     * Only lines whose bit is set in @p mask are changed; they take the
+     * corresponding bit of @p values. Lines outside the mask keep their state.
+     * Selected lines that already hold the requested level are skipped, so
+     * a write that changes nothing makes no syscall.
+     *
+     * @param mask Bit mask selecting which lines to update
+     * @param values New values for the selected lines
+     * @return true on success (including an empty mask), false on failure or for input groups
+     */
+    bool writeMask(uint64_t mask, uint64_t values);
+
+    /**
+     * @brief Drive the lines in @p mask HIGH (one transaction, no read)
+     */
+    bool setBits(uint64_t mask) { return writeMask(mask, ~uint64_t{0}); }
+
+    /**
+     * @brief Drive the lines in @p mask LOW (one transaction, no read)
+     */
+    bool clearBits(uint64_t mask) { return writeMask(mask, 0); }
+
+    /**
+     * @brief Invert the lines in @p mask (one transaction, no read)
+     */
+    bool toggleBits(uint64_t mask) { return writeMask(mask, ~outputState); }
+
+    /**
+     * @brief Last written state of every line, from the local shadow
+     *
+     * @return Bit i holds the level last written to pins[i], -1 for input groups
+     */
+    int64_t getOutputState() const;
+
+    /**
+     * @brief Write every line in the group in one transaction
+     *
+     * @param values Bit i drives pins[i]
+     * @return true on success, false on failure or for input groups
+     */
+    bool writeAll(uint64_t values);
+
+    /**
+     * @brief Read every line in the group in one transaction
+     *
+     * @return int64_t Bit i holds the state of pins[i], or -1 on error
+     */
+    int64_t readAll();
+
+    /**
+     * @brief Clock a buffer out on two lines of the group
+     *
+     * Each bit is one transaction setting the data line with the clock
+     * low, followed by one raising the clock (two ioctls per bit instead
+     * of three Pin::write() calls). Shift registers sample on the rising
+     * edge, so changing data together with the falling edge is safe. The
+     * clock is left low.
+     *
+     * @param dataBit Group bit of the data line
+     * @param clockBit Group bit of the clock line
+     * @param msbFirst true for most significant bit first
+     * @param data Bytes to send, in order
+     * @param length Number of bytes
+     * @param clockNs Data setup time and clock high time in nanoseconds
+     * @return false for input groups, invalid or equal bits, or on failure
+     */
+    bool shiftOut(size_t dataBit, size_t clockBit, bool msbFirst,
+                  const uint8_t* data, size_t length, uint32_t clockNs = 0);
+
+    /**
+     * @brief Clock several data lanes out in lockstep on a shared clock
+     *
+     * Group bits 0 .. laneCount-1 are the data lanes (e.g. one 74HC595
+     * chain each) and @p clockBit the clock they share. Every clock sets
+     * all lanes and lowers the clock in one transaction, then raises the
+     * clock in a second, so N chains take as long as one.
+     *
+     * @p data is interleaved: byte k of lane i is data[k * laneCount + i].
+     * Each group of up to 8 lanes is turned into per-clock masks with an
+     * 8x8 bit-matrix transpose (see transposeLanes()).
+     *
+     * @param laneCount Number of data lanes (1 .. size()-1)
+     * @param clockBit Group bit of the clock line (>= laneCount)
+     * @param msbFirst true for most significant bit first
+     * @param data laneCount * length bytes, interleaved
+     * @param length Bytes per lane
+     * @param clockNs Data setup time and clock high time in nanoseconds
+     * @return false for input groups, invalid lane/clock bits, or on failure
+     *
+     * @code
+     * // Four 74HC595 chains on GPIO 5,6,13,19 sharing a clock on GPIO 26
+     * PinGroup chains({5, 6, 13, 19, 26}, PinDirection::OUTPUT);
+     * uint8_t frame[4 * 3];            // 3 registers per chain
+     * chains.shiftOutLanes(4, 4, true, frame, 3);
+     * @endcode
+     */
+    bool shiftOutLanes(size_t laneCount, size_t clockBit, bool msbFirst,
+                       const uint8_t* data, size_t length, uint32_t clockNs = 0);
+
+    /**
+     * @brief Turn one byte per lane into one lane mask per clock
+     *
+     * @param bytes One byte per lane (lane i at bytes[i])
+     * @param laneCount Number of lanes (1-64)
+     * @param msbFirst Clock order of the bits within each byte
+     * @param masks Output: masks[j] holds the j-th bit to be clocked from
+     *        every lane (bit i = lane i)
+     */
+    static void transposeLanes(const uint8_t* bytes, size_t laneCount, bool msbFirst, uint64_t masks[8]);
+
+    /**
+     * @brief Number of lines in the group
+     */
+    size_t size() const { return offsets.size(); }
+
+    /**
+     * @brief GPIO line offsets in bit order
+     */
+    const std::vector<unsigned int>& pins() const { return offsets; }
+
+private:
+    std::shared_ptr<pipinpp::GpioChip> chip; ///< Shared GPIO chip handle (see ChipRegistry)
+    gpiod_line_request* request; ///< Single request covering every line
+    PinDirection currentDirection; ///< Direction shared by all lines
+    std::vector<unsigned int> offsets; ///< Line offsets, index == bit position
+    uint64_t allBits; ///< One bit per line in the group
+    uint64_t outputState; ///< Last written levels (outputs), bit i == pins[i]
+
+    /**
+     * @brief Mirror written levels of @p changed bits into the chip's OutputShadow
+     */
+    void recordOutputs(uint64_t changed, uint64_t values);
+
+    /**
+     * @brief Validate the pin list and copy it into offsets
+     * @throws InvalidPinError on empty/oversized lists, duplicates or out-of-range pins
+     */
+    void validatePins(const std::vector<int>& pins);
+
+    /**
+     * @brief Open the chip and request all lines with one configuration
+     * @throws GpioAccessError if GPIO hardware access fails
+     */
+    void initializeGpio(const std::string& chipname,
+                        gpiod_line_direction direction,
+                        gpiod_line_bias bias);
+};
@@ -44,9 +44,19 @@
 #ifndef PIPINPP_SPI_HPP
 #define PIPINPP_SPI_HPP
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+#include "backend.hpp"
+#include "error_code.hpp"
 
 namespace pipinpp {
 
@@ -68,6 +78,123 @@ constexpr uint8_t SPI_CLOCK_DIV32 = 32;
 constexpr uint8_t SPI_CLOCK_DIV64 = 64;
 constexpr uint8_t SPI_CLOCK_DIV128 = 128;
 
+/**
+ * @brief Largest number of segments sent in one SPI_IOC_MESSAGE ioctl
+ *
+ * Limited by the 14-bit ioctl size field (16383 / sizeof(spi_ioc_transfer)).
+ */
+constexpr size_t SPI_MAX_BATCH_SEGMENTS = 511;
+
+/**
+ * @brief One segment of a batched SPI message
+ *
+ * Maps directly onto a struct spi_ioc_transfer. Either buffer may be null
+ * for write-only or read-only segments (a null tx sends zeros).
+ */
+struct SpiSegment {
+    const uint8_t* tx = nullptr;   ///< Data to send, or nullptr
+    uint8_t* rx = nullptr;         ///< Buffer for received data, or nullptr
+    size_t length = 0;             ///< Bytes in this segment
+    uint32_t speedHz = 0;          ///< Clock for this segment, 0 for the current setClock() value
+    uint16_t delayUs = 0;          ///< Delay after the segment, before CS changes
+    uint8_t bitsPerWord = 0;       ///< Word size, 0 for 8 bits
+    bool csChange = false;         ///< Deselect CS after this segment (before the next one)
+};
+
+class SPIClass;
+
+/**
+ * @brief SPI message laid out as spi_ioc_transfer entries once, sent many times
+ *
+ * SPIClass::prepare() does the per-segment work of transferBatch() (filling
+ * spi_ioc_transfer and splitting into messages under the spidev limits)
+ * ahead of time; SPIClass::transferPrepared() then only takes the lock and
+ * issues the ioctls. Used for fixed, repeated transfers such as ADC sample
+ * blocks.
+ *
+ * The segments' buffers must stay at the same address for as long as the
+ * message is used. The clock and word size are fixed when it is prepared.
+ */
+class SpiPreparedMessage {
+public:
+    /**
+     * @brief spi_ioc_transfer entries in the message
+     */
+    size_t transferCount() const;
+    
+    /**
+     * @brief ioctls transferPrepared() issues
+     */
+    size_t ioctlCount() const { return messages_.size(); }
+    
+    bool empty() const { return messages_.empty(); }
+    
+private:
+    friend class SPIClass;
+    
+    std::vector<unsigned char> transfers_;   ///< spi_ioc_transfer array
+    std::vector<size_t> messages_;           ///< Transfers per ioctl
+};
+
+/**
+ * @brief Per-device SPI settings (Arduino SPISettings)
+ *
+ * Pass to SPIClass::beginTransaction() before talking to a device. Devices
+ * sharing a bus can each keep their own SPISettings; only what differs
+ * from the previous device is reprogrammed.
+ */
+class SPISettings {
+public:
+    /**
+     * @param clockHz Maximum clock speed in Hz
+     * @param bitOrder MSBFIRST (1) or LSBFIRST (0)
+     * @param dataMode SPI_MODE0-SPI_MODE3
+     */
+    SPISettings(uint32_t clockHz = 4000000, uint8_t bitOrder = 1, uint8_t dataMode = SPI_MODE0)
+        : clock(clockHz), bitOrder(bitOrder), dataMode(dataMode) {}
+    
+    bool operator==(const SPISettings& other) const {
+        return clock == other.clock && bitOrder == other.bitOrder && dataMode == other.dataMode;
+    }
+    bool operator!=(const SPISettings& other) const { return !(*this == other); }
+    
+    uint32_t clock;     ///< Clock speed in Hz
+    uint8_t bitOrder;   ///< MSBFIRST or LSBFIRST
+    uint8_t dataMode;   ///< SPI mode (0-3)
+};
+
+/**
+ * @brief Queue lane for asynchronous SPI transactions
+ */
+enum class SpiPriority {
+    HIGH,     ///< Latency-sensitive work (sensor reads); always runs first
+    NORMAL    ///< Bulk work (display pushes)
+};
+
+/**
+ * @brief A queued SPI transaction: device settings plus segments
+ *
+ * Each transaction carries the settings of the device it talks to. The
+ * I/O thread only reconfigures the bus when they differ from the
+ * transaction that ran before.
+ *
+ * Buffers referenced by the segments must stay valid until the
+ * completion callback runs.
+ */
+struct SpiTransaction {
+    std::vector<SpiSegment> segments;          ///< Segments sent as one batch
+    SPISettings settings;                      ///< Device clock, bit order and mode
+    SpiPriority priority = SpiPriority::NORMAL; ///< Queue lane
+};
+
+/**
+ * @brief Completion callback for an asynchronous transaction
+ *
+ * Runs on the SPI I/O thread; @p success is false if the transfer failed
+ * or the queue was shut down by end() before it ran.
+ */
+using SpiCompletion = std::function<void(bool success)>;
+
 /**
  * @class SPIClass
  * @brief Arduino-compatible SPI master communication class
@@ -228,6 +355,34 @@ public:
      */
     uint32_t getClock() const;
     
+    /**
+     * @brief Claim the bus and switch to a device's settings
+     * 
+     * Arduino-style: the bus is reserved for the calling thread (and the
+     * asynchronous queue waits) until endTransaction(). Only settings that
+     * changed are reprogrammed; the clock travels with each transfer and
+     * never needs an ioctl of its own.
+     * 
+     * @param settings Clock, bit order and mode of the device
+     * 
+     * @note Do not call waitForPending() inside a transaction
+     * 
+     * @example
+     * SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE3));
+     * digitalWrite(CS_PIN, LOW);
+     * SPI.transfer(buffer, 4);
+     * digitalWrite(CS_PIN, HIGH);
+     * SPI.endTransaction();
+     */
+    void beginTransaction(const SPISettings& settings);
+    
+    /**
+     * @brief Release the bus claimed by beginTransaction()
+     * 
+     * @note Ignored when the calling thread has no open transaction
+     */
+    void endTransaction();
+    
     /* ------------------------------------------------------------ */
     /*                   DATA TRANSFER                              */
     /* ------------------------------------------------------------ */
@@ -259,6 +414,8 @@ public:
      * @param length Number of bytes to transfer
      * 
      * @note Buffer is modified in-place (sent data replaced with received data)
+     * @note Lengths over getMaxTransferSize() are split automatically;
+     *       use transferStream() to find out whether the transfer succeeded
      * 
      * @example
      * uint8_t data[] = {0x01, 0x02, 0x03};
@@ -286,6 +443,154 @@ public:
      */
     void transfer(const uint8_t* txBuffer, uint8_t* rxBuffer, size_t length);
     
+    /**
+     * @brief Full-duplex transfer that reports why it failed
+     * 
+     * transfer() silently returns nothing on error; this returns the
+     * reason without exceptions or allocation (see error_code.hpp).
+     * 
+     * @param txBuffer Bytes to send (nullptr sends zeros)
+     * @param rxBuffer Receives @p length bytes (nullptr discards them)
+     * @param length Number of bytes
+     * @return Empty on success; GpioErrc::NOT_OPEN before begin(),
+     *         GpioErrc::INVALID_ARGUMENT, or the ioctl's errno
+     */
+    std::error_code tryTransfer(const uint8_t* txBuffer, uint8_t* rxBuffer, size_t length) noexcept;
+    
+    /**
+     * @brief Send several segments as one SPI message
+     * 
+     * All segments go to the kernel in a single SPI_IOC_MESSAGE(N) ioctl
+     * under one lock, so a command/data sequence costs one syscall instead
+     * of one per segment. CS stays asserted across segments unless a
+     * segment sets csChange.
+     * 
+     * @param segments Segments to transfer, in order
+     * @param count Number of segments
+     * @return true if every segment was transferred, false on error
+     * 
+     * @note Batches over SPI_MAX_BATCH_SEGMENTS segments or the spidev
+     *       bufsiz limit are split into several messages, keeping CS
+     *       asserted across the split
+     * 
+     * @example
+     * uint8_t cmd[] = {0x2C};          // Display: memory write
+     * SpiSegment segs[2];
+     * segs[0].tx = cmd;
+     * segs[0].length = 1;
+     * segs[1].tx = pixels;
+     * segs[1].length = pixelBytes;
+     * segs[1].speedHz = 32000000;      // Faster clock for the bulk data
+     * SPI.transferBatch(segs, 2);
+     */
+    bool transferBatch(const SpiSegment* segments, size_t count);
+    
+    /**
+     * @brief Send several segments as one SPI message
+     * 
+     * @param segments Segments to transfer, in order
+     * @return true if every segment was transferred, false on error
+     */
+    bool transferBatch(const std::vector<SpiSegment>& segments);
+    
+    /**
+     * @brief Stream a buffer of any size, reporting errors
+     * 
+     * spidev refuses messages longer than its bufsiz parameter (4096 bytes
+     * by default). The buffer is split into the largest chunks that fit,
+     * sent back to back with CS kept asserted, so a 150 KB framebuffer
+     * goes out as one transaction in ~38 ioctls.
+     * 
+     * @param txBuffer Data to send, or nullptr to send zeros
+     * @param rxBuffer Buffer for received data, or nullptr to discard
+     * @param length Number of bytes
+     * @return true on success, false if not initialized or an ioctl failed
+     * 
+     * @example
+     * std::vector<uint8_t> frame(320 * 240 * 2);
+     * if (!SPI.transferStream(frame.data(), nullptr, frame.size())) {
+     *     // Handle error
+     * }
+     */
+    bool transferStream(const uint8_t* txBuffer, uint8_t* rxBuffer, size_t length);
+    
+    /**
+     * @brief Get the largest number of bytes spidev accepts per message
+     * 
+     * @return spidev bufsiz as read by begin() (4096 if unknown)
+     */
+    size_t getMaxTransferSize() const;
+    
+    /**
+     * @brief Lay segments out for repeated transferPrepared() calls
+     * 
+     * @param segments Segments, as for transferBatch()
+     * @param count Number of segments
+     * @param message Receives the prepared message (replaced)
+     * @return false if the bus is not open or a segment is empty
+     * 
+     * @example
+     * SpiSegment samples[1024];          // 3 bytes each, csChange = true
+     * SpiPreparedMessage block;
+     * SPI.prepare(samples, 1024, block); // 3 ioctls of up to 511 transfers
+     * while (running) {
+     *     SPI.transferPrepared(block);   // No per-sample work
+     * }
+     */
+    bool prepare(const SpiSegment* segments, size_t count, SpiPreparedMessage& message) const;
+    
+    /**
+     * @brief Send a message built by prepare()
+     * 
+     * @return true if every ioctl succeeded, false on error or an empty message
+     */
+    bool transferPrepared(const SpiPreparedMessage& message);
+    
+    /* ------------------------------------------------------------ */
+    /*                   ASYNCHRONOUS QUEUE                         */
+    /* ------------------------------------------------------------ */
+    
+    /**
+     * @brief Queue a transaction for the SPI I/O thread
+     * 
+     * Returns immediately. The I/O thread ("pipinpp-spi<bus>.<cs>", started on the
+     * first submit) runs HIGH transactions before NORMAL ones, so a sensor
+     * read does not wait behind queued display frames. Each transaction
+     * holds the bus for its whole batch.
+     * 
+     * @param transaction Settings and segments; moved into the queue
+     * @param onComplete Optional callback when done (runs on the I/O thread)
+     * @return true if queued, false if the transaction is empty or its
+     *         mode is invalid
+     * 
+     * @note Never waits for a transfer in progress. If the bus is not
+     *       open when the transaction runs, it completes with false
+     * 
+     * @note After a transaction runs, the bus keeps its settings; the next
+     *       synchronous transfer uses them too
+     * 
+     * @example
+     * SpiTransaction read;
+     * read.priority = SpiPriority::HIGH;
+     * read.settings = SPISettings(1000000, MSBFIRST, SPI_MODE3);
+     * read.segments.resize(1);
+     * read.segments[0].tx = cmd;
+     * read.segments[0].rx = reply;
+     * read.segments[0].length = 4;
+     * SPI.submit(std::move(read), [](bool ok) { ... });
+     */
+    bool submit(SpiTransaction transaction, SpiCompletion onComplete = nullptr);
+    
+    /**
+     * @brief Block until every submitted transaction has completed
+     */
+    void waitForPending();
+    
+    /**
+     * @brief Get number of transactions queued or running
+     */
+    size_t getPendingCount() const;
+    
     /* ------------------------------------------------------------ */
     /*                   HELPER FUNCTIONS                           */
     /* ------------------------------------------------------------ */
@@ -298,7 +603,7 @@ public:
     bool isInitialized() const;
     
 private:
-    int fd_;                    ///< SPI device file descriptor
+    std::unique_ptr<DeviceFile> device_; ///< Open SPI device (real or simulated)
     int busNumber_;             ///< SPI bus number
     int csNumber_;              ///< Chip select number
     uint8_t mode_;              ///< SPI mode (0-3)
@@ -306,18 +611,91 @@ private:
     uint32_t speed_;            ///< Clock speed in Hz
     uint8_t bitsPerWord_;       ///< Bits per word (always 8)
     mutable std::mutex mutex_;  ///< Thread safety mutex
+    size_t bufsiz_;             ///< spidev per-message byte limit
+    bool settingsValid_;        ///< appliedMode_/appliedBits_ reflect the device
+    uint8_t appliedMode_;       ///< Last SPI_IOC_WR_MODE value (mode | LSB flag)
+    uint8_t appliedBits_;       ///< Last SPI_IOC_WR_BITS_PER_WORD value
+    std::mutex transactionMutex_;            ///< Held between begin/endTransaction()
+    std::atomic<std::thread::id> transactionOwner_;  ///< Thread holding transactionMutex_
+    
+    /**
+     * @brief Queued transaction with its callback
+     */
+    struct Pending {
+        SpiTransaction transaction;
+        SpiCompletion onComplete;
+    };
+    
+    std::thread ioThread_;                   ///< Runs queued transactions
+    mutable std::mutex queueMutex_;          ///< Protects the lanes and counters
+    std::condition_variable queueCv_;        ///< Wakes the I/O thread
+    std::condition_variable idleCv_;         ///< Signals waitForPending()
+    std::deque<Pending> highLane_;           ///< SpiPriority::HIGH queue
+    std::deque<Pending> normalLane_;         ///< SpiPriority::NORMAL queue
+    size_t pending_ = 0;                     ///< Queued plus running
+    bool ioRunning_ = false;                 ///< I/O thread should keep running
+    std::vector<unsigned char> batch_;  ///< Reused spi_ioc_transfer array for sendSegments()
+    std::vector<size_t> batchMessages_; ///< Transfers per ioctl in batch_
     
     static constexpr uint32_t DEFAULT_SPEED = 4000000;  ///< Default 4 MHz
     static constexpr uint32_t BASE_CLOCK = 250000000;   ///< Pi base clock (250 MHz)
+    static constexpr size_t DEFAULT_BUFSIZ = 4096;      ///< spidev default bufsiz
     
     /**
      * @brief Apply current configuration to device
      * 
-     * Updates device with current mode, speed, bit order settings.
+     * Issues only the ioctls whose value differs from what was last
+     * applied. The speed ioctl is only sent after begin(); later speed
+     * changes ride in spi_ioc_transfer.speed_hz.
      * 
      * @return true if successful, false on error
      */
     bool applySettings();
+    
+    /**
+     * @brief Read the spidev bufsiz module parameter
+     */
+    static size_t readBufsiz();
+    
+    /**
+     * @brief Send segments in as few messages as the spidev limits allow
+     * 
+     * @return true on success, false (logged) if an ioctl failed
+     * @note Mutex must be held by caller
+     */
+    bool sendSegments(const SpiSegment* segments, size_t count);
+    
+    /**
+     * @brief Lay segments out as spi_ioc_transfer entries split into messages
+     * 
+     * @param transfers Receives the spi_ioc_transfer array
+     * @param messages Receives the number of transfers of each message
+     * @note Mutex must be held by caller
+     */
+    void packSegments(const SpiSegment* segments, size_t count,
+                      std::vector<unsigned char>& transfers, std::vector<size_t>& messages) const;
+    
+    /**
+     * @brief Issue one SPI_IOC_MESSAGE ioctl per message of a packed array
+     * 
+     * @note Mutex must be held by caller
+     */
+    bool sendPacked(const std::vector<unsigned char>& transfers, const std::vector<size_t>& messages);
+    
+    /**
+     * @brief Run one queued transaction (takes mutex_)
+     */
+    bool runTransaction(const SpiTransaction& transaction);
+    
+    /**
+     * @brief I/O thread: pops HIGH before NORMAL and runs each transaction
+     */
+    void ioThreadFunction();
+    
+    /**
+     * @brief Stop the I/O thread, failing anything still queued
+     */
+    void stopQueue();
 };
 
 // Global SPI instance (Arduino compatibility)
@@ -328,6 +706,10 @@ extern SPIClass SPI;
 // Allow usage without namespace (Arduino compatibility)
 using pipinpp::SPI;
 using pipinpp::SPIClass;
+using pipinpp::SPISettings;
+using pipinpp::SpiSegment;
+using pipinpp::SpiTransaction;
+using pipinpp::SpiPriority;
 using pipinpp::SPI_MODE0;
 using pipinpp::SPI_MODE1;
 using pipinpp::SPI_MODE2;
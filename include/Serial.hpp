@@ -35,7 +35,14 @@
 #include <vector>
 #include <cstdint>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <thread>
 #include <termios.h>
+#include "spsc_ring.hpp"
+#include "serial_framing.hpp"
 
 namespace pipinpp {
 
@@ -47,6 +54,32 @@ enum PrintFormat {
     BIN = 2     ///< Binary format (base 2)
 };
 
+/**
+ * @brief Default receive ring size for beginRxThread() (bytes)
+ * 
+ * About 0.7 s of data at 921600 baud.
+ */
+constexpr size_t SERIAL_RX_DEFAULT_BUFFER = 65536;
+
+/**
+ * @brief Size of the per-port print()/println() formatting buffer (bytes)
+ */
+constexpr size_t SERIAL_TX_BUFFER_SIZE = 512;
+
+/**
+ * @brief Default transmit queue size for beginTxThread() (bytes)
+ */
+constexpr size_t SERIAL_TX_DEFAULT_QUEUE = 16384;
+
+/**
+ * @brief What a write does when the transmit queue is full
+ */
+enum class SerialBackpressure {
+    BLOCK,        ///< Wait for the writer thread to make room
+    DROP_OLDEST,  ///< Discard the oldest queued bytes (not yet being written)
+    ERROR         ///< Reject the whole write (returns 0)
+};
+
 
 
 /**
@@ -101,7 +134,9 @@ public:
     
     /**
      * @brief Open serial port with specified baud rate
-     * @param baudRate Communication speed (9600, 19200, 38400, 57600, 115200, etc.)
+     * @param baudRate Communication speed (9600, 19200, 38400, 57600, 115200, etc.);
+     *                 rates outside the standard table (250000, 3000000, ...) are set
+     *                 through termios2, see getActualBaudRate()
      * @param device Serial device path (default: "/dev/ttyUSB0")
      * @return true if port opened successfully, false on error
      * 
@@ -128,10 +163,22 @@ public:
      */
     bool isOpen() const;
     
+    /**
+     * @brief File descriptor of the open port, for poll()/epoll/asyncio
+     * 
+     * Readable when received bytes are waiting in the kernel. While the
+     * receive thread is running it drains the kernel buffer, so watch
+     * available() instead.
+     * 
+     * @return The fd (owned by this object), or -1 if the port is closed
+     */
+    int getFd() const;
+    
     /**
      * @brief Get number of bytes available for reading
      * @return Number of bytes in receive buffer
      * @note Returns 0 if port not open or no data available
+     * @note With the receive thread running this is the ring fill level (no syscall)
      */
     int available();
     
@@ -327,23 +374,258 @@ public:
     
     /**
      * @brief Flush transmit buffer (wait for all data to be sent)
-     * @note Blocks until all pending data transmitted
+     * @note Writes any print() output held by setTxBuffering(), then blocks
+     *       until all pending data transmitted
      */
     void flush();
     
+    /**
+     * @brief Batch print()/println() output into fewer write() calls
+     * 
+     * print() and println() always format into a fixed per-port buffer
+     * without heap allocation. With @p threshold = 0 (default) every call
+     * is written immediately, one write() per call. Otherwise output
+     * accumulates until println() ends a line, @p threshold bytes are
+     * pending, flush() or a raw write() is called, so a line built from
+     * many fields goes out in one write().
+     * 
+     * @param threshold Pending bytes that force a write (0 = unbuffered,
+     *                  capped at SERIAL_TX_BUFFER_SIZE)
+     * @note Call flush() before waiting for a reply to a print() without newline
+     * 
+     * @example
+     * Serial.setTxBuffering(SERIAL_TX_BUFFER_SIZE);
+     * Serial.print(ax); Serial.print(','); ...
+     * Serial.println(az);   // One write() for the whole line
+     */
+    void setTxBuffering(size_t threshold);
+    
+    /**
+     * @brief Bytes of print() output waiting in the TX buffer
+     */
+    size_t getTxPending() const;
+    
     /**
      * @brief Get current baud rate
      * @return Baud rate, or 0 if port not open
      */
     unsigned long getBaudRate() const;
+    
+    /**
+     * @brief Baud rate the driver actually programmed
+     * 
+     * Rates from the standard table and custom ones passed to begin()
+     * (e.g. 250000 or 3000000, set through termios2) are rounded to the
+     * nearest divisor the UART clock allows.
+     * 
+     * @return Bits per second, or 0 if port not open
+     */
+    unsigned long getActualBaudRate() const;
+    
+    /**
+     * @brief Deliver received bytes without driver/adapter batching
+     * 
+     * Sets ASYNC_LOW_LATENCY and, on USB-serial adapters such as FTDI, the
+     * latency timer (16 ms default, 1 ms when enabled; needs write access
+     * to sysfs).
+     * 
+     * @param enable true for low latency, false for the driver default
+     * @return true if the setting was applied
+     */
+    bool setLowLatency(bool enable = true);
+    
+    /**
+     * @brief Read up to @p length bytes, waiting up to the timeout
+     * @param buffer Destination
+     * @param length Bytes wanted
+     * @return Bytes read (less than @p length on timeout)
+     * @note Arduino readBytes(); copies in bulk instead of byte by byte
+     */
+    size_t readBytes(uint8_t* buffer, size_t length);
+    
+    /**
+     * @brief Read into @p buffer until @p terminator, @p length bytes or the timeout
+     * @param terminator Byte that ends the read (consumed, not stored)
+     * @param buffer Destination
+     * @param length Capacity of @p buffer
+     * @return Bytes stored, excluding the terminator
+     * @note Arduino readBytesUntil(); the allocation-free counterpart of
+     *       readStringUntil() for code that reads lines in a loop
+     */
+    size_t readBytesUntil(char terminator, uint8_t* buffer, size_t length);
+    
+    /**
+     * @brief Receive on a background thread into a lock-free ring buffer
+     * 
+     * A "pipinpp-uart" thread sleeps in poll() and drains the UART in bulk
+     * as soon as data arrives, so the kernel buffer cannot overrun while
+     * the application is busy. available(), read() and peek() then become
+     * memory operations on the ring instead of syscalls.
+     * 
+     * Stays enabled across begin()/end() until endRxThread().
+     * 
+     * @param bufferSize Ring size in bytes (rounded up to a power of two)
+     * @return true if the thread is running (or the port is not open yet)
+     * 
+     * @example
+     * Serial.begin(921600, "/dev/ttyAMA0");
+     * Serial.beginRxThread();
+     * uint8_t frame[64];
+     * size_t n = Serial.readBytes(frame, sizeof(frame));
+     */
+    bool beginRxThread(size_t bufferSize = SERIAL_RX_DEFAULT_BUFFER);
+    
+    /**
+     * @brief Stop the receive thread and return to direct reads
+     * @note Bytes still in the ring are discarded
+     */
+    void endRxThread();
+    
+    /**
+     * @brief Check if the receive thread is running
+     */
+    bool isRxThreadRunning() const;
+    
+    /**
+     * @brief Bytes dropped because the receive ring was full
+     */
+    uint64_t getRxOverflowCount() const;
+    
+    /**
+     * @brief Transmit through a queue drained by a background writer thread
+     * 
+     * write(), print() and println() copy into the queue and return; a
+     * "pipinpp-uart-tx" thread sends everything pending with one writev()
+     * (the queue's two contiguous spans), so a slow UART neither blocks
+     * the caller per call nor loses short writes. flush() waits for the
+     * queue to drain before tcdrain().
+     * 
+     * Stays enabled across begin()/end() until endTxThread(). end() sends
+     * whatever is still queued before closing.
+     * 
+     * @param queueSize Queue capacity in bytes
+     * @param policy What happens when the queue is full
+     * @return true if the thread is running (or the port is not open yet)
+     * 
+     * @example
+     * Serial.begin(115200, "/dev/ttyAMA0");
+     * Serial.beginTxThread(16384, SerialBackpressure::DROP_OLDEST);
+     * Serial.println(telemetry);   // Never waits for the UART
+     */
+    bool beginTxThread(size_t queueSize = SERIAL_TX_DEFAULT_QUEUE,
+                       SerialBackpressure policy = SerialBackpressure::BLOCK);
+    
+    /**
+     * @brief Send what is queued, stop the writer thread and return to direct writes
+     */
+    void endTxThread();
+    
+    /**
+     * @brief Check if the transmit thread is running
+     */
+    bool isTxThreadRunning() const;
+    
+    /**
+     * @brief Bytes waiting in the transmit queue
+     */
+    size_t getTxQueued() const;
+    
+    /**
+     * @brief Bytes discarded by SerialBackpressure::DROP_OLDEST
+     */
+    uint64_t getTxDroppedCount() const;
+    
+    /**
+     * @brief Decode incoming data as COBS or SLIP frames
+     * 
+     * The receive thread feeds every chunk it reads straight into a
+     * FrameDecoder, and @p callback runs on that thread once per frame
+     * whose CRC matches, with a view into the decoder's buffer. Received
+     * bytes no longer reach available()/read() while frame mode is on.
+     * 
+     * Starts the receive thread if needed; like it, frame mode stays
+     * enabled across begin()/end() until endFrameMode().
+     * 
+     * @param encoding Byte stuffing used by the sender
+     * @param crc Trailer to check and strip
+     * @param callback Called per valid frame; keep it short, the view is only valid during the call
+     * @param maxFrameSize Largest decoded frame, CRC included
+     * @return true if frame mode is active (or the port is not open yet)
+     * 
+     * @example
+     * Serial.beginFrameMode(FrameEncoding::COBS, FrameCrc::CRC16, [](FrameView frame) {
+     *     handleTelemetry(frame.data(), frame.size());
+     * });
+     * Serial.writeFrame(command, sizeof(command));
+     */
+    bool beginFrameMode(FrameEncoding encoding, FrameCrc crc, FrameCallback callback,
+                        size_t maxFrameSize = FRAME_DEFAULT_MAX_SIZE);
+    
+    /**
+     * @brief Return to byte-stream reads
+     */
+    void endFrameMode();
+    
+    /**
+     * @brief Check if frame mode is enabled
+     */
+    bool isFrameMode() const;
+    
+    /**
+     * @brief Encode and send one frame with the frame mode's encoding and CRC
+     * @param payload Frame contents
+     * @param length Payload length (up to the maxFrameSize given to beginFrameMode(), CRC excluded)
+     * @return Encoded bytes written or queued, 0 if not in frame mode or on error
+     */
+    size_t writeFrame(const uint8_t* payload, size_t length);
+    
+    /**
+     * @brief Frame decoder counters (all zero outside frame mode)
+     */
+    FrameStats getFrameStats() const;
 
 private:
     int fd_;                          ///< File descriptor for serial port
     unsigned long baudRate_;          ///< Current baud rate
-    unsigned long timeout_;           ///< Read timeout in milliseconds
+    std::atomic<unsigned long> timeout_; ///< Read timeout in milliseconds
     std::string device_;              ///< Device path (e.g., "/dev/ttyUSB0")
     mutable std::mutex mutex_;        ///< Mutex for thread safety
     
+    // Receive thread (see beginRxThread())
+    size_t rxBufferSize_;             ///< Ring size, 0 when the thread is disabled
+    std::unique_ptr<SpscRing<uint8_t>> rxRing_;  ///< Filled by rxThread_
+    std::thread rxThread_;            ///< Receive thread
+    std::atomic<bool> rxRunning_;     ///< Receive thread is (still) reading
+    int rxWakeFd_;                    ///< eventfd that stops the receive thread
+    std::mutex rxReadMutex_;          ///< Serializes consumers (ring is single-consumer)
+    std::mutex rxWaitMutex_;          ///< Guards rxCv_ waits
+    std::condition_variable rxCv_;    ///< Signalled when data arrives
+    std::atomic<int> rxWaiters_;      ///< Consumers blocked on rxCv_
+    std::atomic<uint64_t> rxOverflows_; ///< Bytes dropped on a full ring
+    std::unique_ptr<FrameDecoder> frameDecoder_; ///< Frame mode decoder, fed by rxLoop() instead of rxRing_
+    std::vector<uint8_t> frameTxBuffer_; ///< Reused encoding buffer for writeFrame()
+    
+    // print()/println() formatting (see setTxBuffering())
+    char txBuffer_[SERIAL_TX_BUFFER_SIZE]; ///< Formatted output not yet written
+    size_t txLength_;                 ///< Bytes pending in txBuffer_
+    size_t txThreshold_;              ///< Pending bytes that force a write, 0 = immediate
+    
+    // Transmit thread (see beginTxThread())
+    size_t txQueueSize_;              ///< Queue capacity, 0 when the thread is disabled
+    SerialBackpressure txPolicy_;     ///< Full-queue behaviour
+    std::unique_ptr<uint8_t[]> txQueue_; ///< Circular byte queue
+    size_t txTail_;                   ///< Index of the oldest queued byte
+    size_t txCount_;                  ///< Queued bytes
+    size_t txInFlight_;               ///< Bytes at the tail being written (not droppable)
+    bool txStopping_;                 ///< Writer should drain and exit
+    std::thread txThread_;            ///< Writer thread
+    std::atomic<bool> txRunning_;     ///< Writer thread is running
+    mutable std::mutex txQueueMutex_; ///< Guards the queue fields above
+    std::condition_variable txDataCv_;  ///< Writer: data queued or stop requested
+    std::condition_variable txSpaceCv_; ///< Producers: room freed
+    std::condition_variable txIdleCv_;  ///< flush(): queue fully written
+    std::atomic<uint64_t> txDropped_; ///< Bytes dropped by DROP_OLDEST
+    
     /**
      * @brief Configure termios settings for serial port
      * @param baudRate Desired baud rate
@@ -354,7 +636,7 @@ private:
     /**
      * @brief Convert baud rate integer to termios speed constant
      * @param baudRate Baud rate (e.g., 9600, 115200)
-     * @return termios speed_t constant, or 0 if invalid
+     * @return termios speed_t constant, or 0 if not a standard rate
      */
     speed_t getBaudRateConstant(unsigned long baudRate) const;
     
@@ -365,6 +647,84 @@ private:
      * @return Formatted string
      */
     std::string formatNumber(long num, int base) const;
+    
+    /**
+     * @brief Queue formatted text (plus optional line ending) for transmission
+     * @param endOfLine Text completes a line (forces a write when buffering)
+     * @return Bytes accepted, or 0 on error
+     */
+    size_t printText(const char* data, size_t length, bool endOfLine);
+    
+    /**
+     * @brief Format an integer without allocating and queue it
+     */
+    size_t printInteger(long long value, int base, bool endOfLine);
+    
+    /**
+     * @brief Format a fixed-point double without allocating and queue it
+     */
+    size_t printDouble(double value, int decimals, bool endOfLine);
+    
+    /**
+     * @brief Write everything in txBuffer_
+     * @return false on write error (pending bytes are dropped)
+     * @note Caller must hold mutex_
+     */
+    bool flushTxLocked();
+    
+    /**
+     * @brief Send bytes directly, or through the transmit queue when it runs
+     * @return Bytes written or queued
+     * @note Caller must hold mutex_
+     */
+    size_t sendLocked(const uint8_t* data, size_t length);
+    
+    /**
+     * @brief Copy bytes into the transmit queue, applying txPolicy_
+     * @return Bytes accepted
+     * @note Caller must hold mutex_
+     */
+    size_t enqueueTx(const uint8_t* data, size_t length);
+    
+    /**
+     * @brief Start the writer thread on the open port
+     * @note Caller must hold mutex_
+     */
+    bool startTxLocked();
+    
+    /**
+     * @brief Drain the queue, then stop and join the writer thread
+     * @note Caller must hold mutex_
+     */
+    void stopTxLocked();
+    
+    /**
+     * @brief Writer thread body
+     */
+    void txLoop();
+    
+    /**
+     * @brief Start the receive thread on the open port
+     * @note Caller must hold mutex_
+     */
+    bool startRxLocked();
+    
+    /**
+     * @brief Stop and join the receive thread, dropping the ring
+     * @note Caller must hold mutex_
+     */
+    void stopRxLocked();
+    
+    /**
+     * @brief Receive thread body
+     */
+    void rxLoop();
+    
+    /**
+     * @brief Wait until the ring holds @p count bytes or @p deadline passes
+     * @note Caller must hold rxReadMutex_
+     */
+    bool waitForRx(size_t count, std::chrono::steady_clock::time_point deadline);
 };
 
 } // namespace pipinpp
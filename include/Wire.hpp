@@ -48,11 +48,158 @@
 #include <cstdint>
 #include <cstddef>
 #include <vector>
+#include <memory>
 #include <mutex>
 #include <string>
+#include "backend.hpp"
+#include "error_code.hpp"
 
 namespace pipinpp {
 
+/**
+ * @brief Most i2c_msg entries the kernel accepts in one I2C_RDWR ioctl
+ * 
+ * Matches I2C_RDWR_IOCTL_MAX_MSGS in <linux/i2c-dev.h>.
+ */
+constexpr size_t WIRE_BATCH_MAX_MESSAGES = 42;
+
+/**
+ * @brief How WireClass::probe() tests for a device
+ */
+enum class I2cProbeMode {
+    AUTO,         ///< Like i2cdetect: READ_BYTE for 0x30-0x37 and 0x50-0x5F, else QUICK_WRITE
+    QUICK_WRITE,  ///< SMBus quick write (address + W, no data)
+    READ_BYTE     ///< SMBus receive byte (safe for EEPROMs and write-only-sensitive parts)
+};
+
+/**
+ * @class WireBatch
+ * @brief Reads and writes for any number of devices, sent in one I2C_RDWR ioctl
+ * 
+ * Each add call queues one operation (a register read is two i2c_msg entries,
+ * everything else one) and returns its index. WireClass::transfer() sends the
+ * whole batch with a single lock and as few ioctls as WIRE_BATCH_MAX_MESSAGES
+ * allows, then records a status per operation.
+ * 
+ * Write data is copied into the batch; read buffers must stay valid until
+ * transfer() returns. A batch can be reused: transfer() it again to repeat
+ * the same reads, or clear() it to build a new one.
+ * 
+ * @note The kernel runs an I2C_RDWR ioctl as one unit and only reports
+ *       whether all of its messages completed. When one fails, every
+ *       operation sent in the same ioctl is marked failed with that error,
+ *       even though some of them may have reached the bus.
+ * 
+ * @example
+ * uint8_t accel[6], gyro[6], temp[2];
+ * WireBatch batch;
+ * batch.readRegisters(0x68, 0x3B, accel, 6);   // MPU6050
+ * batch.readRegisters(0x69, 0x43, gyro, 6);    // Second IMU
+ * batch.readRegisters(0x48, 0x00, temp, 2);    // TMP102
+ * 
+ * Wire.transfer(batch);          // One syscall
+ * if (batch.ok(0)) { ... }
+ */
+class WireBatch {
+public:
+    /**
+     * @brief Queue a write of @p reg, repeated START, then a read of @p length bytes
+     * 
+     * @return Operation index, or -1 if arguments are invalid or the op cannot fit
+     */
+    int readRegisters(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length);
+    
+    /**
+     * @brief Queue a single-register read
+     * 
+     * @return Operation index, or -1 on invalid arguments
+     */
+    int readRegister(uint8_t address, uint8_t reg, uint8_t* value);
+    
+    /**
+     * @brief Queue a write of @p reg followed by @p length data bytes
+     * 
+     * @return Operation index, or -1 on invalid arguments
+     */
+    int writeRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length);
+    
+    /**
+     * @brief Queue a single-register write
+     * 
+     * @return Operation index, or -1 on invalid arguments
+     */
+    int writeRegister(uint8_t address, uint8_t reg, uint8_t value);
+    
+    /**
+     * @brief Queue a raw read (no register address)
+     * 
+     * @return Operation index, or -1 on invalid arguments
+     */
+    int read(uint8_t address, uint8_t* buffer, size_t length);
+    
+    /**
+     * @brief Queue a raw write
+     * 
+     * @return Operation index, or -1 on invalid arguments
+     */
+    int write(uint8_t address, const uint8_t* data, size_t length);
+    
+    /**
+     * @brief Remove all operations (keeps the reserved storage)
+     */
+    void clear();
+    
+    /**
+     * @brief Preallocate room for @p operations and @p writeBytes of payload
+     * 
+     * A batch that is reserved once and clear()ed between rounds queues
+     * and transfers without allocating.
+     */
+    void reserve(size_t operations, size_t writeBytes);
+    
+    /**
+     * @brief Number of queued operations
+     */
+    size_t size() const { return ops_.size(); }
+    
+    /**
+     * @brief Number of i2c_msg entries the operations need
+     */
+    size_t messageCount() const { return messages_; }
+    
+    /**
+     * @brief Result of an operation after WireClass::transfer()
+     * 
+     * @return 0 on success, an errno value (e.g. ENXIO for no ACK) on
+     *         failure, or -1 if not transferred yet / index out of range
+     */
+    int status(size_t index) const;
+    
+    /**
+     * @brief Whether an operation completed successfully
+     */
+    bool ok(size_t index) const { return status(index) == 0; }
+    
+private:
+    friend class WireClass;
+    
+    struct Op {
+        uint8_t address;         ///< 7-bit device address
+        size_t writeOffset;      ///< Start of write bytes in writeData_
+        uint16_t writeLength;    ///< Bytes to write (0 for a plain read)
+        uint8_t* readBuffer;     ///< Read destination, or nullptr
+        uint16_t readLength;     ///< Bytes to read (0 for a write)
+        int status;              ///< See status()
+    };
+    
+    int add(uint8_t address, const uint8_t* prefix, const uint8_t* data, size_t writeLength,
+            uint8_t* readBuffer, size_t readLength);
+    
+    std::vector<Op> ops_;
+    std::vector<uint8_t> writeData_;   ///< Copies of every write payload
+    size_t messages_ = 0;
+};
+
 /**
  * @class WireClass
  * @brief Arduino-compatible I2C master communication class
@@ -159,6 +306,11 @@ public:
      * Sends queued data to the I2C slave and releases the bus.
      * 
      * @param sendStop true to send STOP condition (default), false for repeated START
+     * 
+     * @note With sendStop = false the write is held back and sent together
+     *       with the next requestFrom() to the same address as one I2C_RDWR
+     *       transaction (write, repeated START, read). The return value is
+     *       then 0, and write errors are reported by requestFrom()
      * @return 0 = success
      *         1 = data too long for transmit buffer
      *         2 = NACK on transmit of address
@@ -381,15 +533,54 @@ public:
      * @example
      * uint8_t accel[6];
      * Wire.readRegisters(0x68, 0x3B, accel, 6);  // Read accel X, Y, Z
+     * 
+     * @note One I2C_RDWR ioctl: register write, repeated START, then the
+     *       read straight into @p buffer
      */
     int readRegisters(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length);
     
+    /**
+     * @brief Write multiple bytes to consecutive device registers
+     * 
+     * Sends the register address followed by the data in one message.
+     * 
+     * @param address I2C device address
+     * @param reg Starting register address
+     * @param data Bytes to write
+     * @param length Number of bytes (at most BUFFER_SIZE - 1)
+     * @return true if successful, false on error
+     * 
+     * @example
+     * uint8_t config[] = {0x00, 0x18};
+     * Wire.writeRegisters(0x68, 0x1B, config, 2);  // Gyro + accel ranges
+     */
+    bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length);
+    
+    /**
+     * @brief readRegisters() that reports why it failed
+     * 
+     * No exceptions or allocation (see error_code.hpp). A device that
+     * does not acknowledge compares equal to std::errc::no_such_device_or_address.
+     * 
+     * @return Empty when all @p length bytes were read; GpioErrc::NOT_OPEN
+     *         before begin(), GpioErrc::INVALID_ARGUMENT, or the errno
+     */
+    std::error_code tryReadRegisters(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length) noexcept;
+    
+    /**
+     * @brief writeRegisters() that reports why it failed
+     */
+    std::error_code tryWriteRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) noexcept;
+    
     /**
      * @brief Scan I2C bus for devices
      * 
      * Scans all possible 7-bit addresses (0x03-0x77) and returns list of
      * addresses that respond. Useful for device discovery.
      * 
+     * Each address costs one SMBus probe ioctl (see probe()). Addresses
+     * claimed by a kernel driver are reported as present.
+     * 
      * @return Vector of responding I2C addresses
      * 
      * @example
@@ -403,7 +594,8 @@ public:
     /**
      * @brief Check if device exists at address
      * 
-     * Tests if an I2C device responds at the given address.
+     * Tests if an I2C device responds at the given address, using
+     * probe() with I2cProbeMode::AUTO.
      * 
      * @param address I2C address to test
      * @return true if device responds, false otherwise
@@ -415,8 +607,117 @@ public:
      */
     bool exists(uint8_t address);
     
+    /**
+     * @brief Probe for a device with a single SMBus transaction
+     * 
+     * Uses whichever of quick write / receive byte the adapter supports
+     * (I2C_FUNCS) when the requested mode is unavailable.
+     * 
+     * @param address I2C address to test
+     * @param mode Probe transaction
+     * @return true if the device ACKs or is bound to a kernel driver
+     */
+    bool probe(uint8_t address, I2cProbeMode mode = I2cProbeMode::AUTO);
+    
+    /**
+     * @brief List the I2C buses present on this system
+     * 
+     * @return Bus numbers of every /dev/i2c-N, in ascending order
+     */
+    static std::vector<int> availableBuses();
+    
+    /**
+     * @brief Get the bus number opened by begin()
+     * 
+     * @return Bus number, or -1 if not initialized
+     */
+    int getBusNumber() const { return busNumber_; }
+    
+    /**
+     * @brief Send every operation in a batch
+     * 
+     * Takes the bus lock once and packs operations into I2C_RDWR ioctls of
+     * up to WIRE_BATCH_MAX_MESSAGES messages, so six register reads cost
+     * one syscall instead of six I2C_SLAVE + write + read sequences.
+     * Per-operation results are stored in the batch (see WireBatch::status()).
+     * 
+     * On adapters without I2C_FUNC_I2C the operations are sent one by one.
+     * 
+     * @param batch Operations to send
+     * @return Number of operations that succeeded
+     * 
+     * @example
+     * WireBatch batch;
+     * batch.readRegisters(0x68, 0x3B, accel, 6);
+     * batch.writeRegister(0x1E, 0x02, 0x01);
+     * if (Wire.transfer(batch) != batch.size()) {
+     *     // Check batch.status(i)
+     * }
+     */
+    size_t transfer(WireBatch& batch);
+    
+    /**
+     * @brief SMBus "read byte data" (i2c_smbus_read_byte_data)
+     * 
+     * Single I2C_SMBUS ioctl with no intermediate buffers. Works on
+     * SMBus-only adapters, and repeated accesses to the same device skip
+     * the I2C_SLAVE ioctl.
+     * 
+     * @param address I2C device address
+     * @param command Register (SMBus command byte)
+     * @return Byte value (0-255), or -1 on error
+     * 
+     * @example
+     * int whoami = Wire.smbusReadByteData(0x68, 0x75);
+     */
+    int smbusReadByteData(uint8_t address, uint8_t command);
+    
+    /**
+     * @brief SMBus "read word data" (i2c_smbus_read_word_data)
+     * 
+     * @param address I2C device address
+     * @param command Register (SMBus command byte)
+     * @return Word as sent by SMBus (low byte first on the wire), or -1 on error
+     */
+    int smbusReadWordData(uint8_t address, uint8_t command);
+    
+    /**
+     * @brief I2C block read (i2c_smbus_read_i2c_block_data)
+     * 
+     * @param address I2C device address
+     * @param command Starting register
+     * @param buffer Destination
+     * @param length Bytes to read (1-SMBUS_BLOCK_MAX)
+     * @return Bytes read, or -1 on error
+     */
+    int smbusReadI2cBlockData(uint8_t address, uint8_t command, uint8_t* buffer, size_t length);
+    
+    /**
+     * @brief SMBus "write byte data" (i2c_smbus_write_byte_data)
+     * 
+     * @return true if successful, false on error
+     */
+    bool smbusWriteByteData(uint8_t address, uint8_t command, uint8_t value);
+    
+    /**
+     * @brief SMBus "write word data" (i2c_smbus_write_word_data)
+     * 
+     * @return true if successful, false on error
+     */
+    bool smbusWriteWordData(uint8_t address, uint8_t command, uint16_t value);
+    
+    /**
+     * @brief I2C block write (i2c_smbus_write_i2c_block_data)
+     * 
+     * @param length Bytes to write (1-SMBUS_BLOCK_MAX)
+     * @return true if successful, false on error
+     */
+    bool smbusWriteI2cBlockData(uint8_t address, uint8_t command, const uint8_t* data, size_t length);
+    
+    static constexpr size_t SMBUS_BLOCK_MAX = 32;  ///< I2C_SMBUS_BLOCK_MAX
+    
 private:
-    int fd_;                           ///< I2C device file descriptor
+    std::unique_ptr<DeviceFile> device_;   ///< Open I2C adapter (real or simulated)
     int busNumber_;                    ///< I2C bus number
     uint32_t clockFrequency_;          ///< Current clock frequency (Hz)
     uint8_t txAddress_;                ///< Current transmission address
@@ -424,6 +725,10 @@ private:
     std::vector<uint8_t> rxBuffer_;    ///< Receive buffer
     size_t rxIndex_;                   ///< Current read position in rxBuffer
     std::mutex mutex_;                 ///< Thread safety mutex
+    bool combinedSupported_;           ///< Adapter supports I2C_RDWR (I2C_FUNC_I2C)
+    bool pendingWrite_;                ///< txBuffer_ held for a repeated-START read
+    int slaveAddress_;                 ///< Address last set with I2C_SLAVE, -1 if none
+    unsigned long functionality_;      ///< I2C_FUNCS bits of the adapter
     
     static constexpr size_t BUFFER_SIZE = 256;  ///< Maximum buffer size
     
@@ -440,10 +745,60 @@ private:
     /**
      * @brief Set I2C slave address for next operation
      * 
+     * Skips the ioctl if @p address is already selected.
+     * 
      * @param address I2C slave address
      * @return true if successful, false on error
+     * @note Mutex must be held by caller
      */
     bool setSlaveAddress(uint8_t address);
+    
+    /**
+     * @brief Open /dev/i2c-N and query adapter functionality
+     * 
+     * @return true if successful, false on error
+     * @note Mutex must be held by caller
+     */
+    bool openBus(int busNumber);
+    
+    /**
+     * @brief Write to a device, as one I2C_RDWR message when supported
+     * 
+     * @return Arduino endTransmission() error code
+     * @note Mutex must be held by caller
+     */
+    uint8_t writeLocked(uint8_t address, const uint8_t* data, size_t length);
+    
+    /**
+     * @brief Optional write, repeated START, then read in one I2C_RDWR ioctl
+     * 
+     * Falls back to write() + read() on adapters without I2C_FUNC_I2C.
+     * 
+     * @param writeData Bytes to write first, or nullptr
+     * @param writeLength Number of bytes to write (0 for a plain read)
+     * @param readData Destination for the read
+     * @param readLength Number of bytes to read
+     * @return Bytes read, or -1 on error
+     * @note Mutex must be held by caller
+     */
+    int writeReadLocked(uint8_t address, const uint8_t* writeData, size_t writeLength,
+                        uint8_t* readData, size_t readLength);
+    
+    /**
+     * @brief Send a write held back by endTransmission(false)
+     * 
+     * @note Mutex must be held by caller
+     */
+    void flushPendingWrite();
+    
+    /**
+     * @brief Issue one I2C_SMBUS ioctl after selecting the device
+     * 
+     * @param data Pointer to a union i2c_smbus_data
+     * @return true if successful
+     * @note Mutex must be held by caller
+     */
+    bool smbusLocked(uint8_t address, uint8_t readWrite, uint8_t command, uint32_t size, void* data);
 };
 
 // Global Wire instance (Arduino compatibility)
@@ -454,5 +809,7 @@ extern WireClass Wire;
 // Allow usage without namespace (Arduino compatibility)
 using pipinpp::Wire;
 using pipinpp::WireClass;
+using pipinpp::WireBatch;
+using pipinpp::I2cProbeMode;
 
 #endif // PIPINPP_WIRE_HPP
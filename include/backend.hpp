@@ -0,0 +1,183 @@
+/**
+ * @file backend.hpp
+ * @brief Kernel interface seam under Pin, InterruptManager, SPIClass and WireClass
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Everything the core classes ask of the kernel goes through two small
+ * interfaces, so the same code runs against real hardware or against
+ * SimulatedHardware (see sim_backend.hpp):
+ *
+ * - LineRequest: one GPIO line request (values, reconfiguration, edge
+ *   events and the fd to poll for them). GpioChip::requestLines() creates
+ *   one; the default implementation is libgpiod.
+ * - DeviceFile: an opened character device (ioctl/read/write), used for
+ *   /dev/spidevB.C and /dev/i2c-N. openDeviceFile() opens the real file
+ *   unless a DeviceProvider is installed.
+ *
+ * Applications do not normally use these directly. The libgpiod path costs
+ * one indirect call per operation over the previous direct calls; the
+ * /dev/gpiomem register fast path is not routed through here.
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <gpiod.h>
+#include <sys/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @brief Requested configuration of one line
+ */
+struct LineSettings {
+    unsigned int offset = 0;                                   ///< Line number on the chip
+    gpiod_line_direction direction = GPIOD_LINE_DIRECTION_INPUT;
+    gpiod_line_bias bias = GPIOD_LINE_BIAS_AS_IS;              ///< AS_IS leaves the bias untouched
+    gpiod_line_edge edge = GPIOD_LINE_EDGE_NONE;               ///< Edge detection (inputs only)
+    uint32_t debounceUs = 0;                                   ///< Kernel debounce period (0 = off)
+    gpiod_line_value outputValue = GPIOD_LINE_VALUE_INACTIVE;  ///< Initial level of an output
+};
+
+/**
+ * @brief One edge event read from a LineRequest
+ */
+struct LineEvent {
+    unsigned int offset;    ///< Line the edge occurred on
+    bool rising;            ///< true for LOW to HIGH
+    uint64_t timestampNs;   ///< CLOCK_MONOTONIC timestamp
+    uint64_t globalSeqno;   ///< Sequence number across the request
+    uint64_t lineSeqno;     ///< Sequence number on this line
+};
+
+/**
+ * @brief Lines requested from a chip (released on destruction)
+ */
+class LineRequest {
+public:
+    virtual ~LineRequest() = default;
+
+    /**
+     * @brief Drive an output line
+     * @return 0 on success, -1 on failure
+     */
+    virtual int setValue(unsigned int offset, bool value) = 0;
+
+    /**
+     * @brief Drive several output lines of this request in one operation
+     * @return 0 on success, -1 on failure
+     */
+    virtual int setValues(const unsigned int* offsets, const bool* values, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (setValue(offsets[i], values[i]) != 0) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Read a line
+     * @return 0 or 1, -1 on failure
+     */
+    virtual int getValue(unsigned int offset) = 0;
+
+    /**
+     * @brief Apply new settings; every line of the request must be listed
+     */
+    virtual bool reconfigure(const std::vector<LineSettings>& lines) = 0;
+
+    /**
+     * @brief File descriptor that becomes readable when edge events are pending
+     */
+    virtual int fd() const = 0;
+
+    /**
+     * @brief Wait for edge events
+     * @param timeoutNs Nanoseconds to wait (0 = poll, negative = forever)
+     * @return 1 if events are pending, 0 on timeout, -1 on error
+     */
+    virtual int waitEdgeEvents(int64_t timeoutNs) = 0;
+
+    /**
+     * @brief Read pending edge events without blocking
+     * @return Number of events stored in @p events, -1 on error
+     */
+    virtual int readEdgeEvents(LineEvent* events, size_t maxEvents) = 0;
+};
+
+/**
+ * @brief An opened character device
+ */
+class DeviceFile {
+public:
+    virtual ~DeviceFile() = default;
+
+    /**
+     * @brief ioctl() with a pointer argument
+     * @return ioctl() result; -1 with errno set on failure
+     */
+    virtual int ioctl(unsigned long request, void* arg) = 0;
+
+    /**
+     * @brief ioctl() with an integer argument (e.g. I2C_SLAVE)
+     */
+    virtual int ioctlValue(unsigned long request, unsigned long value) = 0;
+
+    virtual ssize_t read(void* buffer, size_t length) = 0;
+    virtual ssize_t write(const void* buffer, size_t length) = 0;
+};
+
+/**
+ * @brief Source of device files replacing /dev (see SimulatedHardware)
+ */
+class DeviceProvider {
+public:
+    virtual ~DeviceProvider() = default;
+
+    /**
+     * @brief Open @p path
+     * @return Device, or nullptr with errno set
+     */
+    virtual std::unique_ptr<DeviceFile> open(const std::string& path) = 0;
+
+    /**
+     * @brief Paths of every device offered (e.g. "/dev/i2c-1")
+     */
+    virtual std::vector<std::string> list() const = 0;
+};
+
+/**
+ * @brief Route openDeviceFile() and friends through @p provider (nullptr restores /dev)
+ *
+ * @note Devices already open are unaffected
+ */
+void setDeviceProvider(std::shared_ptr<DeviceProvider> provider);
+
+/**
+ * @brief Open a character device read/write
+ * @return Device, or nullptr with errno set
+ */
+std::unique_ptr<DeviceFile> openDeviceFile(const std::string& path);
+
+/**
+ * @brief Whether @p path can be opened with openDeviceFile()
+ */
+bool deviceFileExists(const std::string& path);
+
+/**
+ * @brief Paths of the entries in /dev (or of the installed provider's devices)
+ */
+std::vector<std::string> listDeviceFiles();
+
+} // namespace pipinpp
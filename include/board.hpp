@@ -0,0 +1,198 @@
+/**
+ * @file board.hpp
+ * @brief Compile-time board profiles: GPIO range and pin capability tables
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Every supported Raspberry Pi exposes GPIO 0-27 on the same 40-pin
+ * header, with the same alternate functions. What differs is the SoC and
+ * its register layout. A BoardProfile records both as constexpr data, so
+ * range and capability checks are constant expressions:
+ * - isValidGpioPin() replaces the "0-27" checks scattered through the
+ *   library and follows the board selected at build time
+ * - BoardPin<N> rejects a GPIO number the board does not have (or lacks a
+ *   required function) with a compile error instead of an exception
+ * - registerLayout tells template code which GpioMem layout to use
+ *   without inspecting chip labels at run time
+ *
+ * The build board is chosen with `-DPIPINPP_BOARD=PI4` (CMake), which
+ * defines `PIPINPP_BOARD_PI4` for the library and everything linking it.
+ * The default, GENERIC, accepts any 40-pin Pi and leaves the register
+ * layout to run-time detection.
+ *
+ * Example usage:
+ * @code
+ * #include "board.hpp"
+ *
+ * using Led = pipinpp::BoardPin<17>;
+ * using Fan = pipinpp::BoardPin<18, pipinpp::BOARD_PI4>;
+ * static_assert(Fan::hardwarePwm, "fan needs a hardware PWM pin");
+ *
+ * pinMode(Led::number, OUTPUT);
+ * // pipinpp::BoardPin<40> would not compile
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "gpiomem.hpp"
+#include "platform.hpp"
+
+namespace pipinpp {
+
+/**
+ * @brief Bit for @p pin in a BoardProfile pin mask
+ */
+constexpr uint64_t gpioBit(int pin) {
+    return (pin >= 0 && pin < 64) ? (uint64_t(1) << pin) : 0;
+}
+
+/**
+ * @brief Static description of one board model
+ */
+struct BoardProfile {
+    const char* name;
+    Platform platform;              ///< Matching run-time detection result (UNKNOWN = any)
+    int gpioCount;                  ///< User GPIOs are 0 .. gpioCount-1
+    uint64_t hardwarePwmPins;       ///< Pins with a hardware PWM channel
+    uint64_t i2cPins;               ///< I2C0 (ID EEPROM) and I2C1 SDA/SCL
+    uint64_t spiPins;               ///< SPI0 and SPI1 MISO/MOSI/SCLK/CE
+    uint64_t uartPins;              ///< UART0 TXD/RXD
+    uint64_t reservedPins;          ///< Usable, but reserved by convention (HAT ID EEPROM)
+    GpioMemLayout registerLayout;   ///< NONE = decide at run time from the chip label
+    const char* gpioChip;           ///< Character device holding the header pins
+    int i2cBus;                     ///< Bus on GPIO 2/3
+
+    constexpr bool isGpio(int pin) const { return pin >= 0 && pin < gpioCount; }
+    constexpr bool isHardwarePwm(int pin) const { return (hardwarePwmPins & gpioBit(pin)) != 0; }
+    constexpr bool isI2c(int pin) const { return (i2cPins & gpioBit(pin)) != 0; }
+    constexpr bool isSpi(int pin) const { return (spiPins & gpioBit(pin)) != 0; }
+    constexpr bool isUart(int pin) const { return (uartPins & gpioBit(pin)) != 0; }
+    constexpr bool isReserved(int pin) const { return (reservedPins & gpioBit(pin)) != 0; }
+};
+
+namespace board_detail {
+
+constexpr uint64_t HEADER_PWM = gpioBit(12) | gpioBit(13) | gpioBit(18) | gpioBit(19);
+constexpr uint64_t HEADER_I2C = gpioBit(0) | gpioBit(1) | gpioBit(2) | gpioBit(3);
+constexpr uint64_t HEADER_SPI = gpioBit(7) | gpioBit(8) | gpioBit(9) | gpioBit(10) | gpioBit(11) |
+                                gpioBit(16) | gpioBit(17) | gpioBit(18) | gpioBit(19) |
+                                gpioBit(20) | gpioBit(21);
+constexpr uint64_t HEADER_UART = gpioBit(14) | gpioBit(15);
+constexpr uint64_t HEADER_RESERVED = gpioBit(0) | gpioBit(1);
+
+} // namespace board_detail
+
+/**
+ * @brief Any 40-pin Raspberry Pi; register layout detected at run time
+ */
+inline constexpr BoardProfile BOARD_GENERIC{
+    "Generic 40-pin Raspberry Pi", Platform::UNKNOWN, 28,
+    board_detail::HEADER_PWM, board_detail::HEADER_I2C, board_detail::HEADER_SPI,
+    board_detail::HEADER_UART, board_detail::HEADER_RESERVED,
+    GpioMemLayout::NONE, "gpiochip0", 1};
+
+inline constexpr BoardProfile BOARD_PI3{
+    "Raspberry Pi 3", Platform::RASPBERRY_PI_3, 28,
+    board_detail::HEADER_PWM, board_detail::HEADER_I2C, board_detail::HEADER_SPI,
+    board_detail::HEADER_UART, board_detail::HEADER_RESERVED,
+    GpioMemLayout::BCM2835, "gpiochip0", 1};
+
+inline constexpr BoardProfile BOARD_PI4{
+    "Raspberry Pi 4", Platform::RASPBERRY_PI_4, 28,
+    board_detail::HEADER_PWM, board_detail::HEADER_I2C, board_detail::HEADER_SPI,
+    board_detail::HEADER_UART, board_detail::HEADER_RESERVED,
+    GpioMemLayout::BCM2835, "gpiochip0", 1};
+
+/**
+ * @brief Raspberry Pi 5 (header GPIO behind RP1; gpiochip0 on kernels 6.6.45+)
+ */
+inline constexpr BoardProfile BOARD_PI5{
+    "Raspberry Pi 5", Platform::RASPBERRY_PI_5, 28,
+    board_detail::HEADER_PWM, board_detail::HEADER_I2C, board_detail::HEADER_SPI,
+    board_detail::HEADER_UART, board_detail::HEADER_RESERVED,
+    GpioMemLayout::RP1, "gpiochip0", 1};
+
+inline constexpr BoardProfile BOARD_ZERO2{
+    "Raspberry Pi Zero 2", Platform::RASPBERRY_PI_ZERO2, 28,
+    board_detail::HEADER_PWM, board_detail::HEADER_I2C, board_detail::HEADER_SPI,
+    board_detail::HEADER_UART, board_detail::HEADER_RESERVED,
+    GpioMemLayout::BCM2835, "gpiochip0", 1};
+
+/**
+ * @brief Compute Module 4 (GPIO 0-27 as on the 40-pin header of the IO board)
+ */
+inline constexpr BoardProfile BOARD_CM4{
+    "Raspberry Pi Compute Module 4", Platform::RASPBERRY_PI_CM4, 28,
+    board_detail::HEADER_PWM, board_detail::HEADER_I2C, board_detail::HEADER_SPI,
+    board_detail::HEADER_UART, board_detail::HEADER_RESERVED,
+    GpioMemLayout::BCM2835, "gpiochip0", 1};
+
+/**
+ * @brief Board selected at build time (PIPINPP_BOARD_<NAME>)
+ */
+#if defined(PIPINPP_BOARD_PI3)
+inline constexpr const BoardProfile& BUILD_BOARD = BOARD_PI3;
+#elif defined(PIPINPP_BOARD_PI4)
+inline constexpr const BoardProfile& BUILD_BOARD = BOARD_PI4;
+#elif defined(PIPINPP_BOARD_PI5)
+inline constexpr const BoardProfile& BUILD_BOARD = BOARD_PI5;
+#elif defined(PIPINPP_BOARD_ZERO2)
+inline constexpr const BoardProfile& BUILD_BOARD = BOARD_ZERO2;
+#elif defined(PIPINPP_BOARD_CM4)
+inline constexpr const BoardProfile& BUILD_BOARD = BOARD_CM4;
+#else
+inline constexpr const BoardProfile& BUILD_BOARD = BOARD_GENERIC;
+#endif
+
+/**
+ * @brief Whether @p pin is a user GPIO on the build board
+ */
+constexpr bool isValidGpioPin(int pin) {
+    return BUILD_BOARD.isGpio(pin);
+}
+
+/**
+ * @brief Profile matching a run-time detected platform (BOARD_GENERIC if none)
+ */
+constexpr const BoardProfile& boardProfileFor(Platform platform) {
+    switch (platform) {
+        case Platform::RASPBERRY_PI_3:     return BOARD_PI3;
+        case Platform::RASPBERRY_PI_4:     return BOARD_PI4;
+        case Platform::RASPBERRY_PI_5:     return BOARD_PI5;
+        case Platform::RASPBERRY_PI_ZERO2: return BOARD_ZERO2;
+        case Platform::RASPBERRY_PI_CM4:   return BOARD_CM4;
+        default:                           return BOARD_GENERIC;
+    }
+}
+
+/**
+ * @brief A GPIO number checked against a board at compile time
+ *
+ * Carries the pin's number, register mask and capabilities as constants,
+ * so code templated on it needs no run-time validation or lookups.
+ *
+ * @tparam N GPIO number
+ * @tparam Board Profile to check against (default: the build board)
+ */
+template <int N, const BoardProfile& Board = BUILD_BOARD>
+struct BoardPin {
+    static_assert(Board.isGpio(N), "GPIO number is not a user GPIO on this board");
+
+    static constexpr int number = N;
+    static constexpr uint32_t mask = uint32_t(1) << N;     ///< Bit in GpioMem bank 0
+    static constexpr const BoardProfile& board = Board;
+    static constexpr bool hardwarePwm = Board.isHardwarePwm(N);
+    static constexpr bool i2c = Board.isI2c(N);
+    static constexpr bool spi = Board.isSpi(N);
+    static constexpr bool uart = Board.isUart(N);
+    static constexpr bool reserved = Board.isReserved(N);
+};
+
+} // namespace pipinpp
@@ -0,0 +1,328 @@
+/**
+ * @file board_config.hpp
+ * @brief Declarative board setup: every line, bus and PWM channel in one pass
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * An application that constructs forty Pin, HardwarePWM and bus objects
+ * one by one pays for forty line requests, a sysfs export wait per PWM
+ * channel in turn, and a device open per bus user. Board takes the whole
+ * wiring as a BoardConfig (JSON, or built in code) and brings it up at
+ * once:
+ *
+ * - all outputs and inputs on a chip share one multi-line request, so a
+ *   chip costs one ioctl however many lines it has
+ * - each I2C and SPI bus is opened once, through SPIBus()/I2CBus()
+ * - PWM channels are exported and started concurrently, each on its own
+ *   thread, overlapping the line requests and bus opens
+ * - interrupt lines keep their mode and debounce from the config and are
+ *   attached through InterruptManager when a callback is given
+ *
+ * getStartupReport() gives the time spent in each phase, so the path from
+ * cold start to the first control loop iteration can be measured.
+ *
+ * Board lines are BoardLine handles: write(), read() and toggle() use the
+ * /dev/gpiomem registers when Pin would, and the line request otherwise.
+ * The lines belong to the Board, so Pin and digitalWrite() cannot claim
+ * them while it exists.
+ *
+ * Example config:
+ * @code{.json}
+ * {
+ *   "chip": "gpiochip0",
+ *   "outputs": { "led": 17, "relay": { "pin": 27, "initial": 1 } },
+ *   "inputs": { "button": { "pin": 22, "mode": "pullup" } },
+ *   "interrupts": { "door": { "pin": 5, "edge": "falling", "debounceUs": 5000 } },
+ *   "pwm": { "fan": { "pin": 18, "frequency": 25000, "duty": 40 } },
+ *   "i2c": { "sensors": 1 },
+ *   "spi": { "adc": { "bus": 0, "cs": 0 } }
+ * }
+ * @endcode
+ *
+ * Example usage:
+ * @code
+ * auto board = pipinpp::Board::fromFile("/etc/myapp/board.json");
+ * board->attachInterrupt("door", onDoor);
+ * board->line("led").write(true);
+ * board->pwm("fan").setDutyCycle(60.0);
+ * int id = board->i2c("sensors").readRegister(0x76, 0xD0);
+ *
+ * // Or in code
+ * pipinpp::BoardConfig config;
+ * config.output("led", 17).input("button", 22, PinMode::INPUT_PULLUP);
+ * pipinpp::Board board(config);
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "HardwarePWM.hpp"
+#include "SPI.hpp"
+#include "Wire.hpp"
+#include "interrupts.hpp"
+#include "pin.hpp"
+
+namespace pipinpp {
+
+class GpioChip;
+class GpioMem;
+class LineRequest;
+
+/**
+ * @brief One GPIO line of a BoardConfig (output or input)
+ */
+struct BoardLineSpec {
+    std::string name;
+    int pin = -1;
+    std::string chip;                   ///< Empty = BoardConfig::chipname
+    PinMode mode = PinMode::INPUT;
+    bool initial = false;               ///< Initial level of an output
+};
+
+/**
+ * @brief One interrupt line of a BoardConfig
+ */
+struct BoardInterruptSpec {
+    std::string name;
+    int pin = -1;
+    std::string chip;                   ///< Empty = BoardConfig::chipname
+    InterruptMode mode = InterruptMode::CHANGE;
+    uint32_t debounceUs = 0;
+};
+
+/**
+ * @brief One hardware PWM channel of a BoardConfig
+ */
+struct BoardPwmSpec {
+    std::string name;
+    int pin = -1;                       ///< GPIO it was given by (-1 = by chip and channel)
+    int chip = 0;
+    int channel = 0;
+    uint32_t frequencyHz = 1000;
+    double dutyCycle = 0.0;             ///< Percent
+};
+
+/**
+ * @brief One I2C bus of a BoardConfig
+ */
+struct BoardI2cSpec {
+    std::string name;
+    int bus = 1;
+};
+
+/**
+ * @brief One SPI device of a BoardConfig
+ */
+struct BoardSpiSpec {
+    std::string name;
+    int bus = 0;
+    int cs = 0;
+};
+
+/**
+ * @brief Everything a Board sets up, parsed from JSON or built in code
+ */
+class BoardConfig {
+public:
+    /**
+     * @brief Parse a JSON config (see the file comment for the layout)
+     * @throws std::invalid_argument with line and column on a syntax or schema error
+     */
+    static BoardConfig fromJson(const std::string& json);
+
+    /**
+     * @brief Read and parse a JSON config file
+     * @throws std::invalid_argument if the file cannot be read or parsed
+     */
+    static BoardConfig fromFile(const std::string& path);
+
+    /**
+     * @brief GPIO chip of the lines that name none (default "gpiochip0")
+     */
+    BoardConfig& chip(const std::string& chipname);
+
+    BoardConfig& output(const std::string& name, int pin, bool initial = false);
+    BoardConfig& input(const std::string& name, int pin, PinMode mode = PinMode::INPUT);
+    BoardConfig& interrupt(const std::string& name, int pin, InterruptMode mode, uint32_t debounceUs = 0);
+
+    /**
+     * @brief Hardware PWM channel on a GPIO (see HardwarePWM::gpioToPWM())
+     * @throws InvalidPinError if @p pin has no PWM channel
+     */
+    BoardConfig& pwm(const std::string& name, int pin, uint32_t frequencyHz, double dutyCycle = 0.0);
+    BoardConfig& pwmChannel(const std::string& name, int chip, int channel, uint32_t frequencyHz,
+                            double dutyCycle = 0.0);
+
+    BoardConfig& i2c(const std::string& name, int bus);
+    BoardConfig& spi(const std::string& name, int bus, int cs = 0);
+
+    /**
+     * @brief Check pin numbers, names and conflicts
+     * @throws InvalidPinError for an invalid or doubly used pin
+     * @throws std::invalid_argument for a duplicate or empty name or a bad value
+     */
+    void validate() const;
+
+    std::string chipname = "gpiochip0";
+    std::vector<BoardLineSpec> lines;
+    std::vector<BoardInterruptSpec> interrupts;
+    std::vector<BoardPwmSpec> pwms;
+    std::vector<BoardI2cSpec> i2cBuses;
+    std::vector<BoardSpiSpec> spiDevices;
+};
+
+/**
+ * @brief Where a Board's startup time went
+ *
+ * PWM channels start concurrently with the lines and buses, so the phase
+ * times can add up to more than totalNs.
+ */
+struct BoardStartupReport {
+    uint64_t parseNs = 0;               ///< JSON parsing (0 for a config built in code)
+    uint64_t validateNs = 0;
+    uint64_t linesNs = 0;               ///< Line requests, all chips
+    uint64_t busesNs = 0;
+    uint64_t pwmNs = 0;                 ///< Until the slowest channel was running
+    uint64_t interruptsNs = 0;          ///< Debounce settings
+    uint64_t totalNs = 0;               ///< Validation until the Board was ready
+    size_t lineRequests = 0;
+    size_t lines = 0;
+    size_t buses = 0;
+    size_t pwmChannels = 0;
+};
+
+/**
+ * @brief One GPIO line owned by a Board
+ *
+ * @note Like Pin, not synchronized: one thread per line, or external locking.
+ */
+class BoardLine {
+public:
+    /**
+     * @brief Drive an output
+     * @return false for inputs or on failure
+     */
+    bool write(bool value);
+
+    /**
+     * @brief Read the line level
+     * @return 0 or 1, -1 on failure
+     */
+    int read();
+
+    /**
+     * @brief Invert an output (from the last written level, no read)
+     */
+    bool toggle();
+
+    int pin() const { return static_cast<int>(offset_); }
+    bool isOutput() const { return output_; }
+
+private:
+    friend class Board;
+
+    LineRequest* request_ = nullptr;
+    GpioChip* chip_ = nullptr;
+    GpioMem* fastPath_ = nullptr;
+    uint32_t mask_ = 0;
+    unsigned int offset_ = 0;
+    bool output_ = false;
+};
+
+/**
+ * @brief Lines, buses and PWM channels of one application, set up in one pass
+ *
+ * @note Thread-safe; the returned objects have their own rules.
+ */
+class Board {
+public:
+    /**
+     * @brief Set up everything in @p config
+     * @throws InvalidPinError / std::invalid_argument if the config is invalid
+     * @throws GpioAccessError if a chip, line, bus or PWM channel cannot be opened
+     */
+    explicit Board(const BoardConfig& config);
+
+    /**
+     * @brief Detaches the interrupts, stops the PWM channels and releases the lines
+     *
+     * Buses stay open in the bus registry (see closeAllBuses()).
+     */
+    ~Board();
+
+    Board(const Board&) = delete;
+    Board& operator=(const Board&) = delete;
+
+    static std::unique_ptr<Board> fromConfig(const BoardConfig& config);
+
+    /**
+     * @brief Parse a JSON config and set it up (parse time in the report)
+     */
+    static std::unique_ptr<Board> fromJson(const std::string& json);
+    static std::unique_ptr<Board> fromFile(const std::string& path);
+
+    /**
+     * @throws std::invalid_argument if no output or input has this name
+     */
+    BoardLine& line(const std::string& name);
+
+    /**
+     * @throws std::invalid_argument if no PWM channel has this name
+     */
+    HardwarePWM& pwm(const std::string& name);
+
+    /**
+     * @throws std::invalid_argument if no I2C bus has this name
+     */
+    WireClass& i2c(const std::string& name);
+
+    /**
+     * @throws std::invalid_argument if no SPI device has this name
+     */
+    SPIClass& spi(const std::string& name);
+
+    /**
+     * @brief Attach a callback to a configured interrupt line
+     * @throws std::invalid_argument if no interrupt has this name
+     * @throws GpioAccessError / std::runtime_error as InterruptManager::attachInterrupt()
+     */
+    void attachInterrupt(const std::string& name, InterruptCallback callback);
+
+    void detachInterrupt(const std::string& name);
+
+    const BoardStartupReport& getStartupReport() const { return report_; }
+
+private:
+    /**
+     * @brief Request the lines, then collect the buses and PWM channels started by the constructor
+     */
+    void setUp(std::future<void>& buses, std::vector<std::future<bool>>& pwmStarts);
+    void releaseLines();
+
+    BoardConfig config_;
+    BoardStartupReport report_;
+
+    std::vector<std::shared_ptr<GpioChip>> chips_;
+    std::vector<std::unique_ptr<LineRequest>> requests_;
+    std::map<std::string, BoardLine> lines_;
+    std::map<std::string, std::unique_ptr<HardwarePWM>> pwms_;
+    std::map<std::string, WireClass*> i2c_;
+    std::map<std::string, SPIClass*> spi_;
+    mutable std::mutex mutex_;                  ///< Guards attached_
+    std::map<std::string, bool> attached_;      ///< Interrupt name -> attached
+};
+
+} // namespace pipinpp
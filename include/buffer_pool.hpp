@@ -0,0 +1,143 @@
+/**
+ * @file buffer_pool.hpp
+ * @brief Fixed-size transaction buffers preallocated in one block
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * SPIClass::submit() and other queued transfers need their buffers to
+ * stay valid until the completion runs, which usually means a new vector
+ * per transaction. BufferPool allocates every buffer once, up front;
+ * acquire() hands one out and the PooledBuffer handle returns it when it
+ * is destroyed, on whichever thread that happens (typically the
+ * completion callback). Neither side allocates after construction.
+ *
+ * An exhausted pool returns an empty handle rather than allocating, so
+ * the caller decides whether to wait, drop or fall back.
+ *
+ * Example usage:
+ * @code
+ * pipinpp::BufferPool pool(512, 8);                 // Eight 512-byte frames
+ *
+ * auto frame = std::make_shared<pipinpp::PooledBuffer>(pool.acquire());
+ * if (*frame) {
+ *     fillFrame(frame->data(), frame->capacity());
+ *     SpiTransaction transaction;
+ *     transaction.segments.push_back({frame->data(), nullptr, frame->capacity()});
+ *     SPI.submit(std::move(transaction), [frame](bool) {});   // Returned when the lambda dies
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pipinpp {
+
+class BufferPool;
+
+/**
+ * @brief Move-only handle to one pool buffer; returns it on destruction
+ */
+class PooledBuffer {
+public:
+    PooledBuffer() noexcept = default;
+    PooledBuffer(PooledBuffer&& other) noexcept;
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+    ~PooledBuffer();
+
+    /**
+     * @brief False for the handle of an exhausted pool
+     */
+    explicit operator bool() const noexcept { return data_ != nullptr; }
+
+    uint8_t* data() noexcept { return data_; }
+    const uint8_t* data() const noexcept { return data_; }
+
+    /**
+     * @brief Buffer size in bytes (the pool's block size, 0 when empty)
+     */
+    size_t capacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Return the buffer to its pool now
+     */
+    void reset() noexcept;
+
+private:
+    friend class BufferPool;
+    PooledBuffer(BufferPool* pool, uint8_t* data, size_t capacity) noexcept
+        : pool_(pool), data_(data), capacity_(capacity) {}
+
+    BufferPool* pool_ = nullptr;
+    uint8_t* data_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+/**
+ * @brief Fixed number of equally sized buffers, allocated at construction
+ *
+ * acquire() and release are thread-safe and never allocate. The pool
+ * must outlive every PooledBuffer taken from it.
+ */
+class BufferPool {
+public:
+    /**
+     * @param blockSize Bytes per buffer (each buffer starts max_align_t aligned)
+     * @param blockCount Number of buffers
+     * @throws std::invalid_argument if either is zero
+     */
+    BufferPool(size_t blockSize, size_t blockCount);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Take a free buffer; an empty handle if all are in use
+     */
+    PooledBuffer acquire();
+
+    /**
+     * @brief Bytes per buffer
+     */
+    size_t blockSize() const { return blockSize_; }
+
+    /**
+     * @brief Buffers in the pool
+     */
+    size_t blockCount() const { return blockCount_; }
+
+    /**
+     * @brief Buffers not currently acquired
+     */
+    size_t available() const;
+
+    /**
+     * @brief acquire() calls that found the pool empty
+     */
+    uint64_t getExhaustedCount() const;
+
+private:
+    friend class PooledBuffer;
+    void release(uint8_t* data) noexcept;
+
+    size_t blockSize_;
+    size_t blockCount_;
+    std::unique_ptr<std::max_align_t[]> storage_;   ///< blockCount_ blocks of blockSize_ bytes
+    mutable std::mutex mutex_;
+    std::vector<uint8_t*> free_;                    ///< Guarded by mutex_; capacity blockCount_
+    uint64_t exhausted_ = 0;                        ///< Guarded by mutex_
+};
+
+} // namespace pipinpp
@@ -0,0 +1,74 @@
+/**
+ * @file bus_registry.hpp
+ * @brief Shared SPI and I2C bus objects, one per bus, for parallel use
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * The global SPI and Wire objects each wrap one device file behind one
+ * mutex, so driving spidev0.0 and spidev1.0 (or i2c-1 and i2c-3) through
+ * them means re-calling begin() and serialising everything. SPIBus() and
+ * I2CBus() return a long-lived object per bus instead, opened on first
+ * use:
+ * - each has its own file descriptor and its own lock, so threads using
+ *   different buses never wait on each other
+ * - each SPIClass runs its own I/O thread for submit() ("pipinpp-spi<bus>.<cs>"),
+ *   and a WireScheduler on an I2CBus() polls it from its own
+ *   "pipinpp-i2c<bus>" thread, so independent buses progress in parallel
+ *   on different cores (ThreadPolicyManager can pin each)
+ * - every caller asking for the same bus gets the same object, so drivers
+ *   sharing a bus still share its lock
+ *
+ * The global SPI and Wire are separate objects; don't mix them with the
+ * registry object for the same bus, or the two locks will not exclude
+ * each other.
+ *
+ * Example usage:
+ * @code
+ * #include "bus_registry.hpp"
+ *
+ * SPIClass& adc = pipinpp::SPIBus(0, 0);
+ * SPIClass& display = pipinpp::SPIBus(1, 0);
+ * WireClass& sensors = pipinpp::I2CBus(1);
+ * std::thread sampler([&] { adc.transfer(tx, rx, 3); });     // Runs alongside
+ * display.transferStream(frame, nullptr, sizeof(frame));     // this transfer
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "SPI.hpp"
+#include "Wire.hpp"
+
+namespace pipinpp {
+
+/**
+ * @brief SPI object for /dev/spidev@p bus.@p cs, begun on first use
+ *
+ * @return The same object for every call with the same bus and CS
+ * @throws GpioAccessError if the device cannot be opened
+ * @note Thread-safe
+ */
+SPIClass& SPIBus(int bus, int cs = 0);
+
+/**
+ * @brief I2C object for /dev/i2c-@p bus, begun on first use
+ *
+ * @return The same object for every call with the same bus
+ * @throws GpioAccessError if the device cannot be opened
+ * @note Thread-safe
+ */
+WireClass& I2CBus(int bus);
+
+/**
+ * @brief end() and drop every registry bus
+ *
+ * References returned earlier become invalid. Meant for shutdown and tests.
+ */
+void closeAllBuses();
+
+} // namespace pipinpp
@@ -0,0 +1,66 @@
+/**
+ * @file cache_file.hpp
+ * @brief Private, tamper-checked files for detection and scan caches
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * The platform and I2C scan caches are written by the CLI, usually as
+ * root, and what they hold is trusted afterwards. A fixed name in a
+ * world-writable directory would let any local user plant a symlink (and
+ * have the cache write clobber its target) or plant a cache of their own.
+ * So:
+ * - runtimeCachePath() puts caches in /run/pipinpp for root and in
+ *   $XDG_RUNTIME_DIR/pipinpp for everyone else, both only writable by
+ *   their owner; with neither available there is no cache
+ * - writeCacheFile() writes a new file created with mkstemp() (O_EXCL, so
+ *   never through a planted link) and renames it over the old one
+ * - readCacheFile() refuses symlinks, anything but a regular file, files
+ *   owned by another user and files group or world can write
+ *
+ * Example usage:
+ * @code
+ * std::string path = pipinpp::runtimeCachePath("example.cache");
+ * std::string content;
+ * if (!path.empty() && pipinpp::readCacheFile(path, content)) {
+ *     use(content);
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <ctime>
+#include <string>
+
+namespace pipinpp {
+
+/**
+ * @brief Cache file @p name in the caller's private runtime directory
+ *
+ * Creates the directory (mode 0700) on first use.
+ *
+ * @return The path, or an empty string if there is no directory only the
+ *         effective user can write (caching is then off)
+ */
+std::string runtimeCachePath(const std::string& name);
+
+/**
+ * @brief Replace @p path with @p content without following links (mode 0600)
+ * @return false if the file could not be written
+ */
+bool writeCacheFile(const std::string& path, const std::string& content);
+
+/**
+ * @brief Read @p path if it is a regular file only the effective user can write
+ * @param[out] content File content
+ * @param[out] modified Last modification time, if not nullptr
+ * @return false if it is missing, a symlink, not ours or group/world-writable
+ */
+bool readCacheFile(const std::string& path, std::string& content, time_t* modified = nullptr);
+
+} // namespace pipinpp
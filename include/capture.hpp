@@ -0,0 +1,222 @@
+/**
+ * @file capture.hpp
+ * @brief Logic-analyser style edge capture into a memory-mapped ring file
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * CaptureSession records every edge on a set of pins for as long as it
+ * runs, at whatever rate the kernel delivers them, without growing the
+ * heap:
+ * - The file is sized and mapped up front (header + capacity records of
+ *   16 bytes, pages touched at start), so recording an edge is a store
+ *   into the mapping; nothing is allocated or written with syscalls
+ * - Records come from the interrupt monitor thread in batches with kernel
+ *   timestamps; all pins share one line request and one kernel buffer,
+ *   and readCapture() puts the per-pin batches back in timestamp order
+ * - When full the ring overwrites the oldest records (keep the last N
+ *   edges) or, with stopWhenFull, keeps the first N and counts the rest
+ * - Record and lost-edge counts live in the mapped header, so another
+ *   process can follow a running capture, and a killed one leaves a
+ *   readable file
+ *
+ * The same file format without a ring (capacity 0, records until end of
+ * file) is what `pipinpp monitor --bin` streams. readCapture() loads
+ * either; writeVcd() and writeSigrok() convert for GTKWave / PulseView.
+ *
+ * Example usage:
+ * @code
+ * #include "capture.hpp"
+ *
+ * pipinpp::CaptureOptions options;
+ * options.pins = {17, 18, 27};
+ * options.path = "/var/tmp/field.cap";
+ * options.capacity = 4 << 20;              // Last 4M edges, 64 MiB file
+ *
+ * pipinpp::CaptureSession capture;
+ * if (capture.start(options)) {
+ *     delay(10 * 60 * 1000);
+ *     capture.stop();
+ * }
+ *
+ * pipinpp::CaptureData data;
+ * if (pipinpp::readCapture("/var/tmp/field.cap", data)) {
+ *     pipinpp::writeVcd(data, "field.vcd");
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class EdgeEventSpan;
+
+namespace pipinpp {
+
+/**
+ * @brief Capture file format version written by this library
+ */
+constexpr uint32_t CAPTURE_FORMAT_VERSION = 1;
+
+/**
+ * @brief Size of the file header; records start here (one page)
+ */
+constexpr size_t CAPTURE_HEADER_SIZE = 4096;
+
+/**
+ * @brief Most pins one capture can record
+ */
+constexpr size_t CAPTURE_MAX_PINS = 64;
+
+/**
+ * @brief Default ring capacity in records (16 MiB file)
+ */
+constexpr size_t CAPTURE_DEFAULT_CAPACITY = 1 << 20;
+
+/**
+ * @brief One edge (16 bytes, little-endian on disk)
+ */
+struct CaptureRecord {
+    uint64_t timestampNs;   ///< Kernel CLOCK_MONOTONIC timestamp
+    uint32_t lineSeqno;     ///< Kernel per-line sequence number (gaps = lost edges)
+    uint8_t pin;            ///< GPIO pin
+    uint8_t level;          ///< Level after the edge (1 = rising)
+    uint16_t reserved;
+};
+static_assert(sizeof(CaptureRecord) == 16, "capture records are 16 bytes");
+
+/**
+ * @brief File header (first CAPTURE_HEADER_SIZE bytes of a capture)
+ */
+struct CaptureHeader {
+    char magic[8];                          ///< "PIPINCAP"
+    uint32_t version;                       ///< CAPTURE_FORMAT_VERSION
+    uint32_t recordSize;                    ///< sizeof(CaptureRecord)
+    uint32_t headerSize;                    ///< CAPTURE_HEADER_SIZE
+    uint32_t pinCount;
+    uint64_t capacity;                      ///< Ring size in records, 0 = records until end of file
+    uint64_t recordCount;                   ///< Records written in total (ring slot = count % capacity)
+    uint64_t lostCount;                     ///< Edges lost (kernel buffer overflow or stopWhenFull)
+    uint64_t startNs;                       ///< CLOCK_MONOTONIC when recording started
+    uint64_t stopNs;                        ///< CLOCK_MONOTONIC when it stopped, 0 while running
+    uint8_t pins[CAPTURE_MAX_PINS];
+    uint8_t initialLevels[CAPTURE_MAX_PINS];   ///< Levels at startNs
+    uint8_t lastLevels[CAPTURE_MAX_PINS];      ///< Level after each pin's latest record
+};
+static_assert(sizeof(CaptureHeader) <= CAPTURE_HEADER_SIZE, "header fits its page");
+
+/**
+ * @brief Fill in a header for @p pins (at most CAPTURE_MAX_PINS)
+ */
+void initCaptureHeader(CaptureHeader& header, const std::vector<int>& pins,
+                       const std::vector<int>& initialLevels, uint64_t startNs, uint64_t capacity);
+
+/**
+ * @brief Settings for CaptureSession::start()
+ */
+struct CaptureOptions {
+    std::vector<int> pins;                          ///< Pins to record (both edges)
+    std::string path;                               ///< Capture file (created or truncated)
+    size_t capacity = CAPTURE_DEFAULT_CAPACITY;     ///< Records kept
+    bool stopWhenFull = false;                      ///< Keep the first records instead of the last
+    size_t eventBufferSize = 256;                   ///< Kernel edge buffer (1-1024)
+    std::string chipname = "gpiochip0";
+};
+
+/**
+ * @brief Records edges on a set of pins into a memory-mapped ring file
+ *
+ * @note start()/stop() are not thread-safe against each other; the
+ *       counters can be read from any thread
+ */
+class CaptureSession {
+public:
+    CaptureSession() = default;
+    ~CaptureSession();
+
+    CaptureSession(const CaptureSession&) = delete;
+    CaptureSession& operator=(const CaptureSession&) = delete;
+
+    /**
+     * @brief Create and map the file, read starting levels, attach the interrupts
+     * @return false (logged) on invalid options or if the file or pins are unavailable
+     */
+    bool start(const CaptureOptions& options);
+
+    /**
+     * @brief Detach, stamp the stop time and flush the file (safe to call twice)
+     */
+    void stop();
+
+    bool isRunning() const { return header_ != nullptr; }
+
+    /**
+     * @brief Records written so far (may exceed capacity when the ring wrapped)
+     */
+    uint64_t getRecordCount() const;
+
+    /**
+     * @brief Edges lost so far
+     */
+    uint64_t getLostCount() const;
+
+private:
+    void record(const EdgeEventSpan& events);
+
+    std::vector<int> pins_;
+    std::string chipname_;
+    CaptureHeader* header_ = nullptr;
+    CaptureRecord* records_ = nullptr;
+    size_t mappedSize_ = 0;
+    uint64_t capacity_ = 0;
+    bool stopWhenFull_ = false;
+    uint64_t lastSeqno_[256] = {};      ///< Per pin, for lost-edge detection
+    uint8_t pinIndex_[256] = {};        ///< Pin -> header slot
+};
+
+/**
+ * @brief A capture loaded for conversion
+ *
+ * @note When the ring wrapped, startNs is moved to the oldest kept record
+ *       and initialLevels are reconstructed for that moment
+ */
+struct CaptureData {
+    std::vector<int> pins;
+    std::vector<int> initialLevels;     ///< Levels at startNs
+    uint64_t startNs = 0;
+    uint64_t stopNs = 0;                ///< 0 if the recorder did not stop cleanly
+    uint64_t lostCount = 0;
+    bool wrapped = false;               ///< Oldest records were overwritten
+    std::vector<CaptureRecord> records; ///< Oldest first
+};
+
+/**
+ * @brief Load a capture file (ring or streamed)
+ * @return false (logged) if the file is missing or not a capture
+ */
+bool readCapture(const std::string& path, CaptureData& data);
+
+/**
+ * @brief Write a Value Change Dump (1 ns timescale, time 0 = startNs)
+ */
+bool writeVcd(const CaptureData& data, const std::string& path);
+
+/**
+ * @brief Write a sigrok session file (.sr) sampled at @p sampleRateHz
+ *
+ * Edges are placed on the nearest sample, so pulses shorter than one
+ * sample period disappear; pick the rate accordingly. The file holds one
+ * bit per pin per sample, so long captures at high rates get large
+ * (refused above 1 GiB of samples).
+ */
+bool writeSigrok(const CaptureData& data, const std::string& path, uint64_t sampleRateHz = 1000000);
+
+} // namespace pipinpp
@@ -0,0 +1,266 @@
+/**
+ * @file chip_registry.hpp
+ * @brief Process-wide cache of opened GPIO chip handles
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Every Pin, PinGroup and interrupt used to call gpiod_chip_open() and
+ * gpiod_chip_get_info() for itself, so 20 pins meant 20 chip file
+ * descriptors on top of the 20 line requests. ChipRegistry opens each
+ * chip once, caches its line count, and hands out shared, reference-counted
+ * handles. The chip is closed when the last user releases its handle.
+ *
+ * Example usage:
+ * @code
+ * auto chip = pipinpp::ChipRegistry::getInstance().acquire("gpiochip0");
+ * size_t lines = chip->numLines();            // No extra ioctl
+ * std::vector<pipinpp::LineSettings> lines(1);
+ * lines[0].offset = 17;
+ * auto request = chip->requestLines("my-app", lines);   // libgpiod or simulated
+ * @endcode
+ *
+ * setChipFactory() replaces libgpiod for chips opened afterwards; this is
+ * how SimulatedHardware takes over every Pin and interrupt.
+ *
+ * Each chip also carries an OutputShadow: the last level written to every
+ * output line the process owns, so toggles and output-state queries need
+ * no kernel read.
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <gpiod.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "backend.hpp"
+
+namespace pipinpp {
+
+/**
+ * @brief Last level written to each output line this process owns on a chip
+ *
+ * Pin and PinGroup claim their output lines here and record every
+ * successful write. The kernel grants a line to one request at a time,
+ * so each bit has a single writer; the words are atomic only so that
+ * neighbouring lines written from different threads do not clobber each
+ * other.
+ *
+ * @note Stores that bypass Pin/PinGroup (GpioMem, FastPin, WaveSequencer)
+ *       are not tracked; FastPin releases its line from the shadow
+ */
+class OutputShadow {
+public:
+    explicit OutputShadow(size_t numLines);
+
+    OutputShadow(const OutputShadow&) = delete;
+    OutputShadow& operator=(const OutputShadow&) = delete;
+
+    /**
+     * @brief Start tracking an output line at its initial level
+     */
+    void claim(unsigned int offset, bool level);
+
+    /**
+     * @brief Stop tracking a line (released or no longer an output)
+     */
+    void release(unsigned int offset);
+
+    /**
+     * @brief Record a successful write
+     */
+    inline void record(unsigned int offset, bool level) {
+        if (offset / 64 >= banks_) {
+            return;
+        }
+        const uint64_t bit = uint64_t{1} << (offset % 64);
+        if (level) {
+            levels_[offset / 64].fetch_or(bit, std::memory_order_relaxed);
+        } else {
+            levels_[offset / 64].fetch_and(~bit, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Last level written to @p offset, -1 if it is not a tracked output
+     */
+    inline int level(unsigned int offset) const {
+        if (offset / 64 >= banks_) {
+            return -1;
+        }
+        const uint64_t bit = uint64_t{1} << (offset % 64);
+        if (!(owned_[offset / 64].load(std::memory_order_relaxed) & bit)) {
+            return -1;
+        }
+        return (levels_[offset / 64].load(std::memory_order_relaxed) & bit) ? 1 : 0;
+    }
+
+    /**
+     * @brief Levels of lines 64*bank .. 64*bank+63 (untracked lines read 0)
+     */
+    uint64_t levels(size_t bank = 0) const;
+
+    /**
+     * @brief Tracked output lines among 64*bank .. 64*bank+63
+     */
+    uint64_t owned(size_t bank = 0) const;
+
+private:
+    size_t banks_;
+    std::unique_ptr<std::atomic<uint64_t>[]> levels_;
+    std::unique_ptr<std::atomic<uint64_t>[]> owned_;
+};
+
+/**
+ * @brief Shared handle to one opened GPIO chip
+ *
+ * Obtain instances through ChipRegistry::acquire(). The underlying
+ * gpiod_chip is closed when the last std::shared_ptr is destroyed.
+ */
+class GpioChip {
+public:
+    virtual ~GpioChip();
+
+    GpioChip(const GpioChip&) = delete;
+    GpioChip& operator=(const GpioChip&) = delete;
+
+    /**
+     * @brief Raw libgpiod chip pointer (owned by this object, nullptr for simulated chips)
+     */
+    gpiod_chip* get() const { return chip_; }
+
+    /**
+     * @brief Chip name without the /dev/ prefix (e.g. "gpiochip0")
+     */
+    const std::string& name() const { return name_; }
+
+    /**
+     * @brief Chip label reported by the driver (e.g. "pinctrl-bcm2711")
+     */
+    const std::string& label() const { return label_; }
+
+    /**
+     * @brief Number of GPIO lines, cached when the chip was opened
+     */
+    size_t numLines() const { return numLines_; }
+
+    /**
+     * @brief Last written levels of this process's output lines on the chip
+     */
+    OutputShadow& outputShadow() { return shadow_; }
+    const OutputShadow& outputShadow() const { return shadow_; }
+
+    /**
+     * @brief Request lines on this chip
+     *
+     * Serializes gpiod_chip_request_lines() calls because libgpiod chip
+     * objects are not thread-safe and are now shared between subsystems.
+     *
+     * @return Line request or nullptr on failure (errno set by libgpiod,
+     *         ENOTSUP on a simulated chip)
+     */
+    gpiod_line_request* requestLines(gpiod_request_config* req_cfg, gpiod_line_config* line_cfg);
+
+    /**
+     * @brief Request lines through the backend interface
+     *
+     * Used by Pin and InterruptManager so they also run on simulated chips.
+     *
+     * @param consumer Consumer name shown by gpioinfo
+     * @param lines One entry per line
+     * @param eventBufferSize Kernel edge event buffer (0 = default)
+     * @return Line request or nullptr on failure (errno set)
+     */
+    virtual std::unique_ptr<LineRequest> requestLines(const std::string& consumer,
+                                                      const std::vector<LineSettings>& lines,
+                                                      size_t eventBufferSize = 0);
+
+protected:
+    /**
+     * @brief Chip without a libgpiod handle (for alternative backends)
+     */
+    GpioChip(const std::string& name, const std::string& label, size_t numLines);
+
+private:
+    friend class ChipRegistry;
+
+    GpioChip(gpiod_chip* chip, const std::string& name, const std::string& label, size_t numLines);
+
+    gpiod_chip* chip_;
+    std::string name_;
+    std::string label_;
+    size_t numLines_;
+    OutputShadow shadow_;
+    std::mutex mutex_;
+};
+
+/**
+ * @brief Singleton cache mapping chip names to shared GpioChip handles
+ *
+ * The registry only keeps weak references, so it never extends the
+ * lifetime of a chip beyond its last user.
+ *
+ * @note Thread-safe
+ */
+class ChipRegistry {
+public:
+    /**
+     * @brief Get the singleton instance
+     */
+    static ChipRegistry& getInstance();
+
+    /**
+     * @brief Get a shared handle to a chip, opening it on first use
+     *
+     * @param chipname Chip name ("gpiochip0") or path ("/dev/gpiochip0")
+     * @return Shared handle, never nullptr
+     * @throws GpioAccessError if the chip cannot be opened
+     */
+    std::shared_ptr<GpioChip> acquire(const std::string& chipname);
+
+    /**
+     * @brief Number of chips currently held open by at least one user
+     */
+    size_t openCount() const;
+
+    /**
+     * @brief Creates a chip for a normalized name ("gpiochip0")
+     */
+    using ChipFactory = std::function<std::shared_ptr<GpioChip>(const std::string& name)>;
+
+    /**
+     * @brief Open chips through @p factory instead of libgpiod (nullptr restores libgpiod)
+     *
+     * Chips already handed out stay valid; the next acquire() of any name
+     * goes through the new factory.
+     */
+    void setChipFactory(ChipFactory factory);
+
+    ChipRegistry(const ChipRegistry&) = delete;
+    ChipRegistry& operator=(const ChipRegistry&) = delete;
+
+private:
+    ChipRegistry() = default;
+
+    /**
+     * @brief Strip a leading "/dev/" so both spellings share one entry
+     */
+    static std::string normalizeName(const std::string& chipname);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<GpioChip>> chips_;
+    ChipFactory factory_;
+};
+
+} // namespace pipinpp
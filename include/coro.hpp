@@ -0,0 +1,525 @@
+/**
+ * @file coro.hpp
+ * @brief C++20 coroutine tasks and awaitables on top of EventLoop
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Device protocols ("toggle, wait for the edge or time out, read a
+ * register, wait 2 ms") become callback chains on an EventLoop, or a
+ * blocked thread each. With coroutines they read top to bottom, and a
+ * suspended state machine costs one heap frame, not a thread stack:
+ * @code
+ * pipinpp::coro::Task<> probe(pipinpp::EventLoop& loop, Pin& ready) {
+ *     using namespace std::chrono_literals;
+ *     digitalWrite(TRIGGER, HIGH);
+ *     auto edge = co_await pipinpp::coro::edge(loop, ready, RISING, 50ms);
+ *     if (!edge) {
+ *         co_return;                                        // Timed out
+ *     }
+ *     uint8_t data[6];
+ *     co_await pipinpp::coro::readRegisters(loop, Wire, 0x68, 0x3B, data, 6);
+ *     co_await pipinpp::coro::sleepFor(loop, 2ms);
+ * }
+ *
+ * pipinpp::EventLoop loop;
+ * for (auto& sensor : sensors) {
+ *     pipinpp::coro::spawn(probe(loop, sensor.readyPin));  // Thousands are fine
+ * }
+ * loop.run();
+ * @endcode
+ *
+ * - Task<T> is lazy: it starts when awaited (or spawn()ed) and resumes its
+ *   awaiter when it finishes, by symmetric transfer
+ * - sleepFor() and edge() are timerfd/line-request sources on the loop
+ * - readRegisters()/writeRegisters() and blocking() run the call on the
+ *   loop's helper thread (EventLoop::runBlocking()): the kernel I2C
+ *   interface has no asynchronous form
+ * - transfer() queues an SpiTransaction on the bus's I/O thread
+ * - readLine() collects a line from a SerialPort as bytes arrive
+ * Every coroutine resumes on the loop thread, so they need no locks.
+ *
+ * The rest of the library builds as C++17; this header is empty unless
+ * the including file is compiled as C++20 (PIPINPP_HAS_COROUTINES is
+ * then defined). Awaitables are free functions taking the loop rather
+ * than members of Pin/WireClass for the same reason.
+ *
+ * @note A pin can have only one edge() waiter at a time; edges queued in
+ *       the kernel before the await are delivered to it too.
+ * @note A capturing lambda used as a coroutine must outlive it: the frame
+ *       refers to the closure, so spawn(body()) on a named lambda is fine,
+ *       spawn([&]() -> Task<> {...}()) dangles.
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#define PIPINPP_HAS_COROUTINES 1
+
+#include "SPI.hpp"
+#include "Serial.hpp"
+#include "Wire.hpp"
+#include "event_loop.hpp"
+#include "log.hpp"
+#include "pin.hpp"
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace pipinpp {
+namespace coro {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr exception;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            return handle.promise().continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+    void return_value(T result) { value.emplace(std::move(result)); }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+};
+
+} // namespace detail
+
+/**
+ * @brief Lazily started coroutine producing a T
+ *
+ * Owns its frame; co_await it (or pass it to spawn()) to run it.
+ */
+template <typename T>
+class Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) noexcept : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { reset(); }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation = awaiter;
+        return handle_;
+    }
+
+    T await_resume() {
+        promise_type& promise = handle_.promise();
+        if (promise.exception) {
+            std::rethrow_exception(promise.exception);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*promise.value);
+        }
+    }
+
+    /**
+     * @brief Whether the coroutine has run to completion
+     */
+    bool done() const noexcept { return handle_ && handle_.done(); }
+
+private:
+    void reset() noexcept {
+        if (handle_) {
+            handle_.destroy();
+        }
+        handle_ = {};
+    }
+
+    Handle handle_;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+/**
+ * @brief Self-destroying coroutine that drives a spawned Task
+ */
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept {}
+    };
+};
+
+inline Detached runDetached(Task<void> task) {
+    try {
+        co_await task;
+    } catch (const std::exception& error) {
+        PIPINPP_LOG_WARNING("Spawned coroutine ended with an exception: " << error.what());
+    } catch (...) {
+        PIPINPP_LOG_WARNING("Spawned coroutine ended with an exception");
+    }
+}
+
+inline int64_t toMicros(std::chrono::nanoseconds duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+} // namespace detail
+
+/**
+ * @brief Start a task without awaiting it; its frame is freed when it finishes
+ *
+ * Runs synchronously up to the task's first suspension. An exception
+ * escaping the task is logged and dropped.
+ */
+inline void spawn(Task<void> task) {
+    detail::runDetached(std::move(task));
+}
+
+/**
+ * @brief Awaiter for sleepFor()
+ */
+class SleepAwaiter {
+public:
+    SleepAwaiter(EventLoop& loop, int64_t delayUs) : loop_(loop), delayUs_(delayUs < 0 ? 0 : delayUs) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        ok_ = loop_.after(static_cast<uint64_t>(delayUs_), [handle] { handle.resume(); }) >= 0;
+        return ok_;
+    }
+
+    /**
+     * @return false if the timer could not be created (did not wait)
+     */
+    bool await_resume() const noexcept { return ok_; }
+
+private:
+    EventLoop& loop_;
+    int64_t delayUs_;
+    bool ok_ = false;
+};
+
+/**
+ * @brief Resume after @p duration (a timerfd on @p loop)
+ */
+inline SleepAwaiter sleepFor(EventLoop& loop, std::chrono::nanoseconds duration) {
+    return SleepAwaiter(loop, detail::toMicros(duration));
+}
+
+/**
+ * @brief Awaiter for edge()
+ */
+class EdgeAwaiter {
+public:
+    EdgeAwaiter(EventLoop& loop, Pin& pin, int mode, int64_t timeoutUs)
+        : loop_(loop), pin_(pin), mode_(mode), timeoutUs_(timeoutUs) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        pinId_ = loop_.addPin(pin_, [this](const PinEdgeEvent& event) {
+            if (!result_ && matches(event)) {
+                result_ = event;
+                finish();
+            }
+        });
+        if (pinId_ < 0) {
+            return false;                  // Not an input: resume with nullopt
+        }
+        if (timeoutUs_ >= 0) {
+            timerId_ = loop_.after(static_cast<uint64_t>(timeoutUs_), [this] {
+                timerId_ = -1;             // One-shot, already removed
+                finish();
+            });
+        }
+        return true;
+    }
+
+    /**
+     * @return The first matching edge, or nullopt on timeout or error
+     */
+    std::optional<PinEdgeEvent> await_resume() const noexcept { return result_; }
+
+private:
+    bool matches(const PinEdgeEvent& event) const {
+        return mode_ == 2 || (mode_ == 0) == event.rising;   // CHANGE, RISING, FALLING
+    }
+
+    void finish() {
+        loop_.remove(pinId_);
+        if (timerId_ >= 0) {
+            loop_.remove(timerId_);
+        }
+        handle_.resume();                  // May destroy this awaiter
+    }
+
+    EventLoop& loop_;
+    Pin& pin_;
+    int mode_;
+    int64_t timeoutUs_;
+    std::coroutine_handle<> handle_;
+    std::optional<PinEdgeEvent> result_;
+    int pinId_ = -1;
+    int timerId_ = -1;
+};
+
+/**
+ * @brief Wait for an edge on an input pin
+ *
+ * @param mode RISING, FALLING or CHANGE (ArduinoCompat values 0, 1, 2)
+ * @param timeout Longest wait; negative waits forever
+ */
+inline EdgeAwaiter edge(EventLoop& loop, Pin& pin, int mode,
+                        std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1)) {
+    return EdgeAwaiter(loop, pin, mode, timeout.count() < 0 ? -1 : detail::toMicros(timeout));
+}
+
+/**
+ * @brief Awaiter for blocking()
+ */
+template <typename Function>
+class BlockingAwaiter {
+public:
+    using Result = std::invoke_result_t<Function&>;
+
+    BlockingAwaiter(EventLoop& loop, Function function) : loop_(loop), function_(std::move(function)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        loop_.runBlocking(
+            [this] {
+                try {
+                    if constexpr (std::is_void_v<Result>) {
+                        function_();
+                    } else {
+                        result_.emplace(function_());
+                    }
+                } catch (...) {
+                    exception_ = std::current_exception();
+                }
+            },
+            [handle] { handle.resume(); });
+    }
+
+    Result await_resume() {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+        if constexpr (!std::is_void_v<Result>) {
+            return std::move(*result_);
+        }
+    }
+
+private:
+    struct Empty {};
+    using Storage = std::conditional_t<std::is_void_v<Result>, Empty, std::optional<Result>>;
+
+    EventLoop& loop_;
+    Function function_;
+    Storage result_;
+    std::exception_ptr exception_;
+};
+
+/**
+ * @brief Run a blocking call on the loop's helper thread and resume with its result
+ */
+template <typename Function>
+BlockingAwaiter<Function> blocking(EventLoop& loop, Function function) {
+    return BlockingAwaiter<Function>(loop, std::move(function));
+}
+
+/**
+ * @brief WireClass::readRegisters() off the loop thread
+ * @return Bytes read, -1 on error (as readRegisters())
+ */
+inline auto readRegisters(EventLoop& loop, WireClass& wire, uint8_t address, uint8_t reg,
+                          uint8_t* buffer, size_t length) {
+    return blocking(loop, [&wire, address, reg, buffer, length] {
+        return wire.readRegisters(address, reg, buffer, length);
+    });
+}
+
+/**
+ * @brief WireClass::writeRegisters() off the loop thread
+ * @return true on success
+ */
+inline auto writeRegisters(EventLoop& loop, WireClass& wire, uint8_t address, uint8_t reg,
+                           const uint8_t* data, size_t length) {
+    return blocking(loop, [&wire, address, reg, data, length] {
+        return wire.writeRegisters(address, reg, data, length);
+    });
+}
+
+/**
+ * @brief Awaiter for transfer()
+ */
+class SpiAwaiter {
+public:
+    SpiAwaiter(EventLoop& loop, SPIClass& spi, SpiTransaction transaction)
+        : loop_(loop), spi_(spi), transaction_(std::move(transaction)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        EventLoop* loop = &loop_;
+        bool* ok = &ok_;
+        return spi_.submit(std::move(transaction_), [loop, ok, handle](bool success) {
+            loop->post([ok, handle, success] {
+                *ok = success;
+                handle.resume();
+            });
+        });
+    }
+
+    /**
+     * @return true if the transaction was sent
+     */
+    bool await_resume() const noexcept { return ok_; }
+
+private:
+    EventLoop& loop_;
+    SPIClass& spi_;
+    SpiTransaction transaction_;
+    bool ok_ = false;
+};
+
+/**
+ * @brief Queue a transaction on the bus's I/O thread and resume when it completes
+ */
+inline SpiAwaiter transfer(EventLoop& loop, SPIClass& spi, SpiTransaction transaction) {
+    return SpiAwaiter(loop, spi, std::move(transaction));
+}
+
+/**
+ * @brief Awaiter for readLine()
+ */
+class LineAwaiter {
+public:
+    LineAwaiter(EventLoop& loop, SerialPort& port, int64_t timeoutUs)
+        : loop_(loop), port_(port), timeoutUs_(timeoutUs) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        portId_ = loop_.addSerial(port_, [this] { receive(); });
+        if (portId_ < 0) {
+            return false;
+        }
+        if (timeoutUs_ >= 0) {
+            timerId_ = loop_.after(static_cast<uint64_t>(timeoutUs_), [this] {
+                timerId_ = -1;
+                finish(false);
+            });
+        }
+        return true;
+    }
+
+    /**
+     * @return The line without its "\n" or "\r\n", nullopt on timeout or
+     *         if the port is closed (a partial line is dropped)
+     */
+    std::optional<std::string> await_resume() { return complete_ ? std::optional<std::string>(std::move(line_)) : std::nullopt; }
+
+private:
+    void receive() {
+        while (port_.available() > 0) {
+            int c = port_.read();
+            if (c < 0) {
+                return;
+            }
+            if (c == '\n') {
+                finish(true);
+                return;
+            }
+            if (c != '\r') {
+                line_.push_back(static_cast<char>(c));
+            }
+        }
+    }
+
+    void finish(bool complete) {
+        complete_ = complete;
+        loop_.remove(portId_);
+        if (timerId_ >= 0) {
+            loop_.remove(timerId_);
+        }
+        handle_.resume();                  // May destroy this awaiter
+    }
+
+    EventLoop& loop_;
+    SerialPort& port_;
+    int64_t timeoutUs_;
+    std::coroutine_handle<> handle_;
+    std::string line_;
+    bool complete_ = false;
+    int portId_ = -1;
+    int timerId_ = -1;
+};
+
+/**
+ * @brief Read one line from a port without a receive thread
+ *
+ * @param timeout Longest wait; negative waits forever
+ */
+inline LineAwaiter readLine(EventLoop& loop, SerialPort& port,
+                            std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1)) {
+    return LineAwaiter(loop, port, timeout.count() < 0 ? -1 : detail::toMicros(timeout));
+}
+
+} // namespace coro
+} // namespace pipinpp
+
+#endif // C++20 coroutines
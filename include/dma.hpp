@@ -0,0 +1,324 @@
+/**
+ * @file dma.hpp
+ * @brief BCM283x/BCM2711 DMA, uncached memory and peripheral register access
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Building blocks for DMA-paced outputs (DmaPWM, DmaSoftPWM), grown out of
+ * examples/poc_dma_gpio. Unlike the proof of concept, DMA buffers are real
+ * uncached VideoCore allocations obtained through the /dev/vcio mailbox,
+ * so the bus addresses handed to the DMA engine are valid.
+ *
+ * - DmaMemory: locked, uncached memory with virtual and bus addresses
+ * - PeripheralMap: /dev/mem window onto a peripheral register block
+ * - DmaChannel: one DMA engine channel (start, stop, status)
+ * - PwmPacer: PWM peripheral + clock manager set up as a DREQ source
+ *
+ * Requirements:
+ * - Raspberry Pi Zero/1/2/3/4 (BCM2835/6/7, BCM2711). The Pi 5 routes
+ *   GPIO and PWM through RP1, which is not reachable from these engines.
+ * - Root (for /dev/mem) and access to /dev/vcio
+ * - The chosen DMA channel must not be used by the kernel (5 is safe on
+ *   current Raspberry Pi OS images)
+ *
+ * @warning Only one DMA-paced PiPinPP output can use the PWM peripheral at
+ *          a time, and it cannot be combined with HardwarePWM.
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pipinpp {
+
+/**
+ * @brief Register offsets, bus addresses and bit definitions
+ */
+namespace dma {
+
+constexpr uint32_t BUS_PERIPHERAL_BASE = 0x7E000000;   ///< Peripheral base as seen by DMA
+
+constexpr uint32_t GPIO_OFFSET = 0x200000;             ///< GPIO block
+constexpr uint32_t PWM_OFFSET = 0x20C000;              ///< PWM block
+constexpr uint32_t CLOCK_OFFSET = 0x101000;            ///< Clock manager
+constexpr uint32_t DMA_OFFSET = 0x007000;              ///< DMA channels 0-14 (0x100 apart)
+
+// GPIO word offsets
+constexpr uint32_t GPFSEL0 = 0x00 / 4;
+constexpr uint32_t GPSET0 = 0x1C / 4;
+constexpr uint32_t GPCLR0 = 0x28 / 4;
+
+// PWM word offsets
+constexpr uint32_t PWM_CTL = 0x00 / 4;
+constexpr uint32_t PWM_STA = 0x04 / 4;
+constexpr uint32_t PWM_DMAC = 0x08 / 4;
+constexpr uint32_t PWM_RNG1 = 0x10 / 4;
+constexpr uint32_t PWM_DAT1 = 0x14 / 4;
+constexpr uint32_t PWM_FIF1 = 0x18 / 4;
+constexpr uint32_t PWM_RNG2 = 0x20 / 4;
+constexpr uint32_t PWM_DAT2 = 0x24 / 4;
+
+// PWM_CTL bits (channel 2 bits are channel 1 bits << 8)
+constexpr uint32_t PWM_CTL_PWEN1 = 1u << 0;
+constexpr uint32_t PWM_CTL_MODE1 = 1u << 1;
+constexpr uint32_t PWM_CTL_USEF1 = 1u << 5;
+constexpr uint32_t PWM_CTL_CLRF1 = 1u << 6;
+constexpr uint32_t PWM_CTL_MSEN1 = 1u << 7;
+constexpr uint32_t PWM_DMAC_ENAB = 1u << 31;
+
+// Clock manager word offsets and fields
+constexpr uint32_t CM_PWMCTL = 0xA0 / 4;
+constexpr uint32_t CM_PWMDIV = 0xA4 / 4;
+constexpr uint32_t CM_PASSWORD = 0x5Au << 24;
+constexpr uint32_t CM_ENAB = 1u << 4;
+constexpr uint32_t CM_KILL = 1u << 5;
+constexpr uint32_t CM_BUSY = 1u << 7;
+constexpr uint32_t CM_SRC_OSC = 1;
+
+// DMA channel word offsets
+constexpr uint32_t DMA_CS = 0x00 / 4;
+constexpr uint32_t DMA_CONBLK_AD = 0x04 / 4;
+constexpr uint32_t DMA_DEBUG = 0x20 / 4;
+
+// DMA_CS bits
+constexpr uint32_t DMA_CS_ACTIVE = 1u << 0;
+constexpr uint32_t DMA_CS_END = 1u << 1;
+constexpr uint32_t DMA_CS_INT = 1u << 2;
+constexpr uint32_t DMA_CS_ERROR = 1u << 8;
+constexpr uint32_t DMA_CS_WAIT_FOR_WRITES = 1u << 28;
+constexpr uint32_t DMA_CS_ABORT = 1u << 30;
+constexpr uint32_t DMA_CS_RESET = 1u << 31;
+
+// Transfer information (control block TI) bits
+constexpr uint32_t DMA_TI_WAIT_RESP = 1u << 3;
+constexpr uint32_t DMA_TI_DEST_INC = 1u << 4;
+constexpr uint32_t DMA_TI_DEST_DREQ = 1u << 6;
+constexpr uint32_t DMA_TI_SRC_INC = 1u << 8;
+constexpr uint32_t DMA_TI_NO_WIDE_BURSTS = 1u << 26;
+constexpr uint32_t DMA_TI_PERMAP_SHIFT = 16;
+constexpr uint32_t DMA_PERMAP_PWM = 5;
+
+/**
+ * @brief Bus address of a peripheral register
+ */
+constexpr uint32_t busAddress(uint32_t blockOffset, uint32_t wordOffset) {
+    return BUS_PERIPHERAL_BASE + blockOffset + wordOffset * 4;
+}
+
+} // namespace dma
+
+/**
+ * @brief Default DMA channel for PiPinPP outputs
+ */
+constexpr int DEFAULT_DMA_CHANNEL = 5;
+
+/**
+ * @brief Hardware DMA control block (must be 32-byte aligned)
+ */
+struct alignas(32) DmaControlBlock {
+    uint32_t ti;           ///< Transfer information
+    uint32_t sourceAd;     ///< Source bus address
+    uint32_t destAd;       ///< Destination bus address
+    uint32_t txfrLen;      ///< Transfer length in bytes
+    uint32_t stride;       ///< 2D stride (unused)
+    uint32_t nextConbk;    ///< Bus address of next block, 0 to stop
+    uint32_t reserved[2];  ///< Must be zero
+};
+
+/**
+ * @brief Whether this board has a DMA engine PiPinPP can drive
+ */
+bool isDmaSupported();
+
+/**
+ * @brief Uncached, locked memory usable as a DMA source or control block area
+ *
+ * Allocated from the VideoCore through the /dev/vcio mailbox and mapped
+ * through /dev/mem. Contents are zeroed on allocation.
+ */
+class DmaMemory {
+public:
+    /**
+     * @param size Bytes to allocate (rounded up to whole pages)
+     * @throws GpioAccessError if the mailbox or /dev/mem is unavailable
+     */
+    explicit DmaMemory(size_t size);
+    ~DmaMemory();
+
+    DmaMemory(const DmaMemory&) = delete;
+    DmaMemory& operator=(const DmaMemory&) = delete;
+
+    /**
+     * @brief CPU pointer to the start of the allocation
+     */
+    void* virt() const { return virt_; }
+
+    /**
+     * @brief Bus address for a pointer inside the allocation
+     */
+    uint32_t busAddress(const void* ptr) const {
+        return busBase_ + static_cast<uint32_t>(static_cast<const uint8_t*>(ptr) -
+                                                static_cast<const uint8_t*>(virt_));
+    }
+
+    /**
+     * @brief Allocation size in bytes
+     */
+    size_t size() const { return size_; }
+
+private:
+    int mailboxFd_;
+    uint32_t handle_;
+    uint32_t busBase_;
+    void* virt_;
+    size_t size_;
+};
+
+/**
+ * @brief /dev/mem mapping of one peripheral register block
+ */
+class PeripheralMap {
+public:
+    /**
+     * @param blockOffset Offset from the peripheral base (e.g. dma::PWM_OFFSET)
+     * @param size Bytes to map
+     * @throws GpioAccessError if the platform is unsupported or /dev/mem cannot be mapped
+     */
+    PeripheralMap(uint32_t blockOffset, size_t size = 4096);
+    ~PeripheralMap();
+
+    PeripheralMap(const PeripheralMap&) = delete;
+    PeripheralMap& operator=(const PeripheralMap&) = delete;
+
+    /**
+     * @brief Register block
+     */
+    volatile uint32_t* regs() const { return regs_; }
+
+private:
+    volatile uint32_t* regs_;
+    void* map_;
+    size_t mapSize_;
+};
+
+/**
+ * @brief One channel of the DMA engine
+ */
+class DmaChannel {
+public:
+    /**
+     * @param channel DMA channel (0-14)
+     * @throws InvalidPinError for out-of-range channels
+     * @throws GpioAccessError if the registers cannot be mapped
+     */
+    explicit DmaChannel(int channel = DEFAULT_DMA_CHANNEL);
+
+    /**
+     * @brief Stops the channel
+     */
+    ~DmaChannel();
+
+    DmaChannel(const DmaChannel&) = delete;
+    DmaChannel& operator=(const DmaChannel&) = delete;
+
+    /**
+     * @brief Reset the channel and start at a control block
+     */
+    void start(uint32_t controlBlockBus);
+
+    /**
+     * @brief Abort the current transfer and reset the channel
+     */
+    void stop();
+
+    /**
+     * @brief Whether the channel is running
+     */
+    bool isActive() const;
+
+    /**
+     * @brief Whether the channel reported an error
+     */
+    bool hasError() const;
+
+    /**
+     * @brief Bus address of the control block being executed
+     */
+    uint32_t currentBlock() const;
+
+private:
+    uint32_t channel_;
+    PeripheralMap map_;          ///< Page holding channels 0-14
+    volatile uint32_t* regs_;
+};
+
+/**
+ * @brief PWM peripheral and its clock configured as a DREQ source
+ *
+ * Every word written to the PWM FIFO is consumed once per PWM period, so
+ * DMA transfers into the FIFO are paced at clockHz / range.
+ */
+class PwmPacer {
+public:
+    /**
+     * @throws GpioAccessError if the registers cannot be mapped
+     */
+    PwmPacer();
+
+    /**
+     * @brief Stops PWM and its clock
+     */
+    ~PwmPacer();
+
+    PwmPacer(const PwmPacer&) = delete;
+    PwmPacer& operator=(const PwmPacer&) = delete;
+
+    /**
+     * @brief Integer clock divisor from the crystal for a target PWM clock
+     * @param oscillatorHz Crystal frequency
+     * @param clockHz Requested PWM clock
+     * @param[out] divisor Divisor (2-4095)
+     * @return false if the clock is out of range
+     */
+    static bool computeDivisor(uint32_t oscillatorHz, uint32_t clockHz, uint32_t& divisor);
+
+    /**
+     * @brief Crystal oscillator frequency of this board (19.2 or 54 MHz)
+     */
+    static uint32_t oscillatorHz();
+
+    /**
+     * @brief Start the PWM clock from the crystal
+     * @return Actual clock in Hz, or 0 if @p clockHz is out of range
+     */
+    uint32_t setClock(uint32_t clockHz);
+
+    /**
+     * @brief Run one PWM channel in mark-space mode fed from the FIFO with DMA requests enabled
+     * @param channel PWM channel (0 or 1)
+     * @param range Clock ticks per FIFO word
+     */
+    void startFifo(int channel, uint32_t range);
+
+    /**
+     * @brief Stop both PWM channels and DMA requests
+     */
+    void stop();
+
+    /**
+     * @brief Bus address of the PWM FIFO (DMA destination)
+     */
+    static constexpr uint32_t fifoBusAddress() { return dma::busAddress(dma::PWM_OFFSET, dma::PWM_FIF1); }
+
+private:
+    PeripheralMap pwm_;
+    PeripheralMap clock_;
+};
+
+} // namespace pipinpp
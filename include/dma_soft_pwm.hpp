@@ -0,0 +1,234 @@
+/**
+ * @file dma_soft_pwm.hpp
+ * @brief DMA-timed software PWM on any GPIO (servoblaster/pigpio style)
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * HardwarePWM covers two channels, and EventPWM needs a CPU thread to time
+ * every edge. DmaSoftPWM drives any of GPIO 0-27 from a circular chain of
+ * DMA control blocks, so once a duty cycle is set no CPU time is spent per
+ * edge and timing does not depend on scheduling.
+ *
+ * The PWM cycle is split into ticks of stepUs. For every tick the chain
+ * does three transfers:
+ * 1. Write that tick's set mask to GPSET0
+ * 2. Write that tick's clear mask to GPCLR0
+ * 3. Write one word to the PWM FIFO, which stalls the DMA for one tick
+ *    (the PWM peripheral is used only as a clock; its output is not routed)
+ *
+ * Each channel sets its bit at tick 0 and clears it at tick
+ * width / stepUs, so updating a duty cycle is two word writes to uncached
+ * memory.
+ *
+ * Requirements are the same as for DmaPWM (see dma.hpp): a Raspberry Pi
+ * Zero-4, root, and a free DMA channel. The PWM block is shared with
+ * DmaPWM and HardwarePWM, so only one of them can be used.
+ *
+ * Example usage:
+ * @code
+ * #include "dma_soft_pwm.hpp"
+ *
+ * int main() {
+ *     auto& pwm = pipinpp::DmaSoftPWM::getInstance();
+ *     pwm.begin(20000, 10);           // 50 Hz, 10 µs resolution (servos)
+ *
+ *     for (int pin = 4; pin < 20; ++pin) {
+ *         pwm.setPulseWidthUs(pin, 1500);   // 16 servos centred
+ *     }
+ *     pwm.setDutyCycle(21, 25.0);          // LED at 25%
+ *
+ *     delay(5000);
+ *     pwm.end();
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "dma.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace pipinpp {
+
+/**
+ * @brief Default DmaSoftPWM cycle length (microseconds, 50 Hz)
+ */
+constexpr uint32_t DMA_SOFT_PWM_DEFAULT_CYCLE_US = 20000;
+
+/**
+ * @brief Default DmaSoftPWM tick length (microseconds)
+ */
+constexpr uint32_t DMA_SOFT_PWM_DEFAULT_STEP_US = 10;
+
+/**
+ * @brief Largest number of ticks per cycle (bounds the DMA memory to ~1 MiB)
+ */
+constexpr uint32_t DMA_SOFT_PWM_MAX_TICKS = 10000;
+
+/**
+ * @brief Multi-pin PWM timed entirely by DMA
+ *
+ * Singleton, since it owns the PWM block and a DMA channel. Every channel
+ * shares the cycle length; duty cycles are independent.
+ *
+ * @note Thread-safe
+ * @note setDutyCycle() and friends call begin() with the defaults if it
+ *       has not been called yet
+ */
+class DmaSoftPWM {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static DmaSoftPWM& getInstance();
+
+    /**
+     * @brief Allocate the control-block chain and start the DMA
+     * @param cycleUs PWM period in microseconds (multiple of stepUs)
+     * @param stepUs Tick length / duty resolution in microseconds (2 or more)
+     * @param dmaChannel DMA channel to use (0-14)
+     * @return true on success (or already running with the same settings),
+     *         false on invalid settings or when DMA is not available
+     */
+    bool begin(uint32_t cycleUs = DMA_SOFT_PWM_DEFAULT_CYCLE_US,
+               uint32_t stepUs = DMA_SOFT_PWM_DEFAULT_STEP_US,
+               int dmaChannel = DEFAULT_DMA_CHANNEL);
+
+    /**
+     * @brief Stop every channel (driven low), stop DMA and restore pin functions
+     *
+     * @note Safe to call multiple times
+     */
+    void end();
+
+    /**
+     * @brief Check if the DMA chain is running
+     */
+    bool isBegun() const;
+
+    /**
+     * @brief Set a channel's duty cycle, starting it if needed
+     * @param pin GPIO pin number (0-27)
+     * @param percent Duty cycle percentage (0.0-100.0), rounded to the tick
+     * @return true on success, false on invalid duty or if DMA is unavailable
+     * @throws InvalidPinError if pin number invalid
+     */
+    bool setDutyCycle(int pin, double percent);
+
+    /**
+     * @brief Set a channel's pulse width, starting it if needed
+     * @param pin GPIO pin number (0-27)
+     * @param widthUs High time per cycle in microseconds (clamped to the cycle)
+     * @return true on success, false if DMA is unavailable
+     * @throws InvalidPinError if pin number invalid
+     */
+    bool setPulseWidthUs(int pin, uint32_t widthUs);
+
+    /**
+     * @brief Arduino-style 8-bit duty (0-255)
+     * @throws InvalidPinError if pin number invalid
+     */
+    bool analogWrite(int pin, int value);
+
+    /**
+     * @brief Stop PWM on a pin (driven low, pin function restored)
+     * @param pin GPIO pin number
+     * @return true if PWM was active
+     */
+    bool stopPWM(int pin);
+
+    /**
+     * @brief Check if PWM is active on a pin
+     */
+    bool isActive(int pin) const;
+
+    /**
+     * @brief Get a channel's duty cycle percentage, or -1.0 if not active
+     */
+    double getDutyCycle(int pin) const;
+
+    /**
+     * @brief Get number of active PWM channels
+     */
+    size_t getActiveCount() const;
+
+    /**
+     * @brief Get cycle length in microseconds, or 0 if not begun
+     */
+    uint32_t getCycleUs() const;
+
+    /**
+     * @brief Get tick length in microseconds, or 0 if not begun
+     */
+    uint32_t getStepUs() const;
+
+    /**
+     * @brief Helper: Tick at which a channel's output goes low
+     * @param widthUs Requested high time
+     * @param stepUs Tick length
+     * @param ticks Ticks per cycle
+     * @return Tick in [0, ticks]; @p ticks means never cleared (100%)
+     */
+    static uint32_t widthToTicks(uint32_t widthUs, uint32_t stepUs, uint32_t ticks);
+
+    /**
+     * @brief Helper: DMA memory needed for a cycle
+     * @param ticks Ticks per cycle
+     * @return Bytes for control blocks, set/clear masks and the FIFO word
+     */
+    static size_t memoryBytes(uint32_t ticks);
+
+    DmaSoftPWM(const DmaSoftPWM&) = delete;
+    DmaSoftPWM& operator=(const DmaSoftPWM&) = delete;
+
+private:
+    DmaSoftPWM();
+    ~DmaSoftPWM();
+
+    static constexpr int NUM_PINS = 28;      ///< GPIO 0-27 (bank 0)
+    static constexpr uint32_t OFF = UINT32_MAX;
+
+    /**
+     * @brief Move a pin's clear tick, keeping every cycle cleared at least once
+     *
+     * Claims the pin (saves its function, drives it low, makes it an
+     * output) on first use.
+     *
+     * @note Caller must hold mutex_ and the DMA must be running
+     */
+    void applyWidth(int pin, uint32_t clearTick);
+
+    /**
+     * @brief Set the pin's GPFSEL function code
+     * @note Caller must hold mutex_
+     */
+    void setPinFunction(int pin, uint32_t function);
+
+    bool beginLocked(uint32_t cycleUs, uint32_t stepUs, int dmaChannel);
+    void endLocked();
+
+    mutable std::mutex mutex_;
+    uint32_t cycleUs_;
+    uint32_t stepUs_;
+    uint32_t ticks_;
+    uint32_t clearTick_[NUM_PINS];           ///< Current clear tick per pin, OFF if inactive
+    uint32_t savedFunction_[NUM_PINS];       ///< GPFSEL code before the pin was claimed
+
+    std::unique_ptr<PeripheralMap> gpio_;    ///< GPIO registers (pin function, idle level)
+    std::unique_ptr<PwmPacer> pacer_;        ///< PWM block used as the tick clock
+    std::unique_ptr<DmaChannel> dma_;        ///< DMA engine channel
+    std::unique_ptr<DmaMemory> memory_;      ///< Control blocks + masks
+    volatile uint32_t* setMasks_;            ///< One GPSET0 word per tick
+    volatile uint32_t* clearMasks_;          ///< One GPCLR0 word per tick
+};
+
+} // namespace pipinpp
@@ -0,0 +1,145 @@
+/**
+ * @file edge_queue.hpp
+ * @brief Queued edge delivery: interrupts into a lock-free ring drained by the consumer
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * An interrupt callback runs on the monitor thread, so a callback that has
+ * to wait for something (a Python GIL, a GUI lock) delays every pin.
+ * EdgeQueue attaches batch interrupts whose only work is copying the
+ * events into an SpscRing and, once per batch, writing an eventfd. The
+ * consumer drains the ring whenever it likes:
+ * - poll() copies out up to N events without blocking
+ * - wait() sleeps on the eventfd until events arrive or a timeout
+ * - fd() can be added to poll()/epoll/an asyncio loop instead
+ *
+ * The monitor thread never blocks on the consumer. If the ring is full,
+ * new events are dropped and counted (getDroppedCount()); lineSeqno gaps
+ * show where.
+ *
+ * Example usage:
+ * @code
+ * #include "edge_queue.hpp"
+ *
+ * pipinpp::EdgeQueue queue(4096);
+ * queue.attach(17, InterruptMode::CHANGE);
+ * queue.attach(27, InterruptMode::RISING);
+ *
+ * EdgeEvent events[64];
+ * while (running) {
+ *     queue.wait(100);
+ *     size_t n = queue.poll(events, 64);
+ *     for (size_t i = 0; i < n; ++i) {
+ *         handle(events[i].pin, events[i].type, events[i].timestampNs);
+ *     }
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "interrupts.hpp"
+#include "spsc_ring.hpp"
+
+namespace pipinpp {
+
+/**
+ * @brief Default number of events an EdgeQueue holds
+ */
+constexpr size_t EDGE_QUEUE_DEFAULT_CAPACITY = 4096;
+
+/**
+ * @brief Edge events from any number of pins, queued for one consumer thread
+ *
+ * @note attach()/detach() are thread-safe; poll() must only be called by
+ *       one thread at a time (the ring has a single consumer)
+ */
+class EdgeQueue {
+public:
+    /**
+     * @param capacity Events held before new ones are dropped (rounded up to a power of two)
+     * @throws GpioAccessError if the eventfd cannot be created
+     */
+    explicit EdgeQueue(size_t capacity = EDGE_QUEUE_DEFAULT_CAPACITY);
+
+    /**
+     * @brief Detaches every pin and closes the eventfd
+     */
+    ~EdgeQueue();
+
+    EdgeQueue(const EdgeQueue&) = delete;
+    EdgeQueue& operator=(const EdgeQueue&) = delete;
+
+    /**
+     * @brief Queue edges from @p pin
+     * @throws InvalidPinError / GpioAccessError as InterruptManager::attachInterruptBatch(),
+     *         including when the pin already has an interrupt
+     */
+    void attach(int pin, InterruptMode mode, size_t bufferSize = DEFAULT_EVENT_BUFFER_SIZE,
+                const std::string& chipname = "gpiochip0");
+
+    /**
+     * @brief Stop queueing @p pin (events already queued stay)
+     * @return false if the pin was not attached to this queue
+     */
+    bool detach(int pin);
+
+    /**
+     * @brief Copy out up to @p max events, oldest first, without blocking
+     * @return Number of events copied
+     */
+    size_t poll(EdgeEvent* out, size_t max);
+
+    /**
+     * @brief Wait until events are queued
+     * @param timeoutMs Milliseconds to wait, negative to wait forever
+     * @return true if events are waiting
+     */
+    bool wait(int timeoutMs) const;
+
+    /**
+     * @brief eventfd that is readable while events may be waiting
+     *
+     * Level-triggered and may wake spuriously; poll() resets it.
+     */
+    int fd() const { return eventFd_; }
+
+    /**
+     * @brief Events waiting (exact from the consumer thread)
+     */
+    size_t size() const { return ring_.size(); }
+
+    size_t capacity() const { return ring_.capacity(); }
+
+    /**
+     * @brief Events dropped because the queue was full
+     */
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Pins currently attached
+     */
+    std::vector<int> getPins() const;
+
+private:
+    void push(const EdgeEventSpan& events);
+
+    SpscRing<EdgeEvent> ring_;
+    int eventFd_ = -1;
+    std::atomic<uint64_t> dropped_{0};
+    mutable std::mutex mutex_;          ///< Guards pins_
+    std::vector<int> pins_;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,84 @@
+/**
+ * @file error_code.hpp
+ * @brief std::error_code results for the exception-free (noexcept) API
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * digitalWrite() and friends report failures by throwing PinError types
+ * whose messages are built with std::string. The noexcept variants
+ * (tryDigitalWrite(), Pin::writeNoexcept(), SPIClass::tryTransfer(),
+ * WireClass::tryReadRegisters(), ...) return a std::error_code instead:
+ * two words, no allocation, nothing to unwind. The text is only built if
+ * the caller asks for message().
+ *
+ * Errors detected by PiPinPP itself use GpioErrc in gpioCategory();
+ * failed system calls carry their errno in std::system_category(), so
+ * they compare equal to std::errc values (e.g. std::errc::no_such_device_or_address
+ * for an I2C NACK).
+ *
+ * std::expected would need C++23; the library builds as C++17, so values
+ * are returned through out-parameters.
+ *
+ * Example usage:
+ * @code
+ * #include "ArduinoCompat.hpp"
+ *
+ * if (std::error_code error = tryDigitalWrite(17, HIGH)) {
+ *     if (error == pipinpp::GpioErrc::NOT_CONFIGURED) {
+ *         // pinMode() was not called
+ *     }
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <system_error>
+#include <type_traits>
+
+namespace pipinpp {
+
+/**
+ * @brief Errors detected by PiPinPP (value 0 is never used: it means success)
+ */
+enum class GpioErrc {
+    INVALID_PIN = 1,     ///< Pin number outside the board's GPIO range
+    NOT_CONFIGURED,      ///< pinMode() has not been called for the pin
+    WRONG_DIRECTION,     ///< Write to an input, or the operation needs another mode
+    INVALID_ARGUMENT,    ///< Null buffer, zero or oversized length
+    NOT_OPEN,            ///< Line, bus or device not opened (begin() not called)
+    ACCESS_FAILED        ///< The backend failed without an errno
+};
+
+/**
+ * @brief Category of GpioErrc values (name "pipinpp")
+ */
+const std::error_category& gpioCategory() noexcept;
+
+inline std::error_code make_error_code(GpioErrc error) noexcept {
+    return std::error_code(static_cast<int>(error), gpioCategory());
+}
+
+/**
+ * @brief errno of the system call that just failed, or @p fallback if none is set
+ */
+inline std::error_code lastSystemError(GpioErrc fallback = GpioErrc::ACCESS_FAILED) noexcept {
+    int error = errno;
+    if (error != 0) {
+        return std::error_code(error, std::system_category());
+    }
+    return make_error_code(fallback);
+}
+
+} // namespace pipinpp
+
+namespace std {
+template <>
+struct is_error_code_enum<pipinpp::GpioErrc> : true_type {};
+} // namespace std
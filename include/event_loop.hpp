@@ -0,0 +1,219 @@
+/**
+ * @file event_loop.hpp
+ * @brief Single-threaded epoll loop for GPIO edges, serial, timers and user fds
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * attachInterrupt(), TimerManager, PWM and a serial polling loop each run
+ * on their own thread, and the application pays for it with locks and
+ * cross-thread handoffs. EventLoop is the optional alternative: one epoll
+ * instance that the application's own thread runs, with every source
+ * registered on it:
+ * - addPin(): edge events read straight from the Pin's line request fd
+ *   (kernel timestamps, debounce as configured on the Pin)
+ * - addSerial(): readiness of a SerialPort's fd
+ * - every()/after(): one timerfd per timer, armed with absolute fixed-rate
+ *   deadlines; missed periods are counted, not run in a burst
+ * - addFd(): any other fd (sockets, pipes, eventfds)
+ *
+ * Callbacks run on the thread calling run()/runOnce(), one at a time, so
+ * they need no locks. Only stop() and post() may be called from another
+ * thread. Sources can be removed from inside a callback, including their
+ * own. Blocking calls (an I2C transaction, a file write) can be moved off
+ * the loop with runBlocking(), which runs them on a helper thread and
+ * delivers the completion back on the loop thread.
+ *
+ * Example usage:
+ * @code
+ * #include "event_loop.hpp"
+ *
+ * pipinpp::EventLoop loop;
+ * Pin button(17, PinMode::INPUT_PULLUP);
+ * loop.addPin(button, [](const PinEdgeEvent& edge) { onPress(edge.timestampNs); });
+ * loop.addSerial(Serial, [] { while (Serial.available()) handle(Serial.read()); });
+ * loop.every(10000, [] { pidStep(); });         // 100 Hz
+ * loop.run();                                   // Until loop.stop()
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "Serial.hpp"
+#include "pin.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @brief Readiness callback for addFd() (@p events is the epoll event mask)
+ */
+using EventLoopFdCallback = std::function<void(uint32_t events)>;
+
+/**
+ * @brief Edge callback for addPin()
+ */
+using EventLoopEdgeCallback = std::function<void(const PinEdgeEvent& edge)>;
+
+/**
+ * @brief Callback for timers and serial readiness
+ */
+using EventLoopCallback = std::function<void()>;
+
+/**
+ * @brief One epoll set dispatching every registered source on the calling thread
+ *
+ * @note Not thread-safe except for stop() and post(); use from one thread
+ */
+class EventLoop {
+public:
+    /**
+     * @throws GpioAccessError if the epoll instance cannot be created
+     */
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Watch a file descriptor (not owned; remove() it before closing)
+     *
+     * @param events epoll event mask, e.g. EPOLLIN
+     * @return Source id, -1 on error
+     */
+    int addFd(int fd, uint32_t events, EventLoopFdCallback callback);
+
+    /**
+     * @brief Deliver the edges of an input Pin
+     *
+     * Enables edge events on the pin if they are off. The pin must outlive
+     * its registration.
+     *
+     * @return Source id, -1 if the pin is not an input
+     */
+    int addPin(Pin& pin, EventLoopEdgeCallback callback);
+
+    /**
+     * @brief Call @p callback when received bytes are waiting
+     *
+     * The port must be open and must not run its receive thread
+     * (beginRxThread()), which would drain the fd first.
+     *
+     * @return Source id, -1 if the port is closed
+     */
+    int addSerial(SerialPort& port, EventLoopCallback callback);
+
+    /**
+     * @brief Run @p callback every @p periodUs, at fixed rate from now
+     *
+     * @return Source id, -1 on error
+     */
+    int every(uint64_t periodUs, EventLoopCallback callback);
+
+    /**
+     * @brief Run @p callback once, @p delayUs from now (removed afterwards)
+     *
+     * @return Source id, -1 on error
+     */
+    int after(uint64_t delayUs, EventLoopCallback callback);
+
+    /**
+     * @brief Unregister a source (safe from inside any callback)
+     */
+    bool remove(int id);
+
+    /**
+     * @brief Timer periods that passed without a callback (the loop was busy)
+     */
+    uint64_t getTimerOverruns(int id) const;
+
+    /**
+     * @brief Wait once and dispatch what is ready
+     *
+     * @param timeoutMs Longest wait, -1 for no limit
+     * @return Callbacks run, -1 on error
+     */
+    int runOnce(int timeoutMs = -1);
+
+    /**
+     * @brief Dispatch until stop()
+     */
+    void run();
+
+    /**
+     * @brief Make run() return after the current dispatch (any thread)
+     *
+     * A stop() before run() makes the next run() return at once.
+     */
+    void stop();
+
+    /**
+     * @brief Run @p callback on the loop thread at its next wakeup (any thread)
+     */
+    void post(EventLoopCallback callback);
+
+    /**
+     * @brief Run blocking @p work on the loop's helper thread, then @p done on the loop
+     *
+     * The helper thread ("pipinpp-loopio", started on first use) runs
+     * work items one at a time, in order.
+     */
+    void runBlocking(EventLoopCallback work, EventLoopCallback done);
+
+    /**
+     * @brief Registered sources
+     */
+    size_t size() const { return sources_.size(); }
+
+private:
+    enum class Kind { FD, PIN, TIMER };
+
+    struct Source {
+        Kind kind;
+        int fd;
+        Pin* pin = nullptr;
+        EventLoopFdCallback onReady;
+        EventLoopEdgeCallback onEdge;
+        EventLoopCallback onTimer;
+        bool oneShot = false;
+        uint64_t overruns = 0;
+    };
+
+    int add(int fd, uint32_t events, std::shared_ptr<Source> source);
+    int addTimer(uint64_t delayUs, uint64_t periodUs, EventLoopCallback callback);
+    void dispatch(int id, uint32_t events);
+    int runPosted();
+    void workerThread();
+
+    int epollFd_;
+    int wakeFd_;
+    int nextId_;
+    std::atomic<bool> stopRequested_;    ///< Set by stop(), cleared when run() returns
+    std::unordered_map<int, std::shared_ptr<Source>> sources_;
+
+    std::mutex postMutex_;
+    std::vector<EventLoopCallback> posted_;              ///< Guarded by postMutex_
+
+    std::thread worker_;                                 ///< runBlocking() helper
+    std::mutex workMutex_;
+    std::condition_variable workCv_;
+    std::deque<std::pair<EventLoopCallback, EventLoopCallback>> work_;   ///< work, done
+    bool workerRunning_ = false;                         ///< Guarded by workMutex_
+};
+
+} // namespace pipinpp
@@ -49,9 +49,12 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
-#include <map>
+#include <condition_variable>
+#include <cstdint>
+#include <vector>
 #include <time.h>
 #include "pin.hpp"
+#include "PinGroup.hpp"
 
 namespace pipinpp {
 
@@ -158,29 +161,17 @@ private:
     /**
      * @brief PWM generation thread function
      * 
-     * Hybrid timing algorithm:
-     * 1. Calculate period = 1/frequency
-     * 2. Calculate onTime = period * (dutyCycle/100)
-     * 3. For each cycle:
+     * Hybrid timing algorithm (see PwmEdgeClock):
+     * 1. Recompute integer period/onTime only when duty or frequency change
+     * 2. For each cycle:
      *    a. Set pin HIGH
-     *    b. Sleep (onTime - THRESHOLD), then busy-wait final THRESHOLD
+     *    b. Sleep until (cycleStart + onTime - THRESHOLD), busy-wait the rest
      *    c. Set pin LOW
-     *    d. Sleep (offTime - THRESHOLD), then busy-wait final THRESHOLD
+     *    d. Sleep until (cycleStart + period - THRESHOLD), busy-wait the rest
+     *    e. cycleStart += period (absolute, so no drift accumulates)
      */
     void pwmThreadFunction();
     
-    /**
-     * @brief Hybrid sleep: clock_nanosleep() + busy-wait
-     * @param durationNs Target sleep duration in nanoseconds
-     * 
-     * If duration > BUSYWAIT_THRESHOLD_US:
-     *   - Sleep (duration - threshold) using clock_nanosleep()
-     *   - Busy-wait final threshold microseconds for precision
-     * Else:
-     *   - Pure busy-wait for entire duration
-     */
-    void hybridSleep(long durationNs);
-    
     int pin_;                              ///< GPIO pin number
     std::unique_ptr<Pin> pinObj_;          ///< Pin control object
     std::thread pwmThread_;                ///< PWM generation thread
@@ -190,10 +181,129 @@ private:
     mutable std::mutex mutex_;             ///< Protect state changes
 };
 
+/**
+ * @brief Edges due within this window are written together (nanoseconds)
+ *
+ * EventPWMManager merges every edge whose deadline falls within this window
+ * of the earliest one into a single multi-line write.
+ */
+constexpr long EDGE_COALESCE_NS = 2000;
+
+/**
+ * @brief Edge deadline heap behind EventPWMManager
+ *
+ * Pure scheduling state with no I/O and no locking: channels are indices
+ * (== PinGroup bits), and takeDue() reports which lines to write and the
+ * level of each. EventPWMManager owns one and guards it with its mutex.
+ */
+class EventPWMSchedule {
+public:
+    /**
+     * @brief Append a channel
+     * @note Follow with restart(), pending edges are dropped
+     * @param value 8-bit duty cycle (0-255)
+     * @param frequencyHz Frequency in Hz (> 0)
+     */
+    void add(int value, int frequencyHz);
+
+    /**
+     * @brief Remove a channel; later channels move down one index
+     * @note Follow with restart(), pending edges are dropped
+     */
+    void remove(size_t channel);
+
+    /**
+     * @brief Drop every channel and pending edge
+     */
+    void clear();
+
+    /**
+     * @brief Change a channel's duty and frequency from its next cycle
+     *
+     * A channel held at 0% or 100% has no pending edge, so it starts a new
+     * cycle at @p nowNs instead.
+     *
+     * @return true if the earliest deadline may have changed
+     */
+    bool update(size_t channel, int value, int frequencyHz, int64_t nowNs);
+
+    /**
+     * @brief Start every channel's cycle in phase at @p nowNs
+     */
+    void restart(int64_t nowNs);
+
+    /**
+     * @brief Number of channels
+     */
+    size_t size() const { return channels_.size(); }
+
+    /**
+     * @brief No edge is pending
+     */
+    bool idle() const { return heap_.empty(); }
+
+    /**
+     * @brief Earliest pending deadline (CLOCK_MONOTONIC ns); requires !idle()
+     */
+    int64_t nextDeadlineNs() const { return heap_.front().deadlineNs; }
+
+    /**
+     * @brief Apply every edge due by @p nowNs + EDGE_COALESCE_NS
+     *
+     * A line whose rising and falling edges are both due ends LOW.
+     *
+     * @param[out] mask Lines to write
+     * @param[out] values Level of each line in @p mask
+     */
+    void takeDue(int64_t nowNs, uint64_t& mask, uint64_t& values);
+
+private:
+    /**
+     * @brief Timing state of one channel
+     */
+    struct Channel {
+        int value;                 ///< 8-bit duty cycle (0-255)
+        int frequencyHz;           ///< PWM frequency in Hz
+        int64_t cycleStartNs;      ///< CLOCK_MONOTONIC start of current cycle
+        int64_t periodNs;          ///< Period of current cycle
+        bool scheduled;            ///< Has an edge in the heap (false while held at 0% or 100%)
+    };
+
+    /**
+     * @brief Pending edge in the deadline heap
+     */
+    struct Edge {
+        int64_t deadlineNs;        ///< CLOCK_MONOTONIC deadline
+        size_t channel;            ///< Index into channels_ (== PinGroup bit)
+        bool rising;               ///< Cycle start (true) or falling edge (false)
+
+        bool operator>(const Edge& other) const { return deadlineNs > other.deadlineNs; }
+    };
+
+    /**
+     * @brief Apply one due edge and schedule the channel's next one
+     */
+    void processEdge(const Edge& edge, int64_t nowNs, uint64_t& mask, uint64_t& values);
+
+    void push(const Edge& edge);
+
+    std::vector<Channel> channels_;
+    std::vector<Edge> heap_;                         ///< Min-heap of next edges
+};
+
 /**
  * @brief Manager for multiple EventPWM channels
  * 
  * Singleton pattern to coordinate multiple PWM outputs.
+ *
+ * Unlike standalone EventPWM objects, manager channels share one timer
+ * thread ("pipinpp-epwm") driven by a min-heap of next-edge deadlines,
+ * and all channel lines live in one PinGroup request. Edges that are due
+ * together go out as a single multi-line write, so CPU load follows the
+ * edge rate rather than the channel count.
+ *
+ * @note Adding or removing a channel re-requests the group's lines, which
+ *       briefly pauses every channel.
  */
 class EventPWMManager {
 public:
@@ -209,6 +319,7 @@ public:
      * @param frequencyHz Frequency in Hz (default: 490)
      * 
      * @note Arduino-compatible API
+     * @note Duty and frequency changes take effect at the next cycle
      */
     void analogWriteEvent(int pin, int value, int frequencyHz = 490);
     
@@ -239,8 +350,29 @@ private:
     // Prevent copying
     EventPWMManager(const EventPWMManager&) = delete;
     EventPWMManager& operator=(const EventPWMManager&) = delete;
+
+    /**
+     * @brief Timer thread: sleeps until the earliest deadline, then writes
+     *        every edge due within EDGE_COALESCE_NS in one transaction
+     */
+    void schedulerThread();
+
+    /**
+     * @brief Re-request the PinGroup for pins_ and restart every schedule
+     * @throws InvalidPinError or GpioAccessError if the lines cannot be requested
+     * @note Caller must hold mutex_
+     */
+    void rebuildGroup();
+
+    static int64_t nowNs();
     
-    std::map<int, std::unique_ptr<EventPWM>> channels_;
+    std::vector<int> pins_;                          ///< Channel pins, index == group bit
+    EventPWMSchedule schedule_;                      ///< Edge heap, same indices as pins_
+    std::unique_ptr<PinGroup> group_;                ///< One request for every channel line
+    std::thread scheduler_;                          ///< Shared timer thread
+    std::condition_variable cv_;                     ///< Wakes the timer on channel changes
+    bool running_ = false;                           ///< Timer thread running
+    bool changed_ = false;                           ///< Channel set or schedule changed
     mutable std::mutex mutex_;
 };
 
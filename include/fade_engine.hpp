@@ -0,0 +1,229 @@
+/**
+ * @file fade_engine.hpp
+ * @brief Timer-driven LED fades with a gamma table, for any number of pins
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * A fade written as `for (b...) { analogWrite(pin, b); delay(ms); }`
+ * ties up a thread per LED for the whole fade and steps in perceptually
+ * uneven jumps. FadeEngine instead keeps every fading pin in one table
+ * and advances them all from a single TimerManager task:
+ *
+ * - fadeTo() takes a target brightness, a duration and a curve, and
+ *   returns at once
+ * - each tick interpolates the brightness in 16-bit fixed point, maps it
+ *   through a 256-entry gamma table built once by setGamma(), and writes
+ *   the pin only when the 8-bit output actually changes
+ * - output goes through PwmRouter, so each pin uses the cheapest backend
+ *   it has: persistent HardwarePWM fds, DmaSoftPWM duty buffers or the
+ *   EventPWM scheduler
+ * - the timer task is started by the first fade and cancelled once
+ *   nothing is fading
+ *
+ * Brightness is perceptual: 128 looks about half as bright as 255. Call
+ * setGamma(1.0) to write levels unchanged.
+ *
+ * Example usage:
+ * @code
+ * auto& fades = pipinpp::FadeEngine::getInstance();
+ * for (int pin : {17, 18, 27}) {
+ *     fades.fadeTo(pin, 255, 2000, pipinpp::FadeCurve::EASE_IN_OUT);
+ * }
+ * fades.fadeTo(22, 0, 500);
+ * while (fades.getActiveCount() > 0) {
+ *     delay(10);                                   // Or do something useful
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace pipinpp {
+
+class TimerManager;
+
+/**
+ * @brief Default interval between fade updates (100 Hz)
+ */
+constexpr uint32_t DEFAULT_FADE_TICK_US = 10000;
+
+/**
+ * @brief Default gamma of the brightness table (typical for LEDs)
+ */
+constexpr double DEFAULT_FADE_GAMMA = 2.2;
+
+/**
+ * @brief Shape of the brightness change over a fade
+ */
+enum class FadeCurve {
+    LINEAR,        ///< Constant rate
+    EASE_IN,       ///< Starts slowly (quadratic)
+    EASE_OUT,      ///< Ends slowly (quadratic)
+    EASE_IN_OUT    ///< Starts and ends slowly (smoothstep)
+};
+
+/**
+ * @brief Receives each new 8-bit PWM value of a pin (default: PwmRouter::write())
+ */
+using FadeOutput = std::function<void(int pin, uint8_t value)>;
+
+/**
+ * @brief Runs many LED fades from one timer task
+ *
+ * @note Thread-safe. The output is called with the engine's lock held, so
+ *       it must not call back into the engine.
+ */
+class FadeEngine {
+public:
+    /**
+     * @brief Process-wide engine writing through PwmRouter on TimerManager::getInstance()
+     */
+    static FadeEngine& getInstance();
+
+    /**
+     * @param output Where PWM values go (empty = PwmRouter)
+     * @param timers Timer driving the ticks (nullptr = TimerManager::getInstance())
+     */
+    explicit FadeEngine(FadeOutput output = FadeOutput(), TimerManager* timers = nullptr);
+
+    /**
+     * @brief Cancels the timer task; pins keep their last value
+     */
+    ~FadeEngine();
+
+    FadeEngine(const FadeEngine&) = delete;
+    FadeEngine& operator=(const FadeEngine&) = delete;
+
+    /**
+     * @brief Fade a pin from its current brightness to @p target
+     *
+     * A pin the engine has not driven yet starts from 0. A new fade on a
+     * pin replaces its running one, starting from where that one got to.
+     *
+     * @param pin GPIO pin number (0-27)
+     * @param target Perceptual brightness (0-255)
+     * @param durationMs Fade length (0 = jump on the next tick)
+     * @param curve Shape of the fade
+     * @throws InvalidPinError if the pin number is invalid
+     */
+    void fadeTo(int pin, uint8_t target, uint32_t durationMs, FadeCurve curve = FadeCurve::LINEAR);
+
+    /**
+     * @brief Set a pin's brightness now, ending any fade on it
+     * @throws InvalidPinError if the pin number is invalid
+     */
+    void set(int pin, uint8_t brightness);
+
+    /**
+     * @brief Stop a pin's fade where it is (the pin keeps its PWM value)
+     * @return false if the pin was not fading
+     */
+    bool stop(int pin);
+
+    /**
+     * @brief Whether a fade is running on a pin
+     */
+    bool isFading(int pin) const;
+
+    /**
+     * @brief Current perceptual brightness of a pin (0 if never driven)
+     */
+    uint8_t getBrightness(int pin) const;
+
+    /**
+     * @brief Number of pins currently fading
+     */
+    size_t getActiveCount() const;
+
+    /**
+     * @brief Rebuild the brightness table; applies from the next write
+     * @param gamma Exponent (> 0; 1.0 = linear)
+     * @return false if @p gamma is not positive
+     */
+    bool setGamma(double gamma);
+
+    /**
+     * @brief PWM value a brightness is written as
+     */
+    uint8_t gammaCorrect(uint8_t brightness) const;
+
+    /**
+     * @brief Interval between updates, from the next tick (0 is ignored)
+     */
+    void setTickUs(uint32_t tickUs);
+
+    /**
+     * @brief PWM frequency passed to PwmRouter for new pins (0 = any)
+     */
+    void setFrequency(int frequencyHz);
+
+    /**
+     * @brief Advance every fade to @p nowNs (CLOCK_MONOTONIC) and write changed outputs
+     *
+     * Called by the timer task; public for applications that drive fades
+     * from their own loop.
+     *
+     * @return true while any pin is still fading
+     */
+    bool step(int64_t nowNs);
+
+    /**
+     * @brief Helper: progress along a curve
+     * @param curve Fade shape
+     * @param progress Elapsed fraction of the fade, 0-65536
+     * @return Fraction of the brightness change done, 0-65536
+     */
+    static uint32_t curveProgress(FadeCurve curve, uint32_t progress);
+
+private:
+    struct Channel {
+        uint16_t level = 0;         ///< Brightness << 8, as of the last step
+        uint16_t from = 0;          ///< Level when the fade started
+        uint16_t to = 0;            ///< Target level
+        int64_t startNs = 0;
+        int64_t durationNs = 0;
+        FadeCurve curve = FadeCurve::LINEAR;
+        bool fading = false;
+        int output = -1;            ///< Last PWM value written (-1 = none)
+    };
+
+    /**
+     * @note Caller must hold mutex_
+     */
+    void write(int pin, Channel& channel);
+
+    /**
+     * @note Caller must hold mutex_
+     */
+    void ensureTimer();
+
+    /**
+     * @brief Timer task body: step, then cancel the task once idle
+     */
+    void onTick();
+
+    FadeOutput output_;
+    TimerManager* timers_;
+
+    mutable std::mutex mutex_;
+    std::map<int, Channel> channels_;
+    std::array<uint8_t, 256> gamma_;
+    size_t fading_ = 0;             ///< Channels with fading set
+    uint32_t tickUs_ = DEFAULT_FADE_TICK_US;
+    int frequencyHz_ = 0;
+    int timerId_ = -1;
+};
+
+} // namespace pipinpp
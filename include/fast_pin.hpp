@@ -0,0 +1,190 @@
+/**
+ * @file fast_pin.hpp
+ * @brief Header-only pin templated on backend and GPIO number for bit-bang loops
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Pin::write() is an out-of-line call that checks the request, picks the
+ * backend and then stores to a register or calls libgpiod. FastPin moves
+ * those decisions to compile time:
+ * - The GPIO number is a template argument, checked against the board
+ *   profile (BoardPin), so the register mask is a constant
+ * - With PinBackend::GPIOMEM the SET/CLR/LEV register addresses are
+ *   cached at construction, and set()/clear() inline to one store of a
+ *   constant to a cached address: no call, no branch
+ * - toggle() uses a shadow of the last written level, never a read
+ *
+ * Line ownership is Pin's: FastPin owns a Pin, which requests and
+ * configures the line through libgpiod and releases it on destruction.
+ * Unlike Pin, the GPIOMEM variant does not fall back to libgpiod (that
+ * would put a branch back in every write); construction throws instead.
+ * Its register stores bypass Pin::write(), so the GPIOMEM variant drops
+ * the line from the chip's OutputShadow and keeps its own level instead.
+ *
+ * Example usage:
+ * @code
+ * #include "fast_pin.hpp"
+ *
+ * pipinpp::StaticPin<17> clock;            // FastPin<PinBackend::GPIOMEM, 17>
+ * pipinpp::StaticPin<27> data;
+ * for (uint8_t bit = 0x80; bit; bit >>= 1) {
+ *     data.write(byte & bit);
+ *     clock.set();
+ *     clock.clear();
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "board.hpp"
+#include "chip_registry.hpp"
+#include "exceptions.hpp"
+#include "gpiomem.hpp"
+#include "pin.hpp"
+
+namespace pipinpp {
+
+/**
+ * @brief GPIO pin with the backend and pin number fixed at compile time
+ *
+ * @tparam Backend PinBackend::GPIOMEM (register stores) or PinBackend::LIBGPIOD
+ * @tparam N GPIO number, checked against @p Board
+ * @tparam Board Board profile (default: the build board)
+ *
+ * @note Not thread-safe (the toggle shadow is per object); like Pin, one
+ *       owner per line
+ */
+template <PinBackend Backend, int N, const BoardProfile& Board = BUILD_BOARD>
+class FastPin {
+    using Descriptor = BoardPin<N, Board>;
+    static_assert(Backend != PinBackend::GPIOMEM || N < 32,
+                  "register access covers GPIO bank 0 only");
+
+public:
+    static constexpr int number = N;
+    static constexpr uint32_t mask = Descriptor::mask;
+    static constexpr PinBackend backend = Backend;
+
+    /**
+     * @brief Request the line (output starts LOW)
+     * @throws GpioAccessError if the line cannot be requested, or for
+     *         GPIOMEM if the chip has no register mapping (or not the
+     *         board's layout)
+     */
+    explicit FastPin(PinDirection direction = PinDirection::OUTPUT,
+                     const std::string& chipname = Board.gpioChip)
+        : pin_(N, direction, chipname, Backend) {
+        bindRegisters(chipname);
+    }
+
+    /**
+     * @brief Request the line with pull resistors (see Pin(int, PinMode, ...))
+     */
+    explicit FastPin(PinMode mode, const std::string& chipname = Board.gpioChip)
+        : pin_(N, mode, chipname, Backend) {
+        bindRegisters(chipname);
+    }
+
+    FastPin(const FastPin&) = delete;
+    FastPin& operator=(const FastPin&) = delete;
+
+    /**
+     * @brief Drive HIGH
+     */
+    inline void set() {
+        if constexpr (Backend == PinBackend::GPIOMEM) {
+            *setReg_ = mask;
+        } else {
+            pin_.write(true);
+        }
+        level_ = true;
+    }
+
+    /**
+     * @brief Drive LOW
+     */
+    inline void clear() {
+        if constexpr (Backend == PinBackend::GPIOMEM) {
+            *clrReg_ = mask;
+        } else {
+            pin_.write(false);
+        }
+        level_ = false;
+    }
+
+    inline void write(bool value) {
+        if (value) {
+            set();
+        } else {
+            clear();
+        }
+    }
+
+    /**
+     * @brief Invert the last written level (no read-back)
+     */
+    inline void toggle() { write(!level_); }
+
+    /**
+     * @brief Current line level (1/0), -1 on error with LIBGPIOD
+     */
+    inline int read() const {
+        if constexpr (Backend == PinBackend::GPIOMEM) {
+            return (*levReg_ & mask) ? 1 : 0;
+        } else {
+            return pin_.read();
+        }
+    }
+
+    /**
+     * @brief Level last written with set()/clear()/write()/toggle()
+     */
+    bool getOutputState() const { return level_; }
+
+    /**
+     * @brief Underlying Pin, for edge events, debounce and shifting
+     */
+    Pin& pin() { return pin_; }
+
+private:
+    void bindRegisters(const std::string& chipname) {
+        if constexpr (Backend == PinBackend::GPIOMEM) {
+            GpioMem* regs = pin_.getRegisters();
+            if (!regs) {
+                throw GpioAccessError(chipname, "no register access for GPIO " + std::to_string(N) +
+                                      " (FastPin<GPIOMEM> does not fall back to libgpiod)");
+            }
+            if (Board.registerLayout != GpioMemLayout::NONE && regs->layout() != Board.registerLayout) {
+                throw GpioAccessError(chipname, std::string("register layout does not match ") + Board.name);
+            }
+            setReg_ = regs->setRegister();
+            clrReg_ = regs->clearRegister();
+            levReg_ = regs->levelRegister();
+            ChipRegistry::getInstance().acquire(chipname)->outputShadow().release(N);
+        } else {
+            (void)chipname;
+        }
+    }
+
+    mutable Pin pin_;                       ///< Owns the line request
+    volatile uint32_t* setReg_ = nullptr;
+    volatile uint32_t* clrReg_ = nullptr;
+    volatile uint32_t* levReg_ = nullptr;
+    bool level_ = false;
+};
+
+/**
+ * @brief Register-backed FastPin: set()/clear() are single stores
+ */
+template <int N, const BoardProfile& Board = BUILD_BOARD>
+using StaticPin = FastPin<PinBackend::GPIOMEM, N, Board>;
+
+} // namespace pipinpp
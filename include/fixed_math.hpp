@@ -0,0 +1,109 @@
+/**
+ * @file fixed_math.hpp
+ * @brief Divide-free fixed-point map() for converting sample blocks
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * map() divides by the input range for every value: a 64-bit integer
+ * divide that costs tens of cycles on a Cortex-A and cannot be
+ * vectorized. FixedMap does that divide once, in its constructor, turning
+ * the range ratio into a 32-bit multiplier and a shift. Converting a
+ * sample is then one widening multiply and a shift, and apply() runs over
+ * a block in a loop the compiler vectorizes.
+ *
+ * The multiplier is rounded up, so a result is never smaller in magnitude
+ * than the exact quotient and is identical to map() whenever
+ * |x - inMin| * |inMax - inMin| < 2^shift() (every 12-bit ADC range, for
+ * example). Outside that bound it can be one step larger than map().
+ *
+ * Example usage:
+ * @code
+ * constexpr pipinpp::FixedMap adcToMillivolts(0, 4095, 0, 3300);
+ * int16_t samples[256], millivolts[256];
+ * adc.readBlock(samples, 256);
+ * adcToMillivolts.apply(samples, millivolts, 256);
+ * static_assert(adcToMillivolts(4095) == 3300, "full scale");
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pipinpp {
+
+/**
+ * @brief map() with fixed ranges, precomputed as a multiply and shift
+ */
+class FixedMap {
+public:
+    /**
+     * @brief Largest shift tried (the multiplier stays within 32 bits)
+     */
+    static constexpr int MAX_SHIFT = 31;
+
+    /**
+     * @brief Precompute the mapping; an empty input range maps everything to @p outMin like map()
+     */
+    constexpr FixedMap(int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax)
+        : inMin_(inMin), outMin_(outMin) {
+        const int64_t inSpan = static_cast<int64_t>(inMax) - inMin;
+        const int64_t outSpan = static_cast<int64_t>(outMax) - outMin;
+        if (inSpan == 0) {
+            return;
+        }
+        negate_ = (inSpan < 0) != (outSpan < 0);
+        const uint64_t num = static_cast<uint64_t>(outSpan < 0 ? -outSpan : outSpan);
+        const uint64_t den = static_cast<uint64_t>(inSpan < 0 ? -inSpan : inSpan);
+        // Largest shift whose rounded-up multiplier still fits in 32 bits
+        for (int shift = MAX_SHIFT; shift >= 0; --shift) {
+            const uint64_t scale = ((num << shift) + den - 1) / den;
+            if (scale <= UINT32_MAX) {
+                scale_ = static_cast<uint32_t>(scale);
+                shift_ = shift;
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Map one value (results outside int32_t wrap)
+     */
+    constexpr int32_t operator()(int32_t x) const {
+        const int64_t offset = static_cast<int64_t>(x) - inMin_;
+        const uint64_t magnitude = static_cast<uint64_t>(offset < 0 ? -offset : offset);
+        const int64_t steps = static_cast<int64_t>((magnitude * scale_) >> shift_);
+        const bool negative = (offset < 0) != negate_;
+        return static_cast<int32_t>(outMin_ + (negative ? -steps : steps));
+    }
+
+    /**
+     * @brief Map a block of samples, saturating to int16_t (in == out is allowed)
+     */
+    void apply(const int16_t* in, int16_t* out, size_t count) const;
+
+    /**
+     * @brief Fractional bits of the multiplier
+     */
+    constexpr int shift() const { return shift_; }
+
+    /**
+     * @brief |outMax - outMin| / |inMax - inMin| scaled by 2^shift(), rounded up
+     */
+    constexpr uint32_t scale() const { return scale_; }
+
+private:
+    int32_t inMin_;
+    int32_t outMin_;
+    bool negate_ = false;    ///< Input and output ranges run in opposite directions
+    uint32_t scale_ = 0;
+    int shift_ = 0;
+};
+
+} // namespace pipinpp
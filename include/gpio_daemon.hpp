@@ -0,0 +1,189 @@
+/**
+ * @file gpio_daemon.hpp
+ * @brief Share GPIO lines between processes through the pipinppd daemon
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * The kernel grants each GPIO line to one request, so separate services
+ * (control, telemetry, UI) cannot use the same pin. GpioDaemon requests
+ * the lines once, in one process (tools/pipinppd), and GpioDaemonClient
+ * lets any number of other processes share them:
+ *
+ * - GpioDaemonClient::connect() installs a chip factory (see
+ *   ChipRegistry::setChipFactory()), so Pin, digitalWrite(),
+ *   InterruptManager and PWMManager run unchanged on the daemon's lines
+ * - line requests, reconfiguration and release go over a unix socket; a
+ *   client's lines are released when its socket closes, even on a crash
+ * - a line held by several clients is an output if any of them asked for
+ *   one (the others read its level), detects the union of their edges and
+ *   delivers each client only the edges it asked for; the last write wins
+ * - writes and reads go over a lock-free command ring in memory shared
+ *   with the daemon: setValue() returns once the command is queued, and
+ *   the daemon is only woken through an eventfd when it has gone to sleep
+ * - edge events are copied into a shared ring per request with the
+ *   kernel's timestamps; the request's fd() is an eventfd that
+ *   InterruptManager polls like the kernel's
+ *
+ * A queued write costs a few tens of nanoseconds and reaches the line
+ * within a few microseconds while the daemon is busy (it spins briefly
+ * before sleeping); a read waits for the daemon's reply.
+ *
+ * Example usage:
+ * @code
+ * // Once, as a user with access to /dev/gpiochip*:
+ * //   pipinppd --socket /run/pipinppd.sock --mode 0660
+ *
+ * pipinpp::GpioDaemonClient::getInstance().connect();
+ * pinMode(17, OUTPUT);
+ * digitalWrite(17, HIGH);                           // Through the daemon
+ * attachInterrupt(27, onEdge, RISING);              // Edges from the daemon
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "chip_registry.hpp"
+
+namespace pipinpp {
+
+/**
+ * @brief Socket the daemon listens on unless told otherwise
+ */
+constexpr const char* DEFAULT_DAEMON_SOCKET = "/run/pipinppd.sock";
+
+/**
+ * @brief Label of chips opened through the daemon (no /dev/gpiomem layout matches it)
+ */
+constexpr const char* DAEMON_CHIP_LABEL = "pipinppd";
+
+/**
+ * @brief How long the daemon polls the shared rings before sleeping (µs)
+ */
+constexpr uint32_t DAEMON_SPIN_US = 50;
+
+class DaemonSession;
+
+/**
+ * @brief Server side: owns the GPIO chips and serves clients on a unix socket
+ *
+ * One thread handles every client: control messages, command rings and
+ * the edge events of every line request.
+ *
+ * @note Thread-safe.
+ */
+class GpioDaemon {
+public:
+    /**
+     * @param socketPath Unix socket to listen on (replaced if it exists)
+     * @param chips Opens the chips clients ask for (nullptr = ChipRegistry::acquire())
+     */
+    explicit GpioDaemon(const std::string& socketPath = DEFAULT_DAEMON_SOCKET,
+                        ChipRegistry::ChipFactory chips = nullptr);
+
+    /**
+     * @brief Stops serving; every client's lines are released
+     */
+    ~GpioDaemon();
+
+    GpioDaemon(const GpioDaemon&) = delete;
+    GpioDaemon& operator=(const GpioDaemon&) = delete;
+
+    /**
+     * @brief Permission bits applied to the socket by start() (default 0660)
+     */
+    void setSocketMode(unsigned int mode);
+
+    /**
+     * @brief Bind the socket and start the service thread
+     * @return false if the socket cannot be created (errno set)
+     */
+    bool start();
+
+    /**
+     * @brief Stop the service thread, disconnect clients and remove the socket
+     */
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Number of connected clients
+     */
+    size_t getClientCount() const;
+
+    /**
+     * @brief Number of line requests held for clients
+     */
+    size_t getRequestCount() const;
+
+    const std::string& getSocketPath() const { return socketPath_; }
+
+private:
+    struct Impl;
+
+    void run();
+
+    std::string socketPath_;
+    ChipRegistry::ChipFactory chips_;
+    unsigned int socketMode_ = 0660;
+
+    std::unique_ptr<Impl> impl_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+/**
+ * @brief Client side: routes this process's chips through a GpioDaemon
+ *
+ * @note Thread-safe. Like SimulatedHardware::install(), only chips opened
+ *       after connect() are affected; open Pins keep their own lines.
+ */
+class GpioDaemonClient {
+public:
+    static GpioDaemonClient& getInstance();
+
+    /**
+     * @brief Connect to a daemon and route chips opened from now on to it
+     * @return false if the daemon cannot be reached (errno set)
+     */
+    bool connect(const std::string& socketPath = DEFAULT_DAEMON_SOCKET);
+
+    /**
+     * @brief Restore libgpiod (lines already requested stay valid until released)
+     */
+    void disconnect();
+
+    bool isConnected() const;
+
+    /**
+     * @brief Queued writes the daemon could not apply since connect()
+     *
+     * setValue() returns before the daemon acts on it, so a write to a line
+     * that was meanwhile reconfigured as an input fails only here.
+     */
+    uint64_t getFailedWrites() const;
+
+    GpioDaemonClient(const GpioDaemonClient&) = delete;
+    GpioDaemonClient& operator=(const GpioDaemonClient&) = delete;
+
+private:
+    GpioDaemonClient() = default;
+    ~GpioDaemonClient() = default;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<DaemonSession> session_;
+};
+
+} // namespace pipinpp
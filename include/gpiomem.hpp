@@ -0,0 +1,122 @@
+/**
+ * @file gpiomem.hpp
+ * @brief Memory-mapped GPIO register access through /dev/gpiomem
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * /dev/gpiomem exposes only the GPIO register block and is accessible to
+ * members of the 'gpio' group, so no root and no /dev/mem are required.
+ * Once a line has been requested (and therefore configured) through
+ * libgpiod, its level can be driven with a single store to the SET/CLR
+ * registers instead of an ioctl per write. This is the backend behind
+ * PinBackend::GPIOMEM.
+ *
+ * Supported register layouts:
+ * - BCM2835/BCM2836/BCM2837/BCM2711 (Pi 1-4, Zero): /dev/gpiomem,
+ *   GPSET0 (0x1C), GPCLR0 (0x28), GPLEV0 (0x34)
+ * - RP1 (Pi 5): /dev/gpiomem0, RIO0 block at 0x10000 with atomic
+ *   SET (+0x2000) / CLR (+0x3000) aliases and SYNC_IN (+0x08)
+ *
+ * Only bank 0 (GPIO 0-31) is handled; that covers every header pin.
+ *
+ * Example usage:
+ * @code
+ * auto* mem = pipinpp::GpioMem::forChipLabel("pinctrl-bcm2711");
+ * if (mem) {
+ *     mem->set(1u << 17);     // GPIO17 HIGH
+ *     mem->clear(1u << 17);   // GPIO17 LOW
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pipinpp {
+
+/**
+ * @brief GPIO register block layout
+ */
+enum class GpioMemLayout {
+    NONE,       ///< Unsupported controller
+    BCM2835,    ///< BCM2835/6/7 and BCM2711 (Pi 1-4, Zero, CM4)
+    RP1         ///< RP1 south bridge (Pi 5)
+};
+
+/**
+ * @brief Process-wide mapping of the GPIO register block
+ *
+ * Instances are created lazily (one per layout) and stay mapped for the
+ * lifetime of the process. The hot-path accessors are inline and do not
+ * lock; every register used is either write-1-to-act (SET/CLR) or
+ * read-only (LEV), so concurrent writers on different pins are safe.
+ */
+class GpioMem {
+public:
+    /**
+     * @brief Get the mapping that matches a libgpiod chip label
+     *
+     * @param chipLabel Label from gpiod_chip_info_get_label()
+     * @return Mapped instance, or nullptr if the controller is unsupported
+     *         or the device node cannot be opened/mapped
+     */
+    static GpioMem* forChipLabel(const std::string& chipLabel);
+
+    /**
+     * @brief Determine the register layout from a chip label
+     */
+    static GpioMemLayout layoutForLabel(const std::string& chipLabel);
+
+    /**
+     * @brief Register layout of this mapping
+     */
+    GpioMemLayout layout() const { return layout_; }
+
+    /**
+     * @brief Drive every pin in @p mask HIGH (bank 0)
+     */
+    inline void set(uint32_t mask) { *setReg_ = mask; }
+
+    /**
+     * @brief Drive every pin in @p mask LOW (bank 0)
+     */
+    inline void clear(uint32_t mask) { *clrReg_ = mask; }
+
+    /**
+     * @brief Current input level of GPIO 0-31
+     */
+    inline uint32_t levels() const { return *levReg_; }
+
+    /**
+     * @brief Register addresses, for callers that cache them (see FastPin)
+     */
+    volatile uint32_t* setRegister() const { return setReg_; }
+    volatile uint32_t* clearRegister() const { return clrReg_; }
+    volatile uint32_t* levelRegister() const { return levReg_; }
+
+    GpioMem(const GpioMem&) = delete;
+    GpioMem& operator=(const GpioMem&) = delete;
+
+private:
+    explicit GpioMem(GpioMemLayout layout);
+    ~GpioMem();
+
+    bool isMapped() const { return base_ != nullptr; }
+
+    GpioMemLayout layout_;
+    volatile uint32_t* base_;
+    size_t mapSize_;
+    volatile uint32_t* setReg_;
+    volatile uint32_t* clrReg_;
+    volatile uint32_t* levReg_;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,100 @@
+/**
+ * @file i2c_scan.hpp
+ * @brief Concurrent multi-bus I2C scan with an optional result cache
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * WireClass::scan() walks one bus. Boards with several buses (Pi 5 HAT
+ * and camera buses, I2C muxes, USB adapters) were scanned one address at
+ * a time, one bus after another, and from scratch on every run.
+ * scanI2cBuses():
+ * - Probes every /dev/i2c-N (or a chosen list) on its own thread, each
+ *   with its own file descriptor, so bus scans run in parallel
+ * - Uses WireClass::probe(), which picks quick-write or receive-byte per
+ *   address range and adapter capability, like i2cdetect
+ * - Optionally reuses results cached in a file, keyed by boot id, so a
+ *   hot restart does not re-probe the buses; the file is only trusted if
+ *   it is a regular file the caller owns and no one else can write
+ *
+ * Example usage:
+ * @code
+ * #include "i2c_scan.hpp"
+ *
+ * pipinpp::I2cScanOptions options;
+ * options.cachePath = pipinpp::i2cScanDefaultCachePath();
+ * for (const auto& bus : pipinpp::scanI2cBuses(options)) {
+ *     printf("bus %d: %zu device(s)\n", bus.bus, bus.devices.size());
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @brief Default cache file used by `pipinpp i2c scan --cached`
+ *
+ * In the caller's private runtime directory (see cache_file.hpp).
+ *
+ * @return The path, or an empty string if there is none (no caching)
+ */
+std::string i2cScanDefaultCachePath();
+
+/**
+ * @brief Default cache lifetime (seconds)
+ */
+constexpr int I2C_SCAN_DEFAULT_MAX_AGE_S = 300;
+
+/**
+ * @brief Devices found on one bus
+ */
+struct I2cBusScan {
+    int bus = -1;                   ///< Bus number (/dev/i2c-N)
+    bool ok = false;                ///< false if the bus could not be opened
+    std::vector<uint8_t> devices;   ///< Responding addresses, ascending
+};
+
+/**
+ * @brief What scanI2cBuses() scans and whether it may use the cache
+ */
+struct I2cScanOptions {
+    std::vector<int> buses;         ///< Buses to scan, empty for every /dev/i2c-N
+    std::string cachePath;          ///< Cache file, empty to disable caching
+    int maxAgeSeconds = I2C_SCAN_DEFAULT_MAX_AGE_S;  ///< Oldest usable cache
+    bool refresh = false;           ///< Ignore the cache (but rewrite it)
+};
+
+/**
+ * @brief Scan buses concurrently, one thread per bus
+ * @param options Buses and cache settings
+ * @return One entry per bus, in ascending bus order
+ */
+std::vector<I2cBusScan> scanI2cBuses(const I2cScanOptions& options = {});
+
+/**
+ * @brief Read cached scan results
+ * @param path Cache file
+ * @param maxAgeSeconds Reject caches older than this
+ * @param[out] results Cached results
+ * @return false if missing, stale, from another boot, malformed, or not a
+ *         regular file owned by the caller and writable only by them
+ */
+bool loadI2cScanCache(const std::string& path, int maxAgeSeconds, std::vector<I2cBusScan>& results);
+
+/**
+ * @brief Write scan results to a cache file (atomically replaced)
+ * @return true on success
+ */
+bool saveI2cScanCache(const std::string& path, const std::vector<I2cBusScan>& results);
+
+} // namespace pipinpp
@@ -0,0 +1,185 @@
+/**
+ * @file inplace_function.hpp
+ * @brief Fixed-capacity callable wrapper that never allocates
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * std::function heap-allocates any callable larger than its small internal
+ * buffer (two pointers in libstdc++), and every call goes through its
+ * manager indirection. InplaceFunction stores the callable in a buffer of
+ * fixed size inside the object itself, so an interrupt handler's callback
+ * lives in the same allocation as the rest of the handler state, attaching
+ * never allocates, and a call is one indirect jump.
+ *
+ * A callable that does not fit is rejected at compile time; wrap it in a
+ * std::function (which fits) or capture a pointer to the state instead.
+ *
+ * Example usage:
+ * @code
+ * pipinpp::InplaceFunction<void(), 48> onEdge = [&counter, pin] { counter.bump(pin); };
+ * onEdge();
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pipinpp {
+
+template <typename Signature, size_t Capacity>
+class InplaceFunction;
+
+/**
+ * @brief Copyable callable stored inline in @p Capacity bytes
+ *
+ * @tparam Capacity Bytes available for the callable (max_align_t aligned)
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+    InplaceFunction() noexcept = default;
+    InplaceFunction(std::nullptr_t) noexcept {}
+
+    /**
+     * @brief Store a copy of @p callable (a null function pointer or empty std::function leaves this empty)
+     */
+    template <typename F, typename Callable = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same<Callable, InplaceFunction>::value &&
+                                          std::is_invocable_r<R, Callable&, Args...>::value>>
+    InplaceFunction(F&& callable) {
+        static_assert(sizeof(Callable) <= Capacity,
+                      "Callable too large for InplaceFunction: capture less or wrap it in std::function");
+        static_assert(alignof(Callable) <= alignof(Storage), "Callable is over-aligned for InplaceFunction");
+        static_assert(std::is_copy_constructible<Callable>::value, "InplaceFunction needs a copyable callable");
+        if (isNull(callable)) {
+            return;
+        }
+        ::new (static_cast<void*>(&storage_)) Callable(std::forward<F>(callable));
+        ops_ = &OpsFor<Callable>::table;
+    }
+
+    InplaceFunction(const InplaceFunction& other) : ops_(other.ops_) {
+        if (ops_) {
+            ops_->copy(&storage_, &other.storage_);
+        }
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept : ops_(other.ops_) {
+        if (ops_) {
+            ops_->move(&storage_, &other.storage_);
+            other.reset();
+        }
+    }
+
+    InplaceFunction& operator=(const InplaceFunction& other) {
+        if (this != &other) {
+            InplaceFunction copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops_) {
+                other.ops_->move(&storage_, &other.storage_);
+                ops_ = other.ops_;
+                other.reset();
+            }
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    ~InplaceFunction() { reset(); }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    /**
+     * @throws std::bad_function_call if empty
+     */
+    R operator()(Args... args) const {
+        if (!ops_) {
+            throw std::bad_function_call();
+        }
+        return ops_->invoke(const_cast<void*>(static_cast<const void*>(&storage_)), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Bytes available for the stored callable
+     */
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    using Storage = std::aligned_storage_t<Capacity == 0 ? 1 : Capacity, alignof(std::max_align_t)>;
+
+    struct Ops {
+        R (*invoke)(void* callable, Args&&... args);
+        void (*copy)(void* to, const void* from);
+        void (*move)(void* to, void* from) noexcept;
+        void (*destroy)(void* callable) noexcept;
+    };
+
+    template <typename Callable>
+    struct OpsFor {
+        static R invoke(void* callable, Args&&... args) {
+            return (*static_cast<Callable*>(callable))(std::forward<Args>(args)...);
+        }
+        static void copy(void* to, const void* from) {
+            ::new (to) Callable(*static_cast<const Callable*>(from));
+        }
+        static void move(void* to, void* from) noexcept {
+            ::new (to) Callable(std::move(*static_cast<Callable*>(from)));
+        }
+        static void destroy(void* callable) noexcept {
+            static_cast<Callable*>(callable)->~Callable();
+        }
+        static constexpr Ops table = {&invoke, &copy, &move, &destroy};
+    };
+
+    template <typename F>
+    static bool isNull(const F& callable) noexcept {
+        if constexpr (std::is_pointer<F>::value || std::is_member_pointer<F>::value) {
+            return callable == nullptr;
+        } else {
+            return isEmptyFunction(callable);
+        }
+    }
+
+    template <typename Signature>
+    static bool isEmptyFunction(const std::function<Signature>& callable) noexcept {
+        return !callable;
+    }
+
+    template <typename F>
+    static bool isEmptyFunction(const F&) noexcept {
+        return false;
+    }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    Storage storage_;
+    const Ops* ops_ = nullptr;
+};
+
+} // namespace pipinpp
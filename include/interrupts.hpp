@@ -35,6 +35,9 @@
  * - Thread-safe callback invocation
  * - Multiple interrupts on different pins simultaneously
  * - Efficient event monitoring with background thread
+ * - Batched delivery with kernel timestamps (attachInterruptBatch)
+ * - Optional single line request per chip for many inputs (setMergeRequests)
+ * - Continuous period/frequency/duty statistics per pin (FrequencyCounter)
  * - Automatic cleanup on shutdown
  *
  * Example usage:
@@ -69,9 +72,17 @@
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <map>
 #include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "backend.hpp"
+#include "chip_registry.hpp"
+#include "inplace_function.hpp"
+#include "spsc_ring.hpp"
 
 /**
  * @brief Interrupt trigger modes (Arduino-inspired)
@@ -82,33 +93,175 @@ enum class InterruptMode {
     CHANGE    ///< Trigger on any edge (both rising and falling)
 };
 
+/**
+ * @brief Bytes an interrupt callback may capture (a std::function fits)
+ */
+constexpr size_t INTERRUPT_CALLBACK_CAPACITY = 6 * sizeof(void*);
+
 /**
  * @brief Callback function signature for interrupts
  * 
  * User callbacks should be fast and non-blocking. Heavy processing
  * should be deferred to avoid blocking other interrupts.
+ *
+ * Stored inline in the pin's handler, so attaching never allocates and
+ * dispatch is a single indirect call. Function pointers, lambdas and
+ * std::function objects all convert; a lambda capturing more than
+ * INTERRUPT_CALLBACK_CAPACITY bytes fails to compile.
+ */
+using InterruptCallback = pipinpp::InplaceFunction<void(), INTERRUPT_CALLBACK_CAPACITY>;
+
+/**
+ * @brief Direction of a captured edge
+ */
+enum class EdgeType {
+    RISING,   ///< LOW to HIGH transition
+    FALLING   ///< HIGH to LOW transition
+};
+
+/**
+ * @brief One edge event as reported by the kernel
+ *
+ * Timestamps come from gpiod_edge_event_get_timestamp_ns() and use
+ * CLOCK_MONOTONIC unless the line was configured otherwise, so the
+ * interval between two edges is exact regardless of dispatch latency.
+ */
+struct EdgeEvent {
+    int pin;                      ///< GPIO pin (line offset) that fired
+    EdgeType type;                ///< Rising or falling edge
+    uint64_t timestampNs;         ///< Kernel timestamp in nanoseconds
+    unsigned long globalSeqno;    ///< Sequence number across all lines of the request
+    unsigned long lineSeqno;      ///< Sequence number on this line
+};
+
+/**
+ * @brief Read-only view of a batch of edge events (C++17 stand-in for std::span)
+ */
+class EdgeEventSpan {
+public:
+    EdgeEventSpan(const EdgeEvent* data, size_t size) : data_(data), size_(size) {}
+
+    const EdgeEvent* begin() const { return data_; }
+    const EdgeEvent* end() const { return data_ + size_; }
+    const EdgeEvent& operator[](size_t index) const { return data_[index]; }
+    const EdgeEvent* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    const EdgeEvent* data_;
+    size_t size_;
+};
+
+/**
+ * @brief Callback receiving every event read in one batch
+ *
+ * Invoked once per read from the kernel with up to the configured buffer
+ * size of events, oldest first. The span is only valid during the call.
+ */
+using EdgeBatchCallback = pipinpp::InplaceFunction<void(EdgeEventSpan events), INTERRUPT_CALLBACK_CAPACITY>;
+
+/**
+ * @brief Default number of edge events buffered per pin
+ */
+constexpr size_t DEFAULT_EVENT_BUFFER_SIZE = 16;
+
+/**
+ * @brief Upper bound on kernel-side edge event buffering for one request
+ */
+constexpr size_t MAX_EVENT_BUFFER_SIZE = 1024;
+
+/**
+ * @brief Where a pin's interrupt callbacks run
+ */
+enum class CallbackDispatch {
+    INLINE,     ///< On the monitor thread (default, lowest latency)
+    DEDICATED,  ///< On a thread of the pin's own ("pipinpp-irqcb<pin>")
+    POOL        ///< On the shared callback pool ("pipinpp-irqcb"), in order per pin
+};
+
+/**
+ * @brief Default events a queued pin can hold before new edges are dropped
+ */
+constexpr size_t DEFAULT_CALLBACK_QUEUE_DEPTH = 256;
+
+/**
+ * @brief Queue statistics of a pin with DEDICATED or POOL dispatch
  */
-using InterruptCallback = std::function<void()>;
+struct CallbackQueueStats {
+    size_t depth = 0;           ///< Events waiting for the callback now
+    size_t capacity = 0;        ///< Events the queue holds
+    size_t maxDepth = 0;        ///< Deepest the queue has been
+    uint64_t delivered = 0;     ///< Events passed to the callback
+    uint64_t dropped = 0;       ///< Edges lost because the queue was full
+};
+
+struct EdgeRequest;
+class CallbackExecutor;
 
 /**
  * @brief Internal structure for managing a single interrupt
  */
 struct InterruptHandler {
     int pin;                              ///< GPIO pin number
-    InterruptCallback callback;           ///< User callback function
+    InterruptCallback callback;           ///< User callback function (one call per event)
+    EdgeBatchCallback batch_callback;     ///< User batch callback (one call per read)
+    CallbackDispatch dispatch;            ///< Where the callbacks run
+    std::unique_ptr<pipinpp::SpscRing<EdgeEvent>> queue;   ///< Monitor to worker events (queued dispatch)
+    std::vector<EdgeEvent> worker_events; ///< Worker-side batch storage (queued dispatch)
+    std::shared_ptr<CallbackExecutor> executor;            ///< Runs the callbacks (queued dispatch)
+    std::atomic<bool> scheduled;          ///< Waiting for or running on a worker
+    std::atomic<size_t> max_depth;        ///< Deepest queue seen by the monitor thread
+    std::atomic<uint64_t> delivered;      ///< Events passed to the callback by workers
+    std::atomic<uint64_t> dropped;        ///< Edges dropped on a full queue
     InterruptMode mode;                   ///< Edge detection mode
-    gpiod_chip* chip;                     ///< GPIO chip handle
-    gpiod_line_request* request;          ///< Line request for this pin
-    gpiod_edge_event_buffer* event_buffer; ///< Buffer for reading edge events
+    size_t buffer_size;                   ///< Kernel and user-space event buffer capacity
+    std::vector<EdgeEvent> events;        ///< Preallocated batch storage
+    size_t pending;                       ///< Events collected for the current batch
+    EdgeRequest* owner;                   ///< Line request this pin belongs to
     std::atomic<bool> active;             ///< Whether this handler is active
+    uint32_t debounce_us;                 ///< Debounce period from InterruptManager::setDebounce()
+    std::atomic<uint32_t> software_debounce_us; ///< Non-zero when the kernel rejected debounce: filter in dispatch
+    uint64_t last_edge_ns;                ///< Last edge passed by the software filter (monitor thread only)
+    unsigned long last_line_seqno;        ///< Kernel line sequence number of the last edge (monitor thread only)
+    std::atomic<uint64_t> lost;           ///< Edges the kernel dropped on a full buffer (sequence number gaps)
     
     InterruptHandler() 
-        : pin(0), mode(InterruptMode::CHANGE), chip(nullptr), 
-          request(nullptr), event_buffer(nullptr), active(false) {}
-          
+        : pin(0), dispatch(CallbackDispatch::INLINE), scheduled(false), max_depth(0), delivered(0),
+          dropped(0), mode(InterruptMode::CHANGE), buffer_size(DEFAULT_EVENT_BUFFER_SIZE), 
+          pending(0), owner(nullptr), active(false), debounce_us(0), software_debounce_us(0),
+          last_edge_ns(0), last_line_seqno(0), lost(0) {}
+
+    /**
+     * @brief Waits for a queued callback in progress (not when called from it)
+     */
     ~InterruptHandler();
 };
 
+/**
+ * @brief Internal structure for one edge-detecting line request
+ *
+ * Holds a single line, or every merged line of a chip when
+ * InterruptManager::setMergeRequests() is enabled. Events are routed to
+ * their handler by line offset.
+ */
+struct EdgeRequest {
+    std::shared_ptr<pipinpp::GpioChip> chip;       ///< Shared GPIO chip handle
+    std::unique_ptr<pipinpp::LineRequest> request; ///< Line request for all member pins
+    std::vector<pipinpp::LineEvent> event_buffer;  ///< Buffer for reading edge events
+    std::vector<InterruptHandler*> members;        ///< Handlers served by this request
+    std::vector<InterruptHandler*> by_offset;      ///< Line offset to handler lookup
+    std::vector<std::unique_ptr<InterruptHandler>> detached; ///< Handlers detached from a callback
+    bool merged;                                   ///< Shared by all pins of the chip
+    bool grow;                                     ///< Lost events: enlarge the buffers (monitor thread only)
+    std::atomic<bool> active;                      ///< Whether this request is dispatched
+    
+    EdgeRequest() 
+        : chip(), request(), event_buffer(), merged(false), grow(false), active(false) {}
+          
+    ~EdgeRequest();
+};
+
 /**
  * @brief Manages GPIO interrupts with a background monitoring thread
  * 
@@ -142,6 +295,34 @@ public:
      */
     void attachInterrupt(int pin, InterruptCallback callback, InterruptMode mode, 
                         const std::string& chipname = "gpiochip0");
+
+    /**
+     * @brief Attach a batch interrupt handler with kernel timestamps
+     *
+     * Every read from the kernel is delivered in a single callback as an
+     * EdgeEventSpan carrying timestamp, edge type and sequence numbers.
+     * Use this for encoders, frequency counters and other high-rate inputs.
+     *
+     * @param pin GPIO pin number (0-27 for Raspberry Pi)
+     * @param callback Function receiving each batch of events
+     * @param mode Edge detection mode (RISING, FALLING, or CHANGE)
+     * @param bufferSize Events buffered by the kernel and read per batch (1-1024)
+     * @param chipname GPIO chip name (default: "gpiochip0")
+     * @throws InvalidPinError if pin number, callback or buffer size is invalid
+     * @throws GpioAccessError if unable to configure interrupt
+     *
+     * @code
+     * InterruptManager::getInstance().attachInterruptBatch(17,
+     *     [](EdgeEventSpan events) {
+     *         for (const EdgeEvent& e : events) {
+     *             record(e.timestampNs, e.type == EdgeType::RISING);
+     *         }
+     *     }, InterruptMode::CHANGE, 64);
+     * @endcode
+     */
+    void attachInterruptBatch(int pin, EdgeBatchCallback callback, InterruptMode mode,
+                              size_t bufferSize = DEFAULT_EVENT_BUFFER_SIZE,
+                              const std::string& chipname = "gpiochip0");
     
     /**
      * @brief Detach an interrupt handler from a GPIO pin
@@ -167,6 +348,149 @@ public:
      * @return Number of pins with attached interrupt handlers
      */
     size_t getActiveCount() const;
+
+    /**
+     * @brief Share one line request per chip between all interrupt pins
+     *
+     * When enabled, interrupts attached afterwards on the same chip are
+     * merged into a single multi-line gpiod_line_request: one fd, one
+     * kernel event buffer and one read drains every pin. Events are
+     * demultiplexed by line offset before the callbacks run.
+     *
+     * libgpiod cannot add lines to an existing request, so attaching or
+     * detaching a merged pin re-requests the remaining lines. Edges on the
+     * other pins of that chip may be missed during the re-request
+     * (typically well under a millisecond). Merged pins cannot be attached
+     * from inside an interrupt callback; detaching one from a callback
+     * stops its dispatch immediately and releases the line on the next
+     * reconfiguration of that chip.
+     *
+     * Pins attached before the change keep their current request.
+     *
+     * @param enable true to merge, false for one request per pin (default)
+     */
+    void setMergeRequests(bool enable);
+
+    /**
+     * @brief Whether new interrupts are merged into one request per chip
+     */
+    bool getMergeRequests() const;
+
+    /**
+     * @brief Debounce a pin's interrupt
+     *
+     * The kernel debounces the line (a level must be stable for
+     * @p periodUs before its edge is reported), so bounce edges never wake
+     * the monitor thread. If the kernel rejects the setting, the
+     * dispatcher drops edges that arrive within @p periodUs of the last
+     * accepted edge by kernel timestamp, before any callback runs.
+     *
+     * The period is kept per pin: it applies to an interrupt attached now
+     * and to later attachInterrupt() / attachInterruptBatch() calls.
+     *
+     * @param pin GPIO pin number (0-27 for Raspberry Pi)
+     * @param periodUs Debounce period in microseconds, 0 to disable
+     * @throws InvalidPinError if pin number is invalid
+     * @throws GpioAccessError if an attached line cannot be reconfigured
+     *
+     * @code
+     * auto& interrupts = InterruptManager::getInstance();
+     * interrupts.setDebounce(17, 5000);        // 5 ms for a push button
+     * interrupts.attachInterrupt(17, onPress, InterruptMode::FALLING);
+     * @endcode
+     */
+    void setDebounce(int pin, uint32_t periodUs);
+
+    /**
+     * @brief Debounce period of a pin in microseconds (0 if none)
+     */
+    uint32_t getDebounce(int pin) const;
+
+    /**
+     * @brief Whether an attached pin is debounced by the timestamp filter
+     *        rather than the kernel
+     */
+    bool isSoftwareDebounce(int pin) const;
+
+    /**
+     * @brief Edges of an attached pin that the kernel dropped
+     *
+     * The kernel buffers a limited number of edges per request (the
+     * bufferSize of attachInterruptBatch(), 16 for attachInterrupt()) and
+     * overwrites the oldest when a burst outruns the monitor thread. Every
+     * edge carries a per-line sequence number, so each gap is counted here
+     * (and in the interrupt_lost_events metric).
+     *
+     * @return Lost edges since attach, 0 if the pin is not attached
+     */
+    uint64_t getLostEvents(int pin) const;
+
+    /**
+     * @brief Grow a request's event buffer when it loses edges
+     *
+     * When enabled, a request that loses edges is re-requested with twice
+     * the buffer (up to @p maxSize), kernel and user space alike, after the
+     * current dispatch. The re-request itself may miss edges for well under
+     * a millisecond; bursts of the size seen so far are then kept whole.
+     * Off by default.
+     *
+     * @param enable true to grow buffers on loss
+     * @param maxSize Largest buffer to grow to (at most MAX_EVENT_BUFFER_SIZE)
+     */
+    void setAdaptiveEventBuffer(bool enable, size_t maxSize = MAX_EVENT_BUFFER_SIZE);
+
+    /**
+     * @brief Kernel event buffer of an attached pin's request (0 if not attached)
+     */
+    size_t getEventBufferSize(int pin) const;
+
+    /**
+     * @brief Choose where a pin's callbacks run
+     *
+     * INLINE callbacks run on the monitor thread, so a slow one (logging,
+     * an I2C read) delays the edges of every other pin and can overflow
+     * their kernel buffers. With DEDICATED or POOL the monitor thread only
+     * copies each edge into the pin's queue and wakes a worker; edge
+     * reading never waits for user code. Callbacks of one pin always run
+     * one at a time, in edge order; batch callbacks receive what was
+     * queued since their last call (at most the pin's buffer size).
+     *
+     * A full queue drops new edges and counts them (getCallbackQueueStats(),
+     * and the interrupt_queue_drops metric). The setting is kept per pin
+     * and applies from the next attachInterrupt() / attachInterruptBatch().
+     *
+     * @param pin GPIO pin number (0-27 for Raspberry Pi)
+     * @param dispatch INLINE, DEDICATED or POOL
+     * @param queueDepth Events buffered between monitor and worker (rounded up to a power of two)
+     * @throws InvalidPinError if pin number or queue depth is invalid
+     *
+     * @code
+     * auto& interrupts = InterruptManager::getInstance();
+     * interrupts.setCallbackDispatch(4, CallbackDispatch::DEDICATED);
+     * interrupts.attachInterrupt(4, [] { logSensor(Wire.read()); }, InterruptMode::FALLING);
+     * @endcode
+     */
+    void setCallbackDispatch(int pin, CallbackDispatch dispatch,
+                             size_t queueDepth = DEFAULT_CALLBACK_QUEUE_DEPTH);
+
+    /**
+     * @brief Dispatch policy set for a pin (INLINE if none)
+     */
+    CallbackDispatch getCallbackDispatch(int pin) const;
+
+    /**
+     * @brief Number of POOL worker threads (default 2)
+     *
+     * @return false if the pool is already running (it is started by the
+     *         first POOL attach and keeps its size)
+     */
+    bool setCallbackPoolThreads(size_t threads);
+
+    /**
+     * @brief Queue statistics of an attached DEDICATED or POOL pin
+     * @return false if the pin is not attached or dispatches inline
+     */
+    bool getCallbackQueueStats(int pin, CallbackQueueStats& out) const;
     
     // Prevent copying
     InterruptManager(const InterruptManager&) = delete;
@@ -179,10 +503,30 @@ private:
     /**
      * @brief Background thread function that monitors all interrupt sources
      * 
-     * Uses poll() to efficiently wait for edge events on multiple pins.
-     * Dispatches callbacks when events occur.
+     * Waits on a persistent epoll set (one entry per line request plus the wakeup
+     * eventfd) without timeouts or per-iteration allocation, and dispatches
+     * callbacks when events occur.
      */
     void monitorThread();
+
+    /**
+     * @brief Read pending edge events for one request and invoke the callbacks
+     *
+     * Events are routed to handlers by line offset. Per-event callbacks run
+     * in kernel order; batch handlers receive their events once the whole
+     * read has been routed.
+     */
+    void dispatchEvents(EdgeRequest& request);
+
+    /**
+     * @brief Re-request every request marked for growth with larger buffers (monitor thread)
+     */
+    void growRequests();
+
+    /**
+     * @brief Signal the wakeup eventfd
+     */
+    void wakeMonitor();
     
     /**
      * @brief Start the monitoring thread if not already running
@@ -198,11 +542,246 @@ private:
      * @brief Convert InterruptMode to libgpiod edge type
      */
     static gpiod_line_edge modeToEdge(InterruptMode mode);
+
+    /**
+     * @brief Attach a prepared handler, merging it into its chip's request if enabled
+     * @note Caller must hold lock on mutex_
+     */
+    void registerHandler(std::unique_ptr<InterruptHandler> handler, const std::string& chipname,
+                         std::unique_lock<std::mutex>& lock);
+
+    /**
+     * @brief Settings for every member line (edge mode and kernel debounce)
+     */
+    static std::vector<pipinpp::LineSettings> buildLineSettings(const std::vector<InterruptHandler*>& members);
+
+    /**
+     * @brief Request every member line and build the offset lookup
+     * @throws GpioAccessError if the lines cannot be requested
+     */
+    std::unique_ptr<EdgeRequest> createRequest(std::shared_ptr<pipinpp::GpioChip> chip,
+                                               const std::vector<InterruptHandler*>& members,
+                                               bool merged);
+
+    /**
+     * @brief Add a request to the epoll set and the request list
+     * @note Caller must hold mutex_
+     */
+    void addRequest(std::unique_ptr<EdgeRequest> request);
+
+    /**
+     * @brief Remove a request from the epoll set and wait until the monitor
+     *        thread can no longer be using it
+     * @return Ownership of the request, or nullptr if it was retired to the
+     *         monitor thread (called from inside a callback)
+     * @note Caller must hold lock on mutex_; it is released while waiting
+     */
+    std::unique_ptr<EdgeRequest> removeRequest(EdgeRequest* request,
+                                               std::unique_lock<std::mutex>& lock);
+
+    /**
+     * @brief Whether the calling thread is the monitor thread
+     */
+    bool onMonitorThread() const;
+
+    /**
+     * @brief Validate pin number and reject pins that already have a handler
+     * @note Caller must hold mutex_
+     */
+    void checkAttachable(int pin) const;
+
+    /**
+     * @brief Give a new handler its queue and executor if its pin is not INLINE
+     * @note Caller must hold mutex_
+     */
+    void setupDispatch(InterruptHandler& handler);
+
+    /**
+     * @brief Free a detached handler without blocking the calling worker or monitor thread
+     */
+    static void releaseHandler(std::unique_ptr<InterruptHandler> handler);
     
     std::map<int, std::unique_ptr<InterruptHandler>> handlers_; ///< Active interrupt handlers
-    mutable std::mutex mutex_;                                   ///< Protects handlers_ map
+    std::vector<std::unique_ptr<EdgeRequest>> requests_;         ///< Line requests in the epoll set
+    std::map<std::string, EdgeRequest*> merged_;                 ///< Merged request per chip name
+    std::map<int, uint32_t> debounce_us_;                        ///< Debounce period per pin, kept across attach/detach
+    std::map<int, std::pair<CallbackDispatch, size_t>> dispatch_; ///< Dispatch policy and queue depth per pin, kept across attach/detach
+    std::shared_ptr<CallbackExecutor> pool_;                     ///< Shared POOL workers, started on first use
+    size_t pool_threads_;                                        ///< Worker count for pool_
+    std::atomic<size_t> adaptive_max_;                           ///< Largest grown buffer, 0 when adaptive sizing is off
+    std::vector<EdgeRequest*> grow_;                             ///< Requests to grow after this dispatch (monitor thread only)
+    std::vector<std::unique_ptr<EdgeRequest>> retired_;          ///< Requests removed from a callback, freed after dispatch
+    mutable std::mutex mutex_;                                   ///< Protects handlers_, requests_, merged_, debounce_us_, dispatch_, pool_, retired_ and epoch_
+    std::condition_variable epoch_cv_;                           ///< Signals completed monitor iterations
+    std::condition_variable reconfig_cv_;                        ///< Signals the end of a merged re-request
+    bool reconfiguring_;                                         ///< A merged request is being rebuilt
+    bool merge_requests_;                                        ///< Merge new pins into one request per chip
     std::thread monitor_thread_;                                 ///< Background monitoring thread
     std::atomic<bool> running_;                                  ///< Whether monitoring thread is running
     std::atomic<bool> shutdown_requested_;                       ///< Shutdown flag
-    int wakeup_pipe_[2];                                        ///< Pipe for waking up poll()
+    int epoll_fd_;                                               ///< Persistent epoll set
+    int wakeup_fd_;                                              ///< eventfd for waking up epoll_wait()
+    uint64_t epoch_;                                             ///< Completed monitor iterations
+
+    static constexpr int MAX_EPOLL_EVENTS = 32;                  ///< Ready fds handled per epoll_wait()
+};
+
+/**
+ * @brief Number of buckets in FrequencySnapshot::jitter
+ */
+constexpr size_t FREQUENCY_JITTER_BUCKETS = 16;
+
+/**
+ * @brief Running statistics for one FrequencyCounter pin
+ *
+ * A cycle is measured rising edge to rising edge. Jitter bucket 0 counts
+ * cycles within 1 µs of the running average period, bucket i (1-14)
+ * deviations in [2^(i-1), 2^i) µs, and the last bucket everything from
+ * 16.384 ms up.
+ */
+struct FrequencySnapshot {
+    uint64_t edges = 0;              ///< Edges seen
+    uint64_t cycles = 0;             ///< Complete periods measured
+    uint64_t missedEdges = 0;        ///< Edges lost by the kernel (line sequence number gaps)
+    uint64_t periodNs = 0;           ///< Latest period
+    uint64_t averagePeriodNs = 0;    ///< Moving average period (each cycle weighs 1/16)
+    uint64_t minPeriodNs = 0;        ///< Shortest period since the last reset
+    uint64_t maxPeriodNs = 0;        ///< Longest period since the last reset
+    uint64_t highNs = 0;             ///< High time of the latest cycle
+    double frequencyHz = 0.0;        ///< 1 / averagePeriodNs, 0 before the first cycle
+    double dutyCycle = 0.0;          ///< Latest high time as a percentage of its period
+    uint64_t lastEdgeNs = 0;         ///< Kernel timestamp of the latest edge
+    uint64_t ageNs = 0;              ///< Time since lastEdgeNs when read (a stopped fan keeps its last frequency)
+    uint64_t jitter[FREQUENCY_JITTER_BUCKETS] = {}; ///< Histogram of |period - average|
+};
+
+/**
+ * @brief Edge stream to FrequencySnapshot accumulator
+ *
+ * Used by FrequencyCounter on the interrupt monitor thread; usable on its
+ * own with recorded events.
+ */
+class FrequencyTracker {
+public:
+    /**
+     * @brief Account for one edge (events must be in kernel order)
+     */
+    void onEdge(const EdgeEvent& event);
+
+    /**
+     * @brief Clear all statistics
+     */
+    void reset();
+
+    /**
+     * @brief Current statistics (ageNs is left at 0)
+     */
+    const FrequencySnapshot& stats() const { return stats_; }
+
+    /**
+     * @brief Histogram bucket for a period deviation
+     */
+    static size_t jitterBucket(uint64_t deviationNs);
+
+private:
+    FrequencySnapshot stats_;
+    bool have_rise_ = false;
+    bool have_fall_ = false;
+    bool have_seqno_ = false;
+    uint64_t last_rise_ns_ = 0;
+    uint64_t last_fall_ns_ = 0;
+    unsigned long last_seqno_ = 0;
+};
+
+/**
+ * @brief Continuous frequency / duty-cycle measurement on many pins
+ *
+ * Each pin gets a CHANGE batch interrupt whose events are folded into a
+ * FrequencyTracker on the monitor thread, with no user callback involved.
+ * Statistics are published once per batch through a per-pin seqlock, so
+ * read() never blocks the monitor thread and never takes a lock.
+ *
+ * @code
+ * auto& counter = FrequencyCounter::getInstance();
+ * for (int pin : {5, 6, 13, 19}) {
+ *     counter.addPin(pin);                 // Fan tachometers
+ * }
+ * FrequencySnapshot fan;
+ * if (counter.read(5, fan) && fan.ageNs < 1000000000) {
+ *     double rpm = fan.frequencyHz * 30;   // Two pulses per revolution
+ * }
+ * @endcode
+ *
+ * @note This is a singleton class - only one instance exists.
+ */
+class FrequencyCounter {
+public:
+    /**
+     * @brief Get the singleton instance
+     */
+    static FrequencyCounter& getInstance();
+
+    /**
+     * @brief Start counting on a pin
+     * @param pin GPIO pin number (0-27)
+     * @param bufferSize Kernel event buffer (raise for kHz-rate inputs)
+     * @param chipname GPIO chip name
+     * @throws InvalidPinError if the pin or buffer size is invalid
+     * @throws GpioAccessError if the pin already has an interrupt or edge detection fails
+     */
+    void addPin(int pin, size_t bufferSize = 64, const std::string& chipname = "gpiochip0");
+
+    /**
+     * @brief Stop counting on a pin
+     * @return false if the pin was not being counted
+     */
+    bool removePin(int pin);
+
+    /**
+     * @brief Whether a pin is being counted
+     */
+    bool isCounting(int pin) const;
+
+    /**
+     * @brief Lock-free copy of a pin's statistics
+     * @return false if the pin is not being counted
+     */
+    bool read(int pin, FrequencySnapshot& out) const;
+
+    /**
+     * @brief Clear a pin's statistics (counting continues)
+     */
+    void reset(int pin);
+
+    FrequencyCounter(const FrequencyCounter&) = delete;
+    FrequencyCounter& operator=(const FrequencyCounter&) = delete;
+
+private:
+    FrequencyCounter();
+    ~FrequencyCounter();
+
+    static constexpr int MAX_PINS = 28;
+    static constexpr size_t SNAPSHOT_WORDS = (sizeof(FrequencySnapshot) + 7) / 8;
+
+    struct Slot {
+        std::atomic<bool> active{false};
+        std::atomic<uint32_t> seq{0};
+        std::atomic<uint64_t> words[SNAPSHOT_WORDS];
+        std::mutex writer_mutex;         ///< Monitor thread vs reset(); readers never take it
+        FrequencyTracker tracker;        ///< Guarded by writer_mutex
+    };
+
+    /**
+     * @brief Fold a batch into the tracker and publish it
+     */
+    void onEdges(Slot& slot, EdgeEventSpan events);
+
+    /**
+     * @brief Copy the tracker's statistics into the seqlock words
+     * @note Caller must hold slot.writer_mutex
+     */
+    static void publish(Slot& slot);
+
+    Slot slots_[MAX_PINS];
+    mutable std::mutex mutex_;           ///< Serializes addPin()/removePin()
 };
@@ -1,6 +1,6 @@
 /**
  * @file log.hpp
- * @brief Optional logging macros for debugging GPIO operations
+ * @brief Asynchronous, rate-limited logging macros for debugging GPIO operations
  * @author Barbatos6669
  * @date 2025
  * 
@@ -27,32 +27,218 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 // Logging macros - controlled by CMake options
 // By default, logging is disabled in Release builds
 // Enable with: cmake -DPIPINPP_ENABLE_LOGGING=ON
+//
+// With logging enabled, PIPINPP_LOG_*(msg) does not format on the calling
+// thread. The operands of `msg` ("text" << value << ...) are stored in
+// binary form (integers, doubles, string bytes) into a lock-free ring
+// owned by the calling thread; a background thread ("pipinpp-log") formats
+// them and writes them to the sink (std::cerr by default). Each call site
+// is rate-limited (see setLogRateLimit()), and the level can be changed at
+// run time with setLogLevel() above the compile-time PIPINPP_LOG_LEVEL floor.
+
+#ifndef PIPINPP_LOG_LEVEL
+    #define PIPINPP_LOG_LEVEL 1  // Default: INFO level
+#endif
+
+namespace pipinpp {
+
+/**
+ * @brief Message severity (matches the numeric PIPINPP_LOG_LEVEL values)
+ */
+enum class LogLevel : int {
+    DEBUG = 0,
+    INFO = 1,
+    WARNING = 2,
+    ERROR = 3,
+    OFF = 4     ///< Only for setLogLevel(): log nothing
+};
+
+/**
+ * @brief Receives every formatted message on the logging thread
+ */
+using LogSink = std::function<void(LogLevel level, const std::string& message)>;
+
+/**
+ * @brief Default messages per call site per second before repeats are suppressed
+ */
+constexpr uint32_t DEFAULT_LOG_RATE_LIMIT = 20;
+
+/**
+ * @brief Lowest level logged at run time (default PIPINPP_LOG_LEVEL)
+ */
+void setLogLevel(LogLevel level);
+LogLevel getLogLevel();
+
+/**
+ * @brief Messages a single call site may log per second (0 = unlimited)
+ *
+ * Messages over the limit are counted, and the next accepted message of
+ * that site reports how many were suppressed.
+ */
+void setLogRateLimit(uint32_t perSecond);
+uint32_t getLogRateLimit();
+
+/**
+ * @brief Replace the output (empty = "[LEVEL] message" lines on std::cerr)
+ */
+void setLogSink(LogSink sink);
+
+/**
+ * @brief Format and write every pending message before returning
+ */
+void flushLog();
+
+/**
+ * @brief Messages lost because a thread's ring was full
+ */
+uint64_t getLogDroppedCount();
+
+namespace detail {
+
+/// Largest encoded record; longer messages are truncated
+constexpr size_t LOG_MAX_RECORD_BYTES = 512;
+
+/// Runtime level, checked before any operand is evaluated
+extern std::atomic<int> logLevel;
+
+inline bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) >= PIPINPP_LOG_LEVEL &&
+           static_cast<int>(level) >= logLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Static state of one PIPINPP_LOG_* call site (rate limiting)
+ */
+struct LogSite {
+    constexpr LogSite(LogLevel siteLevel, const char* siteFile, int siteLine)
+        : level(siteLevel), file(siteFile), line(siteLine) {}
+
+    const LogLevel level;
+    const char* const file;
+    const int line;
+    std::atomic<uint64_t> windowStartNs{0};
+    std::atomic<uint32_t> windowCount{0};
+    std::atomic<uint32_t> suppressed{0};
+};
+
+/**
+ * @brief Operand type tags of the binary record encoding
+ */
+enum class LogArg : uint8_t { INT, UINT, DOUBLE, CHAR, BOOL, STRING, POINTER, BASE };
+
+/**
+ * @brief Encodes one message on the stack and hands it to the thread's ring
+ */
+class LogRecord {
+public:
+    /**
+     * @brief Applies the site's rate limit; check accepted() before streaming
+     */
+    explicit LogRecord(LogSite& site);
+
+    /**
+     * @brief Commits the record to the calling thread's ring
+     */
+    ~LogRecord();
+
+    LogRecord(const LogRecord&) = delete;
+    LogRecord& operator=(const LogRecord&) = delete;
+
+    bool accepted() const { return accepted_; }
+
+    template <typename T>
+    LogRecord& operator<<(const T& value) {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            put(LogArg::BOOL, static_cast<uint8_t>(value));
+        } else if constexpr (std::is_same_v<U, char>) {
+            put(LogArg::CHAR, value);
+        } else if constexpr (std::is_enum_v<U>) {
+            put(LogArg::INT, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            put(LogArg::INT, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<U>) {
+            put(LogArg::UINT, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<U>) {
+            put(LogArg::DOUBLE, static_cast<double>(value));
+        } else if constexpr (!std::is_array_v<T> && (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)) {
+            putString(value ? std::string_view(value) : std::string_view("(null)"));
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            putString(std::string_view(value));
+        } else if constexpr (std::is_same_v<U, std::ios_base& (*)(std::ios_base&)>) {
+            // std::hex / std::oct / std::dec: integer base for the operands that follow
+            put(LogArg::BASE, static_cast<uint8_t>(value == std::hex ? 16 : value == std::oct ? 8 : 10));
+        } else if constexpr (std::is_pointer_v<U>) {
+            put(LogArg::POINTER, reinterpret_cast<uintptr_t>(static_cast<const void*>(value)));
+        } else {
+            // Anything else that streams: formatted here (slow path)
+            std::ostringstream text;
+            text << value;
+            putString(text.str());
+        }
+        return *this;
+    }
+
+private:
+    template <typename V>
+    void put(LogArg tag, V value) {
+        if (used_ + 1 + sizeof(V) > sizeof(data_)) {
+            truncated_ = true;
+            return;
+        }
+        data_[used_++] = static_cast<uint8_t>(tag);
+        std::memcpy(data_ + used_, &value, sizeof(V));
+        used_ += sizeof(V);
+    }
+
+    void putString(std::string_view text);
+
+    LogSite& site_;
+    bool accepted_;
+    bool truncated_;
+    uint32_t suppressed_;
+    uint64_t timestampNs_;
+    size_t used_;
+    uint8_t data_[LOG_MAX_RECORD_BYTES];
+};
+
+} // namespace detail
+} // namespace pipinpp
 
 #ifdef PIPINPP_ENABLE_LOGGING
-    #ifndef PIPINPP_LOG_LEVEL
-        #define PIPINPP_LOG_LEVEL 1  // Default: INFO level
-    #endif
-    
     // Log levels: 0=DEBUG, 1=INFO, 2=WARNING, 3=ERROR
-    // DEBUG, INFO, WARNING use '\n' (buffered) for better performance
-    // ERROR uses std::endl (flushes immediately) for critical messages
-    
-    #define PIPINPP_LOG_DEBUG(msg) \
-        do { if (PIPINPP_LOG_LEVEL <= 0) std::cerr << "[DEBUG] " << msg << '\n'; } while(0)
-    
-    #define PIPINPP_LOG_INFO(msg) \
-        do { if (PIPINPP_LOG_LEVEL <= 1) std::cerr << "[INFO] " << msg << '\n'; } while(0)
-    
-    #define PIPINPP_LOG_WARNING(msg) \
-        do { if (PIPINPP_LOG_LEVEL <= 2) std::cerr << "[WARNING] " << msg << '\n'; } while(0)
-    
-    #define PIPINPP_LOG_ERROR(msg) \
-        do { if (PIPINPP_LOG_LEVEL <= 3) std::cerr << "[ERROR] " << msg << std::endl; } while(0)
+    // Levels below PIPINPP_LOG_LEVEL compile out; the rest are checked at run time
+    // ERROR wakes the logging thread immediately; the others are written within ~10 ms
+
+    #define PIPINPP_LOG_AT(lvl, msg) \
+        do { \
+            if (::pipinpp::detail::logEnabled(lvl)) { \
+                static ::pipinpp::detail::LogSite pipinppLogSite_(lvl, __FILE__, __LINE__); \
+                ::pipinpp::detail::LogRecord pipinppLogRecord_(pipinppLogSite_); \
+                if (pipinppLogRecord_.accepted()) { \
+                    pipinppLogRecord_ << msg; \
+                } \
+            } \
+        } while(0)
+
+    #define PIPINPP_LOG_DEBUG(msg) PIPINPP_LOG_AT(::pipinpp::LogLevel::DEBUG, msg)
+    #define PIPINPP_LOG_INFO(msg) PIPINPP_LOG_AT(::pipinpp::LogLevel::INFO, msg)
+    #define PIPINPP_LOG_WARNING(msg) PIPINPP_LOG_AT(::pipinpp::LogLevel::WARNING, msg)
+    #define PIPINPP_LOG_ERROR(msg) PIPINPP_LOG_AT(::pipinpp::LogLevel::ERROR, msg)
 #else
     // Logging disabled - macros expand to nothing (zero overhead)
     #define PIPINPP_LOG_DEBUG(msg) do {} while(0)
@@ -0,0 +1,286 @@
+/**
+ * @file metrics.hpp
+ * @brief Opt-in latency and throughput metrics with lock-free counters and histograms
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Configure with -DPIPINPP_ENABLE_METRICS=ON to instrument the library's
+ * hot paths; without it every PIPINPP_METRIC_* macro expands to nothing and
+ * its arguments are not evaluated. Built-in metrics:
+ *
+ * | Name                         | Kind      | What                                          |
+ * |------------------------------|-----------|-----------------------------------------------|
+ * | gpio_write_ns                | histogram | Pin::write() through the GPIO character device |
+ * | gpio_fast_writes             | counter   | Pin::write() through the register fast path    |
+ * | interrupt_dispatch_ns        | histogram | Kernel edge timestamp to callback start        |
+ * | interrupt_queue_depth        | histogram | Queued callback events when a worker is woken  |
+ * | interrupt_queue_drops        | counter   | Edges dropped on a full callback queue         |
+ * | interrupt_lost_events        | counter   | Edges the kernel dropped (sequence number gaps) |
+ * | spi_transfer_ns              | histogram | One SPI_IOC_MESSAGE ioctl                      |
+ * | spi_errors                   | counter   | Failed SPI ioctls                              |
+ * | i2c_transaction_ns           | histogram | One I2C_RDWR ioctl                             |
+ * | i2c_errors                   | counter   | Failed I2C_RDWR ioctls                         |
+ * | pwm_edge_lateness_ns         | histogram | EventPWMManager edge written vs. its deadline  |
+ * | rt_audit_allocations         | counter   | Allocations on real-time threads (rt_audit.hpp) |
+ * | rt_audit_locks               | counter   | Mutex locks on real-time threads (rt_audit.hpp) |
+ * | rt_audit_lock_waits          | counter   | Contended ones among rt_audit_locks            |
+ *
+ * Recording is a relaxed atomic increment (counters) or three (histograms:
+ * bucket, count, sum) plus a rarely-taken max update; no locks. Histograms
+ * are HDR-style log-linear: 32 sub-buckets per power of two, so every
+ * reported quantile is within ~3% of the true value across the whole
+ * uint64 range.
+ *
+ * snapshot() copies every metric; toPrometheus() and toJson() render a
+ * snapshot for scraping. Applications can add their own metrics through
+ * counter()/histogram() or the same macros.
+ *
+ * Example usage:
+ * @code
+ * // Build with -DPIPINPP_ENABLE_METRICS=ON, run the workload, then:
+ * auto snap = pipinpp::metrics::snapshot();
+ * std::cout << pipinpp::metrics::toPrometheus(snap);
+ * // pipinpp_gpio_write_ns{quantile="0.99"} 2300
+ * const auto* spi = snap.findHistogram("spi_transfer_ns");
+ * if (spi) std::cout << spi->quantile(0.5) << " ns median SPI transfer\n";
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "timebase.hpp"
+
+namespace pipinpp {
+namespace metrics {
+
+/**
+ * @brief Exact buckets below this value, then this many per power of two
+ */
+constexpr size_t HISTOGRAM_SUB_BUCKETS = 32;
+
+/**
+ * @brief Buckets covering 0 to UINT64_MAX
+ */
+constexpr size_t HISTOGRAM_BUCKETS = HISTOGRAM_SUB_BUCKETS + (64 - 5) * HISTOGRAM_SUB_BUCKETS;
+
+/**
+ * @brief Monotonic event count
+ */
+class Counter {
+public:
+    void add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+    void reset() { value_.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+/**
+ * @brief Log-linear histogram of non-negative values (usually nanoseconds)
+ */
+class Histogram {
+public:
+    void record(uint64_t value) {
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    void reset();
+
+    /**
+     * @brief Bucket holding @p value
+     */
+    static size_t bucketIndex(uint64_t value) {
+        if (value < HISTOGRAM_SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        const int msb = 63 - __builtin_clzll(value);
+        const int group = msb - 5;
+        const size_t sub = static_cast<size_t>(value >> group) - HISTOGRAM_SUB_BUCKETS;
+        return HISTOGRAM_SUB_BUCKETS + static_cast<size_t>(group) * HISTOGRAM_SUB_BUCKETS + sub;
+    }
+
+    /**
+     * @brief Smallest value in a bucket
+     */
+    static uint64_t bucketLowerBound(size_t index) {
+        if (index < HISTOGRAM_SUB_BUCKETS) {
+            return index;
+        }
+        const size_t group = (index - HISTOGRAM_SUB_BUCKETS) / HISTOGRAM_SUB_BUCKETS;
+        const size_t sub = (index - HISTOGRAM_SUB_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+        return static_cast<uint64_t>(HISTOGRAM_SUB_BUCKETS + sub) << group;
+    }
+
+    /**
+     * @brief Largest value in a bucket
+     */
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < HISTOGRAM_SUB_BUCKETS) {
+            return index;
+        }
+        const size_t group = (index - HISTOGRAM_SUB_BUCKETS) / HISTOGRAM_SUB_BUCKETS;
+        return bucketLowerBound(index) + ((uint64_t(1) << group) - 1);
+    }
+
+private:
+    friend class Registry;
+
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief Copy of one counter
+ */
+struct CounterSnapshot {
+    std::string name;
+    std::string help;
+    uint64_t value = 0;
+};
+
+/**
+ * @brief Copy of one histogram (non-empty buckets only)
+ */
+struct HistogramSnapshot {
+    struct Bucket {
+        uint64_t lower;
+        uint64_t upper;
+        uint64_t count;
+    };
+
+    std::string name;
+    std::string help;
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    std::vector<Bucket> buckets;
+
+    /**
+     * @brief Value at quantile @p q (0.0-1.0): upper bound of its bucket, capped at max
+     */
+    uint64_t quantile(double q) const;
+
+    double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+};
+
+/**
+ * @brief Every registered metric at one point in time
+ */
+struct Snapshot {
+    uint64_t timestampNs = 0;                  ///< CLOCK_MONOTONIC when taken
+    std::vector<CounterSnapshot> counters;
+    std::vector<HistogramSnapshot> histograms;
+
+    const CounterSnapshot* findCounter(const std::string& name) const;
+    const HistogramSnapshot* findHistogram(const std::string& name) const;
+};
+
+/**
+ * @brief Counter registered under @p name (created on first use, never destroyed)
+ * @param name Metric name ([a-z0-9_])
+ * @param help Description, kept from the first registration that gives one
+ */
+Counter& counter(const std::string& name, const std::string& help = "");
+
+/**
+ * @brief Histogram registered under @p name (created on first use, never destroyed)
+ */
+Histogram& histogram(const std::string& name, const std::string& help = "");
+
+/**
+ * @brief Copy every metric
+ */
+Snapshot snapshot();
+
+/**
+ * @brief Zero every metric (registrations are kept)
+ */
+void reset();
+
+/**
+ * @brief Whether the library was built with PIPINPP_ENABLE_METRICS
+ */
+bool instrumentationEnabled();
+
+/**
+ * @brief Prometheus text exposition format (counters as counter, histograms as summary)
+ * @param prefix Prepended to every metric name
+ */
+std::string toPrometheus(const Snapshot& snap, const std::string& prefix = "pipinpp_");
+
+/**
+ * @brief JSON object {"counters": {...}, "histograms": {...}}
+ */
+std::string toJson(const Snapshot& snap);
+
+/**
+ * @brief Records the lifetime of a scope into a histogram
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& target) : target_(target), startNs_(monotonicNowNs()) {}
+    ~ScopedTimer() { target_.record(static_cast<uint64_t>(monotonicNowNs() - startNs_)); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram& target_;
+    int64_t startNs_;
+};
+
+} // namespace metrics
+} // namespace pipinpp
+
+#define PIPINPP_METRIC_CONCAT_(a, b) a##b
+#define PIPINPP_METRIC_CONCAT(a, b) PIPINPP_METRIC_CONCAT_(a, b)
+
+#ifdef PIPINPP_ENABLE_METRICS
+    // The registry lookup runs once per call site; afterwards only atomics
+
+    #define PIPINPP_METRIC_COUNT(name, n) \
+        do { \
+            static ::pipinpp::metrics::Counter& pipinppMetric_ = ::pipinpp::metrics::counter(name); \
+            pipinppMetric_.add(n); \
+        } while(0)
+
+    #define PIPINPP_METRIC_RECORD(name, value) \
+        do { \
+            static ::pipinpp::metrics::Histogram& pipinppMetric_ = ::pipinpp::metrics::histogram(name); \
+            pipinppMetric_.record(value); \
+        } while(0)
+
+    #define PIPINPP_METRIC_TIME_SCOPE(name) \
+        static ::pipinpp::metrics::Histogram& PIPINPP_METRIC_CONCAT(pipinppMetricHist_, __LINE__) = \
+            ::pipinpp::metrics::histogram(name); \
+        ::pipinpp::metrics::ScopedTimer PIPINPP_METRIC_CONCAT(pipinppMetricTimer_, __LINE__)( \
+            PIPINPP_METRIC_CONCAT(pipinppMetricHist_, __LINE__))
+
+    #define PIPINPP_METRIC_NOW_NS() ::pipinpp::monotonicNowNs()
+#else
+    // Metrics disabled - macros expand to nothing (zero overhead)
+    #define PIPINPP_METRIC_COUNT(name, n) do {} while(0)
+    #define PIPINPP_METRIC_RECORD(name, value) do {} while(0)
+    #define PIPINPP_METRIC_TIME_SCOPE(name) do {} while(0)
+    #define PIPINPP_METRIC_NOW_NS() 0
+#endif
@@ -0,0 +1,259 @@
+/**
+ * @file neopixel.hpp
+ * @brief WS2812/SK6812 LED strips driven from the SPI MOSI line or a Pi 5 PIO
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * WS2812-style LEDs take a single-wire signal with 1.25 µs bits whose HIGH
+ * time (~0.4 µs or ~0.8 µs) encodes 0 or 1. That is far below what
+ * Pin::write() and a sleeping thread can hit, but it is exactly what an
+ * SPI controller produces when every LED bit is sent as 3 (or 4) SPI bits
+ * at 2.4 MHz (or 3.2 MHz): "100" is a 0 and "110" a 1. The controller's
+ * DMA then clocks out the whole frame without the CPU.
+ *
+ * Encoding is one lookup per colour byte in a 256-entry table built at
+ * compile time; the encoded frame (plus the trailing LOW latch time) lives
+ * in a buffer allocated once, and show() hands it to
+ * SPIClass::transferStream(), which splits it into the largest chunks
+ * spidev accepts. Only MOSI is used: connect it (through a level shifter)
+ * to the strip's DIN and leave SCLK and CS unconnected.
+ *
+ * The LED protocol itself runs at 800 kbit/s, so a frame takes 30 µs per
+ * RGB LED whatever drives it: 60 fps allows about 550 LEDs per data line.
+ * Longer installations are split across SPI buses, one strip each.
+ *
+ * On a Raspberry Pi 5, constructing a strip from a pin number instead
+ * runs the bit timing on an RP1 PIO state machine (pioWs2812Program()):
+ * any GPIO works, each pixel is one 32-bit word instead of 9-12 SPI
+ * bytes, and the kernel's DMA feeds the FIFO, so several strips on
+ * different pins can run at once. Elsewhere that constructor falls back
+ * to SPI0 when the pin is its MOSI (GPIO 10).
+ *
+ * @note spidev's default 4096-byte message limit splits longer frames into
+ *       several ioctls, and a gap between them longer than the latch time
+ *       ends the frame early. For strips above ~450 LEDs (3-bit encoding)
+ *       raise the limit, e.g. spidev.bufsiz=65536 on the kernel command
+ *       line; see SPIClass::getMaxTransferSize().
+ *
+ * Example usage:
+ * @code
+ * SPI.begin(0, 0);                                     // MOSI = GPIO 10
+ * pipinpp::NeoPixelStrip strip(1000);
+ * for (uint8_t t = 0;; ++t) {
+ *     for (size_t i = 0; i < strip.size(); ++i) {
+ *         strip.setPixelColor(i, 255, 0, static_cast<uint8_t>(t + i));
+ *     }
+ *     strip.show();                                    // 9 KB, 30 ms on the wire
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pipinpp {
+
+class SPIClass;
+extern SPIClass SPI;
+class PioStateMachine;
+
+/**
+ * @brief Default LOW time after a frame that latches it (µs, WS2812B-V5 needs 280)
+ */
+constexpr uint32_t NEOPIXEL_DEFAULT_RESET_US = 300;
+
+/**
+ * @brief LED protocol bit rate
+ */
+constexpr uint32_t NEOPIXEL_BIT_RATE_HZ = 800000;
+
+/**
+ * @brief SPI bits per LED bit
+ */
+enum class NeoPixelEncoding {
+    BITS_3,   ///< 2.4 MHz, 3 bytes per colour byte: 0 = 100, 1 = 110
+    BITS_4    ///< 3.2 MHz, 4 bytes per colour byte: 0 = 1000, 1 = 1110 (more margin)
+};
+
+/**
+ * @brief Order in which the strip expects the colour channels
+ */
+enum class NeoPixelOrder {
+    GRB,      ///< WS2812/WS2812B
+    RGB,      ///< WS2811 and some clones
+    BRG,
+    GRBW      ///< SK6812 RGBW
+};
+
+/**
+ * @brief LED strip on one SPI bus or PIO state machine
+ *
+ * Pixel colours are kept unscaled; setBrightness() is applied while
+ * encoding, so it can change without losing resolution.
+ *
+ * @note Not thread-safe: use one thread per strip
+ */
+class NeoPixelStrip {
+public:
+    /**
+     * @param count Number of LEDs
+     * @param spi Bus to send on; must be begun by the caller
+     * @param encoding SPI bits per LED bit
+     * @param order Colour channel order
+     * @param resetUs LOW time appended to every frame
+     */
+    explicit NeoPixelStrip(size_t count, SPIClass& spi = SPI,
+                           NeoPixelEncoding encoding = NeoPixelEncoding::BITS_3,
+                           NeoPixelOrder order = NeoPixelOrder::GRB,
+                           uint32_t resetUs = NEOPIXEL_DEFAULT_RESET_US);
+
+    /**
+     * @brief Strip on any GPIO pin, driven by PIO (Raspberry Pi 5)
+     *
+     * Without PIO, GPIO 10 falls back to SPI0 with 3-bit encoding (begun
+     * here if it is not already).
+     *
+     * @param pin Data pin
+     * @param count Number of LEDs
+     * @param order Colour channel order
+     * @param resetUs LOW time between frames
+     * @throws InvalidPinError if the pin number is invalid
+     * @throws GpioAccessError if neither PIO nor SPI can drive the pin
+     */
+    NeoPixelStrip(int pin, size_t count, NeoPixelOrder order = NeoPixelOrder::GRB,
+                  uint32_t resetUs = NEOPIXEL_DEFAULT_RESET_US);
+
+    /**
+     * @brief Waits for a pending showAsync()
+     */
+    ~NeoPixelStrip();
+
+    NeoPixelStrip(const NeoPixelStrip&) = delete;
+    NeoPixelStrip& operator=(const NeoPixelStrip&) = delete;
+
+    /**
+     * @brief Pack a colour as 0xWWRRGGBB
+     */
+    static constexpr uint32_t color(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) {
+        return (static_cast<uint32_t>(w) << 24) | (static_cast<uint32_t>(r) << 16) |
+               (static_cast<uint32_t>(g) << 8) | b;
+    }
+
+    /**
+     * @brief Set one pixel (ignored when out of range)
+     */
+    void setPixelColor(size_t index, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0);
+
+    /**
+     * @brief Set one pixel from a packed 0xWWRRGGBB colour
+     */
+    void setPixelColor(size_t index, uint32_t packed);
+
+    /**
+     * @brief Packed colour of one pixel (0 when out of range)
+     */
+    uint32_t getPixelColor(size_t index) const;
+
+    /**
+     * @brief Set @p count pixels from @p first (0 = to the end)
+     */
+    void fill(uint32_t packed, size_t first = 0, size_t count = 0);
+
+    /**
+     * @brief All pixels off (takes effect on the next show())
+     */
+    void clear() { fill(0); }
+
+    /**
+     * @brief Global brightness applied while encoding (255 = unscaled)
+     */
+    void setBrightness(uint8_t brightness) { brightness_ = brightness; }
+    uint8_t getBrightness() const { return brightness_; }
+
+    /**
+     * @brief Encode and send the frame, returning when it is on the wire
+     * @return false if the bus is not begun, a transfer failed, or a
+     *         showAsync() frame is still being sent
+     */
+    bool show();
+
+    /**
+     * @brief Encode the frame and queue it on the SPI I/O thread
+     *
+     * The colour buffer may be changed immediately; the encoded frame is
+     * in use until the transfer completes (see isBusy()). On PIO this is
+     * the same as show().
+     *
+     * @return false if the previous frame is still being sent or the queue refused it
+     */
+    bool showAsync();
+
+    /**
+     * @brief Whether a showAsync() frame is still being sent
+     */
+    bool isBusy() const { return busy_.load(std::memory_order_acquire); }
+
+    size_t size() const { return count_; }
+    NeoPixelEncoding getEncoding() const { return encoding_; }
+    NeoPixelOrder getOrder() const { return order_; }
+
+    /**
+     * @brief Whether a PIO state machine drives the strip
+     */
+    bool usesPio() const { return pio_ != nullptr; }
+
+    /**
+     * @brief Encoded frame of the last show() including the latch bytes (empty on PIO)
+     */
+    const std::vector<uint8_t>& frame() const { return frame_; }
+
+    /**
+     * @brief SPI clock for an encoding
+     */
+    static uint32_t clockHz(NeoPixelEncoding encoding);
+
+    /**
+     * @brief Colour bytes per pixel for a channel order
+     */
+    static size_t bytesPerPixel(NeoPixelOrder order) { return order == NeoPixelOrder::GRBW ? 4 : 3; }
+
+    /**
+     * @brief Encode colour bytes into SPI bytes
+     * @param bytes Colour bytes in wire order
+     * @param length Number of colour bytes
+     * @param encoding SPI bits per LED bit
+     * @param[out] out At least length * 3 (BITS_3) or length * 4 (BITS_4) bytes
+     * @return Bytes written to @p out
+     */
+    static size_t encode(const uint8_t* bytes, size_t length, NeoPixelEncoding encoding, uint8_t* out);
+
+private:
+    void allocateFrame(uint32_t resetUs);
+    size_t encodeFrame();
+    bool showPio();
+
+    SPIClass* spi_;                   ///< nullptr on PIO
+    size_t count_;
+    NeoPixelEncoding encoding_;
+    NeoPixelOrder order_;
+    uint8_t brightness_;
+    std::vector<uint8_t> pixels_;     ///< Colour bytes in wire order
+    std::vector<uint8_t> frame_;      ///< Encoded pixels followed by LOW latch bytes
+    std::atomic<bool> busy_;
+    std::unique_ptr<PioStateMachine> pio_;
+    std::vector<uint32_t> words_;     ///< One FIFO word per pixel (PIO)
+    uint32_t resetUs_;
+    int64_t latchEndNs_;              ///< When the line has been LOW for resetUs_ (PIO)
+};
+
+} // namespace pipinpp
@@ -0,0 +1,210 @@
+/**
+ * @file one_wire.hpp
+ * @brief Bit-banged 1-Wire master with DS18B20 temperature helpers
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * 1-Wire is open-drain: the master pulls the line LOW and otherwise lets a
+ * pull-up (4.7 kΩ external, or the internal one as a fallback for short
+ * cables) hold it HIGH. OneWireBus emulates that with one Pin that it
+ * switches between OUTPUT (driven LOW) and input with Pin::reconfigure(),
+ * one ioctl each way on the line request it already owns.
+ *
+ * Every bit is a timed slot measured from the falling edge against
+ * CLOCK_MONOTONIC deadlines (preciseSleepUntilNs()):
+ * - reset: 480 µs LOW, presence sampled 70 µs after release
+ * - write 0: 60 µs LOW; write 1 and read: released as soon as possible,
+ *   read sampled 12 µs after the falling edge
+ * A 1 or read slot only works if the line is released within 15 µs. When
+ * preemption or a slow ioctl stretches it past that, the slot is counted
+ * as an overrun and the transaction fails (and is retried where the
+ * protocol allows) instead of silently writing a 0.
+ *
+ * While a transaction runs, the calling thread is raised to the SCHED_FIFO
+ * priority of the ThreadPolicyManager policy (if one is set and granted)
+ * and restored afterwards.
+ *
+ * For a set of DS18B20 sensors, readTemperatures() starts the conversion
+ * on all of them at once (SKIP ROM + CONVERT T), polls for completion and
+ * then reads each scratchpad, so 12 sensors take one 750 ms conversion
+ * plus ~12 ms per sensor instead of 12 conversions. ROM codes and
+ * scratchpads are checked with a table-driven CRC8.
+ *
+ * @note Sensors must be powered from VDD; parasite power needs a strong
+ *       pull-up during conversion, which a reconfigured GPIO cannot
+ *       switch to without a LOW glitch.
+ *
+ * Example usage:
+ * @code
+ * #include "one_wire.hpp"
+ *
+ * pipinpp::OneWireBus bus(4);
+ * std::vector<uint64_t> sensors;
+ * bus.search(sensors);                          // All ROM codes, CRC checked
+ * std::vector<float> celsius;
+ * bus.readTemperatures(sensors, celsius);       // One conversion for all
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pin.hpp"
+
+namespace pipinpp {
+
+constexpr uint8_t ONEWIRE_SEARCH_ROM = 0xF0;
+constexpr uint8_t ONEWIRE_ALARM_SEARCH = 0xEC;
+constexpr uint8_t ONEWIRE_READ_ROM = 0x33;
+constexpr uint8_t ONEWIRE_MATCH_ROM = 0x55;
+constexpr uint8_t ONEWIRE_SKIP_ROM = 0xCC;
+
+constexpr uint8_t DS18B20_FAMILY = 0x28;
+constexpr uint8_t DS18B20_CONVERT_T = 0x44;
+constexpr uint8_t DS18B20_READ_SCRATCHPAD = 0xBE;
+constexpr size_t DS18B20_SCRATCHPAD_SIZE = 9;
+
+/**
+ * @brief Dallas/Maxim CRC8 (polynomial x^8 + x^5 + x^4 + 1), 256-entry table
+ *
+ * @return 0 when @p data ends with its own valid CRC byte
+ */
+uint8_t oneWireCrc8(const uint8_t* data, size_t length);
+
+/**
+ * @brief 1-Wire master on one GPIO
+ *
+ * ROM codes are uint64_t with the family code in the low byte and the
+ * CRC in the high byte (the order they are sent on the wire).
+ *
+ * @note Not thread-safe; one thread per bus
+ */
+class OneWireBus {
+public:
+    /**
+     * @param pin GPIO connected to DQ
+     * @param internalPullup Release to INPUT_PULLUP instead of INPUT
+     *        (the ~50 kΩ internal pull-up only suits a few sensors on short wires)
+     * @param chipname GPIO chip
+     * @throws InvalidPinError, GpioAccessError as Pin
+     */
+    explicit OneWireBus(int pin, bool internalPullup = false, const std::string& chipname = "gpiochip0");
+
+    OneWireBus(const OneWireBus&) = delete;
+    OneWireBus& operator=(const OneWireBus&) = delete;
+
+    /**
+     * @brief Reset pulse
+     * @return true if at least one device answered with a presence pulse
+     */
+    bool reset();
+
+    bool writeBit(bool bit);
+
+    /**
+     * @return 0 or 1, -1 on error or slot overrun
+     */
+    int readBit();
+
+    bool writeByte(uint8_t value);
+
+    /**
+     * @return 0-255, -1 on error or slot overrun
+     */
+    int readByte();
+
+    bool write(const uint8_t* data, size_t length);
+    bool read(uint8_t* data, size_t length);
+
+    /**
+     * @brief Reset and address one device (MATCH ROM)
+     */
+    bool select(uint64_t rom);
+
+    /**
+     * @brief Reset and address every device (SKIP ROM)
+     */
+    bool skip();
+
+    /**
+     * @brief Enumerate every device on the bus
+     *
+     * Runs the binary ROM search to completion in one call; each code is
+     * CRC checked. A pass that fails is restarted, up to @p retries times.
+     *
+     * @param roms Receives the ROM codes (cleared first)
+     * @param command ONEWIRE_SEARCH_ROM, or ONEWIRE_ALARM_SEARCH for devices in alarm
+     * @param retries Restarts allowed after a failed pass
+     * @return Number of devices found, -1 on error
+     */
+    int search(std::vector<uint64_t>& roms, uint8_t command = ONEWIRE_SEARCH_ROM, int retries = 2);
+
+    /**
+     * @brief Start a temperature conversion on every DS18B20 at once
+     */
+    bool startConversion();
+
+    /**
+     * @brief Whether all conversions have finished (one read slot)
+     */
+    bool conversionDone();
+
+    /**
+     * @brief Read and CRC-check one DS18B20 scratchpad
+     * @param retries Extra attempts after a CRC error or overrun
+     */
+    bool readScratchpad(uint64_t rom, uint8_t* scratchpad, int retries = 2);
+
+    /**
+     * @brief Read the result of the last conversion from one sensor
+     */
+    bool readTemperature(uint64_t rom, float& celsius);
+
+    /**
+     * @brief Convert on all sensors in parallel, then read each
+     *
+     * @param roms Sensors to read
+     * @param celsius Receives one value per ROM, NaN where the read failed
+     * @param timeoutMs Longest wait for the conversion
+     * @return Number of sensors read successfully
+     */
+    size_t readTemperatures(const std::vector<uint64_t>& roms, std::vector<float>& celsius,
+                            uint32_t timeoutMs = 1000);
+
+    /**
+     * @brief Temperature from a DS18B20 scratchpad, at its configured resolution
+     */
+    static float scratchpadToCelsius(const uint8_t* scratchpad);
+
+    /**
+     * @brief Slots whose short LOW phase ran past 15 µs (transaction failed)
+     */
+    uint64_t getSlotOverruns() const { return overruns_; }
+
+    /**
+     * @brief The DQ line
+     */
+    Pin& pin() { return line_; }
+
+private:
+    /**
+     * @brief One timed slot: LOW for @p lowNs, then released
+     * @param sampleNs Sample time from the falling edge, 0 for a write slot
+     * @return Sampled level (or 0 for writes), -1 on error or overrun
+     */
+    int slot(int64_t lowNs, int64_t sampleNs);
+
+    Pin line_;
+    PinMode releaseMode_;
+    uint64_t overruns_;
+};
+
+} // namespace pipinpp
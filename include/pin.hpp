@@ -61,7 +61,15 @@
 #pragma once
 
 #include <gpiod.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+#include "backend.hpp"
+#include "chip_registry.hpp"
+#include "error_code.hpp"
+#include "gpiomem.hpp"
 
 enum class PinDirection { INPUT, OUTPUT };
 
@@ -75,6 +83,27 @@ enum class PinMode {
     INPUT_PULLDOWN      ///< Input with internal pull-down resistor
 };
 
+/**
+ * @brief I/O backend used by Pin::write() and Pin::read()
+ *
+ * The line is always requested and configured through libgpiod. With
+ * GPIOMEM, reads and writes then go straight to the mmap'd GPIO registers
+ * (/dev/gpiomem on BCM2835/2711, /dev/gpiomem0 on the Pi 5 RP1). If the
+ * registers cannot be mapped, the pin quietly falls back to LIBGPIOD.
+ */
+enum class PinBackend {
+    LIBGPIOD,           ///< One ioctl per read/write (default, works everywhere)
+    GPIOMEM             ///< Direct register access for bit-banging hot loops
+};
+
+/**
+ * @brief One edge read from a Pin's own line request
+ */
+struct PinEdgeEvent {
+    bool rising;            ///< true for LOW to HIGH
+    uint64_t timestampNs;   ///< Kernel CLOCK_MONOTONIC timestamp
+};
+
 /**
  * @brief A class for controlling GPIO pins on Raspberry Pi
  * 
@@ -90,13 +119,15 @@ public:
      * @param pin The GPIO pin number to control (0-27 for Raspberry Pi)
      * @param direction The direction of the pin (INPUT or OUTPUT)
      * @param chipname The name of the GPIO chip (default: "gpiochip0")
+     * @param backend I/O backend for read/write (default: PinBackend::LIBGPIOD)
      * @throws std::invalid_argument if pin number is invalid (outside 0-27 range)
      * @throws std::runtime_error if GPIO chip cannot be opened or line cannot be requested
      * 
      * @note This constructor does not configure pull resistors. Use PinMode constructor for pull resistors.
      * @warning Some pins (0,1,14,15) have special functions and may conflict with other uses.
      */
-    Pin(int pin, PinDirection direction, const std::string& chipname = "gpiochip0");
+    Pin(int pin, PinDirection direction, const std::string& chipname = "gpiochip0",
+        PinBackend backend = PinBackend::LIBGPIOD);
 
     /**
      * @brief Construct a new Pin object with mode (including pull resistors)
@@ -104,13 +135,15 @@ public:
      * @param pin The GPIO pin number to control (0-27 for Raspberry Pi)
      * @param mode The pin mode including pull resistor configuration
      * @param chipname The name of the GPIO chip (default: "gpiochip0")
+     * @param backend I/O backend for read/write (default: PinBackend::LIBGPIOD)
      * @throws std::invalid_argument if pin number is invalid (outside 0-27 range)  
      * @throws std::runtime_error if GPIO chip cannot be opened or line cannot be requested
      * 
      * @note Pull resistor support requires libgpiod 1.4+ and compatible hardware
      * @warning Some pins (0,1,14,15) have special functions and may conflict with other uses.
      */
-    Pin(int pin, PinMode mode, const std::string& chipname = "gpiochip0");
+    Pin(int pin, PinMode mode, const std::string& chipname = "gpiochip0",
+        PinBackend backend = PinBackend::LIBGPIOD);
 
     /**
      * @brief Destroy the Pin object
@@ -159,13 +192,194 @@ public:
      * @endcode
      */
     int read();
+
+    /**
+     * @brief write() reporting why it failed, without exceptions or allocation
+     *
+     * @return Empty on success; GpioErrc::NOT_OPEN, GpioErrc::WRONG_DIRECTION
+     *         for inputs, or the backend's errno
+     */
+    std::error_code writeNoexcept(bool value) noexcept;
+
+    /**
+     * @brief read() reporting why it failed, without exceptions or allocation
+     *
+     * @param level Receives 0 or 1 on success
+     */
+    std::error_code readNoexcept(int& level) noexcept;
+
+    /**
+     * @brief Invert an output without reading it back
+     *
+     * The current level comes from the chip's OutputShadow (the last
+     * value written), so a toggle is one write and no read.
+     *
+     * @return false for input pins or if the write failed
+     */
+    bool toggle();
+
+    /**
+     * @brief Level last written to this output (no kernel access)
+     *
+     * @return 1 or 0, -1 for input pins
+     */
+    int getOutputState() const;
+
+    /**
+     * @brief Change direction and pull resistors on the existing request
+     *
+     * One reconfigure ioctl on the line this object already owns, instead
+     * of releasing it and requesting it again (useful for bidirectional
+     * lines such as 1-Wire). The backend and chip are kept.
+     * - OUTPUT drives the line LOW and drops edge detection and debounce
+     * - Inputs keep edge detection and debounce if they were enabled;
+     *   INPUT on a line that had a pull resistor disables it
+     *
+     * @param mode New mode
+     * @return false if the kernel rejected the settings (the pin is unchanged)
+     *
+     * @code
+     * Pin bus(4, PinMode::INPUT_PULLUP);
+     * bus.reconfigure(PinMode::OUTPUT);       // drive the reset pulse
+     * bus.reconfigure(PinMode::INPUT_PULLUP); // release and listen
+     * @endcode
+     */
+    bool reconfigure(PinMode mode);
+
+    /**
+     * @brief Get the backend actually in use
+     *
+     * @return PinBackend::GPIOMEM if direct register access is active,
+     *         PinBackend::LIBGPIOD otherwise (including after a fallback)
+     */
+    PinBackend getBackend() const { return fastPath ? PinBackend::GPIOMEM : PinBackend::LIBGPIOD; }
+
+    /**
+     * @brief Register mapping behind the GPIOMEM backend
+     *
+     * @return nullptr unless getBackend() is PinBackend::GPIOMEM
+     */
+    pipinpp::GpioMem* getRegisters() const { return fastPath; }
+    
+    /**
+     * @brief Turn on kernel edge detection (both edges) for this input
+     * 
+     * Reconfigures the existing line request, keeping direction and bias,
+     * so no second request (and no EBUSY) is needed to timestamp edges on
+     * a pin this object already owns. Use waitEdgeEvents() to read them.
+     * 
+     * @param enable true to detect both edges, false to stop
+     * @return false for output pins or if the kernel rejects the change
+     * 
+     * @note Events queue in the kernel (16 per line, oldest dropped) until read
+     */
+    bool enableEdgeEvents(bool enable = true);
+    
+    /**
+     * @brief Whether enableEdgeEvents() is active
+     */
+    bool edgeEventsEnabled() const { return !eventBuffer.empty(); }
+
+    /**
+     * @brief File descriptor that becomes readable when edges are pending
+     *
+     * For an external poll()/epoll loop; read the edges with
+     * waitEdgeEvents(events, n, 0).
+     *
+     * @return The line request fd, -1 if edge events are off
+     */
+    int getEventFd() const;
+    
+    /**
+     * @brief Block on the request fd for edge events
+     * 
+     * @param events Destination for events, oldest first
+     * @param maxEvents Capacity of @p events
+     * @param timeoutNs Longest wait in nanoseconds (0 polls)
+     * @return Events read, 0 on timeout or if every edge read was a filtered bounce
+     *         (see setDebounce()), -1 on error or if edge events are off
+     * 
+     * @note Not thread-safe; one reader per pin
+     */
+    int waitEdgeEvents(PinEdgeEvent* events, size_t maxEvents, int64_t timeoutNs);
+    
+    /**
+     * @brief Filter contact bounce on this input
+     * 
+     * Asks the kernel to debounce the line (the level must be stable for
+     * @p periodUs before a change is reported, for both read() and edge
+     * events). If the kernel rejects the setting, waitEdgeEvents() falls
+     * back to dropping edges that arrive within @p periodUs of the last
+     * accepted edge, by kernel timestamp.
+     * 
+     * @param periodUs Debounce period in microseconds, 0 to disable
+     * @return false for output pins or if the line cannot be reconfigured
+     */
+    bool setDebounce(uint32_t periodUs);
+    
+    /**
+     * @brief Debounce period set with setDebounce() in microseconds
+     */
+    uint32_t getDebounce() const { return debouncePeriodUs; }
+    
+    /**
+     * @brief Whether debounce is done by the timestamp filter rather than the kernel
+     */
+    bool isSoftwareDebounce() const { return softwareDebounce; }
+    
+    /**
+     * @brief Clock a buffer out with this pin as data line
+     * 
+     * For each bit: data is set while the clock is low, then the clock is
+     * pulsed high; the clock is left low. When both pins use the register
+     * backend (see getBackend()) the bits are written straight to the GPIO
+     * set/clear registers with masks computed once per call, otherwise each
+     * edge is one libgpiod call.
+     * 
+     * @param clock Clock output
+     * @param msbFirst true for most significant bit first
+     * @param data Bytes to send, in order
+     * @param length Number of bytes
+     * @param clockNs Data setup time and clock high time in nanoseconds
+     *        (0 = as fast as the backend allows)
+     * @return false unless both pins are outputs, or if a write failed
+     */
+    bool shiftOut(Pin& clock, bool msbFirst, const uint8_t* data, size_t length, uint32_t clockNs = 0);
+    
+    /**
+     * @brief Clock a buffer in with this pin as data line
+     * 
+     * For each bit: the clock is raised, the data pin sampled after
+     * @p clockNs, then the clock is lowered and held for @p clockNs.
+     * 
+     * @param clock Clock output
+     * @param msbFirst true if the first bit received is the most significant
+     * @param data Destination for @p length bytes
+     * @param length Number of bytes
+     * @param clockNs Clock high and low time in nanoseconds
+     * @return false unless this pin is an input and @p clock an output, or if an access failed
+     */
+    bool shiftIn(Pin& clock, bool msbFirst, uint8_t* data, size_t length, uint32_t clockNs = 0);
     
 private:
-    gpiod_chip* chip; ///< The GPIO chip being used
-    gpiod_line_request* request; ///< The GPIO line request (v2 API)
+    std::shared_ptr<pipinpp::GpioChip> chip; ///< Shared GPIO chip handle (see ChipRegistry)
+    std::unique_ptr<pipinpp::LineRequest> request; ///< The GPIO line request (libgpiod or simulated)
     PinDirection currentDirection; ///< Current pin direction
 
     unsigned int pinNumber; ///< The GPIO pin number being controlled 
+    pipinpp::GpioMem* fastPath; ///< Register mapping when using PinBackend::GPIOMEM, else nullptr
+    uint32_t pinMask; ///< 1 << pinNumber, precomputed for the register fast path
+    gpiod_line_bias currentBias; ///< Bias requested at construction (kept on reconfigure)
+    std::vector<pipinpp::LineEvent> eventBuffer; ///< Non-empty while edge events are enabled
+    uint32_t debouncePeriodUs; ///< Debounce period requested with setDebounce()
+    bool softwareDebounce; ///< Kernel rejected the period; filter edges in waitEdgeEvents()
+    uint64_t lastEdgeNs; ///< Timestamp of the last edge passed by the software filter
+    
+    /**
+     * @brief Reconfigure the input line keeping direction and bias
+     * @return false if the kernel rejected the settings
+     */
+    bool reconfigureInput(bool edges, uint32_t debounceUs);
     
     /**
      * @brief Validate that the pin number is valid for Raspberry Pi
@@ -179,7 +393,7 @@ private:
     
     /**
      * @brief Initialize GPIO hardware with specified configuration
-     * @param chipname The name of the GPIO chip to open
+     * @param chipname The name of the GPIO chip (shared through ChipRegistry)
      * @param direction The GPIO line direction (input or output)
      * @param bias The bias setting for pull resistors (GPIOD_LINE_BIAS_AS_IS, PULL_UP, PULL_DOWN)
      * @param initial_value Initial output value (only used for OUTPUT direction)
@@ -191,4 +405,10 @@ private:
                         gpiod_line_direction direction,
                         gpiod_line_bias bias,
                         gpiod_line_value initial_value = GPIOD_LINE_VALUE_INACTIVE);
+
+    /**
+     * @brief Enable the /dev/gpiomem fast path if the chip supports it
+     * @param chipname Chip name, used for log messages only
+     */
+    void initializeFastPath(const std::string& chipname);
 };
\ No newline at end of file
@@ -0,0 +1,378 @@
+/**
+ * @file pio.hpp
+ * @brief Raspberry Pi 5 RP1 PIO state machines: programs, assembler and FIFO access
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * The RP1 I/O controller on the Pi 5 has the same programmable I/O block
+ * as the RP2040: four state machines running tiny programs (32
+ * instructions shared), each with its own clock divider and 4-word TX/RX
+ * FIFOs. A protocol written as a PIO program is timed to the PIO clock
+ * cycle with no CPU involvement, where the Pi 4 paths need DMA tricks
+ * (dma.hpp) that do not exist on the Pi 5.
+ *
+ * - PioProgram: assembled program with side-set, delays and wrap; the
+ *   pio_* encoders build instructions, so programs read like pioasm
+ * - built-in programs for WS2812 LEDs, quadrature counting, parallel
+ *   output, PWM and WaveSequencer playback
+ * - PioStateMachine: loads a program, claims a state machine, configures
+ *   pins, shifts and clock, and moves data through the FIFOs (bulk writes
+ *   use the kernel's DMA)
+ *
+ * Hardware access goes through Raspberry Pi's piolib and the rp1-pio
+ * driver (/dev/pio0). The build enables it when piolib is installed (see
+ * PIPINPP_ENABLE_PIO in docs/BUILD.md); elsewhere isSupported() is false
+ * and begin() fails, so NeoPixelStrip, QuadratureEncoder and
+ * WaveSequencer fall back to their SPI/libgpiod/thread paths.
+ *
+ * Example usage:
+ * @code
+ * if (pipinpp::PioStateMachine::isSupported()) {
+ *     pipinpp::PioStateMachine sm;
+ *     pipinpp::PioSmConfig config;
+ *     config.sidesetBase = 18;
+ *     config.outShiftRight = false;
+ *     config.autopull = true;
+ *     config.pullThreshold = 24;
+ *     config.clockHz = 800000.0 * pipinpp::PIO_WS2812_CYCLES_PER_BIT;
+ *     sm.begin(pipinpp::pioWs2812Program(), config);
+ *     sm.put(0x00FF0000u << 8);            // One green pixel (GRB, MSB first)
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @brief Instruction memory shared by the state machines of one PIO block
+ */
+constexpr size_t PIO_MAX_INSTRUCTIONS = 32;
+
+/**
+ * @brief PIO clock cycles per bit of pioWs2812Program()
+ */
+constexpr uint32_t PIO_WS2812_CYCLES_PER_BIT = 10;
+
+/**
+ * @brief PIO clock cycles of pioWaveProgram() overhead per step
+ */
+constexpr uint32_t PIO_WAVE_STEP_CYCLES = 5;
+
+/**
+ * @brief JMP conditions
+ */
+enum class PioJmp : uint8_t {
+    ALWAYS = 0,
+    NOT_X = 1,        ///< X is zero
+    X_DEC = 2,        ///< X non-zero, then decrement
+    NOT_Y = 3,        ///< Y is zero
+    Y_DEC = 4,        ///< Y non-zero, then decrement
+    X_NE_Y = 5,
+    PIN = 6,          ///< JMP pin is high
+    NOT_OSRE = 7      ///< Output shift register not empty
+};
+
+enum class PioWaitSource : uint8_t { GPIO = 0, PIN = 1, IRQ = 2 };
+enum class PioInSource : uint8_t { PINS = 0, X = 1, Y = 2, NULLS = 3, ISR = 6, OSR = 7 };
+enum class PioOutDest : uint8_t { PINS = 0, X = 1, Y = 2, NULLS = 3, PINDIRS = 4, PC = 5, ISR = 6, EXEC = 7 };
+enum class PioMovDest : uint8_t { PINS = 0, X = 1, Y = 2, EXEC = 4, PC = 5, ISR = 6, OSR = 7 };
+enum class PioMovSource : uint8_t { PINS = 0, X = 1, Y = 2, NULLS = 3, STATUS = 5, ISR = 6, OSR = 7 };
+enum class PioMovOp : uint8_t { NONE = 0, INVERT = 1, REVERSE = 2 };
+enum class PioSetDest : uint8_t { PINS = 0, X = 1, Y = 2, PINDIRS = 4 };
+
+/**
+ * @brief RX/TX FIFO joining (one 8-deep FIFO instead of two 4-deep ones)
+ */
+enum class PioFifoJoin : uint8_t { NONE, TX, RX };
+
+// Instruction encoders. Delay and side-set are added by PioProgram::add(),
+// since their bit layout depends on the program's side-set configuration.
+
+constexpr uint16_t pioJmp(PioJmp condition, uint8_t address) {
+    return static_cast<uint16_t>(0x0000 | (static_cast<uint8_t>(condition) << 5) | (address & 0x1f));
+}
+
+constexpr uint16_t pioWait(bool polarity, PioWaitSource source, uint8_t index) {
+    return static_cast<uint16_t>(0x2000 | (polarity ? 0x80 : 0) | (static_cast<uint8_t>(source) << 5) | (index & 0x1f));
+}
+
+/**
+ * @param bits 1-32
+ */
+constexpr uint16_t pioIn(PioInSource source, uint8_t bits) {
+    return static_cast<uint16_t>(0x4000 | (static_cast<uint8_t>(source) << 5) | (bits & 0x1f));
+}
+
+/**
+ * @param bits 1-32
+ */
+constexpr uint16_t pioOut(PioOutDest destination, uint8_t bits) {
+    return static_cast<uint16_t>(0x6000 | (static_cast<uint8_t>(destination) << 5) | (bits & 0x1f));
+}
+
+constexpr uint16_t pioPush(bool ifFull = false, bool block = true) {
+    return static_cast<uint16_t>(0x8000 | (ifFull ? 0x40 : 0) | (block ? 0x20 : 0));
+}
+
+constexpr uint16_t pioPull(bool ifEmpty = false, bool block = true) {
+    return static_cast<uint16_t>(0x8080 | (ifEmpty ? 0x40 : 0) | (block ? 0x20 : 0));
+}
+
+constexpr uint16_t pioMov(PioMovDest destination, PioMovSource source, PioMovOp op = PioMovOp::NONE) {
+    return static_cast<uint16_t>(0xA000 | (static_cast<uint8_t>(destination) << 5) |
+                                 (static_cast<uint8_t>(op) << 3) | static_cast<uint8_t>(source));
+}
+
+constexpr uint16_t pioNop() {
+    return pioMov(PioMovDest::Y, PioMovSource::Y);
+}
+
+constexpr uint16_t pioIrq(bool clear, bool wait, uint8_t index) {
+    return static_cast<uint16_t>(0xC000 | (clear ? 0x40 : 0) | (wait ? 0x20 : 0) | (index & 0x1f));
+}
+
+/**
+ * @param value 0-31
+ */
+constexpr uint16_t pioSet(PioSetDest destination, uint8_t value) {
+    return static_cast<uint16_t>(0xE000 | (static_cast<uint8_t>(destination) << 5) | (value & 0x1f));
+}
+
+/**
+ * @brief An assembled PIO program
+ *
+ * Jump targets are program-relative; they are relocated when the program
+ * is loaded (not for instructions passed to PioStateMachine::exec()).
+ */
+class PioProgram {
+public:
+    /**
+     * @param sidesetBits Side-set pins driven by each instruction (0-5, including the enable bit if optional)
+     * @param sidesetOptional Side-set may be omitted per instruction (costs one bit)
+     * @throws std::invalid_argument if the side-set does not fit the 5-bit field
+     */
+    explicit PioProgram(uint8_t sidesetBits = 0, bool sidesetOptional = false);
+
+    /**
+     * @brief Append an instruction
+     * @param instruction From the pio* encoders
+     * @param delay Extra cycles after the instruction (up to maxDelay())
+     * @param sideset Side-set value, -1 for none (only allowed when optional)
+     * @return Address of the instruction
+     * @throws std::invalid_argument if the program is full, the delay is too
+     *         long, or the side-set value is missing or too wide
+     */
+    uint8_t add(uint16_t instruction, uint8_t delay = 0, int sideset = -1);
+
+    /**
+     * @brief Address the next add() will use
+     */
+    uint8_t here() const { return static_cast<uint8_t>(instructions_.size()); }
+
+    /**
+     * @brief Loop from @p wrap back to @p wrapTarget without a JMP (default: whole program)
+     */
+    void setWrap(uint8_t wrapTarget, uint8_t wrap);
+
+    /**
+     * @brief Require loading at @p origin (-1 = anywhere), e.g. for MOV PC jump tables
+     */
+    void setOrigin(int origin) { origin_ = origin; }
+
+    const std::vector<uint16_t>& instructions() const { return instructions_; }
+    size_t size() const { return instructions_.size(); }
+    int origin() const { return origin_; }
+    uint8_t wrapTarget() const { return wrapTarget_; }
+    uint8_t wrap() const;
+    uint8_t sidesetBits() const { return sidesetBits_; }
+    bool sidesetOptional() const { return sidesetOptional_; }
+
+    /**
+     * @brief Longest delay an instruction can carry
+     */
+    uint8_t maxDelay() const { return static_cast<uint8_t>((1u << delayBits()) - 1); }
+
+private:
+    unsigned delayBits() const { return 5u - sidesetBits_ - (sidesetOptional_ ? 1u : 0u); }
+
+    std::vector<uint16_t> instructions_;
+    uint8_t sidesetBits_;
+    bool sidesetOptional_;
+    int origin_ = -1;
+    uint8_t wrapTarget_ = 0;
+    int wrap_ = -1;                 ///< -1 = last instruction
+};
+
+/**
+ * @brief Pin mapping, shift and clock configuration of one state machine
+ *
+ * Pins set to -1 are not used. Output, set and side-set pins are switched
+ * to the PIO function and made outputs; input pins are switched and left
+ * as inputs.
+ */
+struct PioSmConfig {
+    int outBase = -1;              ///< First pin of OUT PINS
+    uint8_t outCount = 0;
+    int setBase = -1;              ///< First pin of SET PINS
+    uint8_t setCount = 0;
+    int sidesetBase = -1;          ///< First side-set pin (count comes from the program)
+    int inBase = -1;               ///< First pin of IN PINS / WAIT PIN
+    uint8_t inCount = 0;           ///< Input pins to route to the PIO
+    int jmpPin = -1;               ///< Pin tested by JMP PIN
+    uint32_t pinMask = 0;          ///< Limit the pins handed to the PIO (0 = all of the above)
+    bool inputPullUp = false;      ///< Enable the pull-ups of the input pins
+    bool outShiftRight = true;
+    bool autopull = false;
+    uint8_t pullThreshold = 32;
+    bool inShiftRight = true;
+    bool autopush = false;
+    uint8_t pushThreshold = 32;
+    PioFifoJoin fifoJoin = PioFifoJoin::NONE;
+    double clockHz = 0.0;          ///< Instruction clock (0 = the PIO clock, undivided)
+    bool enable = true;            ///< Start running in begin() (false: exec() setup first, then setEnabled())
+};
+
+/**
+ * @brief One claimed state machine running a loaded program
+ *
+ * @note Not thread-safe: one thread writes and one reads, or add a lock
+ */
+class PioStateMachine {
+public:
+    PioStateMachine();
+
+    /**
+     * @brief Calls end()
+     */
+    ~PioStateMachine();
+
+    PioStateMachine(const PioStateMachine&) = delete;
+    PioStateMachine& operator=(const PioStateMachine&) = delete;
+
+    /**
+     * @brief Whether PIO can be used here (Pi 5, /dev/pio0, built with piolib)
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Load @p program, claim a state machine, configure it and (unless
+     *        PioSmConfig::enable is false) start it
+     * @return false if PIO is unsupported, no state machine or instruction
+     *         space is free, or the configuration is invalid
+     */
+    bool begin(const PioProgram& program, const PioSmConfig& config);
+
+    /**
+     * @brief Stop the state machine, unload the program and release it
+     *
+     * @note Safe to call multiple times
+     */
+    void end();
+
+    bool isBegun() const { return impl_ != nullptr; }
+
+    /**
+     * @brief Queue one word, waiting for FIFO space
+     */
+    bool put(uint32_t word);
+
+    /**
+     * @brief Queue words through the kernel's DMA, waiting until all are accepted
+     */
+    bool write(const uint32_t* words, size_t count);
+
+    /**
+     * @brief Take one word, waiting for one to arrive
+     */
+    bool get(uint32_t& word);
+
+    /**
+     * @brief Take one word if the RX FIFO has one
+     */
+    bool tryGet(uint32_t& word);
+
+    /**
+     * @brief Whether the TX FIFO has drained
+     */
+    bool isTxEmpty() const;
+
+    /**
+     * @brief Execute one instruction immediately (jump targets are not relocated)
+     */
+    bool exec(uint16_t instruction);
+
+    /**
+     * @brief Start or pause the state machine (begin() starts it)
+     */
+    bool setEnabled(bool enabled);
+
+    /**
+     * @brief Drop queued words and restart the program from its first instruction
+     *
+     * Pins keep their levels; scratch and shift registers are cleared.
+     */
+    bool restart();
+
+    /**
+     * @brief Instruction memory address the program was loaded at
+     */
+    uint8_t getOffset() const;
+
+    /**
+     * @brief Instruction clock after rounding the divider (0 before begin())
+     */
+    double getClockHz() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief WS2812 bit encoder: one side-set pin, PIO_WS2812_CYCLES_PER_BIT cycles per bit
+ *
+ * Run at 800 kHz * PIO_WS2812_CYCLES_PER_BIT with the OSR shifting left
+ * and autopull at 24 (RGB) or 32 (RGBW) bits; each word carries one pixel
+ * in its top bits.
+ */
+PioProgram pioWs2812Program();
+
+/**
+ * @brief Quadrature counter: decodes A/B (consecutive pins, A first) into Y
+ *
+ * Every loop pushes the 32-bit count (non-blocking), so the RX FIFO always
+ * holds the latest values. Loaded at origin 0 (the decoder is a MOV PC
+ * jump table indexed by previous and current state).
+ */
+PioProgram pioQuadratureProgram();
+
+/**
+ * @brief Parallel output: @p width pins per sample, one sample per cycle
+ */
+PioProgram pioParallelOutputProgram(uint8_t width);
+
+/**
+ * @brief PWM on one side-set pin: duty via put(), period loaded into ISR with exec()
+ */
+PioProgram pioPwmProgram();
+
+/**
+ * @brief WaveSequencer player: per step, one word of pin levels then one delay word
+ *
+ * A step with delay word d holds for d + PIO_WAVE_STEP_CYCLES cycles.
+ */
+PioProgram pioWaveProgram();
+
+} // namespace pipinpp
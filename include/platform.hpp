@@ -10,6 +10,14 @@
  * This module enables PiPinPP to automatically adapt to different
  * platforms without requiring compile-time configuration.
  * 
+ * Detection is lazy: each capability is probed the first time something
+ * asks for it, so a program that only needs the platform model never
+ * enumerates /dev or /sys. With a cache file set, the whole result is
+ * stored keyed by boot ID, kernel release and effective user, and later
+ * processes load it instead of probing. Only a regular file the user owns
+ * and no one else can write is loaded, and the peripheral base (an mmap
+ * offset into /dev/mem) is never stored: it is derived from the model.
+ * 
  * Author: Barbatos6669
  * Date: November 16, 2025
  * Status: Phase 2 (Platform Expansion)
@@ -18,14 +26,25 @@
 #ifndef PIPINPP_PLATFORM_HPP
 #define PIPINPP_PLATFORM_HPP
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <cstdint>
 #include <stdexcept>
 
 namespace pipinpp {
 
+/**
+ * @brief Default platform cache file used by the pipinpp CLI
+ *
+ * In the caller's private runtime directory (see cache_file.hpp).
+ *
+ * @return The path, or an empty string if there is none (no caching)
+ */
+std::string platformDefaultCachePath();
+
 /**
  * @brief Enumeration of supported hardware platforms
  */
@@ -88,7 +107,9 @@ struct PlatformCapabilities {
  * @brief Main platform detection class
  * 
  * Singleton pattern - one instance per process.
- * Auto-detects platform on first access.
+ * Each capability is detected on first access and kept until refresh().
+ * Getters are thread-safe; refresh() must not race with readers that
+ * hold references returned by the getters.
  * 
  * @example
  * ```cpp
@@ -99,7 +120,7 @@ struct PlatformCapabilities {
  * }
  * 
  * // Check I2C availability
- * auto i2cBuses = platform.getCapabilities().i2cBuses;
+ * const auto& i2cBuses = platform.getI2CBuses();
  * for (const auto& bus : i2cBuses) {
  *     std::cout << "I2C bus " << bus.busNumber << ": " 
  *               << (bus.available ? "available" : "not available") << "\n";
@@ -118,7 +139,7 @@ public:
      * @brief Get detected platform
      * @return Platform enum value
      */
-    Platform getPlatform() const { return platform_; }
+    Platform getPlatform() const;
     
     /**
      * @brief Get platform name as string
@@ -129,14 +150,37 @@ public:
     /**
      * @brief Get platform capabilities
      * @return Struct with detected hardware capabilities
+     * @note Detects every capability; prefer the narrower getters below
+     *       when only one is needed
+     */
+    const PlatformCapabilities& getCapabilities() const;
+    
+    /**
+     * @brief GPIO chips (/dev/gpiochip*), detected on first call
+     */
+    const std::vector<GPIOChipInfo>& getGPIOChips() const;
+    
+    /**
+     * @brief I2C buses (/dev/i2c-*), detected on first call
      */
-    const PlatformCapabilities& getCapabilities() const { return capabilities_; }
+    const std::vector<I2CBusInfo>& getI2CBuses() const;
+    
+    /**
+     * @brief PWM channels (/sys/class/pwm), detected on first call
+     */
+    const std::vector<PWMChannelInfo>& getPWMChannels() const;
+    
+    /**
+     * @brief Peripheral base address for DMA/hardware access
+     * @return Base address, or 0 if DMA GPIO is not available
+     */
+    uint32_t getPeripheralBase() const;
     
     /**
      * @brief Check if platform is supported
      * @return true if platform is recognized and supported
      */
-    bool isSupported() const { return platform_ != Platform::UNKNOWN; }
+    bool isSupported() const { return getPlatform() != Platform::UNKNOWN; }
     
     /**
      * @brief Check if running on Raspberry Pi (any model)
@@ -148,13 +192,13 @@ public:
      * @brief Get kernel version
      * @return Kernel version string (e.g., "6.1.21")
      */
-    std::string getKernelVersion() const { return kernelVersion_; }
+    std::string getKernelVersion() const;
     
     /**
      * @brief Get libgpiod version
      * @return libgpiod version string (e.g., "2.2.1")
      */
-    std::string getLibgpiodVersion() const { return libgpiodVersion_; }
+    std::string getLibgpiodVersion() const;
     
     /**
      * @brief Get default GPIO chip name
@@ -193,9 +237,36 @@ public:
      * 
      * Normally not needed - detection happens once on first access.
      * Use this if hardware changes at runtime (hot-plug, etc.)
+     * Rewrites the cache file when one is set.
      */
     void refresh();
     
+    /**
+     * @brief Keep detection results in @p path (empty disables the cache)
+     * 
+     * The next capability that has not been detected yet is loaded from
+     * the file if it was written this boot, for this kernel release and
+     * effective user; otherwise everything is detected once and the file
+     * is (re)written. Capabilities already detected are kept.
+     * 
+     * @example
+     * ```cpp
+     * PlatformInfo::instance().setCachePath(pipinpp::platformDefaultCachePath());
+     * int bus = PlatformInfo::instance().getDefaultI2CBus();  // No probing when cached
+     * ```
+     */
+    void setCachePath(const std::string& path);
+    
+    /**
+     * @brief Current cache file (empty if caching is disabled)
+     */
+    std::string getCachePath() const;
+    
+    /**
+     * @brief Whether the current results were loaded from the cache file
+     */
+    bool isFromCache() const { return fromCache_.load(std::memory_order_acquire); }
+    
     // Delete copy/move constructors (singleton)
     PlatformInfo(const PlatformInfo&) = delete;
     PlatformInfo& operator=(const PlatformInfo&) = delete;
@@ -206,15 +277,32 @@ private:
     PlatformInfo();  // Private constructor (singleton)
     ~PlatformInfo() = default;
     
-    // Detection methods
-    void detectPlatform();
-    void detectCapabilities();
-    void detectGPIOChips();
-    void detectI2CBuses();
-    void detectPWMChannels();
-    void detectKernelVersion();
-    void detectLibgpiodVersion();
-    void detectDMASupport();
+    // Bits of detected_, one per lazily detected capability
+    enum DetectedBits : unsigned {
+        DETECTED_PLATFORM = 1u << 0,
+        DETECTED_KERNEL   = 1u << 1,
+        DETECTED_LIBGPIOD = 1u << 2,
+        DETECTED_GPIO     = 1u << 3,
+        DETECTED_I2C      = 1u << 4,
+        DETECTED_PWM      = 1u << 5,
+        DETECTED_DMA      = 1u << 6,
+        DETECTED_CACHED   = DETECTED_PLATFORM | DETECTED_GPIO | DETECTED_I2C |
+                            DETECTED_PWM | DETECTED_DMA,
+        DETECTED_ALL      = 0x7Fu
+    };
+    
+    // Detect whatever in `what` has not been detected yet
+    void ensure(unsigned what) const;
+    unsigned detectLocked(unsigned what, unsigned done) const;
+    
+    // Detection methods (called with mutex_ held)
+    void detectPlatform() const;
+    void detectGPIOChips() const;
+    void detectI2CBuses() const;
+    void detectPWMChannels() const;
+    void detectKernelVersion() const;
+    void detectLibgpiodVersion() const;
+    void detectDMASupport() const;
     
     // Helper methods
     std::string readFile(const std::string& path) const;
@@ -222,16 +310,41 @@ private:
     bool deviceExists(const std::string& path) const;
     Platform parseCPUInfo() const;
     Platform parseDeviceTree() const;
-    uint32_t getPeripheralBase() const;
+    static bool isRaspberryPiModel(Platform platform);
+    static uint32_t peripheralBaseFor(Platform platform);
     
-    // Member variables
-    Platform platform_;
-    PlatformCapabilities capabilities_;
-    std::string kernelVersion_;
-    std::string libgpiodVersion_;
-    bool detected_;  // Whether detection has run
+    // Detection results, filled in lazily by ensure()
+    mutable Platform platform_;
+    mutable PlatformCapabilities capabilities_;
+    mutable std::string kernelVersion_;
+    mutable std::string libgpiodVersion_;
+    
+    mutable std::mutex mutex_;                  // Serialises detection
+    mutable std::atomic<unsigned> detected_;    // DetectedBits already valid
+    mutable std::atomic<bool> fromCache_;
+    mutable bool cacheChecked_;                 // Cache file tried since setCachePath()
+    std::string cachePath_;
 };
 
+/**
+ * @brief Write detection results to a platform cache file (atomically replaced)
+ * @return false if the file could not be written
+ */
+bool savePlatformCache(const std::string& path, Platform platform,
+                       const PlatformCapabilities& capabilities);
+
+/**
+ * @brief Read a platform cache file
+ * @return false if it is missing, malformed, not a regular file owned by
+ *         the caller and writable only by them, or was written in another
+ *         boot, under another kernel release or by another user
+ *
+ * @note capabilities.peripheralBase is left 0; PlatformInfo derives it
+ *       from the platform model.
+ */
+bool loadPlatformCache(const std::string& path, Platform& platform,
+                       PlatformCapabilities& capabilities);
+
 /**
  * @brief Exception thrown when platform detection fails
  */
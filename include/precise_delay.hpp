@@ -0,0 +1,121 @@
+/**
+ * @file precise_delay.hpp
+ * @brief Calibrated sleep-then-spin delays against CLOCK_MONOTONIC deadlines
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Busy-waiting a whole delay keeps a core at 100% and still drifts when the
+ * thread is preempted; sleeping the whole delay is late by the kernel's
+ * wake-up latency (tens of µs without PREEMPT_RT, sometimes much more).
+ * These functions sleep with clock_nanosleep(TIMER_ABSTIME) until a
+ * calibrated margin before the deadline and spin only for that tail.
+ *
+ * The margin is how late clock_nanosleep() wakes up on this system.
+ * calibratePreciseDelay() measures it from a few short sleeps (call it at
+ * startup, after the thread's scheduling policy is set); after that every
+ * sleep measures its own wake-up and keeps the estimate current - it rises
+ * quickly after a late wake-up and decays slowly. Without an explicit
+ * calibration the margin starts at a conservative 100 µs and adapts the
+ * same way, so nothing blocks on first use.
+ *
+ * The spin polls the timebase counter (readCycleCounter()) instead of
+ * calling clock_gettime() per iteration: CNTVCT_EL0 on ARM64 (readable
+ * from user space on Linux), CLOCK_MONOTONIC elsewhere.
+ *
+ * Example usage:
+ * @code
+ * timespec next;
+ * clock_gettime(CLOCK_MONOTONIC, &next);
+ * for (;;) {
+ *     pipinpp::addNs(next, 250000);                 // 4 kHz loop, no drift
+ *     pipinpp::preciseSleepUntil(next);
+ *     sample();
+ * }
+ * pipinpp::calibratePreciseDelay();                 // Once at startup
+ * pipinpp::preciseDelayUs(500);                     // Sleeps most of it, spins the tail
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "timebase.hpp"
+#include <cstdint>
+#include <time.h>
+
+namespace pipinpp {
+
+/**
+ * @brief Smallest spin tail used after calibration (nanoseconds)
+ */
+constexpr int64_t PRECISE_DELAY_MIN_SPIN_NS = 5000;
+
+/**
+ * @brief Largest spin tail used after calibration (nanoseconds)
+ */
+constexpr int64_t PRECISE_DELAY_MAX_SPIN_NS = 2000000;
+
+/**
+ * @brief Result of measuring clock_nanosleep() wake-up latency
+ */
+struct PreciseDelayCalibration {
+    int64_t medianOvershootNs = 0;   ///< Typical lateness of a sleep (0 if never calibrated)
+    int64_t maxOvershootNs = 0;      ///< Worst lateness measured
+    int64_t spinNs = 0;              ///< Tail spun before each deadline
+    uint64_t counterHz = 0;          ///< Frequency of readCycleCounter()
+};
+
+/**
+ * @brief Advance a timespec by @p ns, keeping tv_nsec normalized
+ */
+inline void addNs(timespec& ts, int64_t ns) {
+    int64_t total = static_cast<int64_t>(ts.tv_nsec) + ns;
+    int64_t carry = total / 1000000000LL;
+    total %= 1000000000LL;
+    if (total < 0) {
+        total += 1000000000LL;
+        --carry;
+    }
+    ts.tv_sec += static_cast<time_t>(carry);
+    ts.tv_nsec = static_cast<long>(total);
+}
+
+/**
+ * @brief Measure wake-up latency and reset the spin tail from it
+ * @param samples Number of short sleeps measured
+ * @return The measured calibration
+ * @note Blocks for roughly samples * 200 µs
+ */
+PreciseDelayCalibration calibratePreciseDelay(int samples = 32);
+
+/**
+ * @brief Last calibratePreciseDelay() result with the spin tail in use now
+ */
+PreciseDelayCalibration getPreciseDelayCalibration();
+
+/**
+ * @brief Return at a CLOCK_MONOTONIC deadline, sleeping all but the spin tail
+ * @param deadlineNs Deadline in nanoseconds; returns immediately if passed
+ */
+void preciseSleepUntilNs(int64_t deadlineNs);
+
+/**
+ * @brief Return at a CLOCK_MONOTONIC deadline
+ */
+void preciseSleepUntil(const timespec& deadline);
+
+/**
+ * @brief Delay for @p ns from now
+ */
+void preciseDelayNs(uint64_t ns);
+
+/**
+ * @brief Delay for @p us from now (used by delayMicroseconds())
+ */
+inline void preciseDelayUs(uint32_t us) { preciseDelayNs(static_cast<uint64_t>(us) * 1000); }
+
+} // namespace pipinpp
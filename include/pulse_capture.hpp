@@ -0,0 +1,191 @@
+/**
+ * @file pulse_capture.hpp
+ * @brief Pulse width measurement from kernel edge timestamps
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Polling a pin in a loop (the old pulseIn()) keeps a core at 100% and its
+ * resolution is bounded by how fast digitalRead() can be called. Edge
+ * events carry a kernel timestamp taken in the GPIO interrupt handler, so
+ * subtracting two of them gives the pulse width regardless of when user
+ * space gets to run.
+ *
+ * - PulseTracker: turns an edge stream into completed pulses
+ * - PulseCapture: background capture on a pin through InterruptManager
+ *   (every pulse queued with its start time, e.g. for continuous ranging)
+ * - measurePulse(): Arduino pulseIn() semantics on a Pin that is already
+ *   requested as an input, blocking on its event fd (used by pulseIn())
+ *
+ * Example usage:
+ * @code
+ * // HC-SR04 echo on GPIO 24, trigger elsewhere
+ * pipinpp::PulseCapture echo(24);
+ * trigger();
+ * pipinpp::Pulse pulse;
+ * if (echo.waitPulse(true, 30000, pulse)) {
+ *     double cm = pulse.widthNs / 58000.0;
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "interrupts.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Pin;
+
+namespace pipinpp {
+
+/**
+ * @brief Default number of pulses PulseCapture queues
+ */
+constexpr size_t PULSE_CAPTURE_DEFAULT_CAPACITY = 64;
+
+/**
+ * @brief One complete pulse
+ */
+struct Pulse {
+    bool level = false;       ///< true for a HIGH pulse, false for LOW
+    uint64_t startNs = 0;     ///< Kernel timestamp of the edge that started it
+    uint64_t widthNs = 0;     ///< Time until the edge that ended it
+};
+
+/**
+ * @brief Edge stream to pulse state machine
+ *
+ * A pulse is the interval between two consecutive opposite edges. Two
+ * edges in the same direction mean one was lost (kernel buffer overflow);
+ * the tracker then restarts from the later edge instead of reporting a
+ * wrong width.
+ */
+class PulseTracker {
+public:
+    /**
+     * @brief Feed the next edge
+     * @param rising Edge direction
+     * @param timestampNs Edge timestamp
+     * @param[out] pulse Pulse ended by this edge
+     * @return true if @p pulse was filled
+     */
+    bool onEdge(bool rising, uint64_t timestampNs, Pulse& pulse);
+
+    /**
+     * @brief Forget the previous edge
+     */
+    void reset() { haveEdge_ = false; }
+
+private:
+    bool haveEdge_ = false;
+    bool level_ = false;      ///< Level after the previous edge
+    uint64_t lastNs_ = 0;
+};
+
+/**
+ * @brief Queue every pulse on a pin in the background
+ *
+ * Attaches a CHANGE batch interrupt on construction and detaches it on
+ * destruction. Pulses are decoded on the interrupt monitor thread and
+ * queued; when the queue is full the oldest pulse is dropped.
+ *
+ * The pin must not be requested elsewhere (no pinMode()/Pin on it); use
+ * measurePulse() for pins you already own.
+ *
+ * @note Thread-safe
+ */
+class PulseCapture {
+public:
+    /**
+     * @param pin GPIO pin number
+     * @param capacity Pulses kept until read
+     * @param chipname GPIO chip name
+     * @throws InvalidPinError if the pin or capacity is invalid
+     * @throws GpioAccessError if edge detection cannot be configured
+     */
+    explicit PulseCapture(int pin, size_t capacity = PULSE_CAPTURE_DEFAULT_CAPACITY,
+                          const std::string& chipname = "gpiochip0");
+    ~PulseCapture();
+
+    PulseCapture(const PulseCapture&) = delete;
+    PulseCapture& operator=(const PulseCapture&) = delete;
+
+    /**
+     * @brief Wait for the next queued pulse of a level, discarding others
+     * @param level true for HIGH pulses, false for LOW
+     * @param timeoutUs Longest wait in microseconds
+     * @param[out] pulse The pulse
+     * @return false on timeout
+     */
+    bool waitPulse(bool level, unsigned long timeoutUs, Pulse& pulse);
+
+    /**
+     * @brief Arduino-style: width of the next pulse that starts after this call
+     * @return Width in microseconds, or 0 on timeout
+     */
+    unsigned long pulseIn(bool level, unsigned long timeoutUs = 1000000);
+
+    /**
+     * @brief Take the oldest queued pulse
+     * @return false if none is queued
+     */
+    bool read(Pulse& pulse);
+
+    /**
+     * @brief Number of queued pulses
+     */
+    size_t available() const;
+
+    /**
+     * @brief Drop every queued pulse
+     */
+    void clear();
+
+    /**
+     * @brief Pulses dropped because the queue was full
+     */
+    uint64_t getDroppedCount() const;
+
+    int getPin() const { return pin_; }
+
+private:
+    void onEdges(EdgeEventSpan events);
+
+    int pin_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    PulseTracker tracker_;          ///< Only used on the monitor thread
+    std::vector<Pulse> queue_;      ///< Circular, capacity fixed at construction
+    size_t head_;                   ///< Index of the oldest pulse
+    size_t count_;
+    uint64_t dropped_;
+};
+
+/**
+ * @brief Measure one pulse on an input Pin from its edge timestamps
+ *
+ * Same semantics as Arduino pulseIn(): waits for an edge into @p level
+ * that happens after the call, then for the edge out of it, and returns
+ * the time between the two kernel timestamps. Blocks on the line
+ * request's fd, so no CPU is used while waiting.
+ *
+ * Enables edge events on @p pin (see Pin::enableEdgeEvents()) and leaves
+ * them enabled for the next call.
+ *
+ * @param pin Input pin
+ * @param level true for a HIGH pulse, false for LOW
+ * @param timeoutUs Deadline for the whole measurement in microseconds
+ * @return Width in microseconds, 0 on timeout, -1 if the pin cannot report edges
+ */
+long measurePulse(Pin& pin, bool level, unsigned long timeoutUs);
+
+} // namespace pipinpp
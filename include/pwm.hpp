@@ -39,8 +39,9 @@
  * - Smooth transitions and glitch-free operation
  *
  * ⚠️ CPU Usage Warning:
- * - Each PWM pin runs a busy-loop thread consuming ~10-30% CPU
- * - Uses std::this_thread::yield() to share CPU, but still busy-waits for accuracy
+ * - Each PWM pin runs a dedicated timing thread
+ * - Edges use absolute clock_nanosleep() deadlines with a short busy-wait tail
+ *   (see PwmEdgeClock), so frequency does not drift but CPU use is not zero
  * - Multiple PWM pins can cause significant CPU load
  * 
  * Limitations:
@@ -109,6 +110,79 @@ struct PWMChannel {
         : pin(p), dutyCycle(0), frequency(DEFAULT_PWM_FREQUENCY), active(false) {}
     
     ~PWMChannel();
+    
+    /**
+     * @brief Stop the thread, drive the pin LOW and release it
+     * @note Safe to call more than once
+     */
+    void stop();
+};
+
+class PWMManager;
+
+/**
+ * @brief Lock-free handle to one active PWMManager channel
+ * 
+ * Duty cycle and frequency updates are single relaxed atomic stores that
+ * the channel's thread picks up at its next cycle, so a control loop can
+ * update many channels without touching PWMManager's mutex. The handle
+ * keeps the channel's state alive; once the channel is stopped (stopPWM(),
+ * or the manager shutting down) updates return false.
+ * 
+ * @code
+ * PWMManager::getInstance().startPWM(17, 0);
+ * PWMChannelHandle led = PWMManager::getInstance().channel(17);
+ * for (int i = 0; i < 1000; ++i) {
+ *     led.setDutyCycle(i % 256);     // No lock, no map lookup
+ *     delay(1);
+ * }
+ * @endcode
+ */
+class PWMChannelHandle {
+public:
+    /**
+     * @brief Handle to no channel
+     */
+    PWMChannelHandle() = default;
+    
+    /**
+     * @brief Whether the handle refers to a channel that is still running
+     */
+    bool isActive() const { return channel_ && channel_->active.load(std::memory_order_relaxed); }
+    explicit operator bool() const { return isActive(); }
+    
+    /**
+     * @brief Set the duty cycle (clamped to 0-255)
+     * @return false if the channel is stopped
+     */
+    bool setDutyCycle(int dutyCycle);
+    
+    /**
+     * @brief Set the frequency (clamped to MIN_PWM_FREQUENCY-MAX_PWM_FREQUENCY)
+     * @return false if the channel is stopped
+     */
+    bool setFrequency(int frequency);
+    
+    /**
+     * @return Duty cycle (0-255), or -1 if the channel is stopped
+     */
+    int getDutyCycle() const;
+    
+    /**
+     * @return Frequency in Hz, or -1 if the channel is stopped
+     */
+    int getFrequency() const;
+    
+    /**
+     * @return GPIO pin number, or -1 for an empty handle
+     */
+    int getPin() const { return channel_ ? channel_->pin : -1; }
+    
+private:
+    friend class PWMManager;
+    explicit PWMChannelHandle(std::shared_ptr<PWMChannel> channel) : channel_(std::move(channel)) {}
+    
+    std::shared_ptr<PWMChannel> channel_;
 };
 
 /**
@@ -141,7 +215,7 @@ public:
      * @throws GpioAccessError if unable to configure pin
      * 
      * @note If PWM is already active on this pin, duty cycle is updated
-     * @note Frequency can only be changed by stopping and restarting PWM
+     * @note Frequency of an active pin changes through channel(pin).setFrequency()
      * @note Pin is automatically configured as OUTPUT
      */
     void startPWM(int pin, int dutyCycle, int frequency = DEFAULT_PWM_FREQUENCY);
@@ -200,6 +274,17 @@ public:
      */
     int getFrequency(int pin) const;
     
+    /**
+     * @brief Lock-free handle for frequent updates of one channel
+     * 
+     * @param pin GPIO pin number
+     * @return Handle to the active channel, or an empty handle if PWM is
+     *         not active on this pin
+     * 
+     * @note Takes the manager mutex once; the handle's updates never do
+     */
+    PWMChannelHandle channel(int pin) const;
+    
     // Prevent copying
     PWMManager(const PWMManager&) = delete;
     PWMManager& operator=(const PWMManager&) = delete;
@@ -211,8 +296,8 @@ private:
     /**
      * @brief PWM generation thread function
      * 
-     * Generates PWM pulses by rapidly toggling the pin state.
-     * Uses high-resolution timing for accurate pulse width.
+     * Generates PWM pulses by toggling the pin state at integer nanosecond
+     * deadlines that are recomputed only when duty or frequency change.
      * 
      * @param channel Pointer to the PWM channel to manage
      */
@@ -232,6 +317,6 @@ private:
      */
     static int validateFrequency(int frequency);
     
-    std::map<int, std::unique_ptr<PWMChannel>> channels_; ///< Active PWM channels
-    mutable std::mutex mutex_;                             ///< Protects channels_ map
+    std::map<int, std::shared_ptr<PWMChannel>> channels_; ///< Active PWM channels (shared with handles)
+    mutable std::mutex mutex_;                             ///< Protects channels_ map (create/destroy only)
 };
@@ -0,0 +1,160 @@
+/**
+ * @file pwm_backend.hpp
+ * @brief Per-pin PWM backend selection behind analogWrite() and tone()
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * The library has four ways to produce PWM, each best for different pins
+ * and loads. PwmRouter picks one per pin so Arduino-style code gets the
+ * cheapest backend available without naming it:
+ *
+ * 1. HARDWARE - HardwarePWM, when PlatformInfo reports a usable sysfs PWM
+ *    channel mapped to the pin and no other pin uses that channel
+ * 2. DMA - DmaSoftPWM, when the application has begun it and the caller
+ *    accepts its fixed cycle (analogWrite(), not tone())
+ * 3. EVENT - EventPWMManager: every pin on one shared timer thread
+ *    (50-10000 Hz)
+ * 4. SOFTWARE - PWMManager, one thread per pin; only for frequencies
+ *    EVENT cannot produce
+ *
+ * A pin keeps its backend while the frequency stays the same, so repeated
+ * analogWrite() calls only update the duty cycle. setPreferredBackend()
+ * forces one backend where the pin allows it (e.g. SOFTWARE to reproduce
+ * old behaviour).
+ *
+ * Example usage:
+ * @code
+ * auto& router = pipinpp::PwmRouter::getInstance();
+ * router.write(18, 128);                     // HARDWARE on a Pi with the PWM overlay
+ * router.write(17, 64);                      // EVENT (shared thread)
+ * std::cout << pipinpp::pwmBackendName(router.getBackend(17)) << "\n";
+ * router.stop(17);
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace pipinpp {
+
+class HardwarePWM;
+
+/**
+ * @brief PWM generator driving a pin
+ */
+enum class PwmBackend {
+    AUTO,       ///< Choose per pin (also returned for pins without PWM)
+    HARDWARE,   ///< HardwarePWM (sysfs PWM channel, zero CPU)
+    DMA,        ///< DmaSoftPWM (DMA-timed, any pin, fixed cycle)
+    EVENT,      ///< EventPWMManager (one shared timer thread)
+    SOFTWARE    ///< PWMManager (one thread per pin)
+};
+
+/**
+ * @brief Lower-case name of a backend ("auto", "hardware", ...)
+ */
+const char* pwmBackendName(PwmBackend backend);
+
+/**
+ * @brief Routes per-pin PWM requests to the best available backend
+ *
+ * @note Singleton; thread-safe
+ */
+class PwmRouter {
+public:
+    static PwmRouter& getInstance();
+
+    /**
+     * @brief Force a backend for new routes (AUTO = choose per pin)
+     *
+     * A forced backend that cannot serve a pin (no hardware channel, DMA
+     * not begun, frequency out of range) falls back to automatic choice.
+     */
+    void setPreferredBackend(PwmBackend backend);
+    PwmBackend getPreferredBackend() const;
+
+    /**
+     * @brief Backend a new route for @p pin would use now
+     * @param pin GPIO pin number (0-27)
+     * @param frequencyHz Required frequency (0 = any, 490 Hz where selectable)
+     */
+    PwmBackend select(int pin, int frequencyHz = 0) const;
+
+    /**
+     * @brief Start or update PWM on a pin
+     * @param pin GPIO pin number (0-27)
+     * @param value 8-bit duty cycle (clamped to 0-255)
+     * @param frequencyHz Required frequency (0 = any)
+     * @return Backend now driving the pin
+     * @throws InvalidPinError if the pin number is invalid
+     * @throws GpioAccessError if no backend can drive the pin
+     */
+    PwmBackend write(int pin, int value, int frequencyHz = 0);
+
+    /**
+     * @brief Stop PWM on a pin (driven LOW)
+     * @return false if the pin had no PWM
+     */
+    bool stop(int pin);
+
+    /**
+     * @brief Backend driving a pin (AUTO if none)
+     */
+    PwmBackend getBackend(int pin) const;
+
+    bool isActive(int pin) const { return getBackend(pin) != PwmBackend::AUTO; }
+
+    size_t getActiveCount() const;
+
+private:
+    PwmRouter();
+    ~PwmRouter();
+
+    PwmRouter(const PwmRouter&) = delete;
+    PwmRouter& operator=(const PwmRouter&) = delete;
+
+    struct Route {
+        PwmBackend backend;
+        int frequencyHz;                        ///< Requested frequency (0 = any)
+        int hardwareChannel;                    ///< chip * 256 + channel for HARDWARE, else -1
+        std::unique_ptr<HardwarePWM> hardware;
+    };
+
+    /**
+     * @brief sysfs channel mapped to @p pin and not used by another pin
+     * @return chip * 256 + channel, or -1
+     * @note Caller must hold mutex_
+     */
+    int freeHardwareChannel(int pin) const;
+
+    /**
+     * @note Caller must hold mutex_
+     */
+    PwmBackend selectLocked(int pin, int frequencyHz) const;
+
+    /**
+     * @brief Start a route on @p backend
+     * @return false if the backend refused the pin
+     * @note Caller must hold mutex_
+     */
+    bool start(Route& route, int pin, int value, int frequencyHz);
+
+    /**
+     * @note Caller must hold mutex_
+     */
+    void stopRoute(Route& route, int pin);
+
+    mutable std::mutex mutex_;
+    PwmBackend preferred_;
+    std::map<int, Route> routes_;
+};
+
+} // namespace pipinpp
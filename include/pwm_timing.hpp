@@ -0,0 +1,146 @@
+/**
+ * @file pwm_timing.hpp
+ * @brief Integer nanosecond edge scheduling for software PWM
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Software PWM threads used to recompute period and on-time every cycle
+ * (in double or long math) and measure each wait relative to "now", so
+ * scheduling delays accumulated into frequency error. This engine keeps:
+ * - PwmTiming: period and on-time in integer nanoseconds, recomputed only
+ *   when the duty cycle or frequency actually changes
+ * - PwmEdgeClock: an absolute CLOCK_MONOTONIC cycle start that advances by
+ *   exactly one period per cycle; waits use clock_nanosleep(TIMER_ABSTIME)
+ *   with an optional busy-wait tail, so lateness never carries over into
+ *   the next cycle
+ *
+ * Example usage:
+ * @code
+ * pipinpp::PwmEdgeClock clock(100000);    // Spin the last 100 µs
+ * auto timing = pipinpp::PwmTiming::fromDuty8Bit(1000, 64);
+ * clock.restart();
+ * while (active) {
+ *     pin.write(true);
+ *     clock.waitUntil(timing.onNs, active);
+ *     pin.write(false);
+ *     clock.waitUntil(timing.periodNs, active);
+ *     clock.nextCycle(timing.periodNs);
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <time.h>
+
+namespace pipinpp {
+
+/**
+ * @brief Default busy-wait tail before each edge (nanoseconds)
+ */
+constexpr int64_t PWM_SPIN_THRESHOLD_NS = 100000;
+
+/**
+ * @brief Longest single sleep, so a stop request is noticed promptly (nanoseconds)
+ */
+constexpr int64_t PWM_MAX_SLEEP_SLICE_NS = 10000000;
+
+/**
+ * @brief One PWM cycle in integer nanoseconds
+ */
+struct PwmTiming {
+    int64_t periodNs = 0;   ///< Full cycle length
+    int64_t onNs = 0;       ///< HIGH time from cycle start
+
+    /**
+     * @brief Output is constantly LOW
+     */
+    bool alwaysLow() const { return onNs <= 0; }
+
+    /**
+     * @brief Output is constantly HIGH
+     */
+    bool alwaysHigh() const { return onNs >= periodNs; }
+
+    /**
+     * @brief Timing for an 8-bit duty cycle (Arduino analogWrite() scale)
+     * @param frequencyHz Frequency in Hz (> 0)
+     * @param duty 0-255
+     */
+    static PwmTiming fromDuty8Bit(int frequencyHz, int duty);
+
+    /**
+     * @brief Timing for a percentage duty cycle
+     * @param frequencyHz Frequency in Hz (> 0)
+     * @param dutyPercent 0.0-100.0
+     */
+    static PwmTiming fromPercent(double frequencyHz, double dutyPercent);
+};
+
+/**
+ * @brief Absolute-deadline clock for one PWM output
+ *
+ * Deadlines are expressed as offsets from the current cycle start, which
+ * advances by whole periods, so the long-run frequency is exact no matter
+ * how late individual wakeups are.
+ */
+class PwmEdgeClock {
+public:
+    /**
+     * @param spinNs Busy-wait this long before each deadline (0 = sleep only)
+     */
+    explicit PwmEdgeClock(int64_t spinNs = PWM_SPIN_THRESHOLD_NS);
+
+    /**
+     * @brief Start a new cycle now
+     */
+    void restart();
+
+    /**
+     * @brief Wait until cycle start + @p offsetNs
+     * @param offsetNs Offset from the current cycle start
+     * @param active Abort the wait when this becomes false
+     * @return Value of @p active when the wait ended
+     */
+    bool waitUntil(int64_t offsetNs, const std::atomic<bool>& active) const;
+
+    /**
+     * @brief Advance the cycle start by one period
+     *
+     * If the thread fell more than a full period behind (e.g. it was
+     * preempted), the cycle restarts now instead of emitting a burst of
+     * catch-up pulses.
+     */
+    void nextCycle(int64_t periodNs);
+
+    /**
+     * @brief Current cycle start (CLOCK_MONOTONIC)
+     */
+    const timespec& cycleStart() const { return cycleStart_; }
+
+private:
+    static int64_t toNs(const timespec& ts) {
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    static timespec fromNs(int64_t ns) {
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+        return ts;
+    }
+
+    static int64_t nowNs();
+
+    timespec cycleStart_;
+    int64_t spinNs_;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,291 @@
+/**
+ * @file quadrature_encoder.hpp
+ * @brief Quadrature encoder decoding from one two-line edge request
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Counting an encoder with two attachInterrupt() callbacks that each call
+ * digitalRead() on the other channel is racy: by the time a callback runs
+ * the other line may have moved again, and the two callbacks can run in
+ * either order. Here both channels are requested in a single line request
+ * with edge detection on both lines, so the kernel delivers one ordered,
+ * timestamped event stream and the channel levels are known from the event
+ * types alone - nothing is read back from the pins.
+ *
+ * - QuadratureDecoder: state-table (x4) decoder fed with edge events;
+ *   usable on its own with recorded events
+ * - QuadratureEncoder: owns the line request and a decoding thread, and
+ *   publishes position and velocity through atomics
+ *
+ * Lost events are detected from gaps in the request's global sequence
+ * number, and transitions the state table rejects are counted separately.
+ *
+ * Example usage:
+ * @code
+ * pipinpp::QuadratureEncoder knob(5, 6);          // A on GPIO 5, B on GPIO 6
+ * for (;;) {
+ *     int64_t position = knob.read();             // One atomic load
+ *     double speed = knob.getVelocity();          // Counts per second
+ *     if (knob.getMissedCount() > 0) { ... }
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "interrupts.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct gpiod_line_request;
+struct gpiod_edge_event_buffer;
+
+namespace pipinpp {
+
+class GpioChip;
+class PioStateMachine;
+
+/**
+ * @brief Default window over which velocity is averaged (10 ms)
+ */
+constexpr uint64_t QUADRATURE_DEFAULT_VELOCITY_WINDOW_NS = 10000000;
+
+/**
+ * @brief QuadratureDecoder::transition() result for an impossible transition
+ */
+constexpr int QUADRATURE_INVALID_TRANSITION = 2;
+
+/**
+ * @brief Interval at which the PIO counter is read (microseconds)
+ */
+constexpr uint32_t QUADRATURE_PIO_POLL_US = 1000;
+
+/**
+ * @brief Edge stream to position/velocity decoder
+ *
+ * The state is (A << 1) | B. Every edge on either channel is one count
+ * (x4 resolution); A leading B counts up. An edge that leaves its channel
+ * at the level it already had means the opposite edge was lost, and is
+ * counted as invalid without moving the position.
+ *
+ * Velocity is the net count change over the last complete window divided
+ * by its duration, so it is zero-mean for a shaft that only jitters
+ * across one edge.
+ */
+class QuadratureDecoder {
+public:
+    /**
+     * @param pinA Line offset of channel A
+     * @param pinB Line offset of channel B
+     * @param velocityWindowNs Shortest interval a velocity estimate covers
+     */
+    QuadratureDecoder(int pinA, int pinB,
+                      uint64_t velocityWindowNs = QUADRATURE_DEFAULT_VELOCITY_WINDOW_NS);
+
+    /**
+     * @brief Set the channel levels the next event starts from
+     * @param state (A << 1) | B
+     */
+    void setState(uint8_t state) { state_ = state & 0x3; }
+
+    /**
+     * @brief Account for one edge (events must be in kernel order)
+     * @return Position change: -1, 0 or +1
+     */
+    int onEdge(const EdgeEvent& event);
+
+    /**
+     * @brief Account for a net count change from a hardware counter (PIO)
+     * @param steps Counts since the last call (0 = no movement)
+     * @param timestampNs When the change was observed
+     */
+    void onSteps(int64_t steps, uint64_t timestampNs);
+
+    /**
+     * @brief Overwrite the position (velocity and counters are kept)
+     */
+    void setPosition(int64_t position);
+
+    /**
+     * @brief Position, velocity and all counters back to zero
+     */
+    void reset();
+
+    /**
+     * @brief Set the velocity averaging window
+     */
+    void setVelocityWindow(uint64_t windowNs) { windowNs_ = windowNs; }
+
+    int64_t position() const { return position_; }
+    uint8_t state() const { return state_; }
+    uint64_t invalidCount() const { return invalid_; }
+    uint64_t missedCount() const { return missed_; }
+    uint64_t lastStepNs() const { return lastStepNs_; }
+    uint64_t velocityWindow() const { return windowNs_; }
+
+    /**
+     * @brief Latest velocity estimate in counts per second
+     */
+    double velocity() const { return velocity_; }
+
+    /**
+     * @brief Velocity as of @p nowNs
+     *
+     * With no count for longer than the window the shaft has slowed to at
+     * most one count per elapsed time, so the estimate is bounded by that
+     * and decays to zero when it stops.
+     */
+    double velocity(uint64_t nowNs) const;
+
+    /**
+     * @brief Apply the decay used by velocity(nowNs) to published values
+     */
+    static double decayVelocity(double velocity, uint64_t lastStepNs, uint64_t nowNs, uint64_t windowNs);
+
+    /**
+     * @brief State-table lookup
+     * @param from Previous (A << 1) | B
+     * @param to New (A << 1) | B
+     * @return -1, 0, +1 or QUADRATURE_INVALID_TRANSITION when both channels changed
+     */
+    static int transition(uint8_t from, uint8_t to);
+
+private:
+    int pinA_;
+    int pinB_;
+    uint64_t windowNs_;
+    uint8_t state_ = 0;
+    int64_t position_ = 0;
+    uint64_t invalid_ = 0;
+    uint64_t missed_ = 0;
+    bool haveSeqno_ = false;
+    unsigned long lastSeqno_ = 0;
+    bool haveStep_ = false;
+    uint64_t lastStepNs_ = 0;
+    uint64_t windowStartNs_ = 0;
+    int64_t windowStartPosition_ = 0;
+    double velocity_ = 0.0;
+};
+
+/**
+ * @brief Two-channel quadrature encoder on GPIO
+ *
+ * Requests both lines as inputs with edge detection on both edges in one
+ * line request and decodes them on a dedicated thread (named
+ * "pipinpp-encoder", subject to ThreadPolicyManager). read() is a single
+ * relaxed atomic load and never blocks the decoding thread.
+ *
+ * On a Raspberry Pi 5 with PIO (pio.hpp) and the channels on adjacent
+ * pins, a PIO state machine counts instead (pioQuadratureProgram()): it
+ * samples the pins every few tens of nanoseconds, so no edge is lost at
+ * any shaft speed and the thread only reads the count every
+ * QUADRATURE_PIO_POLL_US. Impossible transitions are ignored there, so
+ * getInvalidCount() and getMissedCount() stay 0; see usesPio().
+ *
+ * The pins must not be requested elsewhere (no pinMode()/Pin or
+ * attachInterrupt() on them).
+ *
+ * @note Thread-safe
+ */
+class QuadratureEncoder {
+public:
+    /**
+     * @param pinA Channel A GPIO pin
+     * @param pinB Channel B GPIO pin
+     * @param pullUp Enable the internal pull-ups (open-collector encoders)
+     * @param bufferSize Events read per wakeup and kernel event queue length
+     * @param chipname GPIO chip name
+     * @throws InvalidPinError if a pin is invalid or both are the same
+     * @throws GpioAccessError if the lines cannot be requested
+     */
+    QuadratureEncoder(int pinA, int pinB, bool pullUp = true,
+                      size_t bufferSize = DEFAULT_EVENT_BUFFER_SIZE * 4,
+                      const std::string& chipname = "gpiochip0");
+    ~QuadratureEncoder();
+
+    QuadratureEncoder(const QuadratureEncoder&) = delete;
+    QuadratureEncoder& operator=(const QuadratureEncoder&) = delete;
+
+    /**
+     * @brief Current position in counts (4 per encoder cycle)
+     */
+    int64_t read() const { return position_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Overwrite the position, e.g. 0 at a homing switch
+     */
+    void write(int64_t position);
+
+    /**
+     * @brief Clear position, velocity and error counters
+     */
+    void reset();
+
+    /**
+     * @brief Velocity in counts per second, decaying to 0 when stopped
+     */
+    double getVelocity() const;
+
+    /**
+     * @brief Set the velocity averaging window in microseconds
+     */
+    void setVelocityWindow(uint32_t windowUs);
+
+    /**
+     * @brief Events the kernel dropped (sequence number gaps)
+     */
+    uint64_t getMissedCount() const { return missed_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Edges rejected by the state table
+     */
+    uint64_t getInvalidCount() const { return invalid_.load(std::memory_order_relaxed); }
+
+    int getPinA() const { return pinA_; }
+    int getPinB() const { return pinB_; }
+
+    /**
+     * @brief Whether a PIO state machine does the counting
+     */
+    bool usesPio() const { return pio_ != nullptr; }
+
+private:
+    bool beginPio(bool pullUp);
+    void decodeLoop();
+    void pioLoop();
+    void publishLocked();
+
+    int pinA_;
+    int pinB_;
+    std::shared_ptr<GpioChip> chip_;
+    gpiod_line_request* request_;
+    gpiod_edge_event_buffer* eventBuffer_;
+    int wakeupFd_;
+    std::thread thread_;
+    std::atomic<bool> stopping_;
+    std::unique_ptr<PioStateMachine> pio_;
+    int pioSign_;                            ///< -1 when B is the lower pin
+    uint32_t pioCount_;                      ///< Last raw 32-bit count read
+
+    std::mutex mutex_;                       ///< Guards decoder_ (uncontended unless written)
+    QuadratureDecoder decoder_;
+
+    std::atomic<int64_t> position_;
+    std::atomic<double> velocity_;
+    std::atomic<uint64_t> lastStepNs_;
+    std::atomic<uint64_t> windowNs_;
+    std::atomic<uint64_t> missed_;
+    std::atomic<uint64_t> invalid_;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,188 @@
+/**
+ * @file register_map.hpp
+ * @brief Cached register image of an I2C device with batched dirty-range writes
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Device drivers usually configure a chip with a string of writeRegister()
+ * calls and change single bitfields with a read, a modify and a write:
+ * every one of them is a separate bus transaction. RegisterMap keeps a
+ * local copy of the device's registers instead:
+ * - set()/update() change the copy and mark the register dirty; a
+ *   bitfield update only reads the device if the register is not cached
+ * - flush() coalesces dirty registers into contiguous runs and sends each
+ *   run as one auto-increment block write, all runs in one WireBatch
+ *   (one I2C_RDWR ioctl)
+ * - read() answers from the copy; registers marked volatile (status,
+ *   data, FIFO) are always read from the device and never cached
+ *
+ * Runs separated by a few clean, cached registers can be merged by
+ * rewriting those registers with their cached value (setMergeGap()),
+ * trading a few bytes for a transaction.
+ *
+ * Devices that need a flag in the register address to auto-increment
+ * (e.g. bit 7 on ST sensors) set it with setAutoIncrementFlag(). Devices
+ * that do not auto-increment on writes at all (e.g. the BMP280, which
+ * takes register/value pairs) must not be flushed; write their registers
+ * one at a time.
+ *
+ * Example usage:
+ * @code
+ * #include "register_map.hpp"
+ *
+ * Wire.begin();
+ * pipinpp::RegisterMap mpu6050(0x68);
+ * mpu6050.setVolatile(0x3A);                // INT_STATUS
+ * mpu6050.setVolatile(0x3B, 14);            // accel, temperature, gyro data
+ * mpu6050.load(0x19, 4);                    // SMPLRT_DIV .. ACCEL_CONFIG
+ * mpu6050.set(0x19, 9);                     // 100 Hz sample rate (no bus access)
+ * mpu6050.update(0x1A, 0x07, 0x03);         // 44 Hz low-pass filter
+ * mpu6050.update(0x1B, 0x18, 0x08);         // gyro +-500 deg/s
+ * mpu6050.update(0x1C, 0x18, 0x10);         // accel +-8 g
+ * mpu6050.flush();                          // One 4-byte block write
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "Wire.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @brief Local image of one I2C device's 8-bit register file
+ *
+ * @note Not thread-safe; one RegisterMap per device, used from one thread
+ *       (the WireClass underneath is thread-safe)
+ */
+class RegisterMap {
+public:
+    /**
+     * @param address 7-bit I2C address
+     * @param size Number of registers (addresses 0 .. size-1, at most 256)
+     * @param wire Bus the device is on (must be begun by the caller)
+     */
+    explicit RegisterMap(uint8_t address, size_t size = 256, WireClass& wire = Wire);
+
+    /**
+     * @brief Mark registers whose value the device changes on its own
+     *
+     * Volatile registers are read from the device on every read() and
+     * their cached value is dropped. Writes to them are still batched.
+     */
+    void setVolatile(uint8_t first, size_t count = 1, bool isVolatile = true);
+
+    bool isVolatile(uint8_t reg) const;
+
+    /**
+     * @brief Read registers from the device into the cache (one block read)
+     * @return false on a bus error or a range outside the map
+     */
+    bool load(uint8_t first, size_t count);
+
+    /**
+     * @brief Forget cached values (the next read goes to the device)
+     */
+    void invalidate(uint8_t first = 0, size_t count = 256);
+
+    /**
+     * @brief Set a register in the cache; marked dirty only if it changes
+     *
+     * A register not cached yet is always marked dirty.
+     */
+    void set(uint8_t reg, uint8_t value);
+
+    /**
+     * @brief Set consecutive registers in the cache
+     */
+    void set(uint8_t first, const uint8_t* data, size_t length);
+
+    /**
+     * @brief Read-modify-write of the bits in @p mask
+     *
+     * Reads the device only if the register is not cached (or volatile).
+     *
+     * @return false if that read failed
+     */
+    bool update(uint8_t reg, uint8_t mask, uint8_t value);
+
+    /**
+     * @brief Register value, from the cache unless volatile or not cached
+     * @return 0-255, -1 on a bus error
+     */
+    int read(uint8_t reg);
+
+    /**
+     * @brief Consecutive registers; one block read if any is volatile or not cached
+     */
+    bool read(uint8_t first, uint8_t* buffer, size_t length);
+
+    /**
+     * @brief Write every dirty register in as few block writes as possible
+     *
+     * All runs go out in one WireBatch. Registers of runs that failed stay
+     * dirty, so flush() can simply be called again.
+     *
+     * @return true if nothing was dirty or every run was written
+     */
+    bool flush();
+
+    /**
+     * @brief Number of dirty registers
+     */
+    size_t dirtyCount() const;
+
+    bool isDirty(uint8_t reg) const;
+
+    /**
+     * @brief Merge dirty runs separated by at most @p gap clean registers
+     *
+     * The gap registers are rewritten with their cached value, so only
+     * cached, non-volatile gaps are merged. Default 0 (no merging).
+     */
+    void setMergeGap(size_t gap) { mergeGap_ = gap; }
+
+    /**
+     * @brief OR'ed into the register address of multi-byte transfers
+     */
+    void setAutoIncrementFlag(uint8_t flag) { autoIncrementFlag_ = flag; }
+
+    /**
+     * @brief I2C transactions issued so far (each block read or write counts once)
+     */
+    uint64_t getTransactions() const { return transactions_; }
+
+    uint8_t getAddress() const { return address_; }
+    size_t size() const { return values_.size(); }
+
+private:
+    enum Flags : uint8_t {
+        VALID = 0x01,
+        DIRTY = 0x02,
+        VOLATILE = 0x04
+    };
+
+    bool inRange(size_t first, size_t count) const { return count > 0 && first + count <= values_.size(); }
+    uint8_t blockRegister(uint8_t first, size_t length) const {
+        return length > 1 ? static_cast<uint8_t>(first | autoIncrementFlag_) : first;
+    }
+    bool fetch(uint8_t first, size_t count, uint8_t* buffer);
+
+    WireClass& wire_;
+    uint8_t address_;
+    std::vector<uint8_t> values_;
+    std::vector<uint8_t> flags_;
+    size_t mergeGap_;
+    uint8_t autoIncrementFlag_;
+    uint64_t transactions_;
+};
+
+} // namespace pipinpp
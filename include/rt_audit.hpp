@@ -0,0 +1,165 @@
+/**
+ * @file rt_audit.hpp
+ * @brief Debug audit of heap allocations and mutex locks on real-time threads
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * A thread running under SCHED_FIFO only meets its deadlines if it never
+ * waits on the allocator or on a lock another thread holds, and nothing
+ * in the API says which library calls do. Configure with
+ * -DPIPINPP_ENABLE_RT_AUDIT=ON to find out: the library then interposes
+ * malloc()/calloc()/realloc()/aligned_alloc()/posix_memalign() and
+ * pthread_mutex_lock(), and every call made on a thread marked real-time
+ * is recorded as a violation together with the stack that made it.
+ *
+ * Threads are marked:
+ * - automatically, for every PiPinPP-owned thread (interrupt monitor, PWM,
+ *   UART, SPI, callback workers...) once its ThreadPolicy is applied
+ * - by the application, with markCurrentThread() or a ScopedRealtime
+ *   around the time-critical part of its own loop
+ *
+ * Violations are aggregated per call stack in a fixed table, so recording
+ * one never allocates. The totals are also published as the
+ * rt_audit_allocations, rt_audit_locks and rt_audit_lock_waits counters
+ * of the metrics API (lock_waits: the mutex was held by another thread).
+ * violations() and report() resolve the stacks to symbols; call them
+ * from a normal thread. Link the application with -rdynamic to get names
+ * for its own functions.
+ *
+ * The interposition costs a thread-local check per malloc and lock in
+ * every thread, so this is a debugging build, not a production one.
+ * Without the option every function here is a no-op and violations()
+ * is always empty.
+ *
+ * Example usage:
+ * @code
+ * // Build with -DPIPINPP_ENABLE_RT_AUDIT=ON, then:
+ * while (running) {
+ *     pipinpp::rt_audit::ScopedRealtime rt("control");
+ *     controlStep();                       // Everything in here is audited
+ * }
+ * std::cerr << pipinpp::rt_audit::report();
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pipinpp {
+namespace rt_audit {
+
+/**
+ * @brief Stack frames kept per violation
+ */
+constexpr size_t RT_AUDIT_MAX_FRAMES = 8;
+
+/**
+ * @brief Distinct call stacks recorded before further ones are only counted
+ */
+constexpr size_t RT_AUDIT_MAX_SITES = 512;
+
+/**
+ * @brief What a real-time thread did
+ */
+enum class ViolationKind {
+    ALLOCATION,   ///< Heap allocation (may take the allocator lock or fault in pages)
+    LOCK,         ///< pthread_mutex_lock() on a free mutex
+    LOCK_WAIT     ///< pthread_mutex_lock() that had to wait for another thread
+};
+
+/**
+ * @brief One call stack that violated real-time rules, and how often
+ */
+struct Violation {
+    ViolationKind kind = ViolationKind::ALLOCATION;
+    uint64_t count = 0;                 ///< Times this stack did it
+    std::string thread;                 ///< Name of the first thread seen doing it
+    std::vector<void*> stack;           ///< Return addresses, innermost first
+    std::vector<std::string> symbols;   ///< Demangled stack, "module+offset" if unknown
+};
+
+/**
+ * @brief Whether the library was built with PIPINPP_ENABLE_RT_AUDIT
+ */
+bool enabled();
+
+/**
+ * @brief Treat the calling thread as real-time from now on
+ *
+ * @param name Label used in reports (first 15 characters kept)
+ */
+void markCurrentThread(const char* name);
+
+/**
+ * @brief Stop auditing the calling thread
+ */
+void unmarkCurrentThread();
+
+/**
+ * @brief Whether the calling thread is currently audited
+ */
+bool isCurrentThreadMarked();
+
+/**
+ * @brief Every recorded violation, most frequent first (resolves symbols; allocates)
+ */
+std::vector<Violation> violations();
+
+/**
+ * @brief Violations whose stack did not fit in the table (counted, not kept)
+ */
+uint64_t droppedViolations();
+
+/**
+ * @brief Forget every recorded violation
+ *
+ * Only call while no marked thread is running.
+ */
+void reset();
+
+/**
+ * @brief Human-readable summary of violations(), one block per stack
+ */
+std::string report();
+
+/**
+ * @brief Marks the calling thread real-time for a scope, then restores the previous state
+ */
+class ScopedRealtime {
+public:
+    explicit ScopedRealtime(const char* name = "rt");
+    ~ScopedRealtime();
+
+    ScopedRealtime(const ScopedRealtime&) = delete;
+    ScopedRealtime& operator=(const ScopedRealtime&) = delete;
+
+private:
+    bool wasMarked_;
+};
+
+/**
+ * @brief Suspends auditing on the calling thread for a scope (known, accepted calls)
+ */
+class ScopedAllow {
+public:
+    ScopedAllow();
+    ~ScopedAllow();
+
+    ScopedAllow(const ScopedAllow&) = delete;
+    ScopedAllow& operator=(const ScopedAllow&) = delete;
+
+private:
+    bool wasSuspended_;
+};
+
+} // namespace rt_audit
+} // namespace pipinpp
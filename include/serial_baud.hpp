@@ -0,0 +1,64 @@
+/**
+ * @file serial_baud.hpp
+ * @brief Arbitrary UART baud rates (termios2/BOTHER) and low-latency mode
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * POSIX termios only knows the fixed Bxxx speed constants, which rules out
+ * rates such as 250000 (DMX), 31250 (MIDI) or whatever divisor a
+ * microcontroller link needs. Linux's termios2 interface takes the rate as
+ * an integer (BOTHER); the driver picks the nearest divisor and reports
+ * the rate it actually programmed.
+ *
+ * These helpers live in their own translation unit because the kernel's
+ * <asm/termbits.h> cannot be included alongside glibc's <termios.h>.
+ * SerialPort uses them for any rate missing from its speed table.
+ *
+ * Low latency: USB-serial adapters batch received bytes (FTDI holds them
+ * for up to 16 ms by default). setSerialLowLatency() sets the tty's
+ * ASYNC_LOW_LATENCY flag and, for usb-serial devices, the latency_timer
+ * in sysfs.
+ *
+ * Example usage:
+ * @code
+ * int fd = open("/dev/ttyAMA0", O_RDWR | O_NOCTTY);
+ * if (pipinpp::setTermiosBaudRate(fd, 3000000)) {
+ *     std::cout << pipinpp::getTermiosBaudRate(fd) << " baud\n";
+ * }
+ * pipinpp::setSerialLowLatency(fd, true);
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+namespace pipinpp {
+
+/**
+ * @brief Set input and output speed to any integer rate
+ * @param fd Open tty file descriptor
+ * @param baudRate Rate in bits per second
+ * @return false if the driver rejected the rate or termios2 is unavailable
+ * @note Other termios settings are left unchanged
+ */
+bool setTermiosBaudRate(int fd, unsigned long baudRate);
+
+/**
+ * @brief Output speed currently programmed in the driver
+ * @return Bits per second, or 0 on error
+ */
+unsigned long getTermiosBaudRate(int fd);
+
+/**
+ * @brief Ask the driver to deliver received bytes without batching
+ * @param fd Open tty file descriptor
+ * @param enable true for low latency, false for the driver default
+ * @return true if the tty flag or the usb-serial latency timer was changed
+ */
+bool setSerialLowLatency(int fd, bool enable);
+
+} // namespace pipinpp
@@ -0,0 +1,212 @@
+/**
+ * @file serial_framing.hpp
+ * @brief COBS/SLIP frame encoding and incremental decoding with CRC checks
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Binary telemetry over a UART needs a way to find frame boundaries and
+ * reject corrupted frames. This module provides:
+ * - COBS (zero byte delimits frames) and SLIP (RFC 1055) encoding
+ * - FrameDecoder: a byte-stream state machine that decodes frames as
+ *   data arrives, directly into one preallocated buffer, and hands each
+ *   complete frame to a callback without copying it again
+ * - CRC-16/CCITT-FALSE and CRC-32 (IEEE 802.3) trailers, table driven, with
+ *   the ARMv8 CRC32 instructions used when the compiler enables them
+ *
+ * The CRC, when enabled, is appended little-endian to the payload before
+ * encoding and stripped before the callback sees the frame.
+ *
+ * SerialPort::beginFrameMode() feeds a FrameDecoder from its receive
+ * thread, and SerialPort::writeFrame() sends encoded frames.
+ *
+ * Example usage:
+ * @code
+ * pipinpp::FrameDecoder decoder(pipinpp::FrameEncoding::COBS, pipinpp::FrameCrc::CRC16);
+ * decoder.setCallback([](pipinpp::FrameView frame) {
+ *     handleTelemetry(frame.data(), frame.size());   // Valid during the call only
+ * });
+ * decoder.feed(bytes, count);
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace pipinpp {
+
+/**
+ * @brief Default largest decoded frame, CRC included (bytes)
+ */
+constexpr size_t FRAME_DEFAULT_MAX_SIZE = 1024;
+
+/**
+ * @brief Byte stuffing used to delimit frames
+ */
+enum class FrameEncoding {
+    COBS,   ///< Consistent Overhead Byte Stuffing, frames end with 0x00
+    SLIP    ///< RFC 1055, frames delimited by 0xC0
+};
+
+/**
+ * @brief Integrity check appended to each frame
+ */
+enum class FrameCrc {
+    NONE,   ///< No check
+    CRC16,  ///< CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), 2 bytes
+    CRC32   ///< CRC-32 as used by zlib and Ethernet, 4 bytes
+};
+
+/**
+ * @brief CRC-16/CCITT-FALSE of a buffer
+ * @param crc Previous value when checksumming in pieces
+ */
+uint16_t crc16Ccitt(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+
+/**
+ * @brief CRC-32 (IEEE 802.3) of a buffer, zlib compatible
+ * @param crc Previous result when checksumming in pieces
+ */
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+
+/**
+ * @brief Size of a CRC trailer in bytes (0, 2 or 4)
+ */
+size_t frameCrcSize(FrameCrc crc);
+
+/**
+ * @brief Worst-case encoded size of a payload, delimiters and CRC included
+ */
+size_t maxEncodedFrameSize(FrameEncoding encoding, FrameCrc crc, size_t length);
+
+/**
+ * @brief Encode one frame
+ * @param payload Frame contents
+ * @param length Payload length
+ * @param out Destination buffer
+ * @param capacity Destination size (maxEncodedFrameSize() is always enough)
+ * @return Bytes written to @p out, or 0 if it does not fit
+ */
+size_t encodeFrame(FrameEncoding encoding, FrameCrc crc,
+                   const uint8_t* payload, size_t length,
+                   uint8_t* out, size_t capacity);
+
+/**
+ * @brief Read-only view of a decoded frame (C++17 stand-in for std::span)
+ */
+class FrameView {
+public:
+    FrameView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    const uint8_t* begin() const { return data_; }
+    const uint8_t* end() const { return data_ + size_; }
+    uint8_t operator[](size_t index) const { return data_[index]; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+/**
+ * @brief Callback receiving each valid frame
+ *
+ * The view points into the decoder's buffer and is only valid during the call.
+ */
+using FrameCallback = std::function<void(FrameView frame)>;
+
+/**
+ * @brief Decoder counters
+ */
+struct FrameStats {
+    uint64_t frames = 0;         ///< Frames delivered to the callback
+    uint64_t crcErrors = 0;      ///< Frames dropped for a CRC mismatch
+    uint64_t framingErrors = 0;  ///< Malformed or oversized frames dropped
+};
+
+/**
+ * @brief Incremental COBS/SLIP decoder
+ *
+ * feed() may be called with any split of the byte stream; state carries
+ * over between calls. Bytes are decoded straight into a buffer allocated
+ * once at construction, so steady-state decoding does not allocate.
+ *
+ * @note feed() and reset() must be called from one thread at a time;
+ *       getStats() may be called from any thread
+ */
+class FrameDecoder {
+public:
+    /**
+     * @param encoding Byte stuffing of the incoming stream
+     * @param crc Trailer to check and strip
+     * @param maxFrameSize Largest decoded frame (CRC included); longer frames are dropped
+     */
+    explicit FrameDecoder(FrameEncoding encoding, FrameCrc crc = FrameCrc::NONE,
+                          size_t maxFrameSize = FRAME_DEFAULT_MAX_SIZE);
+
+    FrameDecoder(const FrameDecoder&) = delete;
+    FrameDecoder& operator=(const FrameDecoder&) = delete;
+
+    /**
+     * @brief Set the function called for each valid frame
+     */
+    void setCallback(FrameCallback callback);
+
+    /**
+     * @brief Decode more of the stream, invoking the callback per complete frame
+     */
+    void feed(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Discard a partially received frame
+     */
+    void reset();
+
+    /**
+     * @brief Snapshot of the counters
+     */
+    FrameStats getStats() const;
+
+    FrameEncoding getEncoding() const { return encoding_; }
+    FrameCrc getCrc() const { return crc_; }
+    size_t getMaxFrameSize() const { return maxFrameSize_; }
+
+private:
+    /**
+     * @brief Validate the CRC and deliver the frame in buffer_
+     */
+    void finishFrame();
+
+    /**
+     * @brief Append a decoded byte, dropping the frame on overflow
+     */
+    void append(uint8_t byte);
+
+    FrameEncoding encoding_;
+    FrameCrc crc_;
+    size_t maxFrameSize_;
+    FrameCallback callback_;
+    std::unique_ptr<uint8_t[]> buffer_;    ///< Decoded bytes of the current frame
+    size_t length_;
+    bool discarding_;                      ///< Error seen: skip to the next delimiter
+    uint8_t cobsCode_;                     ///< Code byte of the current COBS block, 0 before the first
+    uint8_t cobsRemaining_;                ///< Data bytes left in the current COBS block
+    bool slipEscape_;                      ///< Previous byte was SLIP ESC
+
+    std::atomic<uint64_t> frames_;
+    std::atomic<uint64_t> crcErrors_;
+    std::atomic<uint64_t> framingErrors_;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,256 @@
+/**
+ * @file servo_controller.hpp
+ * @brief Velocity- and acceleration-limited servo motion from one timer task
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Writing a new angle straight to HardwarePWM makes the servo jump at
+ * full speed, and smoothing it by hand ties the update rate to whatever
+ * loop the caller runs. ServoController takes waypoints instead and moves
+ * every attached servo from a single fixed-rate TimerManager task:
+ *
+ * - each servo follows a trapezoidal velocity profile: it accelerates at
+ *   up to maxAcceleration, cruises at up to maxVelocity and decelerates so
+ *   it arrives at each waypoint at rest
+ * - the profile is replanned every tick from the current position and
+ *   velocity, so moveTo() can redirect a moving servo without a jerk
+ * - waypoints queue per servo, each with optional speed limits and a
+ *   dwell time
+ * - pulse widths go out through HardwarePWM::setDutyCycleNs() (one
+ *   pwrite() on a persistent fd), DmaSoftPWM::setPulseWidthUs() (two word
+ *   writes, any pin) or a custom output, and only when they change
+ * - the task ticks once per 50 Hz servo frame by default, and is cancelled
+ *   once no servo is moving
+ *
+ * A tick costs a few hundred nanoseconds per servo plus one write, so
+ * sixteen servos on DMA use a small fraction of one core.
+ *
+ * Example usage:
+ * @code
+ * auto& servos = pipinpp::ServoController::getInstance();
+ * pipinpp::DmaSoftPWM::getInstance().begin(20000, 10);    // 50 Hz, 10 µs steps
+ *
+ * pipinpp::ServoConfig config;
+ * config.maxVelocity = 120.0;                             // deg/s
+ * int arm = servos.attachDma(17, config);
+ * int wrist = servos.attachDma(27, config, 45.0);
+ *
+ * servos.moveTo(arm, 30.0);
+ * servos.addWaypoint(wrist, {135.0, 60.0, 0.0, 500});     // Slower, then pause 0.5 s
+ * servos.addWaypoint(wrist, {45.0});
+ * while (servos.getMovingCount() > 0) {
+ *     delay(20);
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace pipinpp {
+
+class HardwarePWM;
+class TimerManager;
+
+/**
+ * @brief Default interval between servo updates (one 50 Hz frame)
+ */
+constexpr uint32_t DEFAULT_SERVO_TICK_US = 20000;
+
+/**
+ * @brief Calibration and motion limits of one servo
+ */
+struct ServoConfig {
+    uint32_t minPulseUs = 1000;        ///< Pulse width at minAngle
+    uint32_t maxPulseUs = 2000;        ///< Pulse width at maxAngle
+    double minAngle = 0.0;             ///< Degrees
+    double maxAngle = 180.0;           ///< Degrees
+    double maxVelocity = 180.0;        ///< Degrees per second (0 = unlimited)
+    double maxAcceleration = 720.0;    ///< Degrees per second squared (0 = unlimited)
+};
+
+/**
+ * @brief One target in a servo's path
+ */
+struct ServoWaypoint {
+    double angle = 0.0;                ///< Degrees (clamped to the servo's range)
+    double maxVelocity = 0.0;          ///< 0 = the servo's ServoConfig limit
+    double maxAcceleration = 0.0;      ///< 0 = the servo's ServoConfig limit
+    uint32_t dwellMs = 0;              ///< Hold time after arriving
+};
+
+/**
+ * @brief Receives a servo's new pulse width in nanoseconds; false on write failure
+ */
+using ServoOutput = std::function<bool(uint64_t pulseNs)>;
+
+/**
+ * @brief Moves many servos along limited-speed paths from one timer task
+ *
+ * @note Thread-safe. Outputs are called with the controller's lock held,
+ *       so they must not call back into the controller.
+ */
+class ServoController {
+public:
+    /**
+     * @brief Process-wide controller on TimerManager::getInstance()
+     */
+    static ServoController& getInstance();
+
+    /**
+     * @param timers Timer driving the ticks (nullptr = TimerManager::getInstance())
+     */
+    explicit ServoController(TimerManager* timers = nullptr);
+
+    /**
+     * @brief Cancels the timer task; servos hold their last pulse width
+     */
+    ~ServoController();
+
+    ServoController(const ServoController&) = delete;
+    ServoController& operator=(const ServoController&) = delete;
+
+    /**
+     * @brief Drive a servo from a hardware PWM channel
+     * @param pwm Channel already started with begin() (50 Hz for most servos); must outlive the servo
+     * @param config Calibration and limits
+     * @param initialAngle Position written immediately (degrees)
+     * @return Servo id
+     * @throws std::invalid_argument if @p config is inconsistent
+     */
+    int attach(HardwarePWM& pwm, const ServoConfig& config = ServoConfig(), double initialAngle = 90.0);
+
+    /**
+     * @brief Drive a servo from a DmaSoftPWM channel (begin() it with a 20000 µs cycle)
+     * @return Servo id
+     * @throws InvalidPinError if the pin number is invalid
+     * @throws std::invalid_argument if @p config is inconsistent
+     */
+    int attachDma(int pin, const ServoConfig& config = ServoConfig(), double initialAngle = 90.0);
+
+    /**
+     * @brief Drive a servo through a custom output
+     * @return Servo id
+     * @throws std::invalid_argument if @p output is empty or @p config is inconsistent
+     */
+    int attach(ServoOutput output, const ServoConfig& config = ServoConfig(), double initialAngle = 90.0);
+
+    /**
+     * @brief Forget a servo (its output keeps the last pulse width)
+     * @return false if no such servo exists
+     */
+    bool detach(int servo);
+
+    /**
+     * @brief Replace a servo's path with a single target
+     * @return false if no such servo exists
+     */
+    bool moveTo(int servo, double angle);
+
+    /**
+     * @brief Append a target to a servo's path
+     * @return false if no such servo exists
+     */
+    bool addWaypoint(int servo, const ServoWaypoint& waypoint);
+
+    /**
+     * @brief Drop a servo's path and bring it to rest as fast as its acceleration allows
+     * @return false if no such servo exists
+     */
+    bool stop(int servo);
+
+    /**
+     * @brief Whether a servo has a path left to follow (including dwell)
+     */
+    bool isMoving(int servo) const;
+
+    /**
+     * @brief Current commanded angle (degrees; 0 for an unknown id)
+     */
+    double getAngle(int servo) const;
+
+    /**
+     * @brief Current commanded velocity (degrees per second; 0 for an unknown id)
+     */
+    double getVelocity(int servo) const;
+
+    /**
+     * @brief Number of servos with a path left to follow
+     */
+    size_t getMovingCount() const;
+
+    /**
+     * @brief Interval between updates, from the next tick (0 is ignored)
+     */
+    void setTickUs(uint32_t tickUs);
+
+    /**
+     * @brief Advance every servo by @p elapsedNs and write changed pulse widths
+     *
+     * Called by the timer task with the measured time since its last
+     * tick; public for applications that run their own control loop.
+     *
+     * @return true while any servo is still moving
+     */
+    bool step(int64_t elapsedNs);
+
+    /**
+     * @brief Helper: pulse width for an angle under a calibration (angle clamped)
+     */
+    static uint64_t angleToPulseNs(const ServoConfig& config, double angle);
+
+private:
+    struct Servo {
+        ServoOutput output;
+        ServoConfig config;
+        std::deque<ServoWaypoint> path;
+        double position = 0.0;         ///< Degrees
+        double velocity = 0.0;         ///< Degrees per second
+        int64_t dwellNs = 0;           ///< Hold time left at the last waypoint
+        uint64_t pulseNs = 0;          ///< Last pulse width written
+    };
+
+    static bool moving(const Servo& servo) { return !servo.path.empty() || servo.dwellNs > 0; }
+
+    /**
+     * @brief Advance one servo; false once it has stopped moving
+     */
+    static bool advance(Servo& servo, int64_t elapsedNs);
+
+    /**
+     * @note Caller must hold mutex_
+     */
+    bool write(Servo& servo);
+
+    /**
+     * @note Caller must hold mutex_
+     */
+    void ensureTimer();
+
+    /**
+     * @brief Timer task body: step by the measured interval, cancel the task once idle
+     */
+    void onTick();
+
+    TimerManager* timers_;
+
+    mutable std::mutex mutex_;
+    std::map<int, Servo> servos_;
+    int nextId_ = 0;
+    uint32_t tickUs_ = DEFAULT_SERVO_TICK_US;
+    int timerId_ = -1;
+    int64_t lastTickNs_ = 0;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,262 @@
+/**
+ * @file sim_backend.hpp
+ * @brief In-memory GPIO, SPI and I2C hardware for tests and benchmarks without a Pi
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * install() points ChipRegistry and the device file hook (backend.hpp) at
+ * a simulation, so Pin, digitalWrite(), InterruptManager, SPIClass and
+ * WireClass run unchanged on any Linux machine. What is then measured is
+ * the library's own overhead (lookups, locks, std::function dispatch,
+ * buffering) plus the simulation's, which is a mutex and a few stores.
+ *
+ * - GPIO: every chip name maps to one bank of SIM_NUM_LINES lines. Output
+ *   writes are recorded; setInput() drives an input and raises edge
+ *   events; connect() wires an output to an input (loopback). Edges can be
+ *   injected in bursts with modeled timestamps or generated at a fixed
+ *   rate by a background thread. Edge event fds are eventfds, so the
+ *   InterruptManager epoll loop runs as on hardware.
+ * - SPI: /dev/spidevB.C devices added with addSpiDevice(); a transfer runs
+ *   a handler, or echoes MOSI to MISO by default.
+ * - I2C: /dev/i2c-N adapters with register-file devices (256 registers,
+ *   auto-incrementing pointer) added with addI2cDevice(). Combined
+ *   transfers (I2C_RDWR), plain read/write and the common SMBus calls are
+ *   understood; other addresses NACK.
+ *
+ * Lines, like on the kernel, can be requested once at a time: a second
+ * request fails with EBUSY. Classes built directly on libgpiod (PinGroup,
+ * QuadratureEncoder) are not simulated and fail to open while installed.
+ *
+ * Example usage:
+ * @code
+ * auto& sim = pipinpp::SimulatedHardware::getInstance();
+ * sim.install();
+ * sim.connect(17, 27);                         // Loopback wire GPIO17 -> GPIO27
+ * attachInterrupt(27, onEdge, CHANGE);
+ * pinMode(17, OUTPUT);
+ * digitalWrite(17, HIGH);                      // onEdge() runs on the monitor thread
+ * sim.injectEdges(27, 1000, 10000);            // 1000 edges 10 us apart, at once
+ * int gen = sim.startEdgeGenerator(22, 5000);  // 5 kHz of edges until stopped
+ * sim.addI2cDevice(1, 0x76);
+ * sim.setI2cRegister(1, 0x76, 0xD0, 0x58);
+ * Wire.begin(1);
+ * int id = Wire.readRegister(0x76, 0xD0);      // 0x58
+ * sim.stopEdgeGenerator(gen);
+ * sim.uninstall();
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "backend.hpp"
+
+namespace pipinpp {
+
+/**
+ * @brief Lines in the simulated GPIO bank (as on BCM2711)
+ */
+constexpr size_t SIM_NUM_LINES = 58;
+
+/**
+ * @brief Label reported by simulated chips (no /dev/gpiomem layout matches it)
+ */
+constexpr const char* SIM_CHIP_LABEL = "pipinpp-sim";
+
+class GpioChip;
+class SimLineRequest;
+
+/**
+ * @brief Simulated GPIO, SPI and I2C hardware (singleton)
+ *
+ * @note All methods are thread-safe
+ */
+class SimulatedHardware {
+public:
+    /**
+     * @brief MISO bytes for a transfer: fill @p rx (length bytes) for @p tx
+     */
+    using SpiHandler = std::function<void(const uint8_t* tx, uint8_t* rx, size_t length)>;
+
+    static SimulatedHardware& getInstance();
+
+    /**
+     * @brief Route chips and bus devices opened from now on to the simulation
+     */
+    void install();
+
+    /**
+     * @brief Restore libgpiod and /dev (open simulated objects keep working)
+     */
+    void uninstall();
+
+    bool isInstalled() const;
+
+    /**
+     * @brief Open a simulated chip without installing the simulation
+     *
+     * For serving simulated lines from a GpioDaemon while this process's
+     * own chips go elsewhere.
+     */
+    std::shared_ptr<GpioChip> openChip(const std::string& name);
+
+    /**
+     * @brief Forget levels, write counts, connections, generators and bus devices
+     *
+     * Line requests stay valid; their pending edge events are dropped.
+     */
+    void reset();
+
+    // ------------------------------------------------------------------
+    // GPIO
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Drive a line from outside, raising an edge event if the level changes
+     */
+    void setInput(int line, bool level);
+
+    /**
+     * @brief Current level of a line (last written value for outputs), -1 if out of range
+     */
+    int getLevel(int line) const;
+
+    /**
+     * @brief Number of writes to a line since the last reset()
+     */
+    uint64_t getWriteCount(int line) const;
+
+    /**
+     * @brief Make every level change written to @p output drive @p input
+     */
+    void connect(int output, int input);
+
+    /**
+     * @brief Remove the connection from @p output
+     */
+    void disconnect(int output);
+
+    /**
+     * @brief Queue @p count alternating edges on @p line at once
+     *
+     * Timestamps are spaced @p intervalNs apart and end now, modeling a
+     * signal of that rate that was buffered by the kernel. Request buffers
+     * that overflow drop their oldest events, like the kernel does.
+     */
+    void injectEdges(int line, size_t count, uint64_t intervalNs);
+
+    /**
+     * @brief Toggle @p line at @p edgesPerSecond from a background thread
+     * @return Generator id for stopEdgeGenerator()
+     */
+    int startEdgeGenerator(int line, double edgesPerSecond);
+
+    /**
+     * @brief Stop and join a generator (unknown ids are ignored)
+     */
+    void stopEdgeGenerator(int id);
+
+    // ------------------------------------------------------------------
+    // Buses
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Create /dev/spidev@p bus.@p cs
+     * @param handler Transfer model; nullptr echoes MOSI back on MISO
+     */
+    void addSpiDevice(int bus, int cs, SpiHandler handler = nullptr);
+
+    /**
+     * @brief Number of SPI transfers (spi_ioc_transfer entries) run on a device
+     */
+    uint64_t getSpiTransferCount(int bus, int cs) const;
+
+    /**
+     * @brief Create a register-file device on /dev/i2c-@p bus (creating the adapter)
+     */
+    void addI2cDevice(int bus, uint8_t address);
+
+    void setI2cRegister(int bus, uint8_t address, uint8_t reg, uint8_t value);
+
+    /**
+     * @brief Register value, -1 if the device does not exist
+     */
+    int getI2cRegister(int bus, uint8_t address, uint8_t reg) const;
+
+    SimulatedHardware(const SimulatedHardware&) = delete;
+    SimulatedHardware& operator=(const SimulatedHardware&) = delete;
+
+private:
+    friend class SimLineRequest;
+    friend class SimSpiFile;
+    friend class SimI2cFile;
+    friend class SimDeviceProvider;
+    friend class SimChip;
+
+    struct Line {
+        bool level = false;
+        bool requested = false;
+        int connectedTo = -1;
+        uint64_t writes = 0;
+    };
+
+    struct SpiDevice {
+        std::shared_ptr<const SpiHandler> handler;  ///< Copied out so it runs unlocked
+        uint64_t transfers = 0;
+    };
+
+    struct I2cDevice {
+        std::array<uint8_t, 256> registers{};
+        uint8_t pointer = 0;
+    };
+
+    struct Generator {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool running = true;
+    };
+
+    SimulatedHardware() = default;
+    ~SimulatedHardware() = default;
+
+    std::unique_ptr<LineRequest> requestLines(const std::vector<LineSettings>& lines, size_t eventBufferSize);
+    void release(SimLineRequest* request);
+    void driveLocked(unsigned int line, bool level, uint64_t timestampNs);
+    void deliverEdgeLocked(unsigned int line, bool rising, uint64_t timestampNs);
+    void generatorThread(Generator* generator, unsigned int line, int64_t periodNs);
+    static void stopGenerator(std::unique_ptr<Generator> generator);
+    static bool validLine(int line) { return line >= 0 && static_cast<size_t>(line) < SIM_NUM_LINES; }
+
+    // I2C device model (caller holds mutex_)
+    I2cDevice* findI2cLocked(int bus, int address);
+    static void i2cWrite(I2cDevice& device, const uint8_t* data, size_t length);
+    static void i2cRead(I2cDevice& device, uint8_t* data, size_t length);
+
+    mutable std::mutex mutex_;
+    bool installed_ = false;
+    std::array<Line, SIM_NUM_LINES> lines_{};
+    std::vector<SimLineRequest*> requests_;
+    std::map<std::pair<int, int>, SpiDevice> spiDevices_;              ///< (bus, cs)
+    std::map<int, std::map<int, I2cDevice>> i2cBuses_;                 ///< bus -> address -> device
+    std::map<int, std::unique_ptr<Generator>> generators_;
+    int nextGeneratorId_ = 1;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,147 @@
+/**
+ * @file spsc_ring.hpp
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Fixed-capacity FIFO for handing bulk data from one I/O thread to one
+ * consumer without a lock. The producer only writes head_, the consumer
+ * only writes tail_, and each side publishes its index with release
+ * ordering after the element copies.
+ *
+ * Capacity is rounded up to a power of two so indices wrap with a mask.
+ *
+ * Example usage:
+ * @code
+ * pipinpp::SpscRing<uint8_t> ring(65536);
+ *
+ * // I/O thread
+ * ring.push(chunk, n);
+ *
+ * // Consumer
+ * uint8_t buffer[256];
+ * size_t got = ring.pop(buffer, sizeof(buffer));
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace pipinpp {
+
+/**
+ * @brief Bounded lock-free FIFO for exactly one producer and one consumer thread
+ *
+ * @tparam T Element type (copy-assignable; bytes in practice)
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @param capacity Minimum number of elements (rounded up to a power of two, at least 2)
+     */
+    explicit SpscRing(size_t capacity)
+        : capacity_(roundUp(capacity)), mask_(capacity_ - 1), buffer_(new T[capacity_]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Number of elements the ring holds
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Elements waiting (exact for the consumer, a lower bound for the producer)
+     */
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Whether the ring is empty
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Append elements (producer only)
+     * @return Number of elements stored (less than @p count if the ring filled up)
+     */
+    size_t push(const T* data, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t space = capacity_ - (head - tail_.load(std::memory_order_acquire));
+        count = std::min(count, space);
+
+        size_t start = head & mask_;
+        size_t first = std::min(count, capacity_ - start);
+        std::copy(data, data + first, buffer_.get() + start);
+        std::copy(data + first, data + count, buffer_.get());
+
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Remove up to @p count elements (consumer only)
+     * @return Number of elements copied to @p out
+     */
+    size_t pop(T* out, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t available = head_.load(std::memory_order_acquire) - tail;
+        count = std::min(count, available);
+
+        size_t start = tail & mask_;
+        size_t first = std::min(count, capacity_ - start);
+        std::copy(buffer_.get() + start, buffer_.get() + start + first, out);
+        std::copy(buffer_.get(), buffer_.get() + (count - first), out + first);
+
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Copy the oldest element without removing it (consumer only)
+     * @return false if the ring is empty
+     */
+    bool peek(T& out) const {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return false;
+        }
+        out = buffer_[tail & mask_];
+        return true;
+    }
+
+    /**
+     * @brief Discard every waiting element (consumer only)
+     */
+    void clear() {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    static size_t roundUp(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> buffer_;
+    alignas(64) std::atomic<size_t> head_{0};   ///< Next write index (producer)
+    alignas(64) std::atomic<size_t> tail_{0};   ///< Next read index (consumer)
+};
+
+} // namespace pipinpp
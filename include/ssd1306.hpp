@@ -0,0 +1,216 @@
+/**
+ * @file ssd1306.hpp
+ * @brief SSD1306 OLED framebuffer driver with dirty-rectangle updates
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Redrawing a whole 128x64 panel moves 1 KB: ~25 ms at 400 kHz I2C. Most
+ * UI updates change a few characters or a progress bar, so Ssd1306 keeps
+ * two copies of the framebuffer, the one being drawn and the one last
+ * sent to the panel, and display() only sends what differs:
+ * - drawing records a dirty column range per page (8-pixel row), so
+ *   display() only compares those bytes
+ * - each dirty page is trimmed to the bytes that really changed; runs
+ *   separated by a long unchanged stretch are sent separately
+ * - identical column ranges on consecutive pages are merged into one
+ *   rectangle, addressed with the controller's column/page window
+ *   (COLUMNADDR 0x21 / PAGEADDR 0x22, horizontal addressing mode)
+ *
+ * Clearing and redrawing a frame therefore only costs the pixels that
+ * moved. Over I2C, every rectangle is a command write plus a data write,
+ * and all of them go out in one WireBatch (I2C_RDWR). Over SPI, the D/C
+ * line selects commands or data and each part is one transferStream().
+ *
+ * @note Panels driven by an SH1106 (the common 1.3" modules) do not
+ *       support the address window commands.
+ *
+ * Example usage:
+ * @code
+ * #include "ssd1306.hpp"
+ *
+ * Wire.begin();
+ * Wire.setClock(400000);
+ * pipinpp::Ssd1306 oled(128, 64);             // I2C address 0x3C
+ * oled.begin();
+ * oled.drawRect(14, 50, 102, 10);
+ * oled.display();                             // Full frame once
+ * for (int percent = 0; percent <= 100; ++percent) {
+ *     oled.fillRect(15, 51, percent, 8);
+ *     oled.display();                         // Only the new column(s)
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "SPI.hpp"
+#include "Wire.hpp"
+#include "pin.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pipinpp {
+
+constexpr uint8_t SSD1306_I2C_ADDRESS = 0x3C;
+
+/**
+ * @brief Monochrome SSD1306 panel (up to 128x64) on I2C or 4-wire SPI
+ *
+ * Pixel (x, y) is bit y % 8 of byte x + (y / 8) * width, the controller's
+ * own page layout, so buffer() can be filled directly (call markDirty()
+ * afterwards).
+ *
+ * @note Not thread-safe; draw and display from one thread
+ */
+class Ssd1306 {
+public:
+    /**
+     * @brief Panel on I2C (the bus must be begun by the caller)
+     *
+     * @param width Columns, 1-128
+     * @param height Rows, a multiple of 8 up to 64
+     * @throws std::invalid_argument for any other geometry
+     */
+    explicit Ssd1306(int width = 128, int height = 64, uint8_t address = SSD1306_I2C_ADDRESS,
+                     WireClass& wire = Wire);
+
+    /**
+     * @brief Panel on 4-wire SPI (the bus must be begun by the caller)
+     *
+     * @param dcPin GPIO driving D/C (LOW = command, HIGH = data)
+     * @param resetPin GPIO driving RES, or -1 if not connected
+     * @throws std::invalid_argument for an invalid geometry;
+     *         InvalidPinError, GpioAccessError as Pin
+     */
+    Ssd1306(SPIClass& spi, int dcPin, int resetPin = -1, int width = 128, int height = 64);
+
+    ~Ssd1306();
+
+    Ssd1306(const Ssd1306&) = delete;
+    Ssd1306& operator=(const Ssd1306&) = delete;
+
+    /**
+     * @brief Reset (SPI with a reset pin), send the init sequence, turn the panel on
+     *
+     * The next display() sends the whole frame.
+     */
+    bool begin();
+
+    /**
+     * @brief Send the changed parts of the frame
+     *
+     * @param full Send the whole frame regardless of what changed
+     * @return true if everything was sent; on failure the unsent areas
+     *         stay dirty and are retried by the next call
+     */
+    bool display(bool full = false);
+
+    void clear() { fill(false); }
+    void fill(bool on);
+
+    void setPixel(int x, int y, bool on = true);
+    bool getPixel(int x, int y) const;
+
+    void drawHLine(int x, int y, int w, bool on = true);
+    void drawVLine(int x, int y, int h, bool on = true);
+    void drawLine(int x0, int y0, int x1, int y1, bool on = true);
+    void drawRect(int x, int y, int w, int h, bool on = true);
+    void fillRect(int x, int y, int w, int h, bool on = true);
+    void drawCircle(int x0, int y0, int radius, bool on = true);
+
+    /**
+     * @brief Draw a column-major bitmap (one byte = 8 vertical pixels, LSB at top)
+     *
+     * @param columns Bytes per 8-pixel band (bitmap width)
+     * @param rows Bitmap height in pixels
+     */
+    void drawBitmap(int x, int y, const uint8_t* bitmap, int columns, int rows, bool on = true);
+
+    /**
+     * @brief Raw framebuffer, width * height / 8 bytes
+     */
+    uint8_t* buffer() { return buffer_.data(); }
+    const uint8_t* buffer() const { return buffer_.data(); }
+
+    /**
+     * @brief Flag an area changed through buffer() for the next display()
+     */
+    void markDirty(int x, int y, int w, int h);
+
+    /**
+     * @brief Send the whole frame on the next display() (e.g. after a panel reset)
+     */
+    void invalidate();
+
+    bool setContrast(uint8_t contrast);
+    bool invert(bool inverted);
+    bool setPower(bool on);
+
+    /**
+     * @brief Skip unchanged stretches longer than this many bytes within a page
+     *
+     * Each extra rectangle costs a 6-byte address command, so shorter gaps
+     * are cheaper to resend. Default 8.
+     */
+    void setSplitGap(int bytes) { splitGap_ = bytes < 0 ? 0 : bytes; }
+
+    /**
+     * @brief Framebuffer bytes sent by the last display()
+     */
+    size_t getLastUpdateBytes() const { return lastBytes_; }
+
+    /**
+     * @brief Address windows sent by the last display()
+     */
+    size_t getLastUpdateRectangles() const { return lastRectangles_; }
+
+    /**
+     * @brief Framebuffer bytes sent since construction
+     */
+    uint64_t getTotalBytes() const { return totalBytes_; }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int pages() const { return height_ / 8; }
+
+private:
+    struct Rect {
+        int firstColumn;
+        int lastColumn;
+        int firstPage;
+        int lastPage;
+    };
+
+    void checkGeometry() const;
+    void markColumns(int page, int first, int last);
+    void collectRects(bool full, std::vector<Rect>& rects) const;
+    bool sendCommands(const uint8_t* commands, size_t length);
+    bool sendRects(const std::vector<Rect>& rects, std::vector<bool>& sent);
+
+    WireClass* wire_;
+    SPIClass* spi_;
+    std::unique_ptr<Pin> dc_;
+    std::unique_ptr<Pin> reset_;
+    uint8_t address_;
+    int width_;
+    int height_;
+    std::vector<uint8_t> buffer_;      ///< Frame being drawn
+    std::vector<uint8_t> shown_;       ///< Frame on the panel
+    std::vector<int> dirtyFirst_;      ///< Per page; width_ when clean
+    std::vector<int> dirtyLast_;       ///< Per page; -1 when clean
+    std::vector<uint8_t> packet_;      ///< Rectangle data staging
+    bool shownValid_;
+    int splitGap_;
+    size_t lastBytes_;
+    size_t lastRectangles_;
+    uint64_t totalBytes_;
+};
+
+} // namespace pipinpp
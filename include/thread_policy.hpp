@@ -0,0 +1,157 @@
+/**
+ * @file thread_policy.hpp
+ * @brief Real-time scheduling, CPU affinity and memory locking for PiPinPP threads
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * The interrupt monitor, PWMManager and EventPWM threads normally run as
+ * SCHED_OTHER wherever the scheduler puts them, so unrelated load on the Pi
+ * shows up as latency spikes. A ThreadPolicy set here is applied by every
+ * PiPinPP-owned thread when it starts:
+ * - SCHED_FIFO priority (needs CAP_SYS_NICE or an rtprio limit)
+ * - CPU pinning, e.g. to a core isolated with isolcpus=3
+ * - mlockall() so page faults cannot stall a time-critical thread
+ *
+ * Nothing fails when the system refuses a setting; the thread keeps running
+ * with the defaults and the outcome is recorded in a ThreadPolicyStatus.
+ *
+ * Example usage:
+ * @code
+ * pipinpp::ThreadPolicy policy;
+ * policy.priority = 80;       // SCHED_FIFO 80
+ * policy.cpu = 3;             // Isolated core
+ * policy.lockMemory = true;
+ * pipinpp::ThreadPolicyManager::getInstance().setPolicy(policy);
+ *
+ * attachInterrupt(17, onEdge, RISING);   // Monitor thread starts with the policy
+ *
+ * auto status = pipinpp::ThreadPolicyManager::getInstance().getStatus("pipinpp-irq");
+ * if (!status.granted()) {
+ *     std::cerr << status.message << std::endl;
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @brief Scheduling settings applied to PiPinPP-owned threads
+ */
+struct ThreadPolicy {
+    int priority = 0;          ///< SCHED_FIFO priority 1-99, 0 keeps SCHED_OTHER
+    int cpu = -1;              ///< CPU to pin to, -1 for no pinning
+    bool lockMemory = false;   ///< Lock all current and future pages (mlockall)
+
+    /**
+     * @brief Whether this policy changes anything from the defaults
+     */
+    bool isDefault() const { return priority == 0 && cpu < 0 && !lockMemory; }
+};
+
+/**
+ * @brief What was actually granted when a policy was applied
+ */
+struct ThreadPolicyStatus {
+    ThreadPolicy requested;          ///< Policy that was asked for
+    bool applied = false;            ///< A thread has applied the policy
+    bool realtimeGranted = false;    ///< SCHED_FIFO at the requested priority
+    bool affinityGranted = false;    ///< Pinned to the requested CPU
+    bool memoryLocked = false;       ///< mlockall() in effect
+    std::string message;             ///< Reasons for anything not granted
+
+    /**
+     * @brief Whether every requested setting was granted
+     */
+    bool granted() const {
+        return applied &&
+               (requested.priority == 0 || realtimeGranted) &&
+               (requested.cpu < 0 || affinityGranted) &&
+               (!requested.lockMemory || memoryLocked);
+    }
+};
+
+/**
+ * @brief Process-wide ThreadPolicy shared by all PiPinPP threads
+ *
+ * Threads read the policy when they start, so set it before attaching
+ * interrupts or starting PWM. Thread names: "pipinpp-irq" for the
+ * interrupt monitor, "pipinpp-pwm<pin>" for PWMManager,
+ * "pipinpp-epwm<pin>" for EventPWM, "pipinpp-spi<bus>.<cs>" for an
+ * SPIClass I/O queue, "pipinpp-i2c<bus>" for WireScheduler, and
+ * "pipinpp-irqcb" / "pipinpp-irqcb<pin>" for queued interrupt callbacks.
+ *
+ * @note Thread-safe
+ */
+class ThreadPolicyManager {
+public:
+    /**
+     * @brief Get the singleton instance
+     */
+    static ThreadPolicyManager& getInstance();
+
+    /**
+     * @brief Set the policy for threads started from now on
+     *
+     * Memory locking is process-wide and takes effect immediately.
+     *
+     * @param policy New policy
+     * @throws InvalidPinError if priority is outside 0-99 or cpu < -1
+     */
+    void setPolicy(const ThreadPolicy& policy);
+
+    /**
+     * @brief Current policy
+     */
+    ThreadPolicy getPolicy() const;
+
+    /**
+     * @brief Apply the current policy to the calling thread
+     *
+     * Called by PiPinPP threads on startup. Also names the thread so it
+     * can be found in top/htop and chrt.
+     *
+     * @param name Thread name (at most 15 characters are kept by the kernel)
+     * @param realtime Audit the thread as real-time in PIPINPP_ENABLE_RT_AUDIT
+     *                 builds (false for helpers that exist to absorb blocking work)
+     * @return Outcome, also recorded for getStatus()
+     */
+    ThreadPolicyStatus applyToCurrentThread(const std::string& name, bool realtime = true);
+
+    /**
+     * @brief Outcome for the most recent thread started with this name
+     *
+     * @return Status with applied == false if no such thread has started
+     */
+    ThreadPolicyStatus getStatus(const std::string& name) const;
+
+    /**
+     * @brief Outcome for every PiPinPP thread started so far
+     */
+    std::vector<std::pair<std::string, ThreadPolicyStatus>> report() const;
+
+    ThreadPolicyManager(const ThreadPolicyManager&) = delete;
+    ThreadPolicyManager& operator=(const ThreadPolicyManager&) = delete;
+
+private:
+    ThreadPolicyManager() = default;
+
+    mutable std::mutex mutex_;
+    ThreadPolicy policy_;
+    bool memoryLocked_ = false;
+    std::string memoryMessage_;
+    std::map<std::string, ThreadPolicyStatus> statuses_;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,132 @@
+/**
+ * @file timebase.hpp
+ * @brief Process-wide monotonic timebase behind millis(), micros() and the precise delays
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * The epoch is captured once, before any other static initializer of the
+ * library runs, and every reading is relative to it, so millis() and
+ * micros() agree with each other. Reads are inline: on ARM64 one read of
+ * the generic timer (CNTVCT_EL0, user-accessible on Linux) and one 128-bit
+ * fixed-point multiply; elsewhere one vDSO clock_gettime(CLOCK_MONOTONIC).
+ * No locks, no static-local guards.
+ *
+ * Configure with -DPIPINPP_USE_ARM_TIMER=OFF to use clock_gettime() on
+ * ARM64 too, e.g. under a hypervisor that traps counter reads. That defines
+ * PIPINPP_NO_ARM_TIMER for the library and everything linking it (CMake
+ * target and pipinpp.pc), since the inline reads must match the epoch.
+ *
+ * Example usage:
+ * @code
+ * uint64_t t0 = pipinpp::timebaseNanos();
+ * work();
+ * uint64_t elapsedNs = pipinpp::timebaseNanos() - t0;
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <time.h>
+
+#if defined(__aarch64__) && !defined(PIPINPP_NO_ARM_TIMER)
+#define PIPINPP_TIMEBASE_ARM_TIMER 1
+#endif
+
+namespace pipinpp {
+
+/**
+ * @brief Current value of the free-running counter the timebase reads
+ *
+ * CNTVCT_EL0 on ARM64, CLOCK_MONOTONIC in nanoseconds elsewhere.
+ */
+inline uint64_t readCycleCounter() {
+#if defined(PIPINPP_TIMEBASE_ARM_TIMER)
+    uint64_t value;
+    asm volatile("isb; mrs %0, cntvct_el0" : "=r"(value) :: "memory");
+    return value;
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+#endif
+}
+
+/**
+ * @brief Ticks per second of readCycleCounter()
+ */
+uint64_t cycleCounterHz();
+
+/**
+ * @brief CLOCK_MONOTONIC in nanoseconds (absolute, not relative to the epoch)
+ */
+inline int64_t monotonicNowNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+namespace detail {
+
+/**
+ * @brief Epoch and tick conversion factors, set once at startup
+ */
+struct TimebaseState {
+    uint64_t epochTicks;     ///< readCycleCounter() at startup
+    uint64_t nsPerTickQ48;   ///< Nanoseconds per tick, 16.48 fixed point
+    uint64_t usPerTickQ48;
+    uint64_t msPerTickQ48;
+};
+
+extern const TimebaseState timebaseState;
+
+#if defined(PIPINPP_TIMEBASE_ARM_TIMER)
+inline uint64_t scaleTicks(uint64_t ticks, uint64_t factorQ48) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * factorQ48) >> 48);
+}
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Nanoseconds since the epoch
+ */
+inline uint64_t timebaseNanos() {
+    const uint64_t ticks = readCycleCounter() - detail::timebaseState.epochTicks;
+#if defined(PIPINPP_TIMEBASE_ARM_TIMER)
+    return detail::scaleTicks(ticks, detail::timebaseState.nsPerTickQ48);
+#else
+    return ticks;
+#endif
+}
+
+/**
+ * @brief Microseconds since the epoch (micros())
+ */
+inline uint64_t timebaseMicros() {
+#if defined(PIPINPP_TIMEBASE_ARM_TIMER)
+    return detail::scaleTicks(readCycleCounter() - detail::timebaseState.epochTicks,
+                              detail::timebaseState.usPerTickQ48);
+#else
+    return timebaseNanos() / 1000;
+#endif
+}
+
+/**
+ * @brief Milliseconds since the epoch (millis())
+ */
+inline uint64_t timebaseMillis() {
+#if defined(PIPINPP_TIMEBASE_ARM_TIMER)
+    return detail::scaleTicks(readCycleCounter() - detail::timebaseState.epochTicks,
+                              detail::timebaseState.msPerTickQ48);
+#else
+    return timebaseNanos() / 1000000;
+#endif
+}
+
+} // namespace pipinpp
@@ -0,0 +1,229 @@
+/**
+ * @file timer_manager.hpp
+ * @brief Fixed-rate periodic callbacks from one timing thread
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * A `while (true) { work(); delay(period); }` loop runs at period plus
+ * however long work() took, so it drifts, and every such loop needs its
+ * own thread. TimerManager keeps all periodic tasks on one thread (named
+ * "pipinpp-timer", subject to ThreadPolicyManager) that blocks on a
+ * timerfd armed with absolute CLOCK_MONOTONIC deadlines:
+ *
+ * - Fixed rate: release k of a task is due at start + k * period, no
+ *   matter how long earlier runs took
+ * - Releases that cannot be met (the thread fell a whole period or more
+ *   behind) are skipped and counted as overruns instead of run in a burst
+ * - Per-task statistics: release lateness (jitter), callback run time,
+ *   overruns
+ * - CPU-heavy tasks can run on a small worker pool ("pipinpp-timer-pool")
+ *   so they do not delay the others; a pool task whose previous run is
+ *   still busy skips the release (overrun) rather than queue up
+ *
+ * Example usage:
+ * @code
+ * auto& timers = pipinpp::TimerManager::getInstance();
+ * int blink = timers.every(500000, [] { toggleLed(); });            // 2 Hz
+ * int control = timers.every(1000, [] { pidStep(); });              // 1 kHz
+ * int logger = timers.every(100000, [] { writeLog(); },
+ *                           pipinpp::TimerExecution::POOL);          // Off the timer thread
+ * ...
+ * auto stats = timers.getStats(control);
+ * std::cout << stats.maxLatenessNs << " ns worst jitter, " << stats.overruns << " overruns\n";
+ * timers.cancel(blink);
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @brief Worker threads started for TimerExecution::POOL tasks
+ */
+constexpr size_t DEFAULT_TIMER_POOL_THREADS = 2;
+
+/**
+ * @brief Callback run on every release of a periodic task
+ */
+using TimerCallback = std::function<void()>;
+
+/**
+ * @brief Where a task's callback runs
+ */
+enum class TimerExecution {
+    TIMER_THREAD,   ///< On the timer thread itself (keep it short)
+    POOL            ///< On a worker of the timer pool
+};
+
+/**
+ * @brief Timing statistics of one task
+ */
+struct TimerStats {
+    uint64_t runs = 0;              ///< Callbacks started
+    uint64_t overruns = 0;          ///< Releases skipped
+    int64_t lastLatenessNs = 0;     ///< Last callback start minus its release time
+    int64_t minLatenessNs = 0;
+    int64_t maxLatenessNs = 0;
+    int64_t totalLatenessNs = 0;    ///< Sum over all runs
+    int64_t lastRunNs = 0;          ///< Duration of the last callback
+    int64_t maxRunNs = 0;
+
+    /**
+     * @brief Spread of release lateness (max - min)
+     */
+    int64_t jitterNs() const { return maxLatenessNs - minLatenessNs; }
+
+    /**
+     * @brief Mean release lateness
+     */
+    double meanLatenessNs() const { return runs ? static_cast<double>(totalLatenessNs) / runs : 0.0; }
+};
+
+/**
+ * @brief Periodic task scheduler
+ *
+ * Threads start with the first task and stop with the manager. Callbacks
+ * must not block for long on the timer thread; use TimerExecution::POOL
+ * for anything that might.
+ *
+ * @note Thread-safe; tasks may be added or cancelled from callbacks
+ */
+class TimerManager {
+public:
+    /**
+     * @brief Process-wide manager
+     */
+    static TimerManager& getInstance();
+
+    /**
+     * @param poolThreads Workers started for the first POOL task
+     */
+    explicit TimerManager(size_t poolThreads = DEFAULT_TIMER_POOL_THREADS);
+
+    /**
+     * @brief Cancels every task and joins all threads
+     */
+    ~TimerManager();
+
+    TimerManager(const TimerManager&) = delete;
+    TimerManager& operator=(const TimerManager&) = delete;
+
+    /**
+     * @brief Run @p callback every @p periodUs, first one period from now
+     * @param periodUs Period in microseconds (> 0)
+     * @param callback Work to run
+     * @param execution Timer thread or worker pool
+     * @return Task id, or -1 if the period or callback is invalid
+     */
+    int every(uint64_t periodUs, TimerCallback callback,
+              TimerExecution execution = TimerExecution::TIMER_THREAD);
+
+    /**
+     * @brief Remove a task
+     *
+     * Waits for a running callback of the task to return, unless called
+     * from that callback.
+     *
+     * @return false if no such task exists
+     */
+    bool cancel(int id);
+
+    /**
+     * @brief Change a task's period from its next release on
+     * @return false if no such task exists or the period is 0
+     */
+    bool setPeriod(int id, uint64_t periodUs);
+
+    /**
+     * @brief Statistics of a task (all zero for an unknown id)
+     */
+    TimerStats getStats(int id) const;
+
+    /**
+     * @brief Clear the statistics of a task
+     * @return false if no such task exists
+     */
+    bool resetStats(int id);
+
+    /**
+     * @brief Busy-wait this long before each release for lower jitter (0 = sleep only)
+     */
+    void setSpin(int64_t spinNs) { spinNs_.store(spinNs < 0 ? 0 : spinNs, std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of registered tasks
+     */
+    size_t size() const;
+
+    /**
+     * @brief Cancel every task; the manager stays usable
+     */
+    void clear();
+
+private:
+    struct Task {
+        int id;
+        int64_t periodNs;                     ///< Guarded by mutex_
+        int64_t nextNs;                       ///< Next release, guarded by mutex_
+        TimerCallback callback;
+        TimerExecution execution;
+        std::atomic<bool> running{false};     ///< Dispatched and not yet finished
+        std::atomic<bool> cancelled{false};
+        std::mutex statsMutex;
+        TimerStats stats;
+    };
+
+    struct Job {
+        std::shared_ptr<Task> task;
+        int64_t releaseNs;
+    };
+
+    void ensureThread();
+    void ensurePool();
+    void wake();
+    void timerLoop();
+    void poolLoop();
+    void run(Task& task, int64_t releaseNs);
+    void finish(Task& task);
+    void waitIdle(const std::shared_ptr<Task>& task);
+    void shutdown();
+
+    size_t poolThreads_;
+    std::atomic<int64_t> spinNs_;
+
+    mutable std::mutex mutex_;                 ///< Guards tasks_ and thread startup
+    std::map<int, std::shared_ptr<Task>> tasks_;
+    int nextId_;
+    std::condition_variable idle_;             ///< A callback returned
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+    int timerFd_;
+    int wakeupFd_;
+    std::vector<Job> due_;                     ///< Reused by the timer thread
+
+    std::mutex poolMutex_;
+    std::condition_variable poolCv_;
+    std::deque<Job> jobs_;
+    std::vector<std::thread> pool_;
+};
+
+} // namespace pipinpp
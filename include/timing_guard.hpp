@@ -0,0 +1,162 @@
+/**
+ * @file timing_guard.hpp
+ * @brief Check and pin down the system settings that decide timing jitter
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * A SCHED_FIFO thread pinned to an isolated core (see thread_policy.hpp)
+ * still wakes up late when the core is clocked down by the cpufreq
+ * governor, has to leave a deep idle state first, or is busy with an
+ * unrelated interrupt. TimingGuard checks the three settings behind that
+ * and, with the privileges to do so, changes them for as long as it lives:
+ *
+ * - the "performance" governor on every cpufreq policy
+ * - a PM QoS request on /dev/cpu_dma_latency, which keeps the cores out of
+ *   idle states that take longer than the limit to leave
+ * - the affinity of the GPIO, SPI and I2C interrupts, steered to one core
+ *   (usually a different one from the time-critical threads)
+ *
+ * restore() and the destructor put back every value that apply() changed;
+ * the PM QoS request ends when its file descriptor is closed, so it cannot
+ * outlive the process. `pipinpp doctor` prints check(), and
+ * `pipinpp tune [-- command]` holds a guard while a command or until
+ * Ctrl+C.
+ *
+ * Nothing throws when the system refuses a setting: the outcome of each
+ * part is recorded in the TimingGuardStatus, like ThreadPolicyStatus.
+ *
+ * Example usage:
+ * @code
+ * pipinpp::TimingGuardOptions options;
+ * options.maxLatencyUs = 0;                 // No idle states at all
+ * options.irqCpu = 2;                       // GPIO/SPI/I2C interrupts on CPU 2
+ * pipinpp::TimingGuard guard(options);
+ * auto status = guard.apply();
+ * if (!status.granted()) {
+ *     std::cerr << status.message << std::endl;
+ * }
+ * runControlLoop();                         // Settings restored when guard goes
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pipinpp {
+
+/**
+ * @brief What a TimingGuard manages
+ */
+struct TimingGuardOptions {
+    bool performanceGovernor = true;    ///< Switch every cpufreq policy to "performance"
+    int maxLatencyUs = 0;               ///< PM QoS CPU latency limit in µs, -1 = no request
+    int irqCpu = -1;                    ///< CPU for the matching interrupts, -1 = leave them
+
+    /**
+     * @brief Interrupts to steer: substrings of their /proc/interrupts names (case-insensitive)
+     */
+    std::vector<std::string> irqNames = {"gpio", "pinctrl", "spi", "i2c"};
+
+    /**
+     * @brief Prefix for /sys, /proc and /dev paths (empty = the running system)
+     */
+    std::string sysRoot;
+};
+
+/**
+ * @brief One setting as found on the system
+ */
+struct TimingCheck {
+    std::string name;                   ///< "cpufreq governor", "idle latency", "IRQ affinity"
+    bool available = false;             ///< The system exposes the setting
+    bool ok = false;                    ///< Already as the options ask
+    std::string detail;                 ///< Current value, or why it could not be read
+};
+
+/**
+ * @brief What apply() managed to change
+ */
+struct TimingGuardStatus {
+    TimingGuardOptions requested;
+    bool applied = false;               ///< apply() has run
+    bool governorGranted = false;       ///< Every policy on "performance"
+    bool latencyGranted = false;        ///< PM QoS request held
+    bool irqGranted = false;            ///< Every matching interrupt on irqCpu
+    std::vector<int> steeredIrqs;       ///< Interrupts moved to irqCpu
+    std::string message;                ///< Reasons for anything not granted
+
+    /**
+     * @brief Whether every requested setting was granted
+     */
+    bool granted() const {
+        return applied &&
+               (!requested.performanceGovernor || governorGranted) &&
+               (requested.maxLatencyUs < 0 || latencyGranted) &&
+               (requested.irqCpu < 0 || irqGranted);
+    }
+};
+
+/**
+ * @brief Holds the governor, PM QoS and IRQ affinity settings while it exists
+ *
+ * @note Not thread-safe; one guard per process is the intended use.
+ */
+class TimingGuard {
+public:
+    /**
+     * @throws std::invalid_argument if maxLatencyUs < -1 or irqCpu < -1
+     */
+    explicit TimingGuard(const TimingGuardOptions& options = TimingGuardOptions());
+
+    /**
+     * @brief Restores everything apply() changed
+     */
+    ~TimingGuard();
+
+    TimingGuard(const TimingGuard&) = delete;
+    TimingGuard& operator=(const TimingGuard&) = delete;
+
+    /**
+     * @brief Read the current settings without changing them
+     */
+    std::vector<TimingCheck> check() const;
+
+    /**
+     * @brief Change the settings the options ask for, remembering the old values
+     *
+     * Needs root (or write access to the sysfs/procfs files and
+     * /dev/cpu_dma_latency). Calling it again re-applies without losing
+     * the values saved the first time.
+     */
+    TimingGuardStatus apply();
+
+    /**
+     * @brief Put back every value apply() changed and drop the PM QoS request
+     */
+    void restore();
+
+    bool isApplied() const { return status_.applied; }
+
+    const TimingGuardStatus& getStatus() const { return status_; }
+
+private:
+    std::string path(const std::string& systemPath) const { return options_.sysRoot + systemPath; }
+    std::vector<std::string> governorFiles() const;
+    std::vector<std::pair<int, std::string>> matchingIrqs() const;
+
+    TimingGuardOptions options_;
+    TimingGuardStatus status_;
+    std::vector<std::pair<std::string, std::string>> savedGovernors_;    ///< File, old governor
+    std::vector<std::pair<int, std::string>> savedAffinity_;             ///< IRQ, old CPU list
+    int latencyFd_ = -1;
+};
+
+} // namespace pipinpp
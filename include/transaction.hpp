@@ -0,0 +1,224 @@
+/**
+ * @file transaction.hpp
+ * @brief Deferred output updates committed together at the end of a scope
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Outputs that belong together (an H-bridge's direction and enable lines,
+ * a motor's PWM duty and brake pin) are normally written one call at a
+ * time, each with its own syscall or register store, so the other side
+ * briefly sees a mix of old and new values. While a Transaction is open,
+ * this thread's output calls are recorded instead of applied:
+ *
+ * - Pin::write()/toggle(), digitalWrite() and digitalToggle()
+ * - BoardLine::write()/toggle() (see board_config.hpp)
+ * - HardwarePWM::setFrequency(), setDutyCycle(), setDutyCycle8Bit() and
+ *   setDutyCycleNs()
+ * - analogWrite()
+ *
+ * commit(), called by the destructor, merges what was recorded and applies
+ * it in as few steps as possible:
+ *
+ * - only the last value per line, PWM channel or analogWrite() pin is kept
+ * - lines with the /dev/gpiomem fast path: one set and one clear register
+ *   store per chip, however many lines changed
+ * - lines on a shared line request (a Board's lines, one per chip): one
+ *   multi-line set-values ioctl per request
+ * - a PWM channel: its period and duty cycle through the persistent sysfs
+ *   fds, each written once and only if it changed
+ *
+ * Lines are written first, back to back, then PWM channels, then
+ * analogWrite() pins. The library's own protocol engines (Pin::shiftOut()
+ * and shiftIn(), Ssd1306's control lines, software PWM) write through a
+ * ScopedTransactionBypass: their pulses are timed and go out immediately. Reads are not deferred: Pin::read() still returns
+ * the line level, but getOutputState() and toggle() see pending writes.
+ *
+ * A Transaction belongs to the thread that opened it; other threads keep
+ * writing directly. One opened while another is open on the same thread
+ * joins it, and the outer one commits everything. If the scope is left by
+ * an exception, the pending changes are discarded instead of committed;
+ * one opened while an exception is already unwinding (in a destructor
+ * that drives outputs to a safe state) still commits when its scope ends.
+ * Pins and PWM channels written in a transaction must outlive it (their
+ * pending changes are dropped if they are destroyed first on this thread).
+ *
+ * Example usage:
+ * @code
+ * {
+ *     pipinpp::Transaction txn;
+ *     digitalWrite(IN1, HIGH);         // Recorded
+ *     digitalWrite(IN2, LOW);          // Recorded
+ *     motorPwm.setDutyCycle(40.0);     // Recorded
+ * }                                    // Both lines, then the duty cycle
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pipinpp {
+
+class GpioChip;
+class GpioMem;
+class HardwarePWM;
+class LineRequest;
+
+/**
+ * @brief Records this thread's output writes and applies them together
+ *
+ * @note Not thread-safe by design: it is only visible to the thread that opened it.
+ */
+class Transaction {
+public:
+    /**
+     * @brief Start recording this thread's output writes (or join the open transaction)
+     */
+    Transaction();
+
+    /**
+     * @brief commit(), or discard() if an exception thrown in its scope is propagating; never throws
+     */
+    ~Transaction();
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    /**
+     * @brief Apply everything recorded so far and keep recording
+     *
+     * Every change is attempted even if an earlier one fails. Does nothing
+     * in a joined transaction.
+     *
+     * @throws GpioAccessError naming the lines and channels that failed
+     */
+    void commit();
+
+    /**
+     * @brief Drop everything recorded so far (nothing in a joined transaction)
+     */
+    void discard();
+
+    /**
+     * @brief Lines with a pending write
+     */
+    size_t pendingLines() const;
+
+    /**
+     * @brief PWM channels and analogWrite() pins with a pending change
+     */
+    size_t pendingPwm() const;
+
+    /**
+     * @brief Whether this one joined a transaction already open on the thread
+     */
+    bool isJoined() const { return outer_ != nullptr; }
+
+    /**
+     * @brief Transaction recording this thread's writes, or nullptr
+     */
+    static Transaction* current() noexcept { return current_; }
+
+    // Recording hooks for Pin, BoardLine, HardwarePWM and analogWrite().
+
+    /**
+     * @brief Record a line write (@p fastPath may be nullptr)
+     */
+    void recordLine(GpioChip* chip, LineRequest* request, GpioMem* fastPath, uint32_t mask,
+                    unsigned int offset, bool value);
+
+    /**
+     * @brief Pending level of a line, or -1 if it has no pending write
+     */
+    int pendingLevel(const GpioChip* chip, unsigned int offset) const;
+
+    /**
+     * @brief Drop the pending writes of a line request about to be released
+     */
+    void forgetRequest(const LineRequest* request);
+
+    /**
+     * @brief Record a PWM period change (preserving the duty cycle percentage)
+     */
+    void recordPwmFrequency(HardwarePWM* pwm, uint32_t frequencyHz);
+
+    /**
+     * @brief Record a PWM duty cycle in percent (of the pending period, if any)
+     */
+    void recordPwmDutyPercent(HardwarePWM* pwm, double percent);
+
+    /**
+     * @brief Record a PWM duty cycle in nanoseconds
+     */
+    void recordPwmDutyNs(HardwarePWM* pwm, uint64_t nanoseconds);
+
+    /**
+     * @brief Drop the pending changes of a PWM channel about to be stopped
+     */
+    void forgetPwm(const HardwarePWM* pwm);
+
+    /**
+     * @brief Record an analogWrite() value (0-255)
+     */
+    void recordAnalogWrite(int pin, int value);
+
+private:
+    struct LineWrite {
+        GpioChip* chip;
+        LineRequest* request;
+        GpioMem* fastPath;
+        uint32_t mask;
+        unsigned int offset;
+        bool value;
+    };
+
+    enum class DutyKind { NONE, PERCENT, NS };
+
+    struct PwmChange {
+        HardwarePWM* pwm;
+        uint32_t frequencyHz = 0;       ///< 0 = period unchanged
+        DutyKind duty = DutyKind::NONE;
+        double percent = 0.0;
+        uint64_t ns = 0;
+    };
+
+    PwmChange& pwmEntry(HardwarePWM* pwm);
+
+    friend class ScopedTransactionBypass;
+
+    static inline thread_local Transaction* current_ = nullptr;
+
+    Transaction* outer_ = nullptr;      ///< Transaction this one joined
+    int uncaughtAtOpen_;                ///< std::uncaught_exceptions() when opened
+    std::vector<LineWrite> lines_;
+    std::vector<PwmChange> pwms_;
+    std::vector<std::pair<int, int>> analog_;    ///< Pin, value
+};
+
+/**
+ * @brief Writes on the calling thread go straight to the hardware for a scope
+ *
+ * For sequences that must not be recorded or merged: clock pulses, a
+ * display's D/C line ahead of the SPI bytes it qualifies.
+ */
+class ScopedTransactionBypass {
+public:
+    ScopedTransactionBypass() noexcept;
+    ~ScopedTransactionBypass();
+
+    ScopedTransactionBypass(const ScopedTransactionBypass&) = delete;
+    ScopedTransactionBypass& operator=(const ScopedTransactionBypass&) = delete;
+
+private:
+    Transaction* suspended_;
+};
+
+} // namespace pipinpp
@@ -0,0 +1,315 @@
+/**
+ * @file wave_sequencer.hpp
+ * @brief Precompiled multi-pin edge sequences played on a timing thread, by DMA or by PIO
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Bit-banged protocols and test patterns are usually written as a loop of
+ * digitalWrite() and delayMicroseconds() calls. Every call re-resolves the
+ * pin, each delay is relative to whenever the previous write returned, and
+ * the sequence is rebuilt every time it is sent. Here the sequence is
+ * compiled once into a Wave - a list of (set mask, clear mask, delay)
+ * steps over GPIO bank 0 - and played against absolute deadlines.
+ *
+ * - Wave: immutable once built; share it as std::shared_ptr<const Wave>
+ *   and play it any number of times on any sequencer
+ * - WaveSequencer: owns the output lines and plays waves either on a
+ *   dedicated thread (named "pipinpp-wave", subject to ThreadPolicyManager),
+ *   on BCM283x/BCM2711 with a DMA control block chain paced by the PWM
+ *   FIFO, which keeps running with no CPU involvement, or on the
+ *   Raspberry Pi 5 with an RP1 PIO state machine (pio.hpp) that times
+ *   every step to the PIO clock cycle
+ *
+ * Writes queued without a delay between them are merged into one step, so
+ * pins changed together switch together (one SET and one CLR register
+ * write, or one line request update without register access).
+ *
+ * Example usage:
+ * @code
+ * auto wave = std::make_shared<pipinpp::Wave>();
+ * wave->write(17, true).write(27, false).delay(2000)   // Both at t = 0
+ *      .write(17, false).write(27, true).delay(8000);  // Both at t = 2 µs
+ *
+ * pipinpp::WaveSequencer sequencer({17, 27});
+ * sequencer.play(wave, 100);                          // 100 passes
+ * sequencer.wait();
+ * sequencer.play(wave);                               // Same wave, no rebuild
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "pwm_timing.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PinGroup;
+
+namespace pipinpp {
+
+class GpioMem;
+class DmaChannel;
+class DmaMemory;
+class PwmPacer;
+class PioStateMachine;
+
+/**
+ * @brief Resolution of delays on the DMA backend (nanoseconds)
+ */
+constexpr uint32_t WAVE_DMA_TICK_NS = 1000;
+
+/**
+ * @brief Largest control block area the DMA backend allocates (bytes)
+ */
+constexpr size_t WAVE_DMA_MAX_BYTES = 4 * 1024 * 1024;
+
+/**
+ * @brief A step applied this much after its deadline counts as late (nanoseconds)
+ */
+constexpr int64_t WAVE_LATE_THRESHOLD_NS = 10000;
+
+/**
+ * @brief Steps handed to the PIO per transfer (bounds stop() latency on the PIO backend)
+ */
+constexpr size_t WAVE_PIO_CHUNK_STEPS = 64;
+
+/**
+ * @brief One wave step: drive pins, then hold for a delay
+ */
+struct WaveStep {
+    uint32_t setMask = 0;     ///< GPIO bank-0 pins driven HIGH
+    uint32_t clearMask = 0;   ///< GPIO bank-0 pins driven LOW
+    uint32_t delayNs = 0;     ///< Time until the next step
+};
+
+/**
+ * @brief Compiled edge sequence over GPIO 0-27
+ *
+ * Built with set()/clear()/write() and delay(); a write after a delay
+ * starts a new step, consecutive writes update the current one (the last
+ * write to a pin wins). Delays longer than a step can hold are split.
+ */
+class Wave {
+public:
+    /**
+     * @brief Drive every pin in @p mask HIGH in the current step
+     * @throws InvalidPinError if @p mask has pins above 27
+     */
+    Wave& set(uint32_t mask);
+
+    /**
+     * @brief Drive every pin in @p mask LOW in the current step
+     * @throws InvalidPinError if @p mask has pins above 27
+     */
+    Wave& clear(uint32_t mask);
+
+    /**
+     * @brief Drive one pin in the current step
+     * @throws InvalidPinError if the pin is outside 0-27
+     */
+    Wave& write(int pin, bool level);
+
+    /**
+     * @brief Hold the current levels for @p ns before the next step
+     */
+    Wave& delay(uint64_t ns);
+
+    /**
+     * @brief Append a raw step (same merging rules as set()/clear()/delay())
+     */
+    Wave& add(const WaveStep& step);
+
+    /**
+     * @brief Append every step of another wave
+     */
+    Wave& append(const Wave& other);
+
+    /**
+     * @brief Compiled steps in playback order
+     */
+    const std::vector<WaveStep>& steps() const { return steps_; }
+
+    /**
+     * @brief Every pin the wave drives
+     */
+    uint32_t pinMask() const { return pinMask_; }
+
+    /**
+     * @brief Length of one pass including the final delay
+     */
+    uint64_t durationNs() const { return durationNs_; }
+
+    size_t size() const { return steps_.size(); }
+    bool empty() const { return steps_.empty(); }
+
+private:
+    WaveStep& openStep();
+
+    std::vector<WaveStep> steps_;
+    uint32_t pinMask_ = 0;
+    uint64_t durationNs_ = 0;
+};
+
+/**
+ * @brief Backend a WaveSequencer plays on
+ */
+enum class WaveBackend {
+    THREAD,   ///< Timing thread with absolute deadlines (any board)
+    DMA,      ///< DMA control blocks paced by the PWM FIFO (BCM283x/BCM2711)
+    PIO,      ///< RP1 PIO state machine (Raspberry Pi 5)
+    AUTO      ///< PIO, then DMA, then THREAD, whichever is available first
+};
+
+/**
+ * @brief Playback statistics of the last play() (thread and PIO backends)
+ */
+struct WaveStats {
+    uint64_t passes = 0;          ///< Complete passes played
+    uint64_t steps = 0;           ///< Steps applied
+    uint64_t lateSteps = 0;       ///< Steps applied WAVE_LATE_THRESHOLD_NS or more late
+    int64_t maxLatenessNs = 0;    ///< Worst lateness seen
+};
+
+/**
+ * @brief Plays Waves on a fixed set of output pins
+ *
+ * The pins are requested as outputs (initially LOW) in one line request on
+ * construction. The thread backend drives them through the GPIO registers
+ * when /dev/gpiomem is available and through the line request otherwise.
+ *
+ * The DMA backend uses the PWM peripheral as its clock, so it cannot run
+ * together with DmaSoftPWM, DmaPWM or hardware PWM; if it is unavailable
+ * the sequencer falls back to the thread backend (see getBackend()).
+ * Finite repeat counts are unrolled into the control block chain, limited
+ * by WAVE_DMA_MAX_BYTES. The chain for the last wave played is kept, so
+ * replaying the same wave with the same repeat count restarts it without
+ * rebuilding anything.
+ *
+ * The PIO backend turns each step into two FIFO words (absolute pin
+ * levels, then the delay in PIO cycles) and feeds them from the playing
+ * thread, WAVE_PIO_CHUNK_STEPS at a time through the kernel's DMA. Delays
+ * are exact to the PIO clock (5 ns at 200 MHz), with a minimum of
+ * PIO_WAVE_STEP_CYCLES cycles per step. Pins between the sequencer's
+ * pins that it does not own are left alone. getStats() counts steps
+ * handed to the PIO, which are never late.
+ *
+ * Pins keep the level of the last step when a wave ends or is stopped.
+ * After a stop() on the PIO backend, pins the next wave does not drive
+ * may jump to the level the stopped wave would have ended with.
+ *
+ * @note Thread-safe
+ */
+class WaveSequencer {
+public:
+    /**
+     * @param pins Output pins (0-27)
+     * @param backend Preferred backend
+     * @param chipname GPIO chip name
+     * @param dmaChannel DMA channel for the DMA backend
+     * @throws InvalidPinError if the pin list is empty or invalid
+     * @throws GpioAccessError if the lines cannot be requested
+     */
+    explicit WaveSequencer(const std::vector<int>& pins, WaveBackend backend = WaveBackend::THREAD,
+                           const std::string& chipname = "gpiochip0", int dmaChannel = 5);
+    ~WaveSequencer();
+
+    WaveSequencer(const WaveSequencer&) = delete;
+    WaveSequencer& operator=(const WaveSequencer&) = delete;
+
+    /**
+     * @brief Start playing a wave, replacing the current one
+     * @param wave Compiled wave; only pins of this sequencer may be driven
+     * @param repeat Number of passes, 0 to repeat until stop()
+     * @return false if the wave is empty, drives foreign pins, has zero
+     *         duration with repeat 0, or does not fit the DMA area
+     */
+    bool play(std::shared_ptr<const Wave> wave, uint32_t repeat = 1);
+
+    /**
+     * @brief Wait for the current wave to finish
+     * @param timeoutMs Longest wait in milliseconds (0 = no limit)
+     * @return true if nothing is playing any more
+     */
+    bool wait(uint32_t timeoutMs = 0);
+
+    /**
+     * @brief Stop playback immediately
+     */
+    void stop();
+
+    /**
+     * @brief Whether a wave is playing
+     */
+    bool isPlaying() const;
+
+    /**
+     * @brief Statistics of the current or last wave (thread and PIO backends)
+     *
+     * Updated after every pass and when playback ends.
+     */
+    WaveStats getStats() const;
+
+    /**
+     * @brief Set the busy-wait tail before each step (thread backend)
+     */
+    void setSpin(int64_t spinNs) { spinNs_.store(spinNs < 0 ? 0 : spinNs, std::memory_order_relaxed); }
+
+    WaveBackend getBackend() const { return backend_; }
+    uint32_t getPinMask() const { return pinMask_; }
+
+private:
+    struct GroupStep {
+        uint64_t mask;
+        uint64_t values;
+    };
+
+    bool beginDma(int dmaChannel);
+    bool beginPio();
+    bool playPio(std::shared_ptr<const Wave> wave, uint32_t repeat);
+    void pioLoop(std::vector<uint32_t> first, std::vector<uint32_t> rest, uint32_t repeat, uint32_t holdNs);
+    void finishPlaying(const WaveStats& stats);
+    bool buildDmaChain(const Wave& wave, uint32_t repeat);
+    void playLoop(std::shared_ptr<const Wave> wave, std::vector<GroupStep> groupSteps, uint32_t repeat);
+    void applyStep(const WaveStep& step, const GroupStep* groupStep);
+    void stopLocked();
+
+    uint32_t pinMask_;
+    std::unique_ptr<PinGroup> group_;
+    GpioMem* fastPath_;
+    WaveBackend backend_;
+    std::atomic<int64_t> spinNs_;
+
+    std::mutex mutex_;                         ///< Serializes play()/stop()
+    std::mutex waitMutex_;
+    std::condition_variable done_;
+    std::thread thread_;
+    std::atomic<bool> playing_;                ///< Thread backend is running
+
+    mutable std::mutex statsMutex_;
+    WaveStats stats_;
+
+    std::unique_ptr<PwmPacer> pacer_;          ///< PWM block used as the tick clock (DMA backend)
+    std::unique_ptr<DmaChannel> dma_;          ///< DMA engine channel (DMA backend)
+    std::unique_ptr<DmaMemory> memory_;        ///< Control blocks + masks of the cached chain
+    std::shared_ptr<const Wave> dmaWave_;      ///< Wave the cached chain was built from
+    uint32_t dmaRepeat_;
+    uint32_t dmaStartBus_;
+    uint32_t tickRange_;
+
+    std::unique_ptr<PioStateMachine> pio_;     ///< PIO backend
+    uint32_t pioLevels_;                       ///< Pin levels at the end of the last wave (PIO)
+};
+
+} // namespace pipinpp
@@ -0,0 +1,214 @@
+/**
+ * @file wire_scheduler.hpp
+ * @brief Background I2C register polling with lock-free latest-value snapshots
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * @details
+ * Control loops that call Wire.readRegisters() themselves wait on the bus
+ * and on WireClass's mutex every time. WireScheduler moves that I/O onto
+ * one thread ("pipinpp-i2c<bus>") that owns the bus schedule:
+ * - Each poll is a register block on one device with its own period
+ * - Polls that are due together go out as one WireBatch (one I2C_RDWR ioctl)
+ * - Deadlines advance by whole periods, so bus usage is deterministic
+ * - Results are published into per-poll seqlock slots; latest() copies the
+ *   newest snapshot without taking a lock or touching the bus
+ *
+ * Example usage:
+ * @code
+ * #include "wire_scheduler.hpp"
+ *
+ * int main() {
+ *     Wire.begin();
+ *     pipinpp::WireScheduler scheduler;
+ *     int accel = scheduler.addPoll(0x68, 0x3B, 6, 1000);   // MPU6050 @ 1 kHz
+ *     int temp = scheduler.addPoll(0x48, 0x00, 2, 100000);  // TMP102 @ 10 Hz
+ *     scheduler.start();
+ *
+ *     pipinpp::WireSnapshot snap;
+ *     while (running) {
+ *         if (scheduler.latest(accel, snap) && snap.ok()) {
+ *             int16_t ax = (snap.data[0] << 8) | snap.data[1];
+ *             // ... control loop, never blocks on I2C
+ *         }
+ *     }
+ *     scheduler.stop();
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @author Barbatos6669
+ * @version 0.4.0
+ * @date 2025-11-21
+ */
+
+#pragma once
+
+#include "Wire.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace pipinpp {
+
+/**
+ * @brief Largest register block one poll can read (bytes)
+ */
+constexpr size_t WIRE_SNAPSHOT_MAX_BYTES = 32;
+
+/**
+ * @brief Number of polls one scheduler can hold
+ */
+constexpr size_t WIRE_SCHEDULER_MAX_POLLS = 32;
+
+/**
+ * @brief Shortest poll period (microseconds)
+ */
+constexpr uint32_t WIRE_SCHEDULER_MIN_PERIOD_US = 100;
+
+/**
+ * @brief Copy of the most recent poll of one register block
+ */
+struct WireSnapshot {
+    uint8_t data[WIRE_SNAPSHOT_MAX_BYTES] = {};  ///< Last successfully read bytes
+    size_t length = 0;             ///< Valid bytes in data
+    int64_t timestampNs = 0;       ///< CLOCK_MONOTONIC (steady_clock) time of the last poll
+    uint64_t sequence = 0;         ///< Polls published so far (successful or not)
+    int status = 0;                ///< 0 if the last poll succeeded, else errno
+    uint32_t consecutiveErrors = 0; ///< Failed polls since the last success
+
+    /**
+     * @brief Whether the last poll succeeded
+     */
+    bool ok() const { return status == 0; }
+};
+
+/**
+ * @brief Polls I2C registers at fixed rates on a background thread
+ *
+ * Polls can be added and removed while running. latest() is wait-free for
+ * readers unless it races the publish of the same slot, in which case it
+ * retries (a copy of at most 64 bytes).
+ *
+ * @note Other code can keep using the same WireClass; its transfers are
+ *       interleaved between scheduler batches by WireClass's lock
+ */
+class WireScheduler {
+public:
+    /**
+     * @param wire Bus to poll (must be begun before polls can succeed)
+     */
+    explicit WireScheduler(WireClass& wire = Wire);
+
+    /**
+     * @brief Stops the polling thread
+     */
+    ~WireScheduler();
+
+    WireScheduler(const WireScheduler&) = delete;
+    WireScheduler& operator=(const WireScheduler&) = delete;
+
+    /**
+     * @brief Register a block to poll
+     * @param address 7-bit device address
+     * @param reg Starting register
+     * @param length Bytes to read (1-WIRE_SNAPSHOT_MAX_BYTES)
+     * @param periodUs Poll period (at least WIRE_SCHEDULER_MIN_PERIOD_US)
+     * @return Poll id for latest(), or -1 on invalid arguments or when full
+     */
+    int addPoll(uint8_t address, uint8_t reg, size_t length, uint32_t periodUs);
+
+    /**
+     * @brief Stop polling a block
+     * @return true if @p id was an active poll
+     */
+    bool removePoll(int id);
+
+    /**
+     * @brief Start the polling thread
+     * @return true if started (or already running)
+     */
+    bool start();
+
+    /**
+     * @brief Stop the polling thread (snapshots stay readable)
+     *
+     * @note Safe to call multiple times
+     */
+    void stop();
+
+    /**
+     * @brief Check if the polling thread is running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Copy the newest snapshot of a poll without blocking
+     * @param id Poll id from addPoll()
+     * @param[out] out Snapshot
+     * @return false if @p id is not an active poll or has not been polled yet
+     */
+    bool latest(int id, WireSnapshot& out) const;
+
+    /**
+     * @brief Number of active polls
+     */
+    size_t getPollCount() const;
+
+    /**
+     * @brief Helper: Next deadline after a poll ran
+     *
+     * Advances by one period; if the poll is more than a full period late
+     * it is rescheduled from @p nowNs rather than run back to back.
+     */
+    static int64_t nextDeadline(int64_t deadlineNs, int64_t periodNs, int64_t nowNs);
+
+private:
+    static constexpr size_t DATA_WORDS = WIRE_SNAPSHOT_MAX_BYTES / 8;
+
+    /**
+     * @brief Seqlock-protected snapshot storage
+     *
+     * Fields are atomics accessed relaxed; the sequence counter (odd while a
+     * publish is in progress) orders them.
+     */
+    struct Slot {
+        std::atomic<bool> active{false};
+        std::atomic<uint32_t> seq{0};
+        std::atomic<uint64_t> words[DATA_WORDS];
+        std::atomic<uint32_t> length{0};
+        std::atomic<int64_t> timestampNs{0};
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<int32_t> status{0};
+        std::atomic<uint32_t> consecutiveErrors{0};
+    };
+
+    /**
+     * @brief Poll configuration, owned by configMutex_
+     */
+    struct PollConfig {
+        bool active = false;
+        uint8_t address = 0;
+        uint8_t reg = 0;
+        size_t length = 0;
+        int64_t periodNs = 0;
+        int64_t deadlineNs = 0;
+        uint32_t generation = 0;   ///< Bumped on add, so late results for a reused slot are dropped
+    };
+
+    void pollThread();
+    void publish(size_t index, const uint8_t* data, size_t length, int status, int64_t nowNs);
+
+    WireClass& wire_;
+    Slot slots_[WIRE_SCHEDULER_MAX_POLLS];
+    PollConfig polls_[WIRE_SCHEDULER_MAX_POLLS];
+    mutable std::mutex configMutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+};
+
+} // namespace pipinpp
@@ -27,8 +27,16 @@
 
 #include "ArduinoCompat.hpp"
 #include "exceptions.hpp"
+#include "board.hpp"
+#include "fast_random.hpp"
 #include "log.hpp"
-#include <unordered_map>
+#include "precise_delay.hpp"
+#include "pulse_capture.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <memory>
 #include <chrono>
 #include <thread>
@@ -38,42 +46,177 @@
 struct PinInfo {
     std::unique_ptr<Pin> pin;
     ArduinoPinMode mode;
-    bool lastValue;
+};
+
+/**
+ * Fixed pin table for Arduino-style pins.
+ *
+ * One cache-line-aligned slot per GPIO number, so threads working on
+ * different pins never share a lock or a cache line. Readers
+ * (digitalWrite/digitalRead/...) only bump the slot's reader count and
+ * load the published pointer. Writers (pinMode/tone/noTone) serialize
+ * on globalPinsMutex, swap the pointer and wait for in-flight readers
+ * of that one slot to drain before deleting the old entry. While pinMode()
+ * swaps a slot it is marked as updating, and readers that find it empty
+ * wait for the new entry instead of reporting an uninitialized pin.
+ */
+static constexpr int MAX_ARDUINO_PINS = 64; // >= every GPIO line count in PlatformInfo
+
+struct alignas(64) PinSlot {
+    std::atomic<PinInfo*> info{nullptr};
+    std::atomic<unsigned int> readers{0};
+    std::atomic<bool> updating{false};
+};
+
+class PinTable {
+public:
+    ~PinTable() {
+        for (auto& slot : slots_) {
+            delete slot.info.exchange(nullptr);
+        }
+    }
+
+    PinSlot* slot(int pin) {
+        if (pin < 0 || pin >= MAX_ARDUINO_PINS) {
+            return nullptr;
+        }
+        return &slots_[static_cast<size_t>(pin)];
+    }
+
+    // Swap in a new entry (or nullptr) and free the previous one once no
+    // reader still holds it. Caller must hold globalPinsMutex.
+    void publish(int pin, PinInfo* info) {
+        PinSlot* s = slot(pin);
+        if (!s) {
+            delete info;
+            return;
+        }
+        PinInfo* old = s->info.exchange(info);
+        while (s->readers.load() != 0) {
+            std::this_thread::yield();
+        }
+        delete old;
+    }
+
+    // Unpublish an entry and hand it to the caller once no reader still
+    // holds it. Caller must hold globalPinsMutex.
+    PinInfo* take(int pin) {
+        PinSlot* s = slot(pin);
+        if (!s) {
+            return nullptr;
+        }
+        PinInfo* old = s->info.exchange(nullptr);
+        while (s->readers.load() != 0) {
+            std::this_thread::yield();
+        }
+        return old;
+    }
+
+    bool contains(int pin) {
+        PinSlot* s = slot(pin);
+        return s && s->info.load() != nullptr;
+    }
+
+private:
+    std::array<PinSlot, MAX_ARDUINO_PINS> slots_;
+};
+
+/**
+ * RAII read access to one pin slot (lock-free)
+ */
+class PinRef {
+public:
+    explicit PinRef(PinSlot* slot) : slot_(slot), info_(nullptr) {
+        if (!slot_) {
+            return;
+        }
+        for (;;) {
+            slot_->readers.fetch_add(1);
+            info_ = slot_->info.load();
+            if (info_ || !slot_->updating.load()) {
+                return;
+            }
+            // pinMode() is swapping this slot: step aside until it publishes
+            slot_->readers.fetch_sub(1);
+            std::this_thread::yield();
+        }
+    }
+    ~PinRef() {
+        if (slot_) {
+            slot_->readers.fetch_sub(1);
+        }
+    }
+    PinRef(const PinRef&) = delete;
+    PinRef& operator=(const PinRef&) = delete;
+
+    PinInfo* operator->() const { return info_; }
+    explicit operator bool() const { return info_ != nullptr; }
+
+private:
+    PinSlot* slot_;
+    PinInfo* info_;
+};
+
+/**
+ * Marks a slot as being swapped for the lifetime of the object
+ */
+class PinUpdate {
+public:
+    explicit PinUpdate(PinSlot* slot) : slot_(slot) {
+        if (slot_) {
+            slot_->updating.store(true);
+        }
+    }
+    ~PinUpdate() {
+        if (slot_) {
+            slot_->updating.store(false);
+        }
+    }
+    PinUpdate(const PinUpdate&) = delete;
+    PinUpdate& operator=(const PinUpdate&) = delete;
+
+private:
+    PinSlot* slot_;
 };
 
 // Global storage for Arduino-style pins
-static std::unordered_map<int, PinInfo> globalPins;
-// Mutex to protect globalPins from concurrent access
+static PinTable globalPins;
+// Serializes writers (pinMode/tone/noTone); readers never take it
 static std::mutex globalPinsMutex;
 
 void pinMode(int pin, int mode) 
 {
     std::lock_guard<std::mutex> lock(globalPinsMutex);
-    // Remove existing pin if it exists
-    globalPins.erase(pin);
-    
-    // Create new pin with specified mode
-    // Exceptions will propagate naturally (InvalidPinError, GpioAccessError)
-    PinInfo pinInfo;
+
+    PinMode lineMode = PinMode::INPUT;
+    ArduinoPinMode arduinoMode = ArduinoPinMode::INPUT;
     if (mode == OUTPUT) {
-        pinInfo.pin = std::make_unique<Pin>(pin, PinDirection::OUTPUT);
-        pinInfo.mode = ArduinoPinMode::OUTPUT;
-        pinInfo.lastValue = false;
+        lineMode = PinMode::OUTPUT;
+        arduinoMode = ArduinoPinMode::OUTPUT;
     } else if (mode == INPUT_PULLUP) {
-        pinInfo.pin = std::make_unique<Pin>(pin, PinMode::INPUT_PULLUP);
-        pinInfo.mode = ArduinoPinMode::INPUT_PULLUP;
-        pinInfo.lastValue = false;
+        lineMode = PinMode::INPUT_PULLUP;
+        arduinoMode = ArduinoPinMode::INPUT_PULLUP;
     } else if (mode == INPUT_PULLDOWN) {
-        pinInfo.pin = std::make_unique<Pin>(pin, PinMode::INPUT_PULLDOWN);
-        pinInfo.mode = ArduinoPinMode::INPUT_PULLDOWN;
-        pinInfo.lastValue = false;
-    } else {
-        pinInfo.pin = std::make_unique<Pin>(pin, PinDirection::INPUT);
-        pinInfo.mode = ArduinoPinMode::INPUT;
-        pinInfo.lastValue = false;
+        lineMode = PinMode::INPUT_PULLDOWN;
+        arduinoMode = ArduinoPinMode::INPUT_PULLDOWN;
     }
+
+    // A pin already set up keeps its line request: changing the mode is a
+    // single reconfigure instead of a release and a new request
+    PinUpdate update(globalPins.slot(pin));
+    std::unique_ptr<PinInfo> pinInfo(globalPins.take(pin));
+    if (pinInfo && !pinInfo->pin->reconfigure(lineMode)) {
+        pinInfo.reset();    // Release the line before requesting it again
+    }
+
+    if (!pinInfo) {
+        // Exceptions will propagate naturally (InvalidPinError, GpioAccessError)
+        pinInfo = std::make_unique<PinInfo>();
+        pinInfo->pin = std::make_unique<Pin>(pin, lineMode);
+    }
+    pinInfo->mode = arduinoMode;
     
-    globalPins[pin] = std::move(pinInfo);
+    globalPins.publish(pin, pinInfo.release());
     
     PIPINPP_LOG_INFO("pinMode: Set pin " << pin << " to " 
                      << ((mode == OUTPUT) ? "OUTPUT" : 
@@ -83,29 +226,64 @@ void pinMode(int pin, int mode)
 
 void digitalWrite(int pin, bool value) 
 {
-    std::lock_guard<std::mutex> lock(globalPinsMutex);
-    auto it = globalPins.find(pin);
-    if (it == globalPins.end()) {
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
         throw InvalidPinError(pin, "Pin not initialized. Call pinMode() first.");
     }
     
-    bool success = it->second.pin->write(value);
-    if (success) {
-        it->second.lastValue = value;  // Track the last written value
-    } else {
+    if (!info->pin->write(value)) {
         throw GpioAccessError("pin " + std::to_string(pin), "Failed to write to GPIO pin");
     }
 }
 
 int digitalRead(int pin) 
 {
-    std::lock_guard<std::mutex> lock(globalPinsMutex);
-    auto it = globalPins.find(pin);
-    if (it == globalPins.end()) {
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
         throw InvalidPinError(pin, "Pin not initialized. Call pinMode() first.");
     }
     
-    return it->second.pin->read();
+    return info->pin->read();
+}
+
+std::error_code tryDigitalWrite(int pin, bool value) noexcept
+{
+    if (!pipinpp::isValidGpioPin(pin)) {
+        return pipinpp::GpioErrc::INVALID_PIN;
+    }
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
+        return pipinpp::GpioErrc::NOT_CONFIGURED;
+    }
+    return info->pin->writeNoexcept(value);
+}
+
+std::error_code tryDigitalRead(int pin, int& value) noexcept
+{
+    if (!pipinpp::isValidGpioPin(pin)) {
+        return pipinpp::GpioErrc::INVALID_PIN;
+    }
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
+        return pipinpp::GpioErrc::NOT_CONFIGURED;
+    }
+    return info->pin->readNoexcept(value);
+}
+
+std::error_code tryDigitalToggle(int pin) noexcept
+{
+    if (!pipinpp::isValidGpioPin(pin)) {
+        return pipinpp::GpioErrc::INVALID_PIN;
+    }
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
+        return pipinpp::GpioErrc::NOT_CONFIGURED;
+    }
+    int level = info->pin->getOutputState();
+    if (level < 0) {
+        return pipinpp::GpioErrc::WRONG_DIRECTION;
+    }
+    return info->pin->writeNoexcept(level == 0);
 }
 
 // Removed duplicate delay(unsigned long ms) implementation
@@ -114,75 +292,85 @@ int digitalRead(int pin)
 /*                        MATH FUNCTIONS                       */
 /* ------------------------------------------------------------ */
 
-int constrain(int x, int min, int max) 
+// Scalar constrain()/map() are inline in ArduinoCompat.hpp. The block
+// versions below are written as branch-free selects so -O3 vectorizes them.
+
+namespace {
+
+inline int16_t saturate16(int64_t value)
 {
-    if (x < min) {
-        return min;
-    } else if (x > max) {
-        return max;
-    } else {
-        return x;
-    }
+    return static_cast<int16_t>(value < INT16_MIN ? INT16_MIN : (value > INT16_MAX ? INT16_MAX : value));
 }
 
-long constrain(long x, long min, long max) 
+} // namespace
+
+void map(const int16_t* in, int16_t* out, size_t count, long in_min, long in_max, long out_min, long out_max)
 {
-    if (x < min) {
-        return min;
-    } else if (x > max) {
-        return max;
-    } else {
-        return x;
+    if (in == nullptr || out == nullptr) {
+        return;
+    }
+    if (in_max == in_min) {
+        std::fill(out, out + count, saturate16(out_min));
+        return;
+    }
+    
+    // For integers a and d, the correctly rounded quotient a / d truncates to
+    // the integer quotient as long as |a| < 2^53: a non-integer quotient is at
+    // least 1/|d| from the next integer, more than the rounding error. With
+    // quotient and out_min also inside 2^30 the sum fits an int32, and the
+    // loop needs only double and int32 lanes, which vectorize everywhere.
+    const double EXACT_LIMIT = 9007199254740992.0;   // 2^53
+    const double INT_LIMIT = 1073741824.0;           // 2^30
+    const double outSpan = static_cast<double>(out_max) - static_cast<double>(out_min);
+    const double inSpan = static_cast<double>(in_max) - static_cast<double>(in_min);
+    const double largestOffset = std::max(std::fabs(INT16_MIN - static_cast<double>(in_min)),
+                                          std::fabs(INT16_MAX - static_cast<double>(in_min)));
+    const double largestProduct = largestOffset * std::fabs(outSpan);
+    if (largestProduct >= EXACT_LIMIT || std::fabs(inSpan) >= EXACT_LIMIT ||
+        largestProduct / std::fabs(inSpan) >= INT_LIMIT || std::fabs(static_cast<double>(out_min)) >= INT_LIMIT) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = saturate16(map(in[i], in_min, in_max, out_min, out_max));
+        }
+        return;
+    }
+    
+    const double inMin = static_cast<double>(in_min);
+    const int32_t outMin = static_cast<int32_t>(out_min);
+    for (size_t i = 0; i < count; ++i) {
+        int32_t mapped = static_cast<int32_t>((static_cast<double>(in[i]) - inMin) * outSpan / inSpan) + outMin;
+        out[i] = static_cast<int16_t>(mapped < INT16_MIN ? INT16_MIN : (mapped > INT16_MAX ? INT16_MAX : mapped));
     }
 }
 
-float constrain(float x, float min, float max) 
+void constrain(const int16_t* in, int16_t* out, size_t count, int16_t min, int16_t max)
 {
-    if (x < min) {
-        return min;
-    } else if (x > max) {
-        return max;
-    } else {
-        return x;
+    if (in == nullptr || out == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int16_t x = in[i];
+        out[i] = x < min ? min : (x > max ? max : x);
     }
 }
 
-long map(long x, long in_min, long in_max, long out_min, long out_max) 
+void constrain(const float* in, float* out, size_t count, float min, float max)
 {
-    // Prevent division by zero
-    if (in_max == in_min) {
-        return out_min;  // Return minimum output if input range is zero
+    if (in == nullptr || out == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        float x = in[i];
+        out[i] = x < min ? min : (x > max ? max : x);
     }
-    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
 /* ------------------------------------------------------------ */
 /*                        TIMING FUNCTIONS                      */
 /* ------------------------------------------------------------ */
 
-unsigned long millis() 
-{
-    static const auto start = std::chrono::steady_clock::now();
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
-    return static_cast<unsigned long>(elapsed);
-}
-
-unsigned long micros() 
-{
-    static const auto start = std::chrono::steady_clock::now();
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
-    return static_cast<unsigned long>(elapsed);
-}
-
 void delayMicroseconds(unsigned int us) 
 {
-    auto start = std::chrono::steady_clock::now();
-    auto duration = std::chrono::microseconds(us);
-    while (std::chrono::steady_clock::now() - start < duration) {
-        // Busy-wait for microsecond precision
-    }
+    pipinpp::preciseDelayUs(us);
 }
 
 void delay(unsigned long ms) 
@@ -215,15 +403,8 @@ void attachInterrupt(int pin, void (*callback)(), int mode)
                                 ". Use RISING, FALLING, or CHANGE");
     }
     
-    // Wrap the C-style function pointer in a std::function
-    InterruptCallback wrappedCallback = [callback]() {
-        if (callback) {
-            callback();
-        }
-    };
-    
-    // Attach interrupt using InterruptManager
-    InterruptManager::getInstance().attachInterrupt(pin, wrappedCallback, intMode);
+    // The function pointer is stored as is; a null one is rejected as an empty callback
+    InterruptManager::getInstance().attachInterrupt(pin, callback, intMode);
     
     PIPINPP_LOG_INFO("attachInterrupt: Attached to pin " << pin 
                      << " mode=" << mode);
@@ -239,7 +420,8 @@ void detachInterrupt(int pin)
 /*                        PWM FUNCTIONS                         */
 /* ------------------------------------------------------------ */
 
-#include "pwm.hpp"
+#include "pwm_backend.hpp"
+#include "transaction.hpp"
 
 void analogWrite(int pin, int value) 
 {
@@ -247,10 +429,17 @@ void analogWrite(int pin, int value)
     if (value < 0) value = 0;
     if (value > 255) value = 255;
     
-    // Start or update PWM
-    PWMManager::getInstance().startPWM(pin, value);
+    if (pipinpp::Transaction* txn = pipinpp::Transaction::current()) {
+        txn->recordAnalogWrite(pin, value);
+        return;
+    }
     
-    PIPINPP_LOG_INFO("analogWrite: Pin " << pin << " set to " << value);
+    // Start or update PWM on the cheapest backend the pin supports
+    pipinpp::PwmBackend backend = pipinpp::PwmRouter::getInstance().write(pin, value);
+    (void)backend;
+    
+    PIPINPP_LOG_INFO("analogWrite: Pin " << pin << " set to " << value
+                     << " (" << pipinpp::pwmBackendName(backend) << ")");
 }   
 
 // ============================================================================
@@ -259,22 +448,20 @@ void analogWrite(int pin, int value)
 
 bool isOutput(int pin) 
 {
-    std::lock_guard<std::mutex> lock(globalPinsMutex);
-    auto it = globalPins.find(pin);
-    if (it == globalPins.end()) {
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
         throw PinError("Pin " + std::to_string(pin) + " not initialized. Call pinMode() first.");
     }
-    return it->second.mode == ArduinoPinMode::OUTPUT;
+    return info->mode == ArduinoPinMode::OUTPUT;
 }
 
 bool isInput(int pin) 
 {
-    std::lock_guard<std::mutex> lock(globalPinsMutex);
-    auto it = globalPins.find(pin);
-    if (it == globalPins.end()) {
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
         throw PinError("Pin " + std::to_string(pin) + " not initialized. Call pinMode() first.");
     }
-    ArduinoPinMode mode = it->second.mode;
+    ArduinoPinMode mode = info->mode;
     return mode == ArduinoPinMode::INPUT || 
            mode == ArduinoPinMode::INPUT_PULLUP || 
            mode == ArduinoPinMode::INPUT_PULLDOWN;
@@ -282,33 +469,27 @@ bool isInput(int pin)
 
 ArduinoPinMode getMode(int pin) 
 {
-    std::lock_guard<std::mutex> lock(globalPinsMutex);
-    auto it = globalPins.find(pin);
-    if (it == globalPins.end()) {
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
         throw PinError("Pin " + std::to_string(pin) + " not initialized. Call pinMode() first.");
     }
-    return it->second.mode;
+    return info->mode;
 }
 
 void digitalToggle(int pin) 
 {
-    std::lock_guard<std::mutex> lock(globalPinsMutex);
-    auto it = globalPins.find(pin);
-    if (it == globalPins.end()) {
+    PinRef info(globalPins.slot(pin));
+    if (!info) {
         throw PinError("Pin " + std::to_string(pin) + " not initialized. Call pinMode() first.");
     }
     
-    if (it->second.mode != ArduinoPinMode::OUTPUT) {
+    if (info->mode != ArduinoPinMode::OUTPUT) {
         throw PinError("Pin " + std::to_string(pin) + " must be OUTPUT to toggle. "
-                      "Current mode: " + std::to_string(static_cast<int>(it->second.mode)));
+                      "Current mode: " + std::to_string(static_cast<int>(info->mode)));
     }
     
-    // Toggle efficiently - no need to read current value
-    bool newValue = !it->second.lastValue;
-    bool success = it->second.pin->write(newValue);
-    if (success) {
-        it->second.lastValue = newValue;  // Only update if write succeeded
-    } else {
+    // Toggle from the chip's output shadow - no read of the line
+    if (!info->pin->toggle()) {
         throw GpioAccessError("pin " + std::to_string(pin), "Failed to toggle GPIO pin");
     }
 }
@@ -317,16 +498,10 @@ void digitalToggle(int pin)
 /*                    RANDOM FUNCTIONS                          */
 /* ------------------------------------------------------------ */
 
-#include <random>
-
-// Static random engine and distribution (thread-safe via mutex)
-static std::mt19937 randomEngine;
-static std::mutex randomMutex;
-
+// Each thread draws from its own engine (fast_random.cpp), so no lock here
 void randomSeed(unsigned long seed)
 {
-    std::lock_guard<std::mutex> lock(randomMutex);
-    randomEngine.seed(seed);
+    pipinpp::setRandomSeedValue(seed);
 }
 
 long random(long max)
@@ -334,9 +509,7 @@ long random(long max)
     if (max <= 0) {
         return 0;
     }
-    std::lock_guard<std::mutex> lock(randomMutex);
-    std::uniform_int_distribution<long> dist(0, max - 1);
-    return dist(randomEngine);
+    return static_cast<long>(pipinpp::threadRandomEngine().below(static_cast<uint64_t>(max)));
 }
 
 long random(long min, long max)
@@ -344,9 +517,9 @@ long random(long min, long max)
     if (min >= max) {
         return min;
     }
-    std::lock_guard<std::mutex> lock(randomMutex);
-    std::uniform_int_distribution<long> dist(min, max - 1);
-    return dist(randomEngine);
+    // Unsigned arithmetic: max - min may not fit in a long
+    const uint64_t range = static_cast<unsigned long>(max) - static_cast<unsigned long>(min);
+    return static_cast<long>(static_cast<unsigned long>(min) + pipinpp::threadRandomEngine().below(range));
 }
 
 /* ------------------------------------------------------------ */
@@ -356,24 +529,30 @@ long random(long min, long max)
 unsigned long pulseIn(int pin, bool state, unsigned long timeout)
 {
     // Validate pin number first (before acquiring mutex)
-    if (pin < 0 || pin > 27) {
+    if (!pipinpp::isValidGpioPin(pin)) {
         throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
                              ". Valid range is 0-27.");
     }
     
-    // Verify pin is INPUT (don't auto-configure to avoid deadlock)
+    // Verify pin is INPUT (don't auto-configure)
     {
-        std::lock_guard<std::mutex> lock(globalPinsMutex);
-        auto it = globalPins.find(pin);
-        if (it == globalPins.end()) {
+        PinRef info(globalPins.slot(pin));
+        if (!info) {
             throw PinError("Pin " + std::to_string(pin) + 
                           " not initialized. Call pinMode(pin, INPUT) first.");
-        } else if (it->second.mode == ArduinoPinMode::OUTPUT) {
+        } else if (info->mode == ArduinoPinMode::OUTPUT) {
             throw PinError("Pin " + std::to_string(pin) + " is configured as OUTPUT. "
                           "Cannot use pulseIn() on output pins.");
         }
+        
+        // Kernel edge timestamps: exact widths, and the wait blocks instead of spinning
+        long width = pipinpp::measurePulse(*info->pin, state, timeout);
+        if (width >= 0) {
+            return static_cast<unsigned long>(width);
+        }
     }
     
+    // No edge detection on this line: poll
     auto start = std::chrono::steady_clock::now();
     auto timeoutDuration = std::chrono::microseconds(timeout);
     
@@ -404,116 +583,116 @@ unsigned long pulseIn(int pin, bool state, unsigned long timeout)
     return static_cast<unsigned long>(duration.count());
 }
 
-void shiftOut(int dataPin, int clockPin, int bitOrder, unsigned char value)
+// Pin lookups and mode checks happen once per call, not once per bit
+static void shiftOutPins(const char* caller, int dataPin, int clockPin, int bitOrder,
+                         const uint8_t* data, size_t length, unsigned int clockDelayNs)
 {
     // Validate pin numbers first (before acquiring mutex)
-    if (dataPin < 0 || dataPin > 27) {
+    if (!pipinpp::isValidGpioPin(dataPin)) {
         throw InvalidPinError("Invalid data pin number: " + std::to_string(dataPin) + 
                              ". Valid range is 0-27.");
     }
-    if (clockPin < 0 || clockPin > 27) {
+    if (!pipinpp::isValidGpioPin(clockPin)) {
         throw InvalidPinError("Invalid clock pin number: " + std::to_string(clockPin) + 
                              ". Valid range is 0-27.");
     }
+    if (data == nullptr && length > 0) {
+        throw std::invalid_argument("shiftOutBuffer() data cannot be null");
+    }
     
-    // Verify pins are OUTPUT. Don't auto-configure with pinMode() here, as that
-    // would acquire globalPinsMutex while it is already held, causing a deadlock.
-    // (pinMode() locks globalPinsMutex internally.)
-    {
-        std::lock_guard<std::mutex> lock(globalPinsMutex);
-        if (globalPins.find(dataPin) == globalPins.end() || 
-            globalPins[dataPin].mode != ArduinoPinMode::OUTPUT) {
-            throw PinError("Pin " + std::to_string(dataPin) + 
-                          " must be OUTPUT for shiftOut(). Call pinMode() first.");
-        }
-        if (globalPins.find(clockPin) == globalPins.end() || 
-            globalPins[clockPin].mode != ArduinoPinMode::OUTPUT) {
-            throw PinError("Pin " + std::to_string(clockPin) + 
-                          " must be OUTPUT for shiftOut(). Call pinMode() first.");
-        }
+    // Verify pins are OUTPUT. Don't auto-configure with pinMode() here;
+    // reconfiguring a pin is an explicit user decision.
+    PinRef dataInfo(globalPins.slot(dataPin));
+    if (!dataInfo || dataInfo->mode != ArduinoPinMode::OUTPUT) {
+        throw PinError("Pin " + std::to_string(dataPin) + 
+                      " must be OUTPUT for " + caller + ". Call pinMode() first.");
+    }
+    PinRef clockInfo(globalPins.slot(clockPin));
+    if (!clockInfo || clockInfo->mode != ArduinoPinMode::OUTPUT) {
+        throw PinError("Pin " + std::to_string(clockPin) + 
+                      " must be OUTPUT for " + caller + ". Call pinMode() first.");
     }
     
-    for (int i = 0; i < 8; i++) {
-        bool bitValue;
-        if (bitOrder == LSBFIRST) {
-            bitValue = !!(value & (1 << i));  // LSB first
-        } else {
-            bitValue = !!(value & (1 << (7 - i)));  // MSB first
-        }
-        
-        digitalWrite(dataPin, bitValue);
-        digitalWrite(clockPin, HIGH);
-        // Small delay for clock pulse (optional, can be removed for speed)
-        delayMicroseconds(1);
-        digitalWrite(clockPin, LOW);
+    bool msbFirst = (bitOrder != LSBFIRST);
+    if (!dataInfo->pin->shiftOut(*clockInfo->pin, msbFirst, data, length, clockDelayNs)) {
+        throw GpioAccessError("pin " + std::to_string(dataPin), "Failed to shift out data");
     }
 }
 
-unsigned char shiftIn(int dataPin, int clockPin, int bitOrder)
+static void shiftInPins(const char* caller, int dataPin, int clockPin, int bitOrder,
+                        uint8_t* data, size_t length, unsigned int clockDelayNs)
 {
     // Validate pin numbers first (before acquiring mutex)
-    if (dataPin < 0 || dataPin > 27) {
+    if (!pipinpp::isValidGpioPin(dataPin)) {
         throw InvalidPinError("Invalid data pin number: " + std::to_string(dataPin) + 
                              ". Valid range is 0-27.");
     }
-    if (clockPin < 0 || clockPin > 27) {
+    if (!pipinpp::isValidGpioPin(clockPin)) {
         throw InvalidPinError("Invalid clock pin number: " + std::to_string(clockPin) + 
                              ". Valid range is 0-27.");
     }
+    if (data == nullptr && length > 0) {
+        throw std::invalid_argument("shiftInBuffer() data cannot be null");
+    }
     
     // Verify dataPin is INPUT and clockPin is OUTPUT. Don't auto-configure with
-    // pinMode() here, as that would acquire globalPinsMutex while it is already
-    // held, causing a deadlock. (pinMode() locks globalPinsMutex internally.)
-    // Also can't call isInput() helper as it also locks the mutex.
-    {
-        std::lock_guard<std::mutex> lock(globalPinsMutex);
-        auto dataIt = globalPins.find(dataPin);
-        if (dataIt == globalPins.end()) {
-            throw PinError("Pin " + std::to_string(dataPin) + 
-                          " not initialized. Call pinMode() first.");
-        }
-        ArduinoPinMode dataMode = dataIt->second.mode;
-        bool isInputMode = (dataMode == ArduinoPinMode::INPUT || 
-                           dataMode == ArduinoPinMode::INPUT_PULLUP || 
-                           dataMode == ArduinoPinMode::INPUT_PULLDOWN);
-        if (!isInputMode) {
-            throw PinError("Pin " + std::to_string(dataPin) + 
-                          " must be INPUT for shiftIn(). Call pinMode() first.");
-        }
-        
-        if (globalPins.find(clockPin) == globalPins.end() || 
-            globalPins[clockPin].mode != ArduinoPinMode::OUTPUT) {
-            throw PinError("Pin " + std::to_string(clockPin) + 
-                          " must be OUTPUT for shiftIn(). Call pinMode() first.");
-        }
+    // pinMode() here; reconfiguring a pin is an explicit user decision.
+    PinRef dataInfo(globalPins.slot(dataPin));
+    if (!dataInfo) {
+        throw PinError("Pin " + std::to_string(dataPin) + 
+                      " not initialized. Call pinMode() first.");
+    }
+    ArduinoPinMode dataMode = dataInfo->mode;
+    bool isInputMode = (dataMode == ArduinoPinMode::INPUT || 
+                       dataMode == ArduinoPinMode::INPUT_PULLUP || 
+                       dataMode == ArduinoPinMode::INPUT_PULLDOWN);
+    if (!isInputMode) {
+        throw PinError("Pin " + std::to_string(dataPin) + 
+                      " must be INPUT for " + caller + ". Call pinMode() first.");
     }
     
-    unsigned char value = 0;
-    
-    for (int i = 0; i < 8; i++) {
-        digitalWrite(clockPin, HIGH);
-        delayMicroseconds(1);  // Small delay for data to stabilize
-        
-        bool bitValue = digitalRead(dataPin);
-        
-        if (bitOrder == LSBFIRST) {
-            value |= (bitValue << i);  // LSB first
-        } else {
-            value |= (bitValue << (7 - i));  // MSB first
-        }
-        
-        digitalWrite(clockPin, LOW);
-        delayMicroseconds(1);
+    PinRef clockInfo(globalPins.slot(clockPin));
+    if (!clockInfo || clockInfo->mode != ArduinoPinMode::OUTPUT) {
+        throw PinError("Pin " + std::to_string(clockPin) + 
+                      " must be OUTPUT for " + caller + ". Call pinMode() first.");
     }
     
+    if (!dataInfo->pin->shiftIn(*clockInfo->pin, bitOrder != LSBFIRST, data, length, clockDelayNs)) {
+        throw GpioAccessError("pin " + std::to_string(dataPin), "Failed to shift in data");
+    }
+}
+
+void shiftOut(int dataPin, int clockPin, int bitOrder, unsigned char value)
+{
+    // 1 µs setup and clock high time, as slow as the original bit-bang loop
+    uint8_t byte = value;
+    shiftOutPins("shiftOut()", dataPin, clockPin, bitOrder, &byte, 1, 1000);
+}
+
+void shiftOutBuffer(int dataPin, int clockPin, int bitOrder, const uint8_t* data, size_t length,
+                    unsigned int clockDelayNs)
+{
+    shiftOutPins("shiftOutBuffer()", dataPin, clockPin, bitOrder, data, length, clockDelayNs);
+}
+
+unsigned char shiftIn(int dataPin, int clockPin, int bitOrder)
+{
+    uint8_t value = 0;
+    shiftInPins("shiftIn()", dataPin, clockPin, bitOrder, &value, 1, 1000);
     return value;
 }
 
+void shiftInBuffer(int dataPin, int clockPin, int bitOrder, uint8_t* data, size_t length,
+                   unsigned int clockDelayNs)
+{
+    shiftInPins("shiftInBuffer()", dataPin, clockPin, bitOrder, data, length, clockDelayNs);
+}
+
 // Tone generation - uses PWM with 50% duty cycle
 void tone(int pin, unsigned int frequency, unsigned long duration)
 {
     // Validate pin number first (before any other checks)
-    if (pin < 0 || pin > 27) {
+    if (!pipinpp::isValidGpioPin(pin)) {
         throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
                              ". Valid range is 0-27.");
     }
@@ -526,22 +705,24 @@ void tone(int pin, unsigned int frequency, unsigned long duration)
     // If pin is held by pinMode(), release it so PWM can create its own Pin object.
     {
         std::lock_guard<std::mutex> lock(globalPinsMutex);
-        auto it = globalPins.find(pin);
-        if (it == globalPins.end()) {
-            throw PinError("Pin " + std::to_string(pin) + 
-                          " must be configured with pinMode(pin, OUTPUT) before calling tone().");
-        }
-        if (it->second.mode != ArduinoPinMode::OUTPUT) {
-            throw PinError("Pin " + std::to_string(pin) + 
-                          " must be OUTPUT for tone(). Call pinMode(pin, OUTPUT) first.");
+        {
+            PinRef info(globalPins.slot(pin));
+            if (!info) {
+                throw PinError("Pin " + std::to_string(pin) + 
+                              " must be configured with pinMode(pin, OUTPUT) before calling tone().");
+            }
+            if (info->mode != ArduinoPinMode::OUTPUT) {
+                throw PinError("Pin " + std::to_string(pin) + 
+                              " must be OUTPUT for tone(). Call pinMode(pin, OUTPUT) first.");
+            }
         }
         // Release the pin so PWM can take control (creates its own Pin object)
-        globalPins.erase(it);
+        globalPins.publish(pin, nullptr);
     }
     
     // Start PWM at 50% duty cycle with specified frequency
-    // PWMManager will create its own Pin object
-    PWMManager::getInstance().startPWM(pin, 128, frequency);  // 128 = 50% of 255
+    // The PWM backend claims the pin itself (hardware channel, DMA or its own line request)
+    pipinpp::PwmRouter::getInstance().write(pin, 128, static_cast<int>(frequency));  // 128 = 50% of 255
     
     // If duration specified, wait and then stop
     if (duration > 0) {
@@ -556,26 +737,25 @@ void tone(int pin, unsigned int frequency, unsigned long duration)
 void noTone(int pin)
 {
     // Validate pin number
-    if (pin < 0 || pin > 27) {
+    if (!pipinpp::isValidGpioPin(pin)) {
         throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
                              ". Valid range is 0-27.");
     }
     
     // Stop PWM (which stops the tone)
-    // PWMManager's stopPWM() will set pin LOW and clean up the PWM channel
-    PWMManager::getInstance().stopPWM(pin);
+    // The backend's stop sets the pin LOW and releases its channel
+    pipinpp::PwmRouter::getInstance().stop(pin);
     
     // Re-add pin to globalPins so it can be used again with tone() or digitalWrite()
     // Note: tone() erased it from globalPins to let PWM have exclusive control
     {
         std::lock_guard<std::mutex> lock(globalPinsMutex);
-        if (globalPins.find(pin) == globalPins.end()) {
+        if (!globalPins.contains(pin)) {
             // Pin was erased by tone(), recreate it as OUTPUT
-            PinInfo pinInfo;
-            pinInfo.pin = std::make_unique<Pin>(pin, PinDirection::OUTPUT);
-            pinInfo.mode = ArduinoPinMode::OUTPUT;
-            pinInfo.lastValue = false;
-            globalPins[pin] = std::move(pinInfo);
+            std::unique_ptr<PinInfo> pinInfo = std::make_unique<PinInfo>();
+            pinInfo->pin = std::make_unique<Pin>(pin, PinDirection::OUTPUT);
+            pinInfo->mode = ArduinoPinMode::OUTPUT;
+            globalPins.publish(pin, pinInfo.release());
         }
     }
     
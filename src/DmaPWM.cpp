@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2025 HobbyHacker
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file DmaPWM.cpp
+ * @brief Implementation of register-level PWM with DMA-paced duty sequences
+ * @author Barbatos6669
+ * @date 2025-11-21
+ */
+
+#include "DmaPWM.hpp"
+#include "log.hpp"
+#include "exceptions.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint32_t GPIO_FUNCTION_ALT0 = 4;
+constexpr uint32_t GPIO_FUNCTION_ALT5 = 2;
+
+} // namespace
+
+DmaPWM::DmaPWM(int gpioPin, int dmaChannel)
+    : pin_(gpioPin)
+    , dmaChannel_(dmaChannel)
+    , pwmChannel_(0)
+    , altFunction_(0)
+    , savedFunction_(0)
+    , sampleRateHz_(0)
+    , range_(0)
+{
+    if (!gpioToChannel(gpioPin, pwmChannel_, altFunction_)) {
+        throw InvalidPinError(gpioPin, "No PWM function (use GPIO 12, 13, 18 or 19)");
+    }
+    if (dmaChannel < 0 || dmaChannel > 14) {
+        throw InvalidPinError("Invalid DMA channel " + std::to_string(dmaChannel) + ": valid range is 0-14");
+    }
+    
+    PIPINPP_LOG_DEBUG("DmaPWM created: GPIO" << pin_ << " → PWM" << pwmChannel_
+                      << ", DMA channel " << dmaChannel_);
+}
+
+DmaPWM::~DmaPWM()
+{
+    end();
+}
+
+bool DmaPWM::gpioToChannel(int gpioPin, int& pwmChannel, uint32_t& altFunction)
+{
+    switch (gpioPin) {
+        case 12: pwmChannel = 0; altFunction = GPIO_FUNCTION_ALT0; return true;
+        case 13: pwmChannel = 1; altFunction = GPIO_FUNCTION_ALT0; return true;
+        case 18: pwmChannel = 0; altFunction = GPIO_FUNCTION_ALT5; return true;
+        case 19: pwmChannel = 1; altFunction = GPIO_FUNCTION_ALT5; return true;
+        default: return false;
+    }
+}
+
+bool DmaPWM::computeClockDivisor(uint32_t oscillatorHz, uint32_t sampleRateHz,
+                                 uint32_t range, uint32_t& divisor)
+{
+    if (range < 2) {
+        return false;
+    }
+    uint64_t clockHz = static_cast<uint64_t>(sampleRateHz) * range;
+    if (clockHz == 0 || clockHz > oscillatorHz) {
+        return false;
+    }
+    return PwmPacer::computeDivisor(oscillatorHz, static_cast<uint32_t>(clockHz), divisor);
+}
+
+bool DmaPWM::begin(uint32_t sampleRateHz, uint32_t range)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (pacer_) {
+        PIPINPP_LOG_WARNING("DmaPWM on GPIO" << pin_ << " already started");
+        return true;
+    }
+    
+    uint32_t divisor = 0;
+    if (!computeClockDivisor(PwmPacer::oscillatorHz(), sampleRateHz, range, divisor)) {
+        PIPINPP_LOG_ERROR("Sample rate " << sampleRateHz << " Hz with range " << range
+                          << " cannot be generated from the " << PwmPacer::oscillatorHz()
+                          << " Hz oscillator");
+        return false;
+    }
+    
+    try {
+        gpio_.reset(new PeripheralMap(dma::GPIO_OFFSET));
+        pacer_.reset(new PwmPacer());
+        dma_.reset(new DmaChannel(dmaChannel_));
+    } catch (const PinError& e) {
+        PIPINPP_LOG_ERROR("DmaPWM unavailable: " << e.what());
+        (void)e; // Only used when logging is enabled
+        dma_.reset();
+        pacer_.reset();
+        gpio_.reset();
+        return false;
+    }
+    
+    uint32_t clockHz = pacer_->setClock(static_cast<uint32_t>(PwmPacer::oscillatorHz() / divisor));
+    if (clockHz == 0) {
+        dma_.reset();
+        pacer_.reset();
+        gpio_.reset();
+        return false;
+    }
+    
+    range_ = range;
+    sampleRateHz_ = clockHz / range;
+    pacer_->startFifo(pwmChannel_, range_);
+    
+    volatile uint32_t* gpio = gpio_->regs();
+    savedFunction_ = (gpio[dma::GPFSEL0 + pin_ / 10] >> ((pin_ % 10) * 3)) & 7u;
+    setPinFunction(altFunction_);
+    
+    PIPINPP_LOG_INFO("DmaPWM GPIO" << pin_ << ": " << sampleRateHz_ << " Hz sample rate, range "
+                     << range_ << " (PWM clock " << clockHz << " Hz)");
+    return true;
+}
+
+void DmaPWM::end()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!pacer_) {
+        return;
+    }
+    
+    stopLocked();
+    dma_.reset();
+    pacer_.reset();
+    memory_.reset();
+    setPinFunction(savedFunction_);
+    gpio_.reset();
+    sampleRateHz_ = 0;
+    range_ = 0;
+    
+    PIPINPP_LOG_DEBUG("DmaPWM GPIO" << pin_ << " stopped");
+}
+
+bool DmaPWM::isBegun() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pacer_ != nullptr;
+}
+
+bool DmaPWM::play(const uint32_t* samples, size_t count, bool loop)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!pacer_) {
+        PIPINPP_LOG_ERROR("DmaPWM not started, call begin() first");
+        return false;
+    }
+    if (!samples || count == 0) {
+        PIPINPP_LOG_ERROR("Empty DMA PWM sequence");
+        return false;
+    }
+    if (count > (UINT32_MAX - sizeof(DmaControlBlock)) / sizeof(uint32_t)) {
+        PIPINPP_LOG_ERROR("DMA PWM sequence too long: " << count << " values");
+        return false;
+    }
+    
+    stopLocked();
+    
+    // Layout: [control block][samples...]; reuse the allocation when it fits
+    size_t bytes = sizeof(DmaControlBlock) + count * sizeof(uint32_t);
+    if (!memory_ || memory_->size() < bytes) {
+        memory_.reset();
+        try {
+            memory_.reset(new DmaMemory(bytes));
+        } catch (const PinError& e) {
+            PIPINPP_LOG_ERROR("DMA memory allocation failed: " << e.what());
+            (void)e; // Only used when logging is enabled
+            return false;
+        }
+    }
+    
+    auto* cb = static_cast<DmaControlBlock*>(memory_->virt());
+    auto* data = reinterpret_cast<uint32_t*>(cb + 1);
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = std::min(samples[i], range_);
+    }
+    
+    uint32_t cbBus = memory_->busAddress(cb);
+    cb->ti = dma::DMA_TI_NO_WIDE_BURSTS | dma::DMA_TI_WAIT_RESP | dma::DMA_TI_DEST_DREQ |
+             (dma::DMA_PERMAP_PWM << dma::DMA_TI_PERMAP_SHIFT) | dma::DMA_TI_SRC_INC;
+    cb->sourceAd = memory_->busAddress(data);
+    cb->destAd = PwmPacer::fifoBusAddress();
+    cb->txfrLen = static_cast<uint32_t>(count * sizeof(uint32_t));
+    cb->stride = 0;
+    cb->nextConbk = loop ? cbBus : 0;
+    cb->reserved[0] = 0;
+    cb->reserved[1] = 0;
+    
+    dma_->start(cbBus);
+    return true;
+}
+
+bool DmaPWM::play(const std::vector<uint32_t>& samples, bool loop)
+{
+    return play(samples.data(), samples.size(), loop);
+}
+
+bool DmaPWM::setDutyCycle(double percent)
+{
+    if (std::isnan(percent) || percent < 0.0 || percent > 100.0) {
+        PIPINPP_LOG_ERROR("Invalid duty cycle: " << percent << "%");
+        return false;
+    }
+    uint32_t range = getRange();
+    uint32_t value = static_cast<uint32_t>(std::lround(percent * range / 100.0));
+    return play(&value, 1, true);
+}
+
+void DmaPWM::stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopLocked();
+}
+
+void DmaPWM::stopLocked()
+{
+    if (dma_) {
+        dma_->stop();
+    }
+}
+
+bool DmaPWM::isPlaying() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dma_ && dma_->isActive();
+}
+
+bool DmaPWM::hasError() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dma_ && dma_->hasError();
+}
+
+uint32_t DmaPWM::getSampleRate() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sampleRateHz_;
+}
+
+uint32_t DmaPWM::getRange() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return range_;
+}
+
+void DmaPWM::setPinFunction(uint32_t function)
+{
+    if (!gpio_) {
+        return;
+    }
+    volatile uint32_t* reg = gpio_->regs() + dma::GPFSEL0 + pin_ / 10;
+    uint32_t shift = (pin_ % 10) * 3;
+    *reg = (*reg & ~(7u << shift)) | ((function & 7u) << shift);
+}
+
+} // namespace pipinpp
@@ -29,25 +29,35 @@
 
 #include "HardwarePWM.hpp"
 #include "log.hpp"
+#include "exceptions.hpp"
+#include "transaction.hpp"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <charconv>
+#include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 #include <cerrno>
 #include <cstring>
+#include <limits>
 
 namespace pipinpp {
 
-HardwarePWM::HardwarePWM(int chip, int channel)
+HardwarePWM::HardwarePWM(int chip, int channel, const std::string& sysRoot)
     : chip_(chip)
     , channel_(channel)
     , exported_(false)
     , enabled_(false)
     , periodNs_(0)
     , dutyCycleNs_(0)
+    , periodFd_(-1)
+    , dutyCycleFd_(-1)
+    , enableFd_(-1)
 {
-    basePath_ = "/sys/class/pwm/pwmchip" + std::to_string(chip_) + "/";
+    basePath_ = sysRoot + "/sys/class/pwm/pwmchip" + std::to_string(chip_) + "/";
     pwmPath_ = basePath_ + "pwm" + std::to_string(channel_) + "/";
     
     PIPINPP_LOG_DEBUG("HardwarePWM created: chip=" << chip_ << ", channel=" << channel_);
@@ -72,11 +82,16 @@ bool HardwarePWM::begin(uint32_t frequencyHz, double initialDutyCycle)
         return false;
     }
     
+    // Keep the hot attributes open for the lifetime of the channel
+    if (periodFd_ < 0) {
+        openAttributes();
+    }
+    
     // Calculate period in nanoseconds
     uint64_t periodNs = 1000000000ULL / frequencyHz;
     
     // Set period first (must be set before duty cycle)
-    if (!writeFile("period", std::to_string(periodNs))) {
+    if (!writeAttribute(periodFd_, "period", periodNs)) {
         PIPINPP_LOG_ERROR("Failed to set PWM period");
         return false;
     }
@@ -84,14 +99,14 @@ bool HardwarePWM::begin(uint32_t frequencyHz, double initialDutyCycle)
     
     // Set initial duty cycle
     uint64_t dutyCycleNs = static_cast<uint64_t>((initialDutyCycle / 100.0) * periodNs);
-    if (!writeFile("duty_cycle", std::to_string(dutyCycleNs))) {
+    if (!writeAttribute(dutyCycleFd_, "duty_cycle", dutyCycleNs)) {
         PIPINPP_LOG_ERROR("Failed to set PWM duty cycle");
         return false;
     }
     dutyCycleNs_ = dutyCycleNs;
     
     // Enable PWM
-    if (!writeFile("enable", "1")) {
+    if (!writeAttribute(enableFd_, "enable", 1)) {
         PIPINPP_LOG_ERROR("Failed to enable PWM");
         return false;
     }
@@ -103,13 +118,19 @@ bool HardwarePWM::begin(uint32_t frequencyHz, double initialDutyCycle)
 
 void HardwarePWM::end()
 {
+    if (Transaction* txn = Transaction::current()) {
+        txn->forgetPwm(this);
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (enabled_) {
-        writeFile("enable", "0");
+        writeAttribute(enableFd_, "enable", 0);
         enabled_ = false;
     }
     
+    closeAttributes();
+    
     if (exported_) {
         unexportPWM();
     }
@@ -125,7 +146,7 @@ bool HardwarePWM::isEnabled() const
 
 bool HardwarePWM::setFrequency(uint32_t frequencyHz)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
     
     if (!exported_) {
         PIPINPP_LOG_ERROR("PWM not initialized - call begin() first");
@@ -137,6 +158,12 @@ bool HardwarePWM::setFrequency(uint32_t frequencyHz)
         return false;
     }
     
+    if (Transaction* txn = Transaction::current()) {
+        lock.unlock();
+        txn->recordPwmFrequency(this, frequencyHz);
+        return true;
+    }
+    
     // Calculate new period
     uint64_t newPeriodNs = 1000000000ULL / frequencyHz;
     
@@ -147,24 +174,24 @@ bool HardwarePWM::setFrequency(uint32_t frequencyHz)
     // Disable while changing period (required by some PWM hardware)
     bool wasEnabled = enabled_;
     if (wasEnabled) {
-        writeFile("enable", "0");
+        writeAttribute(enableFd_, "enable", 0);
     }
     
     // Set new period
-    if (!writeFile("period", std::to_string(newPeriodNs))) {
+    if (!writeAttribute(periodFd_, "period", newPeriodNs)) {
         PIPINPP_LOG_ERROR("Failed to set PWM period");
         if (wasEnabled) {
-            writeFile("enable", "1");
+            writeAttribute(enableFd_, "enable", 1);
         }
         return false;
     }
     periodNs_ = newPeriodNs;
     
     // Update duty cycle to maintain percentage
-    if (!writeFile("duty_cycle", std::to_string(newDutyCycleNs))) {
+    if (!writeAttribute(dutyCycleFd_, "duty_cycle", newDutyCycleNs)) {
         PIPINPP_LOG_ERROR("Failed to set PWM duty cycle");
         if (wasEnabled) {
-            writeFile("enable", "1");
+            writeAttribute(enableFd_, "enable", 1);
         }
         return false;
     }
@@ -172,7 +199,7 @@ bool HardwarePWM::setFrequency(uint32_t frequencyHz)
     
     // Re-enable if it was enabled
     if (wasEnabled) {
-        writeFile("enable", "1");
+        writeAttribute(enableFd_, "enable", 1);
     }
     
     PIPINPP_LOG_DEBUG("PWM frequency set to " << frequencyHz << " Hz");
@@ -181,7 +208,7 @@ bool HardwarePWM::setFrequency(uint32_t frequencyHz)
 
 bool HardwarePWM::setDutyCycle(double percent)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
     
     if (!exported_) {
         PIPINPP_LOG_ERROR("PWM not initialized - call begin() first");
@@ -192,9 +219,15 @@ bool HardwarePWM::setDutyCycle(double percent)
     if (percent < 0.0) percent = 0.0;
     if (percent > 100.0) percent = 100.0;
     
+    if (Transaction* txn = Transaction::current()) {
+        lock.unlock();
+        txn->recordPwmDutyPercent(this, percent);
+        return true;
+    }
+    
     uint64_t dutyCycleNs = static_cast<uint64_t>((percent / 100.0) * periodNs_);
     
-    if (!writeFile("duty_cycle", std::to_string(dutyCycleNs))) {
+    if (!writeAttribute(dutyCycleFd_, "duty_cycle", dutyCycleNs)) {
         PIPINPP_LOG_ERROR("Failed to set duty cycle");
         return false;
     }
@@ -222,13 +255,13 @@ bool HardwarePWM::setPeriodNs(uint64_t nanoseconds)
     // Disable while changing period
     bool wasEnabled = enabled_;
     if (wasEnabled) {
-        writeFile("enable", "0");
+        writeAttribute(enableFd_, "enable", 0);
     }
     
-    if (!writeFile("period", std::to_string(nanoseconds))) {
+    if (!writeAttribute(periodFd_, "period", nanoseconds)) {
         PIPINPP_LOG_ERROR("Failed to set period");
         if (wasEnabled) {
-            writeFile("enable", "1");
+            writeAttribute(enableFd_, "enable", 1);
         }
         return false;
     }
@@ -237,11 +270,11 @@ bool HardwarePWM::setPeriodNs(uint64_t nanoseconds)
     // Ensure duty cycle doesn't exceed new period
     if (dutyCycleNs_ > periodNs_) {
         dutyCycleNs_ = periodNs_;
-        writeFile("duty_cycle", std::to_string(dutyCycleNs_));
+        writeAttribute(dutyCycleFd_, "duty_cycle", dutyCycleNs_);
     }
     
     if (wasEnabled) {
-        writeFile("enable", "1");
+        writeAttribute(enableFd_, "enable", 1);
     }
     
     return true;
@@ -249,19 +282,26 @@ bool HardwarePWM::setPeriodNs(uint64_t nanoseconds)
 
 bool HardwarePWM::setDutyCycleNs(uint64_t nanoseconds)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
     
     if (!exported_) {
         PIPINPP_LOG_ERROR("PWM not initialized - call begin() first");
         return false;
     }
     
+    // Clamped against the period when the transaction commits
+    if (Transaction* txn = Transaction::current()) {
+        lock.unlock();
+        txn->recordPwmDutyNs(this, nanoseconds);
+        return true;
+    }
+    
     if (nanoseconds > periodNs_) {
         PIPINPP_LOG_WARNING("Duty cycle (" << nanoseconds << "ns) exceeds period (" << periodNs_ << "ns), clamping");
         nanoseconds = periodNs_;
     }
     
-    if (!writeFile("duty_cycle", std::to_string(nanoseconds))) {
+    if (!writeAttribute(dutyCycleFd_, "duty_cycle", nanoseconds)) {
         PIPINPP_LOG_ERROR("Failed to set duty cycle");
         return false;
     }
@@ -270,6 +310,62 @@ bool HardwarePWM::setDutyCycleNs(uint64_t nanoseconds)
     return true;
 }
 
+bool HardwarePWM::applyChange(uint32_t frequencyHz, double dutyPercent, uint64_t dutyNs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!exported_) {
+        return false;
+    }
+    
+    uint64_t periodNs = frequencyHz > 0 ? 1000000000ULL / frequencyHz : periodNs_;
+    uint64_t newDutyNs;
+    if (dutyPercent >= 0.0) {
+        newDutyNs = static_cast<uint64_t>((std::min(dutyPercent, 100.0) / 100.0) * periodNs);
+    } else if (dutyNs != std::numeric_limits<uint64_t>::max()) {
+        newDutyNs = std::min(dutyNs, periodNs);
+    } else {
+        // Period only: keep the percentage, as setFrequency() does
+        newDutyNs = periodNs_ > 0 ? static_cast<uint64_t>(static_cast<double>(dutyCycleNs_) * periodNs / periodNs_) : 0;
+    }
+    
+    if (periodNs == periodNs_) {
+        if (newDutyNs == dutyCycleNs_) {
+            return true;
+        }
+        if (!writeAttribute(dutyCycleFd_, "duty_cycle", newDutyNs)) {
+            return false;
+        }
+        dutyCycleNs_ = newDutyNs;
+        return true;
+    }
+    
+    bool wasEnabled = enabled_;
+    if (wasEnabled) {
+        writeAttribute(enableFd_, "enable", 0);
+    }
+    
+    // The duty cycle may never exceed the period, so a shrinking one goes first
+    bool ok = true;
+    if (newDutyNs < dutyCycleNs_) {
+        ok = writeAttribute(dutyCycleFd_, "duty_cycle", newDutyNs);
+        if (ok) {
+            dutyCycleNs_ = newDutyNs;
+        }
+    }
+    if (ok && (ok = writeAttribute(periodFd_, "period", periodNs))) {
+        periodNs_ = periodNs;
+    }
+    if (ok && newDutyNs != dutyCycleNs_ && (ok = writeAttribute(dutyCycleFd_, "duty_cycle", newDutyNs))) {
+        dutyCycleNs_ = newDutyNs;
+    }
+    
+    if (wasEnabled) {
+        writeAttribute(enableFd_, "enable", 1);
+    }
+    return ok;
+}
+
 bool HardwarePWM::setPolarity(PWMPolarity polarity)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -282,14 +378,14 @@ bool HardwarePWM::setPolarity(PWMPolarity polarity)
     // Must disable before changing polarity
     bool wasEnabled = enabled_;
     if (wasEnabled) {
-        writeFile("enable", "0");
+        writeAttribute(enableFd_, "enable", 0);
     }
     
     const char* polarityStr = (polarity == PWMPolarity::NORMAL) ? "normal" : "inversed";
     bool result = writeFile("polarity", polarityStr);
     
     if (wasEnabled) {
-        writeFile("enable", "1");
+        writeAttribute(enableFd_, "enable", 1);
     }
     
     if (result) {
@@ -308,7 +404,7 @@ bool HardwarePWM::enable()
         return false;
     }
     
-    if (!writeFile("enable", "1")) {
+    if (!writeAttribute(enableFd_, "enable", 1)) {
         PIPINPP_LOG_ERROR("Failed to enable PWM");
         return false;
     }
@@ -325,7 +421,7 @@ bool HardwarePWM::disable()
         return true; // Already disabled
     }
     
-    if (!writeFile("enable", "0")) {
+    if (!writeAttribute(enableFd_, "enable", 0)) {
         PIPINPP_LOG_ERROR("Failed to disable PWM");
         return false;
     }
@@ -445,6 +541,48 @@ bool HardwarePWM::unexportPWM()
     return true;
 }
 
+void HardwarePWM::openAttributes()
+{
+    periodFd_ = ::open((pwmPath_ + "period").c_str(), O_WRONLY | O_CLOEXEC);
+    dutyCycleFd_ = ::open((pwmPath_ + "duty_cycle").c_str(), O_WRONLY | O_CLOEXEC);
+    enableFd_ = ::open((pwmPath_ + "enable").c_str(), O_WRONLY | O_CLOEXEC);
+    
+    if (periodFd_ < 0 || dutyCycleFd_ < 0 || enableFd_ < 0) {
+        PIPINPP_LOG_WARNING("Could not keep all PWM attributes open in " << pwmPath_
+                            << " (" << std::strerror(errno) << "), using open/write/close");
+    }
+}
+
+void HardwarePWM::closeAttributes()
+{
+    for (int* fd : {&periodFd_, &dutyCycleFd_, &enableFd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+bool HardwarePWM::writeAttribute(int fd, const char* filename, uint64_t value)
+{
+    if (fd < 0) {
+        return writeFile(filename, std::to_string(value));
+    }
+    
+    // Format on the stack; sysfs attributes are rewritten from offset 0
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    size_t length = static_cast<size_t>(result.ptr - buffer);
+    
+    if (::pwrite(fd, buffer, length, 0) != static_cast<ssize_t>(length)) {
+        PIPINPP_LOG_ERROR("Failed to write to " << pwmPath_ << filename
+                          << " (errno=" << errno << ": " << std::strerror(errno) << ")");
+        return false;
+    }
+    
+    return true;
+}
+
 bool HardwarePWM::writeFile(const std::string& filename, const std::string& value)
 {
     std::string fullPath = pwmPath_ + filename;
@@ -483,4 +621,175 @@ bool HardwarePWM::readFile(const std::string& filename, std::string& value) cons
     return true;
 }
 
+// HardwarePWMGroup Implementation
+
+HardwarePWMGroup::HardwarePWMGroup(const std::vector<HardwarePWM*>& channels)
+    : channels_(channels)
+    , staged_(channels.size())
+    , lastSkewNs_(0)
+{
+    if (channels_.empty()) {
+        throw InvalidPinError("HardwarePWMGroup needs at least one channel");
+    }
+    if (std::find(channels_.begin(), channels_.end(), nullptr) != channels_.end()) {
+        throw InvalidPinError("HardwarePWMGroup channel cannot be null");
+    }
+}
+
+bool HardwarePWMGroup::stageDutyCycle(size_t index, double percent)
+{
+    if (index >= channels_.size()) {
+        PIPINPP_LOG_ERROR("HardwarePWMGroup index out of range: " << index);
+        return false;
+    }
+    
+    uint64_t periodNs = staged_[index].hasPeriod ? staged_[index].periodNs : channels_[index]->getPeriodNs();
+    if (periodNs == 0) {
+        PIPINPP_LOG_ERROR("HardwarePWMGroup channel " << index << " has no period - call begin() first");
+        return false;
+    }
+    
+    percent = std::clamp(percent, 0.0, 100.0);
+    return stageDutyCycleNs(index, static_cast<uint64_t>((percent / 100.0) * periodNs));
+}
+
+bool HardwarePWMGroup::stageDutyCycleNs(size_t index, uint64_t nanoseconds)
+{
+    if (index >= channels_.size()) {
+        PIPINPP_LOG_ERROR("HardwarePWMGroup index out of range: " << index);
+        return false;
+    }
+    
+    Staged& staged = staged_[index];
+    auto result = std::to_chars(staged.dutyText, staged.dutyText + sizeof(staged.dutyText), nanoseconds);
+    staged.dutyLength = static_cast<size_t>(result.ptr - staged.dutyText);
+    staged.dutyCycleNs = nanoseconds;
+    staged.hasDuty = true;
+    return true;
+}
+
+bool HardwarePWMGroup::stagePeriodNs(size_t index, uint64_t nanoseconds)
+{
+    if (index >= channels_.size()) {
+        PIPINPP_LOG_ERROR("HardwarePWMGroup index out of range: " << index);
+        return false;
+    }
+    if (nanoseconds == 0) {
+        PIPINPP_LOG_ERROR("Invalid period: 0 ns");
+        return false;
+    }
+    
+    Staged& staged = staged_[index];
+    auto result = std::to_chars(staged.periodText, staged.periodText + sizeof(staged.periodText), nanoseconds);
+    staged.periodLength = static_cast<size_t>(result.ptr - staged.periodText);
+    staged.periodNs = nanoseconds;
+    staged.hasPeriod = true;
+    return true;
+}
+
+void HardwarePWMGroup::clear()
+{
+    for (Staged& staged : staged_) {
+        staged = Staged();
+    }
+}
+
+bool HardwarePWMGroup::writeText(HardwarePWM& channel, int fd, const char* filename,
+                                 const char* text, size_t length)
+{
+    if (fd < 0) {
+        return channel.writeFile(filename, std::string(text, length));
+    }
+    return ::pwrite(fd, text, length, 0) == static_cast<ssize_t>(length);
+}
+
+bool HardwarePWMGroup::commit()
+{
+    // Lock every channel in address order so concurrent groups cannot deadlock
+    std::vector<HardwarePWM*> lockOrder(channels_);
+    std::sort(lockOrder.begin(), lockOrder.end());
+    lockOrder.erase(std::unique(lockOrder.begin(), lockOrder.end()), lockOrder.end());
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(lockOrder.size());
+    for (HardwarePWM* channel : lockOrder) {
+        locks.emplace_back(channel->mutex_);
+    }
+    
+    bool ok = true;
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        if ((staged_[i].hasPeriod || staged_[i].hasDuty) && !channels_[i]->exported_) {
+            PIPINPP_LOG_ERROR("HardwarePWMGroup channel " << i << " not initialized - call begin() first");
+            ok = false;
+        }
+    }
+    if (!ok) {
+        clear();
+        return false;
+    }
+    
+    // 1. Period changes; shrink duty first if it would exceed the new period
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        HardwarePWM& channel = *channels_[i];
+        Staged& staged = staged_[i];
+        if (!staged.hasPeriod) {
+            continue;
+        }
+        
+        uint64_t duty = staged.hasDuty ? staged.dutyCycleNs : channel.dutyCycleNs_;
+        if (duty > staged.periodNs) {
+            stageDutyCycleNs(i, staged.periodNs);
+        }
+        
+        if (channel.dutyCycleNs_ > staged.periodNs) {
+            // Current duty would not fit in the new period: lower it first
+            if (writeText(channel, channel.dutyCycleFd_, "duty_cycle", staged.dutyText, staged.dutyLength)) {
+                channel.dutyCycleNs_ = staged.dutyCycleNs;
+            } else {
+                ok = false;
+            }
+            staged.hasDuty = false;
+        }
+        
+        if (writeText(channel, channel.periodFd_, "period", staged.periodText, staged.periodLength)) {
+            channel.periodNs_ = staged.periodNs;
+        } else {
+            PIPINPP_LOG_ERROR("HardwarePWMGroup failed to set period on channel " << i);
+            ok = false;
+        }
+    }
+    
+    // 2. All duty writes back-to-back, timestamped for the skew report
+    timespec first{};
+    timespec last{};
+    size_t written = 0;
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        HardwarePWM& channel = *channels_[i];
+        Staged& staged = staged_[i];
+        if (!staged.hasDuty) {
+            continue;
+        }
+        
+        if (writeText(channel, channel.dutyCycleFd_, "duty_cycle", staged.dutyText, staged.dutyLength)) {
+            channel.dutyCycleNs_ = staged.dutyCycleNs;
+        } else {
+            ok = false;
+        }
+        clock_gettime(CLOCK_MONOTONIC, written == 0 ? &first : &last);
+        ++written;
+    }
+    
+    lastSkewNs_ = 0;
+    if (written > 1) {
+        lastSkewNs_ = static_cast<uint64_t>(last.tv_sec - first.tv_sec) * 1000000000ULL +
+                      static_cast<uint64_t>(last.tv_nsec) - static_cast<uint64_t>(first.tv_nsec);
+    }
+    
+    clear();
+    
+    if (!ok) {
+        PIPINPP_LOG_ERROR("HardwarePWMGroup commit incomplete");
+    }
+    return ok;
+}
+
 } // namespace pipinpp
@@ -0,0 +1,459 @@
+/**
+ * @file PinGroup.cpp
+ * @brief Implementation of multi-line GPIO groups
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PinGroup.hpp"
+#include "log.hpp"
+#include "exceptions.hpp"
+#include "board.hpp"
+#include <algorithm>
+#include <time.h>
+
+namespace
+{
+
+// Busy-wait for short bit timings where a sleep would take far too long
+void spinNs(uint32_t ns)
+{
+    if (ns == 0)
+    {
+        return;
+    }
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec) < static_cast<long>(ns));
+}
+
+// 8x8 bit-matrix transpose (Hacker's Delight 7-3): byte r bit c <-> byte c bit r
+uint64_t transpose8x8(uint64_t x)
+{
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+} // namespace
+
+PinGroup::PinGroup(const std::vector<int>& pins, PinDirection direction, const std::string& chipname)
+: chip(), request(nullptr), currentDirection(direction), allBits(0), outputState(0)
+{
+    validatePins(pins);
+
+    gpiod_line_direction gpio_dir = (direction == PinDirection::OUTPUT)
+        ? GPIOD_LINE_DIRECTION_OUTPUT
+        : GPIOD_LINE_DIRECTION_INPUT;
+
+    initializeGpio(chipname, gpio_dir, GPIOD_LINE_BIAS_AS_IS);
+
+    PIPINPP_LOG_INFO("Initialized pin group of " << offsets.size() << " lines as "
+                     << ((direction == PinDirection::OUTPUT) ? "OUTPUT" : "INPUT")
+                     << " on chip " << chipname);
+}
+
+PinGroup::PinGroup(const std::vector<int>& pins, PinMode mode, const std::string& chipname)
+: chip(), request(nullptr),
+  currentDirection(mode == PinMode::OUTPUT ? PinDirection::OUTPUT : PinDirection::INPUT),
+  allBits(0), outputState(0)
+{
+    validatePins(pins);
+
+    gpiod_line_direction gpio_dir = GPIOD_LINE_DIRECTION_INPUT;
+    gpiod_line_bias gpio_bias = GPIOD_LINE_BIAS_AS_IS;
+
+    if (mode == PinMode::OUTPUT)
+    {
+        gpio_dir = GPIOD_LINE_DIRECTION_OUTPUT;
+    }
+    else if (mode == PinMode::INPUT_PULLUP)
+    {
+        gpio_bias = GPIOD_LINE_BIAS_PULL_UP;
+    }
+    else if (mode == PinMode::INPUT_PULLDOWN)
+    {
+        gpio_bias = GPIOD_LINE_BIAS_PULL_DOWN;
+    }
+
+    initializeGpio(chipname, gpio_dir, gpio_bias);
+
+    PIPINPP_LOG_INFO("Initialized pin group of " << offsets.size() << " lines as "
+                     << (mode == PinMode::OUTPUT ? "OUTPUT" :
+                         mode == PinMode::INPUT_PULLUP ? "INPUT_PULLUP" :
+                         mode == PinMode::INPUT_PULLDOWN ? "INPUT_PULLDOWN" : "INPUT")
+                     << " on chip " << chipname);
+}
+
+void PinGroup::validatePins(const std::vector<int>& pins)
+{
+    if (pins.empty())
+    {
+        throw InvalidPinError("PinGroup requires at least one pin");
+    }
+    if (pins.size() > MAX_PINS)
+    {
+        throw InvalidPinError("PinGroup supports at most " + std::to_string(MAX_PINS) + " pins");
+    }
+
+    offsets.reserve(pins.size());
+    for (int pin : pins)
+    {
+        // Same range as Pin::validatePinNumber()
+        if (!pipinpp::isValidGpioPin(pin))
+        {
+            throw InvalidPinError(pin, "Valid range is 0-27 for Raspberry Pi");
+        }
+        unsigned int offset = static_cast<unsigned int>(pin);
+        if (std::find(offsets.begin(), offsets.end(), offset) != offsets.end())
+        {
+            throw InvalidPinError(pin, "Pin listed more than once in PinGroup");
+        }
+        offsets.push_back(offset);
+    }
+    allBits = (offsets.size() == MAX_PINS) ? ~uint64_t{0} : (uint64_t{1} << offsets.size()) - 1;
+}
+
+void PinGroup::initializeGpio(const std::string& chipname,
+                              gpiod_line_direction direction,
+                              gpiod_line_bias bias)
+{
+    chip = pipinpp::ChipRegistry::getInstance().acquire(chipname);
+
+    // Validate every offset against the hardware
+    size_t num_lines = chip->numLines();
+    for (unsigned int offset : offsets)
+    {
+        if (num_lines > 0 && offset >= num_lines)
+        {
+            chip.reset();
+            throw InvalidPinError(static_cast<int>(offset), "Pin number exceeds available GPIO lines (" + std::to_string(num_lines) + ")");
+        }
+    }
+
+    gpiod_line_settings* settings = gpiod_line_settings_new();
+    gpiod_line_config* line_cfg = gpiod_line_config_new();
+    gpiod_request_config* req_cfg = gpiod_request_config_new();
+    if (!settings || !line_cfg || !req_cfg)
+    {
+        if (req_cfg) gpiod_request_config_free(req_cfg);
+        if (line_cfg) gpiod_line_config_free(line_cfg);
+        if (settings) gpiod_line_settings_free(settings);
+        chip.reset();
+        throw GpioAccessError("GPIO", "Failed to allocate line configuration");
+    }
+
+    gpiod_line_settings_set_direction(settings, direction);
+    if (direction == GPIOD_LINE_DIRECTION_OUTPUT)
+    {
+        gpiod_line_settings_set_output_value(settings, GPIOD_LINE_VALUE_INACTIVE);
+    }
+    if (bias != GPIOD_LINE_BIAS_AS_IS)
+    {
+        gpiod_line_settings_set_bias(settings, bias);
+    }
+
+    // One settings block for all offsets -> one request, one fd
+    gpiod_line_config_add_line_settings(line_cfg, offsets.data(), offsets.size(), settings);
+    gpiod_request_config_set_consumer(req_cfg, "PiPinPP-Group");
+
+    request = chip->requestLines(req_cfg, line_cfg);
+
+    gpiod_request_config_free(req_cfg);
+    gpiod_line_config_free(line_cfg);
+    gpiod_line_settings_free(settings);
+
+    if (!request)
+    {
+        chip.reset();
+        throw GpioAccessError("GPIO pin group", "Failed to request GPIO lines. A pin may be in use or unavailable.");
+    }
+
+    // Outputs start LOW (see above)
+    if (direction == GPIOD_LINE_DIRECTION_OUTPUT)
+    {
+        for (unsigned int offset : offsets)
+        {
+            chip->outputShadow().claim(offset, false);
+        }
+    }
+}
+
+void PinGroup::recordOutputs(uint64_t changed, uint64_t values)
+{
+    outputState = (outputState & ~changed) | (values & changed);
+    pipinpp::OutputShadow& shadow = chip->outputShadow();
+    for (size_t bit = 0; bit < offsets.size(); ++bit)
+    {
+        if (changed & (uint64_t{1} << bit))
+        {
+            shadow.record(offsets[bit], (values >> bit) & 1u);
+        }
+    }
+}
+
+int64_t PinGroup::getOutputState() const
+{
+    if (!request || currentDirection != PinDirection::OUTPUT)
+    {
+        return -1;
+    }
+    return static_cast<int64_t>(outputState);
+}
+
+PinGroup::~PinGroup()
+{
+    if (request)
+    {
+        if (currentDirection == PinDirection::OUTPUT)
+        {
+            for (unsigned int offset : offsets)
+            {
+                chip->outputShadow().release(offset);
+            }
+        }
+        gpiod_line_request_release(request);
+    }
+    chip.reset();
+}
+
+bool PinGroup::writeMask(uint64_t mask, uint64_t values)
+{
+    if (!request || currentDirection != PinDirection::OUTPUT)
+    {
+        return false;
+    }
+
+    // Only lines whose level actually changes (computed from the shadow)
+    uint64_t changed = mask & allBits & (values ^ outputState);
+    if (changed == 0)
+    {
+        return true; // Nothing to change
+    }
+
+    // Stack buffers: no allocation on the write path
+    unsigned int subsetOffsets[MAX_PINS];
+    gpiod_line_value subsetValues[MAX_PINS];
+    size_t count = 0;
+
+    for (size_t bit = 0; bit < offsets.size(); ++bit)
+    {
+        uint64_t flag = uint64_t{1} << bit;
+        if (changed & flag)
+        {
+            subsetOffsets[count] = offsets[bit];
+            subsetValues[count] = (values & flag) ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE;
+            ++count;
+        }
+    }
+
+    if (gpiod_line_request_set_values_subset(request, count, subsetOffsets, subsetValues) != 0)
+    {
+        return false;
+    }
+    recordOutputs(changed, values);
+    return true;
+}
+
+bool PinGroup::writeAll(uint64_t values)
+{
+    if (!request || currentDirection != PinDirection::OUTPUT)
+    {
+        return false;
+    }
+
+    gpiod_line_value lineValues[MAX_PINS];
+    for (size_t bit = 0; bit < offsets.size(); ++bit)
+    {
+        lineValues[bit] = ((values >> bit) & 1U) ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE;
+    }
+
+    if (gpiod_line_request_set_values(request, lineValues) != 0)
+    {
+        return false;
+    }
+    recordOutputs(allBits, values);
+    return true;
+}
+
+int64_t PinGroup::readAll()
+{
+    if (!request)
+    {
+        return -1;
+    }
+
+    // get_values() fills values in the order the offsets were requested
+    gpiod_line_value lineValues[MAX_PINS];
+    if (gpiod_line_request_get_values(request, lineValues) != 0)
+    {
+        return -1;
+    }
+
+    int64_t result = 0;
+    for (size_t bit = 0; bit < offsets.size(); ++bit)
+    {
+        if (lineValues[bit] == GPIOD_LINE_VALUE_ERROR)
+        {
+            return -1;
+        }
+        if (lineValues[bit] == GPIOD_LINE_VALUE_ACTIVE)
+        {
+            result |= int64_t{1} << bit;
+        }
+    }
+    return result;
+}
+
+bool PinGroup::shiftOut(size_t dataBit, size_t clockBit, bool msbFirst,
+                        const uint8_t* data, size_t length, uint32_t clockNs)
+{
+    if (!request || currentDirection != PinDirection::OUTPUT || dataBit >= offsets.size() ||
+        clockBit >= offsets.size() || dataBit == clockBit || (data == nullptr && length > 0))
+    {
+        return false;
+    }
+
+    // Precomputed transactions: {data, clock low} per bit value
+    unsigned int lowOffsets[2] = {offsets[dataBit], offsets[clockBit]};
+    const gpiod_line_value lowValues[2][2] = {
+        {GPIOD_LINE_VALUE_INACTIVE, GPIOD_LINE_VALUE_INACTIVE},
+        {GPIOD_LINE_VALUE_ACTIVE, GPIOD_LINE_VALUE_INACTIVE}
+    };
+    unsigned int clockOffset = offsets[clockBit];
+    unsigned int bit = 0;
+
+    for (size_t n = 0; n < length; ++n)
+    {
+        unsigned int byte = data[n];
+        for (int i = 0; i < 8; ++i)
+        {
+            bit = msbFirst ? (byte >> (7 - i)) & 1u : (byte >> i) & 1u;
+            if (gpiod_line_request_set_values_subset(request, 2, lowOffsets, lowValues[bit]) != 0)
+            {
+                return false;
+            }
+            spinNs(clockNs);
+            if (gpiod_line_request_set_value(request, clockOffset, GPIOD_LINE_VALUE_ACTIVE) != 0)
+            {
+                return false;
+            }
+            spinNs(clockNs);
+        }
+    }
+    if (gpiod_line_request_set_value(request, clockOffset, GPIOD_LINE_VALUE_INACTIVE) != 0)
+    {
+        return false;
+    }
+    uint64_t dataFlag = uint64_t{1} << dataBit;
+    uint64_t clockFlag = uint64_t{1} << clockBit;
+    recordOutputs(clockFlag | (length > 0 ? dataFlag : 0), bit ? dataFlag : 0);
+    return true;
+}
+
+void PinGroup::transposeLanes(const uint8_t* bytes, size_t laneCount, bool msbFirst, uint64_t masks[8])
+{
+    for (int j = 0; j < 8; ++j)
+    {
+        masks[j] = 0;
+    }
+
+    // Eight lanes at a time: row r of the matrix is lane r's byte
+    for (size_t base = 0; base < laneCount; base += 8)
+    {
+        size_t rows = std::min<size_t>(8, laneCount - base);
+        uint64_t matrix = 0;
+        for (size_t r = 0; r < rows; ++r)
+        {
+            matrix |= uint64_t{bytes[base + r]} << (8 * r);
+        }
+        matrix = transpose8x8(matrix);
+
+        // Byte c now holds bit c of every lane
+        for (int c = 0; c < 8; ++c)
+        {
+            uint64_t lanes = (matrix >> (8 * c)) & 0xFF;
+            masks[msbFirst ? 7 - c : c] |= lanes << base;
+        }
+    }
+}
+
+bool PinGroup::shiftOutLanes(size_t laneCount, size_t clockBit, bool msbFirst,
+                             const uint8_t* data, size_t length, uint32_t clockNs)
+{
+    if (!request || currentDirection != PinDirection::OUTPUT || laneCount == 0 ||
+        clockBit < laneCount || clockBit >= offsets.size() || (data == nullptr && length > 0))
+    {
+        return false;
+    }
+
+    // Lanes plus clock in one transaction, clock last
+    unsigned int lowOffsets[MAX_PINS];
+    gpiod_line_value lowValues[MAX_PINS];
+    for (size_t lane = 0; lane < laneCount; ++lane)
+    {
+        lowOffsets[lane] = offsets[lane];
+    }
+    lowOffsets[laneCount] = offsets[clockBit];
+    lowValues[laneCount] = GPIOD_LINE_VALUE_INACTIVE;
+    unsigned int clockOffset = offsets[clockBit];
+
+    uint64_t masks[8] = {};
+    for (size_t n = 0; n < length; ++n)
+    {
+        transposeLanes(data + n * laneCount, laneCount, msbFirst, masks);
+        for (int j = 0; j < 8; ++j)
+        {
+            for (size_t lane = 0; lane < laneCount; ++lane)
+            {
+                lowValues[lane] = ((masks[j] >> lane) & 1u) ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE;
+            }
+            if (gpiod_line_request_set_values_subset(request, laneCount + 1, lowOffsets, lowValues) != 0)
+            {
+                return false;
+            }
+            spinNs(clockNs);
+            if (gpiod_line_request_set_value(request, clockOffset, GPIOD_LINE_VALUE_ACTIVE) != 0)
+            {
+                return false;
+            }
+            spinNs(clockNs);
+        }
+    }
+    if (gpiod_line_request_set_value(request, clockOffset, GPIOD_LINE_VALUE_INACTIVE) != 0)
+    {
+        return false;
+    }
+    uint64_t laneBits = (laneCount == MAX_PINS) ? ~uint64_t{0} : (uint64_t{1} << laneCount) - 1;
+    uint64_t clockFlag = uint64_t{1} << clockBit;
+    recordOutputs(clockFlag | (length > 0 ? laneBits : 0), masks[7] & laneBits);
+    return true;
+}
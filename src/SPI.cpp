@@ -27,25 +27,51 @@
 
 #include "SPI.hpp"
 #include "ArduinoCompat.hpp"  // For MSBFIRST/LSBFIRST constants
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/ioctl.h>
+#include "log.hpp"
+#include "metrics.hpp"
+#include "thread_policy.hpp"
 #include <linux/spi/spidev.h>
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
+#include <fstream>
 
 namespace pipinpp {
 
+namespace {
+
+/// ioctls per transferBatch() that begin() reserves room for (bufsiz splits)
+constexpr size_t SPI_BATCH_MESSAGES_RESERVED = 16;
+
+/**
+ * @brief ioctl(SPI_IOC_MESSAGE) recorded in the spi_transfer_ns/spi_errors metrics
+ */
+int spiMessage(DeviceFile& device, unsigned int count, spi_ioc_transfer* transfers) {
+    PIPINPP_METRIC_TIME_SCOPE("spi_transfer_ns");
+    int result = device.ioctl(SPI_IOC_MESSAGE(count), transfers);
+    if (result < 0) {
+        PIPINPP_METRIC_COUNT("spi_errors", 1);
+    }
+    return result;
+}
+
+} // namespace
+
 // Global SPI instance
 SPIClass SPI;
 
 SPIClass::SPIClass()
-    : fd_(-1)
+    : device_()
     , busNumber_(0)
     , csNumber_(0)
     , mode_(SPI_MODE0)
     , bitOrder_(MSBFIRST)
     , speed_(DEFAULT_SPEED)
     , bitsPerWord_(8)
+    , bufsiz_(DEFAULT_BUFSIZ)
+    , settingsValid_(false)
+    , appliedMode_(0)
+    , appliedBits_(0)
 {
 }
 
@@ -61,10 +87,7 @@ bool SPIClass::begin(int bus, int cs) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     // Close existing connection if any
-    if (fd_ >= 0) {
-        close(fd_);
-        fd_ = -1;
-    }
+    device_.reset();
     
     busNumber_ = bus;
     csNumber_ = cs;
@@ -73,11 +96,19 @@ bool SPIClass::begin(int bus, int cs) {
     char device[20];
     snprintf(device, sizeof(device), "/dev/spidev%d.%d", bus, cs);
     
-    fd_ = open(device, O_RDWR);
-    if (fd_ < 0) {
+    device_ = openDeviceFile(device);
+    if (!device_) {
         return false;
     }
     
+    bufsiz_ = readBufsiz();
+    settingsValid_ = false;  // New descriptor: program everything once
+    
+    // Size the transferBatch() scratch for a full message up front so
+    // transactions never grow it (larger batches still can)
+    batch_.reserve(SPI_MAX_BATCH_SEGMENTS * sizeof(spi_ioc_transfer));
+    batchMessages_.reserve(SPI_BATCH_MESSAGES_RESERVED);
+    
     // Set default configuration
     mode_ = SPI_MODE0;
     bitOrder_ = MSBFIRST;
@@ -88,12 +119,11 @@ bool SPIClass::begin(int bus, int cs) {
 }
 
 void SPIClass::end() {
+    stopQueue();
+    
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ >= 0) {
-        close(fd_);
-        fd_ = -1;
-    }
+    device_.reset();
 }
 
 void SPIClass::setDataMode(uint8_t mode) {
@@ -105,7 +135,7 @@ void SPIClass::setDataMode(uint8_t mode) {
     
     mode_ = mode;
     
-    if (fd_ >= 0) {
+    if (device_) {
         applySettings();
     }
 }
@@ -115,7 +145,7 @@ void SPIClass::setBitOrder(uint8_t bitOrder) {
     
     bitOrder_ = bitOrder;
     
-    if (fd_ >= 0) {
+    if (device_) {
         applySettings();
     }
 }
@@ -127,7 +157,7 @@ void SPIClass::setClockDivider(uint8_t divider) {
     // Base clock is 250 MHz on Raspberry Pi
     speed_ = BASE_CLOCK / divider;
     
-    if (fd_ >= 0) {
+    if (device_) {
         applySettings();
     }
 }
@@ -137,11 +167,38 @@ void SPIClass::setClock(uint32_t speed) {
     
     speed_ = speed;
     
-    if (fd_ >= 0) {
+    if (device_) {
+        applySettings();
+    }
+}
+
+void SPIClass::beginTransaction(const SPISettings& settings) {
+    transactionMutex_.lock();
+    transactionOwner_ = std::this_thread::get_id();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (settings.dataMode <= 3) {
+        mode_ = settings.dataMode;
+    }
+    bitOrder_ = settings.bitOrder;
+    if (settings.clock != 0) {
+        speed_ = settings.clock;
+    }
+    
+    if (device_) {
         applySettings();
     }
 }
 
+void SPIClass::endTransaction() {
+    if (transactionOwner_ != std::this_thread::get_id()) {
+        return;
+    }
+    transactionOwner_ = std::thread::id();
+    transactionMutex_.unlock();
+}
+
 uint32_t SPIClass::getClock() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return speed_;
@@ -150,7 +207,7 @@ uint32_t SPIClass::getClock() const {
 uint8_t SPIClass::transfer(uint8_t data) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ < 0) {
+    if (!device_) {
         return 0;
     }
     
@@ -164,7 +221,7 @@ uint8_t SPIClass::transfer(uint8_t data) {
     tr.speed_hz = speed_;
     tr.bits_per_word = bitsPerWord_;
     
-    if (ioctl(fd_, SPI_IOC_MESSAGE(1), &tr) < 0) {
+    if (spiMessage(*device_, 1, &tr) < 0) {
         return 0;
     }
     
@@ -174,48 +231,376 @@ uint8_t SPIClass::transfer(uint8_t data) {
 void SPIClass::transfer(uint8_t* buffer, size_t length) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ < 0 || buffer == nullptr || length == 0) {
+    if (!device_ || buffer == nullptr || length == 0) {
         return;
     }
     
-    struct spi_ioc_transfer tr;
-    memset(&tr, 0, sizeof(tr));
-    tr.tx_buf = (unsigned long)buffer;
-    tr.rx_buf = (unsigned long)buffer;
-    tr.len = length;
-    tr.speed_hz = speed_;
-    tr.bits_per_word = bitsPerWord_;
-    
-    ioctl(fd_, SPI_IOC_MESSAGE(1), &tr);
+    SpiSegment seg;
+    seg.tx = buffer;
+    seg.rx = buffer;
+    seg.length = length;
+    sendSegments(&seg, 1);
 }
 
 void SPIClass::transfer(const uint8_t* txBuffer, uint8_t* rxBuffer, size_t length) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ < 0 || txBuffer == nullptr || rxBuffer == nullptr || length == 0) {
+    if (!device_ || txBuffer == nullptr || rxBuffer == nullptr || length == 0) {
         return;
     }
     
-    struct spi_ioc_transfer tr;
-    memset(&tr, 0, sizeof(tr));
-    tr.tx_buf = (unsigned long)txBuffer;
-    tr.rx_buf = (unsigned long)rxBuffer;
-    tr.len = length;
-    tr.speed_hz = speed_;
-    tr.bits_per_word = bitsPerWord_;
+    SpiSegment seg;
+    seg.tx = txBuffer;
+    seg.rx = rxBuffer;
+    seg.length = length;
+    sendSegments(&seg, 1);
+}
+
+std::error_code SPIClass::tryTransfer(const uint8_t* txBuffer, uint8_t* rxBuffer, size_t length) noexcept {
+    if ((txBuffer == nullptr && rxBuffer == nullptr) || length == 0) {
+        return GpioErrc::INVALID_ARGUMENT;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return GpioErrc::NOT_OPEN;
+    }
+    
+    SpiSegment seg;
+    seg.tx = txBuffer;
+    seg.rx = rxBuffer;
+    seg.length = length;
+    errno = 0;
+    if (!sendSegments(&seg, 1)) {
+        return lastSystemError();
+    }
+    return {};
+}
+
+bool SPIClass::transferStream(const uint8_t* txBuffer, uint8_t* rxBuffer, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_ || (txBuffer == nullptr && rxBuffer == nullptr) || length == 0) {
+        return false;
+    }
     
-    ioctl(fd_, SPI_IOC_MESSAGE(1), &tr);
+    SpiSegment seg;
+    seg.tx = txBuffer;
+    seg.rx = rxBuffer;
+    seg.length = length;
+    return sendSegments(&seg, 1);
+}
+
+size_t SPIClass::getMaxTransferSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bufsiz_;
+}
+
+bool SPIClass::transferBatch(const SpiSegment* segments, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_ || segments == nullptr || count == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (segments[i].length == 0) {
+            return false;
+        }
+    }
+    
+    return sendSegments(segments, count);
+}
+
+bool SPIClass::transferBatch(const std::vector<SpiSegment>& segments) {
+    return transferBatch(segments.data(), segments.size());
+}
+
+size_t SpiPreparedMessage::transferCount() const {
+    return transfers_.size() / sizeof(spi_ioc_transfer);
+}
+
+bool SPIClass::prepare(const SpiSegment* segments, size_t count, SpiPreparedMessage& message) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    message.transfers_.clear();
+    message.messages_.clear();
+    if (!device_ || segments == nullptr || count == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (segments[i].length == 0) {
+            return false;
+        }
+    }
+    
+    packSegments(segments, count, message.transfers_, message.messages_);
+    return true;
+}
+
+bool SPIClass::transferPrepared(const SpiPreparedMessage& message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_ || message.empty()) {
+        return false;
+    }
+    return sendPacked(message.transfers_, message.messages_);
 }
 
 bool SPIClass::isInitialized() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return fd_ >= 0;
+    return device_ != nullptr;
+}
+
+bool SPIClass::submit(SpiTransaction transaction, SpiCompletion onComplete) {
+    // Deliberately does not take mutex_: submitting must not wait for a
+    // transfer in progress. A closed bus completes the transaction with false.
+    if (transaction.segments.empty() || transaction.settings.dataMode > 3) {
+        return false;
+    }
+    
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    
+    if (!ioRunning_) {
+        // A thread stopped by end() from inside a callback may still be exiting
+        std::thread previous = std::move(ioThread_);
+        if (previous.joinable()) {
+            lock.unlock();
+            if (previous.get_id() == std::this_thread::get_id()) {
+                previous.detach();
+            } else {
+                previous.join();
+            }
+            lock.lock();
+        }
+        if (!ioRunning_) {
+            ioRunning_ = true;
+            ioThread_ = std::thread(&SPIClass::ioThreadFunction, this);
+        }
+    }
+    
+    auto& lane = (transaction.priority == SpiPriority::HIGH) ? highLane_ : normalLane_;
+    lane.push_back({std::move(transaction), std::move(onComplete)});
+    ++pending_;
+    queueCv_.notify_one();
+    return true;
+}
+
+void SPIClass::waitForPending() {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    idleCv_.wait(lock, [this] { return pending_ == 0; });
+}
+
+size_t SPIClass::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return pending_;
+}
+
+bool SPIClass::runTransaction(const SpiTransaction& transaction) {
+    // Wait for any beginTransaction() holder, then claim the bus
+    std::lock_guard<std::mutex> claim(transactionMutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return false;
+    }
+    for (const auto& seg : transaction.segments) {
+        if (seg.length == 0) {
+            return false;
+        }
+    }
+    
+    // Only what differs from the previous device is reprogrammed
+    const SPISettings& settings = transaction.settings;
+    mode_ = settings.dataMode;
+    bitOrder_ = settings.bitOrder;
+    if (settings.clock != 0) {
+        speed_ = settings.clock;
+    }
+    if (!applySettings()) {
+        return false;
+    }
+    
+    return sendSegments(transaction.segments.data(), transaction.segments.size());
+}
+
+void SPIClass::ioThreadFunction() {
+    std::string name;
+    {
+        // One worker per bus object, named after its device
+        std::lock_guard<std::mutex> deviceLock(mutex_);
+        name = "pipinpp-spi" + std::to_string(busNumber_) + "." + std::to_string(csNumber_);
+    }
+    ThreadPolicyManager::getInstance().applyToCurrentThread(name);
+    
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    while (true) {
+        queueCv_.wait(lock, [this] {
+            return !ioRunning_ || !highLane_.empty() || !normalLane_.empty();
+        });
+        if (!ioRunning_) {
+            break;
+        }
+        
+        auto& lane = !highLane_.empty() ? highLane_ : normalLane_;
+        Pending item = std::move(lane.front());
+        lane.pop_front();
+        
+        lock.unlock();
+        bool ok = runTransaction(item.transaction);
+        if (item.onComplete) {
+            item.onComplete(ok);
+        }
+        lock.lock();
+        
+        if (--pending_ == 0) {
+            idleCv_.notify_all();
+        }
+    }
+}
+
+void SPIClass::stopQueue() {
+    std::deque<Pending> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        ioRunning_ = false;
+        queueCv_.notify_all();
+    }
+    if (ioThread_.joinable() && ioThread_.get_id() != std::this_thread::get_id()) {
+        ioThread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        cancelled.swap(highLane_);
+        for (auto& item : normalLane_) {
+            cancelled.push_back(std::move(item));
+        }
+        normalLane_.clear();
+    }
+    
+    for (auto& item : cancelled) {
+        if (item.onComplete) {
+            item.onComplete(false);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    pending_ -= cancelled.size();
+    idleCv_.notify_all();
+}
+
+size_t SPIClass::readBufsiz() {
+    // spidev bounce buffer size, a module parameter (default 4096)
+    std::ifstream file("/sys/module/spidev/parameters/bufsiz");
+    unsigned long value = 0;
+    if (file >> value && value > 0) {
+        return static_cast<size_t>(value);
+    }
+    return DEFAULT_BUFSIZ;
+}
+
+bool SPIClass::sendSegments(const SpiSegment* segments, size_t count) {
+    // Note: Mutex should already be locked by caller
+    packSegments(segments, count, batch_, batchMessages_);
+    return sendPacked(batch_, batchMessages_);
+}
+
+void SPIClass::packSegments(const SpiSegment* segments, size_t count,
+                            std::vector<unsigned char>& transfers, std::vector<size_t>& messages) const {
+    // spidev rejects a message whose tx or rx bytes exceed bufsiz, so pack
+    // segments into messages under that limit, splitting large ones. At a
+    // message boundary cs_change on the last transfer keeps CS asserted,
+    // so the whole batch still looks like one transaction to the device.
+    const size_t limit = bufsiz_;
+    transfers.clear();
+    messages.clear();
+    
+    size_t total = 0;             // Transfers laid out so far
+    size_t n = 0;                 // Transfers in the current message
+    size_t txTotal = 0;
+    size_t rxTotal = 0;
+    bool lastDeselects = false;   // Last queued transfer ends a csChange segment
+    
+    auto at = [&](size_t index) {
+        return reinterpret_cast<spi_ioc_transfer*>(transfers.data()) + index;
+    };
+    auto close = [&](bool boundary) {
+        if (n == 0) {
+            return;
+        }
+        if (boundary) {
+            // Message end releases CS; cs_change on the last transfer keeps it
+            at(total - 1)->cs_change = lastDeselects ? 0 : 1;
+        }
+        messages.push_back(n);
+        n = 0;
+        txTotal = 0;
+        rxTotal = 0;
+    };
+    
+    for (size_t i = 0; i < count; ++i) {
+        const SpiSegment& seg = segments[i];
+        size_t offset = 0;
+        
+        while (offset < seg.length) {
+            // Room left in the current message for this segment's directions
+            size_t room = limit;
+            if (seg.tx) {
+                room = std::min(room, limit - txTotal);
+            }
+            if (seg.rx) {
+                room = std::min(room, limit - rxTotal);
+            }
+            if (room == 0 || n == SPI_MAX_BATCH_SEGMENTS) {
+                close(true);
+                continue;
+            }
+            
+            size_t len = std::min(room, seg.length - offset);
+            bool last = (offset + len == seg.length);
+            
+            transfers.resize((total + 1) * sizeof(spi_ioc_transfer));
+            spi_ioc_transfer& tr = *at(total++);
+            ++n;
+            memset(&tr, 0, sizeof(tr));
+            tr.tx_buf = seg.tx ? (unsigned long)(seg.tx + offset) : 0;
+            tr.rx_buf = seg.rx ? (unsigned long)(seg.rx + offset) : 0;
+            tr.len = static_cast<uint32_t>(len);
+            tr.speed_hz = seg.speedHz ? seg.speedHz : speed_;
+            tr.bits_per_word = seg.bitsPerWord ? seg.bitsPerWord : bitsPerWord_;
+            tr.delay_usecs = last ? seg.delayUs : 0;
+            tr.cs_change = (last && seg.csChange) ? 1 : 0;
+            
+            txTotal += seg.tx ? len : 0;
+            rxTotal += seg.rx ? len : 0;
+            offset += len;
+            lastDeselects = last && seg.csChange;
+        }
+    }
+    
+    // Final transfer keeps the caller's cs_change semantics
+    close(false);
+}
+
+bool SPIClass::sendPacked(const std::vector<unsigned char>& transfers, const std::vector<size_t>& messages) {
+    // Note: Mutex should already be locked by caller
+    // The kernel only reads the array; spiMessage() takes it non-const for ioctl()
+    auto* next = reinterpret_cast<spi_ioc_transfer*>(const_cast<unsigned char*>(transfers.data()));
+    for (size_t n : messages) {
+        if (spiMessage(*device_, static_cast<unsigned int>(n), next) < 0) {
+            PIPINPP_LOG_ERROR("SPI transfer on /dev/spidev" << busNumber_ << "." << csNumber_
+                              << " failed: " << strerror(errno));
+            return false;
+        }
+        next += n;
+    }
+    return true;
 }
 
 bool SPIClass::applySettings() {
     // Note: Mutex should already be locked by caller
     
-    if (fd_ < 0) {
+    if (!device_) {
         return false;
     }
     
@@ -225,20 +610,31 @@ bool SPIClass::applySettings() {
         spiMode |= SPI_LSB_FIRST;
     }
     
-    if (ioctl(fd_, SPI_IOC_WR_MODE, &spiMode) < 0) {
-        return false;
+    if (!settingsValid_ || spiMode != appliedMode_) {
+        if (device_->ioctl(SPI_IOC_WR_MODE, &spiMode) < 0) {
+            settingsValid_ = false;
+            return false;
+        }
+        appliedMode_ = spiMode;
     }
     
     // Set bits per word
-    if (ioctl(fd_, SPI_IOC_WR_BITS_PER_WORD, &bitsPerWord_) < 0) {
-        return false;
+    if (!settingsValid_ || bitsPerWord_ != appliedBits_) {
+        if (device_->ioctl(SPI_IOC_WR_BITS_PER_WORD, &bitsPerWord_) < 0) {
+            settingsValid_ = false;
+            return false;
+        }
+        appliedBits_ = bitsPerWord_;
     }
     
-    // Set max speed
-    if (ioctl(fd_, SPI_IOC_WR_MAX_SPEED_HZ, &speed_) < 0) {
-        return false;
+    // Set max speed once per open; every transfer carries speed_hz after that
+    if (!settingsValid_) {
+        if (device_->ioctl(SPI_IOC_WR_MAX_SPEED_HZ, &speed_) < 0) {
+            return false;
+        }
     }
     
+    settingsValid_ = true;
     return true;
 }
 
@@ -10,22 +10,72 @@
 
 #include "Serial.hpp"
 #include "log.hpp"
+#include "serial_baud.hpp"
+#include "thread_policy.hpp"
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
 #include <termios.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
 #include <cstring>
-#include <sstream>
-#include <iomanip>
 
 namespace pipinpp {
 
+namespace {
+
+constexpr size_t INTEGER_CHARS = 72;   ///< 64 binary digits plus sign, with room to spare
+constexpr int MAX_DECIMALS = 64;
+
+/**
+ * Digits of @p value in @p base (uppercase). Like Arduino, non-decimal
+ * bases print the magnitude of negative numbers without a sign.
+ */
+size_t formatInteger(char* out, long long value, int base)
+{
+    std::to_chars_result result;
+    if (base == DEC) {
+        result = std::to_chars(out, out + INTEGER_CHARS, value);
+    } else {
+        unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                                 : static_cast<unsigned long long>(value);
+        result = std::to_chars(out, out + INTEGER_CHARS, magnitude, base);
+        for (char* p = out; p < result.ptr; ++p) {
+            if (*p >= 'a' && *p <= 'z') {
+                *p = static_cast<char>(*p - 'a' + 'A');
+            }
+        }
+    }
+    return static_cast<size_t>(result.ptr - out);
+}
+
+} // namespace
+
 SerialPort::SerialPort()
     : fd_(-1)
     , baudRate_(0)
     , timeout_(1000)  // Default 1 second timeout
     , device_("")
+    , rxBufferSize_(0)
+    , rxRunning_(false)
+    , rxWakeFd_(-1)
+    , rxWaiters_(0)
+    , rxOverflows_(0)
+    , txLength_(0)
+    , txThreshold_(0)
+    , txQueueSize_(0)
+    , txPolicy_(SerialBackpressure::BLOCK)
+    , txTail_(0)
+    , txCount_(0)
+    , txInFlight_(0)
+    , txStopping_(false)
+    , txRunning_(false)
+    , txDropped_(0)
 {
 }
 
@@ -39,10 +89,14 @@ bool SerialPort::begin(unsigned long baudRate, const std::string& device)
     std::lock_guard<std::mutex> lock(mutex_);
     
     // Close existing connection if open
+    stopRxLocked();
     if (fd_ >= 0) {
+        flushTxLocked();
+        stopTxLocked();
         ::close(fd_);
         fd_ = -1;
     }
+    txLength_ = 0;
     
     // Open serial port
     fd_ = ::open(device.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
@@ -63,6 +117,13 @@ bool SerialPort::begin(unsigned long baudRate, const std::string& device)
     baudRate_ = baudRate;
     
     PIPINPP_LOG_INFO("Serial port opened: " << device << " at " << baudRate << " baud");
+    
+    if ((rxBufferSize_ > 0 || frameDecoder_) && !startRxLocked()) {
+        PIPINPP_LOG_WARNING("Serial receive thread unavailable, using direct reads");
+    }
+    if (txQueueSize_ > 0 && !startTxLocked()) {
+        PIPINPP_LOG_WARNING("Serial transmit thread unavailable, using direct writes");
+    }
     return true;
 }
 
@@ -70,7 +131,10 @@ void SerialPort::end()
 {
     std::lock_guard<std::mutex> lock(mutex_);
     
+    stopRxLocked();
     if (fd_ >= 0) {
+        flushTxLocked();
+        stopTxLocked();
         ::close(fd_);
         PIPINPP_LOG_INFO("Serial port closed: " << device_);
         fd_ = -1;
@@ -85,8 +149,21 @@ bool SerialPort::isOpen() const
     return fd_ >= 0;
 }
 
+int SerialPort::getFd() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fd_;
+}
+
 int SerialPort::available()
 {
+    {
+        std::lock_guard<std::mutex> rxLock(rxReadMutex_);
+        if (rxRing_) {
+            return static_cast<int>(rxRing_->size());
+        }
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (fd_ < 0) {
@@ -104,6 +181,21 @@ int SerialPort::available()
 
 int SerialPort::read()
 {
+    {
+        std::lock_guard<std::mutex> rxLock(rxReadMutex_);
+        if (rxRing_) {
+            uint8_t byte;
+            if (rxRing_->pop(&byte, 1) == 1) {
+                return byte;
+            }
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_.load());
+            if (waitForRx(1, deadline) && rxRing_->pop(&byte, 1) == 1) {
+                return byte;
+            }
+            return -1;
+        }
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (fd_ < 0) {
@@ -135,6 +227,14 @@ int SerialPort::read()
 
 int SerialPort::peek()
 {
+    {
+        std::lock_guard<std::mutex> rxLock(rxReadMutex_);
+        if (rxRing_) {
+            uint8_t byte;
+            return rxRing_->peek(byte) ? byte : -1;
+        }
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (fd_ < 0) {
@@ -154,24 +254,22 @@ size_t SerialPort::write(uint8_t byte)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ < 0) {
+    if (fd_ < 0 || !flushTxLocked()) {
         return 0;
     }
     
-    ssize_t bytesWritten = ::write(fd_, &byte, 1);
-    return (bytesWritten > 0) ? bytesWritten : 0;
+    return sendLocked(&byte, 1);
 }
 
 size_t SerialPort::write(const uint8_t* buffer, size_t size)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ < 0 || buffer == nullptr || size == 0) {
+    if (fd_ < 0 || buffer == nullptr || size == 0 || !flushTxLocked()) {
         return 0;
     }
     
-    ssize_t bytesWritten = ::write(fd_, buffer, size);
-    return (bytesWritten > 0) ? bytesWritten : 0;
+    return sendLocked(buffer, size);
 }
 
 size_t SerialPort::write(const std::string& str)
@@ -181,91 +279,87 @@ size_t SerialPort::write(const std::string& str)
 
 size_t SerialPort::print(const std::string& data)
 {
-    return write(data);
+    return printText(data.data(), data.size(), false);
 }
 
 size_t SerialPort::print(int num)
 {
-    return write(std::to_string(num));
+    return printInteger(num, DEC, false);
 }
 
 size_t SerialPort::print(int num, PrintFormat format)
 {
-    return write(formatNumber(num, format));
+    return printInteger(num, format, false);
 }
 
 size_t SerialPort::print(long num)
 {
-    return write(std::to_string(num));
+    return printInteger(num, DEC, false);
 }
 
 size_t SerialPort::print(long num, PrintFormat format)
 {
-    return write(formatNumber(num, format));
+    return printInteger(num, format, false);
 }
 
 size_t SerialPort::print(unsigned int num)
 {
-    return write(std::to_string(num));
+    return printInteger(num, DEC, false);
 }
 
 size_t SerialPort::print(unsigned int num, PrintFormat format)
 {
-    return write(formatNumber(static_cast<long>(num), format));
+    return printInteger(static_cast<long>(num), format, false);
 }
 
 size_t SerialPort::print(double num, int decimals)
 {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(decimals) << num;
-    return write(oss.str());
+    return printDouble(num, decimals, false);
 }
 
 size_t SerialPort::println(const std::string& data)
 {
-    return write(data + "\r\n");
+    return printText(data.data(), data.size(), true);
 }
 
 size_t SerialPort::println(int num)
 {
-    return write(std::to_string(num) + "\r\n");
+    return printInteger(num, DEC, true);
 }
 
 size_t SerialPort::println(int num, PrintFormat format)
 {
-    return write(formatNumber(num, format) + "\r\n");
+    return printInteger(num, format, true);
 }
 
 size_t SerialPort::println(long num)
 {
-    return write(std::to_string(num) + "\r\n");
+    return printInteger(num, DEC, true);
 }
 
 size_t SerialPort::println(long num, PrintFormat format)
 {
-    return write(formatNumber(num, format) + "\r\n");
+    return printInteger(num, format, true);
 }
 
 size_t SerialPort::println(unsigned int num)
 {
-    return write(std::to_string(num) + "\r\n");
+    return printInteger(num, DEC, true);
 }
 
 size_t SerialPort::println(unsigned int num, PrintFormat format)
 {
-    return write(formatNumber(static_cast<long>(num), format) + "\r\n");
+    return printInteger(static_cast<long>(num), format, true);
 }
 
 size_t SerialPort::println(double num, int decimals)
 {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(decimals) << num;
-    return write(oss.str() + "\r\n");
+    return printDouble(num, decimals, true);
 }
 
 size_t SerialPort::println()
 {
-    return write("\r\n");
+    return printText("", 0, true);
 }
 
 std::string SerialPort::readString()
@@ -283,6 +377,27 @@ std::string SerialPort::readString()
     return result;
 }
 
+size_t SerialPort::readBytesUntil(char terminator, uint8_t* buffer, size_t length)
+{
+    if (buffer == nullptr || length == 0) {
+        return 0;
+    }
+    
+    size_t stored = 0;
+    while (stored < length) {
+        int byte = read();
+        if (byte < 0) {
+            break;  // Timeout
+        }
+        if (static_cast<char>(byte) == terminator) {
+            break;  // Found terminator
+        }
+        buffer[stored++] = static_cast<uint8_t>(byte);
+    }
+    
+    return stored;
+}
+
 std::string SerialPort::readStringUntil(char terminator)
 {
     std::string result;
@@ -312,6 +427,12 @@ void SerialPort::flush()
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (fd_ >= 0) {
+        flushTxLocked();
+        if (txRunning_.load()) {
+            // Wait for the writer thread to hand everything to the driver
+            std::unique_lock<std::mutex> txLock(txQueueMutex_);
+            txIdleCv_.wait(txLock, [this]() { return txCount_ == 0 || !txRunning_.load(); });
+        }
         ::tcdrain(fd_);  // Wait for all output to be transmitted
     }
 }
@@ -322,6 +443,229 @@ unsigned long SerialPort::getBaudRate() const
     return baudRate_;
 }
 
+size_t SerialPort::readBytes(uint8_t* buffer, size_t length)
+{
+    if (buffer == nullptr || length == 0) {
+        return 0;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_.load());
+    
+    {
+        std::lock_guard<std::mutex> rxLock(rxReadMutex_);
+        if (rxRing_) {
+            size_t received = rxRing_->pop(buffer, length);
+            while (received < length && waitForRx(1, deadline)) {
+                received += rxRing_->pop(buffer + received, length - received);
+            }
+            return received;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (fd_ < 0) {
+        return 0;
+    }
+    
+    size_t received = 0;
+    while (received < length) {
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining < 0) {
+            remaining = 0;
+        }
+        
+        fd_set readfds;
+        struct timeval tv;
+        FD_ZERO(&readfds);
+        FD_SET(fd_, &readfds);
+        tv.tv_sec = remaining / 1000000;
+        tv.tv_usec = remaining % 1000000;
+        
+        if (::select(fd_ + 1, &readfds, nullptr, nullptr, &tv) <= 0) {
+            break;  // Timeout or error
+        }
+        
+        ssize_t bytesRead = ::read(fd_, buffer + received, length - received);
+        if (bytesRead <= 0) {
+            break;
+        }
+        received += static_cast<size_t>(bytesRead);
+    }
+    
+    return received;
+}
+
+bool SerialPort::beginRxThread(size_t bufferSize)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (bufferSize == 0) {
+        return false;
+    }
+    
+    stopRxLocked();
+    rxBufferSize_ = bufferSize;
+    
+    if (fd_ < 0) {
+        return true;  // Starts with the next begin()
+    }
+    return startRxLocked();
+}
+
+void SerialPort::endRxThread()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopRxLocked();
+    rxBufferSize_ = 0;
+    
+    if (frameDecoder_ && fd_ >= 0) {
+        startRxLocked();  // Frame mode keeps its own receive thread
+    }
+}
+
+bool SerialPort::isRxThreadRunning() const
+{
+    return rxRunning_.load();
+}
+
+uint64_t SerialPort::getRxOverflowCount() const
+{
+    return rxOverflows_.load();
+}
+
+bool SerialPort::startRxLocked()
+{
+    rxWakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (rxWakeFd_ < 0) {
+        PIPINPP_LOG_ERROR("Failed to create serial receive eventfd (errno: " << errno << ")");
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> rxLock(rxReadMutex_);
+        // Frame mode decodes in rxLoop() and leaves the ring empty
+        rxRing_.reset(new SpscRing<uint8_t>(frameDecoder_ ? 2 : rxBufferSize_));
+    }
+    rxOverflows_.store(0);
+    rxRunning_.store(true);
+    rxThread_ = std::thread(&SerialPort::rxLoop, this);
+    return true;
+}
+
+void SerialPort::stopRxLocked()
+{
+    if (rxThread_.joinable()) {
+        uint64_t one = 1;
+        ssize_t written = ::write(rxWakeFd_, &one, sizeof(one));
+        (void)written;
+        rxThread_.join();
+    }
+    rxRunning_.store(false);
+    
+    // Wake consumers blocked in waitForRx(), then drop the ring
+    {
+        std::lock_guard<std::mutex> waitLock(rxWaitMutex_);
+        rxCv_.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> rxLock(rxReadMutex_);
+        rxRing_.reset();
+    }
+    
+    if (rxWakeFd_ >= 0) {
+        ::close(rxWakeFd_);
+        rxWakeFd_ = -1;
+    }
+}
+
+void SerialPort::rxLoop()
+{
+    PIPINPP_LOG_DEBUG("Serial receive thread started for " << device_);
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-uart");
+    
+    uint8_t chunk[4096];
+    struct pollfd fds[2];
+    fds[0].fd = fd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = rxWakeFd_;
+    fds[1].events = POLLIN;
+    
+    while (true) {
+        int ready = ::poll(fds, 2, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PIPINPP_LOG_ERROR("Serial receive poll failed (errno: " << errno << ")");
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;  // stopRxLocked()
+        }
+        
+        // Drain everything the driver has buffered, waking readers per chunk
+        if (fds[0].revents & POLLIN) {
+            ssize_t bytesRead;
+            while ((bytesRead = ::read(fd_, chunk, sizeof(chunk))) > 0) {
+                if (frameDecoder_) {
+                    frameDecoder_->feed(chunk, static_cast<size_t>(bytesRead));
+                    continue;
+                }
+                
+                size_t stored = rxRing_->push(chunk, static_cast<size_t>(bytesRead));
+                if (stored < static_cast<size_t>(bytesRead)) {
+                    rxOverflows_.fetch_add(static_cast<size_t>(bytesRead) - stored);
+                }
+                
+                // Pairs with the fence in waitForRx(): either the waiter sees the data or we see the waiter
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (rxWaiters_.load() > 0) {
+                    std::lock_guard<std::mutex> waitLock(rxWaitMutex_);
+                    rxCv_.notify_all();
+                }
+            }
+        }
+        
+        if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            PIPINPP_LOG_WARNING("Serial port " << device_ << " hung up");
+            break;
+        }
+    }
+    
+    rxRunning_.store(false);
+    {
+        std::lock_guard<std::mutex> waitLock(rxWaitMutex_);
+        rxCv_.notify_all();
+    }
+    PIPINPP_LOG_DEBUG("Serial receive thread stopped for " << device_);
+}
+
+bool SerialPort::waitForRx(size_t count, std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> waitLock(rxWaitMutex_);
+    rxWaiters_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    rxCv_.wait_until(waitLock, deadline, [&]() {
+        return rxRing_->size() >= count || !rxRunning_.load();
+    });
+    rxWaiters_.fetch_sub(1);
+    return rxRing_->size() >= count;
+}
+
+unsigned long SerialPort::getActualBaudRate() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fd_ >= 0 ? getTermiosBaudRate(fd_) : 0;
+}
+
+bool SerialPort::setLowLatency(bool enable)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fd_ >= 0 && setSerialLowLatency(fd_, enable);
+}
+
 bool SerialPort::configurePort(unsigned long baudRate)
 {
     struct termios tty;
@@ -332,16 +676,17 @@ bool SerialPort::configurePort(unsigned long baudRate)
         return false;
     }
     
-    // Get baud rate constant
-    speed_t speed = getBaudRateConstant(baudRate);
-    if (speed == 0) {
+    if (baudRate == 0) {
         PIPINPP_LOG_ERROR("Invalid baud rate: " << baudRate);
         return false;
     }
     
-    // Set baud rate
-    ::cfsetospeed(&tty, speed);
-    ::cfsetispeed(&tty, speed);
+    // Standard rates through termios; anything else through termios2 (BOTHER) below
+    speed_t speed = getBaudRateConstant(baudRate);
+    if (speed != 0) {
+        ::cfsetospeed(&tty, speed);
+        ::cfsetispeed(&tty, speed);
+    }
     
     // Configure 8N1 (8 data bits, no parity, 1 stop bit)
     tty.c_cflag &= ~PARENB;        // No parity
@@ -370,6 +715,11 @@ bool SerialPort::configurePort(unsigned long baudRate)
         return false;
     }
     
+    if (speed == 0 && !setTermiosBaudRate(fd_, baudRate)) {
+        PIPINPP_LOG_ERROR("Baud rate not supported by driver: " << baudRate);
+        return false;
+    }
+    
     // Flush buffers
     ::tcflush(fd_, TCIOFLUSH);
     
@@ -416,38 +766,425 @@ speed_t SerialPort::getBaudRateConstant(unsigned long baudRate) const
 
 std::string SerialPort::formatNumber(long num, int base) const
 {
-    // Handle negative numbers
-    bool negative = (num < 0);
-    unsigned long absNum = negative ? -num : num;
+    char digits[INTEGER_CHARS];
+    return std::string(digits, formatInteger(digits, num, base));
+}
+
+void SerialPort::setTxBuffering(size_t threshold)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    txThreshold_ = std::min(threshold, SERIAL_TX_BUFFER_SIZE);
+    if (txThreshold_ == 0) {
+        flushTxLocked();
+    }
+}
+
+size_t SerialPort::getTxPending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return txLength_;
+}
+
+size_t SerialPort::printText(const char* data, size_t length, bool endOfLine)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    if (base == DEC) {
-        return std::to_string(num);
+    if (fd_ < 0) {
+        return 0;
     }
     
-    // For HEX, OCT, BIN - convert unsigned value
-    std::string result;
-    const char* digits = "0123456789ABCDEF";
+    size_t total = length + (endOfLine ? 2 : 0);
+    if (txLength_ + total > SERIAL_TX_BUFFER_SIZE && !flushTxLocked()) {
+        return 0;
+    }
     
-    if (absNum == 0) {
-        return "0";
+    if (total > SERIAL_TX_BUFFER_SIZE && txRunning_.load()) {
+        size_t queued = enqueueTx(reinterpret_cast<const uint8_t*>(data), length);
+        if (queued == length && endOfLine) {
+            queued += enqueueTx(reinterpret_cast<const uint8_t*>("\r\n"), 2);
+        }
+        return queued;
+    }
+    if (total > SERIAL_TX_BUFFER_SIZE) {
+        // Too long to stage: text and line ending in one writev()
+        struct iovec parts[2];
+        parts[0].iov_base = const_cast<char*>(data);
+        parts[0].iov_len = length;
+        parts[1].iov_base = const_cast<char*>("\r\n");
+        parts[1].iov_len = endOfLine ? 2 : 0;
+        ssize_t bytesWritten = ::writev(fd_, parts, 2);
+        return (bytesWritten > 0) ? bytesWritten : 0;
     }
     
-    while (absNum > 0) {
-        result = digits[absNum % base] + result;
-        absNum /= base;
+    std::memcpy(txBuffer_ + txLength_, data, length);
+    txLength_ += length;
+    if (endOfLine) {
+        txBuffer_[txLength_++] = '\r';
+        txBuffer_[txLength_++] = '\n';
     }
     
-    // Add prefix for HEX, OCT, BIN (optional, Arduino doesn't do this)
-    // Commenting out for Arduino compatibility
-    // if (base == HEX) result = "0x" + result;
-    // if (base == OCT) result = "0" + result;
-    // if (base == BIN) result = "0b" + result;
+    if (txThreshold_ == 0 || endOfLine || txLength_ >= txThreshold_) {
+        if (!flushTxLocked()) {
+            return 0;
+        }
+    }
+    return total;
+}
+
+size_t SerialPort::printInteger(long long value, int base, bool endOfLine)
+{
+    char digits[INTEGER_CHARS];
+    return printText(digits, formatInteger(digits, value, base), endOfLine);
+}
+
+size_t SerialPort::printDouble(double value, int decimals, bool endOfLine)
+{
+    // Largest fixed-notation double: 309 integer digits, sign, point, decimals
+    decimals = std::max(0, std::min(decimals, MAX_DECIMALS));
+    char digits[384];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, decimals);
+    size_t length = static_cast<size_t>(result.ptr - digits);
+#else
+    int formatted = std::snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+    size_t length = formatted > 0 ? std::min(static_cast<size_t>(formatted), sizeof(digits) - 1) : 0;
+#endif
+    return printText(digits, length, endOfLine);
+}
+
+bool SerialPort::flushTxLocked()
+{
+    if (txRunning_.load() && txLength_ > 0) {
+        size_t queued = enqueueTx(reinterpret_cast<const uint8_t*>(txBuffer_), txLength_);
+        bool ok = queued == txLength_;
+        txLength_ = 0;
+        return ok;
+    }
     
-    if (negative && base == DEC) {
-        result = "-" + result;
+    size_t sent = 0;
+    while (sent < txLength_) {
+        ssize_t bytesWritten = ::write(fd_, txBuffer_ + sent, txLength_ - sent);
+        if (bytesWritten > 0) {
+            sent += static_cast<size_t>(bytesWritten);
+            continue;
+        }
+        
+        // O_NDELAY port: wait for room in the driver's output buffer
+        struct pollfd pfd;
+        pfd.fd = fd_;
+        pfd.events = POLLOUT;
+        if (bytesWritten < 0 && (errno == EAGAIN || errno == EINTR) &&
+            ::poll(&pfd, 1, static_cast<int>(timeout_.load())) > 0) {
+            continue;
+        }
+        
+        PIPINPP_LOG_ERROR("Serial write failed (errno: " << errno << ")");
+        txLength_ = 0;
+        return false;
+    }
+    txLength_ = 0;
+    return true;
+}
+
+size_t SerialPort::sendLocked(const uint8_t* data, size_t length)
+{
+    if (txRunning_.load()) {
+        return enqueueTx(data, length);
     }
     
-    return result;
+    ssize_t bytesWritten = ::write(fd_, data, length);
+    return (bytesWritten > 0) ? bytesWritten : 0;
+}
+
+bool SerialPort::beginTxThread(size_t queueSize, SerialBackpressure policy)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (queueSize == 0) {
+        return false;
+    }
+    
+    if (fd_ >= 0) {
+        flushTxLocked();
+    }
+    stopTxLocked();
+    txQueueSize_ = queueSize;
+    txPolicy_ = policy;
+    
+    if (fd_ < 0) {
+        return true;  // Starts with the next begin()
+    }
+    return startTxLocked();
+}
+
+void SerialPort::endTxThread()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0) {
+        flushTxLocked();
+    }
+    stopTxLocked();
+    txQueueSize_ = 0;
+}
+
+bool SerialPort::isTxThreadRunning() const
+{
+    return txRunning_.load();
+}
+
+size_t SerialPort::getTxQueued() const
+{
+    std::lock_guard<std::mutex> txLock(txQueueMutex_);
+    return txCount_;
+}
+
+uint64_t SerialPort::getTxDroppedCount() const
+{
+    return txDropped_.load();
+}
+
+bool SerialPort::beginFrameMode(FrameEncoding encoding, FrameCrc crc, FrameCallback callback,
+                                size_t maxFrameSize)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!callback || maxFrameSize == 0) {
+        return false;
+    }
+    
+    // The decoder is only touched by rxLoop(), so swap it while the thread is stopped
+    stopRxLocked();
+    frameDecoder_.reset(new FrameDecoder(encoding, crc, maxFrameSize));
+    frameDecoder_->setCallback(std::move(callback));
+    frameTxBuffer_.resize(maxEncodedFrameSize(encoding, crc, maxFrameSize));
+    
+    if (fd_ < 0) {
+        return true;  // Starts with the next begin()
+    }
+    return startRxLocked();
+}
+
+void SerialPort::endFrameMode()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!frameDecoder_) {
+        return;
+    }
+    stopRxLocked();
+    frameDecoder_.reset();
+    if (rxBufferSize_ > 0 && fd_ >= 0) {
+        startRxLocked();
+    }
+}
+
+bool SerialPort::isFrameMode() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frameDecoder_ != nullptr;
+}
+
+size_t SerialPort::writeFrame(const uint8_t* payload, size_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (fd_ < 0 || !frameDecoder_ || (payload == nullptr && length > 0) ||
+        length > frameDecoder_->getMaxFrameSize() || !flushTxLocked()) {
+        return 0;
+    }
+    
+    size_t encoded = encodeFrame(frameDecoder_->getEncoding(), frameDecoder_->getCrc(),
+                                 payload, length, frameTxBuffer_.data(), frameTxBuffer_.size());
+    if (encoded == 0) {
+        return 0;
+    }
+    
+    // A frame must go out whole: finish short direct writes
+    size_t sent = 0;
+    while (sent < encoded) {
+        size_t written = sendLocked(frameTxBuffer_.data() + sent, encoded - sent);
+        if (written == 0) {
+            struct pollfd pfd;
+            pfd.fd = fd_;
+            pfd.events = POLLOUT;
+            if (txRunning_.load() || ::poll(&pfd, 1, static_cast<int>(timeout_.load())) <= 0) {
+                break;
+            }
+            continue;
+        }
+        sent += written;
+    }
+    return sent == encoded ? encoded : 0;
+}
+
+FrameStats SerialPort::getFrameStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frameDecoder_ ? frameDecoder_->getStats() : FrameStats();
+}
+
+size_t SerialPort::enqueueTx(const uint8_t* data, size_t length)
+{
+    std::unique_lock<std::mutex> txLock(txQueueMutex_);
+    
+    if (txPolicy_ == SerialBackpressure::ERROR && length > txQueueSize_ - txCount_) {
+        return 0;
+    }
+    if (txPolicy_ == SerialBackpressure::DROP_OLDEST && length > txQueueSize_) {
+        // Only the newest queue-full of this write can survive
+        size_t skipped = length - txQueueSize_;
+        txDropped_.fetch_add(skipped);
+        data += skipped;
+        length = txQueueSize_;
+    }
+    
+    size_t accepted = 0;
+    while (accepted < length && !txStopping_) {
+        size_t space = txQueueSize_ - txCount_;
+        if (txPolicy_ == SerialBackpressure::DROP_OLDEST && space < length - accepted) {
+            // Close the gap after the bytes the writer is sending (overflow only)
+            size_t drop = std::min(length - accepted - space, txCount_ - txInFlight_);
+            size_t keep = txCount_ - txInFlight_ - drop;
+            size_t start = txTail_ + txInFlight_;
+            for (size_t i = 0; i < keep; ++i) {
+                txQueue_[(start + i) % txQueueSize_] = txQueue_[(start + drop + i) % txQueueSize_];
+            }
+            txCount_ -= drop;
+            txDropped_.fetch_add(drop);
+            space += drop;
+        }
+        if (space == 0) {
+            txSpaceCv_.wait(txLock);  // BLOCK, or DROP_OLDEST behind in-flight bytes
+            continue;
+        }
+        
+        size_t head = (txTail_ + txCount_) % txQueueSize_;
+        size_t chunk = std::min({length - accepted, space, txQueueSize_ - head});
+        std::memcpy(txQueue_.get() + head, data + accepted, chunk);
+        txCount_ += chunk;
+        accepted += chunk;
+        txDataCv_.notify_one();
+    }
+    return accepted;
+}
+
+bool SerialPort::startTxLocked()
+{
+    {
+        std::lock_guard<std::mutex> txLock(txQueueMutex_);
+        txQueue_.reset(new uint8_t[txQueueSize_]);
+        txTail_ = 0;
+        txCount_ = 0;
+        txInFlight_ = 0;
+        txStopping_ = false;
+    }
+    txDropped_.store(0);
+    txRunning_.store(true);
+    txThread_ = std::thread(&SerialPort::txLoop, this);
+    return true;
+}
+
+void SerialPort::stopTxLocked()
+{
+    if (txThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> txLock(txQueueMutex_);
+            txStopping_ = true;
+            txDataCv_.notify_one();
+        }
+        txThread_.join();
+    }
+    txRunning_.store(false);
+    
+    std::lock_guard<std::mutex> txLock(txQueueMutex_);
+    txQueue_.reset();
+    txCount_ = 0;
+    txInFlight_ = 0;
+}
+
+void SerialPort::txLoop()
+{
+    PIPINPP_LOG_DEBUG("Serial transmit thread started for " << device_);
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-uart-tx");
+    
+    const auto never = std::chrono::steady_clock::time_point();
+    auto stalledSince = never;
+    bool waitWritable = false;
+    std::unique_lock<std::mutex> txLock(txQueueMutex_);
+    
+    while (true) {
+        txDataCv_.wait(txLock, [this]() { return txCount_ > 0 || txStopping_; });
+        if (txCount_ == 0) {
+            break;  // Stopping with nothing left to send
+        }
+        
+        bool fatal = false;
+        int error = 0;
+        if (waitWritable) {
+            // O_NDELAY port is full: wait for room, checking for stop now and then.
+            // The queue stays unlocked and nothing is in flight, so DROP_OLDEST can trim it.
+            txLock.unlock();
+            struct pollfd pfd;
+            pfd.fd = fd_;
+            pfd.events = POLLOUT;
+            int ready = ::poll(&pfd, 1, 50);
+            txLock.lock();
+            fatal = ready > 0 && (pfd.revents & (POLLERR | POLLHUP | POLLNVAL));
+            waitWritable = false;
+        } else {
+            // Everything pending, as the queue's one or two contiguous spans
+            struct iovec parts[2];
+            size_t first = std::min(txCount_, txQueueSize_ - txTail_);
+            parts[0].iov_base = txQueue_.get() + txTail_;
+            parts[0].iov_len = first;
+            parts[1].iov_base = txQueue_.get();
+            parts[1].iov_len = txCount_ - first;
+            txInFlight_ = txCount_;
+            
+            txLock.unlock();
+            ssize_t bytesWritten = ::writev(fd_, parts, parts[1].iov_len > 0 ? 2 : 1);
+            error = errno;
+            txLock.lock();
+            txInFlight_ = 0;
+            
+            if (bytesWritten > 0) {
+                txTail_ = (txTail_ + static_cast<size_t>(bytesWritten)) % txQueueSize_;
+                txCount_ -= static_cast<size_t>(bytesWritten);
+                stalledSince = never;
+            } else if (bytesWritten < 0 && (error == EAGAIN || error == EINTR)) {
+                waitWritable = error == EAGAIN;
+            } else {
+                fatal = true;
+            }
+        }
+        
+        if (!fatal && waitWritable && txStopping_) {
+            // Don't let end() hang on a stuck UART for longer than the timeout
+            auto now = std::chrono::steady_clock::now();
+            if (stalledSince == never) {
+                stalledSince = now;
+            } else if (now - stalledSince > std::chrono::milliseconds(timeout_.load())) {
+                fatal = true;
+            }
+        }
+        if (fatal) {
+            PIPINPP_LOG_ERROR("Serial transmit failed, dropping " << txCount_ << " queued bytes (errno: " << error << ")");
+            (void)error;
+            txCount_ = 0;
+            txTail_ = 0;
+            waitWritable = false;
+        }
+        
+        txSpaceCv_.notify_all();
+        if (txCount_ == 0) {
+            txIdleCv_.notify_all();
+        }
+    }
+    
+    txRunning_.store(false);
+    txSpaceCv_.notify_all();
+    txIdleCv_.notify_all();
+    PIPINPP_LOG_DEBUG("Serial transmit thread stopped for " << device_);
 }
 
 } // namespace pipinpp
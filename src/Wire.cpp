@@ -28,25 +28,46 @@
  */
 
 #include "Wire.hpp"
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/ioctl.h>
+#include "metrics.hpp"
 #include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <cerrno>
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
-#include <sys/stat.h>
+#include <cstdio>
 
 namespace pipinpp {
 
+namespace {
+
+/**
+ * @brief ioctl(I2C_RDWR) recorded in the i2c_transaction_ns/i2c_errors metrics
+ */
+int i2cReadWrite(DeviceFile& device, i2c_rdwr_ioctl_data& data) {
+    PIPINPP_METRIC_TIME_SCOPE("i2c_transaction_ns");
+    int result = device.ioctl(I2C_RDWR, &data);
+    if (result < 0) {
+        PIPINPP_METRIC_COUNT("i2c_errors", 1);
+    }
+    return result;
+}
+
+} // namespace
+
 // Global Wire instance
 WireClass Wire;
 
 WireClass::WireClass()
-    : fd_(-1)
+    : device_()
     , busNumber_(-1)
     , clockFrequency_(100000)  // Default 100kHz
     , txAddress_(0)
     , rxIndex_(0)
+    , combinedSupported_(false)
+    , pendingWrite_(false)
+    , slaveAddress_(-1)
+    , functionality_(0)
 {
     txBuffer_.reserve(BUFFER_SIZE);
     rxBuffer_.reserve(BUFFER_SIZE);
@@ -69,60 +90,27 @@ bool WireClass::begin() {
         return false;
     }
     
-    // Close existing connection if any
-    if (fd_ >= 0) {
-        close(fd_);
-    }
-    
-    busNumber_ = detectedBus;
-    
-    // Open I2C device
-    char filename[20];
-    snprintf(filename, sizeof(filename), "/dev/i2c-%d", busNumber_);
-    
-    fd_ = open(filename, O_RDWR);
-    if (fd_ < 0) {
-        busNumber_ = -1;
-        return false;
-    }
-    
-    return true;
+    return openBus(detectedBus);
 }
 
 bool WireClass::begin(int busNumber) {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (fd_ >= 0) {
-        close(fd_);
-    }
-    
-    busNumber_ = busNumber;
-    
-    // Open I2C device
-    char filename[20];
-    snprintf(filename, sizeof(filename), "/dev/i2c-%d", busNumber_);
-    
-    fd_ = open(filename, O_RDWR);
-    if (fd_ < 0) {
-        busNumber_ = -1;
-        return false;
-    }
-    
-    return true;
+    return openBus(busNumber);
 }
 
 void WireClass::end() {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ >= 0) {
-        close(fd_);
-        fd_ = -1;
-    }
+    device_.reset();
     
     busNumber_ = -1;
     txBuffer_.clear();
     rxBuffer_.clear();
     rxIndex_ = 0;
+    pendingWrite_ = false;
+    combinedSupported_ = false;
+    slaveAddress_ = -1;
+    functionality_ = 0;
 }
 
 /* ------------------------------------------------------------ */
@@ -132,15 +120,15 @@ void WireClass::end() {
 void WireClass::beginTransmission(uint8_t address) {
     std::lock_guard<std::mutex> lock(mutex_);
     
+    flushPendingWrite();
     txAddress_ = address;
     txBuffer_.clear();
 }
 
 uint8_t WireClass::endTransmission(bool sendStop) {
-    (void)sendStop;  // Parameter not used on Linux i2c-dev (always sends STOP)
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ < 0) {
+    if (!device_) {
         return 4;  // Other error (not initialized)
     }
     
@@ -148,23 +136,15 @@ uint8_t WireClass::endTransmission(bool sendStop) {
         return 0;  // Success (nothing to send)
     }
     
-    if (!setSlaveAddress(txAddress_)) {
-        return 2;  // NACK on address
-    }
-    
-    // Write data
-    ssize_t written = ::write(fd_, txBuffer_.data(), txBuffer_.size());
-    
-    if (written < 0) {
-        return 3;  // NACK on data
-    }
-    
-    if (static_cast<size_t>(written) != txBuffer_.size()) {
-        return 3;  // Incomplete write
+    // Repeated START: hold the write for the following requestFrom()
+    if (!sendStop && combinedSupported_) {
+        pendingWrite_ = true;
+        return 0;
     }
     
+    uint8_t error = writeLocked(txAddress_, txBuffer_.data(), txBuffer_.size());
     txBuffer_.clear();
-    return 0;  // Success
+    return error;
 }
 
 uint8_t WireClass::endTransmission() {
@@ -205,18 +185,15 @@ size_t WireClass::write(const uint8_t* data, size_t length) {
 /* ------------------------------------------------------------ */
 
 size_t WireClass::requestFrom(uint8_t address, size_t quantity, bool sendStop) {
-    (void)sendStop;  // Parameter not used on Linux i2c-dev (always sends STOP)
+    (void)sendStop;  // A read always ends the I2C_RDWR transaction with STOP
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (fd_ < 0) {
+    if (!device_) {
         return 0;
     }
     
     if (quantity == 0 || quantity > BUFFER_SIZE) {
-        return 0;
-    }
-    
-    if (!setSlaveAddress(address)) {
+        flushPendingWrite();
         return 0;
     }
     
@@ -224,8 +201,17 @@ size_t WireClass::requestFrom(uint8_t address, size_t quantity, bool sendStop) {
     rxBuffer_.resize(quantity);
     rxIndex_ = 0;
     
-    // Read data
-    ssize_t bytesRead = ::read(fd_, rxBuffer_.data(), quantity);
+    int bytesRead;
+    if (pendingWrite_ && txAddress_ == address) {
+        // Write held by endTransmission(false), repeated START, read
+        bytesRead = writeReadLocked(address, txBuffer_.data(), txBuffer_.size(),
+                                    rxBuffer_.data(), quantity);
+        pendingWrite_ = false;
+        txBuffer_.clear();
+    } else {
+        flushPendingWrite();
+        bytesRead = writeReadLocked(address, nullptr, 0, rxBuffer_.data(), quantity);
+    }
     
     if (bytesRead < 0) {
         rxBuffer_.clear();
@@ -297,51 +283,195 @@ uint32_t WireClass::getClock() const {
 /* ------------------------------------------------------------ */
 
 int WireClass::readRegister(uint8_t address, uint8_t reg) {
-    beginTransmission(address);
-    write(reg);
+    uint8_t value = 0;
+    if (readRegisters(address, reg, &value, 1) != 1) {
+        return -1;
+    }
+    return value;
+}
+
+bool WireClass::writeRegister(uint8_t address, uint8_t reg, uint8_t value) {
+    return writeRegisters(address, reg, &value, 1);
+}
+
+/* ------------------------------------------------------------ */
+/*                   SMBUS FAST PATHS                           */
+/* ------------------------------------------------------------ */
+
+static_assert(WireClass::SMBUS_BLOCK_MAX == I2C_SMBUS_BLOCK_MAX,
+              "SMBUS_BLOCK_MAX must match the kernel limit");
+
+int WireClass::smbusReadByteData(uint8_t address, uint8_t command) {
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    if (this->endTransmission(false) != 0) {  // Repeated START
+    if (!device_) {
         return -1;
     }
     
-    if (this->requestFrom(address, static_cast<size_t>(1), true) != 1) {
+    flushPendingWrite();
+    i2c_smbus_data data;
+    if (!smbusLocked(address, I2C_SMBUS_READ, command, I2C_SMBUS_BYTE_DATA, &data)) {
+        return -1;
+    }
+    return data.byte;
+}
+
+int WireClass::smbusReadWordData(uint8_t address, uint8_t command) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
         return -1;
     }
     
-    return read();
+    flushPendingWrite();
+    i2c_smbus_data data;
+    if (!smbusLocked(address, I2C_SMBUS_READ, command, I2C_SMBUS_WORD_DATA, &data)) {
+        return -1;
+    }
+    return data.word;
 }
 
-bool WireClass::writeRegister(uint8_t address, uint8_t reg, uint8_t value) {
-    beginTransmission(address);
-    write(reg);
-    write(value);
+int WireClass::smbusReadI2cBlockData(uint8_t address, uint8_t command, uint8_t* buffer, size_t length) {
+    if (buffer == nullptr || length == 0 || length > SMBUS_BLOCK_MAX) {
+        return -1;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return -1;
+    }
+    
+    flushPendingWrite();
+    i2c_smbus_data data;
+    data.block[0] = static_cast<uint8_t>(length);
+    if (!smbusLocked(address, I2C_SMBUS_READ, command, I2C_SMBUS_I2C_BLOCK_DATA, &data)) {
+        return -1;
+    }
+    
+    size_t received = std::min<size_t>(data.block[0], length);
+    memcpy(buffer, data.block + 1, received);
+    return static_cast<int>(received);
+}
+
+bool WireClass::smbusWriteByteData(uint8_t address, uint8_t command, uint8_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return false;
+    }
+    
+    flushPendingWrite();
+    i2c_smbus_data data;
+    data.byte = value;
+    return smbusLocked(address, I2C_SMBUS_WRITE, command, I2C_SMBUS_BYTE_DATA, &data);
+}
+
+bool WireClass::smbusWriteWordData(uint8_t address, uint8_t command, uint16_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    return this->endTransmission(true) == 0;
+    if (!device_) {
+        return false;
+    }
+    
+    flushPendingWrite();
+    i2c_smbus_data data;
+    data.word = value;
+    return smbusLocked(address, I2C_SMBUS_WRITE, command, I2C_SMBUS_WORD_DATA, &data);
+}
+
+bool WireClass::smbusWriteI2cBlockData(uint8_t address, uint8_t command, const uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0 || length > SMBUS_BLOCK_MAX) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return false;
+    }
+    
+    flushPendingWrite();
+    i2c_smbus_data block;
+    block.block[0] = static_cast<uint8_t>(length);
+    memcpy(block.block + 1, data, length);
+    return smbusLocked(address, I2C_SMBUS_WRITE, command, I2C_SMBUS_I2C_BLOCK_DATA, &block);
 }
 
 int WireClass::readRegisters(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length) {
-    if (buffer == nullptr || length == 0) {
+    if (buffer == nullptr || length == 0 || length > UINT16_MAX) {
         return -1;
     }
     
-    beginTransmission(address);
-    write(reg);
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    if (this->endTransmission(false) != 0) {  // Repeated START
+    if (!device_) {
         return -1;
     }
     
-    size_t received = this->requestFrom(address, length, true);
+    flushPendingWrite();
+    return writeReadLocked(address, &reg, 1, buffer, length);
+}
+
+bool WireClass::writeRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0 || length >= BUFFER_SIZE) {
+        return false;
+    }
     
-    for (size_t i = 0; i < received; i++) {
-        int byte = read();
-        if (byte < 0) {
-            return i;  // Return how many we got
-        }
-        buffer[i] = static_cast<uint8_t>(byte);
+    uint8_t message[BUFFER_SIZE];
+    message[0] = reg;
+    memcpy(message + 1, data, length);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return false;
+    }
+    
+    flushPendingWrite();
+    return writeLocked(address, message, length + 1) == 0;
+}
+
+std::error_code WireClass::tryReadRegisters(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length) noexcept {
+    if (buffer == nullptr || length == 0 || length > UINT16_MAX) {
+        return GpioErrc::INVALID_ARGUMENT;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return GpioErrc::NOT_OPEN;
     }
     
-    return received;
+    flushPendingWrite();
+    errno = 0;
+    if (writeReadLocked(address, &reg, 1, buffer, length) != static_cast<int>(length)) {
+        return lastSystemError();
+    }
+    return {};
+}
+
+std::error_code WireClass::tryWriteRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) noexcept {
+    if (data == nullptr || length == 0 || length >= BUFFER_SIZE) {
+        return GpioErrc::INVALID_ARGUMENT;
+    }
+    
+    uint8_t message[BUFFER_SIZE];
+    message[0] = reg;
+    memcpy(message + 1, data, length);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return GpioErrc::NOT_OPEN;
+    }
+    
+    flushPendingWrite();
+    errno = 0;
+    if (writeLocked(address, message, length + 1) != 0) {
+        return lastSystemError();
+    }
+    return {};
 }
 
 std::vector<uint8_t> WireClass::scan() {
@@ -359,9 +489,223 @@ std::vector<uint8_t> WireClass::scan() {
 }
 
 bool WireClass::exists(uint8_t address) {
-    beginTransmission(address);
-    uint8_t error = this->endTransmission(true);
-    return (error == 0);
+    return probe(address, I2cProbeMode::AUTO);
+}
+
+bool WireClass::probe(uint8_t address, I2cProbeMode mode) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!device_) {
+        return false;
+    }
+    
+    flushPendingWrite();
+    
+    if (mode == I2cProbeMode::AUTO) {
+        // Quick write can corrupt some EEPROMs and lock some sensors (i2cdetect rules)
+        bool readRange = (address >= 0x30 && address <= 0x37) || (address >= 0x50 && address <= 0x5F);
+        mode = readRange ? I2cProbeMode::READ_BYTE : I2cProbeMode::QUICK_WRITE;
+    }
+    if (mode == I2cProbeMode::QUICK_WRITE && !(functionality_ & I2C_FUNC_SMBUS_QUICK)) {
+        mode = I2cProbeMode::READ_BYTE;
+    } else if (mode == I2cProbeMode::READ_BYTE && !(functionality_ & I2C_FUNC_SMBUS_READ_BYTE)) {
+        mode = I2cProbeMode::QUICK_WRITE;
+    }
+    
+    if (!setSlaveAddress(address)) {
+        return errno == EBUSY;  // Claimed by a kernel driver ("UU" in i2cdetect)
+    }
+    
+    if (mode == I2cProbeMode::QUICK_WRITE) {
+        return smbusLocked(address, I2C_SMBUS_WRITE, 0, I2C_SMBUS_QUICK, nullptr);
+    }
+    
+    i2c_smbus_data data;
+    return smbusLocked(address, I2C_SMBUS_READ, 0, I2C_SMBUS_BYTE, &data);
+}
+
+std::vector<int> WireClass::availableBuses() {
+    std::vector<int> buses;
+    
+    for (const std::string& path : listDeviceFiles()) {
+        int bus;
+        char trailing;
+        if (sscanf(path.c_str(), "/dev/i2c-%d%c", &bus, &trailing) == 1 && bus >= 0) {
+            buses.push_back(bus);
+        }
+    }
+    
+    std::sort(buses.begin(), buses.end());
+    return buses;
+}
+
+/* ------------------------------------------------------------ */
+/*                   BATCH TRANSFERS                            */
+/* ------------------------------------------------------------ */
+
+static_assert(WIRE_BATCH_MAX_MESSAGES == I2C_RDWR_IOCTL_MAX_MSGS,
+              "WIRE_BATCH_MAX_MESSAGES must match the kernel limit");
+
+int WireBatch::add(uint8_t address, const uint8_t* prefix, const uint8_t* data, size_t writeLength,
+                   uint8_t* readBuffer, size_t readLength) {
+    if (writeLength > UINT16_MAX || readLength > UINT16_MAX) {
+        return -1;
+    }
+    
+    Op op;
+    op.address = address;
+    op.writeOffset = writeData_.size();
+    op.writeLength = static_cast<uint16_t>(writeLength);
+    op.readBuffer = readBuffer;
+    op.readLength = static_cast<uint16_t>(readLength);
+    op.status = -1;
+    
+    if (prefix != nullptr) {
+        writeData_.push_back(*prefix);
+        writeLength--;
+    }
+    if (writeLength > 0) {
+        writeData_.insert(writeData_.end(), data, data + writeLength);
+    }
+    
+    ops_.push_back(op);
+    messages_ += (op.writeLength > 0 ? 1 : 0) + (op.readLength > 0 ? 1 : 0);
+    return static_cast<int>(ops_.size() - 1);
+}
+
+int WireBatch::readRegisters(uint8_t address, uint8_t reg, uint8_t* buffer, size_t length) {
+    if (buffer == nullptr || length == 0) {
+        return -1;
+    }
+    return add(address, &reg, nullptr, 1, buffer, length);
+}
+
+int WireBatch::readRegister(uint8_t address, uint8_t reg, uint8_t* value) {
+    return readRegisters(address, reg, value, 1);
+}
+
+int WireBatch::writeRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0) {
+        return -1;
+    }
+    return add(address, &reg, data, length + 1, nullptr, 0);
+}
+
+int WireBatch::writeRegister(uint8_t address, uint8_t reg, uint8_t value) {
+    return writeRegisters(address, reg, &value, 1);
+}
+
+int WireBatch::read(uint8_t address, uint8_t* buffer, size_t length) {
+    if (buffer == nullptr || length == 0) {
+        return -1;
+    }
+    return add(address, nullptr, nullptr, 0, buffer, length);
+}
+
+int WireBatch::write(uint8_t address, const uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0) {
+        return -1;
+    }
+    return add(address, nullptr, data, length, nullptr, 0);
+}
+
+void WireBatch::clear() {
+    ops_.clear();
+    writeData_.clear();
+    messages_ = 0;
+}
+
+void WireBatch::reserve(size_t operations, size_t writeBytes) {
+    ops_.reserve(operations);
+    writeData_.reserve(writeBytes);
+}
+
+int WireBatch::status(size_t index) const {
+    if (index >= ops_.size()) {
+        return -1;
+    }
+    return ops_[index].status;
+}
+
+size_t WireClass::transfer(WireBatch& batch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto& ops = batch.ops_;
+    
+    if (!device_) {
+        for (auto& op : ops) {
+            op.status = ENODEV;
+        }
+        return 0;
+    }
+    
+    flushPendingWrite();
+    size_t succeeded = 0;
+    
+    if (!combinedSupported_) {
+        for (auto& op : ops) {
+            const uint8_t* writeData = batch.writeData_.data() + op.writeOffset;
+            bool success;
+            errno = 0;
+            if (op.readLength > 0) {
+                success = writeReadLocked(op.address, writeData, op.writeLength,
+                                          op.readBuffer, op.readLength) == op.readLength;
+            } else {
+                success = writeLocked(op.address, writeData, op.writeLength) == 0;
+            }
+            op.status = success ? 0 : (errno != 0 ? errno : EIO);
+            if (success) {
+                succeeded++;
+            }
+        }
+        return succeeded;
+    }
+    
+    i2c_msg msgs[WIRE_BATCH_MAX_MESSAGES];
+    size_t first = 0;
+    
+    while (first < ops.size()) {
+        // Pack whole operations (a register read never straddles two ioctls)
+        size_t count = 0;
+        size_t last = first;
+        while (last < ops.size()) {
+            auto& op = ops[last];
+            size_t needed = (op.writeLength > 0 ? 1 : 0) + (op.readLength > 0 ? 1 : 0);
+            if (count + needed > WIRE_BATCH_MAX_MESSAGES) {
+                break;
+            }
+            if (op.writeLength > 0) {
+                msgs[count].addr = op.address;
+                msgs[count].flags = 0;
+                msgs[count].len = op.writeLength;
+                msgs[count].buf = batch.writeData_.data() + op.writeOffset;
+                count++;
+            }
+            if (op.readLength > 0) {
+                msgs[count].addr = op.address;
+                msgs[count].flags = I2C_M_RD;
+                msgs[count].len = op.readLength;
+                msgs[count].buf = op.readBuffer;
+                count++;
+            }
+            last++;
+        }
+        
+        i2c_rdwr_ioctl_data data;
+        data.msgs = msgs;
+        data.nmsgs = static_cast<uint32_t>(count);
+        
+        int status = (i2cReadWrite(*device_, data) < 0) ? errno : 0;
+        for (size_t i = first; i < last; i++) {
+            ops[i].status = status;
+        }
+        if (status == 0) {
+            succeeded += last - first;
+        }
+        first = last;
+    }
+    
+    return succeeded;
 }
 
 /* ------------------------------------------------------------ */
@@ -379,8 +723,7 @@ int WireClass::detectBusNumber() {
         char filename[20];
         snprintf(filename, sizeof(filename), "/dev/i2c-%d", bus);
         
-        struct stat st;
-        if (stat(filename, &st) == 0) {
+        if (deviceFileExists(filename)) {
             return bus;
         }
     }
@@ -388,16 +731,146 @@ int WireClass::detectBusNumber() {
     return -1;  // No I2C device found
 }
 
+bool WireClass::openBus(int busNumber) {
+    device_.reset();
+    
+    busNumber_ = busNumber;
+    pendingWrite_ = false;
+    slaveAddress_ = -1;
+    
+    // Open I2C device
+    char filename[20];
+    snprintf(filename, sizeof(filename), "/dev/i2c-%d", busNumber_);
+    
+    device_ = openDeviceFile(filename);
+    if (!device_) {
+        busNumber_ = -1;
+        combinedSupported_ = false;
+        return false;
+    }
+    
+    // SMBus-only adapters cannot do combined transactions
+    if (device_->ioctl(I2C_FUNCS, &functionality_) < 0) {
+        functionality_ = 0;
+    }
+    combinedSupported_ = (functionality_ & I2C_FUNC_I2C) != 0;
+    
+    return true;
+}
+
+uint8_t WireClass::writeLocked(uint8_t address, const uint8_t* data, size_t length) {
+    if (combinedSupported_) {
+        i2c_msg msg;
+        msg.addr = address;
+        msg.flags = 0;
+        msg.len = static_cast<uint16_t>(length);
+        msg.buf = const_cast<uint8_t*>(data);
+        
+        i2c_rdwr_ioctl_data transfer;
+        transfer.msgs = &msg;
+        transfer.nmsgs = 1;
+        
+        if (i2cReadWrite(*device_, transfer) < 0) {
+            return (errno == ENXIO) ? 2 : 3;  // NACK on address / data
+        }
+        return 0;
+    }
+    
+    if (!setSlaveAddress(address)) {
+        return 2;  // NACK on address
+    }
+    
+    ssize_t written = device_->write(data, length);
+    if (written < 0 || static_cast<size_t>(written) != length) {
+        return 3;  // NACK on data or incomplete write
+    }
+    return 0;
+}
+
+int WireClass::writeReadLocked(uint8_t address, const uint8_t* writeData, size_t writeLength,
+                               uint8_t* readData, size_t readLength) {
+    if (combinedSupported_) {
+        i2c_msg msgs[2];
+        size_t count = 0;
+        
+        if (writeLength > 0) {
+            msgs[count].addr = address;
+            msgs[count].flags = 0;
+            msgs[count].len = static_cast<uint16_t>(writeLength);
+            msgs[count].buf = const_cast<uint8_t*>(writeData);
+            ++count;
+        }
+        msgs[count].addr = address;
+        msgs[count].flags = I2C_M_RD;
+        msgs[count].len = static_cast<uint16_t>(readLength);
+        msgs[count].buf = readData;
+        ++count;
+        
+        i2c_rdwr_ioctl_data transfer;
+        transfer.msgs = msgs;
+        transfer.nmsgs = static_cast<uint32_t>(count);
+        
+        if (i2cReadWrite(*device_, transfer) < 0) {
+            return -1;
+        }
+        return static_cast<int>(readLength);
+    }
+    
+    // Fallback: STOP between write and read
+    if (!setSlaveAddress(address)) {
+        return -1;
+    }
+    if (writeLength > 0) {
+        ssize_t written = device_->write(writeData, writeLength);
+        if (written < 0 || static_cast<size_t>(written) != writeLength) {
+            return -1;
+        }
+    }
+    ssize_t bytesRead = device_->read(readData, readLength);
+    return bytesRead < 0 ? -1 : static_cast<int>(bytesRead);
+}
+
+void WireClass::flushPendingWrite() {
+    if (!pendingWrite_) {
+        return;
+    }
+    pendingWrite_ = false;
+    if (device_ && !txBuffer_.empty()) {
+        writeLocked(txAddress_, txBuffer_.data(), txBuffer_.size());
+    }
+    txBuffer_.clear();
+}
+
 bool WireClass::setSlaveAddress(uint8_t address) {
-    if (fd_ < 0) {
+    if (!device_) {
         return false;
     }
     
-    if (ioctl(fd_, I2C_SLAVE, address) < 0) {
+    if (slaveAddress_ == address) {
+        return true;
+    }
+    
+    if (device_->ioctlValue(I2C_SLAVE, address) < 0) {
+        slaveAddress_ = -1;
         return false;
     }
     
+    slaveAddress_ = address;
     return true;
 }
 
+bool WireClass::smbusLocked(uint8_t address, uint8_t readWrite, uint8_t command, uint32_t size, void* data) {
+    if (!setSlaveAddress(address)) {
+        return false;
+    }
+    
+    i2c_smbus_ioctl_data args;
+    args.read_write = readWrite;
+    args.command = command;
+    args.size = size;
+    args.data = static_cast<i2c_smbus_data*>(data);
+    
+    return device_->ioctl(I2C_SMBUS, &args) == 0;
+}
+
 } // namespace pipinpp
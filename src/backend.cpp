@@ -0,0 +1,113 @@
+/**
+ * @file backend.cpp
+ * @brief POSIX device files and the device provider hook
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "backend.hpp"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <mutex>
+
+namespace pipinpp {
+
+namespace {
+
+/**
+ * @brief A real file descriptor
+ */
+class PosixDeviceFile : public DeviceFile {
+public:
+    explicit PosixDeviceFile(int fd) : fd_(fd) {}
+    ~PosixDeviceFile() override { close(fd_); }
+
+    PosixDeviceFile(const PosixDeviceFile&) = delete;
+    PosixDeviceFile& operator=(const PosixDeviceFile&) = delete;
+
+    int ioctl(unsigned long request, void* arg) override { return ::ioctl(fd_, request, arg); }
+    int ioctlValue(unsigned long request, unsigned long value) override { return ::ioctl(fd_, request, value); }
+    ssize_t read(void* buffer, size_t length) override { return ::read(fd_, buffer, length); }
+    ssize_t write(const void* buffer, size_t length) override { return ::write(fd_, buffer, length); }
+
+private:
+    int fd_;
+};
+
+std::mutex providerMutex;
+std::shared_ptr<DeviceProvider> provider;
+
+std::shared_ptr<DeviceProvider> currentProvider() {
+    std::lock_guard<std::mutex> lock(providerMutex);
+    return provider;
+}
+
+} // namespace
+
+void setDeviceProvider(std::shared_ptr<DeviceProvider> newProvider) {
+    std::lock_guard<std::mutex> lock(providerMutex);
+    provider = std::move(newProvider);
+}
+
+std::unique_ptr<DeviceFile> openDeviceFile(const std::string& path) {
+    if (auto installed = currentProvider()) {
+        return installed->open(path);
+    }
+    int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    return std::make_unique<PosixDeviceFile>(fd);
+}
+
+bool deviceFileExists(const std::string& path) {
+    if (auto installed = currentProvider()) {
+        std::vector<std::string> paths = installed->list();
+        return std::find(paths.begin(), paths.end(), path) != paths.end();
+    }
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+std::vector<std::string> listDeviceFiles() {
+    if (auto installed = currentProvider()) {
+        return installed->list();
+    }
+    std::vector<std::string> paths;
+    DIR* dir = opendir("/dev");
+    if (dir == nullptr) {
+        return paths;
+    }
+    while (dirent* entry = readdir(dir)) {
+        paths.push_back(std::string("/dev/") + entry->d_name);
+    }
+    closedir(dir);
+    return paths;
+}
+
+} // namespace pipinpp
@@ -0,0 +1,1031 @@
+/**
+ * @file board_config.cpp
+ * @brief JSON board configs and one-pass Board setup
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "board_config.hpp"
+#include "board.hpp"
+#include "bus_registry.hpp"
+#include "chip_registry.hpp"
+#include "exceptions.hpp"
+#include "gpiomem.hpp"
+#include "log.hpp"
+#include "transaction.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <future>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace pipinpp {
+
+namespace {
+
+uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+constexpr int MAX_JSON_DEPTH = 32;
+
+struct JsonValue {
+    enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type = Type::NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;   // In file order
+    size_t line = 1;
+    size_t column = 1;
+};
+
+[[noreturn]] void configError(size_t line, size_t column, const std::string& message) {
+    throw std::invalid_argument("Board config line " + std::to_string(line) + ", column " +
+                                std::to_string(column) + ": " + message);
+}
+
+[[noreturn]] void configError(const JsonValue& at, const std::string& message) {
+    configError(at.line, at.column, message);
+}
+
+/**
+ * @brief Recursive-descent JSON parser (RFC 8259, plus // line comments)
+ */
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+
+    JsonValue parse() {
+        JsonValue root = value(0);
+        skipSpace();
+        if (pos_ < text_.size()) {
+            error("unexpected characters after the end of the config");
+        }
+        return root;
+    }
+
+private:
+    [[noreturn]] void error(const std::string& message) const {
+        configError(line_, column(), message);
+    }
+
+    // Newlines only appear between tokens, so skipSpace() keeps the line current
+    size_t column() const { return pos_ - lineStart_ + 1; }
+
+    void skipSpace() {
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if (c == '\n') {
+                ++pos_;
+                ++line_;
+                lineStart_ = pos_;
+            } else if (c == ' ' || c == '\t' || c == '\r') {
+                ++pos_;
+            } else if (c == '/' && pos_ + 1 < text_.size() && text_[pos_ + 1] == '/') {
+                pos_ = text_.find('\n', pos_);
+                if (pos_ == std::string::npos) {
+                    pos_ = text_.size();
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    void expect(char c) {
+        skipSpace();
+        if (pos_ >= text_.size() || text_[pos_] != c) {
+            error(std::string("expected '") + c + "'");
+        }
+        ++pos_;
+    }
+
+    JsonValue value(int depth) {
+        if (depth > MAX_JSON_DEPTH) {
+            error("nested too deeply");
+        }
+        skipSpace();
+        if (pos_ >= text_.size()) {
+            error("unexpected end of input");
+        }
+
+        // Position for schema errors about this value
+        JsonValue result;
+        result.line = line_;
+        result.column = column();
+
+        char c = text_[pos_];
+        if (c == '{') {
+            ++pos_;
+            result.type = JsonValue::Type::OBJECT;
+            skipSpace();
+            if (pos_ < text_.size() && text_[pos_] == '}') {
+                ++pos_;
+                return result;
+            }
+            while (true) {
+                skipSpace();
+                if (pos_ >= text_.size() || text_[pos_] != '"') {
+                    error("expected a member name");
+                }
+                std::string key = string();
+                for (const auto& member : result.members) {
+                    if (member.first == key) {
+                        error("duplicate member \"" + key + "\"");
+                    }
+                }
+                expect(':');
+                result.members.emplace_back(std::move(key), value(depth + 1));
+                skipSpace();
+                if (pos_ < text_.size() && text_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                expect('}');
+                return result;
+            }
+        }
+        if (c == '[') {
+            ++pos_;
+            result.type = JsonValue::Type::ARRAY;
+            skipSpace();
+            if (pos_ < text_.size() && text_[pos_] == ']') {
+                ++pos_;
+                return result;
+            }
+            while (true) {
+                result.items.push_back(value(depth + 1));
+                skipSpace();
+                if (pos_ < text_.size() && text_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                expect(']');
+                return result;
+            }
+        }
+        if (c == '"') {
+            result.type = JsonValue::Type::STRING;
+            result.string = string();
+            return result;
+        }
+        if (literal("true")) {
+            result.type = JsonValue::Type::BOOLEAN;
+            result.boolean = true;
+            return result;
+        }
+        if (literal("false")) {
+            result.type = JsonValue::Type::BOOLEAN;
+            return result;
+        }
+        if (literal("null")) {
+            return result;
+        }
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            result.type = JsonValue::Type::NUMBER;
+            result.number = number();
+            return result;
+        }
+        error(std::string("unexpected character '") + c + "'");
+    }
+
+    bool literal(const char* word) {
+        size_t length = std::strlen(word);
+        if (text_.compare(pos_, length, word) == 0) {
+            pos_ += length;
+            return true;
+        }
+        return false;
+    }
+
+    double number() {
+        size_t start = pos_;
+        while (pos_ < text_.size() && std::strchr("+-0123456789.eE", text_[pos_]) && text_[pos_] != '\0') {
+            ++pos_;
+        }
+        // from_chars, unlike strtod, ignores LC_NUMERIC (a "," decimal point)
+        double parsed = 0.0;
+        auto result = std::from_chars(text_.data() + start, text_.data() + pos_, parsed);
+        if (pos_ == start || result.ec != std::errc() || result.ptr != text_.data() + pos_ ||
+            !std::isfinite(parsed)) {
+            pos_ = start;
+            error("invalid number");
+        }
+        return parsed;
+    }
+
+    std::string string() {
+        ++pos_;     // Opening quote
+        std::string result;
+        while (true) {
+            if (pos_ >= text_.size()) {
+                error("unterminated string");
+            }
+            char c = text_[pos_++];
+            if (c == '"') {
+                return result;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                error("control character in string");
+            }
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                error("unterminated string");
+            }
+            char escape = text_[pos_++];
+            switch (escape) {
+                case '"': result += '"'; break;
+                case '\\': result += '\\'; break;
+                case '/': result += '/'; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'n': result += '\n'; break;
+                case 'r': result += '\r'; break;
+                case 't': result += '\t'; break;
+                case 'u': {
+                    if (pos_ + 4 > text_.size()) {
+                        error("invalid \\u escape");
+                    }
+                    char* end = nullptr;
+                    std::string hex = text_.substr(pos_, 4);
+                    unsigned long code = std::strtoul(hex.c_str(), &end, 16);
+                    if (*end != '\0') {
+                        error("invalid \\u escape");
+                    }
+                    pos_ += 4;
+                    // UTF-8 (names and chip labels are ASCII in practice)
+                    if (code < 0x80) {
+                        result += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        result += static_cast<char>(0xC0 | (code >> 6));
+                        result += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        result += static_cast<char>(0xE0 | (code >> 12));
+                        result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        result += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default:
+                    --pos_;
+                    error("invalid escape");
+            }
+        }
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+    size_t line_ = 1;
+    size_t lineStart_ = 0;      ///< Offset of the first character of line_
+};
+
+// ============================================================================
+// Schema
+// ============================================================================
+
+const JsonValue& requireObject(const JsonValue& value, const std::string& what) {
+    if (value.type != JsonValue::Type::OBJECT) {
+        configError(value, what + " must be an object");
+    }
+    return value;
+}
+
+int toInt(const JsonValue& value, const std::string& what) {
+    if (value.type != JsonValue::Type::NUMBER || value.number != std::floor(value.number) ||
+        std::fabs(value.number) > 1e9) {
+        configError(value, what + " must be an integer");
+    }
+    return static_cast<int>(value.number);
+}
+
+double toDouble(const JsonValue& value, const std::string& what) {
+    if (value.type != JsonValue::Type::NUMBER) {
+        configError(value, what + " must be a number");
+    }
+    return value.number;
+}
+
+std::string toString(const JsonValue& value, const std::string& what) {
+    if (value.type != JsonValue::Type::STRING) {
+        configError(value, what + " must be a string");
+    }
+    return value.string;
+}
+
+bool toBool(const JsonValue& value, const std::string& what) {
+    if (value.type == JsonValue::Type::BOOLEAN) {
+        return value.boolean;
+    }
+    if (value.type == JsonValue::Type::NUMBER && (value.number == 0.0 || value.number == 1.0)) {
+        return value.number != 0.0;
+    }
+    configError(value, what + " must be true, false, 0 or 1");
+}
+
+/**
+ * @brief Visit the members of an entry object, rejecting names not in @p allowed
+ */
+template <typename Visitor>
+void forEachField(const JsonValue& entry, const std::string& what, std::initializer_list<const char*> allowed,
+                  Visitor visit) {
+    for (const auto& member : entry.members) {
+        bool known = std::any_of(allowed.begin(), allowed.end(),
+                                 [&member](const char* name) { return member.first == name; });
+        if (!known) {
+            configError(member.second, "unknown field \"" + member.first + "\" in " + what);
+        }
+        visit(member.first, member.second);
+    }
+}
+
+PinMode parseMode(const JsonValue& value, const std::string& what) {
+    std::string mode = toString(value, what);
+    if (mode == "input") {
+        return PinMode::INPUT;
+    }
+    if (mode == "pullup") {
+        return PinMode::INPUT_PULLUP;
+    }
+    if (mode == "pulldown") {
+        return PinMode::INPUT_PULLDOWN;
+    }
+    configError(value, what + " must be \"input\", \"pullup\" or \"pulldown\"");
+}
+
+InterruptMode parseEdge(const JsonValue& value, const std::string& what) {
+    std::string edge = toString(value, what);
+    if (edge == "rising") {
+        return InterruptMode::RISING;
+    }
+    if (edge == "falling") {
+        return InterruptMode::FALLING;
+    }
+    if (edge == "change" || edge == "both") {
+        return InterruptMode::CHANGE;
+    }
+    configError(value, what + " must be \"rising\", \"falling\" or \"change\"");
+}
+
+void parseOutputs(const JsonValue& section, BoardConfig& config) {
+    for (const auto& member : requireObject(section, "\"outputs\"").members) {
+        const std::string what = "output \"" + member.first + "\"";
+        BoardLineSpec spec;
+        spec.name = member.first;
+        spec.mode = PinMode::OUTPUT;
+        if (member.second.type == JsonValue::Type::NUMBER) {
+            spec.pin = toInt(member.second, what);
+        } else {
+            forEachField(requireObject(member.second, what), what, {"pin", "initial", "chip"},
+                         [&](const std::string& field, const JsonValue& value) {
+                             if (field == "pin") {
+                                 spec.pin = toInt(value, what + " pin");
+                             } else if (field == "initial") {
+                                 spec.initial = toBool(value, what + " initial");
+                             } else {
+                                 spec.chip = toString(value, what + " chip");
+                             }
+                         });
+        }
+        if (spec.pin < 0) {
+            configError(member.second, what + " needs a pin");
+        }
+        config.lines.push_back(spec);
+    }
+}
+
+void parseInputs(const JsonValue& section, BoardConfig& config) {
+    for (const auto& member : requireObject(section, "\"inputs\"").members) {
+        const std::string what = "input \"" + member.first + "\"";
+        BoardLineSpec spec;
+        spec.name = member.first;
+        if (member.second.type == JsonValue::Type::NUMBER) {
+            spec.pin = toInt(member.second, what);
+        } else {
+            forEachField(requireObject(member.second, what), what, {"pin", "mode", "chip"},
+                         [&](const std::string& field, const JsonValue& value) {
+                             if (field == "pin") {
+                                 spec.pin = toInt(value, what + " pin");
+                             } else if (field == "mode") {
+                                 spec.mode = parseMode(value, what + " mode");
+                             } else {
+                                 spec.chip = toString(value, what + " chip");
+                             }
+                         });
+        }
+        if (spec.pin < 0) {
+            configError(member.second, what + " needs a pin");
+        }
+        config.lines.push_back(spec);
+    }
+}
+
+void parseInterrupts(const JsonValue& section, BoardConfig& config) {
+    for (const auto& member : requireObject(section, "\"interrupts\"").members) {
+        const std::string what = "interrupt \"" + member.first + "\"";
+        BoardInterruptSpec spec;
+        spec.name = member.first;
+        if (member.second.type == JsonValue::Type::NUMBER) {
+            spec.pin = toInt(member.second, what);
+        } else {
+            forEachField(requireObject(member.second, what), what, {"pin", "edge", "debounceUs", "chip"},
+                         [&](const std::string& field, const JsonValue& value) {
+                             if (field == "pin") {
+                                 spec.pin = toInt(value, what + " pin");
+                             } else if (field == "edge") {
+                                 spec.mode = parseEdge(value, what + " edge");
+                             } else if (field == "debounceUs") {
+                                 int debounce = toInt(value, what + " debounceUs");
+                                 if (debounce < 0) {
+                                     configError(value, what + " debounceUs must not be negative");
+                                 }
+                                 spec.debounceUs = static_cast<uint32_t>(debounce);
+                             } else {
+                                 spec.chip = toString(value, what + " chip");
+                             }
+                         });
+        }
+        if (spec.pin < 0) {
+            configError(member.second, what + " needs a pin");
+        }
+        config.interrupts.push_back(spec);
+    }
+}
+
+void parsePwm(const JsonValue& section, BoardConfig& config) {
+    for (const auto& member : requireObject(section, "\"pwm\"").members) {
+        const std::string what = "PWM \"" + member.first + "\"";
+        BoardPwmSpec spec;
+        spec.name = member.first;
+        bool hasChannel = false;
+        forEachField(requireObject(member.second, what), what, {"pin", "chip", "channel", "frequency", "duty"},
+                     [&](const std::string& field, const JsonValue& value) {
+                         if (field == "pin") {
+                             spec.pin = toInt(value, what + " pin");
+                             if (!HardwarePWM::gpioToPWM(spec.pin, spec.chip, spec.channel)) {
+                                 configError(value, what + ": GPIO " + std::to_string(spec.pin) +
+                                                    " has no hardware PWM channel");
+                             }
+                         } else if (field == "chip") {
+                             spec.chip = toInt(value, what + " chip");
+                             hasChannel = true;
+                         } else if (field == "channel") {
+                             spec.channel = toInt(value, what + " channel");
+                             hasChannel = true;
+                         } else if (field == "frequency") {
+                             int frequency = toInt(value, what + " frequency");
+                             if (frequency <= 0) {
+                                 configError(value, what + " frequency must be positive");
+                             }
+                             spec.frequencyHz = static_cast<uint32_t>(frequency);
+                         } else {
+                             spec.dutyCycle = toDouble(value, what + " duty");
+                         }
+                     });
+        if (spec.pin >= 0 && hasChannel) {
+            configError(member.second, what + " takes either a pin or a chip and channel");
+        }
+        config.pwms.push_back(spec);
+    }
+}
+
+void parseI2c(const JsonValue& section, BoardConfig& config) {
+    for (const auto& member : requireObject(section, "\"i2c\"").members) {
+        const std::string what = "I2C bus \"" + member.first + "\"";
+        BoardI2cSpec spec;
+        spec.name = member.first;
+        if (member.second.type == JsonValue::Type::NUMBER) {
+            spec.bus = toInt(member.second, what);
+        } else {
+            forEachField(requireObject(member.second, what), what, {"bus"},
+                         [&](const std::string&, const JsonValue& value) { spec.bus = toInt(value, what + " bus"); });
+        }
+        config.i2cBuses.push_back(spec);
+    }
+}
+
+void parseSpi(const JsonValue& section, BoardConfig& config) {
+    for (const auto& member : requireObject(section, "\"spi\"").members) {
+        const std::string what = "SPI device \"" + member.first + "\"";
+        BoardSpiSpec spec;
+        spec.name = member.first;
+        if (member.second.type == JsonValue::Type::NUMBER) {
+            spec.bus = toInt(member.second, what);
+        } else {
+            forEachField(requireObject(member.second, what), what, {"bus", "cs"},
+                         [&](const std::string& field, const JsonValue& value) {
+                             if (field == "bus") {
+                                 spec.bus = toInt(value, what + " bus");
+                             } else {
+                                 spec.cs = toInt(value, what + " cs");
+                             }
+                         });
+        }
+        config.spiDevices.push_back(spec);
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// BoardConfig
+// ============================================================================
+
+BoardConfig BoardConfig::fromJson(const std::string& json) {
+    JsonValue root = JsonParser(json).parse();
+    requireObject(root, "The config");
+
+    BoardConfig config;
+    for (const auto& member : root.members) {
+        const std::string& key = member.first;
+        if (key == "chip") {
+            config.chipname = toString(member.second, "\"chip\"");
+        } else if (key == "outputs") {
+            parseOutputs(member.second, config);
+        } else if (key == "inputs") {
+            parseInputs(member.second, config);
+        } else if (key == "interrupts") {
+            parseInterrupts(member.second, config);
+        } else if (key == "pwm") {
+            parsePwm(member.second, config);
+        } else if (key == "i2c") {
+            parseI2c(member.second, config);
+        } else if (key == "spi") {
+            parseSpi(member.second, config);
+        } else {
+            configError(member.second, "unknown section \"" + key + "\"");
+        }
+    }
+    return config;
+}
+
+BoardConfig BoardConfig::fromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Cannot read board config " + path);
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return fromJson(text.str());
+}
+
+BoardConfig& BoardConfig::chip(const std::string& name) {
+    chipname = name;
+    return *this;
+}
+
+BoardConfig& BoardConfig::output(const std::string& name, int pin, bool initial) {
+    BoardLineSpec spec;
+    spec.name = name;
+    spec.pin = pin;
+    spec.mode = PinMode::OUTPUT;
+    spec.initial = initial;
+    lines.push_back(spec);
+    return *this;
+}
+
+BoardConfig& BoardConfig::input(const std::string& name, int pin, PinMode mode) {
+    if (mode == PinMode::OUTPUT) {
+        throw std::invalid_argument("Board input \"" + name + "\" cannot have mode OUTPUT");
+    }
+    BoardLineSpec spec;
+    spec.name = name;
+    spec.pin = pin;
+    spec.mode = mode;
+    lines.push_back(spec);
+    return *this;
+}
+
+BoardConfig& BoardConfig::interrupt(const std::string& name, int pin, InterruptMode mode, uint32_t debounceUs) {
+    BoardInterruptSpec spec;
+    spec.name = name;
+    spec.pin = pin;
+    spec.mode = mode;
+    spec.debounceUs = debounceUs;
+    interrupts.push_back(spec);
+    return *this;
+}
+
+BoardConfig& BoardConfig::pwm(const std::string& name, int pin, uint32_t frequencyHz, double dutyCycle) {
+    BoardPwmSpec spec;
+    spec.name = name;
+    spec.pin = pin;
+    if (!HardwarePWM::gpioToPWM(pin, spec.chip, spec.channel)) {
+        throw InvalidPinError(pin, "no hardware PWM channel");
+    }
+    spec.frequencyHz = frequencyHz;
+    spec.dutyCycle = dutyCycle;
+    pwms.push_back(spec);
+    return *this;
+}
+
+BoardConfig& BoardConfig::pwmChannel(const std::string& name, int chip, int channel, uint32_t frequencyHz,
+                                     double dutyCycle) {
+    BoardPwmSpec spec;
+    spec.name = name;
+    spec.chip = chip;
+    spec.channel = channel;
+    spec.frequencyHz = frequencyHz;
+    spec.dutyCycle = dutyCycle;
+    pwms.push_back(spec);
+    return *this;
+}
+
+BoardConfig& BoardConfig::i2c(const std::string& name, int bus) {
+    i2cBuses.push_back(BoardI2cSpec{name, bus});
+    return *this;
+}
+
+BoardConfig& BoardConfig::spi(const std::string& name, int bus, int cs) {
+    spiDevices.push_back(BoardSpiSpec{name, bus, cs});
+    return *this;
+}
+
+void BoardConfig::validate() const {
+    std::set<std::string> names;
+    auto addName = [&names](const std::string& name) {
+        if (name.empty()) {
+            throw std::invalid_argument("Board config entries need a name");
+        }
+        if (!names.insert(name).second) {
+            throw std::invalid_argument("Board config name \"" + name + "\" is used twice");
+        }
+    };
+
+    // GPIO users per (chip, pin)
+    std::map<std::pair<std::string, int>, std::string> pins;
+    auto addPin = [this, &pins](const std::string& name, const std::string& chip, int pin) {
+        if (!isValidGpioPin(pin)) {
+            throw InvalidPinError(pin, "not a GPIO of this board (\"" + name + "\")");
+        }
+        auto key = std::make_pair(chip.empty() ? chipname : chip, pin);
+        auto it = pins.find(key);
+        if (it != pins.end()) {
+            throw InvalidPinError(pin, "used by both \"" + it->second + "\" and \"" + name + "\"");
+        }
+        pins.emplace(key, name);
+    };
+
+    for (const BoardLineSpec& spec : lines) {
+        addName(spec.name);
+        addPin(spec.name, spec.chip, spec.pin);
+    }
+    for (const BoardInterruptSpec& spec : interrupts) {
+        addName(spec.name);
+        addPin(spec.name, spec.chip, spec.pin);
+    }
+
+    std::set<std::pair<int, int>> channels;
+    for (const BoardPwmSpec& spec : pwms) {
+        addName(spec.name);
+        if (spec.pin >= 0) {
+            addPin(spec.name, std::string(), spec.pin);
+        }
+        if (spec.chip < 0 || spec.channel < 0) {
+            throw std::invalid_argument("Board PWM \"" + spec.name + "\" has an invalid chip or channel");
+        }
+        if (!channels.insert({spec.chip, spec.channel}).second) {
+            throw std::invalid_argument("Board PWM \"" + spec.name + "\" reuses pwmchip" +
+                                        std::to_string(spec.chip) + "/pwm" + std::to_string(spec.channel));
+        }
+        if (spec.frequencyHz == 0 || spec.dutyCycle < 0.0 || spec.dutyCycle > 100.0) {
+            throw std::invalid_argument("Board PWM \"" + spec.name + "\" needs a frequency and a 0-100% duty cycle");
+        }
+    }
+    for (const BoardI2cSpec& spec : i2cBuses) {
+        addName(spec.name);
+        if (spec.bus < 0) {
+            throw std::invalid_argument("Board I2C bus \"" + spec.name + "\" has an invalid bus number");
+        }
+    }
+    for (const BoardSpiSpec& spec : spiDevices) {
+        addName(spec.name);
+        if (spec.bus < 0 || spec.cs < 0) {
+            throw std::invalid_argument("Board SPI device \"" + spec.name + "\" has an invalid bus or CS");
+        }
+    }
+}
+
+// ============================================================================
+// BoardLine
+// ============================================================================
+
+bool BoardLine::write(bool value) {
+    if (!output_) {
+        return false;
+    }
+    if (Transaction* txn = Transaction::current()) {
+        txn->recordLine(chip_, request_, fastPath_, mask_, offset_, value);
+        return true;
+    }
+    if (fastPath_) {
+        if (value) {
+            fastPath_->set(mask_);
+        } else {
+            fastPath_->clear(mask_);
+        }
+    } else if (request_->setValue(offset_, value) != 0) {
+        return false;
+    }
+    chip_->outputShadow().record(offset_, value);
+    return true;
+}
+
+int BoardLine::read() {
+    if (fastPath_) {
+        return (fastPath_->levels() & mask_) ? 1 : 0;
+    }
+    return request_->getValue(offset_);
+}
+
+bool BoardLine::toggle() {
+    const Transaction* txn = Transaction::current();
+    int level = txn ? txn->pendingLevel(chip_, offset_) : -1;
+    if (level < 0) {
+        level = chip_->outputShadow().level(offset_);
+    }
+    if (!output_ || level < 0) {
+        return false;
+    }
+    return write(level == 0);
+}
+
+// ============================================================================
+// Board
+// ============================================================================
+
+Board::Board(const BoardConfig& config) : config_(config) {
+    const uint64_t start = monotonicNs();
+    config_.validate();
+    report_.validateNs = monotonicNs() - start;
+
+    // Each PWM export waits for sysfs, so all channels start at once, alongside everything else
+    const uint64_t pwmStart = monotonicNs();
+    std::vector<std::future<bool>> pwmStarts;
+    for (const BoardPwmSpec& spec : config_.pwms) {
+        auto channel = std::make_unique<HardwarePWM>(spec.chip, spec.channel);
+        HardwarePWM* raw = channel.get();
+        pwms_.emplace(spec.name, std::move(channel));
+        pwmStarts.push_back(std::async(std::launch::async, [raw, spec] {
+            return raw->begin(spec.frequencyHz, spec.dutyCycle);
+        }));
+    }
+
+    // Buses open on a second thread while this one requests the lines
+    std::future<void> buses = std::async(std::launch::async, [this] {
+        const uint64_t busStart = monotonicNs();
+        std::set<std::pair<int, int>> opened;
+        for (const BoardI2cSpec& spec : config_.i2cBuses) {
+            i2c_[spec.name] = &I2CBus(spec.bus);
+            opened.insert({-1, spec.bus});
+        }
+        for (const BoardSpiSpec& spec : config_.spiDevices) {
+            spi_[spec.name] = &SPIBus(spec.bus, spec.cs);
+            opened.insert({spec.bus, spec.cs});
+        }
+        report_.buses = opened.size();
+        report_.busesNs = monotonicNs() - busStart;
+    });
+
+    try {
+        setUp(buses, pwmStarts);
+    } catch (...) {
+        // The futures finish before the members go; the shadow claims must not outlive the lines
+        releaseLines();
+        throw;
+    }
+    report_.pwmChannels = pwms_.size();
+    report_.pwmNs = pwms_.empty() ? 0 : monotonicNs() - pwmStart;
+
+    report_.totalNs = monotonicNs() - start;
+    PIPINPP_LOG_INFO("Board ready in " << report_.totalNs / 1000 << " us: " << report_.lines << " lines in "
+                     << report_.lineRequests << " requests, " << report_.buses << " buses, "
+                     << report_.pwmChannels << " PWM channels");
+}
+
+void Board::setUp(std::future<void>& buses, std::vector<std::future<bool>>& pwmStarts) {
+    // One request per chip for every output and input on it
+    const uint64_t linesStart = monotonicNs();
+    std::map<std::string, std::vector<const BoardLineSpec*>> byChip;
+    for (const BoardLineSpec& spec : config_.lines) {
+        byChip[spec.chip.empty() ? config_.chipname : spec.chip].push_back(&spec);
+    }
+    for (const auto& group : byChip) {
+        std::shared_ptr<GpioChip> chip = ChipRegistry::getInstance().acquire(group.first);
+
+        std::vector<LineSettings> settings;
+        for (const BoardLineSpec* spec : group.second) {
+            LineSettings line;
+            line.offset = static_cast<unsigned int>(spec->pin);
+            if (spec->mode == PinMode::OUTPUT) {
+                line.direction = GPIOD_LINE_DIRECTION_OUTPUT;
+                line.outputValue = spec->initial ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE;
+            } else if (spec->mode == PinMode::INPUT_PULLUP) {
+                line.bias = GPIOD_LINE_BIAS_PULL_UP;
+            } else if (spec->mode == PinMode::INPUT_PULLDOWN) {
+                line.bias = GPIOD_LINE_BIAS_PULL_DOWN;
+            }
+            settings.push_back(line);
+        }
+        std::unique_ptr<LineRequest> request = chip->requestLines("PiPinPP-Board", settings);
+        if (!request) {
+            throw GpioAccessError(group.first, "cannot request " + std::to_string(settings.size()) +
+                                               " board lines: " + strerror(errno));
+        }
+
+        GpioMem* registers = GpioMem::forChipLabel(chip->label());
+        for (const BoardLineSpec* spec : group.second) {
+            BoardLine line;
+            line.request_ = request.get();
+            line.chip_ = chip.get();
+            line.offset_ = static_cast<unsigned int>(spec->pin);
+            line.output_ = spec->mode == PinMode::OUTPUT;
+            if (registers && spec->pin < 32) {
+                line.fastPath_ = registers;
+                line.mask_ = 1u << spec->pin;
+            }
+            if (line.output_) {
+                chip->outputShadow().claim(line.offset_, spec->initial);
+            }
+            lines_.emplace(spec->name, line);
+            PIPINPP_LOG_DEBUG("Board line \"" << spec->name << "\": GPIO " << spec->pin << " "
+                              << (line.output_ ? "output" : "input") << " on " << group.first);
+        }
+        requests_.push_back(std::move(request));
+        chips_.push_back(std::move(chip));
+    }
+    report_.lineRequests = requests_.size();
+    report_.lines = lines_.size();
+    report_.linesNs = monotonicNs() - linesStart;
+
+    // Interrupts are requested on attach; their debounce applies from then
+    const uint64_t interruptsStart = monotonicNs();
+    for (const BoardInterruptSpec& spec : config_.interrupts) {
+        if (spec.debounceUs > 0) {
+            InterruptManager::getInstance().setDebounce(spec.pin, spec.debounceUs);
+        }
+    }
+    report_.interruptsNs = monotonicNs() - interruptsStart;
+
+    buses.get();    // Rethrows GpioAccessError from a bus
+
+    std::string failed;
+    for (size_t i = 0; i < pwmStarts.size(); ++i) {
+        if (!pwmStarts[i].get()) {
+            const BoardPwmSpec& spec = config_.pwms[i];
+            failed += (failed.empty() ? "" : ", ") + std::string("pwmchip") + std::to_string(spec.chip) +
+                      "/pwm" + std::to_string(spec.channel) + " (\"" + spec.name + "\")";
+        }
+    }
+    if (!failed.empty()) {
+        throw GpioAccessError(failed, "cannot start hardware PWM");
+    }
+}
+
+void Board::releaseLines() {
+    if (Transaction* txn = Transaction::current()) {
+        for (const auto& request : requests_) {
+            txn->forgetRequest(request.get());
+        }
+    }
+    for (auto& entry : lines_) {
+        if (entry.second.output_) {
+            entry.second.chip_->outputShadow().release(entry.second.offset_);
+        }
+    }
+    lines_.clear();
+    requests_.clear();      // Lines before the chips they came from
+    chips_.clear();
+}
+
+Board::~Board() {
+    for (const auto& entry : attached_) {
+        if (entry.second) {
+            detachInterrupt(entry.first);
+        }
+    }
+    pwms_.clear();
+    releaseLines();
+}
+
+std::unique_ptr<Board> Board::fromConfig(const BoardConfig& config) {
+    return std::make_unique<Board>(config);
+}
+
+std::unique_ptr<Board> Board::fromJson(const std::string& json) {
+    const uint64_t start = monotonicNs();
+    BoardConfig config = BoardConfig::fromJson(json);
+    const uint64_t parseNs = monotonicNs() - start;
+    auto board = std::make_unique<Board>(config);
+    board->report_.parseNs = parseNs;
+    return board;
+}
+
+std::unique_ptr<Board> Board::fromFile(const std::string& path) {
+    const uint64_t start = monotonicNs();
+    BoardConfig config = BoardConfig::fromFile(path);
+    const uint64_t parseNs = monotonicNs() - start;
+    auto board = std::make_unique<Board>(config);
+    board->report_.parseNs = parseNs;
+    return board;
+}
+
+BoardLine& Board::line(const std::string& name) {
+    auto it = lines_.find(name);
+    if (it == lines_.end()) {
+        throw std::invalid_argument("Board has no line \"" + name + "\"");
+    }
+    return it->second;
+}
+
+HardwarePWM& Board::pwm(const std::string& name) {
+    auto it = pwms_.find(name);
+    if (it == pwms_.end()) {
+        throw std::invalid_argument("Board has no PWM channel \"" + name + "\"");
+    }
+    return *it->second;
+}
+
+WireClass& Board::i2c(const std::string& name) {
+    auto it = i2c_.find(name);
+    if (it == i2c_.end()) {
+        throw std::invalid_argument("Board has no I2C bus \"" + name + "\"");
+    }
+    return *it->second;
+}
+
+SPIClass& Board::spi(const std::string& name) {
+    auto it = spi_.find(name);
+    if (it == spi_.end()) {
+        throw std::invalid_argument("Board has no SPI device \"" + name + "\"");
+    }
+    return *it->second;
+}
+
+void Board::attachInterrupt(const std::string& name, InterruptCallback callback) {
+    auto it = std::find_if(config_.interrupts.begin(), config_.interrupts.end(),
+                           [&name](const BoardInterruptSpec& spec) { return spec.name == name; });
+    if (it == config_.interrupts.end()) {
+        throw std::invalid_argument("Board has no interrupt \"" + name + "\"");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    InterruptManager::getInstance().attachInterrupt(it->pin, std::move(callback), it->mode,
+                                                    it->chip.empty() ? config_.chipname : it->chip);
+    attached_[name] = true;
+}
+
+void Board::detachInterrupt(const std::string& name) {
+    auto it = std::find_if(config_.interrupts.begin(), config_.interrupts.end(),
+                           [&name](const BoardInterruptSpec& spec) { return spec.name == name; });
+    if (it == config_.interrupts.end()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto attached = attached_.find(name);
+    if (attached != attached_.end() && attached->second) {
+        InterruptManager::getInstance().detachInterrupt(it->pin);
+        attached->second = false;
+    }
+}
+
+} // namespace pipinpp
@@ -0,0 +1,108 @@
+/**
+ * @file buffer_pool.cpp
+ * @brief Fixed-size transaction buffer pool implementation
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "buffer_pool.hpp"
+#include <stdexcept>
+
+namespace pipinpp {
+
+PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+    : pool_(other.pool_), data_(other.data_), capacity_(other.capacity_) {
+    other.pool_ = nullptr;
+    other.data_ = nullptr;
+    other.capacity_ = 0;
+}
+
+PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool_ = other.pool_;
+        data_ = other.data_;
+        capacity_ = other.capacity_;
+        other.pool_ = nullptr;
+        other.data_ = nullptr;
+        other.capacity_ = 0;
+    }
+    return *this;
+}
+
+PooledBuffer::~PooledBuffer() {
+    reset();
+}
+
+void PooledBuffer::reset() noexcept {
+    if (data_) {
+        pool_->release(data_);
+        pool_ = nullptr;
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+}
+
+BufferPool::BufferPool(size_t blockSize, size_t blockCount)
+    : blockSize_(blockSize), blockCount_(blockCount) {
+    if (blockSize == 0 || blockCount == 0) {
+        throw std::invalid_argument("BufferPool: block size and count must be non-zero");
+    }
+    // Keep every block aligned like malloc() memory
+    const size_t words = (blockSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    storage_.reset(new std::max_align_t[words * blockCount]);
+    
+    free_.reserve(blockCount);
+    for (size_t i = blockCount; i-- > 0;) {
+        free_.push_back(reinterpret_cast<uint8_t*>(storage_.get() + i * words));
+    }
+}
+
+PooledBuffer BufferPool::acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+        ++exhausted_;
+        return PooledBuffer();
+    }
+    uint8_t* data = free_.back();
+    free_.pop_back();
+    return PooledBuffer(this, data, blockSize_);
+}
+
+void BufferPool::release(uint8_t* data) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(data);      // Within the reserved capacity: never reallocates
+}
+
+size_t BufferPool::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
+
+uint64_t BufferPool::getExhaustedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return exhausted_;
+}
+
+} // namespace pipinpp
@@ -0,0 +1,103 @@
+/**
+ * @file bus_registry.cpp
+ * @brief Per-bus SPIClass and WireClass instances
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bus_registry.hpp"
+#include "exceptions.hpp"
+#include "log.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace pipinpp {
+
+namespace {
+
+/**
+ * @brief Bus objects, never moved once created (callers keep references)
+ */
+struct Registry {
+    std::mutex mutex;
+    std::map<std::pair<int, int>, std::unique_ptr<SPIClass>> spi;
+    std::map<int, std::unique_ptr<WireClass>> i2c;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+} // namespace
+
+SPIClass& SPIBus(int bus, int cs) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    auto it = reg.spi.find({bus, cs});
+    if (it != reg.spi.end()) {
+        return *it->second;
+    }
+    auto spi = std::make_unique<SPIClass>();
+    if (!spi->begin(bus, cs)) {
+        throw GpioAccessError("/dev/spidev" + std::to_string(bus) + "." + std::to_string(cs),
+                              "cannot open SPI bus");
+    }
+    PIPINPP_LOG_DEBUG("Bus registry: opened /dev/spidev" << bus << "." << cs);
+    return *reg.spi.emplace(std::make_pair(bus, cs), std::move(spi)).first->second;
+}
+
+WireClass& I2CBus(int bus) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    auto it = reg.i2c.find(bus);
+    if (it != reg.i2c.end()) {
+        return *it->second;
+    }
+    auto wire = std::make_unique<WireClass>();
+    if (!wire->begin(bus)) {
+        throw GpioAccessError("/dev/i2c-" + std::to_string(bus), "cannot open I2C bus");
+    }
+    PIPINPP_LOG_DEBUG("Bus registry: opened /dev/i2c-" << bus);
+    return *reg.i2c.emplace(bus, std::move(wire)).first->second;
+}
+
+void closeAllBuses() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& entry : reg.spi) {
+        entry.second->end();
+    }
+    for (auto& entry : reg.i2c) {
+        entry.second->end();
+    }
+    reg.spi.clear();
+    reg.i2c.clear();
+}
+
+} // namespace pipinpp
@@ -0,0 +1,136 @@
+/**
+ * @file cache_file.cpp
+ * @brief Private cache files: runtime directory, no-follow writes, owner checks
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "cache_file.hpp"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace pipinpp {
+
+namespace {
+
+// Caches are a few hundred bytes; anything far larger is not one of ours
+constexpr off_t MAX_CACHE_BYTES = 1 << 20;
+
+// A directory (not a link to one) that only the effective user can write
+bool isPrivateDirectory(const std::string& path) {
+    struct stat st;
+    return lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode) && st.st_uid == geteuid() &&
+           (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+} // namespace
+
+std::string runtimeCachePath(const std::string& name) {
+    std::string dir;
+    if (geteuid() == 0) {
+        dir = "/run/pipinpp";
+    } else {
+        const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+        if (runtime == nullptr || runtime[0] != '/' || !isPrivateDirectory(runtime)) {
+            return std::string();
+        }
+        dir = std::string(runtime) + "/pipinpp";
+    }
+    if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+        return std::string();
+    }
+    if (!isPrivateDirectory(dir)) {
+        return std::string();
+    }
+    return dir + "/" + name;
+}
+
+bool writeCacheFile(const std::string& path, const std::string& content) {
+    std::vector<char> temp(path.begin(), path.end());
+    const char suffix[] = ".XXXXXX";
+    temp.insert(temp.end(), suffix, suffix + sizeof(suffix));
+    int fd = mkostemp(temp.data(), O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t done = 0; ok && done < content.size();) {
+        ssize_t n = ::write(fd, content.data() + done, content.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = n > 0;
+        done += ok ? static_cast<size_t>(n) : 0;
+    }
+    ok = (::close(fd) == 0) && ok;
+
+    // rename() replaces a planted symlink instead of writing through it
+    if (!ok || std::rename(temp.data(), path.c_str()) != 0) {
+        std::remove(temp.data());
+        return false;
+    }
+    return true;
+}
+
+bool readCacheFile(const std::string& path, std::string& content, time_t* modified) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid() ||
+        (st.st_mode & (S_IWGRP | S_IWOTH)) != 0 || st.st_size > MAX_CACHE_BYTES) {
+        ::close(fd);
+        return false;
+    }
+
+    std::string text;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = ::read(fd, buffer, sizeof(buffer))) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ::close(fd);
+            return false;
+        }
+        text.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+
+    content = std::move(text);
+    if (modified != nullptr) {
+        *modified = st.st_mtime;
+    }
+    return true;
+}
+
+} // namespace pipinpp
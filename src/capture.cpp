@@ -0,0 +1,584 @@
+/**
+ * @file capture.cpp
+ * @brief Edge capture to a memory-mapped ring file and VCD / sigrok export
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "capture.hpp"
+#include "interrupts.hpp"
+#include "log.hpp"
+#include "pin.hpp"
+#include "serial_framing.hpp"
+#include "timebase.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr char CAPTURE_MAGIC[8] = {'P', 'I', 'P', 'I', 'N', 'C', 'A', 'P'};
+
+/// Largest sample stream writeSigrok() produces
+constexpr uint64_t SIGROK_MAX_BYTES = 1ull << 30;
+
+void put16(std::string& out, uint16_t value) {
+    out += static_cast<char>(value & 0xFF);
+    out += static_cast<char>(value >> 8);
+}
+
+void put32(std::string& out, uint32_t value) {
+    put16(out, static_cast<uint16_t>(value & 0xFFFF));
+    put16(out, static_cast<uint16_t>(value >> 16));
+}
+
+/**
+ * @brief Minimal zip writer: stored (uncompressed) entries, streamed
+ *
+ * sigrok reads .sr session files with libzip, which accepts stored
+ * entries, so no deflate implementation is needed. Sizes and CRCs are
+ * patched into each local header once its data is written.
+ */
+class ZipWriter {
+public:
+    explicit ZipWriter(const std::string& path) : file_(path, std::ios::binary | std::ios::trunc) {}
+
+    bool good() const { return static_cast<bool>(file_); }
+
+    void begin(const std::string& name) {
+        Entry entry;
+        entry.name = name;
+        entry.offset = static_cast<uint32_t>(file_.tellp());
+        entries_.push_back(entry);
+        std::string header;
+        put32(header, 0x04034b50);
+        put16(header, 10);              // Version needed: 1.0
+        put16(header, 0);               // Flags
+        put16(header, 0);               // Method: stored
+        put16(header, 0);               // Time
+        put16(header, 0x21);            // Date: 1980-01-01
+        put32(header, 0);               // CRC, patched in end()
+        put32(header, 0);               // Compressed size
+        put32(header, 0);               // Size
+        put16(header, static_cast<uint16_t>(name.size()));
+        put16(header, 0);               // Extra length
+        header += name;
+        file_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+
+    void write(const uint8_t* data, size_t length) {
+        Entry& entry = entries_.back();
+        entry.crc = crc32(data, length, entry.crc);
+        entry.size += static_cast<uint32_t>(length);
+        file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+    }
+
+    void write(const std::string& text) {
+        write(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    }
+
+    void end() {
+        const Entry& entry = entries_.back();
+        const std::streampos here = file_.tellp();
+        std::string sizes;
+        put32(sizes, entry.crc);
+        put32(sizes, entry.size);
+        put32(sizes, entry.size);
+        file_.seekp(entry.offset + 14);
+        file_.write(sizes.data(), static_cast<std::streamsize>(sizes.size()));
+        file_.seekp(here);
+    }
+
+    bool finish() {
+        const uint32_t directoryOffset = static_cast<uint32_t>(file_.tellp());
+        std::string directory;
+        for (const Entry& entry : entries_) {
+            put32(directory, 0x02014b50);
+            put16(directory, 0x0314);   // Made by: Unix, 2.0
+            put16(directory, 10);
+            put16(directory, 0);
+            put16(directory, 0);
+            put16(directory, 0);
+            put16(directory, 0x21);
+            put32(directory, entry.crc);
+            put32(directory, entry.size);
+            put32(directory, entry.size);
+            put16(directory, static_cast<uint16_t>(entry.name.size()));
+            put16(directory, 0);        // Extra length
+            put16(directory, 0);        // Comment length
+            put16(directory, 0);        // Disk
+            put16(directory, 0);        // Internal attributes
+            put32(directory, 0644u << 16);
+            put32(directory, entry.offset);
+            directory += entry.name;
+        }
+        const uint32_t directorySize = static_cast<uint32_t>(directory.size());
+        put32(directory, 0x06054b50);
+        put16(directory, 0);            // Disk
+        put16(directory, 0);            // Directory disk
+        put16(directory, static_cast<uint16_t>(entries_.size()));
+        put16(directory, static_cast<uint16_t>(entries_.size()));
+        put32(directory, directorySize);
+        put32(directory, directoryOffset);
+        put16(directory, 0);            // Comment length
+        file_.write(directory.data(), static_cast<std::streamsize>(directory.size()));
+        file_.close();
+        return !file_.fail();
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        uint32_t offset = 0;
+        uint32_t crc = 0;
+        uint32_t size = 0;
+    };
+
+    std::ofstream file_;
+    std::vector<Entry> entries_;
+};
+
+/// "1 MHz", "250 kHz", "100 Hz" as sigrok writes them
+std::string formatSampleRate(uint64_t hz) {
+    std::ostringstream out;
+    if (hz >= 1000000000 && hz % 1000000000 == 0) {
+        out << hz / 1000000000 << " GHz";
+    } else if (hz >= 1000000 && hz % 1000000 == 0) {
+        out << hz / 1000000 << " MHz";
+    } else if (hz >= 1000 && hz % 1000 == 0) {
+        out << hz / 1000 << " kHz";
+    } else {
+        out << hz << " Hz";
+    }
+    return out.str();
+}
+
+} // namespace
+
+void initCaptureHeader(CaptureHeader& header, const std::vector<int>& pins,
+                       const std::vector<int>& initialLevels, uint64_t startNs, uint64_t capacity) {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_FORMAT_VERSION;
+    header.recordSize = sizeof(CaptureRecord);
+    header.headerSize = CAPTURE_HEADER_SIZE;
+    header.pinCount = static_cast<uint32_t>(std::min(pins.size(), CAPTURE_MAX_PINS));
+    header.capacity = capacity;
+    header.startNs = startNs;
+    for (uint32_t i = 0; i < header.pinCount; ++i) {
+        header.pins[i] = static_cast<uint8_t>(pins[i]);
+        header.initialLevels[i] = i < initialLevels.size() && initialLevels[i] ? 1 : 0;
+        header.lastLevels[i] = header.initialLevels[i];
+    }
+}
+
+// ============================================================================
+// CaptureSession
+// ============================================================================
+
+CaptureSession::~CaptureSession() {
+    stop();
+}
+
+bool CaptureSession::start(const CaptureOptions& options) {
+    if (header_) {
+        PIPINPP_LOG_ERROR("Capture already running");
+        return false;
+    }
+    if (options.pins.empty() || options.pins.size() > CAPTURE_MAX_PINS) {
+        PIPINPP_LOG_ERROR("Capture needs 1-" << CAPTURE_MAX_PINS << " pins, got " << options.pins.size());
+        return false;
+    }
+    for (size_t i = 0; i < options.pins.size(); ++i) {
+        const int pin = options.pins[i];
+        if (pin < 0 || pin > 255 ||
+            std::find(options.pins.begin(), options.pins.begin() + i, pin) != options.pins.begin() + i) {
+            PIPINPP_LOG_ERROR("Invalid or repeated capture pin " << pin);
+            return false;
+        }
+    }
+    if (options.capacity == 0 || options.path.empty()) {
+        PIPINPP_LOG_ERROR("Capture needs a file path and a capacity of at least one record");
+        return false;
+    }
+
+    // Starting levels: a short-lived input request per pin, released
+    // before the interrupt request takes the lines
+    std::vector<int> levels;
+    try {
+        for (int pin : options.pins) {
+            Pin probe(pin, PinDirection::INPUT, options.chipname);
+            levels.push_back(probe.read());
+        }
+    } catch (const std::exception& e) {
+        PIPINPP_LOG_ERROR("Capture cannot read pin levels: " << e.what());
+        return false;
+    }
+
+    const size_t size = CAPTURE_HEADER_SIZE + options.capacity * sizeof(CaptureRecord);
+    const int fd = ::open(options.path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        PIPINPP_LOG_ERROR("Cannot create " << options.path << ": " << std::strerror(errno));
+        return false;
+    }
+    // Reserve the blocks now so a full disk fails here, not as SIGBUS mid-capture
+    int err = ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+    if (err == EOPNOTSUPP || err == EINVAL) {
+        err = ::ftruncate(fd, static_cast<off_t>(size)) == 0 ? 0 : errno;
+    }
+    if (err != 0) {
+        PIPINPP_LOG_ERROR("Cannot size " << options.path << ": " << std::strerror(err));
+        ::close(fd);
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        PIPINPP_LOG_ERROR("Cannot map " << options.path << ": " << std::strerror(errno));
+        return false;
+    }
+
+    header_ = static_cast<CaptureHeader*>(mapping);
+    records_ = reinterpret_cast<CaptureRecord*>(static_cast<uint8_t*>(mapping) + CAPTURE_HEADER_SIZE);
+    mappedSize_ = size;
+    capacity_ = options.capacity;
+    stopWhenFull_ = options.stopWhenFull;
+    pins_ = options.pins;
+    chipname_ = options.chipname;
+    std::fill(std::begin(lastSeqno_), std::end(lastSeqno_), 0);
+    for (size_t i = 0; i < pins_.size(); ++i) {
+        pinIndex_[pins_[i]] = static_cast<uint8_t>(i);
+    }
+    initCaptureHeader(*header_, pins_, levels, static_cast<uint64_t>(monotonicNowNs()), capacity_);
+
+    // One merged request: a single kernel buffer and fd for every pin
+    auto& interrupts = InterruptManager::getInstance();
+    const bool merged = interrupts.getMergeRequests();
+    interrupts.setMergeRequests(true);
+    size_t attached = 0;
+    try {
+        for (int pin : pins_) {
+            interrupts.attachInterruptBatch(pin, [this](EdgeEventSpan events) { record(events); },
+                                            InterruptMode::CHANGE, options.eventBufferSize, chipname_);
+            ++attached;
+        }
+    } catch (const std::exception& e) {
+        PIPINPP_LOG_ERROR("Capture cannot attach pin " << pins_[attached] << ": " << e.what());
+        for (size_t i = 0; i < attached; ++i) {
+            interrupts.detachInterrupt(pins_[i]);
+        }
+        interrupts.setMergeRequests(merged);
+        ::munmap(mapping, size);
+        header_ = nullptr;
+        records_ = nullptr;
+        return false;
+    }
+    interrupts.setMergeRequests(merged);
+
+    PIPINPP_LOG_INFO("Capturing " << pins_.size() << " pins to " << options.path
+                     << " (" << capacity_ << " records)");
+    return true;
+}
+
+void CaptureSession::record(const EdgeEventSpan& events) {
+    // Runs on the interrupt monitor thread, the only writer
+    uint64_t count = header_->recordCount;
+    uint64_t lost = header_->lostCount;
+    for (const EdgeEvent& event : events) {
+        const int pin = event.pin;
+        // Kernel sequence numbers restart when the merged request is rebuilt
+        uint64_t& last = lastSeqno_[pin];
+        if (last != 0 && event.lineSeqno > last + 1) {
+            lost += event.lineSeqno - last - 1;
+        }
+        last = event.lineSeqno;
+
+        if (stopWhenFull_ && count >= capacity_) {
+            ++lost;
+            continue;
+        }
+        const uint8_t level = event.type == EdgeType::RISING ? 1 : 0;
+        CaptureRecord& slot = records_[count % capacity_];
+        slot.timestampNs = event.timestampNs;
+        slot.lineSeqno = static_cast<uint32_t>(event.lineSeqno);
+        slot.pin = static_cast<uint8_t>(pin);
+        slot.level = level;
+        slot.reserved = 0;
+        header_->lastLevels[pinIndex_[pin]] = level;
+        ++count;
+    }
+    // Publish after the records so a reader of the counts sees complete slots
+    __atomic_store_n(&header_->lostCount, lost, __ATOMIC_RELEASE);
+    __atomic_store_n(&header_->recordCount, count, __ATOMIC_RELEASE);
+}
+
+void CaptureSession::stop() {
+    if (!header_) {
+        return;
+    }
+    // No callback runs after detachInterrupt() returns
+    auto& interrupts = InterruptManager::getInstance();
+    for (int pin : pins_) {
+        interrupts.detachInterrupt(pin);
+    }
+    header_->stopNs = static_cast<uint64_t>(monotonicNowNs());
+    PIPINPP_LOG_INFO("Capture stopped: " << header_->recordCount << " records, "
+                     << header_->lostCount << " lost");
+    ::msync(header_, mappedSize_, MS_SYNC);
+    ::munmap(header_, mappedSize_);
+    header_ = nullptr;
+    records_ = nullptr;
+    mappedSize_ = 0;
+}
+
+uint64_t CaptureSession::getRecordCount() const {
+    return header_ ? __atomic_load_n(&header_->recordCount, __ATOMIC_ACQUIRE) : 0;
+}
+
+uint64_t CaptureSession::getLostCount() const {
+    return header_ ? __atomic_load_n(&header_->lostCount, __ATOMIC_ACQUIRE) : 0;
+}
+
+// ============================================================================
+// Reading and conversion
+// ============================================================================
+
+bool readCapture(const std::string& path, CaptureData& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        PIPINPP_LOG_ERROR("Cannot open capture " << path);
+        return false;
+    }
+    CaptureHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 ||
+        header.recordSize != sizeof(CaptureRecord) || header.headerSize < sizeof(CaptureHeader) ||
+        header.pinCount == 0 || header.pinCount > CAPTURE_MAX_PINS) {
+        PIPINPP_LOG_ERROR(path << " is not a PiPinPP capture file");
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    const uint64_t available = fileSize > header.headerSize ? (fileSize - header.headerSize) / sizeof(CaptureRecord) : 0;
+
+    // Stream: records until end of file (the count is only patched on a
+    // clean stop). Ring: the count decides which slots hold data.
+    uint64_t kept = 0;
+    uint64_t first = 0;
+    data.wrapped = false;
+    if (header.capacity == 0) {
+        kept = header.recordCount ? std::min(header.recordCount, available) : available;
+    } else {
+        kept = std::min({header.recordCount, header.capacity, available});
+        if (header.recordCount > header.capacity) {
+            data.wrapped = true;
+            first = header.recordCount % header.capacity;
+        }
+    }
+
+    data.records.resize(kept);
+    if (kept > 0) {
+        // Oldest first: [first, kept) then [0, first)
+        auto readSlots = [&](uint64_t from, uint64_t count, CaptureRecord* out) {
+            file.seekg(static_cast<std::streamoff>(header.headerSize + from * sizeof(CaptureRecord)));
+            file.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(count * sizeof(CaptureRecord)));
+        };
+        file.clear();
+        readSlots(first, kept - first, data.records.data());
+        if (first > 0) {
+            readSlots(0, first, data.records.data() + (kept - first));
+        }
+        if (!file) {
+            PIPINPP_LOG_ERROR("Short read from capture " << path);
+            return false;
+        }
+    }
+    // Batches are recorded per pin, so restore global timestamp order
+    std::stable_sort(data.records.begin(), data.records.end(),
+                     [](const CaptureRecord& a, const CaptureRecord& b) { return a.timestampNs < b.timestampNs; });
+
+    data.pins.assign(header.pins, header.pins + header.pinCount);
+    data.initialLevels.assign(header.initialLevels, header.initialLevels + header.pinCount);
+    data.startNs = header.startNs;
+    data.stopNs = header.stopNs;
+    data.lostCount = header.lostCount;
+
+    if (data.wrapped && !data.records.empty()) {
+        // The starting levels were overwritten: a pin was at the opposite of
+        // its first kept edge, or, without kept edges, at its latest level
+        data.startNs = data.records.front().timestampNs;
+        for (uint32_t i = 0; i < header.pinCount; ++i) {
+            data.initialLevels[i] = header.lastLevels[i];
+            for (const CaptureRecord& record : data.records) {
+                if (record.pin == header.pins[i]) {
+                    data.initialLevels[i] = record.level ? 0 : 1;
+                    break;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool writeVcd(const CaptureData& data, const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        PIPINPP_LOG_ERROR("Cannot write " << path);
+        return false;
+    }
+
+    // Short printable identifiers: "!", "\"", ... then two characters
+    std::string ids[256];
+    file << "$version PiPinPP capture $end\n"
+         << "$timescale 1ns $end\n"
+         << "$scope module gpio $end\n";
+    for (size_t i = 0; i < data.pins.size(); ++i) {
+        std::string& id = ids[data.pins[i] & 0xFF];
+        size_t index = i;
+        do {
+            id += static_cast<char>('!' + index % 94);
+            index /= 94;
+        } while (index > 0);
+        file << "$var wire 1 " << id << " gpio" << data.pins[i] << " $end\n";
+    }
+    file << "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n";
+    for (size_t i = 0; i < data.pins.size(); ++i) {
+        file << (i < data.initialLevels.size() ? data.initialLevels[i] : 0) << ids[data.pins[i] & 0xFF] << "\n";
+    }
+    file << "$end\n";
+
+    uint64_t lastTime = 0;
+    for (const CaptureRecord& record : data.records) {
+        const uint64_t t = record.timestampNs > data.startNs ? record.timestampNs - data.startNs : 0;
+        if (t != lastTime) {
+            file << "#" << t << "\n";
+            lastTime = t;
+        }
+        file << (record.level ? '1' : '0') << ids[record.pin] << "\n";
+    }
+    file.close();
+    return !file.fail();
+}
+
+bool writeSigrok(const CaptureData& data, const std::string& path, uint64_t sampleRateHz) {
+    if (sampleRateHz == 0 || data.pins.empty()) {
+        PIPINPP_LOG_ERROR("sigrok export needs pins and a sample rate");
+        return false;
+    }
+    const size_t unitSize = (data.pins.size() + 7) / 8;
+    const uint64_t endNs = data.records.empty() ? std::max(data.stopNs, data.startNs)
+                                                : std::max(data.stopNs, data.records.back().timestampNs);
+    auto sampleOf = [&](uint64_t ns) {
+        // Split at whole seconds so t * rate cannot overflow
+        const uint64_t t = ns > data.startNs ? ns - data.startNs : 0;
+        return t / 1000000000 * sampleRateHz + (t % 1000000000 * sampleRateHz + 500000000) / 1000000000;
+    };
+    const uint64_t sampleCount = sampleOf(endNs) + 1;
+    if (sampleCount > SIGROK_MAX_BYTES / unitSize) {
+        PIPINPP_LOG_ERROR("sigrok export of " << sampleCount << " samples exceeds 1 GiB; lower the sample rate");
+        return false;
+    }
+
+    ZipWriter zip(path);
+    if (!zip.good()) {
+        PIPINPP_LOG_ERROR("Cannot write " << path);
+        return false;
+    }
+    zip.begin("version");
+    zip.write("2");
+    zip.end();
+
+    std::ostringstream metadata;
+    metadata << "[global]\nsigrok version=0.5.2\n\n"
+             << "[device 1]\ncapturefile=logic-1\n"
+             << "total probes=" << data.pins.size() << "\n"
+             << "samplerate=" << formatSampleRate(sampleRateHz) << "\n"
+             << "total analog=0\n";
+    for (size_t i = 0; i < data.pins.size(); ++i) {
+        metadata << "probe" << i + 1 << "=gpio" << data.pins[i] << "\n";
+    }
+    metadata << "unitsize=" << unitSize << "\n";
+    zip.begin("metadata");
+    zip.write(metadata.str());
+    zip.end();
+
+    // Repeat the current sample up to each edge, in fixed-size chunks
+    uint64_t bits = 0;
+    int bitOf[256];
+    std::fill(std::begin(bitOf), std::end(bitOf), -1);
+    for (size_t i = 0; i < data.pins.size(); ++i) {
+        bitOf[data.pins[i] & 0xFF] = static_cast<int>(i);
+        if (i < data.initialLevels.size() && data.initialLevels[i]) {
+            bits |= 1ull << i;
+        }
+    }
+    std::vector<uint8_t> chunk;
+    chunk.reserve(64 * 1024);
+    auto emit = [&](uint64_t count) {
+        while (count-- > 0) {
+            for (size_t b = 0; b < unitSize; ++b) {
+                chunk.push_back(static_cast<uint8_t>(bits >> (8 * b)));
+            }
+            if (chunk.size() + unitSize > chunk.capacity()) {
+                zip.write(chunk.data(), chunk.size());
+                chunk.clear();
+            }
+        }
+    };
+
+    zip.begin("logic-1-1");
+    uint64_t written = 0;
+    for (const CaptureRecord& record : data.records) {
+        const int bit = bitOf[record.pin];
+        if (bit < 0) {
+            continue;
+        }
+        const uint64_t sample = sampleOf(record.timestampNs);
+        if (sample > written) {
+            emit(sample - written);
+            written = sample;
+        }
+        if (record.level) {
+            bits |= 1ull << bit;
+        } else {
+            bits &= ~(1ull << bit);
+        }
+    }
+    emit(sampleCount - written);
+    zip.write(chunk.data(), chunk.size());
+    zip.end();
+    return zip.finish();
+}
+
+} // namespace pipinpp
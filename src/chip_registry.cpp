@@ -0,0 +1,334 @@
+/**
+ * @file chip_registry.cpp
+ * @brief Implementation of the shared GPIO chip handle cache
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "chip_registry.hpp"
+#include "exceptions.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cerrno>
+
+namespace pipinpp {
+
+namespace {
+
+/**
+ * @brief LineRequest over a libgpiod line request
+ */
+class LibgpiodLineRequest : public LineRequest {
+public:
+    LibgpiodLineRequest(gpiod_line_request* request, size_t eventBufferSize)
+        : request_(request), buffer_(nullptr), bufferSize_(eventBufferSize > 0 ? eventBufferSize : 16) {}
+
+    ~LibgpiodLineRequest() override {
+        if (buffer_) {
+            gpiod_edge_event_buffer_free(buffer_);
+        }
+        gpiod_line_request_release(request_);
+    }
+
+    LibgpiodLineRequest(const LibgpiodLineRequest&) = delete;
+    LibgpiodLineRequest& operator=(const LibgpiodLineRequest&) = delete;
+
+    int setValue(unsigned int offset, bool value) override {
+        return gpiod_line_request_set_value(request_, offset,
+                                            value ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE);
+    }
+
+    int setValues(const unsigned int* offsets, const bool* values, size_t count) override {
+        constexpr size_t MAX_SUBSET = 64;
+        if (count > MAX_SUBSET) {
+            return LineRequest::setValues(offsets, values, count);
+        }
+        gpiod_line_value levels[MAX_SUBSET];
+        for (size_t i = 0; i < count; ++i) {
+            levels[i] = values[i] ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE;
+        }
+        return gpiod_line_request_set_values_subset(request_, count, offsets, levels);
+    }
+
+    int getValue(unsigned int offset) override {
+        gpiod_line_value value = gpiod_line_request_get_value(request_, offset);
+        if (value == GPIOD_LINE_VALUE_ERROR) {
+            return -1;
+        }
+        return value == GPIOD_LINE_VALUE_ACTIVE ? 1 : 0;
+    }
+
+    bool reconfigure(const std::vector<LineSettings>& lines) override {
+        gpiod_line_config* config = buildLineConfig(lines);
+        if (!config) {
+            return false;
+        }
+        bool ok = gpiod_line_request_reconfigure_lines(request_, config) == 0;
+        gpiod_line_config_free(config);
+        return ok;
+    }
+
+    int fd() const override { return gpiod_line_request_get_fd(request_); }
+
+    int waitEdgeEvents(int64_t timeoutNs) override {
+        return gpiod_line_request_wait_edge_events(request_, timeoutNs);
+    }
+
+    int readEdgeEvents(LineEvent* events, size_t maxEvents) override {
+        if (!buffer_) {
+            // Allocated on first use: most requests never read edges
+            buffer_ = gpiod_edge_event_buffer_new(bufferSize_);
+            if (!buffer_) {
+                return -1;
+            }
+        }
+        size_t capacity = gpiod_edge_event_buffer_get_capacity(buffer_);
+        int count = gpiod_line_request_read_edge_events(request_, buffer_,
+                                                        maxEvents < capacity ? maxEvents : capacity);
+        for (int i = 0; i < count; ++i) {
+            gpiod_edge_event* event = gpiod_edge_event_buffer_get_event(buffer_, static_cast<unsigned long>(i));
+            events[i].offset = gpiod_edge_event_get_line_offset(event);
+            events[i].rising = gpiod_edge_event_get_event_type(event) == GPIOD_EDGE_EVENT_RISING_EDGE;
+            events[i].timestampNs = gpiod_edge_event_get_timestamp_ns(event);
+            events[i].globalSeqno = gpiod_edge_event_get_global_seqno(event);
+            events[i].lineSeqno = gpiod_edge_event_get_line_seqno(event);
+        }
+        return count;
+    }
+
+    /**
+     * @brief libgpiod line config for @p lines (caller frees), nullptr on allocation failure
+     */
+    static gpiod_line_config* buildLineConfig(const std::vector<LineSettings>& lines) {
+        gpiod_line_config* config = gpiod_line_config_new();
+        if (!config) {
+            return nullptr;
+        }
+        for (const LineSettings& line : lines) {
+            gpiod_line_settings* settings = gpiod_line_settings_new();
+            if (!settings) {
+                gpiod_line_config_free(config);
+                return nullptr;
+            }
+            gpiod_line_settings_set_direction(settings, line.direction);
+            if (line.direction == GPIOD_LINE_DIRECTION_OUTPUT) {
+                gpiod_line_settings_set_output_value(settings, line.outputValue);
+            } else {
+                gpiod_line_settings_set_edge_detection(settings, line.edge);
+                gpiod_line_settings_set_debounce_period_us(settings, line.debounceUs);
+            }
+            if (line.bias != GPIOD_LINE_BIAS_AS_IS) {
+                gpiod_line_settings_set_bias(settings, line.bias);
+            }
+            unsigned int offset = line.offset;
+            int result = gpiod_line_config_add_line_settings(config, &offset, 1, settings);
+            gpiod_line_settings_free(settings);
+            if (result != 0) {
+                gpiod_line_config_free(config);
+                return nullptr;
+            }
+        }
+        return config;
+    }
+
+private:
+    gpiod_line_request* request_;
+    gpiod_edge_event_buffer* buffer_;
+    size_t bufferSize_;
+};
+
+} // namespace
+
+// OutputShadow Implementation
+
+OutputShadow::OutputShadow(size_t numLines)
+    : banks_(std::max<size_t>(1, (numLines + 63) / 64)),
+      levels_(new std::atomic<uint64_t>[banks_]),
+      owned_(new std::atomic<uint64_t>[banks_]) {
+    for (size_t i = 0; i < banks_; ++i) {
+        levels_[i].store(0, std::memory_order_relaxed);
+        owned_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void OutputShadow::claim(unsigned int offset, bool level) {
+    if (offset / 64 >= banks_) {
+        return;
+    }
+    record(offset, level);
+    owned_[offset / 64].fetch_or(uint64_t{1} << (offset % 64), std::memory_order_release);
+}
+
+void OutputShadow::release(unsigned int offset) {
+    if (offset / 64 >= banks_) {
+        return;
+    }
+    owned_[offset / 64].fetch_and(~(uint64_t{1} << (offset % 64)), std::memory_order_release);
+}
+
+uint64_t OutputShadow::levels(size_t bank) const {
+    if (bank >= banks_) {
+        return 0;
+    }
+    return levels_[bank].load(std::memory_order_relaxed) & owned_[bank].load(std::memory_order_acquire);
+}
+
+uint64_t OutputShadow::owned(size_t bank) const {
+    return bank < banks_ ? owned_[bank].load(std::memory_order_acquire) : 0;
+}
+
+// GpioChip Implementation
+
+GpioChip::GpioChip(gpiod_chip* chip, const std::string& name, const std::string& label, size_t numLines)
+    : chip_(chip), name_(name), label_(label), numLines_(numLines), shadow_(numLines) {
+}
+
+GpioChip::GpioChip(const std::string& name, const std::string& label, size_t numLines)
+    : chip_(nullptr), name_(name), label_(label), numLines_(numLines), shadow_(numLines) {
+}
+
+GpioChip::~GpioChip() {
+    if (chip_) {
+        gpiod_chip_close(chip_);
+        chip_ = nullptr;
+    }
+    PIPINPP_LOG_DEBUG("Closed shared GPIO chip " << name_);
+}
+
+gpiod_line_request* GpioChip::requestLines(gpiod_request_config* req_cfg, gpiod_line_config* line_cfg) {
+    if (!chip_) {
+        errno = ENOTSUP;
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return gpiod_chip_request_lines(chip_, req_cfg, line_cfg);
+}
+
+std::unique_ptr<LineRequest> GpioChip::requestLines(const std::string& consumer,
+                                                    const std::vector<LineSettings>& lines,
+                                                    size_t eventBufferSize) {
+    gpiod_line_config* line_cfg = LibgpiodLineRequest::buildLineConfig(lines);
+    gpiod_request_config* req_cfg = gpiod_request_config_new();
+    if (!line_cfg || !req_cfg) {
+        if (line_cfg) {
+            gpiod_line_config_free(line_cfg);
+        }
+        if (req_cfg) {
+            gpiod_request_config_free(req_cfg);
+        }
+        errno = ENOMEM;
+        return nullptr;
+    }
+    gpiod_request_config_set_consumer(req_cfg, consumer.c_str());
+    if (eventBufferSize > 0) {
+        gpiod_request_config_set_event_buffer_size(req_cfg, eventBufferSize);
+    }
+
+    gpiod_line_request* request = requestLines(req_cfg, line_cfg);
+    gpiod_request_config_free(req_cfg);
+    gpiod_line_config_free(line_cfg);
+    if (!request) {
+        return nullptr;
+    }
+    return std::make_unique<LibgpiodLineRequest>(request, eventBufferSize);
+}
+
+// ChipRegistry Implementation
+
+ChipRegistry& ChipRegistry::getInstance() {
+    static ChipRegistry instance;
+    return instance;
+}
+
+std::string ChipRegistry::normalizeName(const std::string& chipname) {
+    if (chipname.compare(0, 5, "/dev/") == 0) {
+        return chipname.substr(5);
+    }
+    return chipname;
+}
+
+std::shared_ptr<GpioChip> ChipRegistry::acquire(const std::string& chipname) {
+    std::string name = normalizeName(chipname);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = chips_.find(name);
+    if (it != chips_.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+        chips_.erase(it); // Last user went away, reopen below
+    }
+
+    if (factory_) {
+        std::shared_ptr<GpioChip> chip = factory_(name);
+        if (!chip) {
+            throw GpioAccessError(name, "GPIO chip not available from the installed chip factory");
+        }
+        chips_[name] = chip;
+        return chip;
+    }
+
+    std::string path = "/dev/" + name;
+    gpiod_chip* raw = gpiod_chip_open(path.c_str());
+    if (!raw) {
+        throw GpioAccessError(path, "Failed to open GPIO chip. Check permissions and device existence.");
+    }
+
+    size_t numLines = 0;
+    std::string label;
+    gpiod_chip_info* info = gpiod_chip_get_info(raw);
+    if (info) {
+        numLines = gpiod_chip_info_get_num_lines(info);
+        const char* chipLabel = gpiod_chip_info_get_label(info);
+        if (chipLabel) {
+            label = chipLabel;
+        }
+        gpiod_chip_info_free(info);
+    }
+
+    std::shared_ptr<GpioChip> chip(new GpioChip(raw, name, label, numLines));
+    chips_[name] = chip;
+
+    PIPINPP_LOG_DEBUG("Opened shared GPIO chip " << name << " (" << numLines << " lines)");
+    return chip;
+}
+
+void ChipRegistry::setChipFactory(ChipFactory factory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    factory_ = std::move(factory);
+    chips_.clear();     // Current users keep their handles; new ones use the factory
+}
+
+size_t ChipRegistry::openCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& entry : chips_) {
+        if (!entry.second.expired()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace pipinpp
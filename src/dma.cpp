@@ -0,0 +1,352 @@
+/**
+ * @file dma.cpp
+ * @brief Implementation of DMA channels, mailbox memory and peripheral mappings
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "dma.hpp"
+#include "exceptions.hpp"
+#include "log.hpp"
+#include "platform.hpp"
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <chrono>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr size_t PAGE_SIZE_BYTES = 4096;
+
+// VideoCore mailbox property interface
+constexpr unsigned long IOCTL_MBOX_PROPERTY = _IOWR(100, 0, char*);
+constexpr uint32_t MBOX_TAG_ALLOCATE = 0x3000C;
+constexpr uint32_t MBOX_TAG_LOCK = 0x3000D;
+constexpr uint32_t MBOX_TAG_UNLOCK = 0x3000E;
+constexpr uint32_t MBOX_TAG_RELEASE = 0x3000F;
+constexpr uint32_t MBOX_MEM_DIRECT = 0x4;        // Uncached alias (0xC...)
+constexpr uint32_t MBOX_MEM_COHERENT = 0x8;      // L2-coherent alias (0x8...)
+constexpr uint32_t BUS_TO_PHYS_MASK = 0x3FFFFFFF;
+
+constexpr uint32_t BCM2835_PERIPHERAL_BASE = 0x20000000;
+constexpr uint32_t BCM2711_PERIPHERAL_BASE = 0xFE000000;
+constexpr uint32_t OSC_19_2_MHZ = 19200000;
+constexpr uint32_t OSC_54_MHZ = 54000000;
+
+/**
+ * @brief Send one property tag with a single value in and out
+ * @return Response value, or 0 on failure
+ */
+uint32_t mailboxCall(int fd, uint32_t tag, uint32_t a, uint32_t b = 0, uint32_t c = 0,
+                     size_t argc = 1) {
+    alignas(16) uint32_t msg[9] = {};
+    msg[0] = sizeof(msg);
+    msg[1] = 0;                                  // Process request
+    msg[2] = tag;
+    msg[3] = static_cast<uint32_t>(argc * 4);    // Value buffer size
+    msg[4] = static_cast<uint32_t>(argc * 4);    // Request length
+    msg[5] = a;
+    msg[6] = b;
+    msg[7] = c;
+    msg[8] = 0;                                  // End tag
+    if (ioctl(fd, IOCTL_MBOX_PROPERTY, msg) < 0 || msg[1] != 0x80000000) {
+        return 0;
+    }
+    return msg[5];
+}
+
+/**
+ * @brief Peripheral base from the device tree, falling back to PlatformInfo
+ */
+uint32_t detectPeripheralBase() {
+    std::ifstream ranges("/proc/device-tree/soc/ranges", std::ios::binary);
+    unsigned char buf[12] = {};
+    if (ranges.read(reinterpret_cast<char*>(buf), sizeof(buf)) || ranges.gcount() >= 8) {
+        auto be32 = [&](int offset) {
+            return (uint32_t(buf[offset]) << 24) | (uint32_t(buf[offset + 1]) << 16) |
+                   (uint32_t(buf[offset + 2]) << 8) | uint32_t(buf[offset + 3]);
+        };
+        uint32_t base = be32(4);
+        if (base == 0 && ranges.gcount() >= 12) {
+            base = be32(8);                      // BCM2711: 64-bit parent address
+        }
+        if (base != 0) {
+            return base;
+        }
+    }
+    return PlatformInfo::instance().getPeripheralBase();
+}
+
+uint32_t peripheralBase() {
+    static const uint32_t base = detectPeripheralBase();
+    return base;
+}
+
+} // namespace
+
+bool isDmaSupported() {
+    const auto& platform = PlatformInfo::instance();
+    if (platform.getPlatform() == Platform::RASPBERRY_PI_5) {
+        return false;                            // GPIO and PWM live behind RP1
+    }
+    return platform.isRaspberryPi() && peripheralBase() != 0;
+}
+
+// DmaMemory Implementation
+
+DmaMemory::DmaMemory(size_t size)
+    : mailboxFd_(-1), handle_(0), busBase_(0), virt_(nullptr),
+      size_((size + PAGE_SIZE_BYTES - 1) & ~(PAGE_SIZE_BYTES - 1)) {
+    if (size_ == 0) {
+        size_ = PAGE_SIZE_BYTES;
+    }
+
+    mailboxFd_ = ::open("/dev/vcio", O_RDWR | O_CLOEXEC);
+    if (mailboxFd_ < 0) {
+        throw GpioAccessError("/dev/vcio", strerror(errno));
+    }
+
+    uint32_t flags = (peripheralBase() == BCM2835_PERIPHERAL_BASE) ? MBOX_MEM_COHERENT | MBOX_MEM_DIRECT
+                                                                    : MBOX_MEM_DIRECT;
+    handle_ = mailboxCall(mailboxFd_, MBOX_TAG_ALLOCATE, static_cast<uint32_t>(size_),
+                          static_cast<uint32_t>(PAGE_SIZE_BYTES), flags, 3);
+    if (handle_ == 0) {
+        ::close(mailboxFd_);
+        throw GpioAccessError("/dev/vcio", "VideoCore memory allocation failed");
+    }
+
+    busBase_ = mailboxCall(mailboxFd_, MBOX_TAG_LOCK, handle_);
+    if (busBase_ == 0) {
+        mailboxCall(mailboxFd_, MBOX_TAG_RELEASE, handle_);
+        ::close(mailboxFd_);
+        throw GpioAccessError("/dev/vcio", "VideoCore memory lock failed");
+    }
+
+    int memFd = ::open("/dev/mem", O_RDWR | O_SYNC | O_CLOEXEC);
+    if (memFd >= 0) {
+        void* map = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, memFd,
+                         static_cast<off_t>(busBase_ & BUS_TO_PHYS_MASK));
+        ::close(memFd);
+        if (map != MAP_FAILED) {
+            virt_ = map;
+        }
+    }
+
+    if (!virt_) {
+        int err = errno;
+        mailboxCall(mailboxFd_, MBOX_TAG_UNLOCK, handle_);
+        mailboxCall(mailboxFd_, MBOX_TAG_RELEASE, handle_);
+        ::close(mailboxFd_);
+        throw GpioAccessError("/dev/mem", strerror(err));
+    }
+
+    std::memset(virt_, 0, size_);
+    PIPINPP_LOG_DEBUG("Allocated " << size_ << " bytes of DMA memory at bus 0x"
+                      << std::hex << busBase_ << std::dec);
+}
+
+DmaMemory::~DmaMemory() {
+    munmap(virt_, size_);
+    mailboxCall(mailboxFd_, MBOX_TAG_UNLOCK, handle_);
+    mailboxCall(mailboxFd_, MBOX_TAG_RELEASE, handle_);
+    ::close(mailboxFd_);
+}
+
+// PeripheralMap Implementation
+
+PeripheralMap::PeripheralMap(uint32_t blockOffset, size_t size)
+    : regs_(nullptr), map_(nullptr), mapSize_(size) {
+    if (!isDmaSupported()) {
+        throw GpioAccessError("peripheral registers",
+                              "Direct BCM283x/BCM2711 register access is not available on this platform");
+    }
+
+    int fd = ::open("/dev/mem", O_RDWR | O_SYNC | O_CLOEXEC);
+    if (fd < 0) {
+        throw GpioAccessError("/dev/mem", std::string(strerror(errno)) + " (root required)");
+    }
+
+    map_ = mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                static_cast<off_t>(peripheralBase() + blockOffset));
+    int err = errno;
+    ::close(fd); // Mapping stays valid after close
+
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        throw GpioAccessError("/dev/mem", strerror(err));
+    }
+    regs_ = static_cast<volatile uint32_t*>(map_);
+}
+
+PeripheralMap::~PeripheralMap() {
+    if (map_) {
+        munmap(map_, mapSize_);
+    }
+}
+
+// DmaChannel Implementation
+
+namespace {
+
+uint32_t validateDmaChannel(int channel) {
+    // Channel 15 lives in a separate block; 0-6 are full channels, 7-14 are "lite"
+    if (channel < 0 || channel > 14) {
+        throw InvalidPinError("Invalid DMA channel " + std::to_string(channel) + ": valid range is 0-14");
+    }
+    return static_cast<uint32_t>(channel);
+}
+
+} // namespace
+
+DmaChannel::DmaChannel(int channel)
+    : channel_(validateDmaChannel(channel)),
+      map_(dma::DMA_OFFSET, PAGE_SIZE_BYTES),
+      regs_(map_.regs() + channel_ * (0x100 / 4)) {
+    stop();
+}
+
+DmaChannel::~DmaChannel() {
+    stop();
+}
+
+void DmaChannel::start(uint32_t controlBlockBus) {
+    regs_[dma::DMA_CS] = dma::DMA_CS_RESET;
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+    regs_[dma::DMA_CS] = dma::DMA_CS_INT | dma::DMA_CS_END;  // Clear flags
+    regs_[dma::DMA_DEBUG] = 7;                               // Clear error bits
+    regs_[dma::DMA_CONBLK_AD] = controlBlockBus;
+    regs_[dma::DMA_CS] = dma::DMA_CS_WAIT_FOR_WRITES |
+                         (8u << 20) |                        // Panic priority
+                         (8u << 16) |                        // AXI priority
+                         dma::DMA_CS_ACTIVE;
+}
+
+void DmaChannel::stop() {
+    if (regs_[dma::DMA_CS] & dma::DMA_CS_ACTIVE) {
+        regs_[dma::DMA_CS] = dma::DMA_CS_ABORT;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    regs_[dma::DMA_CS] = dma::DMA_CS_RESET;
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+}
+
+bool DmaChannel::isActive() const {
+    return (regs_[dma::DMA_CS] & dma::DMA_CS_ACTIVE) != 0;
+}
+
+bool DmaChannel::hasError() const {
+    return (regs_[dma::DMA_CS] & dma::DMA_CS_ERROR) != 0;
+}
+
+uint32_t DmaChannel::currentBlock() const {
+    return regs_[dma::DMA_CONBLK_AD];
+}
+
+// PwmPacer Implementation
+
+PwmPacer::PwmPacer()
+    : pwm_(dma::PWM_OFFSET, PAGE_SIZE_BYTES), clock_(dma::CLOCK_OFFSET, PAGE_SIZE_BYTES) {
+}
+
+PwmPacer::~PwmPacer() {
+    stop();
+    volatile uint32_t* cm = clock_.regs();
+    cm[dma::CM_PWMCTL] = dma::CM_PASSWORD | dma::CM_SRC_OSC;
+}
+
+bool PwmPacer::computeDivisor(uint32_t oscillatorHz, uint32_t clockHz, uint32_t& divisor) {
+    if (oscillatorHz == 0 || clockHz == 0) {
+        return false;
+    }
+    // Round to the nearest integer divisor; the fractional part adds jitter under MASH 0
+    uint64_t div = (static_cast<uint64_t>(oscillatorHz) + clockHz / 2) / clockHz;
+    if (div < 2 || div > 4095) {
+        return false;
+    }
+    divisor = static_cast<uint32_t>(div);
+    return true;
+}
+
+uint32_t PwmPacer::oscillatorHz() {
+    return peripheralBase() == BCM2711_PERIPHERAL_BASE ? OSC_54_MHZ : OSC_19_2_MHZ;
+}
+
+uint32_t PwmPacer::setClock(uint32_t clockHz) {
+    uint32_t divisor = 0;
+    if (!computeDivisor(oscillatorHz(), clockHz, divisor)) {
+        PIPINPP_LOG_ERROR("PWM clock " << clockHz << " Hz cannot be derived from the "
+                          << oscillatorHz() << " Hz oscillator");
+        return 0;
+    }
+
+    volatile uint32_t* pwm = pwm_.regs();
+    volatile uint32_t* cm = clock_.regs();
+
+    // PWM must be stopped while its clock changes
+    pwm[dma::PWM_CTL] = 0;
+
+    cm[dma::CM_PWMCTL] = dma::CM_PASSWORD | dma::CM_SRC_OSC;   // Disable, keep source
+    for (int i = 0; i < 1000 && (cm[dma::CM_PWMCTL] & dma::CM_BUSY); ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+    if (cm[dma::CM_PWMCTL] & dma::CM_BUSY) {
+        cm[dma::CM_PWMCTL] = dma::CM_PASSWORD | dma::CM_KILL;
+    }
+
+    cm[dma::CM_PWMDIV] = dma::CM_PASSWORD | (divisor << 12);
+    cm[dma::CM_PWMCTL] = dma::CM_PASSWORD | dma::CM_SRC_OSC;
+    cm[dma::CM_PWMCTL] = dma::CM_PASSWORD | dma::CM_SRC_OSC | dma::CM_ENAB;
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+    return oscillatorHz() / divisor;
+}
+
+void PwmPacer::startFifo(int channel, uint32_t range) {
+    volatile uint32_t* pwm = pwm_.regs();
+    uint32_t shift = channel == 1 ? 8 : 0;
+
+    pwm[dma::PWM_CTL] = 0;
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+    pwm[dma::PWM_STA] = 0xFFFFFFFF;                            // Clear error flags
+    pwm[channel == 1 ? dma::PWM_RNG2 : dma::PWM_RNG1] = range;
+    pwm[dma::PWM_DMAC] = dma::PWM_DMAC_ENAB | (7u << 8) | 3u;  // PANIC=7, DREQ=3
+    pwm[dma::PWM_CTL] = dma::PWM_CTL_CLRF1;
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+    pwm[dma::PWM_CTL] = (dma::PWM_CTL_USEF1 | dma::PWM_CTL_MSEN1 | dma::PWM_CTL_PWEN1) << shift;
+}
+
+void PwmPacer::stop() {
+    volatile uint32_t* pwm = pwm_.regs();
+    pwm[dma::PWM_DMAC] = 0;
+    pwm[dma::PWM_CTL] = 0;
+}
+
+} // namespace pipinpp
@@ -0,0 +1,352 @@
+/**
+ * @file dma_soft_pwm.cpp
+ * @brief Implementation of DMA-timed multi-pin software PWM
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "dma_soft_pwm.hpp"
+#include "exceptions.hpp"
+#include "board.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint32_t GPIO_FUNCTION_OUTPUT = 1;
+constexpr uint32_t TICK_CLOCK_HZ = 10000000;  // ~10 MHz, 0.1 µs tick granularity
+constexpr uint32_t BLOCKS_PER_TICK = 3;       // GPSET0, GPCLR0, FIFO delay
+constexpr uint32_t FIFO_DEPTH = 16;           // Words the DMA can run ahead of the PWM
+
+void validatePin(int pin) {
+    if (!isValidGpioPin(pin)) {
+        throw InvalidPinError(pin, "Valid range is 0-27 for DMA PWM");
+    }
+}
+
+} // namespace
+
+// DmaSoftPWM Implementation
+
+DmaSoftPWM& DmaSoftPWM::getInstance() {
+    static DmaSoftPWM instance;
+    return instance;
+}
+
+DmaSoftPWM::DmaSoftPWM()
+    : cycleUs_(0), stepUs_(0), ticks_(0), setMasks_(nullptr), clearMasks_(nullptr) {
+    std::fill(std::begin(clearTick_), std::end(clearTick_), OFF);
+    std::fill(std::begin(savedFunction_), std::end(savedFunction_), 0u);
+}
+
+DmaSoftPWM::~DmaSoftPWM() {
+    end();
+}
+
+uint32_t DmaSoftPWM::widthToTicks(uint32_t widthUs, uint32_t stepUs, uint32_t ticks) {
+    if (stepUs == 0) {
+        return 0;
+    }
+    uint64_t tick = (static_cast<uint64_t>(widthUs) + stepUs / 2) / stepUs;
+    return static_cast<uint32_t>(std::min<uint64_t>(tick, ticks));
+}
+
+size_t DmaSoftPWM::memoryBytes(uint32_t ticks) {
+    return static_cast<size_t>(ticks) * BLOCKS_PER_TICK * sizeof(DmaControlBlock) +
+           static_cast<size_t>(ticks) * 2 * sizeof(uint32_t) +   // Set and clear masks
+           sizeof(uint32_t);                                     // FIFO word
+}
+
+bool DmaSoftPWM::begin(uint32_t cycleUs, uint32_t stepUs, int dmaChannel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return beginLocked(cycleUs, stepUs, dmaChannel);
+}
+
+bool DmaSoftPWM::beginLocked(uint32_t cycleUs, uint32_t stepUs, int dmaChannel) {
+    if (pacer_) {
+        if (cycleUs != cycleUs_ || stepUs != stepUs_) {
+            PIPINPP_LOG_ERROR("DmaSoftPWM already running with " << cycleUs_ << " µs cycle, "
+                              << stepUs_ << " µs step; call end() first");
+            return false;
+        }
+        return true;
+    }
+
+    if (stepUs < 2 || cycleUs == 0 || cycleUs % stepUs != 0) {
+        PIPINPP_LOG_ERROR("Invalid DmaSoftPWM timing: cycle " << cycleUs << " µs, step "
+                          << stepUs << " µs (cycle must be a multiple of a step of 2 µs or more)");
+        return false;
+    }
+    uint32_t ticks = cycleUs / stepUs;
+    if (ticks < 2 || ticks > DMA_SOFT_PWM_MAX_TICKS) {
+        PIPINPP_LOG_ERROR("DmaSoftPWM cycle has " << ticks << " steps (2-"
+                          << DMA_SOFT_PWM_MAX_TICKS << " supported)");
+        return false;
+    }
+    if (dmaChannel < 0 || dmaChannel > 14) {
+        PIPINPP_LOG_ERROR("Invalid DMA channel " << dmaChannel << ": valid range is 0-14");
+        return false;
+    }
+
+    try {
+        gpio_.reset(new PeripheralMap(dma::GPIO_OFFSET));
+        pacer_.reset(new PwmPacer());
+        dma_.reset(new DmaChannel(dmaChannel));
+        memory_.reset(new DmaMemory(memoryBytes(ticks)));
+    } catch (const PinError& e) {
+        PIPINPP_LOG_ERROR("DmaSoftPWM unavailable: " << e.what());
+        (void)e; // Only used when logging is enabled
+        memory_.reset();
+        dma_.reset();
+        pacer_.reset();
+        gpio_.reset();
+        return false;
+    }
+
+    uint32_t clockHz = pacer_->setClock(TICK_CLOCK_HZ);
+    if (clockHz == 0) {
+        memory_.reset();
+        dma_.reset();
+        pacer_.reset();
+        gpio_.reset();
+        return false;
+    }
+    uint32_t range = static_cast<uint32_t>((static_cast<uint64_t>(stepUs) * clockHz + 500000) / 1000000);
+
+    // Layout: [3 control blocks per tick][set masks][clear masks][FIFO word]
+    auto* cbs = static_cast<DmaControlBlock*>(memory_->virt());
+    auto* masks = reinterpret_cast<uint32_t*>(cbs + ticks * BLOCKS_PER_TICK);
+    setMasks_ = masks;
+    clearMasks_ = masks + ticks;
+    uint32_t* fifoWord = masks + 2 * ticks;
+
+    const uint32_t setBus = dma::busAddress(dma::GPIO_OFFSET, dma::GPSET0);
+    const uint32_t clearBus = dma::busAddress(dma::GPIO_OFFSET, dma::GPCLR0);
+    const uint32_t gpioTi = dma::DMA_TI_NO_WIDE_BURSTS | dma::DMA_TI_WAIT_RESP;
+    const uint32_t delayTi = gpioTi | dma::DMA_TI_DEST_DREQ |
+                             (dma::DMA_PERMAP_PWM << dma::DMA_TI_PERMAP_SHIFT);
+
+    const uint32_t blocks = ticks * BLOCKS_PER_TICK;
+    for (uint32_t i = 0; i < ticks; ++i) {
+        DmaControlBlock* cb = cbs + i * BLOCKS_PER_TICK;
+        cb[0] = {gpioTi, memory_->busAddress(masks + i), setBus, 4, 0,
+                 memory_->busAddress(&cb[1]), {0, 0}};
+        cb[1] = {gpioTi, memory_->busAddress(masks + ticks + i), clearBus, 4, 0,
+                 memory_->busAddress(&cb[2]), {0, 0}};
+        cb[2] = {delayTi, memory_->busAddress(fifoWord), PwmPacer::fifoBusAddress(), 4, 0,
+                 memory_->busAddress(cbs + (i * BLOCKS_PER_TICK + BLOCKS_PER_TICK) % blocks), {0, 0}};
+    }
+
+    pacer_->startFifo(0, range);
+    dma_->start(memory_->busAddress(cbs));
+
+    cycleUs_ = cycleUs;
+    stepUs_ = stepUs;
+    ticks_ = ticks;
+
+    PIPINPP_LOG_INFO("DmaSoftPWM started: " << cycleUs_ << " µs cycle, " << stepUs_
+                     << " µs step (" << ticks_ << " steps), DMA channel " << dmaChannel);
+    return true;
+}
+
+void DmaSoftPWM::end() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    endLocked();
+}
+
+void DmaSoftPWM::endLocked() {
+    if (!pacer_) {
+        return;
+    }
+
+    dma_->stop();
+    pacer_->stop();
+
+    uint32_t active = 0;
+    for (int pin = 0; pin < NUM_PINS; ++pin) {
+        if (clearTick_[pin] != OFF) {
+            active |= 1u << pin;
+        }
+    }
+    gpio_->regs()[dma::GPCLR0] = active;
+    for (int pin = 0; pin < NUM_PINS; ++pin) {
+        if (clearTick_[pin] != OFF) {
+            setPinFunction(pin, savedFunction_[pin]);
+            clearTick_[pin] = OFF;
+        }
+    }
+
+    setMasks_ = nullptr;
+    clearMasks_ = nullptr;
+    dma_.reset();
+    pacer_.reset();
+    memory_.reset();
+    gpio_.reset();
+    cycleUs_ = 0;
+    stepUs_ = 0;
+    ticks_ = 0;
+
+    PIPINPP_LOG_DEBUG("DmaSoftPWM stopped");
+}
+
+bool DmaSoftPWM::isBegun() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pacer_ != nullptr;
+}
+
+bool DmaSoftPWM::setDutyCycle(int pin, double percent) {
+    validatePin(pin);
+    if (std::isnan(percent) || percent < 0.0 || percent > 100.0) {
+        PIPINPP_LOG_ERROR("Duty cycle out of range: " << percent << "%");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pacer_ && !beginLocked(DMA_SOFT_PWM_DEFAULT_CYCLE_US, DMA_SOFT_PWM_DEFAULT_STEP_US,
+                                DEFAULT_DMA_CHANNEL)) {
+        return false;
+    }
+    applyWidth(pin, static_cast<uint32_t>(std::lround(percent * ticks_ / 100.0)));
+    return true;
+}
+
+bool DmaSoftPWM::setPulseWidthUs(int pin, uint32_t widthUs) {
+    validatePin(pin);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pacer_ && !beginLocked(DMA_SOFT_PWM_DEFAULT_CYCLE_US, DMA_SOFT_PWM_DEFAULT_STEP_US,
+                                DEFAULT_DMA_CHANNEL)) {
+        return false;
+    }
+    applyWidth(pin, widthToTicks(widthUs, stepUs_, ticks_));
+    return true;
+}
+
+bool DmaSoftPWM::analogWrite(int pin, int value) {
+    value = std::clamp(value, 0, 255);
+    return setDutyCycle(pin, value * 100.0 / 255.0);
+}
+
+void DmaSoftPWM::applyWidth(int pin, uint32_t clearTick) {
+    const uint32_t bit = 1u << pin;
+    const uint32_t oldTick = clearTick_[pin];
+
+    if (oldTick == OFF) {
+        // Claim the pin: start low, then switch it to output
+        volatile uint32_t* gpio = gpio_->regs();
+        savedFunction_[pin] = (gpio[dma::GPFSEL0 + pin / 10] >> ((pin % 10) * 3)) & 7u;
+        gpio[dma::GPCLR0] = bit;
+        setPinFunction(pin, GPIO_FUNCTION_OUTPUT);
+    }
+
+    // Going to 0%: stop setting before moving the clear
+    if (clearTick == 0) {
+        setMasks_[0] &= ~bit;
+    }
+
+    // Add the new clear before removing the old one so no cycle goes uncleared
+    if (clearTick < ticks_) {
+        clearMasks_[clearTick] |= bit;
+    }
+    if (oldTick != OFF && oldTick < ticks_ && oldTick != clearTick) {
+        clearMasks_[oldTick] &= ~bit;
+    }
+
+    if (clearTick > 0) {
+        setMasks_[0] |= bit;
+    }
+
+    clearTick_[pin] = clearTick;
+}
+
+bool DmaSoftPWM::stopPWM(int pin) {
+    if (pin < 0 || pin >= NUM_PINS) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pacer_ || clearTick_[pin] == OFF) {
+        return false;
+    }
+
+    // Hold the pin at 0% for a full cycle (plus FIFO lead) so the DMA cannot
+    // set it again after it is released
+    applyWidth(pin, 0);
+    std::this_thread::sleep_for(std::chrono::microseconds(cycleUs_ + stepUs_ * FIFO_DEPTH));
+
+    const uint32_t bit = 1u << pin;
+    clearMasks_[0] &= ~bit;
+    gpio_->regs()[dma::GPCLR0] = bit;
+    setPinFunction(pin, savedFunction_[pin]);
+    clearTick_[pin] = OFF;
+    return true;
+}
+
+bool DmaSoftPWM::isActive(int pin) const {
+    if (pin < 0 || pin >= NUM_PINS) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return clearTick_[pin] != OFF;
+}
+
+double DmaSoftPWM::getDutyCycle(int pin) const {
+    if (pin < 0 || pin >= NUM_PINS) {
+        return -1.0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (clearTick_[pin] == OFF || ticks_ == 0) {
+        return -1.0;
+    }
+    return 100.0 * clearTick_[pin] / ticks_;
+}
+
+size_t DmaSoftPWM::getActiveCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(std::begin(clearTick_), std::end(clearTick_),
+                                             [](uint32_t tick) { return tick != OFF; }));
+}
+
+uint32_t DmaSoftPWM::getCycleUs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cycleUs_;
+}
+
+uint32_t DmaSoftPWM::getStepUs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stepUs_;
+}
+
+void DmaSoftPWM::setPinFunction(int pin, uint32_t function) {
+    volatile uint32_t* reg = gpio_->regs() + dma::GPFSEL0 + pin / 10;
+    uint32_t shift = (pin % 10) * 3;
+    *reg = (*reg & ~(7u << shift)) | ((function & 7u) << shift);
+}
+
+} // namespace pipinpp
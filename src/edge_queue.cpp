@@ -0,0 +1,122 @@
+/**
+ * @file edge_queue.cpp
+ * @brief Queued edge delivery through a lock-free ring and an eventfd
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "edge_queue.hpp"
+#include "exceptions.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace pipinpp {
+
+EdgeQueue::EdgeQueue(size_t capacity) : ring_(capacity) {
+    eventFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd_ < 0) {
+        throw GpioAccessError("eventfd", std::strerror(errno));
+    }
+}
+
+EdgeQueue::~EdgeQueue() {
+    for (int pin : getPins()) {
+        detach(pin);
+    }
+    ::close(eventFd_);
+}
+
+void EdgeQueue::attach(int pin, InterruptMode mode, size_t bufferSize, const std::string& chipname) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    InterruptManager::getInstance().attachInterruptBatch(
+        pin, [this](EdgeEventSpan events) { push(events); }, mode, bufferSize, chipname);
+    pins_.push_back(pin);
+}
+
+bool EdgeQueue::detach(int pin) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(pins_.begin(), pins_.end(), pin);
+    if (it == pins_.end()) {
+        return false;
+    }
+    pins_.erase(it);
+    // No push() runs for this pin once detachInterrupt() returns
+    InterruptManager::getInstance().detachInterrupt(pin);
+    return true;
+}
+
+std::vector<int> EdgeQueue::getPins() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pins_;
+}
+
+void EdgeQueue::push(const EdgeEventSpan& events) {
+    // Monitor thread: the ring's single producer
+    const size_t stored = ring_.push(events.data(), events.size());
+    if (stored < events.size()) {
+        dropped_.fetch_add(events.size() - stored, std::memory_order_relaxed);
+        PIPINPP_LOG_WARNING("Edge queue full, dropped " << events.size() - stored << " events");
+    }
+    if (stored > 0) {
+        const uint64_t one = 1;
+        ssize_t written = ::write(eventFd_, &one, sizeof(one));
+        (void)written;  // Only fails when the counter is saturated, i.e. already readable
+    }
+}
+
+size_t EdgeQueue::poll(EdgeEvent* out, size_t max) {
+    // Reset readiness before popping: anything pushed after this read
+    // writes the eventfd again, so no wakeup is lost
+    uint64_t counter = 0;
+    ssize_t got = ::read(eventFd_, &counter, sizeof(counter));
+    (void)got;
+    const size_t count = ring_.pop(out, max);
+    if (!ring_.empty()) {
+        // Left over for the next poll(): keep the fd readable
+        const uint64_t one = 1;
+        ssize_t written = ::write(eventFd_, &one, sizeof(one));
+        (void)written;
+    }
+    return count;
+}
+
+bool EdgeQueue::wait(int timeoutMs) const {
+    if (!ring_.empty()) {
+        return true;
+    }
+    struct pollfd pfd = {eventFd_, POLLIN, 0};
+    int result;
+    do {
+        result = ::poll(&pfd, 1, timeoutMs);
+    } while (result < 0 && errno == EINTR);
+    return !ring_.empty();
+}
+
+} // namespace pipinpp
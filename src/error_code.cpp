@@ -0,0 +1,69 @@
+/**
+ * @file error_code.cpp
+ * @brief GpioErrc error category
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "error_code.hpp"
+#include <string>
+
+namespace pipinpp {
+
+namespace {
+
+class GpioCategory : public std::error_category {
+public:
+    const char* name() const noexcept override { return "pipinpp"; }
+
+    std::string message(int value) const override {
+        switch (static_cast<GpioErrc>(value)) {
+            case GpioErrc::INVALID_PIN:      return "invalid pin number";
+            case GpioErrc::NOT_CONFIGURED:   return "pin not initialized, call pinMode() first";
+            case GpioErrc::WRONG_DIRECTION:  return "pin is not configured for this operation";
+            case GpioErrc::INVALID_ARGUMENT: return "invalid argument";
+            case GpioErrc::NOT_OPEN:         return "device not open";
+            case GpioErrc::ACCESS_FAILED:    return "GPIO access failed";
+        }
+        return "unknown error";
+    }
+
+    std::error_condition default_error_condition(int value) const noexcept override {
+        switch (static_cast<GpioErrc>(value)) {
+            case GpioErrc::INVALID_PIN:
+            case GpioErrc::INVALID_ARGUMENT: return std::errc::invalid_argument;
+            case GpioErrc::NOT_OPEN:         return std::errc::bad_file_descriptor;
+            case GpioErrc::ACCESS_FAILED:    return std::errc::io_error;
+            default:                         return std::error_condition(value, *this);
+        }
+    }
+};
+
+} // namespace
+
+const std::error_category& gpioCategory() noexcept {
+    static const GpioCategory category;
+    return category;
+}
+
+} // namespace pipinpp
@@ -0,0 +1,329 @@
+/**
+ * @file event_loop.cpp
+ * @brief epoll-based EventLoop: source registration, timerfds and dispatch
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "event_loop.hpp"
+#include "exceptions.hpp"
+#include "log.hpp"
+#include "thread_policy.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint64_t WAKE_ID = 0;            // epoll data of the stop() eventfd
+constexpr int MAX_EVENTS = 32;
+constexpr size_t EDGE_BATCH = 16;
+
+timespec toTimespec(uint64_t ns) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000ull);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000ull);
+    return ts;
+}
+
+} // namespace
+
+EventLoop::EventLoop() : epollFd_(-1), wakeFd_(-1), nextId_(1), stopRequested_(false) {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        throw GpioAccessError("epoll", strerror(errno));
+    }
+    wakeFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd_ < 0) {
+        int error = errno;
+        close(epollFd_);
+        throw GpioAccessError("eventfd", strerror(error));
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_ID;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+}
+
+EventLoop::~EventLoop() {
+    {
+        std::lock_guard<std::mutex> lock(workMutex_);
+        workerRunning_ = false;
+    }
+    workCv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    for (auto& entry : sources_) {
+        if (entry.second->kind == Kind::TIMER) {
+            close(entry.second->fd);
+        }
+    }
+    close(wakeFd_);
+    close(epollFd_);
+}
+
+int EventLoop::add(int fd, uint32_t events, std::shared_ptr<Source> source) {
+    int id = nextId_++;
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = static_cast<uint64_t>(id);
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        PIPINPP_LOG_WARNING("EventLoop: cannot watch fd " << fd << ": " << strerror(errno));
+        return -1;
+    }
+    source->fd = fd;
+    sources_.emplace(id, std::move(source));
+    return id;
+}
+
+int EventLoop::addFd(int fd, uint32_t events, EventLoopFdCallback callback) {
+    if (fd < 0 || !callback) {
+        return -1;
+    }
+    auto source = std::make_shared<Source>();
+    source->kind = Kind::FD;
+    source->onReady = std::move(callback);
+    return add(fd, events, std::move(source));
+}
+
+int EventLoop::addPin(Pin& pin, EventLoopEdgeCallback callback) {
+    if (!callback || (!pin.edgeEventsEnabled() && !pin.enableEdgeEvents(true))) {
+        return -1;
+    }
+    auto source = std::make_shared<Source>();
+    source->kind = Kind::PIN;
+    source->pin = &pin;
+    source->onEdge = std::move(callback);
+    return add(pin.getEventFd(), EPOLLIN, std::move(source));
+}
+
+int EventLoop::addSerial(SerialPort& port, EventLoopCallback callback) {
+    if (!callback || port.getFd() < 0) {
+        return -1;
+    }
+    return addFd(port.getFd(), EPOLLIN, [callback = std::move(callback)](uint32_t) { callback(); });
+}
+
+int EventLoop::every(uint64_t periodUs, EventLoopCallback callback) {
+    return periodUs == 0 ? -1 : addTimer(periodUs, periodUs, std::move(callback));
+}
+
+int EventLoop::after(uint64_t delayUs, EventLoopCallback callback) {
+    return addTimer(delayUs, 0, std::move(callback));
+}
+
+int EventLoop::addTimer(uint64_t delayUs, uint64_t periodUs, EventLoopCallback callback) {
+    if (!callback) {
+        return -1;
+    }
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (fd < 0) {
+        PIPINPP_LOG_WARNING("EventLoop: timerfd_create failed: " << strerror(errno));
+        return -1;
+    }
+
+    // Absolute first deadline; the kernel keeps later ones on the fixed grid
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t nowNs = static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+    itimerspec spec{};
+    spec.it_value = toTimespec(nowNs + (delayUs > 0 ? delayUs * 1000 : 1));
+    spec.it_interval = toTimespec(periodUs * 1000);
+    if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+        PIPINPP_LOG_WARNING("EventLoop: timerfd_settime failed: " << strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    auto source = std::make_shared<Source>();
+    source->kind = Kind::TIMER;
+    source->onTimer = std::move(callback);
+    source->oneShot = periodUs == 0;
+    int id = add(fd, EPOLLIN, std::move(source));
+    if (id < 0) {
+        close(fd);
+    }
+    return id;
+}
+
+bool EventLoop::remove(int id) {
+    auto it = sources_.find(id);
+    if (it == sources_.end()) {
+        return false;
+    }
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->second->fd, nullptr);
+    if (it->second->kind == Kind::TIMER) {
+        close(it->second->fd);
+    }
+    sources_.erase(it);                    // A running callback keeps its Source alive
+    return true;
+}
+
+uint64_t EventLoop::getTimerOverruns(int id) const {
+    auto it = sources_.find(id);
+    return it == sources_.end() ? 0 : it->second->overruns;
+}
+
+void EventLoop::dispatch(int id, uint32_t events) {
+    auto it = sources_.find(id);
+    if (it == sources_.end()) {
+        return;                            // Removed by an earlier callback in this batch
+    }
+    std::shared_ptr<Source> source = it->second;
+
+    switch (source->kind) {
+    case Kind::FD:
+        source->onReady(events);
+        break;
+
+    case Kind::PIN: {
+        PinEdgeEvent edges[EDGE_BATCH];
+        int count = source->pin->waitEdgeEvents(edges, EDGE_BATCH, 0);
+        for (int i = 0; i < count && sources_.count(id) != 0; ++i) {
+            source->onEdge(edges[i]);
+        }
+        break;
+    }
+
+    case Kind::TIMER: {
+        uint64_t expirations = 0;
+        if (read(source->fd, &expirations, sizeof(expirations)) != sizeof(expirations) || expirations == 0) {
+            return;
+        }
+        source->overruns += expirations - 1;
+        if (source->oneShot) {
+            remove(id);
+        }
+        source->onTimer();
+        break;
+    }
+    }
+}
+
+int EventLoop::runOnce(int timeoutMs) {
+    epoll_event events[MAX_EVENTS];
+    int ready = epoll_wait(epollFd_, events, MAX_EVENTS, timeoutMs);
+    if (ready < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        PIPINPP_LOG_WARNING("EventLoop: epoll_wait failed: " << strerror(errno));
+        return -1;
+    }
+
+    int dispatched = 0;
+    for (int i = 0; i < ready; ++i) {
+        if (events[i].data.u64 == WAKE_ID) {
+            uint64_t value;
+            while (read(wakeFd_, &value, sizeof(value)) == sizeof(value)) {
+            }
+            dispatched += runPosted();
+            continue;
+        }
+        dispatch(static_cast<int>(events[i].data.u64), events[i].events);
+        ++dispatched;
+    }
+    return dispatched;
+}
+
+void EventLoop::run() {
+    while (!stopRequested_.load(std::memory_order_acquire)) {
+        if (runOnce(-1) < 0) {
+            break;
+        }
+    }
+    stopRequested_.store(false, std::memory_order_release);
+}
+
+void EventLoop::post(EventLoopCallback callback) {
+    if (!callback) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(postMutex_);
+        posted_.push_back(std::move(callback));
+    }
+    uint64_t one = 1;
+    if (write(wakeFd_, &one, sizeof(one)) < 0) {
+        PIPINPP_LOG_DEBUG("EventLoop: wake write failed: " << strerror(errno));
+    }
+}
+
+int EventLoop::runPosted() {
+    std::vector<EventLoopCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(postMutex_);
+        callbacks.swap(posted_);
+    }
+    for (auto& callback : callbacks) {
+        callback();
+    }
+    return static_cast<int>(callbacks.size());
+}
+
+void EventLoop::runBlocking(EventLoopCallback work, EventLoopCallback done) {
+    std::lock_guard<std::mutex> lock(workMutex_);
+    work_.emplace_back(std::move(work), std::move(done));
+    if (!workerRunning_) {
+        workerRunning_ = true;
+        worker_ = std::thread(&EventLoop::workerThread, this);
+    }
+    workCv_.notify_one();
+}
+
+void EventLoop::workerThread() {
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-loopio", false);
+
+    std::unique_lock<std::mutex> lock(workMutex_);
+    while (true) {
+        workCv_.wait(lock, [this] { return !workerRunning_ || !work_.empty(); });
+        if (!workerRunning_) {
+            return;
+        }
+        auto item = std::move(work_.front());
+        work_.pop_front();
+        lock.unlock();
+        if (item.first) {
+            item.first();
+        }
+        post(std::move(item.second));
+        lock.lock();
+    }
+}
+
+void EventLoop::stop() {
+    stopRequested_.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    if (write(wakeFd_, &one, sizeof(one)) < 0) {
+        PIPINPP_LOG_DEBUG("EventLoop: wake write failed: " << strerror(errno));
+    }
+}
+
+} // namespace pipinpp
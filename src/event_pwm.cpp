@@ -27,9 +27,15 @@
 
 #include "event_pwm.hpp"
 #include "exceptions.hpp"
+#include "board.hpp"
 #include "log.hpp"
+#include "metrics.hpp"
+#include "thread_policy.hpp"
+#include "transaction.hpp"
+#include "pwm_timing.hpp"
 #include <algorithm>
 #include <chrono>
+#include <functional>
 #include <sstream>
 
 namespace pipinpp {
@@ -40,7 +46,7 @@ EventPWM::EventPWM(int pin)
     : pin_(pin), active_(false), dutyCycle_(0.0), frequencyHz_(490.0) {
     
     // Validate pin number
-    if (pin < 0 || pin > 27) {
+    if (!isValidGpioPin(pin)) {
         throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
                             " (must be 0-27 for Raspberry Pi)");
     }
@@ -108,9 +114,12 @@ void EventPWM::end() {
         pwmThread_.join();
     }
     
-    // Set pin LOW
+    // Set pin LOW, even inside a Transaction
     if (pinObj_) {
-        pinObj_->write(false);
+        {
+            pipinpp::ScopedTransactionBypass direct;
+            pinObj_->write(false);
+        }
         pinObj_.reset();
     }
     
@@ -158,44 +167,42 @@ bool EventPWM::isActive() const {
 
 void EventPWM::pwmThreadFunction() {
     PIPINPP_LOG_DEBUG("EventPWM thread started for pin " << pin_);
+    pipinpp::ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-epwm" + std::to_string(pin_));
+    
+    // Integer deadlines, recomputed only when duty or frequency change
+    PwmEdgeClock clock(BUSYWAIT_THRESHOLD_US * 1000);
+    PwmTiming timing;
+    double lastFreq = -1.0;
+    double lastDuty = -1.0;
     
     while (active_) {
         double freq = frequencyHz_.load();
         double duty = dutyCycle_.load();
-        
-        // Calculate period in nanoseconds
-        long periodNs = static_cast<long>(1000000000.0 / freq);
-        long onTimeNs = static_cast<long>((periodNs * duty) / 100.0);
-        long offTimeNs = periodNs - onTimeNs;
+        if (freq != lastFreq || duty != lastDuty) {
+            // < 0.1% is always off, > 99.9% always on
+            timing = PwmTiming::fromPercent(freq, duty <= 0.1 ? 0.0 : (duty >= 99.9 ? 100.0 : duty));
+            lastFreq = freq;
+            lastDuty = duty;
+        }
         
         // Handle edge cases
-        if (duty <= 0.1) {
-            // Always off (< 0.1% duty)
-            pinObj_->write(false);
-            hybridSleep(periodNs);
-            continue;
-        } else if (duty >= 99.9) {
-            // Always on (> 99.9% duty)
-            pinObj_->write(true);
-            hybridSleep(periodNs);
+        if (timing.alwaysLow() || timing.alwaysHigh()) {
+            pinObj_->write(timing.alwaysHigh());
+            clock.waitUntil(timing.periodNs, active_);
+            clock.nextCycle(timing.periodNs);
             continue;
         }
         
-        // Get absolute time for cycle start
-        struct timespec cycleStart;
-        clock_gettime(CLOCK_MONOTONIC, &cycleStart);
-        
         // HIGH period
         pinObj_->write(true);
-        if (onTimeNs > 0) {
-            hybridSleep(onTimeNs);
+        if (!clock.waitUntil(timing.onNs, active_)) {
+            break;
         }
         
-        // LOW period
+        // LOW period until the next absolute cycle start
         pinObj_->write(false);
-        if (offTimeNs > 0) {
-            hybridSleep(offTimeNs);
-        }
+        clock.waitUntil(timing.periodNs, active_);
+        clock.nextCycle(timing.periodNs);
     }
     
     // Ensure pin is LOW when stopping
@@ -206,49 +213,97 @@ void EventPWM::pwmThreadFunction() {
     PIPINPP_LOG_DEBUG("EventPWM thread stopped for pin " << pin_);
 }
 
-void EventPWM::hybridSleep(long durationNs) {
-    const long BUSYWAIT_THRESHOLD_NS = BUSYWAIT_THRESHOLD_US * 1000;
+// EventPWMSchedule Implementation
+
+void EventPWMSchedule::add(int value, int frequencyHz) {
+    heap_.clear();
+    channels_.push_back({value, frequencyHz, 0, 0, false});
+}
+
+void EventPWMSchedule::remove(size_t channel) {
+    heap_.clear();
+    channels_.erase(channels_.begin() + channel);
+}
+
+void EventPWMSchedule::clear() {
+    heap_.clear();
+    channels_.clear();
+}
+
+bool EventPWMSchedule::update(size_t channel, int value, int frequencyHz, int64_t nowNs) {
+    Channel& state = channels_[channel];
+    state.value = value;
+    state.frequencyHz = frequencyHz;
+    if (state.scheduled) {
+        return false;
+    }
     
-    if (durationNs <= BUSYWAIT_THRESHOLD_NS) {
-        // Duration is short - pure busy-wait for precision
-        auto start = std::chrono::high_resolution_clock::now();
-        auto target = start + std::chrono::nanoseconds(durationNs);
-        
-        while (std::chrono::high_resolution_clock::now() < target && active_) {
-            std::this_thread::yield();
-        }
+    // Held at 0% or 100%: restart its cycle now
+    state.scheduled = true;
+    push({nowNs, channel, true});
+    return true;
+}
+
+void EventPWMSchedule::restart(int64_t nowNs) {
+    heap_.clear();
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        channels_[i].scheduled = true;
+        heap_.push_back({nowNs, i, true});
+    }
+    std::make_heap(heap_.begin(), heap_.end(), std::greater<Edge>());
+}
+
+void EventPWMSchedule::takeDue(int64_t nowNs, uint64_t& mask, uint64_t& values) {
+    mask = 0;
+    values = 0;
+    while (!heap_.empty() && heap_.front().deadlineNs <= nowNs + EDGE_COALESCE_NS) {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Edge>());
+        Edge edge = heap_.back();
+        heap_.pop_back();
+        // Coalesced edges can go out slightly early; those count as on time
+        PIPINPP_METRIC_RECORD("pwm_edge_lateness_ns",
+                              static_cast<uint64_t>(std::max<int64_t>(0, nowNs - edge.deadlineNs)));
+        processEdge(edge, nowNs, mask, values);
+    }
+}
+
+void EventPWMSchedule::push(const Edge& edge) {
+    heap_.push_back(edge);
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<Edge>());
+}
+
+void EventPWMSchedule::processEdge(const Edge& edge, int64_t nowNs, uint64_t& mask, uint64_t& values) {
+    Channel& channel = channels_[edge.channel];
+    uint64_t bit = 1ULL << edge.channel;
+    mask |= bit;
+    
+    if (!edge.rising) {
+        // Falling edge (also when coalesced with this cycle's rising edge);
+        // next cycle starts one period after this one
+        values &= ~bit;
+        push({channel.cycleStartNs + channel.periodNs, edge.channel, true});
         return;
     }
     
-    // Duration is long - hybrid approach
-    // 1. Sleep most of the duration using clock_nanosleep()
-    long sleepNs = durationNs - BUSYWAIT_THRESHOLD_NS;
-    
-    struct timespec req;
-    clock_gettime(CLOCK_MONOTONIC, &req);
-    
-    // Add sleep duration to current time
-    req.tv_nsec += sleepNs;
-    
-    // Handle nanosecond overflow
-    if (req.tv_nsec >= 1000000000) {
-        req.tv_sec += req.tv_nsec / 1000000000;
-        req.tv_nsec = req.tv_nsec % 1000000000;
+    // Cycle start: latch the current duty and frequency
+    channel.periodNs = 1000000000LL / channel.frequencyHz;
+    channel.cycleStartNs = edge.deadlineNs;
+    if (nowNs - channel.cycleStartNs >= channel.periodNs) {
+        channel.cycleStartNs = nowNs; // Fell a whole cycle behind: resynchronize
     }
     
-    // Sleep using absolute time (immune to system time changes)
-    if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &req, nullptr) != 0) {
-        // Sleep interrupted or error - fall back to busy-wait
-        PIPINPP_LOG_DEBUG("clock_nanosleep interrupted, using busy-wait");
+    if (channel.value == 0 || channel.value == 255) {
+        // Constant level: write once and stop scheduling until the next update
+        if (channel.value == 255) {
+            values |= bit;
+        }
+        channel.scheduled = false;
+        return;
     }
     
-    // 2. Busy-wait the final threshold microseconds for precision
-    auto busyStart = std::chrono::high_resolution_clock::now();
-    auto busyTarget = busyStart + std::chrono::nanoseconds(BUSYWAIT_THRESHOLD_NS);
-    
-    while (std::chrono::high_resolution_clock::now() < busyTarget && active_) {
-        std::this_thread::yield();
-    }
+    values |= bit;
+    int64_t onNs = (channel.periodNs * channel.value) / 255;
+    push({channel.cycleStartNs + onNs, edge.channel, false});
 }
 
 // EventPWMManager Implementation
@@ -260,8 +315,31 @@ EventPWMManager& EventPWMManager::getInstance() {
 
 EventPWMManager::~EventPWMManager() {
     PIPINPP_LOG_DEBUG("EventPWMManager shutting down");
+    
+    std::thread scheduler;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        scheduler = std::move(scheduler_);
+    }
+    cv_.notify_all();
+    if (scheduler.joinable()) {
+        scheduler.join();
+    }
+    
+    // Leave every channel LOW
     std::lock_guard<std::mutex> lock(mutex_);
-    channels_.clear(); // Destructors will stop all PWM
+    if (group_) {
+        group_->writeAll(0);
+        group_.reset();
+    }
+    pins_.clear();
+    schedule_.clear();
+}
+
+int64_t EventPWMManager::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 void EventPWMManager::analogWriteEvent(int pin, int value, int frequencyHz) {
@@ -272,52 +350,143 @@ void EventPWMManager::analogWriteEvent(int pin, int value, int frequencyHz) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     // Check if PWM already exists
-    auto it = channels_.find(pin);
-    if (it != channels_.end()) {
-        // Update existing PWM
-        it->second->setDutyCycle8Bit(static_cast<uint8_t>(value));
-        it->second->setFrequency(static_cast<double>(frequencyHz));
+    auto existing = std::find(pins_.begin(), pins_.end(), pin);
+    if (existing != pins_.end()) {
+        // Update existing PWM; picked up at the next cycle start
+        if (schedule_.update(existing - pins_.begin(), value, frequencyHz, nowNs())) {
+            changed_ = true;
+            cv_.notify_one();
+        }
         return;
     }
     
-    // Create new EventPWM
+    // New channel: all lines are re-requested as one group
+    pins_.push_back(pin);
+    schedule_.add(value, frequencyHz);
     try {
-        auto pwm = std::make_unique<EventPWM>(pin);
-        double dutyCycle = (static_cast<double>(value) / 255.0) * 100.0;
-        
-        if (!pwm->begin(static_cast<double>(frequencyHz), dutyCycle)) {
-            PIPINPP_LOG_ERROR("Failed to start EventPWM on pin " << pin);
-            return;
-        }
-        
-        channels_[pin] = std::move(pwm);
-        
+        rebuildGroup();
     } catch (const std::exception& e) {
         PIPINPP_LOG_ERROR("Failed to create EventPWM on pin " << pin << ": " << e.what());
+        pins_.pop_back();
+        schedule_.remove(pins_.size());
+        try {
+            rebuildGroup();
+        } catch (const std::exception& restoreError) {
+            PIPINPP_LOG_ERROR("Failed to restore EventPWM channels: " << restoreError.what());
+            pins_.clear();
+            schedule_.clear();
+            group_.reset();
+        }
+        return;
+    }
+    
+    if (!running_) {
+        running_ = true;
+        scheduler_ = std::thread(&EventPWMManager::schedulerThread, this);
     }
+    
+    PIPINPP_LOG_INFO("Started EventPWM on pin " << pin << ": " << frequencyHz << " Hz, value " << value);
 }
 
 bool EventPWMManager::stopPWM(int pin) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = channels_.find(pin);
-    if (it == channels_.end()) {
+    auto it = std::find(pins_.begin(), pins_.end(), pin);
+    if (it == pins_.end()) {
         return false;
     }
+    size_t channel = it - pins_.begin();
+    
+    // Leave the pin LOW before its line is released
+    if (group_) {
+        group_->writeMask(1ULL << channel, 0);
+    }
+    
+    pins_.erase(it);
+    schedule_.remove(channel);
+    try {
+        rebuildGroup();
+    } catch (const std::exception& e) {
+        PIPINPP_LOG_ERROR("Failed to re-request EventPWM channels, stopping all: " << e.what());
+        pins_.clear();
+        schedule_.clear();
+        group_.reset();
+    }
     
-    channels_.erase(it);
     PIPINPP_LOG_INFO("Stopped EventPWM on pin " << pin);
     return true;
 }
 
 bool EventPWMManager::isActive(int pin) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return channels_.find(pin) != channels_.end();
+    return std::find(pins_.begin(), pins_.end(), pin) != pins_.end();
 }
 
 size_t EventPWMManager::getActiveCount() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return channels_.size();
+    return pins_.size();
+}
+
+void EventPWMManager::rebuildGroup() {
+    // Release the old lines before requesting the new set
+    group_.reset();
+    changed_ = true;
+    cv_.notify_one();
+    
+    if (pins_.empty()) {
+        return;
+    }
+    
+    group_ = std::make_unique<PinGroup>(pins_, PinDirection::OUTPUT);
+    
+    // Restart every channel in phase
+    schedule_.restart(nowNs());
+}
+
+void EventPWMManager::schedulerThread() {
+    PIPINPP_LOG_DEBUG("EventPWM scheduler thread started");
+    pipinpp::ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-epwm");
+    
+    const int64_t BUSYWAIT_THRESHOLD_NS = BUSYWAIT_THRESHOLD_US * 1000;
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    while (running_) {
+        changed_ = false;
+        if (schedule_.idle()) {
+            cv_.wait(lock, [this] { return !running_ || changed_; });
+            continue;
+        }
+        
+        // 1. Sleep until shortly before the earliest edge (woken early on changes)
+        int64_t deadline = schedule_.nextDeadlineNs();
+        auto wakeAt = std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(deadline - BUSYWAIT_THRESHOLD_NS));
+        if (cv_.wait_until(lock, wakeAt, [this] { return !running_ || changed_; })) {
+            continue;
+        }
+        
+        // 2. Busy-wait the final threshold without holding the lock
+        lock.unlock();
+        while (nowNs() < deadline) {
+            std::this_thread::yield();
+        }
+        lock.lock();
+        if (!running_ || changed_) {
+            continue;
+        }
+        
+        // 3. Everything due now goes out in one multi-line write
+        int64_t now = nowNs();
+        uint64_t mask = 0;
+        uint64_t values = 0;
+        schedule_.takeDue(now, mask, values);
+        
+        if (mask != 0 && group_) {
+            group_->writeMask(mask, values);
+        }
+    }
+    
+    PIPINPP_LOG_DEBUG("EventPWM scheduler thread stopped");
 }
 
 } // namespace pipinpp
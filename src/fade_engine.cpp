@@ -0,0 +1,251 @@
+/**
+ * @file fade_engine.cpp
+ * @brief Implementation of timer-driven LED fades
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "fade_engine.hpp"
+#include "board.hpp"
+#include "exceptions.hpp"
+#include "log.hpp"
+#include "pwm_backend.hpp"
+#include "timebase.hpp"
+#include "timer_manager.hpp"
+#include <cmath>
+#include <string>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint32_t ONE = 65536;                  // 1.0 in curve fixed point
+
+void validatePin(int pin) {
+    if (!isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) +
+                              " (must be 0-27 for Raspberry Pi)");
+    }
+}
+
+} // namespace
+
+FadeEngine& FadeEngine::getInstance() {
+    static FadeEngine instance;
+    return instance;
+}
+
+FadeEngine::FadeEngine(FadeOutput output, TimerManager* timers)
+    : output_(std::move(output)),
+      // Taking the singletons now makes them outlive a static engine
+      timers_(timers ? timers : &TimerManager::getInstance()) {
+    if (!output_) {
+        PwmRouter& router = PwmRouter::getInstance();
+        output_ = [this, &router](int pin, uint8_t value) { router.write(pin, value, frequencyHz_); };
+    }
+    setGamma(DEFAULT_FADE_GAMMA);
+}
+
+FadeEngine::~FadeEngine() {
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = timerId_;
+        timerId_ = -1;
+    }
+    // Not under mutex_: cancel() waits for a running tick, which takes it
+    if (id >= 0) {
+        timers_->cancel(id);
+    }
+}
+
+uint32_t FadeEngine::curveProgress(FadeCurve curve, uint32_t progress) {
+    const uint64_t p = progress > ONE ? ONE : progress;
+    switch (curve) {
+        case FadeCurve::EASE_IN:
+            return static_cast<uint32_t>((p * p) >> 16);
+        case FadeCurve::EASE_OUT: {
+            const uint64_t q = ONE - p;
+            return static_cast<uint32_t>(ONE - ((q * q) >> 16));
+        }
+        case FadeCurve::EASE_IN_OUT:
+            // Smoothstep: p^2 * (3 - 2p)
+            return static_cast<uint32_t>((p * p * (3 * ONE - 2 * p)) >> 32);
+        case FadeCurve::LINEAR:
+            break;
+    }
+    return static_cast<uint32_t>(p);
+}
+
+void FadeEngine::fadeTo(int pin, uint8_t target, uint32_t durationMs, FadeCurve curve) {
+    validatePin(pin);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel& channel = channels_[pin];
+    channel.from = channel.level;
+    channel.to = static_cast<uint16_t>(target << 8);
+    channel.startNs = monotonicNowNs();
+    channel.durationNs = static_cast<int64_t>(durationMs) * 1000000;
+    channel.curve = curve;
+    if (!channel.fading) {
+        channel.fading = true;
+        ++fading_;
+    }
+    ensureTimer();
+}
+
+void FadeEngine::set(int pin, uint8_t brightness) {
+    validatePin(pin);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel& channel = channels_[pin];
+    if (channel.fading) {
+        channel.fading = false;
+        --fading_;
+    }
+    channel.level = static_cast<uint16_t>(brightness << 8);
+    write(pin, channel);
+}
+
+bool FadeEngine::stop(int pin) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = channels_.find(pin);
+    if (it == channels_.end() || !it->second.fading) {
+        return false;
+    }
+    it->second.fading = false;
+    --fading_;
+    return true;
+}
+
+bool FadeEngine::isFading(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = channels_.find(pin);
+    return it != channels_.end() && it->second.fading;
+}
+
+uint8_t FadeEngine::getBrightness(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = channels_.find(pin);
+    return it == channels_.end() ? 0 : static_cast<uint8_t>((it->second.level + 128) >> 8);
+}
+
+size_t FadeEngine::getActiveCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fading_;
+}
+
+bool FadeEngine::setGamma(double gamma) {
+    if (!(gamma > 0.0)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < gamma_.size(); ++i) {
+        gamma_[i] = static_cast<uint8_t>(std::lround(255.0 * std::pow(i / 255.0, gamma)));
+    }
+    return true;
+}
+
+uint8_t FadeEngine::gammaCorrect(uint8_t brightness) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return gamma_[brightness];
+}
+
+void FadeEngine::setTickUs(uint32_t tickUs) {
+    if (tickUs == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    tickUs_ = tickUs;
+    if (timerId_ >= 0) {
+        timers_->setPeriod(timerId_, tickUs);
+    }
+}
+
+void FadeEngine::setFrequency(int frequencyHz) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frequencyHz_ = frequencyHz < 0 ? 0 : frequencyHz;
+}
+
+bool FadeEngine::step(int64_t nowNs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : channels_) {
+        Channel& channel = entry.second;
+        if (!channel.fading) {
+            continue;
+        }
+        const int64_t elapsed = nowNs - channel.startNs;
+        if (elapsed >= channel.durationNs) {
+            channel.level = channel.to;
+            channel.fading = false;
+            --fading_;
+        } else if (elapsed > 0) {
+            const uint32_t progress = static_cast<uint32_t>(static_cast<double>(elapsed) / channel.durationNs * ONE);
+            const int64_t delta = static_cast<int64_t>(channel.to) - channel.from;
+            channel.level = static_cast<uint16_t>(channel.from + ((delta * curveProgress(channel.curve, progress)) >> 16));
+        }
+        try {
+            write(entry.first, channel);
+        } catch (const std::exception& e) {
+            // Keep the other fades going; retrying would fail the same way
+            PIPINPP_LOG_ERROR("Fade on pin " << entry.first << " stopped: " << e.what());
+            (void)e;
+            if (channel.fading) {
+                channel.fading = false;
+                --fading_;
+            }
+        }
+    }
+    return fading_ > 0;
+}
+
+void FadeEngine::write(int pin, Channel& channel) {
+    const uint8_t value = gamma_[(channel.level + 128) >> 8];
+    if (value == channel.output) {
+        return;                                  // Unchanged: no syscall, no DMA buffer update
+    }
+    output_(pin, value);
+    channel.output = value;
+}
+
+void FadeEngine::ensureTimer() {
+    if (timerId_ >= 0) {
+        return;
+    }
+    timerId_ = timers_->every(tickUs_, [this] { onTick(); });
+    if (timerId_ < 0) {
+        PIPINPP_LOG_ERROR("FadeEngine could not start its timer task");
+    }
+}
+
+void FadeEngine::onTick() {
+    if (step(monotonicNowNs())) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fading_ == 0 && timerId_ >= 0) {
+        timers_->cancel(timerId_);               // From our own callback: does not wait
+        timerId_ = -1;
+    }
+}
+
+} // namespace pipinpp
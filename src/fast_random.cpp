@@ -0,0 +1,125 @@
+/**
+ * @file fast_random.cpp
+ * @brief Per-thread random engines and the seed they derive from
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "fast_random.hpp"
+#include <atomic>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint64_t DEFAULT_SEED = 5489;          // std::mt19937's default, as before
+
+std::atomic<uint64_t> g_seed{DEFAULT_SEED};
+std::atomic<uint32_t> g_generation{0};           ///< Bumped by every randomSeed()
+std::atomic<uint32_t> g_nextIndex{0};
+
+struct ThreadStream {
+    Xoshiro256 engine;
+    uint32_t generation = UINT32_MAX;            ///< Seed generation the engine was built from
+    uint32_t index = 0;
+    bool indexed = false;
+};
+
+thread_local ThreadStream t_stream;
+
+void reseed(ThreadStream& stream, uint32_t generation) {
+    if (!stream.indexed) {
+        stream.index = g_nextIndex.fetch_add(1, std::memory_order_relaxed);
+        stream.indexed = true;
+    }
+    // Mix the index in before splitmix expands it, so neighbouring streams are unrelated
+    stream.engine.seed(g_seed.load(std::memory_order_relaxed) ^ (static_cast<uint64_t>(stream.index) * 0xD1B54A32D192ED03ULL));
+    stream.generation = generation;
+}
+
+} // namespace
+
+void setRandomSeedValue(uint64_t seed) {
+    g_seed.store(seed, std::memory_order_relaxed);
+    g_generation.fetch_add(1, std::memory_order_release);
+}
+
+Xoshiro256& threadRandomEngine() {
+    ThreadStream& stream = t_stream;
+    const uint32_t generation = g_generation.load(std::memory_order_acquire);
+    if (stream.generation != generation) {
+        reseed(stream, generation);
+    }
+    return stream.engine;
+}
+
+void setRandomStreamIndex(uint32_t index) {
+    t_stream.index = index;
+    t_stream.indexed = true;
+    reseed(t_stream, g_generation.load(std::memory_order_acquire));
+}
+
+uint32_t getRandomStreamIndex() {
+    threadRandomEngine();                        // Assigns the index on first use
+    return t_stream.index;
+}
+
+void fillRandom(uint8_t* buffer, size_t length) {
+    if (buffer == nullptr) {
+        return;
+    }
+    Xoshiro256& engine = threadRandomEngine();
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word = engine();
+        for (size_t b = 0; b < sizeof(uint64_t); ++b) {
+            buffer[i + b] = static_cast<uint8_t>(word >> (8 * b));
+        }
+    }
+    if (i < length) {
+        uint64_t word = engine();
+        for (; i < length; ++i, word >>= 8) {
+            buffer[i] = static_cast<uint8_t>(word);
+        }
+    }
+}
+
+void fillRandom(long* values, size_t count, long min, long max) {
+    if (values == nullptr) {
+        return;
+    }
+    if (min >= max) {
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = min;
+        }
+        return;
+    }
+    Xoshiro256& engine = threadRandomEngine();
+    const uint64_t range = static_cast<uint64_t>(static_cast<unsigned long>(max) - static_cast<unsigned long>(min));
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<long>(static_cast<unsigned long>(min) + static_cast<unsigned long>(engine.below(range)));
+    }
+}
+
+} // namespace pipinpp
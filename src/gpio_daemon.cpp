@@ -0,0 +1,1549 @@
+/**
+ * @file gpio_daemon.cpp
+ * @brief pipinppd server and client: control socket, shared command and event rings
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "gpio_daemon.hpp"
+#include "log.hpp"
+#include "thread_policy.hpp"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <map>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace pipinpp {
+
+namespace {
+
+// ============================================================================
+// Protocol
+// ============================================================================
+
+constexpr uint32_t PROTOCOL_MAGIC = 0x70706464;     // "ppdd"
+constexpr uint32_t PROTOCOL_VERSION = 1;
+constexpr size_t COMMAND_RING_SLOTS = 1024;
+constexpr size_t REPLY_RING_SLOTS = 16;
+constexpr size_t EVENT_RING_SLOTS = 1024;
+constexpr size_t MAX_REQUEST_LINES = 64;
+constexpr size_t MAX_MESSAGE_FDS = 3;
+constexpr size_t NAME_LENGTH = 64;
+constexpr int64_t CALL_TIMEOUT_NS = 1000000000LL;   // Reply or queue space from the daemon
+constexpr int64_t CLIENT_SPIN_NS = 20000;           // Reply wait before sleeping on the doorbell
+constexpr size_t EVENT_BATCH = 64;
+
+uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * Single-producer single-consumer ring that lives in memory shared between
+ * processes: fixed capacity, no pointers, only lock-free atomics.
+ */
+template <typename T, size_t N>
+struct ShmRing {
+    static_assert((N & (N - 1)) == 0, "ShmRing size must be a power of two");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "ShmRing needs lock-free 64-bit atomics");
+
+    alignas(64) std::atomic<uint64_t> head;   // Next slot written by the producer
+    alignas(64) std::atomic<uint64_t> tail;   // Next slot read by the consumer
+    T slots[N];
+
+    bool push(const T& item) {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+        slots[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        const uint64_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+};
+
+enum class CommandOp : uint32_t { SET_VALUE = 1, GET_VALUE = 2 };
+
+struct Command {
+    CommandOp op;
+    uint32_t requestId;
+    uint32_t offset;
+    uint32_t value;
+    uint64_t seq;       // Matches the reply of a GET_VALUE
+};
+
+struct CommandReply {
+    uint64_t seq;
+    int32_t result;     // Level, or -errno
+    uint32_t reserved;
+};
+
+struct WireEvent {
+    uint32_t offset;
+    uint32_t rising;
+    uint64_t timestampNs;
+    uint64_t globalSeqno;
+    uint64_t lineSeqno;
+};
+
+/**
+ * Per-client segment: commands in, replies out, and the flags that say
+ * whether either side sleeps on its doorbell eventfd.
+ */
+struct SessionShm {
+    uint32_t magic;
+    uint32_t version;
+    alignas(64) std::atomic<uint32_t> daemonWaiting;
+    alignas(64) std::atomic<uint32_t> clientWaiting;
+    std::atomic<uint64_t> failedWrites;
+    ShmRing<Command, COMMAND_RING_SLOTS> commands;
+    ShmRing<CommandReply, REPLY_RING_SLOTS> replies;
+};
+
+/**
+ * Per-request segment: edge events from the daemon
+ */
+struct RequestShm {
+    uint32_t magic;
+    std::atomic<uint64_t> dropped;
+    ShmRing<WireEvent, EVENT_RING_SLOTS> events;
+};
+
+enum class MessageType : uint32_t { HELLO = 1, CHIP_INFO, REQUEST, RECONFIGURE, RELEASE };
+
+struct WireLineSettings {
+    uint32_t offset;
+    int32_t direction;
+    int32_t bias;
+    int32_t edge;
+    uint32_t debounceUs;
+    int32_t outputValue;
+};
+
+struct ControlMessage {
+    MessageType type;
+    uint32_t version;
+    uint32_t requestId;
+    uint32_t count;
+    uint32_t eventBufferSize;
+    uint32_t reserved;
+    char chip[NAME_LENGTH];
+    WireLineSettings lines[MAX_REQUEST_LINES];
+};
+
+struct ControlReply {
+    int32_t result;     // 0, or -errno
+    uint32_t requestId;
+    uint32_t numLines;
+    uint32_t reserved;
+};
+
+WireLineSettings toWire(const LineSettings& settings) {
+    WireLineSettings wire{};
+    wire.offset = settings.offset;
+    wire.direction = static_cast<int32_t>(settings.direction);
+    wire.bias = static_cast<int32_t>(settings.bias);
+    wire.edge = static_cast<int32_t>(settings.edge);
+    wire.debounceUs = settings.debounceUs;
+    wire.outputValue = static_cast<int32_t>(settings.outputValue);
+    return wire;
+}
+
+LineSettings fromWire(const WireLineSettings& wire) {
+    LineSettings settings;
+    settings.offset = wire.offset;
+    settings.direction = static_cast<gpiod_line_direction>(wire.direction);
+    settings.bias = static_cast<gpiod_line_bias>(wire.bias);
+    settings.edge = static_cast<gpiod_line_edge>(wire.edge);
+    settings.debounceUs = wire.debounceUs;
+    settings.outputValue = static_cast<gpiod_line_value>(wire.outputValue);
+    return settings;
+}
+
+void copyName(char (&dest)[NAME_LENGTH], const std::string& name) {
+    std::memset(dest, 0, NAME_LENGTH);
+    std::memcpy(dest, name.data(), std::min(name.size(), NAME_LENGTH - 1));
+}
+
+std::string readName(const char (&src)[NAME_LENGTH]) {
+    return std::string(src, strnlen(src, NAME_LENGTH));
+}
+
+/**
+ * @brief Send one datagram with file descriptors attached
+ */
+bool sendMessage(int socket, const void* data, size_t size, const int* fds, size_t fdCount, int flags = 0) {
+    iovec iov{const_cast<void*>(data), size};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_MESSAGE_FDS)];
+    if (fdCount > 0) {
+        std::memset(control, 0, sizeof(control));
+        msg.msg_control = control;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * fdCount);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fdCount);
+        std::memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * fdCount);
+    }
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(socket, &msg, MSG_NOSIGNAL | flags);
+    } while (sent < 0 && errno == EINTR);
+    return sent == static_cast<ssize_t>(size);
+}
+
+/**
+ * @brief Receive one datagram and the file descriptors attached to it
+ * @return Bytes received, 0 when the peer closed, -1 on error
+ */
+ssize_t receiveMessage(int socket, void* data, size_t size, int* fds, size_t maxFds, size_t* fdCount) {
+    iovec iov{data, size};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_MESSAGE_FDS)];
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do {
+        received = recvmsg(socket, &msg, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+
+    size_t count = 0;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        size_t n = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < n; ++i) {
+            int fd;
+            std::memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            if (count < maxFds) {
+                fds[count++] = fd;
+            } else {
+                close(fd);
+            }
+        }
+    }
+    if (fdCount) {
+        *fdCount = count;
+    }
+    if (received > 0 && (msg.msg_flags & MSG_TRUNC)) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    return received;
+}
+
+void closeFds(const int* fds, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        close(fds[i]);
+    }
+}
+
+void ring(int eventFd) {
+    uint64_t one = 1;
+    ssize_t ignored = write(eventFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void drain(int eventFd) {
+    uint64_t count;
+    ssize_t ignored = read(eventFd, &count, sizeof(count));
+    (void)ignored;
+}
+
+/**
+ * @brief Create a memfd holding a value-initialized T and map it
+ */
+template <typename T>
+T* createShared(const char* name, int& fd) {
+    fd = memfd_create(name, MFD_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    void* mem = MAP_FAILED;
+    if (ftruncate(fd, sizeof(T)) == 0) {
+        mem = mmap(nullptr, sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mem == MAP_FAILED) {
+        int saved = errno;
+        close(fd);
+        fd = -1;
+        errno = saved;
+        return nullptr;
+    }
+    T* shared = new (mem) T();
+    shared->magic = PROTOCOL_MAGIC;
+    return shared;
+}
+
+/**
+ * @brief Map a T created by the other side
+ */
+template <typename T>
+T* mapShared(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return nullptr;
+    }
+    if (static_cast<size_t>(st.st_size) < sizeof(T)) {
+        errno = EPROTO;
+        return nullptr;
+    }
+    void* mem = mmap(nullptr, sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+        return nullptr;
+    }
+    T* shared = static_cast<T*>(mem);
+    if (shared->magic != PROTOCOL_MAGIC) {
+        munmap(mem, sizeof(T));
+        errno = EPROTO;
+        return nullptr;
+    }
+    return shared;
+}
+
+template <typename T>
+void unmapShared(T* shared) {
+    if (shared) {
+        munmap(shared, sizeof(T));
+    }
+}
+
+bool sameSettings(const LineSettings& a, const LineSettings& b) {
+    return a.direction == b.direction && a.bias == b.bias && a.edge == b.edge && a.debounceUs == b.debounceUs;
+}
+
+bool edgeWanted(gpiod_line_edge edge, bool rising) {
+    switch (edge) {
+        case GPIOD_LINE_EDGE_RISING:
+            return rising;
+        case GPIOD_LINE_EDGE_FALLING:
+            return !rising;
+        case GPIOD_LINE_EDGE_BOTH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Server
+// ============================================================================
+
+struct GpioDaemon::Impl {
+    struct Session;
+    struct SharedLine;
+    struct ClientRequest;
+
+    enum class WatchKind { LISTEN, STOP, CONTROL, DOORBELL, EDGES };
+
+    struct Watch {
+        WatchKind kind;
+        Session* session = nullptr;
+        SharedLine* line = nullptr;
+    };
+
+    /**
+     * One client's use of a line
+     */
+    struct Holder {
+        ClientRequest* request;
+        SharedLine* line;
+        LineSettings settings;
+        uint64_t lineSeqno = 0;     // Renumbered: the client sees only the edges it asked for
+    };
+
+    /**
+     * A line the daemon has requested from the kernel, shared by every client holding it
+     */
+    struct SharedLine {
+        std::string chip;
+        unsigned int offset = 0;
+        std::unique_ptr<LineRequest> request;
+        LineSettings applied;
+        std::vector<Holder*> holders;
+        uint64_t lastSeqno = 0;
+        Watch watch;
+    };
+
+    struct ClientRequest {
+        uint32_t id = 0;
+        std::map<unsigned int, std::unique_ptr<Holder>> held;
+        RequestShm* shm = nullptr;
+        int eventFd = -1;
+        uint64_t globalSeqno = 0;
+        bool signal = false;
+    };
+
+    struct Session {
+        int socket = -1;
+        SessionShm* shm = nullptr;
+        int daemonDoorbell = -1;    // Client rings, daemon waits
+        int clientDoorbell = -1;    // Daemon rings, client waits
+        std::map<uint32_t, std::unique_ptr<ClientRequest>> requests;
+        uint32_t nextRequestId = 1;
+        bool closed = false;
+        Watch controlWatch;
+        Watch doorbellWatch;
+    };
+
+    explicit Impl(ChipRegistry::ChipFactory factory) : chipFactory(std::move(factory)) {}
+
+    ChipRegistry::ChipFactory chipFactory;
+    int listenFd = -1;
+    int epollFd = -1;
+    int stopFd = -1;
+    Watch listenWatch{WatchKind::LISTEN};
+    Watch stopWatch{WatchKind::STOP};
+
+    // Owned by the service thread while it runs
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::map<std::pair<std::string, unsigned int>, std::unique_ptr<SharedLine>> lines;
+    std::map<std::string, std::shared_ptr<GpioChip>> chips;
+    std::vector<std::unique_ptr<SharedLine>> retired;   // Freed after the epoll batch that may name them
+
+    std::atomic<size_t> clientCount{0};
+    std::atomic<size_t> requestCount{0};
+
+    void watch(int fd, Watch* w) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = w;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            PIPINPP_LOG_ERROR("pipinppd: epoll_ctl() failed: " << strerror(errno));
+        }
+    }
+
+    void unwatch(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    std::shared_ptr<GpioChip> openChip(const std::string& name) {
+        auto it = chips.find(name);
+        if (it != chips.end()) {
+            return it->second;
+        }
+        std::shared_ptr<GpioChip> chip;
+        try {
+            chip = chipFactory ? chipFactory(name) : ChipRegistry::getInstance().acquire(name);
+        } catch (const std::exception& e) {
+            PIPINPP_LOG_WARNING("pipinppd: cannot open " << name << ": " << e.what());
+        }
+        if (chip) {
+            chips[name] = chip;
+        } else {
+            errno = ENODEV;
+        }
+        return chip;
+    }
+
+    // ------------------------------------------------------------------
+    // Clients
+    // ------------------------------------------------------------------
+
+    void accept() {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        auto session = std::make_unique<Session>();
+        session->socket = fd;
+        session->controlWatch = Watch{WatchKind::CONTROL, session.get()};
+        session->doorbellWatch = Watch{WatchKind::DOORBELL, session.get()};
+        watch(fd, &session->controlWatch);
+        sessions.push_back(std::move(session));
+        clientCount.fetch_add(1, std::memory_order_relaxed);
+        PIPINPP_LOG_INFO("pipinppd: client connected");
+    }
+
+    void closeSession(Session& session) {
+        if (session.closed) {
+            return;
+        }
+        session.closed = true;
+        while (!session.requests.empty()) {
+            release(session, *session.requests.begin()->second);
+        }
+        unwatch(session.socket);
+        close(session.socket);
+        if (session.shm) {
+            unwatch(session.daemonDoorbell);
+            close(session.daemonDoorbell);
+            close(session.clientDoorbell);
+            unmapShared(session.shm);
+            session.shm = nullptr;
+        }
+        clientCount.fetch_sub(1, std::memory_order_relaxed);
+        PIPINPP_LOG_INFO("pipinppd: client disconnected, its lines released");
+    }
+
+    void reply(Session& session, const ControlReply& message, const int* fds = nullptr, size_t fdCount = 0) {
+        // Never block on a client that stopped reading
+        if (!sendMessage(session.socket, &message, sizeof(message), fds, fdCount, MSG_DONTWAIT)) {
+            closeSession(session);
+        }
+    }
+
+    void fail(Session& session, int error) {
+        ControlReply message{};
+        message.result = -error;
+        reply(session, message);
+    }
+
+    void onControl(Session& session) {
+        // Commands queued before this message are applied first
+        serviceCommands(session);
+
+        ControlMessage message;
+        int fds[MAX_MESSAGE_FDS];
+        size_t fdCount = 0;
+        ssize_t received = receiveMessage(session.socket, &message, sizeof(message), fds, MAX_MESSAGE_FDS, &fdCount);
+        closeFds(fds, fdCount);     // Clients send none
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EMSGSIZE)) {
+            closeSession(session);
+            return;
+        }
+        if (received != static_cast<ssize_t>(sizeof(message)) || message.count > MAX_REQUEST_LINES) {
+            fail(session, EPROTO);
+            return;
+        }
+        if (message.type != MessageType::HELLO && !session.shm) {
+            fail(session, EPROTO);
+            return;
+        }
+
+        switch (message.type) {
+            case MessageType::HELLO:
+                hello(session, message);
+                break;
+            case MessageType::CHIP_INFO:
+                chipInfo(session, message);
+                break;
+            case MessageType::REQUEST:
+                request(session, message);
+                break;
+            case MessageType::RECONFIGURE:
+                reconfigure(session, message);
+                break;
+            case MessageType::RELEASE: {
+                auto it = session.requests.find(message.requestId);
+                if (it == session.requests.end()) {
+                    fail(session, ENOENT);
+                    return;
+                }
+                release(session, *it->second);
+                reply(session, ControlReply{});
+                break;
+            }
+            default:
+                fail(session, EPROTO);
+                break;
+        }
+    }
+
+    void hello(Session& session, const ControlMessage& message) {
+        if (session.shm || message.version != PROTOCOL_VERSION) {
+            fail(session, EPROTO);
+            return;
+        }
+        int memFd = -1;
+        SessionShm* shm = createShared<SessionShm>("pipinppd-session", memFd);
+        if (!shm) {
+            fail(session, errno);
+            return;
+        }
+        shm->version = PROTOCOL_VERSION;
+        session.shm = shm;
+        session.daemonDoorbell = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        session.clientDoorbell = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (session.daemonDoorbell < 0 || session.clientDoorbell < 0) {
+            int error = errno;
+            close(memFd);
+            fail(session, error);
+            closeSession(session);
+            return;
+        }
+        watch(session.daemonDoorbell, &session.doorbellWatch);
+
+        int fds[] = {memFd, session.daemonDoorbell, session.clientDoorbell};
+        reply(session, ControlReply{}, fds, 3);
+        close(memFd);   // The mapping keeps the segment alive
+    }
+
+    void chipInfo(Session& session, const ControlMessage& message) {
+        std::shared_ptr<GpioChip> chip = openChip(readName(message.chip));
+        if (!chip) {
+            fail(session, errno);
+            return;
+        }
+        ControlReply result{};
+        result.numLines = static_cast<uint32_t>(chip->numLines());
+        reply(session, result);
+    }
+
+    // ------------------------------------------------------------------
+    // Shared lines
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Settings satisfying every holder: output if anyone drives the
+     *        line, the union of the edges asked for, the latest bias and debounce
+     */
+    static LineSettings merged(const SharedLine& line) {
+        LineSettings settings;
+        settings.offset = line.offset;
+        bool rising = false;
+        bool falling = false;
+        for (const Holder* holder : line.holders) {
+            const LineSettings& wanted = holder->settings;
+            if (wanted.direction == GPIOD_LINE_DIRECTION_OUTPUT) {
+                settings.direction = GPIOD_LINE_DIRECTION_OUTPUT;
+            }
+            if (wanted.bias != GPIOD_LINE_BIAS_AS_IS) {
+                settings.bias = wanted.bias;
+            }
+            if (wanted.debounceUs > 0) {
+                settings.debounceUs = wanted.debounceUs;
+            }
+            rising = rising || edgeWanted(wanted.edge, true);
+            falling = falling || edgeWanted(wanted.edge, false);
+        }
+        if (settings.direction == GPIOD_LINE_DIRECTION_OUTPUT) {
+            settings.debounceUs = 0;
+        } else if (rising && falling) {
+            settings.edge = GPIOD_LINE_EDGE_BOTH;
+        } else if (rising) {
+            settings.edge = GPIOD_LINE_EDGE_RISING;
+        } else if (falling) {
+            settings.edge = GPIOD_LINE_EDGE_FALLING;
+        }
+        return settings;
+    }
+
+    /**
+     * @brief Bring the kernel request in line with the holders
+     * @param outputValue Level if the line turns into an output (a line
+     *        that already is one keeps its level)
+     */
+    bool apply(SharedLine& line, gpiod_line_value outputValue) {
+        LineSettings settings = merged(line);
+        if (sameSettings(settings, line.applied)) {
+            return true;
+        }
+        settings.outputValue = outputValue;
+        if (line.applied.direction == GPIOD_LINE_DIRECTION_OUTPUT && settings.direction == GPIOD_LINE_DIRECTION_OUTPUT) {
+            settings.outputValue = line.request->getValue(line.offset) == 1 ? GPIOD_LINE_VALUE_ACTIVE
+                                                                            : GPIOD_LINE_VALUE_INACTIVE;
+        }
+        if (!line.request->reconfigure({settings})) {
+            return false;
+        }
+        line.applied = settings;
+        line.lastSeqno = 0;
+        return true;
+    }
+
+    /**
+     * @brief Add a holder to a line, requesting the line from the kernel if nobody holds it
+     */
+    Holder* hold(ClientRequest& request, const std::string& chipName, const LineSettings& settings,
+                 size_t eventBufferSize) {
+        auto key = std::make_pair(chipName, settings.offset);
+        auto it = lines.find(key);
+        SharedLine* line;
+        if (it == lines.end()) {
+            std::shared_ptr<GpioChip> chip = openChip(chipName);
+            if (!chip) {
+                return nullptr;
+            }
+            std::unique_ptr<LineRequest> kernel = chip->requestLines("pipinppd", {settings}, eventBufferSize);
+            if (!kernel) {
+                return nullptr;
+            }
+            auto created = std::make_unique<SharedLine>();
+            created->chip = chipName;
+            created->offset = settings.offset;
+            created->request = std::move(kernel);
+            created->applied = settings;
+            created->watch = Watch{WatchKind::EDGES, nullptr, created.get()};
+            if (created->request->fd() >= 0) {
+                watch(created->request->fd(), &created->watch);
+            }
+            line = created.get();
+            lines.emplace(key, std::move(created));
+        } else {
+            line = it->second.get();
+        }
+
+        auto holder = std::make_unique<Holder>();
+        holder->request = &request;
+        holder->line = line;
+        holder->settings = settings;
+        line->holders.push_back(holder.get());
+        if (!apply(*line, settings.outputValue)) {
+            int error = errno;
+            line->holders.pop_back();
+            errno = error ? error : EBUSY;
+            return nullptr;
+        }
+        Holder* result = holder.get();
+        request.held[settings.offset] = std::move(holder);
+        return result;
+    }
+
+    void unhold(Holder& holder) {
+        SharedLine& line = *holder.line;
+        line.holders.erase(std::remove(line.holders.begin(), line.holders.end(), &holder), line.holders.end());
+        if (!line.holders.empty()) {
+            apply(line, GPIOD_LINE_VALUE_INACTIVE);
+            return;
+        }
+        auto it = lines.find(std::make_pair(line.chip, line.offset));
+        if (line.request->fd() >= 0) {
+            unwatch(line.request->fd());
+        }
+        line.request.reset();       // Back to the kernel
+        retired.push_back(std::move(it->second));
+        lines.erase(it);
+    }
+
+    // ------------------------------------------------------------------
+    // Requests
+    // ------------------------------------------------------------------
+
+    void request(Session& session, const ControlMessage& message) {
+        std::string chipName = readName(message.chip);
+        auto request = std::make_unique<ClientRequest>();
+        request->id = session.nextRequestId++;
+
+        for (uint32_t i = 0; i < message.count; ++i) {
+            LineSettings settings = fromWire(message.lines[i]);
+            if (request->held.count(settings.offset) ||
+                !hold(*request, chipName, settings, message.eventBufferSize)) {
+                int error = request->held.count(settings.offset) ? EINVAL : errno;
+                for (auto& entry : request->held) {
+                    unhold(*entry.second);
+                }
+                fail(session, error);
+                return;
+            }
+        }
+
+        int memFd = -1;
+        request->shm = createShared<RequestShm>("pipinppd-events", memFd);
+        request->eventFd = request->shm ? eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) : -1;
+        if (request->eventFd < 0) {
+            int error = errno;
+            if (memFd >= 0) {
+                close(memFd);
+            }
+            unmapShared(request->shm);
+            for (auto& entry : request->held) {
+                unhold(*entry.second);
+            }
+            fail(session, error);
+            return;
+        }
+
+        ControlReply result{};
+        result.requestId = request->id;
+        int fds[] = {memFd, request->eventFd};
+        session.requests.emplace(request->id, std::move(request));
+        requestCount.fetch_add(1, std::memory_order_relaxed);
+        reply(session, result, fds, 2);
+        close(memFd);
+    }
+
+    void reconfigure(Session& session, const ControlMessage& message) {
+        auto it = session.requests.find(message.requestId);
+        if (it == session.requests.end()) {
+            fail(session, ENOENT);
+            return;
+        }
+        ClientRequest& request = *it->second;
+        for (uint32_t i = 0; i < message.count; ++i) {
+            if (!request.held.count(message.lines[i].offset)) {
+                fail(session, EINVAL);
+                return;
+            }
+        }
+        int error = 0;
+        for (uint32_t i = 0; i < message.count; ++i) {
+            LineSettings settings = fromWire(message.lines[i]);
+            Holder& holder = *request.held[settings.offset];
+            holder.settings = settings;
+            if (!apply(*holder.line, settings.outputValue)) {
+                error = errno ? errno : EINVAL;
+            }
+        }
+        if (error) {
+            fail(session, error);
+            return;
+        }
+        reply(session, ControlReply{});
+    }
+
+    void release(Session& session, ClientRequest& request) {
+        for (auto& entry : request.held) {
+            unhold(*entry.second);
+        }
+        close(request.eventFd);
+        unmapShared(request.shm);
+        session.requests.erase(request.id);
+        requestCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // ------------------------------------------------------------------
+    // Fast path
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Apply every queued command of a client
+     * @return true if there were any
+     */
+    bool serviceCommands(Session& session) {
+        if (!session.shm) {
+            return false;
+        }
+        SessionShm& shm = *session.shm;
+        bool replied = false;
+        bool any = false;
+        Command command;
+        while (shm.commands.pop(command)) {
+            any = true;
+            Holder* holder = nullptr;
+            auto it = session.requests.find(command.requestId);
+            if (it != session.requests.end()) {
+                auto held = it->second->held.find(command.offset);
+                if (held != it->second->held.end()) {
+                    holder = held->second.get();
+                }
+            }
+
+            if (command.op == CommandOp::SET_VALUE) {
+                // Only holders that asked for an output may drive the line
+                if (!holder || holder->settings.direction != GPIOD_LINE_DIRECTION_OUTPUT ||
+                    holder->line->request->setValue(command.offset, command.value != 0) < 0) {
+                    shm.failedWrites.fetch_add(1, std::memory_order_relaxed);
+                }
+            } else if (command.op == CommandOp::GET_VALUE) {
+                CommandReply result{};
+                result.seq = command.seq;
+                result.result = -EINVAL;
+                if (holder) {
+                    int value = holder->line->request->getValue(command.offset);
+                    result.result = value >= 0 ? value : -(errno ? errno : EIO);
+                }
+                shm.replies.push(result);   // A full ring means the client gave up waiting
+                replied = true;
+            }
+        }
+        if (replied) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (shm.clientWaiting.load(std::memory_order_relaxed)) {
+                ring(session.clientDoorbell);
+            }
+        }
+        return any;
+    }
+
+    bool serviceAll() {
+        bool any = false;
+        for (auto& session : sessions) {
+            if (!session->closed) {
+                any = serviceCommands(*session) || any;
+            }
+        }
+        return any;
+    }
+
+    /**
+     * @brief Tell every client that the daemon is about to sleep
+     * @return false if commands arrived meanwhile (the daemon must not sleep)
+     */
+    bool armDoorbells() {
+        for (auto& session : sessions) {
+            if (session->shm) {
+                session->shm->daemonWaiting.store(1, std::memory_order_relaxed);
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (auto& session : sessions) {
+            if (session->shm && !session->shm->commands.empty()) {
+                disarmDoorbells();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void disarmDoorbells() {
+        for (auto& session : sessions) {
+            if (session->shm) {
+                session->shm->daemonWaiting.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Copy a line's kernel edge events to every holder that asked for them
+     */
+    void forwardEdges(SharedLine& line) {
+        if (!line.request) {
+            return;
+        }
+        LineEvent events[EVENT_BATCH];
+        int count = line.request->readEdgeEvents(events, EVENT_BATCH);
+        for (int i = 0; i < count; ++i) {
+            const LineEvent& event = events[i];
+            // Edges the kernel overwrote are lost to every holder
+            uint64_t lost = (line.lastSeqno > 0 && event.lineSeqno > line.lastSeqno + 1)
+                ? event.lineSeqno - line.lastSeqno - 1 : 0;
+            line.lastSeqno = event.lineSeqno;
+
+            for (Holder* holder : line.holders) {
+                holder->lineSeqno += lost;
+                if (!edgeWanted(holder->settings.edge, event.rising)) {
+                    continue;
+                }
+                ClientRequest& request = *holder->request;
+                WireEvent wire{};
+                wire.offset = event.offset;
+                wire.rising = event.rising ? 1 : 0;
+                wire.timestampNs = event.timestampNs;
+                wire.globalSeqno = ++request.globalSeqno;
+                wire.lineSeqno = ++holder->lineSeqno;
+                // A dropped event still advances the sequence numbers, so the client sees the gap
+                if (!request.shm->events.push(wire)) {
+                    request.shm->dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                request.signal = true;
+            }
+        }
+        for (Holder* holder : line.holders) {
+            if (holder->request->signal) {
+                holder->request->signal = false;
+                ring(holder->request->eventFd);
+            }
+        }
+    }
+};
+
+GpioDaemon::GpioDaemon(const std::string& socketPath, ChipRegistry::ChipFactory chips)
+    : socketPath_(socketPath), chips_(std::move(chips)) {}
+
+GpioDaemon::~GpioDaemon() {
+    stop();
+}
+
+void GpioDaemon::setSocketMode(unsigned int mode) {
+    socketMode_ = mode;
+}
+
+bool GpioDaemon::start() {
+    if (isRunning()) {
+        return true;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath_.empty() || socketPath_.size() >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    std::memcpy(addr.sun_path, socketPath_.c_str(), socketPath_.size() + 1);
+
+    auto impl = std::make_unique<Impl>(chips_);
+    impl->listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    impl->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    impl->stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    auto cleanup = [&impl]() {
+        int saved = errno;
+        for (int fd : {impl->listenFd, impl->epollFd, impl->stopFd}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        errno = saved;
+    };
+    if (impl->listenFd < 0 || impl->epollFd < 0 || impl->stopFd < 0) {
+        cleanup();
+        return false;
+    }
+
+    unlink(socketPath_.c_str());    // Left behind by a daemon that did not exit cleanly
+    if (bind(impl->listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        chmod(socketPath_.c_str(), socketMode_) != 0 || listen(impl->listenFd, 16) != 0) {
+        PIPINPP_LOG_ERROR("pipinppd: cannot listen on " << socketPath_ << ": " << strerror(errno));
+        cleanup();
+        return false;
+    }
+    impl->watch(impl->listenFd, &impl->listenWatch);
+    impl->watch(impl->stopFd, &impl->stopWatch);
+
+    impl_ = std::move(impl);
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&GpioDaemon::run, this);
+    PIPINPP_LOG_INFO("pipinppd: listening on " << socketPath_);
+    return true;
+}
+
+void GpioDaemon::stop() {
+    if (!impl_) {
+        return;
+    }
+    ring(impl_->stopFd);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (auto& session : impl_->sessions) {
+        impl_->closeSession(*session);
+    }
+    impl_->sessions.clear();
+    impl_->retired.clear();
+    impl_->chips.clear();
+    close(impl_->listenFd);
+    close(impl_->epollFd);
+    close(impl_->stopFd);
+    unlink(socketPath_.c_str());
+    impl_.reset();
+    running_.store(false, std::memory_order_release);
+}
+
+size_t GpioDaemon::getClientCount() const {
+    return impl_ ? impl_->clientCount.load(std::memory_order_relaxed) : 0;
+}
+
+size_t GpioDaemon::getRequestCount() const {
+    return impl_ ? impl_->requestCount.load(std::memory_order_relaxed) : 0;
+}
+
+void GpioDaemon::run() {
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-daemon");
+    Impl& impl = *impl_;
+
+    constexpr int MAX_READY = 32;
+    epoll_event ready[MAX_READY];
+    uint64_t lastCommandNs = 0;
+
+    while (true) {
+        if (impl.serviceAll()) {
+            lastCommandNs = monotonicNs();
+        }
+
+        // Poll while commands keep coming, then sleep until a doorbell rings
+        int timeout = 0;
+        if (monotonicNs() - lastCommandNs >= uint64_t{DAEMON_SPIN_US} * 1000) {
+            if (!impl.armDoorbells()) {
+                continue;
+            }
+            timeout = -1;
+        }
+
+        int count = epoll_wait(impl.epollFd, ready, MAX_READY, timeout);
+        if (timeout < 0) {
+            impl.disarmDoorbells();
+        }
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PIPINPP_LOG_ERROR("pipinppd: epoll_wait() failed: " << strerror(errno));
+            break;
+        }
+
+        bool stopping = false;
+        for (int i = 0; i < count; ++i) {
+            auto* w = static_cast<Impl::Watch*>(ready[i].data.ptr);
+            switch (w->kind) {
+                case Impl::WatchKind::STOP:
+                    stopping = true;
+                    break;
+                case Impl::WatchKind::LISTEN:
+                    impl.accept();
+                    break;
+                case Impl::WatchKind::CONTROL:
+                    if (!w->session->closed) {
+                        impl.onControl(*w->session);
+                    }
+                    break;
+                case Impl::WatchKind::DOORBELL:
+                    if (!w->session->closed) {
+                        drain(w->session->daemonDoorbell);
+                        lastCommandNs = monotonicNs();
+                    }
+                    break;
+                case Impl::WatchKind::EDGES:
+                    impl.forwardEdges(*w->line);
+                    break;
+            }
+        }
+
+        // Nothing from this batch refers to them any more
+        impl.retired.clear();
+        impl.sessions.erase(std::remove_if(impl.sessions.begin(), impl.sessions.end(),
+                                           [](const std::unique_ptr<Impl::Session>& s) { return s->closed; }),
+                            impl.sessions.end());
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+// ============================================================================
+// Client
+// ============================================================================
+
+/**
+ * @brief One connection to the daemon, shared by the chips and requests opened through it
+ */
+class DaemonSession : public std::enable_shared_from_this<DaemonSession> {
+public:
+    ~DaemonSession() {
+        close(socket_);
+        close(daemonDoorbell_);
+        close(clientDoorbell_);
+        unmapShared(shm_);
+    }
+
+    /**
+     * @return Session, or nullptr with errno set
+     */
+    static std::shared_ptr<DaemonSession> connect(const std::string& path) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            errno = ENAMETOOLONG;
+            return nullptr;
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return nullptr;
+        }
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            return nullptr;
+        }
+
+        std::shared_ptr<DaemonSession> session(new DaemonSession(fd));
+        ControlMessage hello{};
+        hello.type = MessageType::HELLO;
+        hello.version = PROTOCOL_VERSION;
+        ControlReply reply;
+        int fds[MAX_MESSAGE_FDS];
+        size_t fdCount = 0;
+        if (!session->control(hello, reply, fds, &fdCount)) {
+            return nullptr;
+        }
+        if (fdCount != 3) {
+            closeFds(fds, fdCount);
+            errno = EPROTO;
+            return nullptr;
+        }
+        session->shm_ = mapShared<SessionShm>(fds[0]);
+        int saved = errno;
+        close(fds[0]);
+        session->daemonDoorbell_ = fds[1];
+        session->clientDoorbell_ = fds[2];
+        if (!session->shm_ || session->shm_->version != PROTOCOL_VERSION) {
+            errno = session->shm_ ? EPROTO : saved;
+            return nullptr;
+        }
+        return session;
+    }
+
+    /**
+     * @brief Send a control message and wait for its reply
+     * @return false with errno set if it failed
+     */
+    bool control(ControlMessage& message, ControlReply& reply, int* fds = nullptr, size_t* fdCount = nullptr) {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        message.version = PROTOCOL_VERSION;
+        int received[MAX_MESSAGE_FDS];
+        size_t count = 0;
+        if (!sendMessage(socket_, &message, sizeof(message), nullptr, 0)) {
+            return false;
+        }
+        ssize_t size = receiveMessage(socket_, &reply, sizeof(reply), received, MAX_MESSAGE_FDS, &count);
+        int error = 0;
+        if (size < 0) {
+            error = errno;
+        } else if (size == 0) {
+            error = ECONNRESET;     // Daemon gone
+        } else if (size != static_cast<ssize_t>(sizeof(reply))) {
+            error = EPROTO;
+        } else if (reply.result < 0) {
+            error = -reply.result;
+        }
+        if (error) {
+            closeFds(received, count);
+            errno = error;
+            return false;
+        }
+        if (fds && fdCount) {
+            std::copy(received, received + count, fds);
+            *fdCount = count;
+        } else {
+            closeFds(received, count);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Queue a command, ringing the daemon if it sleeps
+     * @note Caller must hold commandMutex_
+     */
+    int post(const Command& command) {
+        if (!shm_->commands.push(command)) {
+            // Full: the daemon is awake and draining
+            uint64_t deadline = monotonicNs() + CALL_TIMEOUT_NS;
+            do {
+                wakeDaemon();
+                if (monotonicNs() > deadline) {
+                    errno = EAGAIN;
+                    return -1;
+                }
+                std::this_thread::yield();
+            } while (!shm_->commands.push(command));
+        }
+        wakeDaemon();
+        return 0;
+    }
+
+    int setValue(uint32_t requestId, unsigned int offset, bool value) {
+        Command command{CommandOp::SET_VALUE, requestId, offset, value ? 1u : 0u, 0};
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        return post(command);
+    }
+
+    int getValue(uint32_t requestId, unsigned int offset) {
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        Command command{CommandOp::GET_VALUE, requestId, offset, 0, ++nextSeq_};
+        if (post(command) < 0) {
+            return -1;
+        }
+
+        const uint64_t start = monotonicNs();
+        CommandReply reply;
+        while (true) {
+            while (shm_->replies.pop(reply)) {
+                if (reply.seq == command.seq) {
+                    if (reply.result < 0) {
+                        errno = -reply.result;
+                        return -1;
+                    }
+                    return reply.result;
+                }
+                // Reply to a call that timed out: discard
+            }
+            const uint64_t elapsed = monotonicNs() - start;
+            if (elapsed >= static_cast<uint64_t>(CALL_TIMEOUT_NS)) {
+                errno = ETIMEDOUT;
+                return -1;
+            }
+            if (elapsed < static_cast<uint64_t>(CLIENT_SPIN_NS)) {
+                continue;
+            }
+
+            shm_->clientWaiting.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (shm_->replies.empty()) {
+                pollfd pfd{clientDoorbell_, POLLIN, 0};
+                int timeoutMs = static_cast<int>((CALL_TIMEOUT_NS - static_cast<int64_t>(elapsed)) / 1000000) + 1;
+                poll(&pfd, 1, timeoutMs);
+                drain(clientDoorbell_);
+            }
+            shm_->clientWaiting.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t failedWrites() const {
+        return shm_->failedWrites.load(std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<GpioChip> openChip(const std::string& name);
+
+    std::unique_ptr<LineRequest> requestLines(const std::string& chip, const std::vector<LineSettings>& lines,
+                                              size_t eventBufferSize);
+
+private:
+    explicit DaemonSession(int socket) : socket_(socket) {}
+
+    void wakeDaemon() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (shm_->daemonWaiting.load(std::memory_order_relaxed)) {
+            ring(daemonDoorbell_);
+        }
+    }
+
+    int socket_;
+    SessionShm* shm_ = nullptr;
+    int daemonDoorbell_ = -1;
+    int clientDoorbell_ = -1;
+
+    std::mutex controlMutex_;   // One control message in flight
+    std::mutex commandMutex_;   // One producer on the command ring
+    uint64_t nextSeq_ = 0;
+};
+
+namespace {
+
+/**
+ * @brief Lines held through the daemon
+ */
+class DaemonLineRequest : public LineRequest {
+public:
+    DaemonLineRequest(std::shared_ptr<DaemonSession> session, uint32_t id, RequestShm* shm, int eventFd)
+        : session_(std::move(session)), id_(id), shm_(shm), eventFd_(eventFd) {}
+
+    ~DaemonLineRequest() override {
+        ControlMessage message{};
+        message.type = MessageType::RELEASE;
+        message.requestId = id_;
+        ControlReply reply;
+        session_->control(message, reply);
+        close(eventFd_);
+        unmapShared(shm_);
+    }
+
+    int setValue(unsigned int offset, bool value) override {
+        return session_->setValue(id_, offset, value);
+    }
+
+    int getValue(unsigned int offset) override {
+        return session_->getValue(id_, offset);
+    }
+
+    bool reconfigure(const std::vector<LineSettings>& lines) override {
+        if (lines.size() > MAX_REQUEST_LINES) {
+            errno = EINVAL;
+            return false;
+        }
+        ControlMessage message{};
+        message.type = MessageType::RECONFIGURE;
+        message.requestId = id_;
+        message.count = static_cast<uint32_t>(lines.size());
+        for (size_t i = 0; i < lines.size(); ++i) {
+            message.lines[i] = toWire(lines[i]);
+        }
+        ControlReply reply;
+        return session_->control(message, reply);
+    }
+
+    int fd() const override { return eventFd_; }
+
+    int waitEdgeEvents(int64_t timeoutNs) override {
+        if (!shm_->events.empty()) {
+            return 1;
+        }
+        pollfd pfd{eventFd_, POLLIN, 0};
+        timespec timeout;
+        timeout.tv_sec = static_cast<time_t>(timeoutNs / 1000000000LL);
+        timeout.tv_nsec = static_cast<long>(timeoutNs % 1000000000LL);
+        int ready = ppoll(&pfd, 1, timeoutNs < 0 ? nullptr : &timeout, nullptr);
+        return ready < 0 ? -1 : (ready > 0 ? 1 : 0);
+    }
+
+    int readEdgeEvents(LineEvent* events, size_t maxEvents) override {
+        drain(eventFd_);
+        size_t count = 0;
+        WireEvent wire;
+        while (count < maxEvents && shm_->events.pop(wire)) {
+            events[count].offset = wire.offset;
+            events[count].rising = wire.rising != 0;
+            events[count].timestampNs = wire.timestampNs;
+            events[count].globalSeqno = wire.globalSeqno;
+            events[count].lineSeqno = wire.lineSeqno;
+            ++count;
+        }
+        if (!shm_->events.empty()) {
+            ring(eventFd_);     // Keep fd() readable for the rest
+        }
+        return static_cast<int>(count);
+    }
+
+private:
+    std::shared_ptr<DaemonSession> session_;
+    uint32_t id_;
+    RequestShm* shm_;
+    int eventFd_;
+};
+
+/**
+ * @brief Chip opened through the daemon
+ */
+class DaemonChip : public GpioChip {
+public:
+    DaemonChip(std::shared_ptr<DaemonSession> session, const std::string& name, size_t numLines)
+        : GpioChip(name, DAEMON_CHIP_LABEL, numLines), session_(std::move(session)) {}
+
+    std::unique_ptr<LineRequest> requestLines(const std::string& /*consumer*/,
+                                              const std::vector<LineSettings>& lines,
+                                              size_t eventBufferSize) override {
+        return session_->requestLines(name(), lines, eventBufferSize);
+    }
+
+private:
+    std::shared_ptr<DaemonSession> session_;
+};
+
+} // namespace
+
+std::shared_ptr<GpioChip> DaemonSession::openChip(const std::string& name) {
+    ControlMessage message{};
+    message.type = MessageType::CHIP_INFO;
+    copyName(message.chip, name);
+    ControlReply reply;
+    if (!control(message, reply)) {
+        PIPINPP_LOG_WARNING("pipinppd: cannot open " << name << ": " << strerror(errno));
+        return nullptr;
+    }
+    return std::make_shared<DaemonChip>(shared_from_this(), name, reply.numLines);
+}
+
+std::unique_ptr<LineRequest> DaemonSession::requestLines(const std::string& chip,
+                                                         const std::vector<LineSettings>& lines,
+                                                         size_t eventBufferSize) {
+    if (lines.empty() || lines.size() > MAX_REQUEST_LINES) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    ControlMessage message{};
+    message.type = MessageType::REQUEST;
+    message.count = static_cast<uint32_t>(lines.size());
+    message.eventBufferSize = static_cast<uint32_t>(eventBufferSize);
+    copyName(message.chip, chip);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        message.lines[i] = toWire(lines[i]);
+    }
+
+    ControlReply reply;
+    int fds[MAX_MESSAGE_FDS];
+    size_t fdCount = 0;
+    if (!control(message, reply, fds, &fdCount)) {
+        return nullptr;
+    }
+    RequestShm* shm = fdCount == 2 ? mapShared<RequestShm>(fds[0]) : nullptr;
+    if (!shm) {
+        int saved = fdCount == 2 ? errno : EPROTO;
+        closeFds(fds, fdCount);
+        // Give the lines back
+        ControlMessage release{};
+        release.type = MessageType::RELEASE;
+        release.requestId = reply.requestId;
+        control(release, reply);
+        errno = saved;
+        return nullptr;
+    }
+    close(fds[0]);
+    return std::make_unique<DaemonLineRequest>(shared_from_this(), reply.requestId, shm, fds[1]);
+}
+
+GpioDaemonClient& GpioDaemonClient::getInstance() {
+    static GpioDaemonClient instance;
+    return instance;
+}
+
+bool GpioDaemonClient::connect(const std::string& socketPath) {
+    std::shared_ptr<DaemonSession> session = DaemonSession::connect(socketPath);
+    if (!session) {
+        PIPINPP_LOG_WARNING("pipinppd: cannot connect to " << socketPath << ": " << strerror(errno));
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        session_ = session;
+    }
+    ChipRegistry::getInstance().setChipFactory(
+        [session](const std::string& name) { return session->openChip(name); });
+    PIPINPP_LOG_INFO("Routing GPIO chips through pipinppd at " << socketPath);
+    return true;
+}
+
+void GpioDaemonClient::disconnect() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!session_) {
+            return;
+        }
+        session_.reset();   // Closed once the last chip and request let go
+    }
+    ChipRegistry::getInstance().setChipFactory(nullptr);
+}
+
+bool GpioDaemonClient::isConnected() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return session_ != nullptr;
+}
+
+uint64_t GpioDaemonClient::getFailedWrites() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return session_ ? session_->failedWrites() : 0;
+}
+
+} // namespace pipinpp
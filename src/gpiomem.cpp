@@ -0,0 +1,128 @@
+/**
+ * @file gpiomem.cpp
+ * @brief Implementation of memory-mapped GPIO register access
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "gpiomem.hpp"
+#include "log.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace pipinpp {
+
+namespace {
+
+// BCM2835 family: word offsets into the 4 KiB GPIO block
+constexpr size_t BCM_MAP_SIZE = 0x1000;
+constexpr size_t BCM_GPSET0 = 0x1C / 4;
+constexpr size_t BCM_GPCLR0 = 0x28 / 4;
+constexpr size_t BCM_GPLEV0 = 0x34 / 4;
+
+// RP1: /dev/gpiomem0 maps IO_BANK0 (0x00000), RIO0 (0x10000), PADS (0x20000)
+constexpr size_t RP1_MAP_SIZE = 0x30000;
+constexpr size_t RP1_RIO0 = 0x10000;
+constexpr size_t RP1_SET_ALIAS = 0x2000;
+constexpr size_t RP1_CLR_ALIAS = 0x3000;
+constexpr size_t RP1_RIO_OUT = 0x00;
+constexpr size_t RP1_RIO_SYNC_IN = 0x08;
+
+} // namespace
+
+// GpioMem Implementation
+
+GpioMemLayout GpioMem::layoutForLabel(const std::string& chipLabel) {
+    if (chipLabel.find("rp1") != std::string::npos) {
+        return GpioMemLayout::RP1;
+    }
+    if (chipLabel.find("bcm2835") != std::string::npos ||
+        chipLabel.find("bcm2711") != std::string::npos) {
+        return GpioMemLayout::BCM2835;
+    }
+    return GpioMemLayout::NONE;
+}
+
+GpioMem* GpioMem::forChipLabel(const std::string& chipLabel) {
+    switch (layoutForLabel(chipLabel)) {
+        case GpioMemLayout::BCM2835: {
+            static GpioMem bcm(GpioMemLayout::BCM2835);
+            return bcm.isMapped() ? &bcm : nullptr;
+        }
+        case GpioMemLayout::RP1: {
+            static GpioMem rp1(GpioMemLayout::RP1);
+            return rp1.isMapped() ? &rp1 : nullptr;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+GpioMem::GpioMem(GpioMemLayout layout)
+    : layout_(layout), base_(nullptr), mapSize_(0),
+      setReg_(nullptr), clrReg_(nullptr), levReg_(nullptr) {
+    const char* device = (layout == GpioMemLayout::RP1) ? "/dev/gpiomem0" : "/dev/gpiomem";
+    mapSize_ = (layout == GpioMemLayout::RP1) ? RP1_MAP_SIZE : BCM_MAP_SIZE;
+
+    int fd = ::open(device, O_RDWR | O_SYNC | O_CLOEXEC);
+    if (fd < 0) {
+        PIPINPP_LOG_WARNING("Cannot open " << device << ": " << strerror(errno)
+                            << " (falling back to libgpiod)");
+        return;
+    }
+
+    void* map = mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // Mapping stays valid after close
+
+    if (map == MAP_FAILED) {
+        PIPINPP_LOG_WARNING("Cannot mmap " << device << ": " << strerror(errno)
+                            << " (falling back to libgpiod)");
+        return;
+    }
+
+    base_ = static_cast<volatile uint32_t*>(map);
+
+    if (layout == GpioMemLayout::RP1) {
+        setReg_ = base_ + (RP1_RIO0 + RP1_SET_ALIAS + RP1_RIO_OUT) / 4;
+        clrReg_ = base_ + (RP1_RIO0 + RP1_CLR_ALIAS + RP1_RIO_OUT) / 4;
+        levReg_ = base_ + (RP1_RIO0 + RP1_RIO_SYNC_IN) / 4;
+    } else {
+        setReg_ = base_ + BCM_GPSET0;
+        clrReg_ = base_ + BCM_GPCLR0;
+        levReg_ = base_ + BCM_GPLEV0;
+    }
+
+    PIPINPP_LOG_INFO("Mapped " << device << " for direct GPIO register access");
+}
+
+GpioMem::~GpioMem() {
+    if (base_) {
+        munmap(const_cast<uint32_t*>(base_), mapSize_);
+        base_ = nullptr;
+    }
+}
+
+} // namespace pipinpp
@@ -0,0 +1,173 @@
+/**
+ * @file i2c_scan.cpp
+ * @brief Implementation of the concurrent multi-bus I2C scan
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "i2c_scan.hpp"
+#include "Wire.hpp"
+#include "cache_file.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr const char* CACHE_MAGIC = "pipinpp-i2c-scan 1";
+
+// Changes on every boot, so a cache never outlives the hardware it describes
+std::string bootId() {
+    std::ifstream file("/proc/sys/kernel/random/boot_id");
+    std::string id;
+    std::getline(file, id);
+    return id;
+}
+
+I2cBusScan scanBus(int bus) {
+    I2cBusScan result;
+    result.bus = bus;
+
+    WireClass wire;
+    if (!wire.begin(bus)) {
+        return result;
+    }
+    result.ok = true;
+    result.devices = wire.scan();
+    wire.end();
+    return result;
+}
+
+bool sameBuses(const std::vector<I2cBusScan>& results, const std::vector<int>& buses) {
+    if (results.size() != buses.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < buses.size(); ++i) {
+        if (results[i].bus != buses[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// I2C Scan Implementation
+// ============================================================================
+
+std::vector<I2cBusScan> scanI2cBuses(const I2cScanOptions& options) {
+    std::vector<int> buses = options.buses.empty() ? WireClass::availableBuses() : options.buses;
+    std::sort(buses.begin(), buses.end());
+    buses.erase(std::unique(buses.begin(), buses.end()), buses.end());
+
+    std::vector<I2cBusScan> results;
+    if (!options.cachePath.empty() && !options.refresh &&
+        loadI2cScanCache(options.cachePath, options.maxAgeSeconds, results) &&
+        sameBuses(results, buses)) {
+        PIPINPP_LOG_DEBUG("I2C scan: using cache " << options.cachePath);
+        return results;
+    }
+
+    results.assign(buses.size(), I2cBusScan());
+    std::vector<std::thread> workers;
+    workers.reserve(buses.size());
+    for (size_t i = 0; i < buses.size(); ++i) {
+        workers.emplace_back([&results, &buses, i]() { results[i] = scanBus(buses[i]); });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (!options.cachePath.empty() && !saveI2cScanCache(options.cachePath, results)) {
+        PIPINPP_LOG_WARNING("I2C scan: could not write cache " << options.cachePath);
+    }
+    return results;
+}
+
+bool loadI2cScanCache(const std::string& path, int maxAgeSeconds, std::vector<I2cBusScan>& results) {
+    std::string content;
+    time_t modified;
+    if (!readCacheFile(path, content, &modified)) {
+        return false;
+    }
+    if (difftime(time(nullptr), modified) > maxAgeSeconds) {
+        return false;
+    }
+
+    std::istringstream file(content);
+    std::string line;
+    if (!std::getline(file, line) || line != CACHE_MAGIC) {
+        return false;
+    }
+    if (!std::getline(file, line) || line != bootId()) {
+        return false;
+    }
+
+    // One line per bus: "<bus> <ok> <addr> <addr> ..."
+    std::vector<I2cBusScan> parsed;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        I2cBusScan bus;
+        int ok;
+        if (!(fields >> bus.bus >> ok)) {
+            return false;
+        }
+        bus.ok = (ok != 0);
+        int address;
+        while (fields >> address) {
+            if (address < 0 || address > 0x7F) {
+                return false;
+            }
+            bus.devices.push_back(static_cast<uint8_t>(address));
+        }
+        parsed.push_back(std::move(bus));
+    }
+
+    results = std::move(parsed);
+    return true;
+}
+
+bool saveI2cScanCache(const std::string& path, const std::vector<I2cBusScan>& results) {
+    std::ostringstream file;
+    file << CACHE_MAGIC << "\n" << bootId() << "\n";
+    for (const auto& bus : results) {
+        file << bus.bus << " " << (bus.ok ? 1 : 0);
+        for (uint8_t address : bus.devices) {
+            file << " " << static_cast<int>(address);
+        }
+        file << "\n";
+    }
+    return writeCacheFile(path, file.str());
+}
+
+std::string i2cScanDefaultCachePath() {
+    return runtimeCachePath("i2c-scan.cache");
+}
+
+} // namespace pipinpp
@@ -27,31 +27,234 @@
 
 #include "interrupts.hpp"
 #include "exceptions.hpp"
+#include "board.hpp"
 #include "log.hpp"
+#include "metrics.hpp"
+#include "thread_policy.hpp"
 #include <unistd.h>
-#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <vector>
 #include <algorithm>
+#include <deque>
+#include <iterator>
 #include <cstring>  // for strerror
+#include <time.h>
 
-// InterruptHandler destructor
-InterruptHandler::~InterruptHandler() {
-    active = false;
-    
-    if (event_buffer) {
-        gpiod_edge_event_buffer_free(event_buffer);
-        event_buffer = nullptr;
+namespace {
+
+// "GPIO pin 17" or "GPIO pins 17, 22, 27" for error messages
+std::string describePins(const std::vector<InterruptHandler*>& members) {
+    std::string target = (members.size() == 1) ? "GPIO pin " : "GPIO pins ";
+    for (size_t i = 0; i < members.size(); ++i) {
+        if (i > 0) {
+            target += ", ";
+        }
+        target += std::to_string(members[i]->pin);
     }
-    
-    if (request) {
-        gpiod_line_request_release(request);
-        request = nullptr;
+    return target;
+}
+
+// Set on callback worker threads, which must never wait for a worker
+thread_local bool t_callback_worker = false;
+
+// Upper bound on a queued pin's callback queue
+constexpr size_t MAX_CALLBACK_QUEUE_DEPTH = 65536;
+
+} // namespace
+
+/**
+ * @brief Worker threads running queued (DEDICATED or POOL) interrupt callbacks
+ *
+ * The monitor thread schedules a handler after queueing its events. A
+ * handler is on at most one worker at a time (InterruptHandler::scheduled),
+ * which keeps each pin's callbacks in edge order; idle workers take
+ * whichever pin is ready next. Each worker holds a reference to the
+ * executor until it exits, so shutdown() may run on a worker.
+ */
+class CallbackExecutor : public std::enable_shared_from_this<CallbackExecutor> {
+public:
+    static std::shared_ptr<CallbackExecutor> create(size_t threads, const std::string& name) {
+        std::shared_ptr<CallbackExecutor> executor(new CallbackExecutor());
+        std::lock_guard<std::mutex> lock(executor->mutex_);
+        for (size_t i = 0; i < threads; ++i) {
+            executor->threads_.emplace_back([self = executor, name] { self->workerLoop(name); });
+        }
+        return executor;
     }
-    
-    if (chip) {
-        gpiod_chip_close(chip);
-        chip = nullptr;
+
+    ~CallbackExecutor() {
+        shutdown();
+    }
+
+    /**
+     * @brief Queue a handler for a worker unless it already is (monitor thread)
+     */
+    void schedule(InterruptHandler* handler) {
+        // Pairs with the fence in workerLoop(): either the worker sees the
+        // new events or this exchange sees scheduled == false
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (handler->scheduled.exchange(true)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(handler);
+        }
+        cv_.notify_one();
+    }
+
+    /**
+     * @brief Wait until no worker holds @p handler
+     */
+    void waitIdle(InterruptHandler* handler) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [handler] { return !handler->scheduled.load(); });
+    }
+
+    /**
+     * @brief Free an inactive handler now if idle, else after its worker lets go
+     */
+    void retire(std::unique_ptr<InterruptHandler> handler) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (handler->scheduled) {
+                retired_.push_back(std::move(handler));
+                return;
+            }
+        }
+        handler.reset();
     }
+
+    /**
+     * @brief Stop the workers (joined, or detached when called on one of them)
+     */
+    void shutdown() {
+        std::vector<std::thread> threads;
+        std::vector<std::unique_ptr<InterruptHandler>> retired;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            threads.swap(threads_);
+            for (InterruptHandler* handler : ready_) {
+                handler->scheduled = false;
+            }
+            ready_.clear();
+        }
+        cv_.notify_all();
+        idle_cv_.notify_all();
+        for (std::thread& thread : threads) {
+            if (thread.get_id() == std::this_thread::get_id()) {
+                thread.detach();
+            } else if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retired.swap(retired_);
+        }
+    }
+
+private:
+    CallbackExecutor() = default;
+
+    void workerLoop(const std::string& name) {
+        t_callback_worker = true;
+        pipinpp::ThreadPolicyManager::getInstance().applyToCurrentThread(name);
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+            if (stopping_) {
+                break;
+            }
+            InterruptHandler* handler = ready_.front();
+            ready_.pop_front();
+            lock.unlock();
+            
+            drain(*handler);
+            
+            std::vector<std::unique_ptr<InterruptHandler>> finished;
+            lock.lock();
+            handler->scheduled = false;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool again = handler->active && handler->queue->size() > 0 && !handler->scheduled.exchange(true);
+            if (again) {
+                ready_.push_back(handler);          // Events queued while the callback ran
+            }
+            auto idle = std::stable_partition(retired_.begin(), retired_.end(),
+                                              [](const std::unique_ptr<InterruptHandler>& h) { return h->scheduled.load(); });
+            std::move(idle, retired_.end(), std::back_inserter(finished));
+            retired_.erase(idle, retired_.end());
+            lock.unlock();
+            
+            idle_cv_.notify_all();
+            if (again) {
+                cv_.notify_one();
+            }
+            finished.clear();                       // May shut this executor down
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief Run the callback for every queued event of one handler
+     */
+    static void drain(InterruptHandler& handler) {
+        pipinpp::SpscRing<EdgeEvent>& queue = *handler.queue;
+        std::vector<EdgeEvent>& events = handler.worker_events;
+        size_t count;
+        while ((count = queue.pop(events.data(), events.size())) > 0) {
+            if (!handler.active) {
+                continue;                           // Detached: discard
+            }
+            PIPINPP_METRIC_RECORD("interrupt_dispatch_ns",
+                                  static_cast<uint64_t>(PIPINPP_METRIC_NOW_NS()) - events[0].timestampNs);
+            size_t calls = handler.batch_callback ? 1 : count;
+            for (size_t i = 0; i < calls && handler.active; ++i) {
+                try {
+                    if (handler.batch_callback) {
+                        handler.batch_callback(EdgeEventSpan(events.data(), count));
+                    } else {
+                        handler.callback();
+                    }
+                } catch (const std::exception& e) {
+                    PIPINPP_LOG_ERROR("Exception in interrupt callback for pin " 
+                             << handler.pin << ": " << e.what());
+                } catch (...) {
+                    PIPINPP_LOG_ERROR("Unknown exception in interrupt callback for pin " << handler.pin);
+                }
+            }
+            handler.delivered.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;                             ///< Signals ready_ or stopping_
+    std::condition_variable idle_cv_;                        ///< Signals a handler leaving its worker
+    std::deque<InterruptHandler*> ready_;                    ///< Scheduled handlers not yet on a worker
+    std::vector<std::unique_ptr<InterruptHandler>> retired_; ///< Detached while on a worker
+    std::vector<std::thread> threads_;
+    bool stopping_ = false;
+};
+
+InterruptHandler::~InterruptHandler() {
+    if (executor) {
+        executor->waitIdle(this);
+        if (dispatch == CallbackDispatch::DEDICATED) {
+            executor->shutdown();
+        }
+    }
+}
+
+// EdgeRequest destructor
+EdgeRequest::~EdgeRequest() {
+    active = false;
+    
+    // Release the lines before the chip they came from
+    request.reset();
+    chip.reset();
 }
 
 // InterruptManager implementation
@@ -62,12 +265,33 @@ InterruptManager& InterruptManager::getInstance() {
 }
 
 InterruptManager::InterruptManager() 
-    : running_(false), shutdown_requested_(false) {
-    // Create wakeup pipe for signaling the monitor thread
-    if (pipe(wakeup_pipe_) == -1) {
+    : pool_threads_(2), adaptive_max_(0), reconfiguring_(false), merge_requests_(false), running_(false), shutdown_requested_(false), 
+      epoll_fd_(-1), wakeup_fd_(-1), epoch_(0) {
+    // Persistent epoll set; line requests are added/removed as pins attach/detach
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1) {
+        throw GpioAccessError("interrupt system", 
+                            "Failed to create epoll instance for interrupt monitoring");
+    }
+    
+    // eventfd wakes the monitor thread for shutdown (no periodic timeout)
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd_ == -1) {
+        close(epoll_fd_);
+        throw GpioAccessError("interrupt system", 
+                            "Failed to create wakeup eventfd for interrupt monitoring");
+    }
+    
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr; // nullptr marks the wakeup eventfd
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev) == -1) {
+        close(wakeup_fd_);
+        close(epoll_fd_);
         throw GpioAccessError("interrupt system", 
-                            "Failed to create wakeup pipe for interrupt monitoring");
+                            "Failed to register wakeup eventfd with epoll");
     }
+    
     PIPINPP_LOG_DEBUG("InterruptManager initialized");
 }
 
@@ -75,148 +299,384 @@ InterruptManager::~InterruptManager() {
     PIPINPP_LOG_DEBUG("InterruptManager shutting down");
     stopMonitoring();
     
-    // Clean up all handlers
-    std::lock_guard<std::mutex> lock(mutex_);
-    handlers_.clear();
+    // Clean up all requests and handlers
+    std::map<int, std::unique_ptr<InterruptHandler>> handlers;
+    std::shared_ptr<CallbackExecutor> pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        merged_.clear();
+        requests_.clear();
+        retired_.clear();
+        handlers.swap(handlers_);
+        pool.swap(pool_);
+    }
+    handlers.clear();       // Waits for queued callbacks in progress, without mutex_
+    if (pool) {
+        pool->shutdown();
+    }
     
-    // Close wakeup pipe
-    close(wakeup_pipe_[0]);
-    close(wakeup_pipe_[1]);
+    close(wakeup_fd_);
+    close(epoll_fd_);
+}
+
+
+void InterruptManager::wakeMonitor() {
+    uint64_t one = 1;
+    ssize_t result = write(wakeup_fd_, &one, sizeof(one));
+    (void)result; // Intentionally ignore - counter overflow is impossible in practice
+}
+
+bool InterruptManager::onMonitorThread() const {
+    return running_ && std::this_thread::get_id() == monitor_thread_.get_id();
 }
 
 void InterruptManager::attachInterrupt(int pin, InterruptCallback callback, 
                                        InterruptMode mode, const std::string& chipname) {
-    // Validate pin number (0-27 for Raspberry Pi)
-    if (pin < 0 || pin > 27) {
-        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
-                            " (must be 0-27 for Raspberry Pi)");
+    if (!callback) {
+        throw InvalidPinError("Interrupt callback cannot be null");
     }
     
+    std::unique_lock<std::mutex> lock(mutex_);
+    checkAttachable(pin);
+    
+    // Create new handler
+    auto handler = std::make_unique<InterruptHandler>();
+    handler->pin = pin;
+    handler->callback = std::move(callback);
+    handler->mode = mode;
+    
+    registerHandler(std::move(handler), chipname, lock);
+}
+
+void InterruptManager::attachInterruptBatch(int pin, EdgeBatchCallback callback, InterruptMode mode,
+                                            size_t bufferSize, const std::string& chipname) {
     if (!callback) {
         throw InvalidPinError("Interrupt callback cannot be null");
     }
     
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (bufferSize == 0 || bufferSize > MAX_EVENT_BUFFER_SIZE) {
+        throw InvalidPinError("Event buffer size must be between 1 and 1024 (got " +
+                            std::to_string(bufferSize) + ")");
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    checkAttachable(pin);
+    
+    auto handler = std::make_unique<InterruptHandler>();
+    handler->pin = pin;
+    handler->batch_callback = std::move(callback);
+    handler->mode = mode;
+    handler->buffer_size = bufferSize;
+    
+    registerHandler(std::move(handler), chipname, lock);
+}
+
+void InterruptManager::checkAttachable(int pin) const {
+    // Validate pin number (0-27 for Raspberry Pi)
+    if (!pipinpp::isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
+                            " (must be 0-27 for Raspberry Pi)");
+    }
     
     // Check if interrupt already attached
     if (handlers_.find(pin) != handlers_.end()) {
         throw GpioAccessError("GPIO pin " + std::to_string(pin), 
                             "Interrupt already attached. Call detachInterrupt() first");
     }
+}
+
+void InterruptManager::registerHandler(std::unique_ptr<InterruptHandler> handler,
+                                       const std::string& chipname,
+                                       std::unique_lock<std::mutex>& lock) {
+    int pin = handler->pin;
+    InterruptHandler* raw = handler.get();
     
-    // Create new handler
-    auto handler = std::make_unique<InterruptHandler>();
-    handler->pin = pin;
-    handler->callback = callback;
-    handler->mode = mode;
-    
-    // Open GPIO chip (prepend /dev/ if not already present)
-    std::string chip_path = chipname;
-    if (chipname.find("/dev/") != 0) {
-        chip_path = "/dev/" + chipname;
+    auto debounce = debounce_us_.find(pin);
+    if (debounce != debounce_us_.end()) {
+        raw->debounce_us = debounce->second;
     }
-    handler->chip = gpiod_chip_open(chip_path.c_str());
-    if (!handler->chip) {
-        throw GpioAccessError("Failed to open GPIO chip: " + chip_path);
+    setupDispatch(*raw);
+    
+    // Get shared chip handle (accepts "gpiochip0" or "/dev/gpiochip0")
+    std::shared_ptr<pipinpp::GpioChip> chip = pipinpp::ChipRegistry::getInstance().acquire(chipname);
+    
+    if (!merge_requests_) {
+        // One request (and one fd) per pin
+        addRequest(createRequest(chip, {raw}, false));
+        handlers_[pin] = std::move(handler);
+    } else {
+        if (onMonitorThread()) {
+            throw GpioAccessError("GPIO pin " + std::to_string(pin),
+                                "Merged interrupts cannot be attached from inside an interrupt callback");
+        }
+        
+        // One rebuild at a time; re-check since the lock may have been released
+        reconfig_cv_.wait(lock, [this] { return !reconfiguring_; });
+        checkAttachable(pin);
+        reconfiguring_ = true;
+        
+        // Lines cannot be added to an existing request: release it and
+        // request all lines again (edges in between may be missed)
+        std::vector<InterruptHandler*> members;
+        auto it = merged_.find(chip->name());
+        if (it != merged_.end()) {
+            std::unique_ptr<EdgeRequest> old = removeRequest(it->second, lock);
+            for (InterruptHandler* member : old->members) {
+                if (member->active) {
+                    members.push_back(member);
+                }
+            }
+            old.reset();
+        }
+        
+        members.push_back(raw);
+        try {
+            addRequest(createRequest(chip, members, true));
+        } catch (...) {
+            // Put the other pins back the way they were
+            members.pop_back();
+            if (!members.empty()) {
+                try {
+                    addRequest(createRequest(chip, members, true));
+                } catch (const std::exception& e) {
+                    PIPINPP_LOG_ERROR("Failed to restore merged interrupts on " << chip->name()
+                                      << ", detaching " << describePins(members) << ": " << e.what());
+                    for (InterruptHandler* member : members) {
+                        auto node = handlers_.find(member->pin);
+                        member->active = false;
+                        releaseHandler(std::move(node->second));
+                        handlers_.erase(node);
+                    }
+                }
+            }
+            reconfiguring_ = false;
+            reconfig_cv_.notify_all();
+            throw;
+        }
+        
+        handlers_[pin] = std::move(handler);
+        reconfiguring_ = false;
+        reconfig_cv_.notify_all();
     }
     
-    // Configure line settings for edge detection
-    gpiod_line_settings* settings = gpiod_line_settings_new();
-    if (!settings) {
-        gpiod_chip_close(handler->chip);
-        throw GpioAccessError("GPIO pin " + std::to_string(pin), 
-                            "Failed to create line settings for interrupt");
+    PIPINPP_LOG_INFO("Interrupt attached to pin " << pin);
+    
+    // Start monitoring thread if not already running
+    if (!running_) {
+        startMonitoring();
+    }
+}
+
+std::vector<pipinpp::LineSettings> InterruptManager::buildLineSettings(const std::vector<InterruptHandler*>& members) {
+    std::vector<pipinpp::LineSettings> lines(members.size());
+    for (size_t i = 0; i < members.size(); ++i) {
+        // Input with this member's edge mode and, unless filtered in dispatch, kernel debounce
+        lines[i].offset = static_cast<unsigned int>(members[i]->pin);
+        lines[i].direction = GPIOD_LINE_DIRECTION_INPUT;
+        lines[i].edge = modeToEdge(members[i]->mode);
+        if (members[i]->software_debounce_us == 0) {
+            lines[i].debounceUs = members[i]->debounce_us;
+        }
     }
+    return lines;
+}
+
+std::unique_ptr<EdgeRequest> InterruptManager::createRequest(std::shared_ptr<pipinpp::GpioChip> chip,
+                                                             const std::vector<InterruptHandler*>& members,
+                                                             bool merged) {
+    std::string target = describePins(members);
     
-    // Set as input with edge detection
-    gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
-    gpiod_line_settings_set_edge_detection(settings, modeToEdge(mode));
+    auto request = std::make_unique<EdgeRequest>();
+    request->chip = chip;
+    request->merged = merged;
+    request->members = members;
     
-    // Create line config
-    gpiod_line_config* line_cfg = gpiod_line_config_new();
-    if (!line_cfg) {
-        gpiod_line_settings_free(settings);
-        gpiod_chip_close(handler->chip);
-        throw GpioAccessError("GPIO pin " + std::to_string(pin), 
-                            "Failed to create line config for interrupt");
+    size_t buffer_size = 0;
+    unsigned int max_offset = 0;
+    for (InterruptHandler* member : members) {
+        buffer_size += member->buffer_size;
+        max_offset = std::max(max_offset, static_cast<unsigned int>(member->pin));
     }
+    buffer_size = std::min(buffer_size, MAX_EVENT_BUFFER_SIZE);
     
-    unsigned int pin_offset = static_cast<unsigned int>(pin);
-    gpiod_line_config_add_line_settings(line_cfg, &pin_offset, 1, settings);
+    // Request the lines, one settings entry per member (each with its own edge mode)
+    request->request = chip->requestLines("PiPinPP-Interrupt", buildLineSettings(members), buffer_size);
     
-    // Create request config
-    gpiod_request_config* req_cfg = gpiod_request_config_new();
-    if (!req_cfg) {
-        gpiod_line_config_free(line_cfg);
-        gpiod_line_settings_free(settings);
-        gpiod_chip_close(handler->chip);
-        throw GpioAccessError("GPIO pin " + std::to_string(pin), 
-                            "Failed to create request config for interrupt");
+    // Kernel without debounce support: retry with the dispatcher filter
+    bool kernel_debounce = false;
+    for (InterruptHandler* member : members) {
+        kernel_debounce = kernel_debounce || (member->debounce_us > 0 && member->software_debounce_us == 0);
+    }
+    if (!request->request && kernel_debounce) {
+        for (InterruptHandler* member : members) {
+            if (member->debounce_us > 0) {
+                member->software_debounce_us = member->debounce_us;
+            }
+        }
+        request->request = chip->requestLines("PiPinPP-Interrupt", buildLineSettings(members), buffer_size);
+        if (request->request) {
+            PIPINPP_LOG_INFO("Kernel debounce unavailable for " << target << ", filtering edges by timestamp");
+        }
     }
     
-    gpiod_request_config_set_consumer(req_cfg, "PiPinPP-Interrupt");
-    gpiod_request_config_set_event_buffer_size(req_cfg, 16);
+    if (!request->request) {
+        throw GpioAccessError(target, "Failed to request line for interrupt");
+    }
     
-    // Request the line
-    handler->request = gpiod_chip_request_lines(handler->chip, req_cfg, line_cfg);
+    request->event_buffer.resize(buffer_size);
     
-    // Clean up config objects
-    gpiod_request_config_free(req_cfg);
-    gpiod_line_config_free(line_cfg);
-    gpiod_line_settings_free(settings);
+    // Route events by line offset; batch storage covers a full read
+    request->by_offset.assign(max_offset + 1, nullptr);
+    for (InterruptHandler* member : members) {
+        request->by_offset[member->pin] = member;
+        member->owner = request.get();
+        member->pending = 0;
+        member->last_line_seqno = 0;    // Numbering restarts with the request
+        if (member->batch_callback) {
+            member->events.resize(buffer_size);
+        }
+        member->active = true;
+    }
     
-    if (!handler->request) {
-        gpiod_chip_close(handler->chip);
-        throw GpioAccessError("Failed to request line for pin " + std::to_string(pin));
+    request->active = true;
+    return request;
+}
+
+void InterruptManager::addRequest(std::unique_ptr<EdgeRequest> request) {
+    // Register once; the request pointer rides along in epoll_data
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = request.get();
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, request->request->fd(), &ev) == -1) {
+        throw GpioAccessError(describePins(request->members), 
+                            std::string("Failed to add interrupt to epoll set: ") + strerror(errno));
     }
     
-    // Create event buffer
-    handler->event_buffer = gpiod_edge_event_buffer_new(16);
-    if (!handler->event_buffer) {
-        gpiod_line_request_release(handler->request);
-        gpiod_chip_close(handler->chip);
-        throw GpioAccessError("GPIO pin " + std::to_string(pin), 
-                            "Failed to create edge event buffer for interrupt");
+    if (request->merged) {
+        merged_[request->chip->name()] = request.get();
     }
+    requests_.push_back(std::move(request));
+}
+
+std::unique_ptr<EdgeRequest> InterruptManager::removeRequest(EdgeRequest* request,
+                                                             std::unique_lock<std::mutex>& lock) {
+    // Stop dispatching and drop the fd from the epoll set
+    request->active = false;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, request->request->fd(), nullptr);
     
-    handler->active = true;
+    auto merged = merged_.find(request->chip->name());
+    if (merged != merged_.end() && merged->second == request) {
+        merged_.erase(merged);
+    }
     
-    // Add to handlers map
-    handlers_[pin] = std::move(handler);
+    std::unique_ptr<EdgeRequest> owned;
+    auto it = std::find_if(requests_.begin(), requests_.end(),
+                           [request](const std::unique_ptr<EdgeRequest>& r) { return r.get() == request; });
+    if (it != requests_.end()) {
+        owned = std::move(*it);
+        requests_.erase(it);
+    }
     
-    PIPINPP_LOG_INFO("Interrupt attached to pin " << pin);
+    if (onMonitorThread()) {
+        // Removed from inside a callback: the monitor thread may still hold
+        // this pointer, so it frees the request after the current dispatch
+        retired_.push_back(std::move(owned));
+        return nullptr;
+    }
     
-    // Start monitoring thread if not already running
-    if (!running_) {
-        startMonitoring();
-    } else {
-        // Wake up the monitor thread to reconfigure poll
-        char wake = '1';
-        ssize_t result = write(wakeup_pipe_[1], &wake, 1);
-        (void)result; // Intentionally ignore - wakeup is best-effort
+    if (running_) {
+        // An epoll_wait() that started before EPOLL_CTL_DEL may still return
+        // this request. Wait for the monitor to finish that iteration.
+        uint64_t epoch = epoch_;
+        wakeMonitor();
+        epoch_cv_.wait(lock, [this, epoch] { return epoch_ != epoch || !running_ || shutdown_requested_; });
     }
+    
+    return owned;
 }
 
 bool InterruptManager::detachInterrupt(int pin) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool monitor = onMonitorThread();
     
     auto it = handlers_.find(pin);
+    while (!monitor && reconfiguring_ && it != handlers_.end() && it->second->owner->merged) {
+        // Wait for a concurrent rebuild of this pin's request to finish
+        reconfig_cv_.wait(lock);
+        it = handlers_.find(pin);
+    }
+    
     if (it == handlers_.end()) {
         return false; // No interrupt attached
     }
     
-    // Remove handler (destructor will clean up resources)
+    std::unique_ptr<InterruptHandler> handler = std::move(it->second);
     handlers_.erase(it);
+    handler->active = false;
+    EdgeRequest* request = handler->owner;
     
-    PIPINPP_LOG_INFO("Interrupt detached from pin " << pin);
+    if (monitor) {
+        // Detached from inside a callback: dispatch stops now, the handler
+        // is freed together with its request (queued ones by their worker)
+        if (handler->executor) {
+            releaseHandler(std::move(handler));
+        } else {
+            request->detached.push_back(std::move(handler));
+        }
+        if (!request->merged) {
+            removeRequest(request, lock);
+        }
+        PIPINPP_LOG_INFO("Interrupt detached from pin " << pin);
+        return true;
+    }
     
-    // Wake up the monitor thread to reconfigure poll
-    if (running_) {
-        char wake = '1';
-        ssize_t result = write(wakeup_pipe_[1], &wake, 1);
-        (void)result; // Intentionally ignore - wakeup is best-effort
+    std::unique_ptr<EdgeRequest> old;
+    if (!request->merged) {
+        old = removeRequest(request, lock);
+    } else {
+        // Re-request the remaining lines of the chip without this pin
+        reconfiguring_ = true;
+        old = removeRequest(request, lock);
+        
+        std::vector<InterruptHandler*> members;
+        for (InterruptHandler* member : old->members) {
+            if (member->active) {
+                members.push_back(member);
+            }
+        }
+        std::shared_ptr<pipinpp::GpioChip> chip = old->chip;
+        old.reset();
+        
+        if (!members.empty()) {
+            try {
+                addRequest(createRequest(chip, members, true));
+            } catch (const std::exception& e) {
+                PIPINPP_LOG_ERROR("Failed to re-request merged interrupts on " << chip->name()
+                                  << ", detaching " << describePins(members) << ": " << e.what());
+                for (InterruptHandler* member : members) {
+                    auto node = handlers_.find(member->pin);
+                    member->active = false;
+                    releaseHandler(std::move(node->second));
+                    handlers_.erase(node);
+                }
+            }
+        }
+        reconfiguring_ = false;
+        reconfig_cv_.notify_all();
+    }
+    
+    // Destroying the request here releases the line before we return,
+    // so the pin can be reconfigured immediately
+    lock.unlock();
+    old.reset();
+    if (t_callback_worker) {
+        releaseHandler(std::move(handler));     // Waiting here could deadlock the pool
+    } else {
+        handler.reset();                        // Waits for a queued callback in progress
     }
     
+    PIPINPP_LOG_INFO("Interrupt detached from pin " << pin);
+    
     return true;
 }
 
@@ -230,6 +690,16 @@ size_t InterruptManager::getActiveCount() const {
     return handlers_.size();
 }
 
+void InterruptManager::setMergeRequests(bool enable) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    merge_requests_ = enable;
+}
+
+bool InterruptManager::getMergeRequests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return merge_requests_;
+}
+
 void InterruptManager::startMonitoring() {
     if (running_) {
         return; // Already running
@@ -253,130 +723,415 @@ void InterruptManager::stopMonitoring() {
     running_ = false;
     
     // Wake up the monitor thread
-    char wake = '1';
-    ssize_t result = write(wakeup_pipe_[1], &wake, 1);
-    (void)result; // Intentionally ignore - wakeup is best-effort
+    wakeMonitor();
     
     // Wait for thread to finish
     if (monitor_thread_.joinable()) {
         monitor_thread_.join();
     }
     
+    // Release anyone waiting in detachInterrupt()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++epoch_;
+        retired_.clear();
+    }
+    epoch_cv_.notify_all();
+    
     PIPINPP_LOG_DEBUG("Interrupt monitoring thread stopped");
 }
 
 void InterruptManager::monitorThread() {
     PIPINPP_LOG_DEBUG("Monitor thread running");
+    pipinpp::ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-irq");
+    
+    epoll_event ready[MAX_EPOLL_EVENTS];
     
     while (!shutdown_requested_) {
-        std::vector<pollfd> poll_fds;
-        std::vector<int> pin_map; // Maps poll_fds index to pin number
+        // Block until an edge or a wakeup; no periodic timeout
+        int count = epoll_wait(epoll_fd_, ready, MAX_EPOLL_EVENTS, -1);
         
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue; // Interrupted by signal, retry
+            }
+            PIPINPP_LOG_ERROR("epoll_wait() failed: " << strerror(errno));
+            shutdown_requested_ = true; // Unblocks pending detachInterrupt() calls
+            break;
+        }
+        
+        for (int i = 0; i < count; ++i) {
+            auto* request = static_cast<EdgeRequest*>(ready[i].data.ptr);
+            if (!request) {
+                // Wakeup eventfd: drain the counter
+                uint64_t value;
+                ssize_t bytes_read = read(wakeup_fd_, &value, sizeof(value));
+                (void)bytes_read; // Intentionally ignore - just clearing the counter
+                continue;
+            }
+            
+            if (request->active) {
+                dispatchEvents(*request);
+            }
+        }
+        
+        if (!grow_.empty()) {
+            growRequests();
+        }
+        
+        // Iteration done: no pointer from this epoll_wait() is used any more
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            
-            // Add wakeup pipe
-            pollfd wakeup_fd;
-            wakeup_fd.fd = wakeup_pipe_[0];
-            wakeup_fd.events = POLLIN;
-            wakeup_fd.revents = 0;
-            poll_fds.push_back(wakeup_fd);
-            pin_map.push_back(-1); // -1 indicates wakeup pipe
-            
-            // Add all active interrupt handlers
-            for (auto& pair : handlers_) {
-                if (pair.second->active) {
-                    pollfd pfd;
-                    pfd.fd = gpiod_line_request_get_fd(pair.second->request);
-                    pfd.events = POLLIN;
-                    pfd.revents = 0;
-                    poll_fds.push_back(pfd);
-                    pin_map.push_back(pair.first);
-                }
+            ++epoch_;
+            retired_.clear();
+        }
+        epoch_cv_.notify_all();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++epoch_;
+    }
+    epoch_cv_.notify_all();
+    
+    PIPINPP_LOG_DEBUG("Monitor thread exiting");
+}
+
+void InterruptManager::dispatchEvents(EdgeRequest& request) {
+    // Read edge events (every member line of the request at once)
+    int num_events = request.request->readEdgeEvents(request.event_buffer.data(), request.event_buffer.size());
+    
+    if (num_events <= 0) {
+        return;
+    }
+    
+    for (int j = 0; j < num_events; ++j) {
+        const pipinpp::LineEvent& event = request.event_buffer[static_cast<size_t>(j)];
+        
+        // Demultiplex by line offset
+        unsigned int offset = event.offset;
+        InterruptHandler* handler = (offset < request.by_offset.size()) ? request.by_offset[offset] : nullptr;
+        if (!handler || !handler->active) {
+            continue;
+        }
+        
+        // Line sequence numbers are consecutive unless the kernel overwrote edges
+        if (event.lineSeqno > handler->last_line_seqno + 1) {
+            uint64_t gap = event.lineSeqno - handler->last_line_seqno - 1;
+            handler->lost.fetch_add(gap, std::memory_order_relaxed);
+            PIPINPP_METRIC_COUNT("interrupt_lost_events", gap);
+            if (!request.grow && request.event_buffer.size() < adaptive_max_.load(std::memory_order_relaxed)) {
+                request.grow = true;
+                grow_.push_back(&request);
             }
         }
+        handler->last_line_seqno = event.lineSeqno;
         
-        if (poll_fds.size() == 1) {
-            // Only wakeup pipe, no active interrupts
-            // Wait for new interrupts to be attached
-            poll(poll_fds.data(), poll_fds.size(), -1);
-            
-            // Clear wakeup pipe
-            char buf[16];
-            ssize_t bytes_read = read(wakeup_pipe_[0], buf, sizeof(buf));
-            (void)bytes_read; // Intentionally ignore - just clearing the pipe
+        // Software debounce: drop edges too close to the last accepted one
+        uint32_t filter_us = handler->software_debounce_us.load(std::memory_order_relaxed);
+        if (filter_us > 0) {
+            if (handler->last_edge_ns != 0 &&
+                event.timestampNs - handler->last_edge_ns < static_cast<uint64_t>(filter_us) * 1000) {
+                continue;
+            }
+            handler->last_edge_ns = event.timestampNs;
+        }
+        
+        if (handler->executor) {
+            // Queued dispatch: hand the edge over, never wait for the worker
+            EdgeEvent queued;
+            queued.pin = static_cast<int>(offset);
+            queued.type = event.rising ? EdgeType::RISING : EdgeType::FALLING;
+            queued.timestampNs = event.timestampNs;
+            queued.globalSeqno = event.globalSeqno;
+            queued.lineSeqno = event.lineSeqno;
+            if (handler->queue->push(&queued, 1) == 1) {
+                ++handler->pending;
+            } else {
+                handler->dropped.fetch_add(1, std::memory_order_relaxed);
+                PIPINPP_METRIC_COUNT("interrupt_queue_drops", 1);
+            }
             continue;
         }
         
-        // Wait for events (timeout 100ms to check shutdown flag periodically)
-        int ret = poll(poll_fds.data(), poll_fds.size(), 100);
+        if (handler->batch_callback) {
+            // Collect into the preallocated batch, delivered below
+            if (handler->pending < handler->events.size()) {
+                EdgeEvent& out = handler->events[handler->pending++];
+                out.pin = static_cast<int>(offset);
+                out.type = event.rising ? EdgeType::RISING : EdgeType::FALLING;
+                out.timestampNs = event.timestampNs;
+                out.globalSeqno = event.globalSeqno;
+                out.lineSeqno = event.lineSeqno;
+            }
+            continue;
+        }
         
-        if (ret < 0) {
-            if (errno == EINTR) {
-                continue; // Interrupted by signal, retry
+        // Edge timestamps use CLOCK_MONOTONIC (the libgpiod default event clock)
+        PIPINPP_METRIC_RECORD("interrupt_dispatch_ns",
+                              static_cast<uint64_t>(PIPINPP_METRIC_NOW_NS()) - event.timestampNs);
+        
+        // Invoke callback
+        try {
+            handler->callback();
+        } catch (const std::exception& e) {
+            PIPINPP_LOG_ERROR("Exception in interrupt callback for pin " 
+                     << handler->pin << ": " << e.what());
+        } catch (...) {
+            PIPINPP_LOG_ERROR("Unknown exception in interrupt callback for pin " << handler->pin);
+        }
+    }
+    
+    // One batch per pin for this read
+    for (InterruptHandler* handler : request.members) {
+        size_t count = handler->pending;
+        if (count == 0) {
+            continue;
+        }
+        handler->pending = 0;
+        if (!handler->active) {
+            continue;
+        }
+        
+        if (handler->executor) {
+            size_t depth = handler->queue->size();
+            if (depth > handler->max_depth.load(std::memory_order_relaxed)) {
+                handler->max_depth.store(depth, std::memory_order_relaxed);
             }
-            PIPINPP_LOG_ERROR("poll() failed: " << strerror(errno));
-            break;
+            PIPINPP_METRIC_RECORD("interrupt_queue_depth", depth);
+            handler->executor->schedule(handler);
+            continue;
         }
         
-        if (ret == 0) {
-            continue; // Timeout, check shutdown flag
+        // Measured from the oldest edge of the batch
+        PIPINPP_METRIC_RECORD("interrupt_dispatch_ns",
+                              static_cast<uint64_t>(PIPINPP_METRIC_NOW_NS()) - handler->events[0].timestampNs);
+        
+        try {
+            handler->batch_callback(EdgeEventSpan(handler->events.data(), count));
+        } catch (const std::exception& e) {
+            PIPINPP_LOG_ERROR("Exception in interrupt callback for pin " 
+                     << handler->pin << ": " << e.what());
+        } catch (...) {
+            PIPINPP_LOG_ERROR("Unknown exception in interrupt callback for pin " << handler->pin);
+        }
+    }
+}
+
+void InterruptManager::setDebounce(int pin, uint32_t periodUs) {
+    if (!pipinpp::isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
+                            " (must be 0-27 for Raspberry Pi)");
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!onMonitorThread()) {
+        reconfig_cv_.wait(lock, [this] { return !reconfiguring_; });
+    }
+    if (periodUs > 0) {
+        debounce_us_[pin] = periodUs;
+    } else {
+        debounce_us_.erase(pin);
+    }
+    
+    auto it = handlers_.find(pin);
+    if (it == handlers_.end() || !it->second->owner) {
+        return;     // Applied on the next attach
+    }
+    
+    // Reconfigure the live request (every member line must be listed)
+    InterruptHandler& handler = *it->second;
+    EdgeRequest& request = *handler.owner;
+    handler.debounce_us = periodUs;
+    handler.software_debounce_us = 0;
+    bool ok = request.request->reconfigure(buildLineSettings(request.members));
+    
+    if (!ok && periodUs > 0) {
+        // Kernel rejected the period: filter in dispatch instead
+        handler.software_debounce_us = periodUs;
+        ok = request.request->reconfigure(buildLineSettings(request.members));
+        PIPINPP_LOG_INFO("Kernel debounce unavailable on pin " << pin << ", filtering edges by timestamp");
+    }
+    if (!ok) {
+        throw GpioAccessError("GPIO pin " + std::to_string(pin), "Failed to reconfigure line for debounce");
+    }
+}
+
+void InterruptManager::growRequests() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::vector<EdgeRequest*> pending;
+    pending.swap(grow_);
+    size_t max_size = adaptive_max_.load();
+    
+    for (EdgeRequest* request : pending) {
+        // Skip requests detached meanwhile, and chips a merged rebuild is working on
+        auto it = std::find_if(requests_.begin(), requests_.end(),
+                               [request](const std::unique_ptr<EdgeRequest>& r) { return r.get() == request; });
+        if (it == requests_.end() || !request->active || reconfiguring_) {
+            continue;
+        }
+        request->grow = false;
+        if (request->event_buffer.size() >= max_size) {
+            continue;
         }
         
-        // Check wakeup pipe first
-        if (poll_fds[0].revents & POLLIN) {
-            char buf[16];
-            ssize_t bytes_read = read(wakeup_pipe_[0], buf, sizeof(buf));
-            (void)bytes_read; // Intentionally ignore - just clearing the pipe
-            // Reconfigure poll on next iteration
+        std::vector<InterruptHandler*> members;
+        std::vector<size_t> old_sizes;
+        for (InterruptHandler* member : request->members) {
+            if (member->active) {
+                members.push_back(member);
+                old_sizes.push_back(member->buffer_size);
+                member->buffer_size = std::min(member->buffer_size * 2, max_size);
+            }
+        }
+        if (members.empty()) {
             continue;
         }
         
-        // Process events on interrupt pins
-        for (size_t i = 1; i < poll_fds.size(); ++i) {
-            if (poll_fds[i].revents & POLLIN) {
-                int pin = pin_map[i];
-                
-                std::unique_lock<std::mutex> lock(mutex_);
-                auto it = handlers_.find(pin);
-                if (it == handlers_.end() || !it->second->active) {
-                    continue; // Handler was removed
-                }
-                
-                auto& handler = it->second;
-                lock.unlock();
-                
-                // Read edge events
-                int num_events = gpiod_line_request_read_edge_events(
-                    handler->request, handler->event_buffer, 
-                    gpiod_edge_event_buffer_get_capacity(handler->event_buffer)
-                );
-                
-                if (num_events > 0) {
-                    // Process all events
-                    for (int j = 0; j < num_events; ++j) {
-                        gpiod_edge_event* event = gpiod_edge_event_buffer_get_event(
-                            handler->event_buffer, j
-                        );
-                        
-                        if (event) {
-                            // Invoke callback
-                            try {
-                                handler->callback();
-                            } catch (const std::exception& e) {
-                                PIPINPP_LOG_ERROR("Exception in interrupt callback for pin " 
-                                         << pin << ": " << e.what());
-                            } catch (...) {
-                                PIPINPP_LOG_ERROR("Unknown exception in interrupt callback for pin " << pin);
-                            }
-                        }
-                    }
+        // The lines must be released before they can be requested again
+        std::shared_ptr<pipinpp::GpioChip> chip = request->chip;
+        bool merged = request->merged;
+        request->active = false;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, request->request->fd(), nullptr);
+        auto merged_it = merged_.find(chip->name());
+        if (merged_it != merged_.end() && merged_it->second == request) {
+            merged_.erase(merged_it);
+        }
+        std::unique_ptr<EdgeRequest> old = std::move(*it);
+        requests_.erase(it);
+        old.reset();
+        
+        try {
+            addRequest(createRequest(chip, members, merged));
+            PIPINPP_LOG_INFO("Lost interrupt edges on " << describePins(members) << ", event buffer grown to "
+                             << requests_.back()->event_buffer.size());
+        } catch (const std::exception& e) {
+            for (size_t i = 0; i < members.size(); ++i) {
+                members[i]->buffer_size = old_sizes[i];
+            }
+            try {
+                addRequest(createRequest(chip, members, merged));
+                PIPINPP_LOG_WARNING("Could not grow the event buffer of " << describePins(members) << ": " << e.what());
+            } catch (const std::exception& again) {
+                PIPINPP_LOG_ERROR("Failed to re-request interrupts on " << chip->name()
+                                  << ", detaching " << describePins(members) << ": " << again.what());
+                for (InterruptHandler* member : members) {
+                    auto node = handlers_.find(member->pin);
+                    member->active = false;
+                    releaseHandler(std::move(node->second));
+                    handlers_.erase(node);
                 }
             }
         }
     }
+}
+
+uint64_t InterruptManager::getLostEvents(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = handlers_.find(pin);
+    return it != handlers_.end() ? it->second->lost.load(std::memory_order_relaxed) : 0;
+}
+
+void InterruptManager::setAdaptiveEventBuffer(bool enable, size_t maxSize) {
+    adaptive_max_ = enable ? std::min(std::max<size_t>(maxSize, 1), MAX_EVENT_BUFFER_SIZE) : 0;
+}
+
+size_t InterruptManager::getEventBufferSize(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = handlers_.find(pin);
+    if (it == handlers_.end() || !it->second->owner) {
+        return 0;
+    }
+    return it->second->owner->event_buffer.size();
+}
+
+void InterruptManager::setupDispatch(InterruptHandler& handler) {
+    auto it = dispatch_.find(handler.pin);
+    if (it == dispatch_.end()) {
+        return;     // INLINE
+    }
     
-    PIPINPP_LOG_DEBUG("Monitor thread exiting");
+    handler.dispatch = it->second.first;
+    handler.queue = std::make_unique<pipinpp::SpscRing<EdgeEvent>>(it->second.second);
+    handler.worker_events.resize(handler.buffer_size);
+    if (handler.dispatch == CallbackDispatch::DEDICATED) {
+        handler.executor = CallbackExecutor::create(1, "pipinpp-irqcb" + std::to_string(handler.pin));
+    } else {
+        if (!pool_) {
+            pool_ = CallbackExecutor::create(pool_threads_, "pipinpp-irqcb");
+        }
+        handler.executor = pool_;
+    }
+}
+
+void InterruptManager::releaseHandler(std::unique_ptr<InterruptHandler> handler) {
+    if (handler && handler->executor) {
+        std::shared_ptr<CallbackExecutor> executor = handler->executor;
+        executor->retire(std::move(handler));
+    }
+}
+
+void InterruptManager::setCallbackDispatch(int pin, CallbackDispatch dispatch, size_t queueDepth) {
+    if (!pipinpp::isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
+                            " (must be 0-27 for Raspberry Pi)");
+    }
+    if (queueDepth == 0 || queueDepth > MAX_CALLBACK_QUEUE_DEPTH) {
+        throw InvalidPinError("Callback queue depth must be between 1 and 65536 (got " +
+                            std::to_string(queueDepth) + ")");
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dispatch == CallbackDispatch::INLINE) {
+        dispatch_.erase(pin);
+    } else {
+        dispatch_[pin] = {dispatch, queueDepth};
+    }
+}
+
+CallbackDispatch InterruptManager::getCallbackDispatch(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = dispatch_.find(pin);
+    return it != dispatch_.end() ? it->second.first : CallbackDispatch::INLINE;
+}
+
+bool InterruptManager::setCallbackPoolThreads(size_t threads) {
+    if (threads == 0) {
+        throw InvalidPinError("Callback pool needs at least one thread");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pool_) {
+        return false;
+    }
+    pool_threads_ = threads;
+    return true;
+}
+
+bool InterruptManager::getCallbackQueueStats(int pin, CallbackQueueStats& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = handlers_.find(pin);
+    if (it == handlers_.end() || !it->second->executor) {
+        return false;
+    }
+    const InterruptHandler& handler = *it->second;
+    out.depth = handler.queue->size();
+    out.capacity = handler.queue->capacity();
+    out.maxDepth = handler.max_depth.load(std::memory_order_relaxed);
+    out.delivered = handler.delivered.load(std::memory_order_relaxed);
+    out.dropped = handler.dropped.load(std::memory_order_relaxed);
+    return true;
+}
+
+uint32_t InterruptManager::getDebounce(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = debounce_us_.find(pin);
+    return it != debounce_us_.end() ? it->second : 0;
+}
+
+bool InterruptManager::isSoftwareDebounce(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = handlers_.find(pin);
+    return it != handlers_.end() && it->second->software_debounce_us != 0;
 }
 
 gpiod_line_edge InterruptManager::modeToEdge(InterruptMode mode) {
@@ -391,3 +1146,187 @@ gpiod_line_edge InterruptManager::modeToEdge(InterruptMode mode) {
             return GPIOD_LINE_EDGE_BOTH;
     }
 }
+
+/* ------------------------------------------------------------ */
+/*                     FREQUENCY COUNTER                        */
+/* ------------------------------------------------------------ */
+
+size_t FrequencyTracker::jitterBucket(uint64_t deviationNs) {
+    uint64_t us = deviationNs / 1000;
+    size_t bucket = 0;
+    while (us > 0 && bucket < FREQUENCY_JITTER_BUCKETS - 1) {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void FrequencyTracker::reset() {
+    stats_ = FrequencySnapshot();
+    have_rise_ = false;
+    have_fall_ = false;
+    have_seqno_ = false;
+}
+
+void FrequencyTracker::onEdge(const EdgeEvent& event) {
+    ++stats_.edges;
+    stats_.lastEdgeNs = event.timestampNs;
+    
+    // A gap in the line sequence means the kernel buffer overflowed: the cycle in progress is unusable
+    if (have_seqno_ && event.lineSeqno != last_seqno_ + 1) {
+        stats_.missedEdges += event.lineSeqno - last_seqno_ - 1;
+        have_rise_ = false;
+        have_fall_ = false;
+    }
+    have_seqno_ = true;
+    last_seqno_ = event.lineSeqno;
+    
+    if (event.type == EdgeType::FALLING) {
+        last_fall_ns_ = event.timestampNs;
+        have_fall_ = true;
+        return;
+    }
+    
+    if (have_rise_ && event.timestampNs > last_rise_ns_) {
+        uint64_t period = event.timestampNs - last_rise_ns_;
+        uint64_t average = stats_.averagePeriodNs;
+        if (average == 0) {
+            average = period;
+        } else {
+            int64_t delta = static_cast<int64_t>(period) - static_cast<int64_t>(average);
+            average = static_cast<uint64_t>(static_cast<int64_t>(average) + delta / 16);
+        }
+        uint64_t previous = stats_.averagePeriodNs;
+        uint64_t deviation = previous == 0 ? 0 : (period > previous ? period - previous : previous - period);
+        ++stats_.jitter[jitterBucket(deviation)];
+        
+        stats_.periodNs = period;
+        stats_.averagePeriodNs = average;
+        stats_.minPeriodNs = stats_.cycles == 0 ? period : std::min(stats_.minPeriodNs, period);
+        stats_.maxPeriodNs = std::max(stats_.maxPeriodNs, period);
+        stats_.frequencyHz = 1e9 / static_cast<double>(average);
+        if (have_fall_ && last_fall_ns_ > last_rise_ns_) {
+            stats_.highNs = last_fall_ns_ - last_rise_ns_;
+            stats_.dutyCycle = 100.0 * static_cast<double>(stats_.highNs) / static_cast<double>(period);
+        }
+        ++stats_.cycles;
+    }
+    last_rise_ns_ = event.timestampNs;
+    have_rise_ = true;
+}
+
+FrequencyCounter& FrequencyCounter::getInstance() {
+    static FrequencyCounter instance;
+    return instance;
+}
+
+FrequencyCounter::FrequencyCounter() {
+    // Construct the interrupt manager first so it is destroyed after us
+    InterruptManager::getInstance();
+}
+
+FrequencyCounter::~FrequencyCounter() {
+    for (int pin = 0; pin < MAX_PINS; ++pin) {
+        if (slots_[pin].active.load()) {
+            InterruptManager::getInstance().detachInterrupt(pin);
+        }
+    }
+}
+
+void FrequencyCounter::addPin(int pin, size_t bufferSize, const std::string& chipname) {
+    if (pin < 0 || pin >= MAX_PINS) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) +
+                            " (must be 0-27 for Raspberry Pi)");
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot& slot = slots_[pin];
+    {
+        std::lock_guard<std::mutex> writerLock(slot.writer_mutex);
+        slot.tracker.reset();
+        publish(slot);
+    }
+    
+    InterruptManager::getInstance().attachInterruptBatch(
+        pin, [this, &slot](EdgeEventSpan events) { onEdges(slot, events); },
+        InterruptMode::CHANGE, bufferSize, chipname);
+    slot.active.store(true, std::memory_order_release);
+}
+
+bool FrequencyCounter::removePin(int pin) {
+    if (pin < 0 || pin >= MAX_PINS) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!slots_[pin].active.load()) {
+        return false;
+    }
+    slots_[pin].active.store(false, std::memory_order_release);
+    InterruptManager::getInstance().detachInterrupt(pin);
+    return true;
+}
+
+bool FrequencyCounter::isCounting(int pin) const {
+    return pin >= 0 && pin < MAX_PINS && slots_[pin].active.load(std::memory_order_acquire);
+}
+
+bool FrequencyCounter::read(int pin, FrequencySnapshot& out) const {
+    if (!isCounting(pin)) {
+        return false;
+    }
+    const Slot& slot = slots_[pin];
+    
+    uint64_t words[SNAPSHOT_WORDS];
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;  // Publish in progress
+        }
+        for (size_t i = 0; i < SNAPSHOT_WORDS; ++i) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = slot.seq.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    std::memcpy(&out, words, sizeof(out));
+    
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+    out.ageNs = (out.edges > 0 && now > out.lastEdgeNs) ? now - out.lastEdgeNs : 0;
+    return true;
+}
+
+void FrequencyCounter::reset(int pin) {
+    if (pin < 0 || pin >= MAX_PINS) {
+        return;
+    }
+    Slot& slot = slots_[pin];
+    std::lock_guard<std::mutex> writerLock(slot.writer_mutex);
+    slot.tracker.reset();
+    publish(slot);
+}
+
+void FrequencyCounter::onEdges(Slot& slot, EdgeEventSpan events) {
+    std::lock_guard<std::mutex> writerLock(slot.writer_mutex);
+    for (const EdgeEvent& event : events) {
+        slot.tracker.onEdge(event);
+    }
+    publish(slot);
+}
+
+void FrequencyCounter::publish(Slot& slot) {
+    uint64_t words[SNAPSHOT_WORDS] = {};
+    std::memcpy(words, &slot.tracker.stats(), sizeof(FrequencySnapshot));
+    
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < SNAPSHOT_WORDS; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(seq + 2, std::memory_order_release);
+}
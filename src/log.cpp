@@ -0,0 +1,470 @@
+/**
+ * @file log.cpp
+ * @brief Implementation of the asynchronous per-thread ring-buffer logger
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "log.hpp"
+#include "spsc_ring.hpp"
+#include "thread_policy.hpp"
+#include "timebase.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pipinpp {
+
+namespace detail {
+
+std::atomic<int> logLevel{PIPINPP_LOG_LEVEL};
+
+} // namespace detail
+
+namespace {
+
+/// Ring per logging thread; about 100 typical messages
+constexpr size_t THREAD_RING_BYTES = 16 * 1024;
+
+/// Longest time a non-error message waits in its ring
+constexpr std::chrono::milliseconds FLUSH_INTERVAL(10);
+
+constexpr uint64_t RATE_WINDOW_NS = 1000000000ull;
+
+/**
+ * @brief Fixed header in front of every encoded record
+ */
+struct RecordHeader {
+    const detail::LogSite* site;
+    uint64_t timestampNs;
+    uint32_t suppressed;
+    uint16_t bytes;          ///< Encoded operands following the header
+    uint8_t truncated;
+    uint8_t reserved;
+};
+
+struct ThreadRing {
+    SpscRing<uint8_t> ring{THREAD_RING_BYTES};
+    std::atomic<bool> exited{false};
+};
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG:   return "DEBUG";
+        case LogLevel::INFO:    return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::ERROR:   return "ERROR";
+        case LogLevel::OFF:     break;
+    }
+    return "LOG";
+}
+
+/**
+ * @brief Turn encoded operands back into the text std::cerr would have printed
+ */
+std::string decode(const RecordHeader& header, const uint8_t* data) {
+    std::string text;
+    size_t pos = 0;
+    auto take = [&](auto& value) {
+        std::memcpy(&value, data + pos, sizeof(value));
+        pos += sizeof(value);
+    };
+    char number[32];
+    int base = 10;
+    auto appendInteger = [&](uint64_t bits, bool isSigned) {
+        if (base == 16) {
+            std::snprintf(number, sizeof(number), "%llx", static_cast<unsigned long long>(bits));
+        } else if (base == 8) {
+            std::snprintf(number, sizeof(number), "%llo", static_cast<unsigned long long>(bits));
+        } else if (isSigned) {
+            std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(bits));
+        } else {
+            std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(bits));
+        }
+        text += number;
+    };
+    while (pos < header.bytes) {
+        const auto tag = static_cast<detail::LogArg>(data[pos++]);
+        switch (tag) {
+            case detail::LogArg::INT: {
+                int64_t value;
+                take(value);
+                appendInteger(static_cast<uint64_t>(value), true);
+                break;
+            }
+            case detail::LogArg::UINT: {
+                uint64_t value;
+                take(value);
+                appendInteger(value, false);
+                break;
+            }
+            case detail::LogArg::DOUBLE: {
+                double value;
+                take(value);
+                std::snprintf(number, sizeof(number), "%g", value);
+                text += number;
+                break;
+            }
+            case detail::LogArg::CHAR: {
+                char value;
+                take(value);
+                text += value;
+                break;
+            }
+            case detail::LogArg::BOOL: {
+                uint8_t value;
+                take(value);
+                text += value ? '1' : '0';
+                break;
+            }
+            case detail::LogArg::STRING: {
+                uint16_t length;
+                take(length);
+                text.append(reinterpret_cast<const char*>(data + pos), length);
+                pos += length;
+                break;
+            }
+            case detail::LogArg::BASE: {
+                uint8_t value;
+                take(value);
+                base = value;
+                break;
+            }
+            case detail::LogArg::POINTER: {
+                uintptr_t value;
+                take(value);
+                std::snprintf(number, sizeof(number), "%p", reinterpret_cast<void*>(value));
+                text += number;
+                break;
+            }
+        }
+    }
+    if (header.truncated) {
+        text += "...";
+    }
+    if (header.suppressed) {
+        text += " (" + std::to_string(header.suppressed) + " similar messages suppressed)";
+    }
+    return text;
+}
+
+/**
+ * @brief Owner of the per-thread rings and the formatting thread
+ */
+class AsyncLogger {
+public:
+    static AsyncLogger& get() {
+        // Never destroyed: messages logged by late static destructors still
+        // have a logger (written synchronously after shutdown())
+        static AsyncLogger* instance = new AsyncLogger();
+        return *instance;
+    }
+
+    void submit(const RecordHeader& header, const uint8_t* data) {
+        if (shutDown_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(drainMutex_);
+            write(header.site->level, decode(header, data));
+            return;
+        }
+
+        ThreadRing* ring = threadRing();
+        const size_t total = sizeof(RecordHeader) + header.bytes;
+        if (!ring || ring->ring.capacity() - ring->ring.size() < total) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // One push, so the consumer never sees a header without its operands
+        uint8_t record[sizeof(RecordHeader) + detail::LOG_MAX_RECORD_BYTES];
+        std::memcpy(record, &header, sizeof(RecordHeader));
+        std::memcpy(record + sizeof(RecordHeader), data, header.bytes);
+        ring->ring.push(record, total);
+
+        if (header.site->level >= LogLevel::ERROR) {
+            errorPending_.store(true, std::memory_order_release);
+            wake_.notify_one();
+        }
+    }
+
+    /**
+     * @brief Format every pending record in timestamp order (single consumer)
+     */
+    void drain() {
+        std::vector<std::shared_ptr<ThreadRing>> rings;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex_);
+            rings = rings_;
+        }
+
+        std::lock_guard<std::mutex> lock(drainMutex_);
+        pending_.clear();
+        for (const auto& ring : rings) {
+            RecordHeader header;
+            while (ring->ring.size() >= sizeof(RecordHeader)) {
+                ring->ring.pop(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+                Pending entry{header, std::string(header.bytes, '\0')};
+                ring->ring.pop(reinterpret_cast<uint8_t*>(&entry.data[0]), header.bytes);
+                pending_.push_back(std::move(entry));
+            }
+        }
+        std::stable_sort(pending_.begin(), pending_.end(), [](const Pending& a, const Pending& b) {
+            return a.header.timestampNs < b.header.timestampNs;
+        });
+        for (const Pending& entry : pending_) {
+            write(entry.header.site->level,
+                  decode(entry.header, reinterpret_cast<const uint8_t*>(entry.data.data())));
+        }
+
+        const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped_) {
+            write(LogLevel::WARNING, std::to_string(dropped - reportedDropped_) +
+                                         " log messages dropped (thread ring full)");
+            reportedDropped_ = dropped;
+        }
+
+        // Forget rings of threads that exited once they are empty
+        std::lock_guard<std::mutex> registryLock(registryMutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                    [](const std::shared_ptr<ThreadRing>& ring) {
+                                        return ring->exited.load(std::memory_order_acquire) &&
+                                               ring->ring.empty();
+                                    }),
+                     rings_.end());
+    }
+
+    void setSink(LogSink sink) {
+        std::lock_guard<std::mutex> lock(drainMutex_);
+        sink_ = std::move(sink);
+    }
+
+    /**
+     * @brief Stop the thread and drain; later messages are written synchronously
+     */
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            running_ = false;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        drain();
+        shutDown_.store(true, std::memory_order_release);
+    }
+
+    std::atomic<uint32_t> rateLimit{DEFAULT_LOG_RATE_LIMIT};
+
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Pending {
+        RecordHeader header;
+        std::string data;
+    };
+
+    struct RingHolder {
+        std::shared_ptr<ThreadRing> ring;
+        ~RingHolder() {
+            if (ring) {
+                ring->exited.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    AsyncLogger() : running_(true), errorPending_(false), shutDown_(false), dropped_(0), reportedDropped_(0) {
+        thread_ = std::thread(&AsyncLogger::run, this);
+    }
+
+    ThreadRing* threadRing() {
+        thread_local RingHolder holder;
+        if (!holder.ring) {
+            // First message of this thread: the only allocation and lock on the producer side
+            holder.ring = std::make_shared<ThreadRing>();
+            std::lock_guard<std::mutex> lock(registryMutex_);
+            rings_.push_back(holder.ring);
+        }
+        return holder.ring.get();
+    }
+
+    void run() {
+        ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-log", false);
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        while (running_) {
+            wake_.wait_for(lock, FLUSH_INTERVAL, [this] {
+                return !running_ || errorPending_.load(std::memory_order_acquire);
+            });
+            errorPending_.store(false, std::memory_order_relaxed);
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    /**
+     * @note Caller must hold drainMutex_
+     */
+    void write(LogLevel level, const std::string& message) {
+        if (sink_) {
+            sink_(level, message);
+            return;
+        }
+        std::cerr << '[' << levelName(level) << "] " << message << '\n';
+        if (level >= LogLevel::ERROR) {
+            std::cerr.flush();
+        }
+    }
+
+    std::mutex registryMutex_;                           ///< Guards rings_
+    std::vector<std::shared_ptr<ThreadRing>> rings_;
+    std::mutex drainMutex_;                              ///< Single consumer; guards sink_ and pending_
+    std::vector<Pending> pending_;
+    LogSink sink_;
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool running_;
+    std::atomic<bool> errorPending_;
+    std::atomic<bool> shutDown_;
+    std::atomic<uint64_t> dropped_;
+    uint64_t reportedDropped_;
+    std::thread thread_;
+};
+
+/**
+ * @brief Drains and stops the logger at exit
+ *
+ * Constructed during static initialization, so it is destroyed after the
+ * library's function-local singletons and their shutdown messages.
+ */
+struct LoggerShutdown {
+    ~LoggerShutdown() {
+        if (started.load(std::memory_order_acquire)) {
+            AsyncLogger::get().shutdown();
+        }
+    }
+    static std::atomic<bool> started;
+};
+
+std::atomic<bool> LoggerShutdown::started{false};
+LoggerShutdown loggerShutdown;
+
+AsyncLogger& logger() {
+    AsyncLogger& instance = AsyncLogger::get();
+    if (!LoggerShutdown::started.load(std::memory_order_relaxed)) {
+        LoggerShutdown::started.store(true, std::memory_order_release);
+    }
+    return instance;
+}
+
+} // namespace
+
+// ============================================================================
+// Logging API Implementation
+// ============================================================================
+
+void setLogLevel(LogLevel level) {
+    detail::logLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel() {
+    return static_cast<LogLevel>(detail::logLevel.load(std::memory_order_relaxed));
+}
+
+void setLogRateLimit(uint32_t perSecond) {
+    logger().rateLimit.store(perSecond, std::memory_order_relaxed);
+}
+
+uint32_t getLogRateLimit() {
+    return logger().rateLimit.load(std::memory_order_relaxed);
+}
+
+void setLogSink(LogSink sink) {
+    logger().setSink(std::move(sink));
+}
+
+void flushLog() {
+    logger().drain();
+}
+
+uint64_t getLogDroppedCount() {
+    return logger().droppedCount();
+}
+
+namespace detail {
+
+// ============================================================================
+// LogRecord Implementation
+// ============================================================================
+
+LogRecord::LogRecord(LogSite& site)
+    : site_(site), accepted_(true), truncated_(false), suppressed_(0), timestampNs_(timebaseNanos()), used_(0) {
+    const uint32_t limit = logger().rateLimit.load(std::memory_order_relaxed);
+    if (limit != 0) {
+        uint64_t windowStart = site.windowStartNs.load(std::memory_order_relaxed);
+        if (timestampNs_ - windowStart >= RATE_WINDOW_NS &&
+            site.windowStartNs.compare_exchange_strong(windowStart, timestampNs_, std::memory_order_relaxed)) {
+            site.windowCount.store(0, std::memory_order_relaxed);
+        }
+        if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= limit) {
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            accepted_ = false;
+            return;
+        }
+    }
+    suppressed_ = site.suppressed.exchange(0, std::memory_order_relaxed);
+}
+
+LogRecord::~LogRecord() {
+    if (!accepted_) {
+        return;
+    }
+    RecordHeader header{&site_, timestampNs_, suppressed_, static_cast<uint16_t>(used_),
+                        static_cast<uint8_t>(truncated_), 0};
+    logger().submit(header, data_);
+}
+
+void LogRecord::putString(std::string_view text) {
+    const size_t overhead = 1 + sizeof(uint16_t);
+    if (used_ + overhead >= sizeof(data_)) {
+        truncated_ = true;
+        return;
+    }
+    size_t length = text.size();
+    if (used_ + overhead + length > sizeof(data_)) {
+        length = sizeof(data_) - used_ - overhead;
+        truncated_ = true;
+    }
+    data_[used_++] = static_cast<uint8_t>(LogArg::STRING);
+    const uint16_t stored = static_cast<uint16_t>(length);
+    std::memcpy(data_ + used_, &stored, sizeof(stored));
+    used_ += sizeof(stored);
+    std::memcpy(data_ + used_, text.data(), length);
+    used_ += length;
+}
+
+} // namespace detail
+} // namespace pipinpp
@@ -0,0 +1,280 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of the metrics registry, snapshots and exporters
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace pipinpp {
+namespace metrics {
+
+namespace {
+
+/// Descriptions of the metrics the library records itself
+const std::map<std::string, std::string> BUILTIN_HELP = {
+    {"gpio_write_ns", "Pin::write() through the GPIO character device (ns)"},
+    {"gpio_fast_writes", "Pin::write() calls served by the register fast path"},
+    {"interrupt_dispatch_ns", "Kernel edge timestamp to interrupt callback start (ns)"},
+    {"spi_transfer_ns", "SPI_IOC_MESSAGE ioctl duration (ns)"},
+    {"spi_errors", "Failed SPI transfers"},
+    {"i2c_transaction_ns", "I2C_RDWR ioctl duration (ns)"},
+    {"i2c_errors", "Failed I2C transactions"},
+    {"pwm_edge_lateness_ns", "EventPWMManager edge write time minus its deadline (ns)"},
+};
+
+const double EXPORTED_QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+std::string formatQuantile(double q) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%g", q);
+    return text;
+}
+
+} // namespace
+
+// ============================================================================
+// Registry Implementation
+// ============================================================================
+
+/**
+ * @brief Owner of every metric; entries live until exit at stable addresses
+ */
+class Registry {
+public:
+    static Registry& getInstance() {
+        // Never destroyed: call sites keep references in function-local statics
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    template <typename Metric>
+    struct Entry {
+        std::string name;
+        std::string help;
+        Metric metric;
+    };
+
+    Counter& counter(const std::string& name, const std::string& help) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return find(counters_, name, help).metric;
+    }
+
+    Histogram& histogram(const std::string& name, const std::string& help) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return find(histograms_, name, help).metric;
+    }
+
+    Snapshot snapshot() {
+        Snapshot snap;
+        snap.timestampNs = static_cast<uint64_t>(monotonicNowNs());
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : counters_) {
+            snap.counters.push_back({entry.name, entry.help, entry.metric.value()});
+        }
+        for (const auto& entry : histograms_) {
+            const Histogram& h = entry.metric;
+            HistogramSnapshot copy;
+            copy.name = entry.name;
+            copy.help = entry.help;
+            copy.sum = h.sum_.load(std::memory_order_relaxed);
+            copy.max = h.max_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+                const uint64_t n = h.buckets_[i].load(std::memory_order_relaxed);
+                if (n != 0) {
+                    copy.buckets.push_back({Histogram::bucketLowerBound(i), Histogram::bucketUpperBound(i), n});
+                    copy.count += n;
+                }
+            }
+            snap.histograms.push_back(std::move(copy));
+        }
+        return snap;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : counters_) {
+            entry.metric.reset();
+        }
+        for (auto& entry : histograms_) {
+            entry.metric.reset();
+        }
+    }
+
+private:
+    Registry() = default;
+
+    template <typename Metric>
+    static Entry<Metric>& find(std::deque<Entry<Metric>>& entries, const std::string& name,
+                               const std::string& help) {
+        for (auto& entry : entries) {
+            if (entry.name == name) {
+                if (entry.help.empty()) {
+                    entry.help = help;
+                }
+                return entry;
+            }
+        }
+        entries.emplace_back();
+        Entry<Metric>& entry = entries.back();
+        entry.name = name;
+        entry.help = help;
+        if (entry.help.empty()) {
+            auto builtin = BUILTIN_HELP.find(name);
+            if (builtin != BUILTIN_HELP.end()) {
+                entry.help = builtin->second;
+            }
+        }
+        return entry;
+    }
+
+    std::mutex mutex_;                                ///< Registration and snapshots only
+    std::deque<Entry<Counter>> counters_;
+    std::deque<Entry<Histogram>> histograms_;
+};
+
+void Histogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t HistogramSnapshot::quantile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    // Rank of the sample at q (1-based), at least the first sample
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(count) + 0.5));
+    uint64_t seen = 0;
+    for (const Bucket& bucket : buckets) {
+        seen += bucket.count;
+        if (seen >= rank) {
+            return std::min(bucket.upper, max);
+        }
+    }
+    return max;
+}
+
+const CounterSnapshot* Snapshot::findCounter(const std::string& name) const {
+    for (const auto& entry : counters) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const HistogramSnapshot* Snapshot::findHistogram(const std::string& name) const {
+    for (const auto& entry : histograms) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+Counter& counter(const std::string& name, const std::string& help) {
+    return Registry::getInstance().counter(name, help);
+}
+
+Histogram& histogram(const std::string& name, const std::string& help) {
+    return Registry::getInstance().histogram(name, help);
+}
+
+Snapshot snapshot() {
+    return Registry::getInstance().snapshot();
+}
+
+void reset() {
+    Registry::getInstance().reset();
+}
+
+bool instrumentationEnabled() {
+#ifdef PIPINPP_ENABLE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ============================================================================
+// Exporters
+// ============================================================================
+
+std::string toPrometheus(const Snapshot& snap, const std::string& prefix) {
+    std::string out;
+    for (const auto& c : snap.counters) {
+        const std::string name = prefix + c.name + "_total";
+        if (!c.help.empty()) {
+            out += "# HELP " + name + " " + c.help + "\n";
+        }
+        out += "# TYPE " + name + " counter\n";
+        out += name + " " + std::to_string(c.value) + "\n";
+    }
+    for (const auto& h : snap.histograms) {
+        const std::string name = prefix + h.name;
+        if (!h.help.empty()) {
+            out += "# HELP " + name + " " + h.help + "\n";
+        }
+        out += "# TYPE " + name + " summary\n";
+        for (double q : EXPORTED_QUANTILES) {
+            out += name + "{quantile=\"" + formatQuantile(q) + "\"} " + std::to_string(h.quantile(q)) + "\n";
+        }
+        out += name + "_sum " + std::to_string(h.sum) + "\n";
+        out += name + "_count " + std::to_string(h.count) + "\n";
+    }
+    return out;
+}
+
+std::string toJson(const Snapshot& snap) {
+    // Metric names are [a-z0-9_], so no escaping is needed
+    std::string out = "{\"timestamp_ns\":" + std::to_string(snap.timestampNs) + ",\"counters\":{";
+    for (size_t i = 0; i < snap.counters.size(); ++i) {
+        out += (i ? ",\"" : "\"") + snap.counters[i].name + "\":" + std::to_string(snap.counters[i].value);
+    }
+    out += "},\"histograms\":{";
+    for (size_t i = 0; i < snap.histograms.size(); ++i) {
+        const HistogramSnapshot& h = snap.histograms[i];
+        out += (i ? ",\"" : "\"") + h.name + "\":{\"count\":" + std::to_string(h.count) +
+               ",\"sum\":" + std::to_string(h.sum) + ",\"max\":" + std::to_string(h.max);
+        for (double q : EXPORTED_QUANTILES) {
+            out += ",\"p" + formatQuantile(q * 100) + "\":" + std::to_string(h.quantile(q));
+        }
+        out += "}";
+    }
+    out += "}}";
+    return out;
+}
+
+} // namespace metrics
+} // namespace pipinpp
@@ -0,0 +1,298 @@
+/**
+ * @file neopixel.cpp
+ * @brief WS2812 bit encoding and SPI frame output
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "neopixel.hpp"
+#include "SPI.hpp"
+#include "ArduinoCompat.hpp"  // For MSBFIRST
+#include "board.hpp"
+#include "exceptions.hpp"
+#include "pio.hpp"
+#include "timebase.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace pipinpp {
+
+namespace {
+
+// SPI0 MOSI, the pin the SPI fallback can drive
+constexpr int SPI0_MOSI_PIN = 10;
+
+// LED bits the PIO FIFO (TX joined) and OSR can hold beyond a finished write()
+constexpr int64_t PIO_QUEUED_PIXELS = 9;
+
+// One table entry per colour byte: each bit becomes @p bits SPI bits, MSB first
+constexpr std::array<uint32_t, 256> buildTable(unsigned bits, uint32_t zero, uint32_t one) {
+    std::array<uint32_t, 256> table{};
+    for (unsigned value = 0; value < 256; ++value) {
+        uint32_t pattern = 0;
+        for (int bit = 7; bit >= 0; --bit) {
+            pattern = (pattern << bits) | (((value >> bit) & 1) ? one : zero);
+        }
+        table[value] = pattern;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> TABLE_3BIT = buildTable(3, 0b100, 0b110);
+constexpr std::array<uint32_t, 256> TABLE_4BIT = buildTable(4, 0b1000, 0b1110);
+
+static_assert(TABLE_3BIT[0x00] == 0x924924, "3-bit encoding of 0x00");
+static_assert(TABLE_3BIT[0xFF] == 0xDB6DB6, "3-bit encoding of 0xFF");
+static_assert(TABLE_4BIT[0xA5] == 0xE8E88E8E, "4-bit encoding of 0xA5");
+
+// Position of R, G, B and W within a pixel for each channel order
+struct ChannelOffsets {
+    uint8_t r, g, b, w;
+};
+
+ChannelOffsets offsetsFor(NeoPixelOrder order) {
+    switch (order) {
+        case NeoPixelOrder::RGB:  return {0, 1, 2, 0};
+        case NeoPixelOrder::BRG:  return {1, 2, 0, 0};
+        case NeoPixelOrder::GRBW: return {1, 0, 2, 3};
+        case NeoPixelOrder::GRB:
+        default:                  return {1, 0, 2, 0};
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// NeoPixelStrip Implementation
+// ============================================================================
+
+uint32_t NeoPixelStrip::clockHz(NeoPixelEncoding encoding) {
+    return encoding == NeoPixelEncoding::BITS_4 ? 3200000 : 2400000;
+}
+
+size_t NeoPixelStrip::encode(const uint8_t* bytes, size_t length, NeoPixelEncoding encoding, uint8_t* out) {
+    uint8_t* p = out;
+    if (encoding == NeoPixelEncoding::BITS_4) {
+        for (size_t i = 0; i < length; ++i) {
+            uint32_t pattern = TABLE_4BIT[bytes[i]];
+            p[0] = static_cast<uint8_t>(pattern >> 24);
+            p[1] = static_cast<uint8_t>(pattern >> 16);
+            p[2] = static_cast<uint8_t>(pattern >> 8);
+            p[3] = static_cast<uint8_t>(pattern);
+            p += 4;
+        }
+    } else {
+        for (size_t i = 0; i < length; ++i) {
+            uint32_t pattern = TABLE_3BIT[bytes[i]];
+            p[0] = static_cast<uint8_t>(pattern >> 16);
+            p[1] = static_cast<uint8_t>(pattern >> 8);
+            p[2] = static_cast<uint8_t>(pattern);
+            p += 3;
+        }
+    }
+    return static_cast<size_t>(p - out);
+}
+
+NeoPixelStrip::NeoPixelStrip(size_t count, SPIClass& spi, NeoPixelEncoding encoding,
+                             NeoPixelOrder order, uint32_t resetUs)
+    : spi_(&spi), count_(count), encoding_(encoding), order_(order), brightness_(255),
+      pixels_(count * bytesPerPixel(order), 0), busy_(false), resetUs_(resetUs), latchEndNs_(0) {
+    allocateFrame(resetUs);
+}
+
+NeoPixelStrip::NeoPixelStrip(int pin, size_t count, NeoPixelOrder order, uint32_t resetUs)
+    : spi_(nullptr), count_(count), encoding_(NeoPixelEncoding::BITS_3), order_(order), brightness_(255),
+      pixels_(count * bytesPerPixel(order), 0), busy_(false), resetUs_(resetUs), latchEndNs_(0) {
+    if (!isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) +
+                            " (must be 0-27 for Raspberry Pi)");
+    }
+
+    if (PioStateMachine::isSupported()) {
+        PioSmConfig config;
+        config.sidesetBase = pin;
+        config.outShiftRight = false;            // MSB first
+        config.autopull = true;
+        config.pullThreshold = static_cast<uint8_t>(bytesPerPixel(order) * 8);
+        config.fifoJoin = PioFifoJoin::TX;
+        config.clockHz = static_cast<double>(NEOPIXEL_BIT_RATE_HZ) * PIO_WS2812_CYCLES_PER_BIT;
+        pio_.reset(new PioStateMachine());
+        if (pio_->begin(pioWs2812Program(), config)) {
+            words_.assign(count, 0);
+            return;
+        }
+        pio_.reset();
+    }
+
+    if (pin != SPI0_MOSI_PIN) {
+        throw GpioAccessError("GPIO " + std::to_string(pin),
+                              "WS2812 output needs PIO (Raspberry Pi 5) or GPIO 10 (SPI0 MOSI)");
+    }
+    if (!SPI.isInitialized() && !SPI.begin(0, 0)) {
+        throw GpioAccessError("SPI0", "Cannot open the bus for WS2812 output on GPIO 10");
+    }
+    spi_ = &SPI;
+    allocateFrame(resetUs);
+}
+
+void NeoPixelStrip::allocateFrame(uint32_t resetUs) {
+    const size_t perByte = encoding_ == NeoPixelEncoding::BITS_4 ? 4 : 3;
+    const size_t latchBytes = (static_cast<uint64_t>(resetUs) * clockHz(encoding_) + 7999999) / 8000000;
+    frame_.assign(pixels_.size() * perByte + latchBytes, 0);
+}
+
+NeoPixelStrip::~NeoPixelStrip() {
+    while (isBusy()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void NeoPixelStrip::setPixelColor(size_t index, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+    if (index >= count_) {
+        return;
+    }
+    ChannelOffsets offsets = offsetsFor(order_);
+    uint8_t* pixel = pixels_.data() + index * bytesPerPixel(order_);
+    pixel[offsets.r] = r;
+    pixel[offsets.g] = g;
+    pixel[offsets.b] = b;
+    if (order_ == NeoPixelOrder::GRBW) {
+        pixel[offsets.w] = w;
+    }
+}
+
+void NeoPixelStrip::setPixelColor(size_t index, uint32_t packed) {
+    setPixelColor(index, static_cast<uint8_t>(packed >> 16), static_cast<uint8_t>(packed >> 8),
+                  static_cast<uint8_t>(packed), static_cast<uint8_t>(packed >> 24));
+}
+
+uint32_t NeoPixelStrip::getPixelColor(size_t index) const {
+    if (index >= count_) {
+        return 0;
+    }
+    ChannelOffsets offsets = offsetsFor(order_);
+    const uint8_t* pixel = pixels_.data() + index * bytesPerPixel(order_);
+    uint8_t w = order_ == NeoPixelOrder::GRBW ? pixel[offsets.w] : 0;
+    return color(pixel[offsets.r], pixel[offsets.g], pixel[offsets.b], w);
+}
+
+void NeoPixelStrip::fill(uint32_t packed, size_t first, size_t count) {
+    size_t last = (count == 0) ? count_ : std::min(count_, first + count);
+    for (size_t i = first; i < last; ++i) {
+        setPixelColor(i, packed);
+    }
+}
+
+size_t NeoPixelStrip::encodeFrame() {
+    if (brightness_ == 255) {
+        return encode(pixels_.data(), pixels_.size(), encoding_, frame_.data());
+    }
+
+    // Scale in small blocks so the brightness pass stays in L1
+    const uint32_t scale = static_cast<uint32_t>(brightness_) + 1;
+    uint8_t block[96];
+    uint8_t* out = frame_.data();
+    for (size_t offset = 0; offset < pixels_.size(); offset += sizeof(block)) {
+        size_t n = std::min(sizeof(block), pixels_.size() - offset);
+        for (size_t i = 0; i < n; ++i) {
+            block[i] = static_cast<uint8_t>((pixels_[offset + i] * scale) >> 8);
+        }
+        out += encode(block, n, encoding_, out);
+    }
+    return static_cast<size_t>(out - frame_.data());
+}
+
+bool NeoPixelStrip::showPio() {
+    // Keep the line LOW for the latch time after the previous frame
+    int64_t waitNs = latchEndNs_ - monotonicNowNs();
+    if (waitNs > 0) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(waitNs));
+    }
+
+    // One word per pixel, colour bytes from the top (the OSR shifts left)
+    const size_t perPixel = bytesPerPixel(order_);
+    const uint32_t scale = static_cast<uint32_t>(brightness_) + 1;
+    const uint8_t* pixel = pixels_.data();
+    for (size_t i = 0; i < count_; ++i, pixel += perPixel) {
+        uint32_t word = 0;
+        for (size_t c = 0; c < perPixel; ++c) {
+            uint32_t value = brightness_ == 255 ? pixel[c] : (pixel[c] * scale) >> 8;
+            word |= value << (24 - 8 * c);
+        }
+        words_[i] = word;
+    }
+    if (!pio_->write(words_.data(), words_.size())) {
+        return false;
+    }
+
+    // write() returns once the FIFO has taken the last words, not when they are sent
+    const int64_t pixelNs = static_cast<int64_t>(perPixel) * 8 * 1000000000LL / NEOPIXEL_BIT_RATE_HZ;
+    latchEndNs_ = monotonicNowNs() + PIO_QUEUED_PIXELS * pixelNs + static_cast<int64_t>(resetUs_) * 1000;
+    return true;
+}
+
+bool NeoPixelStrip::show() {
+    if (pio_) {
+        return showPio();
+    }
+    if (isBusy() || !spi_->isInitialized()) {
+        return false;
+    }
+    encodeFrame();
+
+    spi_->beginTransaction(SPISettings(clockHz(encoding_), MSBFIRST, SPI_MODE0));
+    bool ok = spi_->transferStream(frame_.data(), nullptr, frame_.size());
+    spi_->endTransaction();
+    return ok;
+}
+
+bool NeoPixelStrip::showAsync() {
+    if (pio_) {
+        return showPio();
+    }
+    if (isBusy() || !spi_->isInitialized()) {
+        return false;
+    }
+    encodeFrame();
+
+    SpiTransaction transaction;
+    SpiSegment segment;
+    segment.tx = frame_.data();
+    segment.length = frame_.size();
+    transaction.segments.push_back(segment);
+    transaction.settings = SPISettings(clockHz(encoding_), MSBFIRST, SPI_MODE0);
+
+    busy_.store(true, std::memory_order_release);
+    bool queued = spi_->submit(std::move(transaction), [this](bool) {
+        busy_.store(false, std::memory_order_release);
+    });
+    if (!queued) {
+        busy_.store(false, std::memory_order_release);
+    }
+    return queued;
+}
+
+} // namespace pipinpp
@@ -0,0 +1,373 @@
+/**
+ * @file one_wire.cpp
+ * @brief 1-Wire master: timed slots, ROM search, CRC8 and DS18B20 reads
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "one_wire.hpp"
+#include "log.hpp"
+#include "precise_delay.hpp"
+#include "thread_policy.hpp"
+#include "timebase.hpp"
+#include <array>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <pthread.h>
+#include <sched.h>
+
+namespace pipinpp {
+
+namespace {
+
+// Standard-speed slot timings (ns), measured from the falling edge
+constexpr int64_t RESET_LOW_NS = 480000;
+constexpr int64_t PRESENCE_SAMPLE_NS = 70000;      // After release
+constexpr int64_t PRESENCE_WINDOW_NS = 480000;     // After release
+constexpr int64_t WRITE0_LOW_NS = 60000;
+constexpr int64_t SHORT_LOW_NS = 1000;             // Write 1 / read: release at once
+constexpr int64_t SHORT_LOW_MAX_NS = 15000;        // Later and a device sees a 0
+constexpr int64_t READ_SAMPLE_NS = 12000;
+constexpr int64_t SLOT_NS = 70000;                 // 60 µs slot + 10 µs recovery
+
+constexpr std::array<uint8_t, 256> buildCrcTable() {
+    std::array<uint8_t, 256> table{};
+    for (unsigned int i = 0; i < 256; ++i) {
+        uint8_t crc = static_cast<uint8_t>(i);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? static_cast<uint8_t>((crc >> 1) ^ 0x8C) : static_cast<uint8_t>(crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> CRC_TABLE = buildCrcTable();
+
+/**
+ * Raise the calling thread to the ThreadPolicyManager SCHED_FIFO priority
+ * for one transaction, and restore its policy afterwards. Nothing happens
+ * without a real-time policy, if the thread already runs at least that
+ * high, or if the kernel refuses.
+ */
+class RealtimeSection {
+public:
+    RealtimeSection() : raised_(false), oldPolicy_(SCHED_OTHER), oldParam_{} {
+        int priority = ThreadPolicyManager::getInstance().getPolicy().priority;
+        if (priority <= 0 || pthread_getschedparam(pthread_self(), &oldPolicy_, &oldParam_) != 0) {
+            return;
+        }
+        if (oldPolicy_ == SCHED_FIFO && oldParam_.sched_priority >= priority) {
+            return;
+        }
+        sched_param param{};
+        param.sched_priority = priority;
+        raised_ = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    }
+
+    ~RealtimeSection() {
+        if (raised_) {
+            pthread_setschedparam(pthread_self(), oldPolicy_, &oldParam_);
+        }
+    }
+
+    RealtimeSection(const RealtimeSection&) = delete;
+    RealtimeSection& operator=(const RealtimeSection&) = delete;
+
+private:
+    bool raised_;
+    int oldPolicy_;
+    sched_param oldParam_;
+};
+
+void romToBytes(uint64_t rom, uint8_t* bytes) {
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<uint8_t>(rom >> (8 * i));
+    }
+}
+
+} // namespace
+
+uint8_t oneWireCrc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; ++i) {
+        crc = CRC_TABLE[crc ^ data[i]];
+    }
+    return crc;
+}
+
+OneWireBus::OneWireBus(int pin, bool internalPullup, const std::string& chipname)
+    : line_(pin, internalPullup ? PinMode::INPUT_PULLUP : PinMode::INPUT, chipname),
+      releaseMode_(internalPullup ? PinMode::INPUT_PULLUP : PinMode::INPUT),
+      overruns_(0) {
+    PIPINPP_LOG_INFO("1-Wire bus on GPIO " << pin << (internalPullup ? " (internal pull-up)" : ""));
+}
+
+int OneWireBus::slot(int64_t lowNs, int64_t sampleNs) {
+    if (!line_.reconfigure(PinMode::OUTPUT)) {
+        return -1;
+    }
+    const int64_t fall = monotonicNowNs();
+    preciseSleepUntilNs(fall + lowNs);
+    if (!line_.reconfigure(releaseMode_)) {
+        return -1;
+    }
+    const int64_t rise = monotonicNowNs();
+
+    if (lowNs < SHORT_LOW_MAX_NS && rise - fall > SHORT_LOW_MAX_NS) {
+        // Devices have already sampled a 0
+        ++overruns_;
+        PIPINPP_LOG_DEBUG("1-Wire slot overrun: LOW for " << (rise - fall) / 1000 << " us");
+        preciseSleepUntilNs(fall + SLOT_NS);
+        return -1;
+    }
+
+    int level = 0;
+    if (sampleNs > 0) {
+        preciseSleepUntilNs(fall + sampleNs);
+        level = line_.read();
+    }
+    preciseSleepUntilNs(fall + SLOT_NS);
+    return level;
+}
+
+bool OneWireBus::reset() {
+    RealtimeSection realtime;
+
+    if (line_.read() != 1) {
+        PIPINPP_LOG_DEBUG("1-Wire bus held LOW before reset (no pull-up or shorted)");
+        return false;
+    }
+    if (!line_.reconfigure(PinMode::OUTPUT)) {
+        return false;
+    }
+    preciseSleepUntilNs(monotonicNowNs() + RESET_LOW_NS);
+    if (!line_.reconfigure(releaseMode_)) {
+        return false;
+    }
+    const int64_t rise = monotonicNowNs();
+    preciseSleepUntilNs(rise + PRESENCE_SAMPLE_NS);
+    int level = line_.read();
+    preciseSleepUntilNs(rise + PRESENCE_WINDOW_NS);
+    return level == 0;
+}
+
+bool OneWireBus::writeBit(bool bit) {
+    RealtimeSection realtime;
+    return slot(bit ? SHORT_LOW_NS : WRITE0_LOW_NS, 0) == 0;
+}
+
+int OneWireBus::readBit() {
+    RealtimeSection realtime;
+    return slot(SHORT_LOW_NS, READ_SAMPLE_NS);
+}
+
+bool OneWireBus::writeByte(uint8_t value) {
+    return write(&value, 1);
+}
+
+int OneWireBus::readByte() {
+    uint8_t value = 0;
+    return read(&value, 1) ? value : -1;
+}
+
+bool OneWireBus::write(const uint8_t* data, size_t length) {
+    RealtimeSection realtime;
+    for (size_t n = 0; n < length; ++n) {
+        for (int bit = 0; bit < 8; ++bit) {
+            bool one = (data[n] >> bit) & 1u;   // LSB first
+            if (slot(one ? SHORT_LOW_NS : WRITE0_LOW_NS, 0) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool OneWireBus::read(uint8_t* data, size_t length) {
+    RealtimeSection realtime;
+    for (size_t n = 0; n < length; ++n) {
+        unsigned int byte = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            int level = slot(SHORT_LOW_NS, READ_SAMPLE_NS);
+            if (level < 0) {
+                return false;
+            }
+            byte |= static_cast<unsigned int>(level) << bit;
+        }
+        data[n] = static_cast<uint8_t>(byte);
+    }
+    return true;
+}
+
+bool OneWireBus::select(uint64_t rom) {
+    uint8_t frame[9];
+    frame[0] = ONEWIRE_MATCH_ROM;
+    romToBytes(rom, frame + 1);
+    RealtimeSection realtime;
+    return reset() && write(frame, sizeof(frame));
+}
+
+bool OneWireBus::skip() {
+    RealtimeSection realtime;
+    return reset() && writeByte(ONEWIRE_SKIP_ROM);
+}
+
+int OneWireBus::search(std::vector<uint64_t>& roms, uint8_t command, int retries) {
+    roms.clear();
+    RealtimeSection realtime;
+
+    uint64_t rom = 0;
+    int lastDiscrepancy = -1;     // Bit where the previous pass took the 0 branch last
+    bool done = false;
+    while (!done) {
+        bool passOk = reset() && writeByte(command);
+        if (!passOk && roms.empty() && lastDiscrepancy < 0 && line_.read() == 1) {
+            return 0;             // No presence pulse: empty bus
+        }
+
+        int lastZero = -1;
+        for (int bit = 0; passOk && bit < 64; ++bit) {
+            int value = readBit();
+            int complement = readBit();
+            if (value < 0 || complement < 0 || (value == 1 && complement == 1)) {
+                passOk = false;   // Error, or every device dropped out
+                break;
+            }
+
+            bool direction;
+            if (value != complement) {
+                direction = value == 1;      // All remaining devices agree
+            } else if (bit < lastDiscrepancy) {
+                direction = (rom >> bit) & 1u;
+            } else {
+                direction = bit == lastDiscrepancy;
+            }
+            if (value == complement && !direction) {
+                lastZero = bit;
+            }
+
+            if (direction) {
+                rom |= uint64_t{1} << bit;
+            } else {
+                rom &= ~(uint64_t{1} << bit);
+            }
+            passOk = writeBit(direction);
+        }
+
+        uint8_t bytes[8];
+        romToBytes(rom, bytes);
+        if (passOk && (rom == 0 || oneWireCrc8(bytes, sizeof(bytes)) != 0)) {
+            passOk = false;
+        }
+        if (!passOk) {
+            if (retries-- <= 0) {
+                PIPINPP_LOG_WARNING("1-Wire search failed after " << roms.size() << " devices");
+                return -1;
+            }
+            continue;             // Repeat the same pass
+        }
+
+        roms.push_back(rom);
+        lastDiscrepancy = lastZero;
+        done = lastDiscrepancy < 0;
+    }
+    return static_cast<int>(roms.size());
+}
+
+bool OneWireBus::startConversion() {
+    RealtimeSection realtime;
+    return skip() && writeByte(DS18B20_CONVERT_T);
+}
+
+bool OneWireBus::conversionDone() {
+    return readBit() == 1;
+}
+
+bool OneWireBus::readScratchpad(uint64_t rom, uint8_t* scratchpad, int retries) {
+    RealtimeSection realtime;
+    for (int attempt = 0; attempt <= retries; ++attempt) {
+        if (!select(rom) || !writeByte(DS18B20_READ_SCRATCHPAD) ||
+            !read(scratchpad, DS18B20_SCRATCHPAD_SIZE)) {
+            continue;
+        }
+        bool allZero = true;
+        for (size_t i = 0; i < DS18B20_SCRATCHPAD_SIZE; ++i) {
+            allZero = allZero && scratchpad[i] == 0;
+        }
+        if (!allZero && oneWireCrc8(scratchpad, DS18B20_SCRATCHPAD_SIZE) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OneWireBus::readTemperature(uint64_t rom, float& celsius) {
+    uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE];
+    if (!readScratchpad(rom, scratchpad)) {
+        return false;
+    }
+    celsius = scratchpadToCelsius(scratchpad);
+    return true;
+}
+
+size_t OneWireBus::readTemperatures(const std::vector<uint64_t>& roms, std::vector<float>& celsius,
+                                    uint32_t timeoutMs) {
+    celsius.assign(roms.size(), std::numeric_limits<float>::quiet_NaN());
+    if (roms.empty() || !startConversion()) {
+        return 0;
+    }
+
+    // Sensors hold the line LOW while converting; poll with read slots
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!conversionDone()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            PIPINPP_LOG_WARNING("1-Wire temperature conversion timed out after " << timeoutMs << " ms");
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    size_t ok = 0;
+    for (size_t i = 0; i < roms.size(); ++i) {
+        if (readTemperature(roms[i], celsius[i])) {
+            ++ok;
+        }
+    }
+    return ok;
+}
+
+float OneWireBus::scratchpadToCelsius(const uint8_t* scratchpad) {
+    int16_t raw = static_cast<int16_t>((scratchpad[1] << 8) | scratchpad[0]);
+    // Undefined low bits at 9-11 bit resolution (config byte bits 5-6)
+    switch ((scratchpad[4] >> 5) & 0x3) {
+        case 0:  raw = static_cast<int16_t>(raw & ~7); break;
+        case 1:  raw = static_cast<int16_t>(raw & ~3); break;
+        case 2:  raw = static_cast<int16_t>(raw & ~1); break;
+        default: break;
+    }
+    return static_cast<float>(raw) / 16.0f;
+}
+
+} // namespace pipinpp
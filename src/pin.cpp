@@ -27,12 +27,38 @@
 
 #include "pin.hpp"
 #include "log.hpp"
+#include "metrics.hpp"
 #include "exceptions.hpp"
+#include "board.hpp"
+#include "transaction.hpp"
 #include <stdexcept>
 #include <gpiod.h>
+#include <time.h>
 
-Pin::Pin(int pin, PinDirection direction, const std::string& chipname) 
-: chip(nullptr), request(nullptr), currentDirection(direction), pinNumber(pin)
+namespace
+{
+
+// Busy-wait for short bit timings where a sleep would take far too long
+void spinNs(uint32_t ns)
+{
+    if (ns == 0)
+    {
+        return;
+    }
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec) < static_cast<long>(ns));
+}
+
+} // namespace
+
+Pin::Pin(int pin, PinDirection direction, const std::string& chipname, PinBackend backend) 
+: chip(), request(), currentDirection(direction), pinNumber(pin),
+  fastPath(nullptr), pinMask(0), currentBias(GPIOD_LINE_BIAS_AS_IS), eventBuffer(),
+  debouncePeriodUs(0), softwareDebounce(false), lastEdgeNs(0)
 {
     validatePinNumber(pin);
     
@@ -47,16 +73,21 @@ Pin::Pin(int pin, PinDirection direction, const std::string& chipname)
     }
     
     initializeGpio(chipname, gpio_dir, GPIOD_LINE_BIAS_AS_IS);
+    if (backend == PinBackend::GPIOMEM)
+    {
+        initializeFastPath(chipname);
+    }
     
     PIPINPP_LOG_INFO("Initializing pin " << pinNumber << " as " 
                      << ((direction == PinDirection::OUTPUT) ? "OUTPUT" : "INPUT")
                      << " on chip " << chipname);
 }
 
-Pin::Pin(int pin, PinMode mode, const std::string& chipname) 
-: chip(nullptr), request(nullptr), 
+Pin::Pin(int pin, PinMode mode, const std::string& chipname, PinBackend backend) 
+: chip(), request(), 
   currentDirection(mode == PinMode::OUTPUT ? PinDirection::OUTPUT : PinDirection::INPUT), 
-  pinNumber(pin)
+  pinNumber(pin), fastPath(nullptr), pinMask(0), currentBias(GPIOD_LINE_BIAS_AS_IS),
+  eventBuffer(), debouncePeriodUs(0), softwareDebounce(false), lastEdgeNs(0)
 {
     validatePinNumber(pin);
     
@@ -89,6 +120,10 @@ Pin::Pin(int pin, PinMode mode, const std::string& chipname)
     }
     
     initializeGpio(chipname, gpio_dir, gpio_bias);
+    if (backend == PinBackend::GPIOMEM)
+    {
+        initializeFastPath(chipname);
+    }
     
     PIPINPP_LOG_INFO("Initializing pin " << pinNumber << " as " 
                      << (mode == PinMode::OUTPUT ? "OUTPUT" :
@@ -102,111 +137,183 @@ void Pin::initializeGpio(const std::string& chipname,
                          gpiod_line_bias bias,
                          gpiod_line_value initial_value)
 {
-    // Open GPIO chip
-    chip = gpiod_chip_open(("/dev/" + chipname).c_str());
-    if (!chip) {
-        throw GpioAccessError("/dev/" + chipname, "Failed to open GPIO chip. Check permissions and device existence.");
+    currentBias = bias;
+    
+    // Get shared chip handle (opened once per process, see ChipRegistry)
+    chip = pipinpp::ChipRegistry::getInstance().acquire(chipname);
+
+    // Validate pin number against hardware (line count cached by the registry)
+    size_t num_lines = chip->numLines();
+    if (num_lines > 0 && static_cast<size_t>(pinNumber) >= num_lines) {
+        chip.reset();
+        throw InvalidPinError(pinNumber, "Pin number exceeds available GPIO lines (" + std::to_string(num_lines) + ")");
     }
 
-    // Validate pin number against hardware (v2 API)
-    gpiod_chip_info* info = gpiod_chip_get_info(chip);
-    if (info) {
-        size_t num_lines = gpiod_chip_info_get_num_lines(info);
-        if (static_cast<size_t>(pinNumber) >= num_lines) {
-            gpiod_chip_info_free(info);
-            gpiod_chip_close(chip);
-            throw InvalidPinError(pinNumber, "Pin number exceeds available GPIO lines (" + std::to_string(num_lines) + ")");
-        }
-        gpiod_chip_info_free(info);
+    // Request the line (libgpiod, or a simulated chip)
+    pipinpp::LineSettings settings;
+    settings.offset = pinNumber;
+    settings.direction = direction;
+    settings.bias = bias;
+    settings.outputValue = initial_value;
+    request = chip->requestLines("PiPinPP", {settings});
+
+    // Error handling for line request
+    if (!request) 
+    {
+        chip.reset();
+        throw GpioAccessError("GPIO pin " + std::to_string(pinNumber), 
+                            "Failed to request GPIO line. Pin may be in use or unavailable.");
     }
 
-    // Configure line settings (v2 API)
-    gpiod_line_settings* settings = gpiod_line_settings_new();
-    if (!settings)
+    if (direction == GPIOD_LINE_DIRECTION_OUTPUT)
     {
-        gpiod_chip_close(chip);
-        throw GpioAccessError("GPIO", "Failed to create line settings");
+        chip->outputShadow().claim(pinNumber, initial_value == GPIOD_LINE_VALUE_ACTIVE);
     }
+}
 
-    // Set direction
-    gpiod_line_settings_set_direction(settings, direction);
-    
-    // Set initial value for output pins
-    if (direction == GPIOD_LINE_DIRECTION_OUTPUT) 
+void Pin::initializeFastPath(const std::string& chipname)
+{
+    (void)chipname; // Only used when logging is enabled
+
+    // Only bank 0 is mapped; the line is already configured by libgpiod
+    if (pinNumber >= 32)
     {
-        gpiod_line_settings_set_output_value(settings, initial_value);
+        return;
     }
-    
-    // Set bias (pull resistors)
-    if (bias != GPIOD_LINE_BIAS_AS_IS)
+
+    fastPath = pipinpp::GpioMem::forChipLabel(chip->label());
+    if (fastPath)
+    {
+        pinMask = 1u << pinNumber;
+        PIPINPP_LOG_DEBUG("Pin " << pinNumber << " using /dev/gpiomem register backend");
+    }
+    else
     {
-        gpiod_line_settings_set_bias(settings, bias);
+        PIPINPP_LOG_WARNING("Direct register access not available for " << chipname
+                            << " (" << chip->label() << "), pin " << pinNumber << " uses libgpiod");
     }
+}
 
-    // Create line config
-    gpiod_line_config* line_cfg = gpiod_line_config_new();
-    if (!line_cfg)
+Pin::~Pin() 
+{
+    if (chip && request && currentDirection == PinDirection::OUTPUT)
+    {
+        chip->outputShadow().release(pinNumber);
+    }
+    if (pipinpp::Transaction* txn = pipinpp::Transaction::current())
     {
-        gpiod_line_settings_free(settings);
-        gpiod_chip_close(chip);
-        throw GpioAccessError("GPIO", "Failed to create line config");
+        txn->forgetRequest(request.get());
     }
 
-    gpiod_line_config_add_line_settings(line_cfg, &pinNumber, 1, settings);
+    // Release the line request before the chip it came from
+    request.reset();
 
-    // Create request config
-    gpiod_request_config* req_cfg = gpiod_request_config_new();
-    if (!req_cfg)
+    // Drop our reference; the chip closes when its last user releases it
+    chip.reset();
+}
+
+bool Pin::write(bool value) 
+{
+    if (!request) 
     {
-        gpiod_line_config_free(line_cfg);
-        gpiod_line_settings_free(settings);
-        gpiod_chip_close(chip);
-        throw GpioAccessError("GPIO", "Failed to create request config");
+        return false; // Request not initialized
     }
-    gpiod_request_config_set_consumer(req_cfg, "PiPinPP");
 
-    // Request the line
-    request = gpiod_chip_request_lines(chip, req_cfg, line_cfg);
+    // Inside a Transaction: applied with the other writes on commit
+    pipinpp::Transaction* txn = pipinpp::Transaction::current();
+    if (txn && currentDirection == PinDirection::OUTPUT)
+    {
+        txn->recordLine(chip.get(), request.get(), fastPath, pinMask, pinNumber, value);
+        return true;
+    }
 
-    // Clean up temporary objects
-    gpiod_request_config_free(req_cfg);
-    gpiod_line_config_free(line_cfg);
-    gpiod_line_settings_free(settings);
+    // Register fast path: a single store to GPSET0/GPCLR0 (or RP1 RIO SET/CLR)
+    if (fastPath && currentDirection == PinDirection::OUTPUT)
+    {
+        if (value)
+        {
+            fastPath->set(pinMask);
+        }
+        else
+        {
+            fastPath->clear(pinMask);
+        }
+        chip->outputShadow().record(pinNumber, value);
+        PIPINPP_METRIC_COUNT("gpio_fast_writes", 1);
+        return true;
+    }
 
-    // Error handling for line request
-    if (!request) 
+    PIPINPP_METRIC_TIME_SCOPE("gpio_write_ns");
+    if (request->setValue(pinNumber, value) != 0)
     {
-        gpiod_chip_close(chip);
-        throw GpioAccessError("GPIO pin " + std::to_string(pinNumber), 
-                            "Failed to request GPIO line. Pin may be in use or unavailable.");
+        return false;
     }
+    if (currentDirection == PinDirection::OUTPUT)
+    {
+        chip->outputShadow().record(pinNumber, value);
+    }
+    return true;
 }
 
-Pin::~Pin() 
+std::error_code Pin::writeNoexcept(bool value) noexcept
 {
-    // Release the line request (v2 API)
-    if (request)
+    if (!request)
+    {
+        return pipinpp::GpioErrc::NOT_OPEN;
+    }
+    if (currentDirection != PinDirection::OUTPUT)
+    {
+        return pipinpp::GpioErrc::WRONG_DIRECTION;
+    }
+    errno = 0;
+    if (!write(value))
     {
-        gpiod_line_request_release(request);
+        return pipinpp::lastSystemError();
     }
+    return {};
+}
 
-    // Close the chip
-    if (chip)
+std::error_code Pin::readNoexcept(int& level) noexcept
+{
+    if (!request)
     {
-        gpiod_chip_close(chip);
+        return pipinpp::GpioErrc::NOT_OPEN;
     }
+    errno = 0;
+    int value = read();
+    if (value < 0)
+    {
+        return pipinpp::lastSystemError();
+    }
+    level = value;
+    return {};
 }
 
-bool Pin::write(bool value) 
+bool Pin::toggle()
 {
-    if (!request) 
+    int level = getOutputState();
+    if (level < 0)
     {
-        return false; // Request not initialized
+        return false;
     }
+    return write(level == 0);
+}
 
-    // v2 API: set value using line request
-    enum gpiod_line_value val = value ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE;
-    return gpiod_line_request_set_value(request, pinNumber, val) == 0;
+int Pin::getOutputState() const
+{
+    if (!request || currentDirection != PinDirection::OUTPUT)
+    {
+        return -1;
+    }
+    if (const pipinpp::Transaction* txn = pipinpp::Transaction::current())
+    {
+        int pending = txn->pendingLevel(chip.get(), pinNumber);
+        if (pending >= 0)
+        {
+            return pending;
+        }
+    }
+    return chip->outputShadow().level(pinNumber);
 }
 
 int Pin::read() 
@@ -216,27 +323,314 @@ int Pin::read()
         return -1; // Request not initialized
     }
 
-    // v2 API: get value using line request
-    enum gpiod_line_value val = gpiod_line_request_get_value(request, pinNumber);
-    if (val == GPIOD_LINE_VALUE_ERROR)
+    if (fastPath)
+    {
+        return (fastPath->levels() & pinMask) ? 1 : 0;
+    }
+
+    return request->getValue(pinNumber);
+}
+
+bool Pin::enableEdgeEvents(bool enable)
+{
+    if (!request || currentDirection != PinDirection::INPUT)
+    {
+        return false;
+    }
+    if (enable == edgeEventsEnabled())
+    {
+        return true;
+    }
+
+    uint32_t kernelDebounceUs = softwareDebounce ? 0 : debouncePeriodUs;
+    if (!reconfigureInput(enable, kernelDebounceUs))
+    {
+        PIPINPP_LOG_WARNING("Edge detection not available on pin " << pinNumber);
+        return false;
+    }
+
+    if (enable)
+    {
+        eventBuffer.resize(16);
+    }
+    else
+    {
+        eventBuffer.clear();
+        eventBuffer.shrink_to_fit();
+    }
+    return true;
+}
+
+int Pin::getEventFd() const
+{
+    if (!request || eventBuffer.empty())
+    {
+        return -1;
+    }
+    return request->fd();
+}
+
+int Pin::waitEdgeEvents(PinEdgeEvent* events, size_t maxEvents, int64_t timeoutNs)
+{
+    if (eventBuffer.empty() || events == nullptr || maxEvents == 0)
     {
         return -1;
     }
-    return (val == GPIOD_LINE_VALUE_ACTIVE) ? 1 : 0;
+
+    int ready = request->waitEdgeEvents(timeoutNs);
+    if (ready <= 0)
+    {
+        return ready;
+    }
+
+    int count = request->readEdgeEvents(eventBuffer.data(),
+                                        maxEvents < eventBuffer.size() ? maxEvents : eventBuffer.size());
+    uint64_t filterNs = softwareDebounce ? static_cast<uint64_t>(debouncePeriodUs) * 1000 : 0;
+    int kept = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const pipinpp::LineEvent& event = eventBuffer[static_cast<size_t>(i)];
+        if (filterNs > 0 && lastEdgeNs != 0 && event.timestampNs - lastEdgeNs < filterNs)
+        {
+            continue;   // Bounce
+        }
+        lastEdgeNs = event.timestampNs;
+        events[kept].rising = event.rising;
+        events[kept].timestampNs = event.timestampNs;
+        ++kept;
+    }
+    return count < 0 ? count : kept;
+}
+
+bool Pin::setDebounce(uint32_t periodUs)
+{
+    if (!request || currentDirection != PinDirection::INPUT)
+    {
+        return false;
+    }
+
+    bool edges = edgeEventsEnabled();
+    if (reconfigureInput(edges, periodUs))
+    {
+        softwareDebounce = false;
+    }
+    else if (periodUs > 0 && reconfigureInput(edges, 0))
+    {
+        PIPINPP_LOG_INFO("Kernel debounce unavailable on pin " << pinNumber << ", filtering edges by timestamp");
+        softwareDebounce = true;
+    }
+    else
+    {
+        return false;
+    }
+    debouncePeriodUs = periodUs;
+    lastEdgeNs = 0;
+    return true;
+}
+
+bool Pin::reconfigure(PinMode mode)
+{
+    if (!request)
+    {
+        return false;
+    }
+
+    pipinpp::LineSettings settings;
+    settings.offset = pinNumber;
+    if (mode == PinMode::OUTPUT)
+    {
+        settings.direction = GPIOD_LINE_DIRECTION_OUTPUT;
+        settings.outputValue = GPIOD_LINE_VALUE_INACTIVE;
+    }
+    else
+    {
+        settings.direction = GPIOD_LINE_DIRECTION_INPUT;
+        if (mode == PinMode::INPUT_PULLUP)
+        {
+            settings.bias = GPIOD_LINE_BIAS_PULL_UP;
+        }
+        else if (mode == PinMode::INPUT_PULLDOWN)
+        {
+            settings.bias = GPIOD_LINE_BIAS_PULL_DOWN;
+        }
+        else if (currentBias != GPIOD_LINE_BIAS_AS_IS)
+        {
+            settings.bias = GPIOD_LINE_BIAS_DISABLED; // AS_IS would keep the old pull
+        }
+        if (currentDirection == PinDirection::INPUT && edgeEventsEnabled())
+        {
+            settings.edge = GPIOD_LINE_EDGE_BOTH;
+            settings.debounceUs = softwareDebounce ? 0 : debouncePeriodUs;
+        }
+    }
+
+    if (!request->reconfigure({settings}))
+    {
+        PIPINPP_LOG_WARNING("Failed to reconfigure pin " << pinNumber);
+        return false;
+    }
+
+    pipinpp::OutputShadow& shadow = chip->outputShadow();
+    if (mode == PinMode::OUTPUT)
+    {
+        shadow.claim(pinNumber, false);
+        eventBuffer.clear();
+        eventBuffer.shrink_to_fit();
+        debouncePeriodUs = 0;
+        softwareDebounce = false;
+        lastEdgeNs = 0;
+        currentDirection = PinDirection::OUTPUT;
+    }
+    else
+    {
+        if (currentDirection == PinDirection::OUTPUT)
+        {
+            shadow.release(pinNumber);
+        }
+        currentDirection = PinDirection::INPUT;
+    }
+    currentBias = settings.bias;
+
+    PIPINPP_LOG_DEBUG("Reconfigured pin " << pinNumber << " as "
+                      << (mode == PinMode::OUTPUT ? "OUTPUT" :
+                          mode == PinMode::INPUT_PULLUP ? "INPUT_PULLUP" :
+                          mode == PinMode::INPUT_PULLDOWN ? "INPUT_PULLDOWN" : "INPUT"));
+    return true;
+}
+
+bool Pin::reconfigureInput(bool edges, uint32_t debounceUs)
+{
+    pipinpp::LineSettings settings;
+    settings.offset = pinNumber;
+    settings.direction = GPIOD_LINE_DIRECTION_INPUT;
+    settings.bias = currentBias;
+    settings.edge = edges ? GPIOD_LINE_EDGE_BOTH : GPIOD_LINE_EDGE_NONE;
+    settings.debounceUs = debounceUs;
+    return request->reconfigure({settings});
+}
+
+bool Pin::shiftOut(Pin& clock, bool msbFirst, const uint8_t* data, size_t length, uint32_t clockNs)
+{
+    if (!request || !clock.request || currentDirection != PinDirection::OUTPUT ||
+        clock.currentDirection != PinDirection::OUTPUT || (data == nullptr && length > 0))
+    {
+        return false;
+    }
+
+    // Clock pulses are timed: never recorded by a Transaction
+    pipinpp::ScopedTransactionBypass direct;
+
+    if (fastPath && fastPath == clock.fastPath)
+    {
+        // Register path: per bit value, what to clear with the clock going
+        // low (data too for a 0; a 1 is set right after)
+        pipinpp::GpioMem* regs = fastPath;
+        const uint32_t dataMask = pinMask;
+        const uint32_t clockMask = clock.pinMask;
+        const uint32_t clearMask[2] = {clockMask | dataMask, clockMask};
+        unsigned int bit = 0;
+        for (size_t n = 0; n < length; ++n)
+        {
+            unsigned int byte = data[n];
+            for (int i = 0; i < 8; ++i)
+            {
+                bit = msbFirst ? (byte >> (7 - i)) & 1u : (byte >> i) & 1u;
+                regs->clear(clearMask[bit]);
+                if (bit)
+                {
+                    regs->set(dataMask);
+                }
+                spinNs(clockNs);
+                regs->set(clockMask);
+                spinNs(clockNs);
+            }
+        }
+        regs->clear(clockMask);
+
+        // The stores bypassed write(); leave the shadow as the lines are
+        if (length > 0)
+        {
+            chip->outputShadow().record(pinNumber, bit != 0);
+        }
+        clock.chip->outputShadow().record(clock.pinNumber, false);
+        return true;
+    }
+
+    for (size_t n = 0; n < length; ++n)
+    {
+        unsigned int byte = data[n];
+        for (int i = 0; i < 8; ++i)
+        {
+            bool bit = msbFirst ? (byte >> (7 - i)) & 1u : (byte >> i) & 1u;
+            if (!write(bit))
+            {
+                return false;
+            }
+            spinNs(clockNs);
+            if (!clock.write(true))
+            {
+                return false;
+            }
+            spinNs(clockNs);
+            if (!clock.write(false))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool Pin::shiftIn(Pin& clock, bool msbFirst, uint8_t* data, size_t length, uint32_t clockNs)
+{
+    if (!request || !clock.request || currentDirection != PinDirection::INPUT ||
+        clock.currentDirection != PinDirection::OUTPUT || (data == nullptr && length > 0))
+    {
+        return false;
+    }
+
+    // Clock pulses are timed: never recorded by a Transaction
+    pipinpp::ScopedTransactionBypass direct;
+
+    for (size_t n = 0; n < length; ++n)
+    {
+        unsigned int byte = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            if (!clock.write(true))
+            {
+                return false;
+            }
+            spinNs(clockNs);
+            int level = read();
+            if (level < 0)
+            {
+                return false;
+            }
+            byte |= static_cast<unsigned int>(level) << (msbFirst ? 7 - i : i);
+            if (!clock.write(false))
+            {
+                return false;
+            }
+            spinNs(clockNs);
+        }
+        data[n] = static_cast<uint8_t>(byte);
+    }
+    return true;
 }
 
 void Pin::validatePinNumber(int pin) 
 {
-    // Raspberry Pi GPIO pins: 0-27 are generally valid
+    // Raspberry Pi GPIO pins: 0-27 are generally valid (see board.hpp)
     // Some pins have special functions, but we'll allow them for flexibility
-    if (pin < 0 || pin > 27) {
+    if (!pipinpp::isValidGpioPin(pin)) {
         throw InvalidPinError(pin, "Valid range is 0-27 for Raspberry Pi");
     }
     
     // Warn about commonly reserved pins (but don't block them)
-    if (pin == 0 || pin == 1) {
+    if (pipinpp::BUILD_BOARD.isReserved(pin)) {
         PIPINPP_LOG_WARNING("GPIO pin " << pin << " is typically reserved for I2C (ID_SD/ID_SC). Use with caution.");
-    } else if (pin == 14 || pin == 15) {
+    } else if (pipinpp::BUILD_BOARD.isUart(pin)) {
         PIPINPP_LOG_WARNING("GPIO pin " << pin << " is typically used for UART (TXD/RXD). Use with caution.");
     }
 }
\ No newline at end of file
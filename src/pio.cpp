@@ -0,0 +1,456 @@
+/**
+ * @file pio.cpp
+ * @brief PIO program assembly, built-in programs and piolib-backed state machines
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "pio.hpp"
+#include "log.hpp"
+#include "platform.hpp"
+#include "quadrature_encoder.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#ifdef PIPINPP_HAVE_PIOLIB
+#include <piolib.h>
+#endif
+
+namespace pipinpp {
+
+// ============================================================================
+// PioProgram Implementation
+// ============================================================================
+
+PioProgram::PioProgram(uint8_t sidesetBits, bool sidesetOptional)
+    : sidesetBits_(sidesetBits), sidesetOptional_(sidesetOptional && sidesetBits > 0) {
+    if (sidesetBits_ + (sidesetOptional_ ? 1 : 0) > 5) {
+        throw std::invalid_argument("PIO side-set needs " + std::to_string(sidesetBits_) +
+                                    " bits plus enable; the field has 5");
+    }
+}
+
+uint8_t PioProgram::add(uint16_t instruction, uint8_t delay, int sideset) {
+    if (instructions_.size() >= PIO_MAX_INSTRUCTIONS) {
+        throw std::invalid_argument("PIO program is full (32 instructions)");
+    }
+    if (delay > maxDelay()) {
+        throw std::invalid_argument("PIO delay " + std::to_string(delay) + " exceeds " +
+                                    std::to_string(maxDelay()) + " with this side-set");
+    }
+    if (sideset >= 0 && (sidesetBits_ == 0 || sideset >= (1 << sidesetBits_))) {
+        throw std::invalid_argument("PIO side-set value " + std::to_string(sideset) + " does not fit " +
+                                    std::to_string(sidesetBits_) + " side-set bits");
+    }
+    if (sideset < 0 && sidesetBits_ > 0 && !sidesetOptional_) {
+        throw std::invalid_argument("Every instruction needs a side-set value (side-set is not optional)");
+    }
+
+    // Bits 12:8: [enable][side-set value][delay], enable only when optional
+    uint16_t field = delay;
+    if (sideset >= 0) {
+        field |= static_cast<uint16_t>(sideset << delayBits());
+        if (sidesetOptional_) {
+            field |= 0x10;
+        }
+    }
+    instructions_.push_back(static_cast<uint16_t>((instruction & ~0x1f00) | (field << 8)));
+    return static_cast<uint8_t>(instructions_.size() - 1);
+}
+
+void PioProgram::setWrap(uint8_t wrapTarget, uint8_t wrap) {
+    wrapTarget_ = wrapTarget;
+    wrap_ = wrap;
+}
+
+uint8_t PioProgram::wrap() const {
+    if (wrap_ >= 0) {
+        return static_cast<uint8_t>(wrap_);
+    }
+    return instructions_.empty() ? 0 : static_cast<uint8_t>(instructions_.size() - 1);
+}
+
+// ============================================================================
+// Built-in programs
+// ============================================================================
+
+PioProgram pioWs2812Program() {
+    // Bit period T1 + T2 + T3 = PIO_WS2812_CYCLES_PER_BIT: HIGH for T1 (0) or T1 + T2 (1)
+    constexpr uint8_t T1 = 2, T2 = 5, T3 = 3;
+    static_assert(T1 + T2 + T3 == PIO_WS2812_CYCLES_PER_BIT, "WS2812 bit timing");
+    PioProgram program(1);
+    program.add(pioOut(PioOutDest::X, 1), T3 - 1, 0);                 // 0: bitloop
+    program.add(pioJmp(PioJmp::NOT_X, 3), T1 - 1, 1);                 // 1
+    program.add(pioJmp(PioJmp::ALWAYS, 0), T2 - 1, 1);                // 2: do_one
+    program.add(pioNop(), T2 - 1, 0);                                  // 3: do_zero
+    return program;
+}
+
+PioProgram pioQuadratureProgram() {
+    constexpr uint8_t DECREMENT = 16, UPDATE = 17, INCREMENT = 23;
+    PioProgram program;
+    program.setOrigin(0);
+
+    // 0-15: jump table indexed by (previous << 2) | current. The pins read
+    // as A in bit 0 and B in bit 1, the reverse of QuadratureDecoder's state.
+    auto decoderState = [](unsigned pins) { return static_cast<uint8_t>(((pins & 1) << 1) | (pins >> 1)); };
+    for (unsigned index = 0; index < 16; ++index) {
+        int step = QuadratureDecoder::transition(decoderState(index >> 2), decoderState(index & 3));
+        program.add(pioJmp(PioJmp::ALWAYS, step == 1 ? INCREMENT : (step == -1 ? DECREMENT : UPDATE)));
+    }
+    program.add(pioJmp(PioJmp::Y_DEC, UPDATE));                                      // 16: decrement
+    program.add(pioMov(PioMovDest::ISR, PioMovSource::Y));                           // 17: update
+    program.add(pioPush(false, false));                                              // 18
+    program.add(pioOut(PioOutDest::ISR, 2));                                         // 19: previous pins
+    program.add(pioIn(PioInSource::PINS, 2));                                        // 20: append current
+    program.add(pioMov(PioMovDest::OSR, PioMovSource::ISR));                         // 21
+    program.add(pioMov(PioMovDest::PC, PioMovSource::ISR));                          // 22
+    program.add(pioMov(PioMovDest::Y, PioMovSource::Y, PioMovOp::INVERT));           // 23: increment
+    program.add(pioJmp(PioJmp::Y_DEC, 25));                                          // 24: Y = ~(~Y - 1)
+    program.add(pioMov(PioMovDest::Y, PioMovSource::Y, PioMovOp::INVERT));           // 25
+    program.setWrap(UPDATE, 25);
+    return program;
+}
+
+PioProgram pioParallelOutputProgram(uint8_t width) {
+    if (width == 0 || width > 32) {
+        throw std::invalid_argument("PIO parallel output width must be 1-32 (got " + std::to_string(width) + ")");
+    }
+    PioProgram program;
+    program.add(pioOut(PioOutDest::PINS, width));
+    return program;
+}
+
+PioProgram pioPwmProgram() {
+    PioProgram program(1, true);
+    program.add(pioPull(false, false), 0, 0);                         // 0: latest duty, or keep X
+    program.add(pioMov(PioMovDest::X, PioMovSource::OSR));            // 1
+    program.add(pioMov(PioMovDest::Y, PioMovSource::ISR));            // 2: period
+    program.add(pioJmp(PioJmp::X_NE_Y, 5));                           // 3: countloop
+    program.add(pioJmp(PioJmp::ALWAYS, 6), 0, 1);                     // 4: count reached duty
+    program.add(pioNop());                                             // 5
+    program.add(pioJmp(PioJmp::Y_DEC, 3));                            // 6
+    return program;
+}
+
+PioProgram pioWaveProgram() {
+    PioProgram program;
+    program.add(pioPull());                                            // 0: levels
+    program.add(pioOut(PioOutDest::PINS, 32));                        // 1
+    program.add(pioPull());                                            // 2: delay
+    program.add(pioOut(PioOutDest::X, 32));                           // 3
+    program.add(pioJmp(PioJmp::X_DEC, 4));                            // 4: X + 1 cycles
+    static_assert(PIO_WAVE_STEP_CYCLES == 5, "four fixed instructions plus the final JMP");
+    return program;
+}
+
+// ============================================================================
+// PioStateMachine Implementation
+// ============================================================================
+
+#ifdef PIPINPP_HAVE_PIOLIB
+
+namespace {
+
+// Bulk writes go through the kernel in buffers of this size
+constexpr size_t XFER_BUFFER_BYTES = 4096;
+
+} // namespace
+
+struct PioStateMachine::Impl {
+    PIO pio = nullptr;
+    int sm = -1;
+    std::vector<uint16_t> instructions;
+    pio_program_t program;
+    uint offset = 0;
+    bool xferConfigured = false;
+    double clockHz = 0.0;
+};
+
+PioStateMachine::PioStateMachine() = default;
+
+PioStateMachine::~PioStateMachine() {
+    end();
+}
+
+bool PioStateMachine::isSupported() {
+    return PlatformInfo::instance().getPlatform() == Platform::RASPBERRY_PI_5 &&
+           access("/dev/pio0", R_OK | W_OK) == 0;
+}
+
+bool PioStateMachine::begin(const PioProgram& program, const PioSmConfig& config) {
+    end();
+    if (program.size() == 0 || !isSupported()) {
+        return false;
+    }
+
+    std::unique_ptr<Impl> impl(new Impl());
+    impl->pio = pio_open(0);
+    if (!impl->pio || PIO_IS_ERR(impl->pio)) {
+        PIPINPP_LOG_ERROR("Cannot open /dev/pio0");
+        return false;
+    }
+    pio_enable_fatal_errors(impl->pio, false);
+
+    auto fail = [&impl](const char* what) {
+        PIPINPP_LOG_ERROR("PIO: " << what);
+        (void)what; // Only used when logging is enabled
+        if (impl->sm >= 0) {
+            pio_sm_unclaim(impl->pio, static_cast<uint>(impl->sm));
+        }
+        pio_close(impl->pio);
+        return false;
+    };
+
+    impl->sm = pio_claim_unused_sm(impl->pio, false);
+    if (impl->sm < 0) {
+        return fail("no free state machine");
+    }
+    const uint sm = static_cast<uint>(impl->sm);
+
+    impl->instructions = program.instructions();
+    impl->program = pio_program_t();
+    impl->program.instructions = impl->instructions.data();
+    impl->program.length = static_cast<uint8_t>(impl->instructions.size());
+    impl->program.origin = static_cast<int8_t>(program.origin());
+    if (program.origin() >= 0) {
+        if (!pio_can_add_program_at_offset(impl->pio, &impl->program, static_cast<uint>(program.origin()))) {
+            return fail("instruction memory at the program's origin is in use");
+        }
+        impl->offset = static_cast<uint>(program.origin());
+        pio_add_program_at_offset(impl->pio, &impl->program, impl->offset);
+    } else {
+        if (!pio_can_add_program(impl->pio, &impl->program)) {
+            return fail("not enough free instruction memory");
+        }
+        impl->offset = pio_add_program(impl->pio, &impl->program);
+    }
+
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, impl->offset + program.wrapTarget(), impl->offset + program.wrap());
+
+    uint32_t outputs = 0;
+    uint32_t inputs = 0;
+    auto range = [](int base, unsigned count) {
+        return (base < 0 || count == 0) ? 0u : static_cast<uint32_t>(((1ull << count) - 1) << base);
+    };
+    if (program.sidesetBits() > 0) {
+        sm_config_set_sideset(&c, program.sidesetBits() + (program.sidesetOptional() ? 1 : 0),
+                              program.sidesetOptional(), false);
+        if (config.sidesetBase >= 0) {
+            sm_config_set_sideset_pins(&c, static_cast<uint>(config.sidesetBase));
+            outputs |= range(config.sidesetBase, program.sidesetBits());
+        }
+    }
+    if (config.outBase >= 0) {
+        sm_config_set_out_pins(&c, static_cast<uint>(config.outBase), config.outCount);
+        outputs |= range(config.outBase, config.outCount);
+    }
+    if (config.setBase >= 0) {
+        sm_config_set_set_pins(&c, static_cast<uint>(config.setBase), config.setCount);
+        outputs |= range(config.setBase, config.setCount);
+    }
+    if (config.inBase >= 0) {
+        sm_config_set_in_pins(&c, static_cast<uint>(config.inBase));
+        inputs |= range(config.inBase, config.inCount);
+    }
+    if (config.jmpPin >= 0) {
+        sm_config_set_jmp_pin(&c, static_cast<uint>(config.jmpPin));
+        inputs |= 1u << config.jmpPin;
+    }
+    if (config.pinMask != 0) {
+        outputs &= config.pinMask;
+        inputs &= config.pinMask;
+    }
+    inputs &= ~outputs;
+
+    sm_config_set_out_shift(&c, config.outShiftRight, config.autopull, config.pullThreshold);
+    sm_config_set_in_shift(&c, config.inShiftRight, config.autopush, config.pushThreshold);
+    if (config.fifoJoin == PioFifoJoin::TX) {
+        sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    } else if (config.fifoJoin == PioFifoJoin::RX) {
+        sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+    }
+
+    const double sysHz = static_cast<double>(clock_get_hz(clk_sys));
+    double divider = config.clockHz > 0.0 ? sysHz / config.clockHz : 1.0;
+    divider = std::min(std::max(divider, 1.0), 65535.0);
+    sm_config_set_clkdiv(&c, static_cast<float>(divider));
+    impl->clockHz = sysHz / divider;
+
+    for (int pin = 0; pin < 32; ++pin) {
+        if ((outputs | inputs) & (1u << pin)) {
+            pio_gpio_init(impl->pio, static_cast<uint>(pin));
+            if ((inputs & (1u << pin)) && config.inputPullUp) {
+                gpio_set_pulls(static_cast<uint>(pin), true, false);
+            }
+        }
+    }
+    // Outputs start LOW
+    pio_sm_set_pins_with_mask(impl->pio, sm, 0, outputs);
+    pio_sm_set_pindirs_with_mask(impl->pio, sm, outputs, outputs | inputs);
+
+    pio_sm_init(impl->pio, sm, impl->offset, &c);
+    pio_sm_set_enabled(impl->pio, sm, config.enable);
+    impl_ = std::move(impl);
+    return true;
+}
+
+void PioStateMachine::end() {
+    if (!impl_) {
+        return;
+    }
+    const uint sm = static_cast<uint>(impl_->sm);
+    pio_sm_set_enabled(impl_->pio, sm, false);
+    pio_remove_program(impl_->pio, &impl_->program, impl_->offset);
+    pio_sm_unclaim(impl_->pio, sm);
+    pio_close(impl_->pio);
+    impl_.reset();
+}
+
+bool PioStateMachine::put(uint32_t word) {
+    if (!impl_) {
+        return false;
+    }
+    pio_sm_put_blocking(impl_->pio, static_cast<uint>(impl_->sm), word);
+    return true;
+}
+
+bool PioStateMachine::write(const uint32_t* words, size_t count) {
+    if (!impl_) {
+        return false;
+    }
+    const uint sm = static_cast<uint>(impl_->sm);
+    if (!impl_->xferConfigured) {
+        if (pio_sm_config_xfer(impl_->pio, sm, PIO_DIR_TO_SM, XFER_BUFFER_BYTES, 2) != 0) {
+            PIPINPP_LOG_ERROR("PIO: cannot set up DMA transfers");
+            return false;
+        }
+        impl_->xferConfigured = true;
+    }
+    const size_t chunkWords = XFER_BUFFER_BYTES / sizeof(uint32_t);
+    while (count > 0) {
+        size_t n = std::min(count, chunkWords);
+        if (pio_sm_xfer_data(impl_->pio, sm, PIO_DIR_TO_SM, n * sizeof(uint32_t),
+                             const_cast<uint32_t*>(words)) != 0) {
+            PIPINPP_LOG_ERROR("PIO: DMA transfer failed");
+            return false;
+        }
+        words += n;
+        count -= n;
+    }
+    return true;
+}
+
+bool PioStateMachine::get(uint32_t& word) {
+    if (!impl_) {
+        return false;
+    }
+    word = pio_sm_get_blocking(impl_->pio, static_cast<uint>(impl_->sm));
+    return true;
+}
+
+bool PioStateMachine::tryGet(uint32_t& word) {
+    if (!impl_ || pio_sm_is_rx_fifo_empty(impl_->pio, static_cast<uint>(impl_->sm))) {
+        return false;
+    }
+    word = pio_sm_get(impl_->pio, static_cast<uint>(impl_->sm));
+    return true;
+}
+
+bool PioStateMachine::isTxEmpty() const {
+    return !impl_ || pio_sm_is_tx_fifo_empty(impl_->pio, static_cast<uint>(impl_->sm));
+}
+
+bool PioStateMachine::exec(uint16_t instruction) {
+    if (!impl_) {
+        return false;
+    }
+    pio_sm_exec(impl_->pio, static_cast<uint>(impl_->sm), instruction);
+    return true;
+}
+
+bool PioStateMachine::setEnabled(bool enabled) {
+    if (!impl_) {
+        return false;
+    }
+    pio_sm_set_enabled(impl_->pio, static_cast<uint>(impl_->sm), enabled);
+    return true;
+}
+
+bool PioStateMachine::restart() {
+    if (!impl_) {
+        return false;
+    }
+    const uint sm = static_cast<uint>(impl_->sm);
+    pio_sm_set_enabled(impl_->pio, sm, false);
+    pio_sm_clear_fifos(impl_->pio, sm);
+    pio_sm_restart(impl_->pio, sm);
+    pio_sm_exec(impl_->pio, sm, pioJmp(PioJmp::ALWAYS, static_cast<uint8_t>(impl_->offset)));
+    pio_sm_set_enabled(impl_->pio, sm, true);
+    return true;
+}
+
+uint8_t PioStateMachine::getOffset() const {
+    return impl_ ? static_cast<uint8_t>(impl_->offset) : 0;
+}
+
+double PioStateMachine::getClockHz() const {
+    return impl_ ? impl_->clockHz : 0.0;
+}
+
+#else // !PIPINPP_HAVE_PIOLIB
+
+// Built without piolib: no state machine can be started
+struct PioStateMachine::Impl {};
+
+PioStateMachine::PioStateMachine() = default;
+PioStateMachine::~PioStateMachine() = default;
+
+bool PioStateMachine::isSupported() {
+    return false;
+}
+
+bool PioStateMachine::begin(const PioProgram&, const PioSmConfig&) {
+    PIPINPP_LOG_WARNING("PIO unavailable: PiPinPP was built without piolib");
+    return false;
+}
+
+void PioStateMachine::end() {}
+bool PioStateMachine::put(uint32_t) { return false; }
+bool PioStateMachine::write(const uint32_t*, size_t) { return false; }
+bool PioStateMachine::get(uint32_t&) { return false; }
+bool PioStateMachine::tryGet(uint32_t&) { return false; }
+bool PioStateMachine::isTxEmpty() const { return true; }
+bool PioStateMachine::exec(uint16_t) { return false; }
+bool PioStateMachine::setEnabled(bool) { return false; }
+bool PioStateMachine::restart() { return false; }
+uint8_t PioStateMachine::getOffset() const { return 0; }
+double PioStateMachine::getClockHz() const { return 0.0; }
+
+#endif // PIPINPP_HAVE_PIOLIB
+
+} // namespace pipinpp
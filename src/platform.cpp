@@ -6,10 +6,13 @@
  */
 
 #include "platform.hpp"
+#include "log.hpp"
+#include "cache_file.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cstdio>
 #include <sys/utsname.h>
 #include <unistd.h>
 #include <gpiod.h>
@@ -17,6 +20,28 @@
 
 namespace pipinpp {
 
+namespace {
+
+constexpr const char* CACHE_MAGIC = "pipinpp-platform 2";
+
+std::string kernelRelease()
+{
+    struct utsname buffer;
+    return uname(&buffer) == 0 ? std::string(buffer.release) : std::string("Unknown");
+}
+
+// Boot ID, kernel release and effective user: device nodes can change
+// across reboots and kernel upgrades, and "available" depends on who asks
+std::string cacheKey()
+{
+    std::ifstream file("/proc/sys/kernel/random/boot_id");
+    std::string bootId;
+    std::getline(file, bootId);
+    return bootId + " " + kernelRelease() + " " + std::to_string(geteuid());
+}
+
+} // namespace
+
 // Singleton instance
 PlatformInfo& PlatformInfo::instance() 
 {
@@ -24,23 +49,172 @@ PlatformInfo& PlatformInfo::instance()
     return instance;
 }
 
-// Constructor
+// Constructor (nothing is detected until asked for)
 PlatformInfo::PlatformInfo()
     : platform_(Platform::UNKNOWN)
     , capabilities_{}
     , kernelVersion_("")
     , libgpiodVersion_("")
-    , detected_(false)
+    , detected_(0)
+    , fromCache_(false)
+    , cacheChecked_(false)
+{
+}
+
+// Lazy detection
+void PlatformInfo::ensure(unsigned what) const
+{
+    if ((detected_.load(std::memory_order_acquire) & what) == what) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    unsigned done = detected_.load(std::memory_order_relaxed);
+    if ((done & what) == what) {
+        return;
+    }
+    
+    bool saveCache = false;
+    if (!cachePath_.empty() && !cacheChecked_) {
+        cacheChecked_ = true;
+        Platform platform = Platform::UNKNOWN;
+        PlatformCapabilities capabilities{};
+        if (loadPlatformCache(cachePath_, platform, capabilities)) {
+            PIPINPP_LOG_DEBUG("Platform: using cache " << cachePath_);
+            // Keep anything already handed out by reference
+            if (!(done & DETECTED_PLATFORM)) {
+                platform_ = platform;
+            }
+            if (!(done & DETECTED_GPIO)) {
+                capabilities_.gpioChips = std::move(capabilities.gpioChips);
+                capabilities_.totalGPIOPins = capabilities.totalGPIOPins;
+            }
+            if (!(done & DETECTED_I2C)) {
+                capabilities_.i2cBuses = std::move(capabilities.i2cBuses);
+            }
+            if (!(done & DETECTED_PWM)) {
+                capabilities_.pwmChannels = std::move(capabilities.pwmChannels);
+            }
+            if (!(done & DETECTED_DMA)) {
+                capabilities_.hasDMASupport = capabilities.hasDMASupport;
+                capabilities_.peripheralBase = capabilities.hasDMASupport ? peripheralBaseFor(platform_) : 0;
+            }
+            done |= DETECTED_CACHED;
+            fromCache_.store(true, std::memory_order_release);
+        } else {
+            // Detect everything once so the whole cache can be written
+            what = DETECTED_ALL;
+            saveCache = true;
+        }
+    }
+    
+    done = detectLocked(what, done);
+    detected_.store(done, std::memory_order_release);
+    
+    if (saveCache && !savePlatformCache(cachePath_, platform_, capabilities_)) {
+        PIPINPP_LOG_DEBUG("Platform: could not write cache " << cachePath_);
+    }
+}
+
+// Run the missing detect methods, dependencies first
+unsigned PlatformInfo::detectLocked(unsigned what, unsigned done) const
+{
+    unsigned missing = what & ~done;
+    if (missing & (DETECTED_PWM | DETECTED_DMA)) {
+        missing |= DETECTED_PLATFORM & ~done;   // Both depend on the model
+    }
+    
+    if (missing & DETECTED_PLATFORM) {
+        detectPlatform();
+    }
+    if (missing & DETECTED_KERNEL) {
+        detectKernelVersion();
+    }
+    if (missing & DETECTED_LIBGPIOD) {
+        detectLibgpiodVersion();
+    }
+    if (missing & DETECTED_GPIO) {
+        detectGPIOChips();
+    }
+    if (missing & DETECTED_I2C) {
+        detectI2CBuses();
+    }
+    if (missing & DETECTED_PWM) {
+        detectPWMChannels();
+    }
+    if (missing & DETECTED_DMA) {
+        detectDMASupport();
+    }
+    return done | missing;
+}
+
+// Lazy getters
+Platform PlatformInfo::getPlatform() const
+{
+    ensure(DETECTED_PLATFORM);
+    return platform_;
+}
+
+const PlatformCapabilities& PlatformInfo::getCapabilities() const
+{
+    ensure(DETECTED_ALL);
+    return capabilities_;
+}
+
+const std::vector<GPIOChipInfo>& PlatformInfo::getGPIOChips() const
+{
+    ensure(DETECTED_GPIO);
+    return capabilities_.gpioChips;
+}
+
+const std::vector<I2CBusInfo>& PlatformInfo::getI2CBuses() const
+{
+    ensure(DETECTED_I2C);
+    return capabilities_.i2cBuses;
+}
+
+const std::vector<PWMChannelInfo>& PlatformInfo::getPWMChannels() const
+{
+    ensure(DETECTED_PWM);
+    return capabilities_.pwmChannels;
+}
+
+uint32_t PlatformInfo::getPeripheralBase() const
+{
+    ensure(DETECTED_DMA);
+    return capabilities_.peripheralBase;
+}
+
+std::string PlatformInfo::getKernelVersion() const
+{
+    ensure(DETECTED_KERNEL);
+    return kernelVersion_;
+}
+
+std::string PlatformInfo::getLibgpiodVersion() const
+{
+    ensure(DETECTED_LIBGPIOD);
+    return libgpiodVersion_;
+}
+
+// Cache configuration
+void PlatformInfo::setCachePath(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cachePath_ = path;
+    cacheChecked_ = false;
+}
+
+std::string PlatformInfo::getCachePath() const
 {
-    detectPlatform();
-    detectCapabilities();
-    detected_ = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cachePath_;
 }
 
 // Platform name mapping
 std::string PlatformInfo::getPlatformName() const 
 {
-    switch (platform_) {
+    switch (getPlatform()) {
         case Platform::RASPBERRY_PI_3:     return "Raspberry Pi 3";
         case Platform::RASPBERRY_PI_4:     return "Raspberry Pi 4";
         case Platform::RASPBERRY_PI_5:     return "Raspberry Pi 5";
@@ -58,41 +232,48 @@ std::string PlatformInfo::getPlatformName() const
 // Check if Raspberry Pi
 bool PlatformInfo::isRaspberryPi() const 
 {
-    return platform_ == Platform::RASPBERRY_PI_3 ||
-           platform_ == Platform::RASPBERRY_PI_4 ||
-           platform_ == Platform::RASPBERRY_PI_5 ||
-           platform_ == Platform::RASPBERRY_PI_CM4 ||
-           platform_ == Platform::RASPBERRY_PI_ZERO ||
-           platform_ == Platform::RASPBERRY_PI_ZERO2;
+    return isRaspberryPiModel(getPlatform());
+}
+
+bool PlatformInfo::isRaspberryPiModel(Platform platform)
+{
+    return platform == Platform::RASPBERRY_PI_3 ||
+           platform == Platform::RASPBERRY_PI_4 ||
+           platform == Platform::RASPBERRY_PI_5 ||
+           platform == Platform::RASPBERRY_PI_CM4 ||
+           platform == Platform::RASPBERRY_PI_ZERO ||
+           platform == Platform::RASPBERRY_PI_ZERO2;
 }
 
 // Get default GPIO chip
 std::string PlatformInfo::getDefaultGPIOChip() const 
 {
-    if (capabilities_.gpioChips.empty()) {
+    const auto& chips = getGPIOChips();
+    if (chips.empty()) {
         return "gpiochip0";  // Fallback default
     }
     
     // Return first available chip
-    for (const auto& chip : capabilities_.gpioChips) {
+    for (const auto& chip : chips) {
         if (chip.available) {
             return chip.name;
         }
     }
     
-    return capabilities_.gpioChips[0].name;
+    return chips[0].name;
 }
 
 // Get default I2C bus
 int PlatformInfo::getDefaultI2CBus() const 
 {
-    if (capabilities_.i2cBuses.empty()) {
+    const auto& buses = getI2CBuses();
+    if (buses.empty()) {
         return 1;  // Fallback default
     }
     
     // Raspberry Pi 5 uses /dev/i2c-20 by default
-    if (platform_ == Platform::RASPBERRY_PI_5) {
-        for (const auto& bus : capabilities_.i2cBuses) {
+    if (getPlatform() == Platform::RASPBERRY_PI_5) {
+        for (const auto& bus : buses) {
             if (bus.busNumber == 20 && bus.available) {
                 return 20;
             }
@@ -100,18 +281,20 @@ int PlatformInfo::getDefaultI2CBus() const
     }
     
     // Return first available bus
-    for (const auto& bus : capabilities_.i2cBuses) {
+    for (const auto& bus : buses) {
         if (bus.available) {
             return bus.busNumber;
         }
     }
     
-    return capabilities_.i2cBuses[0].busNumber;
+    return buses[0].busNumber;
 }
 
 // Print platform information
 void PlatformInfo::printInfo() const 
 {
+    ensure(DETECTED_ALL);
+    
     std::cout << "╔════════════════════════════════════════════════════════════════╗\n";
     std::cout << "║               PiPin++ Platform Information                     ║\n";
     std::cout << "╚════════════════════════════════════════════════════════════════╝\n\n";
@@ -167,18 +350,25 @@ void PlatformInfo::printInfo() const
 // Force refresh
 void PlatformInfo::refresh() 
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     platform_ = Platform::UNKNOWN;
     capabilities_ = PlatformCapabilities{};
     kernelVersion_.clear();
     libgpiodVersion_.clear();
     
-    detectPlatform();
-    detectCapabilities();
-    detected_ = true;
+    detected_.store(detectLocked(DETECTED_ALL, 0), std::memory_order_release);
+    fromCache_.store(false, std::memory_order_release);
+    
+    if (!cachePath_.empty()) {
+        cacheChecked_ = true;
+        if (!savePlatformCache(cachePath_, platform_, capabilities_)) {
+            PIPINPP_LOG_DEBUG("Platform: could not write cache " << cachePath_);
+        }
+    }
 }
 
 // Detect platform
-void PlatformInfo::detectPlatform() 
+void PlatformInfo::detectPlatform() const
 {
     // Try /proc/device-tree/model first (Raspberry Pi, modern kernels)
     platform_ = parseDeviceTree();
@@ -187,30 +377,13 @@ void PlatformInfo::detectPlatform()
     if (platform_ == Platform::UNKNOWN) {
         platform_ = parseCPUInfo();
     }
-    
-    detectKernelVersion();
-    detectLibgpiodVersion();
-}
-
-// Detect all capabilities
-void PlatformInfo::detectCapabilities() 
-{
-    detectGPIOChips();
-    detectI2CBuses();
-    detectPWMChannels();
-    detectDMASupport();
-    
-    // Count total GPIO pins
-    capabilities_.totalGPIOPins = 0;
-    for (const auto& chip : capabilities_.gpioChips) {
-        capabilities_.totalGPIOPins += chip.numLines;
-    }
 }
 
 // Detect GPIO chips
-void PlatformInfo::detectGPIOChips() 
+void PlatformInfo::detectGPIOChips() const
 {
     capabilities_.gpioChips.clear();
+    capabilities_.totalGPIOPins = 0;
     
     // Enumerate all gpiochip devices
     for (int i = 0; i < 16; i++) {  // Check up to gpiochip15
@@ -241,6 +414,7 @@ void PlatformInfo::detectGPIOChips()
         info.available = true;
         
         capabilities_.gpioChips.push_back(info);
+        capabilities_.totalGPIOPins += info.numLines;
         
         gpiod_chip_info_free(chip_info);
         gpiod_chip_close(chip);
@@ -248,7 +422,7 @@ void PlatformInfo::detectGPIOChips()
 }
 
 // Detect I2C buses
-void PlatformInfo::detectI2CBuses() 
+void PlatformInfo::detectI2CBuses() const
 {
     capabilities_.i2cBuses.clear();
     
@@ -268,7 +442,7 @@ void PlatformInfo::detectI2CBuses()
 }
 
 // Detect PWM channels
-void PlatformInfo::detectPWMChannels() 
+void PlatformInfo::detectPWMChannels() const
 {
     capabilities_.pwmChannels.clear();
     
@@ -314,7 +488,7 @@ void PlatformInfo::detectPWMChannels()
     closedir(dir);
     
     // Map PWM channels to GPIO pins (Raspberry Pi specific)
-    if (isRaspberryPi()) {
+    if (isRaspberryPiModel(platform_)) {
         // Pi 4/5: PWM0 = GPIO18, PWM1 = GPIO19 (common mapping)
         for (auto& pwm : capabilities_.pwmChannels) {
             if (pwm.chip == 0 && pwm.channel == 0) {
@@ -327,30 +501,25 @@ void PlatformInfo::detectPWMChannels()
 }
 
 // Detect kernel version
-void PlatformInfo::detectKernelVersion() 
+void PlatformInfo::detectKernelVersion() const
 {
-    struct utsname buffer;
-    if (uname(&buffer) == 0) {
-        kernelVersion_ = buffer.release;
-    } else {
-        kernelVersion_ = "Unknown";
-    }
+    kernelVersion_ = kernelRelease();
 }
 
 // Detect libgpiod version
-void PlatformInfo::detectLibgpiodVersion() 
+void PlatformInfo::detectLibgpiodVersion() const
 {
     libgpiodVersion_ = gpiod_api_version();
 }
 
 // Detect DMA support
-void PlatformInfo::detectDMASupport() 
+void PlatformInfo::detectDMASupport() const
 {
     capabilities_.hasDMASupport = false;
     capabilities_.peripheralBase = 0;
     
     // Only Raspberry Pi supports DMA GPIO (for now)
-    if (!isRaspberryPi()) {
+    if (!isRaspberryPiModel(platform_)) {
         return;
     }
     
@@ -362,13 +531,13 @@ void PlatformInfo::detectDMASupport()
     // Check if running as root (required for /dev/mem)
     if (geteuid() != 0) {
         // Not root - DMA might work but can't verify
-        capabilities_.peripheralBase = getPeripheralBase();
+        capabilities_.peripheralBase = peripheralBaseFor(platform_);
         capabilities_.hasDMASupport = (capabilities_.peripheralBase != 0);
         return;
     }
     
     // Get peripheral base address
-    capabilities_.peripheralBase = getPeripheralBase();
+    capabilities_.peripheralBase = peripheralBaseFor(platform_);
     capabilities_.hasDMASupport = (capabilities_.peripheralBase != 0);
 }
 
@@ -502,9 +671,9 @@ Platform PlatformInfo::parseDeviceTree() const
 }
 
 // Get peripheral base address
-uint32_t PlatformInfo::getPeripheralBase() const 
+uint32_t PlatformInfo::peripheralBaseFor(Platform platform)
 {
-    switch (platform_) {
+    switch (platform) {
         case Platform::RASPBERRY_PI_ZERO:
         case Platform::RASPBERRY_PI_3:
         case Platform::RASPBERRY_PI_ZERO2:
@@ -524,4 +693,118 @@ uint32_t PlatformInfo::getPeripheralBase() const
     }
 }
 
+// ============================================================================
+// Platform cache file
+// ============================================================================
+
+bool savePlatformCache(const std::string& path, Platform platform,
+                       const PlatformCapabilities& capabilities)
+{
+    // No peripheral base: it is an mmap offset for /dev/mem, so it always
+    // comes from the model, never from a file
+    std::ostringstream file;
+    file << CACHE_MAGIC << "\n" << cacheKey() << "\n";
+    file << "platform " << static_cast<int>(platform) << "\n";
+    file << "dma " << (capabilities.hasDMASupport ? 1 : 0) << "\n";
+    for (const auto& chip : capabilities.gpioChips) {
+        // Label last: it may contain spaces
+        file << "gpiochip " << chip.name << " " << chip.numLines << " "
+             << (chip.available ? 1 : 0) << " " << chip.label << "\n";
+    }
+    for (const auto& bus : capabilities.i2cBuses) {
+        file << "i2c " << bus.busNumber << " " << (bus.available ? 1 : 0) << "\n";
+    }
+    for (const auto& pwm : capabilities.pwmChannels) {
+        file << "pwm " << pwm.chip << " " << pwm.channel << " " << pwm.gpioPin << " "
+             << (pwm.available ? 1 : 0) << "\n";
+    }
+    return writeCacheFile(path, file.str());
+}
+
+bool loadPlatformCache(const std::string& path, Platform& platform,
+                       PlatformCapabilities& capabilities)
+{
+    std::string content;
+    if (!readCacheFile(path, content)) {
+        return false;
+    }
+    std::istringstream file(content);
+    std::string line;
+    if (!std::getline(file, line) || line != CACHE_MAGIC) {
+        return false;
+    }
+    if (!std::getline(file, line) || line != cacheKey()) {
+        return false;
+    }
+    
+    Platform parsedPlatform = Platform::UNKNOWN;
+    PlatformCapabilities parsed{};
+    bool havePlatform = false;
+    bool haveDma = false;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "platform") {
+            int value;
+            if (!(fields >> value) || value < static_cast<int>(Platform::UNKNOWN) ||
+                value > static_cast<int>(Platform::JETSON_NANO)) {
+                return false;
+            }
+            parsedPlatform = static_cast<Platform>(value);
+            havePlatform = true;
+        } else if (kind == "dma") {
+            int dma;
+            if (!(fields >> dma)) {
+                return false;
+            }
+            parsed.hasDMASupport = (dma != 0);
+            haveDma = true;
+        } else if (kind == "gpiochip") {
+            GPIOChipInfo chip;
+            int available;
+            if (!(fields >> chip.name >> chip.numLines >> available)) {
+                return false;
+            }
+            chip.available = (available != 0);
+            fields.get();   // Separator before the label
+            std::getline(fields, chip.label);
+            parsed.totalGPIOPins += chip.numLines;
+            parsed.gpioChips.push_back(std::move(chip));
+        } else if (kind == "i2c") {
+            I2CBusInfo bus;
+            int available;
+            if (!(fields >> bus.busNumber >> available)) {
+                return false;
+            }
+            bus.devicePath = "/dev/i2c-" + std::to_string(bus.busNumber);
+            bus.available = (available != 0);
+            parsed.i2cBuses.push_back(bus);
+        } else if (kind == "pwm") {
+            PWMChannelInfo pwm;
+            int available;
+            if (!(fields >> pwm.chip >> pwm.channel >> pwm.gpioPin >> available)) {
+                return false;
+            }
+            pwm.sysfsPath = "/sys/class/pwm/pwmchip" + std::to_string(pwm.chip);
+            pwm.available = (available != 0);
+            parsed.pwmChannels.push_back(pwm);
+        } else {
+            return false;
+        }
+    }
+    if (!havePlatform || !haveDma) {
+        return false;
+    }
+    
+    platform = parsedPlatform;
+    capabilities = std::move(parsed);
+    return true;
+}
+
+std::string platformDefaultCachePath()
+{
+    return runtimeCachePath("platform.cache");
+}
+
 } // namespace pipinpp
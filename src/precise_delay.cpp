@@ -0,0 +1,153 @@
+/**
+ * @file precise_delay.cpp
+ * @brief Sleep-then-spin delay calibration and implementation
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "precise_delay.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+#include <vector>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr int64_t CALIBRATION_SLEEP_NS = 200000;
+constexpr int64_t CALIBRATION_MARGIN_NS = 2000;
+constexpr int64_t DEFAULT_OVERSHOOT_NS = 100000;    // Until measured: generous for non-RT kernels
+
+// High-percentile wake-up lateness: rises by half of any larger sample, decays by 1/64
+std::atomic<int64_t> overshootEstimate(DEFAULT_OVERSHOOT_NS);
+std::mutex calibrationMutex;
+PreciseDelayCalibration lastCalibration;
+
+inline void cpuRelax() {
+#if defined(__aarch64__) || (defined(__arm__) && __ARM_ARCH >= 7)
+    asm volatile("yield" ::: "memory");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+void sleepUntilNs(int64_t deadlineNs) {
+    timespec wake;
+    wake.tv_sec = static_cast<time_t>(deadlineNs / 1000000000LL);
+    wake.tv_nsec = static_cast<long>(deadlineNs % 1000000000LL);
+    int rc;
+    do {
+        rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr);
+    } while (rc == EINTR);
+}
+
+int64_t spinFor(int64_t overshootNs) {
+    return std::clamp(overshootNs + CALIBRATION_MARGIN_NS, PRECISE_DELAY_MIN_SPIN_NS, PRECISE_DELAY_MAX_SPIN_NS);
+}
+
+void recordOvershoot(int64_t overshootNs) {
+    int64_t estimate = overshootEstimate.load(std::memory_order_relaxed);
+    estimate += (overshootNs > estimate) ? (overshootNs - estimate) / 2 : (overshootNs - estimate) / 64;
+    overshootEstimate.store(estimate, std::memory_order_relaxed);  // Racy updates only blur the estimate
+}
+
+} // namespace
+
+PreciseDelayCalibration calibratePreciseDelay(int samples) {
+    std::vector<int64_t> overshoots;
+    overshoots.reserve(static_cast<size_t>(std::max(samples, 1)));
+    for (int i = 0; i < std::max(samples, 1); ++i) {
+        int64_t target = monotonicNowNs() + CALIBRATION_SLEEP_NS;
+        sleepUntilNs(target);
+        overshoots.push_back(std::max<int64_t>(monotonicNowNs() - target, 0));
+    }
+    std::sort(overshoots.begin(), overshoots.end());
+
+    // 90th percentile: rarer outliers raise the running estimate when they happen
+    const int64_t p90 = overshoots[(overshoots.size() * 9) / 10];
+    overshootEstimate.store(p90, std::memory_order_relaxed);
+
+    PreciseDelayCalibration result;
+    result.medianOvershootNs = overshoots[overshoots.size() / 2];
+    result.maxOvershootNs = overshoots.back();
+    result.spinNs = spinFor(p90);
+    result.counterHz = cycleCounterHz();
+    {
+        std::lock_guard<std::mutex> lock(calibrationMutex);
+        lastCalibration = result;
+    }
+
+    PIPINPP_LOG_INFO("Precise delay calibrated: median wake-up " << result.medianOvershootNs
+                     << " ns late, spinning the last " << result.spinNs << " ns");
+    return result;
+}
+
+PreciseDelayCalibration getPreciseDelayCalibration() {
+    PreciseDelayCalibration result;
+    {
+        std::lock_guard<std::mutex> lock(calibrationMutex);
+        result = lastCalibration;
+    }
+    result.spinNs = spinFor(overshootEstimate.load(std::memory_order_relaxed));
+    result.counterHz = cycleCounterHz();
+    return result;
+}
+
+void preciseSleepUntilNs(int64_t deadlineNs) {
+    const int64_t tail = spinFor(overshootEstimate.load(std::memory_order_relaxed));
+
+    int64_t now = monotonicNowNs();
+    if (deadlineNs - now > tail) {
+        const int64_t wakeNs = deadlineNs - tail;
+        sleepUntilNs(wakeNs);
+        now = monotonicNowNs();
+        recordOvershoot(now - wakeNs);
+    }
+    if (now >= deadlineNs) {
+        return;
+    }
+
+    // One clock read converts the remainder into counter ticks; then only the counter is polled
+    static const uint64_t hz = cycleCounterHz();
+    const uint64_t ticks = static_cast<uint64_t>(deadlineNs - now) * hz / 1000000000ull;
+    const uint64_t end = readCycleCounter() + ticks;
+    while (readCycleCounter() < end) {
+        cpuRelax();
+    }
+}
+
+void preciseSleepUntil(const timespec& deadline) {
+    preciseSleepUntilNs(static_cast<int64_t>(deadline.tv_sec) * 1000000000LL + deadline.tv_nsec);
+}
+
+void preciseDelayNs(uint64_t ns) {
+    if (ns == 0) {
+        return;
+    }
+    preciseSleepUntilNs(monotonicNowNs() + static_cast<int64_t>(ns));
+}
+
+} // namespace pipinpp
@@ -0,0 +1,217 @@
+/**
+ * @file pulse_capture.cpp
+ * @brief Implementation of edge-timestamp pulse measurement
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pulse_capture.hpp"
+#include "exceptions.hpp"
+#include "pin.hpp"
+#include <chrono>
+#include <time.h>
+
+namespace pipinpp {
+
+namespace {
+
+uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+// ============================================================================
+// PulseTracker Implementation
+// ============================================================================
+
+bool PulseTracker::onEdge(bool rising, uint64_t timestampNs, Pulse& pulse) {
+    bool complete = haveEdge_ && rising != level_ && timestampNs >= lastNs_;
+    if (complete) {
+        pulse.level = level_;
+        pulse.startNs = lastNs_;
+        pulse.widthNs = timestampNs - lastNs_;
+    }
+    haveEdge_ = true;
+    level_ = rising;
+    lastNs_ = timestampNs;
+    return complete;
+}
+
+// ============================================================================
+// PulseCapture Implementation
+// ============================================================================
+
+PulseCapture::PulseCapture(int pin, size_t capacity, const std::string& chipname)
+    : pin_(pin), head_(0), count_(0), dropped_(0) {
+    if (capacity == 0) {
+        throw InvalidPinError(pin, "PulseCapture capacity must be at least 1");
+    }
+    queue_.resize(capacity);
+    
+    InterruptManager::getInstance().attachInterruptBatch(
+        pin, [this](EdgeEventSpan events) { onEdges(events); }, InterruptMode::CHANGE,
+        DEFAULT_EVENT_BUFFER_SIZE, chipname);
+}
+
+PulseCapture::~PulseCapture() {
+    InterruptManager::getInstance().detachInterrupt(pin_);
+}
+
+void PulseCapture::onEdges(EdgeEventSpan events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t before = count_;
+    
+    for (const EdgeEvent& event : events) {
+        Pulse pulse;
+        if (!tracker_.onEdge(event.type == EdgeType::RISING, event.timestampNs, pulse)) {
+            continue;
+        }
+        if (count_ == queue_.size()) {
+            head_ = (head_ + 1) % queue_.size();
+            --count_;
+            ++dropped_;
+        }
+        queue_[(head_ + count_) % queue_.size()] = pulse;
+        ++count_;
+    }
+    
+    if (count_ != before || count_ == queue_.size()) {
+        cv_.notify_all();
+    }
+}
+
+bool PulseCapture::waitPulse(bool level, unsigned long timeoutUs, Pulse& pulse) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeoutUs);
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    while (true) {
+        while (count_ > 0) {
+            Pulse next = queue_[head_];
+            head_ = (head_ + 1) % queue_.size();
+            --count_;
+            if (next.level == level) {
+                pulse = next;
+                return true;
+            }
+        }
+        if (cv_.wait_until(lock, deadline) == std::cv_status::timeout && count_ == 0) {
+            return false;
+        }
+    }
+}
+
+unsigned long PulseCapture::pulseIn(bool level, unsigned long timeoutUs) {
+    uint64_t calledNs = monotonicNs();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeoutUs);
+    
+    Pulse pulse;
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return 0;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+        if (!waitPulse(level, static_cast<unsigned long>(remaining.count()), pulse)) {
+            return 0;
+        }
+        if (pulse.startNs >= calledNs) {
+            return static_cast<unsigned long>(pulse.widthNs / 1000);
+        }
+    }
+}
+
+bool PulseCapture::read(Pulse& pulse) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ == 0) {
+        return false;
+    }
+    pulse = queue_[head_];
+    head_ = (head_ + 1) % queue_.size();
+    --count_;
+    return true;
+}
+
+size_t PulseCapture::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+void PulseCapture::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    head_ = 0;
+    count_ = 0;
+}
+
+uint64_t PulseCapture::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+// ============================================================================
+// measurePulse Implementation
+// ============================================================================
+
+long measurePulse(Pin& pin, bool level, unsigned long timeoutUs) {
+    if (!pin.enableEdgeEvents()) {
+        return -1;
+    }
+    
+    // Kernel timestamps are CLOCK_MONOTONIC: anything queued before now is stale
+    uint64_t calledNs = monotonicNs();
+    uint64_t deadlineNs = calledNs + static_cast<uint64_t>(timeoutUs) * 1000;
+    bool started = false;
+    uint64_t startNs = 0;
+    PinEdgeEvent events[16];
+    
+    while (true) {
+        uint64_t now = monotonicNs();
+        if (now >= deadlineNs) {
+            return 0;
+        }
+        
+        int count = pin.waitEdgeEvents(events, 16, static_cast<int64_t>(deadlineNs - now));
+        if (count < 0) {
+            return -1;
+        }
+        for (int i = 0; i < count; ++i) {
+            const PinEdgeEvent& event = events[i];
+            if (event.timestampNs < calledNs) {
+                continue;
+            }
+            if (event.rising == level) {
+                started = true;                 // Edge into the requested level (latest wins if one was lost)
+                startNs = event.timestampNs;
+            } else if (started) {
+                if (event.timestampNs > deadlineNs) {
+                    return 0;                   // Ended after the timeout
+                }
+                return static_cast<long>((event.timestampNs - startNs) / 1000);
+            }
+        }
+    }
+}
+
+} // namespace pipinpp
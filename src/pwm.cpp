@@ -27,19 +27,58 @@
 
 #include "pwm.hpp"
 #include "exceptions.hpp"
+#include "board.hpp"
 #include "log.hpp"
+#include "thread_policy.hpp"
+#include "transaction.hpp"
+#include "pwm_timing.hpp"
 #include <algorithm>
 
 // PWMChannel destructor
 PWMChannel::~PWMChannel() {
+    stop();
+}
+
+void PWMChannel::stop() {
     active = false;
     if (pwmThread.joinable()) {
         pwmThread.join();
     }
-    // Set pin LOW before releasing
+    // Set pin LOW before releasing, even inside a Transaction
     if (pinObj) {
-        pinObj->write(false);
+        {
+            pipinpp::ScopedTransactionBypass direct;
+            pinObj->write(false);
+        }
+        pinObj.reset();
+    }
+}
+
+// PWMChannelHandle implementation
+
+bool PWMChannelHandle::setDutyCycle(int dutyCycle) {
+    if (!isActive()) {
+        return false;
     }
+    channel_->dutyCycle.store(std::clamp(dutyCycle, 0, 255), std::memory_order_relaxed);
+    return true;
+}
+
+bool PWMChannelHandle::setFrequency(int frequency) {
+    if (!isActive()) {
+        return false;
+    }
+    channel_->frequency.store(std::clamp(frequency, MIN_PWM_FREQUENCY, MAX_PWM_FREQUENCY),
+                              std::memory_order_relaxed);
+    return true;
+}
+
+int PWMChannelHandle::getDutyCycle() const {
+    return isActive() ? channel_->dutyCycle.load(std::memory_order_relaxed) : -1;
+}
+
+int PWMChannelHandle::getFrequency() const {
+    return isActive() ? channel_->frequency.load(std::memory_order_relaxed) : -1;
 }
 
 // PWMManager implementation
@@ -56,14 +95,17 @@ PWMManager::PWMManager() {
 PWMManager::~PWMManager() {
     PIPINPP_LOG_DEBUG("PWMManager shutting down");
     
-    // Stop all PWM channels
+    // Stop all PWM channels (handles may still hold their state)
     std::lock_guard<std::mutex> lock(mutex_);
-    channels_.clear(); // Destructors will stop threads
+    for (auto& entry : channels_) {
+        entry.second->stop();
+    }
+    channels_.clear();
 }
 
 void PWMManager::startPWM(int pin, int dutyCycle, int frequency) {
     // Validate pin number
-    if (pin < 0 || pin > 27) {
+    if (!pipinpp::isValidGpioPin(pin)) {
         throw InvalidPinError("Invalid pin number: " + std::to_string(pin) + 
                             " (must be 0-27 for Raspberry Pi)");
     }
@@ -84,7 +126,7 @@ void PWMManager::startPWM(int pin, int dutyCycle, int frequency) {
     }
     
     // Create new PWM channel
-    auto channel = std::make_unique<PWMChannel>(pin);
+    auto channel = std::make_shared<PWMChannel>(pin);
     channel->dutyCycle = dutyCycle;
     channel->frequency = frequency;
     
@@ -130,7 +172,8 @@ bool PWMManager::stopPWM(int pin) {
         return false; // PWM not active
     }
     
-    // Remove channel (destructor will stop thread and clean up)
+    // Stop now; handles only keep the stopped state alive
+    it->second->stop();
     channels_.erase(it);
     
     PIPINPP_LOG_INFO("Stopped PWM on pin " << pin);
@@ -165,48 +208,54 @@ int PWMManager::getFrequency(int pin) const {
     return it->second->frequency;
 }
 
+PWMChannelHandle PWMManager::channel(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = channels_.find(pin);
+    if (it == channels_.end()) {
+        return PWMChannelHandle();
+    }
+    return PWMChannelHandle(it->second);
+}
+
 void PWMManager::pwmThreadFunction(PWMChannel* channel) {
     PIPINPP_LOG_DEBUG("PWM thread started for pin " << channel->pin);
+    pipinpp::ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-pwm" + std::to_string(channel->pin));
+    
+    // Integer deadlines, recomputed only when duty or frequency change
+    pipinpp::PwmEdgeClock clock;
+    pipinpp::PwmTiming timing;
+    int lastDuty = -1;
+    int lastFreq = -1;
     
     while (channel->active) {
-        int duty = channel->dutyCycle;
-        int freq = channel->frequency;
-        
-        // Calculate period and timing
-        double periodUs = 1000000.0 / freq; // Period in microseconds
-        double onTimeUs = (periodUs * duty) / 255.0;
+        int duty = channel->dutyCycle.load(std::memory_order_relaxed);
+        int freq = channel->frequency.load(std::memory_order_relaxed);
+        if (duty != lastDuty || freq != lastFreq) {
+            timing = pipinpp::PwmTiming::fromDuty8Bit(freq, duty);
+            lastDuty = duty;
+            lastFreq = freq;
+        }
         
         // Handle edge cases
-        if (duty == 0) {
-            // Always off
-            channel->pinObj->write(false);
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            continue;
-        } else if (duty == 255) {
-            // Always on
-            channel->pinObj->write(true);
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (timing.alwaysLow() || timing.alwaysHigh()) {
+            // Constant level, re-checked every 10 ms
+            channel->pinObj->write(timing.alwaysHigh());
+            const int64_t pollNs = 10000000;
+            clock.waitUntil(pollNs, channel->active);
+            clock.nextCycle(pollNs);
             continue;
         }
         
-        // Generate PWM pulse
-        auto cycleStart = std::chrono::high_resolution_clock::now();
-        
         // HIGH period
         channel->pinObj->write(true);
-        auto onTarget = cycleStart + std::chrono::nanoseconds(static_cast<long>(onTimeUs * 1000));
-        while (std::chrono::high_resolution_clock::now() < onTarget && channel->active) {
-            // Busy-wait for precision (necessary for software PWM)
-            std::this_thread::yield();
+        if (!clock.waitUntil(timing.onNs, channel->active)) {
+            break;
         }
         
-        // LOW period
+        // LOW period until the next absolute cycle start
         channel->pinObj->write(false);
-        auto offTarget = cycleStart + std::chrono::nanoseconds(static_cast<long>(periodUs * 1000));
-        while (std::chrono::high_resolution_clock::now() < offTarget && channel->active) {
-            // Busy-wait for precision
-            std::this_thread::yield();
-        }
+        clock.waitUntil(timing.periodNs, channel->active);
+        clock.nextCycle(timing.periodNs);
     }
     
     // Ensure pin is LOW when stopping
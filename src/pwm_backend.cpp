@@ -0,0 +1,304 @@
+/**
+ * @file pwm_backend.cpp
+ * @brief Implementation of per-pin PWM backend selection
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pwm_backend.hpp"
+#include "HardwarePWM.hpp"
+#include "dma_soft_pwm.hpp"
+#include "event_pwm.hpp"
+#include "exceptions.hpp"
+#include "board.hpp"
+#include "log.hpp"
+#include "platform.hpp"
+#include "pwm.hpp"
+#include <algorithm>
+#include <string>
+
+namespace pipinpp {
+
+namespace {
+
+/// Frequency range EventPWMManager produces without clamping
+constexpr int EVENT_MIN_FREQUENCY = 50;
+constexpr int EVENT_MAX_FREQUENCY = 10000;
+
+int effectiveFrequency(int frequencyHz) {
+    return frequencyHz > 0 ? frequencyHz : DEFAULT_PWM_FREQUENCY;
+}
+
+bool eventSupports(int frequencyHz) {
+    const int hz = effectiveFrequency(frequencyHz);
+    return hz >= EVENT_MIN_FREQUENCY && hz <= EVENT_MAX_FREQUENCY;
+}
+
+/// DMA runs every pin at its own cycle; only callers that accept it qualify
+bool dmaSupports(int frequencyHz) {
+    DmaSoftPWM& dma = DmaSoftPWM::getInstance();
+    if (!dma.isBegun()) {
+        return false;
+    }
+    const uint32_t cycleUs = dma.getCycleUs();
+    return frequencyHz == 0 || (cycleUs != 0 && 1000000u / cycleUs == static_cast<uint32_t>(frequencyHz));
+}
+
+} // namespace
+
+const char* pwmBackendName(PwmBackend backend) {
+    switch (backend) {
+        case PwmBackend::HARDWARE: return "hardware";
+        case PwmBackend::DMA:      return "dma";
+        case PwmBackend::EVENT:    return "event";
+        case PwmBackend::SOFTWARE: return "software";
+        case PwmBackend::AUTO:     break;
+    }
+    return "auto";
+}
+
+// ============================================================================
+// PwmRouter Implementation
+// ============================================================================
+
+PwmRouter& PwmRouter::getInstance() {
+    static PwmRouter instance;
+    return instance;
+}
+
+PwmRouter::PwmRouter() : preferred_(PwmBackend::AUTO) {
+}
+
+PwmRouter::~PwmRouter() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : routes_) {
+        // Other backends are singletons that clean up after themselves
+        if (entry.second.hardware) {
+            entry.second.hardware->end();
+        }
+    }
+}
+
+void PwmRouter::setPreferredBackend(PwmBackend backend) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    preferred_ = backend;
+}
+
+PwmBackend PwmRouter::getPreferredBackend() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return preferred_;
+}
+
+PwmBackend PwmRouter::select(int pin, int frequencyHz) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return selectLocked(pin, frequencyHz);
+}
+
+int PwmRouter::freeHardwareChannel(int pin) const {
+    if (!BUILD_BOARD.isHardwarePwm(pin)) {
+        return -1;                               // No PWM function on this pin: skip sysfs
+    }
+    for (const PWMChannelInfo& info : PlatformInfo::instance().getPWMChannels()) {
+        if (info.gpioPin != pin || !info.available) {
+            continue;
+        }
+        const int key = info.chip * 256 + info.channel;
+        const bool taken = std::any_of(routes_.begin(), routes_.end(), [pin, key](const auto& entry) {
+            return entry.first != pin && entry.second.hardwareChannel == key;
+        });
+        if (!taken) {
+            return key;
+        }
+    }
+    return -1;
+}
+
+PwmBackend PwmRouter::selectLocked(int pin, int frequencyHz) const {
+    switch (preferred_) {
+        case PwmBackend::HARDWARE:
+            if (freeHardwareChannel(pin) >= 0) {
+                return PwmBackend::HARDWARE;
+            }
+            break;
+        case PwmBackend::DMA:
+            if (dmaSupports(frequencyHz)) {
+                return PwmBackend::DMA;
+            }
+            break;
+        case PwmBackend::EVENT:
+            if (eventSupports(frequencyHz)) {
+                return PwmBackend::EVENT;
+            }
+            break;
+        case PwmBackend::SOFTWARE:
+            return PwmBackend::SOFTWARE;
+        case PwmBackend::AUTO:
+            break;
+    }
+
+    if (freeHardwareChannel(pin) >= 0) {
+        return PwmBackend::HARDWARE;
+    }
+    if (dmaSupports(frequencyHz)) {
+        return PwmBackend::DMA;
+    }
+    if (eventSupports(frequencyHz)) {
+        return PwmBackend::EVENT;
+    }
+    return PwmBackend::SOFTWARE;
+}
+
+PwmBackend PwmRouter::write(int pin, int value, int frequencyHz) {
+    if (!isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) +
+                              " (must be 0-27 for Raspberry Pi)");
+    }
+    value = std::clamp(value, 0, 255);
+    frequencyHz = std::max(frequencyHz, 0);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = routes_.find(pin);
+    if (it != routes_.end()) {
+        Route& route = it->second;
+        if (route.frequencyHz == frequencyHz) {
+            // Same frequency: only the duty cycle changes, on the same backend
+            bool updated = false;
+            switch (route.backend) {
+                case PwmBackend::HARDWARE:
+                    updated = route.hardware->setDutyCycle8Bit(static_cast<uint8_t>(value));
+                    break;
+                case PwmBackend::DMA:
+                    updated = DmaSoftPWM::getInstance().analogWrite(pin, value);
+                    break;
+                case PwmBackend::EVENT:
+                    EventPWMManager::getInstance().analogWriteEvent(pin, value, effectiveFrequency(frequencyHz));
+                    updated = EventPWMManager::getInstance().isActive(pin);
+                    break;
+                case PwmBackend::SOFTWARE:
+                    updated = PWMManager::getInstance().setDutyCycle(pin, value);
+                    break;
+                case PwmBackend::AUTO:
+                    break;
+            }
+            if (updated) {
+                return route.backend;
+            }
+        }
+        stopRoute(route, pin);
+        routes_.erase(it);
+    }
+
+    Route route{PwmBackend::AUTO, frequencyHz, -1, nullptr};
+    PwmBackend backend = selectLocked(pin, frequencyHz);
+    route.backend = backend;
+    if (!start(route, pin, value, frequencyHz)) {
+        // Hardware or DMA refused the pin: fall back to the timer-thread backends
+        backend = eventSupports(frequencyHz) ? PwmBackend::EVENT : PwmBackend::SOFTWARE;
+        PIPINPP_LOG_WARNING("PWM backend " << pwmBackendName(route.backend) << " unavailable for pin "
+                            << pin << ", using " << pwmBackendName(backend));
+        route = Route{backend, frequencyHz, -1, nullptr};
+        if (!start(route, pin, value, frequencyHz)) {
+            throw GpioAccessError("GPIO " + std::to_string(pin), "no PWM backend could drive the pin");
+        }
+    }
+    routes_.emplace(pin, std::move(route));
+    PIPINPP_LOG_INFO("PWM on pin " << pin << " routed to " << pwmBackendName(backend));
+    return backend;
+}
+
+bool PwmRouter::start(Route& route, int pin, int value, int frequencyHz) {
+    const int hz = effectiveFrequency(frequencyHz);
+    switch (route.backend) {
+        case PwmBackend::HARDWARE: {
+            const int key = freeHardwareChannel(pin);
+            if (key < 0) {
+                return false;
+            }
+            auto hardware = std::make_unique<HardwarePWM>(key / 256, key % 256);
+            if (!hardware->begin(static_cast<uint32_t>(hz), value * 100.0 / 255.0)) {
+                return false;
+            }
+            route.hardwareChannel = key;
+            route.hardware = std::move(hardware);
+            return true;
+        }
+        case PwmBackend::DMA:
+            return DmaSoftPWM::getInstance().analogWrite(pin, value);
+        case PwmBackend::EVENT:
+            EventPWMManager::getInstance().analogWriteEvent(pin, value, hz);
+            return EventPWMManager::getInstance().isActive(pin);
+        case PwmBackend::SOFTWARE:
+            // Throws GpioAccessError itself when the line cannot be requested
+            PWMManager::getInstance().startPWM(pin, value, hz);
+            return true;
+        case PwmBackend::AUTO:
+            break;
+    }
+    return false;
+}
+
+void PwmRouter::stopRoute(Route& route, int pin) {
+    switch (route.backend) {
+        case PwmBackend::HARDWARE:
+            route.hardware->end();
+            route.hardware.reset();
+            break;
+        case PwmBackend::DMA:
+            DmaSoftPWM::getInstance().stopPWM(pin);
+            break;
+        case PwmBackend::EVENT:
+            EventPWMManager::getInstance().stopPWM(pin);
+            break;
+        case PwmBackend::SOFTWARE:
+            PWMManager::getInstance().stopPWM(pin);
+            break;
+        case PwmBackend::AUTO:
+            break;
+    }
+}
+
+bool PwmRouter::stop(int pin) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = routes_.find(pin);
+    if (it == routes_.end()) {
+        // Started directly on PWMManager (e.g. by older code)
+        return PWMManager::getInstance().stopPWM(pin);
+    }
+    stopRoute(it->second, pin);
+    routes_.erase(it);
+    return true;
+}
+
+PwmBackend PwmRouter::getBackend(int pin) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = routes_.find(pin);
+    return it == routes_.end() ? PwmBackend::AUTO : it->second.backend;
+}
+
+size_t PwmRouter::getActiveCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return routes_.size();
+}
+
+} // namespace pipinpp
@@ -0,0 +1,102 @@
+/**
+ * @file pwm_timing.cpp
+ * @brief Implementation of integer nanosecond PWM edge scheduling
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pwm_timing.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <thread>
+
+namespace pipinpp {
+
+// PwmTiming Implementation
+
+PwmTiming PwmTiming::fromDuty8Bit(int frequencyHz, int duty) {
+    PwmTiming timing;
+    timing.periodNs = 1000000000LL / std::max(frequencyHz, 1);
+    timing.onNs = (timing.periodNs * std::clamp(duty, 0, 255)) / 255;
+    return timing;
+}
+
+PwmTiming PwmTiming::fromPercent(double frequencyHz, double dutyPercent) {
+    PwmTiming timing;
+    timing.periodNs = std::llround(1e9 / std::max(frequencyHz, 1e-3));
+    timing.onNs = std::llround(timing.periodNs * std::clamp(dutyPercent, 0.0, 100.0) / 100.0);
+    return timing;
+}
+
+// PwmEdgeClock Implementation
+
+PwmEdgeClock::PwmEdgeClock(int64_t spinNs)
+    : cycleStart_(), spinNs_(std::max<int64_t>(spinNs, 0)) {
+    restart();
+}
+
+int64_t PwmEdgeClock::nowNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return toNs(now);
+}
+
+void PwmEdgeClock::restart() {
+    clock_gettime(CLOCK_MONOTONIC, &cycleStart_);
+}
+
+bool PwmEdgeClock::waitUntil(int64_t offsetNs, const std::atomic<bool>& active) const {
+    const int64_t target = toNs(cycleStart_) + offsetNs;
+    const int64_t sleepTarget = target - spinNs_;
+
+    // 1. Absolute sleeps in bounded slices; no drift, and stop is seen promptly
+    int64_t now = nowNs();
+    while (now < sleepTarget && active) {
+        timespec wake = fromNs(std::min(sleepTarget, now + PWM_MAX_SLEEP_SLICE_NS));
+        int rc;
+        do {
+            rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr);
+        } while (rc == EINTR);
+        now = nowNs();
+    }
+
+    // 2. Busy-wait the tail for precision
+    while (now < target && active) {
+        std::this_thread::yield();
+        now = nowNs();
+    }
+
+    return active;
+}
+
+void PwmEdgeClock::nextCycle(int64_t periodNs) {
+    int64_t next = toNs(cycleStart_) + periodNs;
+    int64_t now = nowNs();
+    if (now - next >= periodNs) {
+        next = now; // More than a period behind: resynchronize
+    }
+    cycleStart_ = fromNs(next);
+}
+
+} // namespace pipinpp
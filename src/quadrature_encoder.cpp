@@ -0,0 +1,392 @@
+/**
+ * @file quadrature_encoder.cpp
+ * @brief Implementation of the two-line quadrature encoder decoder
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "quadrature_encoder.hpp"
+#include "chip_registry.hpp"
+#include "exceptions.hpp"
+#include "board.hpp"
+#include "log.hpp"
+#include "pio.hpp"
+#include "thread_policy.hpp"
+#include <gpiod.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <time.h>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr size_t MAX_ENCODER_EVENTS = 1024;
+
+constexpr int BAD = QUADRATURE_INVALID_TRANSITION;
+
+// Indexed by (from << 2) | to, state = (A << 1) | B; A leading B counts up:
+// 00 -> 10 -> 11 -> 01 -> 00
+constexpr int TRANSITION_TABLE[16] = {
+//  to: 00   01   10   11
+         0,  -1,  +1, BAD,   // from 00
+        +1,   0, BAD,  -1,   // from 01
+        -1, BAD,   0,  +1,   // from 10
+       BAD,  +1,  -1,   0    // from 11
+};
+
+uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void checkEncoderPin(int pin) {
+    if (!isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) +
+                            " (must be 0-27 for Raspberry Pi)");
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// QuadratureDecoder Implementation
+// ============================================================================
+
+QuadratureDecoder::QuadratureDecoder(int pinA, int pinB, uint64_t velocityWindowNs)
+    : pinA_(pinA), pinB_(pinB), windowNs_(velocityWindowNs) {}
+
+int QuadratureDecoder::transition(uint8_t from, uint8_t to) {
+    return TRANSITION_TABLE[((from & 0x3) << 2) | (to & 0x3)];
+}
+
+int QuadratureDecoder::onEdge(const EdgeEvent& event) {
+    uint8_t bit;
+    if (event.pin == pinA_) {
+        bit = 0x2;
+    } else if (event.pin == pinB_) {
+        bit = 0x1;
+    } else {
+        return 0;
+    }
+    
+    // Both lines share one request, so the global sequence number covers them
+    if (haveSeqno_ && event.globalSeqno > lastSeqno_ + 1) {
+        missed_ += event.globalSeqno - lastSeqno_ - 1;
+    }
+    haveSeqno_ = true;
+    lastSeqno_ = event.globalSeqno;
+    
+    uint8_t next = event.type == EdgeType::RISING ? (state_ | bit) : (state_ & ~bit);
+    int step = transition(state_, next);
+    state_ = next;
+    if (step == 0 || step == QUADRATURE_INVALID_TRANSITION) {
+        // An edge that changes nothing: the opposite edge on this line was lost
+        ++invalid_;
+        return 0;
+    }
+    
+    onSteps(step, event.timestampNs);
+    return step;
+}
+
+void QuadratureDecoder::onSteps(int64_t steps, uint64_t ts) {
+    if (steps == 0) {
+        return;
+    }
+    position_ += steps;
+    if (!haveStep_) {
+        haveStep_ = true;
+        windowStartNs_ = ts;
+        windowStartPosition_ = position_;
+    } else if (ts >= windowStartNs_ + windowNs_ && ts > windowStartNs_) {
+        velocity_ = static_cast<double>(position_ - windowStartPosition_) * 1e9 /
+                    static_cast<double>(ts - windowStartNs_);
+        windowStartNs_ = ts;
+        windowStartPosition_ = position_;
+    }
+    lastStepNs_ = ts;
+}
+
+void QuadratureDecoder::setPosition(int64_t position) {
+    windowStartPosition_ += position - position_;
+    position_ = position;
+}
+
+void QuadratureDecoder::reset() {
+    position_ = 0;
+    invalid_ = 0;
+    missed_ = 0;
+    haveSeqno_ = false;
+    haveStep_ = false;
+    lastStepNs_ = 0;
+    windowStartNs_ = 0;
+    windowStartPosition_ = 0;
+    velocity_ = 0.0;
+}
+
+double QuadratureDecoder::velocity(uint64_t nowNs) const {
+    return haveStep_ ? decayVelocity(velocity_, lastStepNs_, nowNs, windowNs_) : 0.0;
+}
+
+double QuadratureDecoder::decayVelocity(double velocity, uint64_t lastStepNs, uint64_t nowNs, uint64_t windowNs) {
+    if (nowNs <= lastStepNs || nowNs - lastStepNs <= windowNs) {
+        return velocity;
+    }
+    double bound = 1e9 / static_cast<double>(nowNs - lastStepNs);
+    return std::fabs(velocity) > bound ? std::copysign(bound, velocity) : velocity;
+}
+
+// ============================================================================
+// QuadratureEncoder Implementation
+// ============================================================================
+
+QuadratureEncoder::QuadratureEncoder(int pinA, int pinB, bool pullUp, size_t bufferSize,
+                                     const std::string& chipname)
+    : pinA_(pinA), pinB_(pinB), request_(nullptr), eventBuffer_(nullptr), wakeupFd_(-1),
+      stopping_(false), pioSign_(1), pioCount_(0), decoder_(pinA, pinB), position_(0), velocity_(0.0), lastStepNs_(0),
+      windowNs_(QUADRATURE_DEFAULT_VELOCITY_WINDOW_NS), missed_(0), invalid_(0) {
+    checkEncoderPin(pinA);
+    checkEncoderPin(pinB);
+    if (pinA == pinB) {
+        throw InvalidPinError(pinB, "Encoder channels A and B must be different pins");
+    }
+    if (bufferSize == 0 || bufferSize > MAX_ENCODER_EVENTS) {
+        throw InvalidPinError("Event buffer size must be between 1 and 1024 (got " +
+                            std::to_string(bufferSize) + ")");
+    }
+    
+    std::string target = "GPIO pins " + std::to_string(pinA) + "/" + std::to_string(pinB);
+    if (beginPio(pullUp)) {
+        thread_ = std::thread(&QuadratureEncoder::pioLoop, this);
+        PIPINPP_LOG_INFO("Quadrature encoder on " << target << " (PIO)");
+        return;
+    }
+    chip_ = ChipRegistry::getInstance().acquire(chipname);
+    
+    // One request for both lines: a single, ordered event stream
+    gpiod_line_settings* settings = gpiod_line_settings_new();
+    gpiod_line_config* line_cfg = gpiod_line_config_new();
+    gpiod_request_config* req_cfg = gpiod_request_config_new();
+    if (settings && line_cfg && req_cfg) {
+        gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+        gpiod_line_settings_set_edge_detection(settings, GPIOD_LINE_EDGE_BOTH);
+        if (pullUp) {
+            gpiod_line_settings_set_bias(settings, GPIOD_LINE_BIAS_PULL_UP);
+        }
+        unsigned int offsets[2] = {static_cast<unsigned int>(pinA), static_cast<unsigned int>(pinB)};
+        gpiod_line_config_add_line_settings(line_cfg, offsets, 2, settings);
+        gpiod_request_config_set_consumer(req_cfg, "PiPinPP-Encoder");
+        gpiod_request_config_set_event_buffer_size(req_cfg, bufferSize);
+        request_ = chip_->requestLines(req_cfg, line_cfg);
+    }
+    if (req_cfg) gpiod_request_config_free(req_cfg);
+    if (line_cfg) gpiod_line_config_free(line_cfg);
+    if (settings) gpiod_line_settings_free(settings);
+    
+    if (!request_) {
+        chip_.reset();
+        throw GpioAccessError(target, "Failed to request encoder lines. Pins may be in use or unavailable.");
+    }
+    
+    eventBuffer_ = gpiod_edge_event_buffer_new(bufferSize);
+    wakeupFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!eventBuffer_ || wakeupFd_ == -1) {
+        if (eventBuffer_) gpiod_edge_event_buffer_free(eventBuffer_);
+        if (wakeupFd_ != -1) close(wakeupFd_);
+        gpiod_line_request_release(request_);
+        chip_.reset();
+        throw GpioAccessError(target, "Failed to set up encoder event handling");
+    }
+    
+    // Starting levels; later levels follow from the event types alone
+    gpiod_line_value values[2] = {GPIOD_LINE_VALUE_INACTIVE, GPIOD_LINE_VALUE_INACTIVE};
+    unsigned int offsets[2] = {static_cast<unsigned int>(pinA), static_cast<unsigned int>(pinB)};
+    if (gpiod_line_request_get_values_subset(request_, 2, offsets, values) == 0) {
+        decoder_.setState(static_cast<uint8_t>(((values[0] == GPIOD_LINE_VALUE_ACTIVE) << 1) |
+                                               (values[1] == GPIOD_LINE_VALUE_ACTIVE)));
+    }
+    
+    thread_ = std::thread(&QuadratureEncoder::decodeLoop, this);
+    PIPINPP_LOG_INFO("Quadrature encoder on " << target);
+}
+
+QuadratureEncoder::~QuadratureEncoder() {
+    stopping_ = true;
+    if (pio_) {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        return;
+    }
+    uint64_t one = 1;
+    ssize_t written = ::write(wakeupFd_, &one, sizeof(one));
+    (void)written;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    
+    close(wakeupFd_);
+    gpiod_edge_event_buffer_free(eventBuffer_);
+    gpiod_line_request_release(request_);
+}
+
+void QuadratureEncoder::write(int64_t position) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    decoder_.setPosition(position);
+    publishLocked();
+}
+
+void QuadratureEncoder::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    decoder_.reset();
+    publishLocked();
+}
+
+double QuadratureEncoder::getVelocity() const {
+    return QuadratureDecoder::decayVelocity(velocity_.load(std::memory_order_relaxed),
+                                            lastStepNs_.load(std::memory_order_relaxed),
+                                            monotonicNs(),
+                                            windowNs_.load(std::memory_order_relaxed));
+}
+
+void QuadratureEncoder::setVelocityWindow(uint32_t windowUs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    decoder_.setVelocityWindow(static_cast<uint64_t>(windowUs) * 1000);
+    windowNs_.store(decoder_.velocityWindow(), std::memory_order_relaxed);
+}
+
+void QuadratureEncoder::publishLocked() {
+    position_.store(decoder_.position(), std::memory_order_relaxed);
+    velocity_.store(decoder_.velocity(), std::memory_order_relaxed);
+    lastStepNs_.store(decoder_.lastStepNs(), std::memory_order_relaxed);
+    missed_.store(decoder_.missedCount(), std::memory_order_relaxed);
+    invalid_.store(decoder_.invalidCount(), std::memory_order_relaxed);
+}
+
+bool QuadratureEncoder::beginPio(bool pullUp) {
+    if (std::abs(pinA_ - pinB_) != 1 || !PioStateMachine::isSupported()) {
+        return false;
+    }
+
+    PioSmConfig config;
+    config.inBase = std::min(pinA_, pinB_);
+    config.inCount = 2;
+    config.inShiftRight = false;         // ISR = (previous << 2) | current
+    config.inputPullUp = pullUp;
+    config.fifoJoin = PioFifoJoin::RX;
+    config.enable = false;
+    std::unique_ptr<PioStateMachine> pio(new PioStateMachine());
+    if (!pio->begin(pioQuadratureProgram(), config)) {
+        PIPINPP_LOG_WARNING("Encoder PIO unavailable, using edge events");
+        return false;
+    }
+
+    // Start from the current levels, so the first sample is not counted as a step
+    pio->exec(pioIn(PioInSource::PINS, 2));
+    pio->exec(pioMov(PioMovDest::OSR, PioMovSource::ISR));
+    pio->setEnabled(true);
+
+    // The program treats the lower pin as A
+    pioSign_ = pinA_ < pinB_ ? 1 : -1;
+    pio_ = std::move(pio);
+    return true;
+}
+
+void QuadratureEncoder::pioLoop() {
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-encoder");
+
+    while (!stopping_) {
+        // The FIFO keeps the oldest counts once full: drain it, then take a fresh one
+        uint32_t count = pioCount_;
+        uint32_t word;
+        while (pio_->tryGet(word)) {
+            count = word;
+        }
+        if (pio_->get(word)) {
+            count = word;
+        }
+
+        int32_t delta = static_cast<int32_t>(count - pioCount_);
+        pioCount_ = count;
+        if (delta != 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            decoder_.onSteps(static_cast<int64_t>(delta) * pioSign_, monotonicNs());
+            publishLocked();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(QUADRATURE_PIO_POLL_US));
+    }
+}
+
+void QuadratureEncoder::decodeLoop() {
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-encoder");
+    
+    pollfd fds[2];
+    fds[0].fd = gpiod_line_request_get_fd(request_);
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeupFd_;
+    fds[1].events = POLLIN;
+    size_t capacity = gpiod_edge_event_buffer_get_capacity(eventBuffer_);
+    
+    while (!stopping_) {
+        int ready = poll(fds, 2, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PIPINPP_LOG_ERROR("Encoder poll() failed: " << strerror(errno));
+            break;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;   // Wakeup for shutdown
+        }
+        
+        int count = gpiod_line_request_read_edge_events(request_, eventBuffer_, capacity);
+        if (count <= 0) {
+            continue;
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < count; ++i) {
+            gpiod_edge_event* raw = gpiod_edge_event_buffer_get_event(eventBuffer_, static_cast<unsigned long>(i));
+            EdgeEvent event;
+            event.pin = static_cast<int>(gpiod_edge_event_get_line_offset(raw));
+            event.type = gpiod_edge_event_get_event_type(raw) == GPIOD_EDGE_EVENT_RISING_EDGE
+                       ? EdgeType::RISING : EdgeType::FALLING;
+            event.timestampNs = gpiod_edge_event_get_timestamp_ns(raw);
+            event.globalSeqno = gpiod_edge_event_get_global_seqno(raw);
+            event.lineSeqno = gpiod_edge_event_get_line_seqno(raw);
+            decoder_.onEdge(event);
+        }
+        publishLocked();
+    }
+}
+
+} // namespace pipinpp
@@ -0,0 +1,222 @@
+/**
+ * @file register_map.cpp
+ * @brief Cached I2C register image with batched dirty-range writes
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "register_map.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace pipinpp {
+
+RegisterMap::RegisterMap(uint8_t address, size_t size, WireClass& wire)
+    : wire_(wire), address_(address),
+      values_(std::min<size_t>(std::max<size_t>(size, 1), 256), 0),
+      flags_(values_.size(), 0),
+      mergeGap_(0), autoIncrementFlag_(0), transactions_(0) {
+}
+
+void RegisterMap::setVolatile(uint8_t first, size_t count, bool isVolatile) {
+    for (size_t reg = first; reg < values_.size() && reg < first + count; ++reg) {
+        if (isVolatile) {
+            flags_[reg] = static_cast<uint8_t>((flags_[reg] | VOLATILE) & ~VALID);
+        } else {
+            flags_[reg] = static_cast<uint8_t>(flags_[reg] & ~VOLATILE);
+        }
+    }
+}
+
+bool RegisterMap::isVolatile(uint8_t reg) const {
+    return reg < flags_.size() && (flags_[reg] & VOLATILE);
+}
+
+bool RegisterMap::fetch(uint8_t first, size_t count, uint8_t* buffer) {
+    ++transactions_;
+    if (wire_.readRegisters(address_, blockRegister(first, count), buffer, count) != static_cast<int>(count)) {
+        PIPINPP_LOG_DEBUG("RegisterMap 0x" << std::hex << int(address_) << ": read of register 0x"
+                          << int(first) << std::dec << " (" << count << " bytes) failed");
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t& flags = flags_[first + i];
+        if (flags & VOLATILE) {
+            continue;                       // Never cached
+        }
+        if (flags & DIRTY) {
+            buffer[i] = values_[first + i]; // Pending write is what the device will hold
+        } else {
+            values_[first + i] = buffer[i];
+            flags |= VALID;
+        }
+    }
+    return true;
+}
+
+bool RegisterMap::load(uint8_t first, size_t count) {
+    if (!inRange(first, count)) {
+        return false;
+    }
+    std::vector<uint8_t> buffer(count);
+    return fetch(first, count, buffer.data());
+}
+
+void RegisterMap::invalidate(uint8_t first, size_t count) {
+    for (size_t reg = first; reg < values_.size() && reg < first + count; ++reg) {
+        if (!(flags_[reg] & DIRTY)) {
+            flags_[reg] = static_cast<uint8_t>(flags_[reg] & ~VALID);
+        }
+    }
+}
+
+void RegisterMap::set(uint8_t reg, uint8_t value) {
+    if (reg >= values_.size()) {
+        return;
+    }
+    uint8_t& flags = flags_[reg];
+    if ((flags & VALID) && values_[reg] == value) {
+        return;                             // Unchanged (or already pending)
+    }
+    values_[reg] = value;
+    flags |= DIRTY;
+    if (!(flags & VOLATILE)) {
+        flags |= VALID;
+    }
+}
+
+void RegisterMap::set(uint8_t first, const uint8_t* data, size_t length) {
+    if (data == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < length && first + i < values_.size(); ++i) {
+        set(static_cast<uint8_t>(first + i), data[i]);
+    }
+}
+
+bool RegisterMap::update(uint8_t reg, uint8_t mask, uint8_t value) {
+    if (reg >= values_.size()) {
+        return false;
+    }
+    uint8_t current = values_[reg];
+    if (!(flags_[reg] & (VALID | DIRTY))) {
+        if (!fetch(reg, 1, &current)) {
+            return false;
+        }
+    }
+    set(reg, static_cast<uint8_t>((current & ~mask) | (value & mask)));
+    return true;
+}
+
+int RegisterMap::read(uint8_t reg) {
+    uint8_t value = 0;
+    return read(reg, &value, 1) ? value : -1;
+}
+
+bool RegisterMap::read(uint8_t first, uint8_t* buffer, size_t length) {
+    if (buffer == nullptr || !inRange(first, length)) {
+        return false;
+    }
+    bool cached = true;
+    for (size_t i = 0; i < length && cached; ++i) {
+        cached = (flags_[first + i] & (VALID | VOLATILE)) == VALID;
+    }
+    if (!cached) {
+        return fetch(first, length, buffer);
+    }
+    std::copy(values_.begin() + first, values_.begin() + first + length, buffer);
+    return true;
+}
+
+bool RegisterMap::flush() {
+    // Coalesce dirty registers into runs, bridging short cached gaps
+    std::vector<std::pair<size_t, size_t>> runs;    // first, length
+    const size_t n = values_.size();
+    size_t i = 0;
+    while (i < n) {
+        if (!(flags_[i] & DIRTY)) {
+            ++i;
+            continue;
+        }
+        size_t last = i;
+        for (;;) {
+            size_t next = last + 1;
+            while (next < n && !(flags_[next] & DIRTY)) {
+                ++next;
+            }
+            if (next >= n || next - last - 1 > mergeGap_) {
+                break;
+            }
+            bool bridgeable = true;
+            for (size_t gap = last + 1; gap < next; ++gap) {
+                bridgeable = bridgeable && (flags_[gap] & (VALID | VOLATILE)) == VALID;
+            }
+            if (!bridgeable) {
+                break;
+            }
+            last = next;
+        }
+        runs.emplace_back(i, last - i + 1);
+        i = last + 1;
+    }
+    if (runs.empty()) {
+        return true;
+    }
+
+    WireBatch batch;
+    for (const auto& run : runs) {
+        batch.writeRegisters(address_, blockRegister(static_cast<uint8_t>(run.first), run.second),
+                             &values_[run.first], run.second);
+    }
+    wire_.transfer(batch);
+    transactions_ += runs.size();
+
+    bool ok = true;
+    for (size_t r = 0; r < runs.size(); ++r) {
+        if (!batch.ok(r)) {
+            ok = false;
+            continue;
+        }
+        for (size_t reg = runs[r].first; reg < runs[r].first + runs[r].second; ++reg) {
+            flags_[reg] = static_cast<uint8_t>(flags_[reg] & ~DIRTY);
+        }
+    }
+    if (!ok) {
+        PIPINPP_LOG_WARNING("RegisterMap 0x" << std::hex << int(address_) << std::dec
+                            << ": flush failed, " << dirtyCount() << " registers still dirty");
+    }
+    return ok;
+}
+
+size_t RegisterMap::dirtyCount() const {
+    return static_cast<size_t>(std::count_if(flags_.begin(), flags_.end(),
+                                             [](uint8_t flags) { return (flags & DIRTY) != 0; }));
+}
+
+bool RegisterMap::isDirty(uint8_t reg) const {
+    return reg < flags_.size() && (flags_[reg] & DIRTY);
+}
+
+} // namespace pipinpp
@@ -0,0 +1,395 @@
+/**
+ * @file rt_audit.cpp
+ * @brief Real-time audit: allocator and mutex interposition, violation table
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "rt_audit.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+#ifdef PIPINPP_ENABLE_RT_AUDIT
+#ifndef __GLIBC__
+#error "PIPINPP_ENABLE_RT_AUDIT interposes malloc through glibc's __libc_malloc"
+#endif
+#include <cerrno>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <cstdlib>
+#endif
+
+namespace pipinpp {
+namespace rt_audit {
+
+#ifdef PIPINPP_ENABLE_RT_AUDIT
+
+namespace {
+
+// Plain initial-exec TLS: the allocator hooks read these on every call, in
+// every thread, possibly before any constructor has run
+#define PIPINPP_RT_TLS __thread __attribute__((tls_model("initial-exec")))
+PIPINPP_RT_TLS bool t_marked = false;
+PIPINPP_RT_TLS bool t_inHook = false;      ///< Recording, or inside an allowed scope
+PIPINPP_RT_TLS char t_name[16];
+
+struct Site {
+    std::atomic<uint64_t> key{0};          ///< Stack hash, 0 while free
+    std::atomic<bool> ready{false};        ///< Fields below written
+    std::atomic<uint64_t> count{0};
+    ViolationKind kind{};
+    size_t depth{0};
+    void* frames[RT_AUDIT_MAX_FRAMES]{};
+    char thread[16]{};
+};
+
+// Constant-initialized, so usable by hooks running before static constructors
+Site g_sites[RT_AUDIT_MAX_SITES];
+std::atomic<uint64_t> g_dropped{0};
+metrics::Counter* g_allocations = nullptr;
+metrics::Counter* g_locks = nullptr;
+metrics::Counter* g_lockWaits = nullptr;
+
+using MutexFn = int (*)(pthread_mutex_t*);
+std::atomic<MutexFn> g_realLock{nullptr};
+std::atomic<MutexFn> g_realTrylock{nullptr};
+
+MutexFn resolve(std::atomic<MutexFn>& slot, const char* name) {
+    MutexFn fn = slot.load(std::memory_order_acquire);
+    if (!fn) {
+        fn = reinterpret_cast<MutexFn>(dlsym(RTLD_NEXT, name));
+        slot.store(fn, std::memory_order_release);
+    }
+    return fn;
+}
+
+/**
+ * @brief Add one violation by the hook's caller (frames 0 and 1 are this and the hook)
+ */
+__attribute__((noinline)) void record(ViolationKind kind) {
+    constexpr int SKIP = 2;
+    void* frames[RT_AUDIT_MAX_FRAMES + SKIP];
+    int captured = backtrace(frames, static_cast<int>(RT_AUDIT_MAX_FRAMES + SKIP));
+    size_t depth = captured > SKIP ? static_cast<size_t>(captured - SKIP) : 0;
+
+    // FNV-1a over the kind and return addresses
+    uint64_t key = 1469598103934665603ULL ^ static_cast<uint64_t>(kind);
+    for (size_t i = 0; i < depth; ++i) {
+        key = (key ^ reinterpret_cast<uintptr_t>(frames[SKIP + i])) * 1099511628211ULL;
+    }
+    key |= 1;
+
+    metrics::Counter* total = kind == ViolationKind::ALLOCATION ? g_allocations
+                            : kind == ViolationKind::LOCK       ? g_locks
+                                                                 : g_lockWaits;
+    if (total) {
+        total->add();
+    }
+
+    for (size_t probe = 0; probe < RT_AUDIT_MAX_SITES; ++probe) {
+        Site& site = g_sites[(key + probe) % RT_AUDIT_MAX_SITES];
+        uint64_t current = site.key.load(std::memory_order_acquire);
+        if (current == 0) {
+            if (site.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                site.kind = kind;
+                site.depth = depth;
+                std::memcpy(site.frames, frames + SKIP, depth * sizeof(void*));
+                std::memcpy(site.thread, t_name, sizeof(site.thread));
+                site.ready.store(true, std::memory_order_release);
+                site.count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        if (current == key) {
+            site.count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    g_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+__attribute__((always_inline)) inline bool audited() {
+    return t_marked && !t_inHook;
+}
+
+/**
+ * @brief "name+0xoffset (module)" for one return address
+ */
+std::string symbolize(void* address) {
+    Dl_info info{};
+    if (!dladdr(address, &info) || !info.dli_fname) {
+        std::ostringstream out;
+        out << address;
+        return out.str();
+    }
+    std::ostringstream out;
+    if (info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        out << (status == 0 && demangled ? demangled : info.dli_sname)
+            << "+0x" << std::hex << (static_cast<char*>(address) - static_cast<char*>(info.dli_saddr));
+        std::free(demangled);
+    } else {
+        out << "+0x" << std::hex << (static_cast<char*>(address) - static_cast<char*>(info.dli_fbase));
+    }
+    const char* module = std::strrchr(info.dli_fname, '/');
+    out << " (" << (module ? module + 1 : info.dli_fname) << ")";
+    return out.str();
+}
+
+/**
+ * @brief Resolves the real lock functions and loads the unwinder before any thread is marked
+ */
+struct Startup {
+    Startup() {
+        t_inHook = true;
+        void* frame[1];
+        backtrace(frame, 1);               // First call dlopen()s libgcc_s
+        resolve(g_realLock, "pthread_mutex_lock");
+        resolve(g_realTrylock, "pthread_mutex_trylock");
+        g_allocations = &metrics::counter("rt_audit_allocations", "Heap allocations on real-time threads");
+        g_locks = &metrics::counter("rt_audit_locks", "Mutex locks on real-time threads");
+        g_lockWaits = &metrics::counter("rt_audit_lock_waits", "Contended mutex locks on real-time threads");
+        t_inHook = false;
+    }
+} g_startup;
+
+} // namespace
+
+bool enabled() {
+    return true;
+}
+
+void markCurrentThread(const char* name) {
+    std::strncpy(t_name, name ? name : "", sizeof(t_name) - 1);
+    t_name[sizeof(t_name) - 1] = '\0';
+    t_marked = true;
+}
+
+void unmarkCurrentThread() {
+    t_marked = false;
+}
+
+bool isCurrentThreadMarked() {
+    return t_marked;
+}
+
+std::vector<Violation> violations() {
+    std::vector<Violation> result;
+    for (const Site& site : g_sites) {
+        if (!site.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+        Violation violation;
+        violation.kind = site.kind;
+        violation.count = site.count.load(std::memory_order_relaxed);
+        violation.thread.assign(site.thread, strnlen(site.thread, sizeof(site.thread)));
+        violation.stack.assign(site.frames, site.frames + site.depth);
+        for (void* frame : violation.stack) {
+            violation.symbols.push_back(symbolize(frame));
+        }
+        result.push_back(std::move(violation));
+    }
+    std::sort(result.begin(), result.end(),
+              [](const Violation& a, const Violation& b) { return a.count > b.count; });
+    return result;
+}
+
+uint64_t droppedViolations() {
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+void reset() {
+    for (Site& site : g_sites) {
+        site.ready.store(false, std::memory_order_relaxed);
+        site.count.store(0, std::memory_order_relaxed);
+        site.key.store(0, std::memory_order_release);
+    }
+    g_dropped.store(0, std::memory_order_relaxed);
+}
+
+ScopedAllow::ScopedAllow() : wasSuspended_(t_inHook) {
+    t_inHook = true;
+}
+
+ScopedAllow::~ScopedAllow() {
+    t_inHook = wasSuspended_;
+}
+
+#else
+
+bool enabled() {
+    return false;
+}
+
+void markCurrentThread(const char*) {}
+
+void unmarkCurrentThread() {}
+
+bool isCurrentThreadMarked() {
+    return false;
+}
+
+std::vector<Violation> violations() {
+    return {};
+}
+
+uint64_t droppedViolations() {
+    return 0;
+}
+
+void reset() {}
+
+ScopedAllow::ScopedAllow() : wasSuspended_(false) {}
+
+ScopedAllow::~ScopedAllow() {}
+
+#endif // PIPINPP_ENABLE_RT_AUDIT
+
+std::string report() {
+    if (!enabled()) {
+        return "RT audit disabled (configure with -DPIPINPP_ENABLE_RT_AUDIT=ON)\n";
+    }
+    static const char* const KIND_NAMES[] = {"allocation", "mutex lock", "contended mutex lock"};
+
+    std::vector<Violation> found = violations();
+    std::ostringstream out;
+    out << "RT audit: " << found.size() << " call stack(s) violated real-time rules";
+    if (droppedViolations() > 0) {
+        out << " (+" << droppedViolations() << " not recorded, table full)";
+    }
+    out << "\n";
+    for (const Violation& violation : found) {
+        out << "\n" << KIND_NAMES[static_cast<int>(violation.kind)] << " x" << violation.count
+            << " on thread '" << violation.thread << "'\n";
+        for (size_t i = 0; i < violation.symbols.size(); ++i) {
+            out << "    #" << i << " " << violation.symbols[i] << "\n";
+        }
+    }
+    return out.str();
+}
+
+ScopedRealtime::ScopedRealtime(const char* name) : wasMarked_(isCurrentThreadMarked()) {
+    if (!wasMarked_) {
+        markCurrentThread(name);
+    }
+}
+
+ScopedRealtime::~ScopedRealtime() {
+    if (!wasMarked_) {
+        unmarkCurrentThread();
+    }
+}
+
+} // namespace rt_audit
+} // namespace pipinpp
+
+#ifdef PIPINPP_ENABLE_RT_AUDIT
+
+// Interposed C entry points. Each forwards to glibc and, on a marked
+// thread, records the call first. memalign()/valloc() are obsolete and
+// not covered.
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size) {
+    if (pipinpp::rt_audit::audited()) {
+        pipinpp::rt_audit::t_inHook = true;
+        pipinpp::rt_audit::record(pipinpp::rt_audit::ViolationKind::ALLOCATION);
+        pipinpp::rt_audit::t_inHook = false;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (pipinpp::rt_audit::audited()) {
+        pipinpp::rt_audit::t_inHook = true;
+        pipinpp::rt_audit::record(pipinpp::rt_audit::ViolationKind::ALLOCATION);
+        pipinpp::rt_audit::t_inHook = false;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    if (pipinpp::rt_audit::audited()) {
+        pipinpp::rt_audit::t_inHook = true;
+        pipinpp::rt_audit::record(pipinpp::rt_audit::ViolationKind::ALLOCATION);
+        pipinpp::rt_audit::t_inHook = false;
+    }
+    return __libc_realloc(pointer, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    if (pipinpp::rt_audit::audited()) {
+        pipinpp::rt_audit::t_inHook = true;
+        pipinpp::rt_audit::record(pipinpp::rt_audit::ViolationKind::ALLOCATION);
+        pipinpp::rt_audit::t_inHook = false;
+    }
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    if (pipinpp::rt_audit::audited()) {
+        pipinpp::rt_audit::t_inHook = true;
+        pipinpp::rt_audit::record(pipinpp::rt_audit::ViolationKind::ALLOCATION);
+        pipinpp::rt_audit::t_inHook = false;
+    }
+    void* pointer = __libc_memalign(alignment, size);
+    if (!pointer) {
+        return ENOMEM;
+    }
+    *result = pointer;
+    return 0;
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    using namespace pipinpp::rt_audit;
+    if (audited()) {
+        t_inHook = true;
+        if (resolve(g_realTrylock, "pthread_mutex_trylock")(mutex) == 0) {
+            record(ViolationKind::LOCK);
+            t_inHook = false;
+            return 0;
+        }
+        record(ViolationKind::LOCK_WAIT);
+        t_inHook = false;
+    }
+    return resolve(g_realLock, "pthread_mutex_lock")(mutex);
+}
+
+} // extern "C"
+
+#endif // PIPINPP_ENABLE_RT_AUDIT
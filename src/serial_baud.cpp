@@ -0,0 +1,133 @@
+/**
+ * @file serial_baud.cpp
+ * @brief termios2 baud rate and low-latency implementation
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "serial_baud.hpp"
+#include "log.hpp"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <asm/termbits.h>
+#include <linux/serial.h>
+
+namespace pipinpp {
+
+namespace {
+
+// FTDI's default latency timer (ms)
+constexpr int USB_SERIAL_DEFAULT_LATENCY_MS = 16;
+
+/**
+ * @brief sysfs latency_timer of the usb-serial device behind an fd, or "" if none
+ */
+std::string usbLatencyTimerPath(int fd) {
+    char link[PATH_MAX];
+    std::string fdPath = "/proc/self/fd/" + std::to_string(fd);
+    ssize_t length = ::readlink(fdPath.c_str(), link, sizeof(link) - 1);
+    if (length <= 0) {
+        return "";
+    }
+    link[length] = '\0';
+    
+    const char* name = std::strrchr(link, '/');
+    name = name ? name + 1 : link;
+    std::string path = std::string("/sys/bus/usb-serial/devices/") + name + "/latency_timer";
+    return ::access(path.c_str(), W_OK) == 0 ? path : "";
+}
+
+} // namespace
+
+bool setTermiosBaudRate(int fd, unsigned long baudRate) {
+    if (fd < 0 || baudRate == 0 || baudRate > UINT_MAX) {
+        return false;
+    }
+    
+    struct termios2 tio;
+    if (::ioctl(fd, TCGETS2, &tio) != 0) {
+        PIPINPP_LOG_ERROR("TCGETS2 failed (errno: " << errno << ")");
+        return false;
+    }
+    
+    tio.c_cflag &= ~CBAUD;
+    tio.c_cflag |= BOTHER;
+    tio.c_cflag &= ~(CBAUD << IBSHIFT);
+    tio.c_cflag |= BOTHER << IBSHIFT;
+    tio.c_ispeed = static_cast<speed_t>(baudRate);
+    tio.c_ospeed = static_cast<speed_t>(baudRate);
+    
+    if (::ioctl(fd, TCSETS2, &tio) != 0) {
+        PIPINPP_LOG_ERROR("TCSETS2 failed for " << baudRate << " baud (errno: " << errno << ")");
+        return false;
+    }
+    return true;
+}
+
+unsigned long getTermiosBaudRate(int fd) {
+    struct termios2 tio;
+    if (fd < 0 || ::ioctl(fd, TCGETS2, &tio) != 0) {
+        return 0;
+    }
+    return tio.c_ospeed;
+}
+
+bool setSerialLowLatency(int fd, bool enable) {
+    if (fd < 0) {
+        return false;
+    }
+    
+    bool changed = false;
+    struct serial_struct serial;
+    if (::ioctl(fd, TIOCGSERIAL, &serial) == 0) {
+        if (enable) {
+            serial.flags |= ASYNC_LOW_LATENCY;
+        } else {
+            serial.flags &= ~ASYNC_LOW_LATENCY;
+        }
+        changed = ::ioctl(fd, TIOCSSERIAL, &serial) == 0;
+    }
+    
+    // usb-serial drivers (FTDI) batch in the adapter; the flag alone does not help there
+    std::string path = usbLatencyTimerPath(fd);
+    if (!path.empty()) {
+        int sysfs = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (sysfs >= 0) {
+            std::string value = std::to_string(enable ? 1 : USB_SERIAL_DEFAULT_LATENCY_MS);
+            changed = ::write(sysfs, value.c_str(), value.size()) == static_cast<ssize_t>(value.size()) || changed;
+            ::close(sysfs);
+        }
+    }
+    
+    if (!changed) {
+        PIPINPP_LOG_DEBUG("Low-latency mode not supported on fd " << fd);
+    }
+    return changed;
+}
+
+} // namespace pipinpp
@@ -0,0 +1,342 @@
+/**
+ * @file serial_framing.cpp
+ * @brief COBS/SLIP framing and CRC implementation
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "serial_framing.hpp"
+#include <cstring>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint8_t SLIP_END = 0xC0;
+constexpr uint8_t SLIP_ESC = 0xDB;
+constexpr uint8_t SLIP_ESC_END = 0xDC;
+constexpr uint8_t SLIP_ESC_ESC = 0xDD;
+
+/**
+ * @brief Byte-at-a-time CRC lookup tables, built at compile time
+ */
+struct CrcTables {
+    uint16_t crc16[256];
+    uint32_t crc32[256];
+
+    constexpr CrcTables() : crc16(), crc32() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint16_t c16 = static_cast<uint16_t>(i << 8);
+            uint32_t c32 = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c16 = static_cast<uint16_t>((c16 & 0x8000) ? (c16 << 1) ^ 0x1021 : c16 << 1);
+                c32 = (c32 & 1) ? (c32 >> 1) ^ 0xEDB88320u : c32 >> 1;
+            }
+            crc16[i] = c16;
+            crc32[i] = c32;
+        }
+    }
+};
+
+constexpr CrcTables TABLES;
+
+/**
+ * @brief CRC of a payload as its little-endian trailer bytes
+ */
+size_t crcTrailer(FrameCrc crc, const uint8_t* data, size_t length, uint8_t* trailer) {
+    uint32_t value = 0;
+    if (crc == FrameCrc::CRC16) {
+        value = crc16Ccitt(data, length);
+    } else if (crc == FrameCrc::CRC32) {
+        value = crc32(data, length);
+    }
+    size_t size = frameCrcSize(crc);
+    for (size_t i = 0; i < size; ++i) {
+        trailer[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return size;
+}
+
+size_t encodeCobs(const uint8_t* payload, size_t length, const uint8_t* trailer, size_t trailerLength,
+                  uint8_t* out, size_t capacity) {
+    size_t total = length + trailerLength;
+    if (capacity < total + total / 254 + 2) {
+        return 0;
+    }
+    
+    size_t codeIndex = 0;
+    size_t written = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < total; ++i) {
+        uint8_t byte = i < length ? payload[i] : trailer[i - length];
+        if (byte != 0) {
+            out[written++] = byte;
+            ++code;
+        }
+        if (byte == 0 || code == 0xFF) {
+            out[codeIndex] = code;
+            code = 1;
+            codeIndex = written++;
+        }
+    }
+    out[codeIndex] = code;
+    out[written++] = 0;  // Delimiter
+    return written;
+}
+
+size_t encodeSlip(const uint8_t* payload, size_t length, const uint8_t* trailer, size_t trailerLength,
+                  uint8_t* out, size_t capacity) {
+    size_t total = length + trailerLength;
+    size_t written = 0;
+    
+    // Leading END flushes any line noise received before the frame
+    if (capacity < 2) {
+        return 0;
+    }
+    out[written++] = SLIP_END;
+    for (size_t i = 0; i < total; ++i) {
+        uint8_t byte = i < length ? payload[i] : trailer[i - length];
+        bool escaped = byte == SLIP_END || byte == SLIP_ESC;
+        if (written + (escaped ? 2 : 1) + 1 > capacity) {
+            return 0;
+        }
+        if (byte == SLIP_END) {
+            out[written++] = SLIP_ESC;
+            out[written++] = SLIP_ESC_END;
+        } else if (byte == SLIP_ESC) {
+            out[written++] = SLIP_ESC;
+            out[written++] = SLIP_ESC_ESC;
+        } else {
+            out[written++] = byte;
+        }
+    }
+    out[written++] = SLIP_END;
+    return written;
+}
+
+} // namespace
+
+// ============================================================================
+// CRC Implementation
+// ============================================================================
+
+uint16_t crc16Ccitt(const uint8_t* data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; ++i) {
+        crc = static_cast<uint16_t>((crc << 8) ^ TABLES.crc16[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc) {
+    crc = ~crc;
+#if defined(__ARM_FEATURE_CRC32)
+    // ARMv8 CRC32 instructions use the same (reflected IEEE) polynomial
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32d(crc, word);
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = __crc32b(crc, *data++);
+    }
+#else
+    for (size_t i = 0; i < length; ++i) {
+        crc = (crc >> 8) ^ TABLES.crc32[(crc ^ data[i]) & 0xFF];
+    }
+#endif
+    return ~crc;
+}
+
+size_t frameCrcSize(FrameCrc crc) {
+    switch (crc) {
+        case FrameCrc::CRC16: return 2;
+        case FrameCrc::CRC32: return 4;
+        default: return 0;
+    }
+}
+
+// ============================================================================
+// Encoder Implementation
+// ============================================================================
+
+size_t maxEncodedFrameSize(FrameEncoding encoding, FrameCrc crc, size_t length) {
+    size_t total = length + frameCrcSize(crc);
+    if (encoding == FrameEncoding::COBS) {
+        return total + total / 254 + 2;   // Code bytes + delimiter
+    }
+    return 2 * total + 2;                 // Every byte escaped + two ENDs
+}
+
+size_t encodeFrame(FrameEncoding encoding, FrameCrc crc,
+                   const uint8_t* payload, size_t length,
+                   uint8_t* out, size_t capacity) {
+    if ((payload == nullptr && length > 0) || out == nullptr) {
+        return 0;
+    }
+    
+    uint8_t trailer[4];
+    size_t trailerLength = crcTrailer(crc, payload, length, trailer);
+    if (encoding == FrameEncoding::COBS) {
+        return encodeCobs(payload, length, trailer, trailerLength, out, capacity);
+    }
+    return encodeSlip(payload, length, trailer, trailerLength, out, capacity);
+}
+
+// ============================================================================
+// FrameDecoder Implementation
+// ============================================================================
+
+FrameDecoder::FrameDecoder(FrameEncoding encoding, FrameCrc crc, size_t maxFrameSize)
+    : encoding_(encoding)
+    , crc_(crc)
+    , maxFrameSize_(maxFrameSize > 0 ? maxFrameSize : FRAME_DEFAULT_MAX_SIZE)
+    , buffer_(new uint8_t[maxFrameSize_])
+    , length_(0)
+    , discarding_(false)
+    , cobsCode_(0)
+    , cobsRemaining_(0)
+    , slipEscape_(false)
+    , frames_(0)
+    , crcErrors_(0)
+    , framingErrors_(0) {
+}
+
+void FrameDecoder::setCallback(FrameCallback callback) {
+    callback_ = std::move(callback);
+}
+
+void FrameDecoder::reset() {
+    length_ = 0;
+    discarding_ = false;
+    cobsCode_ = 0;
+    cobsRemaining_ = 0;
+    slipEscape_ = false;
+}
+
+FrameStats FrameDecoder::getStats() const {
+    FrameStats stats;
+    stats.frames = frames_.load();
+    stats.crcErrors = crcErrors_.load();
+    stats.framingErrors = framingErrors_.load();
+    return stats;
+}
+
+void FrameDecoder::append(uint8_t byte) {
+    if (length_ == maxFrameSize_) {
+        framingErrors_.fetch_add(1);
+        discarding_ = true;
+        return;
+    }
+    buffer_[length_++] = byte;
+}
+
+void FrameDecoder::feed(const uint8_t* data, size_t length) {
+    if (data == nullptr) {
+        return;
+    }
+    
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t byte = data[i];
+        
+        if (encoding_ == FrameEncoding::COBS) {
+            if (byte == 0) {
+                if (!discarding_ && cobsCode_ != 0) {
+                    if (cobsRemaining_ == 0) {
+                        finishFrame();
+                    } else {
+                        framingErrors_.fetch_add(1);   // Delimiter inside a block
+                    }
+                }
+                reset();
+            } else if (discarding_) {
+                continue;
+            } else if (cobsRemaining_ == 0) {
+                // Code byte: the previous block ended in an implicit zero unless it was full
+                if (cobsCode_ != 0 && cobsCode_ != 0xFF) {
+                    append(0);
+                }
+                cobsCode_ = byte;
+                cobsRemaining_ = static_cast<uint8_t>(byte - 1);
+            } else {
+                append(byte);
+                --cobsRemaining_;
+            }
+            continue;
+        }
+        
+        // SLIP
+        if (byte == SLIP_END) {
+            if (!discarding_ && slipEscape_) {
+                framingErrors_.fetch_add(1);
+            } else if (!discarding_ && length_ > 0) {
+                finishFrame();
+            }
+            reset();
+        } else if (discarding_) {
+            continue;
+        } else if (slipEscape_) {
+            slipEscape_ = false;
+            if (byte == SLIP_ESC_END) {
+                append(SLIP_END);
+            } else if (byte == SLIP_ESC_ESC) {
+                append(SLIP_ESC);
+            } else {
+                framingErrors_.fetch_add(1);
+                discarding_ = true;
+            }
+        } else if (byte == SLIP_ESC) {
+            slipEscape_ = true;
+        } else {
+            append(byte);
+        }
+    }
+}
+
+void FrameDecoder::finishFrame() {
+    size_t crcSize = frameCrcSize(crc_);
+    if (length_ < crcSize) {
+        framingErrors_.fetch_add(1);
+        return;
+    }
+    
+    size_t payloadLength = length_ - crcSize;
+    uint8_t expected[4];
+    crcTrailer(crc_, buffer_.get(), payloadLength, expected);
+    if (std::memcmp(expected, buffer_.get() + payloadLength, crcSize) != 0) {
+        crcErrors_.fetch_add(1);
+        return;
+    }
+    
+    frames_.fetch_add(1);
+    if (callback_) {
+        callback_(FrameView(buffer_.get(), payloadLength));
+    }
+}
+
+} // namespace pipinpp
@@ -0,0 +1,334 @@
+/**
+ * @file servo_controller.cpp
+ * @brief Implementation of trajectory-limited servo motion
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "servo_controller.hpp"
+#include "HardwarePWM.hpp"
+#include "board.hpp"
+#include "dma_soft_pwm.hpp"
+#include "exceptions.hpp"
+#include "log.hpp"
+#include "timebase.hpp"
+#include "timer_manager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint64_t NO_PULSE = std::numeric_limits<uint64_t>::max();
+
+/// Distance (degrees) treated as arrived, absorbing rounding in position += v * dt
+constexpr double ARRIVAL_EPSILON = 1e-6;
+
+/// Ticks a late timer may catch up in one step before motion is clipped
+constexpr int64_t MAX_CATCH_UP_TICKS = 4;
+
+double clampAngle(const ServoConfig& config, double angle) {
+    return std::clamp(angle, std::min(config.minAngle, config.maxAngle), std::max(config.minAngle, config.maxAngle));
+}
+
+void validate(const ServoConfig& config) {
+    if (!std::isfinite(config.minAngle) || !std::isfinite(config.maxAngle) || config.minAngle == config.maxAngle) {
+        throw std::invalid_argument("ServoConfig: minAngle and maxAngle must differ");
+    }
+    if (config.minPulseUs == config.maxPulseUs) {
+        throw std::invalid_argument("ServoConfig: minPulseUs and maxPulseUs must differ");
+    }
+    if (!(config.maxVelocity >= 0.0) || !(config.maxAcceleration >= 0.0)) {
+        throw std::invalid_argument("ServoConfig: limits must not be negative");
+    }
+}
+
+} // namespace
+
+ServoController& ServoController::getInstance() {
+    static ServoController instance;
+    return instance;
+}
+
+ServoController::ServoController(TimerManager* timers)
+    // Taking the singleton now makes it outlive a static controller
+    : timers_(timers ? timers : &TimerManager::getInstance()) {
+}
+
+ServoController::~ServoController() {
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = timerId_;
+        timerId_ = -1;
+    }
+    // Not under mutex_: cancel() waits for a running tick, which takes it
+    if (id >= 0) {
+        timers_->cancel(id);
+    }
+}
+
+uint64_t ServoController::angleToPulseNs(const ServoConfig& config, double angle) {
+    const double fraction = (clampAngle(config, angle) - config.minAngle) / (config.maxAngle - config.minAngle);
+    const double spanNs = (static_cast<double>(config.maxPulseUs) - config.minPulseUs) * 1000.0;
+    return static_cast<uint64_t>(std::llround(config.minPulseUs * 1000.0 + fraction * spanNs));
+}
+
+int ServoController::attach(HardwarePWM& pwm, const ServoConfig& config, double initialAngle) {
+    return attach([&pwm](uint64_t pulseNs) { return pwm.setDutyCycleNs(pulseNs); }, config, initialAngle);
+}
+
+int ServoController::attachDma(int pin, const ServoConfig& config, double initialAngle) {
+    if (!isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) +
+                              " (must be 0-27 for Raspberry Pi)");
+    }
+    DmaSoftPWM& dma = DmaSoftPWM::getInstance();
+    return attach([&dma, pin](uint64_t pulseNs) {
+        return dma.setPulseWidthUs(pin, static_cast<uint32_t>((pulseNs + 500) / 1000));
+    }, config, initialAngle);
+}
+
+int ServoController::attach(ServoOutput output, const ServoConfig& config, double initialAngle) {
+    if (!output) {
+        throw std::invalid_argument("ServoController::attach: output must not be empty");
+    }
+    validate(config);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int id = nextId_++;
+    Servo& servo = servos_[id];
+    servo.output = std::move(output);
+    servo.config = config;
+    servo.position = clampAngle(config, initialAngle);
+    servo.pulseNs = NO_PULSE;
+    if (!write(servo)) {
+        PIPINPP_LOG_WARNING("Servo " << id << ": initial pulse not written, retrying on the first move");
+    }
+    return id;
+}
+
+bool ServoController::detach(int servo) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return servos_.erase(servo) > 0;
+}
+
+bool ServoController::moveTo(int servo, double angle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = servos_.find(servo);
+    if (it == servos_.end()) {
+        return false;
+    }
+    ServoWaypoint waypoint;
+    waypoint.angle = angle;
+    it->second.path.clear();
+    it->second.dwellNs = 0;
+    it->second.path.push_back(waypoint);
+    ensureTimer();
+    return true;
+}
+
+bool ServoController::addWaypoint(int servo, const ServoWaypoint& waypoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = servos_.find(servo);
+    if (it == servos_.end()) {
+        return false;
+    }
+    it->second.path.push_back(waypoint);
+    ensureTimer();
+    return true;
+}
+
+bool ServoController::stop(int servo) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = servos_.find(servo);
+    if (it == servos_.end()) {
+        return false;
+    }
+    Servo& s = it->second;
+    s.path.clear();
+    s.dwellNs = 0;
+    const double a = s.config.maxAcceleration;
+    if (s.velocity == 0.0 || a <= 0.0) {
+        s.velocity = 0.0;
+        return true;
+    }
+    // Target the point where full deceleration brings it to rest
+    ServoWaypoint rest;
+    rest.angle = s.position + std::copysign(s.velocity * s.velocity / (2.0 * a), s.velocity);
+    s.path.push_back(rest);
+    ensureTimer();
+    return true;
+}
+
+bool ServoController::isMoving(int servo) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = servos_.find(servo);
+    return it != servos_.end() && moving(it->second);
+}
+
+double ServoController::getAngle(int servo) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = servos_.find(servo);
+    return it == servos_.end() ? 0.0 : it->second.position;
+}
+
+double ServoController::getVelocity(int servo) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = servos_.find(servo);
+    return it == servos_.end() ? 0.0 : it->second.velocity;
+}
+
+size_t ServoController::getMovingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(servos_.begin(), servos_.end(),
+                                             [](const auto& entry) { return moving(entry.second); }));
+}
+
+void ServoController::setTickUs(uint32_t tickUs) {
+    if (tickUs == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    tickUs_ = tickUs;
+    if (timerId_ >= 0) {
+        timers_->setPeriod(timerId_, tickUs);
+    }
+}
+
+bool ServoController::advance(Servo& servo, int64_t elapsedNs) {
+    if (servo.dwellNs > 0) {
+        servo.dwellNs -= elapsedNs;
+        if (servo.dwellNs > 0) {
+            return true;
+        }
+        servo.dwellNs = 0;
+    }
+    if (servo.path.empty()) {
+        return false;
+    }
+
+    const ServoWaypoint& waypoint = servo.path.front();
+    const double target = clampAngle(servo.config, waypoint.angle);
+    const double vmax = waypoint.maxVelocity > 0.0 ? waypoint.maxVelocity : servo.config.maxVelocity;
+    const double amax = waypoint.maxAcceleration > 0.0 ? waypoint.maxAcceleration : servo.config.maxAcceleration;
+    const double dt = elapsedNs * 1e-9;
+    const double distance = target - servo.position;
+    const double speedLimit = vmax > 0.0 ? vmax : std::numeric_limits<double>::infinity();
+
+    if (amax > 0.0) {
+        // Fastest speed from which amax, applied in steps of dt, still stops
+        // at the target (v^2 / 2a + v dt / 2 = distance). The trapezoid is
+        // replanned from the current state every tick.
+        const double step = amax * dt;
+        const double brake = 0.5 * (std::sqrt(step * step + 8.0 * amax * std::fabs(distance)) - step);
+        const double desired = std::copysign(std::min(speedLimit, brake), distance);
+        servo.velocity += std::clamp(desired - servo.velocity, -amax * dt, amax * dt);
+    } else {
+        servo.velocity = std::copysign(std::min(speedLimit, dt > 0.0 ? std::fabs(distance) / dt : 0.0), distance);
+    }
+
+    const double next = servo.position + servo.velocity * dt;
+    const bool arrived = std::fabs(target - next) < ARRIVAL_EPSILON || (distance > 0.0 ? next >= target : next <= target);
+    if (arrived) {
+        servo.position = target;
+        servo.velocity = 0.0;
+        servo.dwellNs = static_cast<int64_t>(waypoint.dwellMs) * 1000000;
+        servo.path.pop_front();
+    } else {
+        servo.position = next;
+    }
+    return moving(servo);
+}
+
+bool ServoController::step(int64_t elapsedNs) {
+    if (elapsedNs < 0) {
+        elapsedNs = 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool anyMoving = false;
+    for (auto& entry : servos_) {
+        Servo& servo = entry.second;
+        if (!moving(servo) && servo.pulseNs != NO_PULSE) {
+            continue;
+        }
+        anyMoving = advance(servo, elapsedNs) || anyMoving;
+        if (!write(servo)) {
+            // Stop rather than retry every tick against a dead output
+            PIPINPP_LOG_ERROR("Servo " << entry.first << ": pulse write failed, motion stopped");
+            servo.path.clear();
+            servo.dwellNs = 0;
+            servo.velocity = 0.0;
+        }
+    }
+    return anyMoving;
+}
+
+bool ServoController::write(Servo& servo) {
+    const uint64_t pulseNs = angleToPulseNs(servo.config, servo.position);
+    if (pulseNs == servo.pulseNs) {
+        return true;                             // Unchanged: no syscall, no DMA update
+    }
+    if (!servo.output(pulseNs)) {
+        return false;
+    }
+    servo.pulseNs = pulseNs;
+    return true;
+}
+
+void ServoController::ensureTimer() {
+    if (timerId_ >= 0) {
+        return;
+    }
+    lastTickNs_ = monotonicNowNs();
+    timerId_ = timers_->every(tickUs_, [this] { onTick(); });
+    if (timerId_ < 0) {
+        PIPINPP_LOG_ERROR("ServoController could not start its timer task");
+    }
+}
+
+void ServoController::onTick() {
+    const int64_t now = monotonicNowNs();
+    int64_t elapsed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        elapsed = std::min(now - lastTickNs_, MAX_CATCH_UP_TICKS * tickUs_ * 1000);
+        lastTickNs_ = now;
+    }
+    if (step(elapsed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool idle = std::none_of(servos_.begin(), servos_.end(), [](const auto& entry) { return moving(entry.second); });
+    if (idle && timerId_ >= 0) {
+        timers_->cancel(timerId_);               // From our own callback: does not wait
+        timerId_ = -1;
+    }
+}
+
+} // namespace pipinpp
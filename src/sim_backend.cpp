@@ -0,0 +1,835 @@
+/**
+ * @file sim_backend.cpp
+ * @brief Implementation of the in-memory GPIO, SPI and I2C simulation
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sim_backend.hpp"
+#include "chip_registry.hpp"
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <linux/spi/spidev.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+
+namespace pipinpp {
+
+namespace {
+
+uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+/**
+ * @brief Lines of the simulated bank; edge events queue here until read
+ *
+ * State is guarded by SimulatedHardware::mutex_. The eventfd is readable
+ * while events are queued, standing in for the kernel request fd.
+ */
+class SimLineRequest : public LineRequest {
+public:
+    SimLineRequest(SimulatedHardware& hardware, std::vector<LineSettings> settings, size_t capacity, int eventFd)
+        : hardware_(hardware), settings_(std::move(settings)), capacity_(capacity), eventFd_(eventFd) {}
+
+    ~SimLineRequest() override {
+        hardware_.release(this);
+        close(eventFd_);
+    }
+
+    SimLineRequest(const SimLineRequest&) = delete;
+    SimLineRequest& operator=(const SimLineRequest&) = delete;
+
+    int setValue(unsigned int offset, bool value) override {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        const LineSettings* line = findLocked(offset);
+        if (!line || line->direction != GPIOD_LINE_DIRECTION_OUTPUT) {
+            errno = EPERM;
+            return -1;
+        }
+        ++hardware_.lines_[offset].writes;
+        hardware_.driveLocked(offset, value, monotonicNs());
+        return 0;
+    }
+
+    int setValues(const unsigned int* offsets, const bool* values, size_t count) override {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            const LineSettings* line = findLocked(offsets[i]);
+            if (!line || line->direction != GPIOD_LINE_DIRECTION_OUTPUT) {
+                errno = EPERM;
+                return -1;
+            }
+        }
+        // One kernel call: every line changes at the same instant
+        const uint64_t now = monotonicNs();
+        for (size_t i = 0; i < count; ++i) {
+            ++hardware_.lines_[offsets[i]].writes;
+            hardware_.driveLocked(offsets[i], values[i], now);
+        }
+        return 0;
+    }
+
+    int getValue(unsigned int offset) override {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        if (!findLocked(offset)) {
+            errno = EINVAL;
+            return -1;
+        }
+        return hardware_.lines_[offset].level ? 1 : 0;
+    }
+
+    bool reconfigure(const std::vector<LineSettings>& lines) override {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        for (const LineSettings& line : lines) {
+            if (!findLocked(line.offset)) {
+                errno = EINVAL;
+                return false;
+            }
+        }
+        for (const LineSettings& line : lines) {
+            *findMutableLocked(line.offset) = line;
+            if (line.direction == GPIOD_LINE_DIRECTION_OUTPUT) {
+                hardware_.driveLocked(line.offset, line.outputValue == GPIOD_LINE_VALUE_ACTIVE, monotonicNs());
+            }
+        }
+        return true;
+    }
+
+    int fd() const override { return eventFd_; }
+
+    int waitEdgeEvents(int64_t timeoutNs) override {
+        pollfd pfd{eventFd_, POLLIN, 0};
+        timespec timeout;
+        timeout.tv_sec = static_cast<time_t>(timeoutNs / 1000000000LL);
+        timeout.tv_nsec = static_cast<long>(timeoutNs % 1000000000LL);
+        int result = ppoll(&pfd, 1, timeoutNs < 0 ? nullptr : &timeout, nullptr);
+        if (result < 0) {
+            return -1;
+        }
+        return result > 0 ? 1 : 0;
+    }
+
+    int readEdgeEvents(LineEvent* events, size_t maxEvents) override {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        size_t count = std::min(maxEvents, events_.size());
+        std::copy(events_.begin(), events_.begin() + static_cast<std::ptrdiff_t>(count), events);
+        events_.erase(events_.begin(), events_.begin() + static_cast<std::ptrdiff_t>(count));
+        if (events_.empty()) {
+            uint64_t drained;
+            ssize_t ignored = ::read(eventFd_, &drained, sizeof(drained));
+            (void)ignored;
+        }
+        return static_cast<int>(count);
+    }
+
+    /**
+     * @brief Queue an edge if this request watches @p offset for it (caller holds the lock)
+     */
+    void deliverLocked(unsigned int offset, bool rising, uint64_t timestampNs) {
+        const LineSettings* line = findLocked(offset);
+        if (!line || line->direction != GPIOD_LINE_DIRECTION_INPUT) {
+            return;
+        }
+        bool wanted = line->edge == GPIOD_LINE_EDGE_BOTH ||
+                      (rising && line->edge == GPIOD_LINE_EDGE_RISING) ||
+                      (!rising && line->edge == GPIOD_LINE_EDGE_FALLING);
+        if (!wanted) {
+            return;
+        }
+        if (events_.size() >= capacity_) {
+            events_.pop_front();    // Kernel overwrites the oldest event when full
+        }
+        events_.push_back(LineEvent{offset, rising, timestampNs, ++globalSeqno_, ++lineSeqno_[offset]});
+        if (events_.size() == 1) {
+            uint64_t one = 1;
+            ssize_t ignored = ::write(eventFd_, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+
+    void clearEventsLocked() {
+        if (!events_.empty()) {
+            events_.clear();
+            uint64_t drained;
+            ssize_t ignored = ::read(eventFd_, &drained, sizeof(drained));
+            (void)ignored;
+        }
+    }
+
+    const std::vector<LineSettings>& settingsLocked() const { return settings_; }
+
+private:
+    const LineSettings* findLocked(unsigned int offset) const {
+        for (const LineSettings& line : settings_) {
+            if (line.offset == offset) {
+                return &line;
+            }
+        }
+        return nullptr;
+    }
+
+    LineSettings* findMutableLocked(unsigned int offset) {
+        return const_cast<LineSettings*>(findLocked(offset));
+    }
+
+    SimulatedHardware& hardware_;
+    std::vector<LineSettings> settings_;
+    size_t capacity_;
+    int eventFd_;
+    std::deque<LineEvent> events_;
+    uint64_t globalSeqno_ = 0;
+    std::array<uint64_t, SIM_NUM_LINES> lineSeqno_{};
+};
+
+/**
+ * @brief Any chip name: all of them share the one simulated bank
+ */
+class SimChip : public GpioChip {
+public:
+    explicit SimChip(const std::string& name) : GpioChip(name, SIM_CHIP_LABEL, SIM_NUM_LINES) {}
+
+    std::unique_ptr<LineRequest> requestLines(const std::string& /*consumer*/,
+                                              const std::vector<LineSettings>& lines,
+                                              size_t eventBufferSize) override {
+        return SimulatedHardware::getInstance().requestLines(lines, eventBufferSize);
+    }
+};
+
+// ============================================================================
+// SPI
+// ============================================================================
+
+class SimSpiFile : public DeviceFile {
+public:
+    SimSpiFile(SimulatedHardware& hardware, int bus, int cs) : hardware_(hardware), key_(bus, cs) {}
+
+    int ioctl(unsigned long request, void* arg) override {
+        switch (request) {
+            case SPI_IOC_WR_MODE:
+                mode_ = *static_cast<uint8_t*>(arg);
+                return 0;
+            case SPI_IOC_RD_MODE:
+                *static_cast<uint8_t*>(arg) = mode_;
+                return 0;
+            case SPI_IOC_WR_BITS_PER_WORD:
+                bitsPerWord_ = *static_cast<uint8_t*>(arg);
+                return 0;
+            case SPI_IOC_RD_BITS_PER_WORD:
+                *static_cast<uint8_t*>(arg) = bitsPerWord_;
+                return 0;
+            case SPI_IOC_WR_MAX_SPEED_HZ:
+                speedHz_ = *static_cast<uint32_t*>(arg);
+                return 0;
+            case SPI_IOC_RD_MAX_SPEED_HZ:
+                *static_cast<uint32_t*>(arg) = speedHz_;
+                return 0;
+            default:
+                break;
+        }
+
+        // SPI_IOC_MESSAGE(n) encodes n in the argument size
+        if (_IOC_TYPE(request) == SPI_IOC_MAGIC && _IOC_NR(request) == 0 && _IOC_DIR(request) == _IOC_WRITE) {
+            size_t count = _IOC_SIZE(request) / sizeof(spi_ioc_transfer);
+            return transfer(static_cast<const spi_ioc_transfer*>(arg), count);
+        }
+        errno = ENOTTY;
+        return -1;
+    }
+
+    int ioctlValue(unsigned long /*request*/, unsigned long /*value*/) override {
+        errno = ENOTTY;
+        return -1;
+    }
+
+    ssize_t read(void* buffer, size_t length) override {
+        std::vector<uint8_t> tx(length, 0);
+        spi_ioc_transfer xfer{};
+        xfer.rx_buf = reinterpret_cast<uintptr_t>(buffer);
+        xfer.tx_buf = reinterpret_cast<uintptr_t>(tx.data());
+        xfer.len = static_cast<uint32_t>(length);
+        return transfer(&xfer, 1);
+    }
+
+    ssize_t write(const void* buffer, size_t length) override {
+        spi_ioc_transfer xfer{};
+        xfer.tx_buf = reinterpret_cast<uintptr_t>(buffer);
+        xfer.len = static_cast<uint32_t>(length);
+        return transfer(&xfer, 1);
+    }
+
+private:
+    int transfer(const spi_ioc_transfer* transfers, size_t count) {
+        std::shared_ptr<const SimulatedHardware::SpiHandler> handler;
+        {
+            std::lock_guard<std::mutex> lock(hardware_.mutex_);
+            auto it = hardware_.spiDevices_.find(key_);
+            if (it == hardware_.spiDevices_.end()) {
+                errno = ENODEV;
+                return -1;
+            }
+            it->second.transfers += count;
+            handler = it->second.handler;
+        }
+
+        int total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const spi_ioc_transfer& xfer = transfers[i];
+            const uint8_t* tx = reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(xfer.tx_buf));
+            uint8_t* rx = reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(xfer.rx_buf));
+            scratchTx_.assign(xfer.len, 0);
+            if (tx) {
+                std::memcpy(scratchTx_.data(), tx, xfer.len);
+            }
+            scratchRx_.assign(xfer.len, 0);
+            if (handler && *handler) {
+                (*handler)(scratchTx_.data(), scratchRx_.data(), xfer.len);
+            } else {
+                scratchRx_ = scratchTx_;
+            }
+            if (rx) {
+                std::memcpy(rx, scratchRx_.data(), xfer.len);
+            }
+            total += static_cast<int>(xfer.len);
+        }
+        return total;
+    }
+
+    SimulatedHardware& hardware_;
+    std::pair<int, int> key_;
+    uint8_t mode_ = 0;
+    uint8_t bitsPerWord_ = 8;
+    uint32_t speedHz_ = 500000;
+    std::vector<uint8_t> scratchTx_;
+    std::vector<uint8_t> scratchRx_;
+};
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+class SimI2cFile : public DeviceFile {
+public:
+    SimI2cFile(SimulatedHardware& hardware, int bus) : hardware_(hardware), bus_(bus) {}
+
+    int ioctl(unsigned long request, void* arg) override {
+        switch (request) {
+            case I2C_FUNCS:
+                *static_cast<unsigned long*>(arg) = I2C_FUNC_I2C | I2C_FUNC_SMBUS_EMUL;
+                return 0;
+            case I2C_RDWR:
+                return readWrite(*static_cast<i2c_rdwr_ioctl_data*>(arg));
+            case I2C_SMBUS:
+                return smbus(*static_cast<i2c_smbus_ioctl_data*>(arg));
+            default:
+                errno = ENOTTY;
+                return -1;
+        }
+    }
+
+    int ioctlValue(unsigned long request, unsigned long value) override {
+        switch (request) {
+            case I2C_SLAVE:
+            case I2C_SLAVE_FORCE:
+                if (value > 0x7F) {
+                    errno = EINVAL;
+                    return -1;
+                }
+                address_ = static_cast<int>(value);
+                return 0;
+            case I2C_RETRIES:
+            case I2C_TIMEOUT:
+            case I2C_TENBIT:
+            case I2C_PEC:
+                return 0;
+            default:
+                errno = ENOTTY;
+                return -1;
+        }
+    }
+
+    ssize_t read(void* buffer, size_t length) override {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        SimulatedHardware::I2cDevice* device = hardware_.findI2cLocked(bus_, address_);
+        if (!device) {
+            errno = ENXIO;
+            return -1;
+        }
+        SimulatedHardware::i2cRead(*device, static_cast<uint8_t*>(buffer), length);
+        return static_cast<ssize_t>(length);
+    }
+
+    ssize_t write(const void* buffer, size_t length) override {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        SimulatedHardware::I2cDevice* device = hardware_.findI2cLocked(bus_, address_);
+        if (!device) {
+            errno = ENXIO;
+            return -1;
+        }
+        SimulatedHardware::i2cWrite(*device, static_cast<const uint8_t*>(buffer), length);
+        return static_cast<ssize_t>(length);
+    }
+
+private:
+    int readWrite(const i2c_rdwr_ioctl_data& data) {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        for (uint32_t i = 0; i < data.nmsgs; ++i) {
+            const i2c_msg& msg = data.msgs[i];
+            SimulatedHardware::I2cDevice* device = hardware_.findI2cLocked(bus_, msg.addr);
+            if (!device) {
+                errno = ENXIO;
+                return -1;
+            }
+            if (msg.flags & I2C_M_RD) {
+                SimulatedHardware::i2cRead(*device, msg.buf, msg.len);
+            } else {
+                SimulatedHardware::i2cWrite(*device, msg.buf, msg.len);
+            }
+        }
+        return static_cast<int>(data.nmsgs);
+    }
+
+    int smbus(const i2c_smbus_ioctl_data& args) {
+        std::lock_guard<std::mutex> lock(hardware_.mutex_);
+        SimulatedHardware::I2cDevice* device = hardware_.findI2cLocked(bus_, address_);
+        if (!device) {
+            errno = ENXIO;
+            return -1;
+        }
+        const bool read = args.read_write == I2C_SMBUS_READ;
+        i2c_smbus_data* data = args.data;
+        switch (args.size) {
+            case I2C_SMBUS_QUICK:
+                return 0;
+            case I2C_SMBUS_BYTE:
+                if (read) {
+                    SimulatedHardware::i2cRead(*device, &data->byte, 1);
+                } else {
+                    device->pointer = args.command;
+                }
+                return 0;
+            case I2C_SMBUS_BYTE_DATA:
+                device->pointer = args.command;
+                if (read) {
+                    SimulatedHardware::i2cRead(*device, &data->byte, 1);
+                } else {
+                    device->registers[args.command] = data->byte;
+                    device->pointer = static_cast<uint8_t>(args.command + 1);
+                }
+                return 0;
+            case I2C_SMBUS_WORD_DATA: {
+                uint8_t bytes[2] = {static_cast<uint8_t>(data->word & 0xFF), static_cast<uint8_t>(data->word >> 8)};
+                device->pointer = args.command;
+                if (read) {
+                    SimulatedHardware::i2cRead(*device, bytes, 2);
+                    data->word = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+                } else {
+                    device->registers[args.command] = bytes[0];
+                    device->registers[static_cast<uint8_t>(args.command + 1)] = bytes[1];
+                    device->pointer = static_cast<uint8_t>(args.command + 2);
+                }
+                return 0;
+            }
+            case I2C_SMBUS_I2C_BLOCK_DATA: {
+                size_t length = std::min<size_t>(data->block[0], I2C_SMBUS_BLOCK_MAX);
+                device->pointer = args.command;
+                if (read) {
+                    SimulatedHardware::i2cRead(*device, &data->block[1], length);
+                } else {
+                    for (size_t i = 0; i < length; ++i) {
+                        device->registers[device->pointer++] = data->block[1 + i];
+                    }
+                }
+                return 0;
+            }
+            default:
+                errno = EOPNOTSUPP;
+                return -1;
+        }
+    }
+
+    SimulatedHardware& hardware_;
+    int bus_;
+    int address_ = -1;
+};
+
+// ============================================================================
+// Device provider
+// ============================================================================
+
+class SimDeviceProvider : public DeviceProvider {
+public:
+    std::unique_ptr<DeviceFile> open(const std::string& path) override {
+        SimulatedHardware& hardware = SimulatedHardware::getInstance();
+        int bus = 0;
+        int cs = 0;
+        char extra = 0;
+        std::lock_guard<std::mutex> lock(hardware.mutex_);
+        if (std::sscanf(path.c_str(), "/dev/spidev%d.%d%c", &bus, &cs, &extra) == 2 &&
+            hardware.spiDevices_.count({bus, cs})) {
+            return std::make_unique<SimSpiFile>(hardware, bus, cs);
+        }
+        if (std::sscanf(path.c_str(), "/dev/i2c-%d%c", &bus, &extra) == 1 && hardware.i2cBuses_.count(bus)) {
+            return std::make_unique<SimI2cFile>(hardware, bus);
+        }
+        errno = ENOENT;
+        return nullptr;
+    }
+
+    std::vector<std::string> list() const override {
+        SimulatedHardware& hardware = SimulatedHardware::getInstance();
+        std::lock_guard<std::mutex> lock(hardware.mutex_);
+        std::vector<std::string> paths;
+        for (const auto& entry : hardware.spiDevices_) {
+            paths.push_back("/dev/spidev" + std::to_string(entry.first.first) + "." +
+                            std::to_string(entry.first.second));
+        }
+        for (const auto& entry : hardware.i2cBuses_) {
+            paths.push_back("/dev/i2c-" + std::to_string(entry.first));
+        }
+        return paths;
+    }
+};
+
+// ============================================================================
+// SimulatedHardware
+// ============================================================================
+
+SimulatedHardware& SimulatedHardware::getInstance() {
+    // Never destroyed: line requests held by other singletons may outlive it
+    static SimulatedHardware* instance = new SimulatedHardware();
+    return *instance;
+}
+
+void SimulatedHardware::install() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        installed_ = true;
+    }
+    ChipRegistry::getInstance().setChipFactory(
+        [](const std::string& name) { return std::make_shared<SimChip>(name); });
+    setDeviceProvider(std::make_shared<SimDeviceProvider>());
+}
+
+std::shared_ptr<GpioChip> SimulatedHardware::openChip(const std::string& name) {
+    return std::make_shared<SimChip>(name);
+}
+
+void SimulatedHardware::uninstall() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        installed_ = false;
+    }
+    ChipRegistry::getInstance().setChipFactory(nullptr);
+    setDeviceProvider(nullptr);
+}
+
+bool SimulatedHardware::isInstalled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return installed_;
+}
+
+void SimulatedHardware::reset() {
+    std::map<int, std::unique_ptr<Generator>> generators;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generators.swap(generators_);
+    }
+    for (auto& entry : generators) {
+        stopGenerator(std::move(entry.second));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < SIM_NUM_LINES; ++i) {
+        Line& line = lines_[i];
+        line.level = false;
+        line.connectedTo = -1;
+        line.writes = 0;
+    }
+    for (SimLineRequest* request : requests_) {
+        request->clearEventsLocked();
+    }
+    spiDevices_.clear();
+    i2cBuses_.clear();
+}
+
+// ----------------------------------------------------------------------------
+// GPIO
+// ----------------------------------------------------------------------------
+
+std::unique_ptr<LineRequest> SimulatedHardware::requestLines(const std::vector<LineSettings>& lines,
+                                                             size_t eventBufferSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (lines[i].offset >= SIM_NUM_LINES) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        bool duplicate = std::any_of(lines.begin(), lines.begin() + static_cast<std::ptrdiff_t>(i),
+                                     [&](const LineSettings& other) { return other.offset == lines[i].offset; });
+        if (lines_[lines[i].offset].requested || duplicate) {
+            errno = EBUSY;
+            return nullptr;
+        }
+    }
+
+    int eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (eventFd < 0) {
+        return nullptr;
+    }
+    // Kernel default: 16 events per requested line
+    size_t capacity = eventBufferSize > 0 ? eventBufferSize : 16 * lines.size();
+    auto request = std::make_unique<SimLineRequest>(*this, lines, capacity, eventFd);
+    requests_.push_back(request.get());
+
+    uint64_t now = monotonicNs();
+    for (const LineSettings& line : lines) {
+        lines_[line.offset].requested = true;
+        if (line.direction == GPIOD_LINE_DIRECTION_OUTPUT) {
+            driveLocked(line.offset, line.outputValue == GPIOD_LINE_VALUE_ACTIVE, now);
+        }
+    }
+    return request;
+}
+
+void SimulatedHardware::release(SimLineRequest* request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const LineSettings& line : request->settingsLocked()) {
+        lines_[line.offset].requested = false;
+    }
+    requests_.erase(std::remove(requests_.begin(), requests_.end(), request), requests_.end());
+}
+
+void SimulatedHardware::driveLocked(unsigned int line, bool level, uint64_t timestampNs) {
+    Line& state = lines_[line];
+    if (state.level == level) {
+        return;
+    }
+    state.level = level;
+    deliverEdgeLocked(line, level, timestampNs);
+    if (state.connectedTo >= 0) {
+        driveLocked(static_cast<unsigned int>(state.connectedTo), level, timestampNs);
+    }
+}
+
+void SimulatedHardware::deliverEdgeLocked(unsigned int line, bool rising, uint64_t timestampNs) {
+    for (SimLineRequest* request : requests_) {
+        request->deliverLocked(line, rising, timestampNs);
+    }
+}
+
+void SimulatedHardware::setInput(int line, bool level) {
+    if (!validLine(line)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    driveLocked(static_cast<unsigned int>(line), level, monotonicNs());
+}
+
+int SimulatedHardware::getLevel(int line) const {
+    if (!validLine(line)) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lines_[static_cast<size_t>(line)].level ? 1 : 0;
+}
+
+uint64_t SimulatedHardware::getWriteCount(int line) const {
+    if (!validLine(line)) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lines_[static_cast<size_t>(line)].writes;
+}
+
+void SimulatedHardware::connect(int output, int input) {
+    if (!validLine(output) || !validLine(input) || output == input) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    lines_[static_cast<size_t>(output)].connectedTo = input;
+    driveLocked(static_cast<unsigned int>(input), lines_[static_cast<size_t>(output)].level, monotonicNs());
+}
+
+void SimulatedHardware::disconnect(int output) {
+    if (!validLine(output)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    lines_[static_cast<size_t>(output)].connectedTo = -1;
+}
+
+void SimulatedHardware::injectEdges(int line, size_t count, uint64_t intervalNs) {
+    if (!validLine(line) || count == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    unsigned int offset = static_cast<unsigned int>(line);
+    uint64_t last = monotonicNs();
+    uint64_t span = intervalNs * (count - 1);
+    uint64_t first = span < last ? last - span : 0;
+    for (size_t i = 0; i < count; ++i) {
+        driveLocked(offset, !lines_[offset].level, first + intervalNs * i);
+    }
+}
+
+int SimulatedHardware::startEdgeGenerator(int line, double edgesPerSecond) {
+    if (!validLine(line) || edgesPerSecond <= 0.0) {
+        return -1;
+    }
+    int64_t periodNs = std::max<int64_t>(1, static_cast<int64_t>(1e9 / edgesPerSecond));
+    auto generator = std::make_unique<Generator>();
+    Generator* raw = generator.get();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = nextGeneratorId_++;
+    generator->thread = std::thread(&SimulatedHardware::generatorThread, this, raw,
+                                    static_cast<unsigned int>(line), periodNs);
+    generators_[id] = std::move(generator);
+    return id;
+}
+
+void SimulatedHardware::stopEdgeGenerator(int id) {
+    std::unique_ptr<Generator> generator;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = generators_.find(id);
+        if (it == generators_.end()) {
+            return;
+        }
+        generator = std::move(it->second);
+        generators_.erase(it);
+    }
+    stopGenerator(std::move(generator));
+}
+
+void SimulatedHardware::stopGenerator(std::unique_ptr<Generator> generator) {
+    {
+        std::lock_guard<std::mutex> lock(generator->mutex);
+        generator->running = false;
+    }
+    generator->wake.notify_all();
+    if (generator->thread.joinable()) {
+        generator->thread.join();
+    }
+}
+
+void SimulatedHardware::generatorThread(Generator* generator, unsigned int line, int64_t periodNs) {
+    // Absolute deadlines: a late wakeup is caught up rather than stretching the period
+    auto next = std::chrono::steady_clock::now();
+    while (true) {
+        next += std::chrono::nanoseconds(periodNs);
+        {
+            std::unique_lock<std::mutex> lock(generator->mutex);
+            if (generator->wake.wait_until(lock, next, [generator] { return !generator->running; })) {
+                return;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        driveLocked(line, !lines_[line].level, monotonicNs());
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Buses
+// ----------------------------------------------------------------------------
+
+void SimulatedHardware::addSpiDevice(int bus, int cs, SpiHandler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SpiDevice& device = spiDevices_[{bus, cs}];
+    device.handler = handler ? std::make_shared<const SpiHandler>(std::move(handler)) : nullptr;
+    device.transfers = 0;
+}
+
+uint64_t SimulatedHardware::getSpiTransferCount(int bus, int cs) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = spiDevices_.find({bus, cs});
+    return it == spiDevices_.end() ? 0 : it->second.transfers;
+}
+
+void SimulatedHardware::addI2cDevice(int bus, uint8_t address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    i2cBuses_[bus][address] = I2cDevice{};
+}
+
+void SimulatedHardware::setI2cRegister(int bus, uint8_t address, uint8_t reg, uint8_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (I2cDevice* device = findI2cLocked(bus, address)) {
+        device->registers[reg] = value;
+    }
+}
+
+int SimulatedHardware::getI2cRegister(int bus, uint8_t address, uint8_t reg) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto busIt = i2cBuses_.find(bus);
+    if (busIt == i2cBuses_.end()) {
+        return -1;
+    }
+    auto deviceIt = busIt->second.find(address);
+    return deviceIt == busIt->second.end() ? -1 : deviceIt->second.registers[reg];
+}
+
+SimulatedHardware::I2cDevice* SimulatedHardware::findI2cLocked(int bus, int address) {
+    auto busIt = i2cBuses_.find(bus);
+    if (busIt == i2cBuses_.end()) {
+        return nullptr;
+    }
+    auto deviceIt = busIt->second.find(address);
+    return deviceIt == busIt->second.end() ? nullptr : &deviceIt->second;
+}
+
+void SimulatedHardware::i2cWrite(I2cDevice& device, const uint8_t* data, size_t length) {
+    // First byte selects the register, the rest are written from there on
+    if (length == 0) {
+        return;
+    }
+    device.pointer = data[0];
+    for (size_t i = 1; i < length; ++i) {
+        device.registers[device.pointer++] = data[i];
+    }
+}
+
+void SimulatedHardware::i2cRead(I2cDevice& device, uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = device.registers[device.pointer++];
+    }
+}
+
+} // namespace pipinpp
@@ -0,0 +1,448 @@
+/**
+ * @file ssd1306.cpp
+ * @brief SSD1306 driver: drawing, dirty tracking and windowed updates
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ssd1306.hpp"
+#include "log.hpp"
+#include "transaction.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint8_t CONTROL_COMMANDS = 0x00;
+constexpr uint8_t CONTROL_DATA = 0x40;
+
+constexpr uint8_t CMD_SET_MEMORY_MODE = 0x20;
+constexpr uint8_t CMD_SET_COLUMN_ADDR = 0x21;
+constexpr uint8_t CMD_SET_PAGE_ADDR = 0x22;
+constexpr uint8_t CMD_SET_START_LINE = 0x40;
+constexpr uint8_t CMD_SET_CONTRAST = 0x81;
+constexpr uint8_t CMD_CHARGE_PUMP = 0x8D;
+constexpr uint8_t CMD_SET_SEGMENT_REMAP = 0xA1;
+constexpr uint8_t CMD_DISPLAY_RAM = 0xA4;
+constexpr uint8_t CMD_NORMAL_DISPLAY = 0xA6;
+constexpr uint8_t CMD_INVERSE_DISPLAY = 0xA7;
+constexpr uint8_t CMD_SET_MULTIPLEX = 0xA8;
+constexpr uint8_t CMD_DISPLAY_OFF = 0xAE;
+constexpr uint8_t CMD_DISPLAY_ON = 0xAF;
+constexpr uint8_t CMD_SET_COM_SCAN_DEC = 0xC8;
+constexpr uint8_t CMD_SET_DISPLAY_OFFSET = 0xD3;
+constexpr uint8_t CMD_SET_CLOCK_DIV = 0xD5;
+constexpr uint8_t CMD_SET_PRECHARGE = 0xD9;
+constexpr uint8_t CMD_SET_COM_PINS = 0xDA;
+constexpr uint8_t CMD_SET_VCOM_DESELECT = 0xDB;
+
+constexpr int DEFAULT_SPLIT_GAP = 8;
+
+} // namespace
+
+Ssd1306::Ssd1306(int width, int height, uint8_t address, WireClass& wire)
+    : wire_(&wire), spi_(nullptr), address_(address), width_(width), height_(height),
+      shownValid_(false), splitGap_(DEFAULT_SPLIT_GAP), lastBytes_(0), lastRectangles_(0),
+      totalBytes_(0) {
+    checkGeometry();
+    buffer_.assign(static_cast<size_t>(width_ * pages()), 0);
+    shown_ = buffer_;
+    dirtyFirst_.assign(static_cast<size_t>(pages()), width_);
+    dirtyLast_.assign(static_cast<size_t>(pages()), -1);
+}
+
+Ssd1306::Ssd1306(SPIClass& spi, int dcPin, int resetPin, int width, int height)
+    : wire_(nullptr), spi_(&spi), address_(0), width_(width), height_(height),
+      shownValid_(false), splitGap_(DEFAULT_SPLIT_GAP), lastBytes_(0), lastRectangles_(0),
+      totalBytes_(0) {
+    checkGeometry();
+    dc_ = std::make_unique<Pin>(dcPin, PinDirection::OUTPUT);
+    if (resetPin >= 0) {
+        reset_ = std::make_unique<Pin>(resetPin, PinDirection::OUTPUT);
+        reset_->write(true);
+    }
+    buffer_.assign(static_cast<size_t>(width_ * pages()), 0);
+    shown_ = buffer_;
+    dirtyFirst_.assign(static_cast<size_t>(pages()), width_);
+    dirtyLast_.assign(static_cast<size_t>(pages()), -1);
+}
+
+Ssd1306::~Ssd1306() = default;
+
+void Ssd1306::checkGeometry() const {
+    if (width_ < 1 || width_ > 128 || height_ < 8 || height_ > 64 || height_ % 8 != 0) {
+        throw std::invalid_argument("Ssd1306: panel must be 1-128 columns by 8-64 rows (multiple of 8), got " +
+                                    std::to_string(width_) + "x" + std::to_string(height_));
+    }
+}
+
+bool Ssd1306::begin() {
+    // The reset pulse and D/C line pace the bus traffic: never deferred
+    ScopedTransactionBypass direct;
+    if (reset_) {
+        reset_->write(false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        reset_->write(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const uint8_t init[] = {
+        CMD_DISPLAY_OFF,
+        CMD_SET_CLOCK_DIV, 0x80,
+        CMD_SET_MULTIPLEX, static_cast<uint8_t>(height_ - 1),
+        CMD_SET_DISPLAY_OFFSET, 0x00,
+        CMD_SET_START_LINE | 0x00,
+        CMD_CHARGE_PUMP, 0x14,
+        CMD_SET_MEMORY_MODE, 0x00,             // Horizontal: windows wrap page by page
+        CMD_SET_SEGMENT_REMAP,
+        CMD_SET_COM_SCAN_DEC,
+        CMD_SET_COM_PINS, static_cast<uint8_t>(height_ == 64 ? 0x12 : 0x02),
+        CMD_SET_CONTRAST, 0xCF,
+        CMD_SET_PRECHARGE, 0xF1,
+        CMD_SET_VCOM_DESELECT, 0x40,
+        CMD_DISPLAY_RAM,
+        CMD_NORMAL_DISPLAY,
+        CMD_DISPLAY_ON
+    };
+    invalidate();
+    if (!sendCommands(init, sizeof(init))) {
+        PIPINPP_LOG_WARNING("Ssd1306: init sequence failed");
+        return false;
+    }
+    return true;
+}
+
+bool Ssd1306::sendCommands(const uint8_t* commands, size_t length) {
+    if (wire_ != nullptr) {
+        return wire_->writeRegisters(address_, CONTROL_COMMANDS, commands, length);
+    }
+    ScopedTransactionBypass direct;
+    dc_->write(false);
+    return spi_->transferStream(commands, nullptr, length);
+}
+
+bool Ssd1306::setContrast(uint8_t contrast) {
+    const uint8_t commands[] = {CMD_SET_CONTRAST, contrast};
+    return sendCommands(commands, sizeof(commands));
+}
+
+bool Ssd1306::invert(bool inverted) {
+    const uint8_t command = inverted ? CMD_INVERSE_DISPLAY : CMD_NORMAL_DISPLAY;
+    return sendCommands(&command, 1);
+}
+
+bool Ssd1306::setPower(bool on) {
+    const uint8_t command = on ? CMD_DISPLAY_ON : CMD_DISPLAY_OFF;
+    return sendCommands(&command, 1);
+}
+
+/* ------------------------------------------------------------ */
+/*                        DIRTY TRACKING                        */
+/* ------------------------------------------------------------ */
+
+void Ssd1306::markColumns(int page, int first, int last) {
+    dirtyFirst_[page] = std::min(dirtyFirst_[page], first);
+    dirtyLast_[page] = std::max(dirtyLast_[page], last);
+}
+
+void Ssd1306::markDirty(int x, int y, int w, int h) {
+    int x0 = std::max(x, 0);
+    int x1 = std::min(x + w, width_) - 1;
+    int y0 = std::max(y, 0);
+    int y1 = std::min(y + h, height_) - 1;
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+    for (int page = y0 / 8; page <= y1 / 8; ++page) {
+        markColumns(page, x0, x1);
+    }
+}
+
+void Ssd1306::invalidate() {
+    shownValid_ = false;
+}
+
+void Ssd1306::collectRects(bool full, std::vector<Rect>& rects) const {
+    rects.clear();
+    if (full || !shownValid_) {
+        rects.push_back({0, width_ - 1, 0, pages() - 1});
+        return;
+    }
+
+    size_t previousPage = 0;                   // First rect of the page above
+    for (int page = 0; page < pages(); ++page) {
+        size_t thisPage = rects.size();
+        const uint8_t* now = &buffer_[static_cast<size_t>(page * width_)];
+        const uint8_t* was = &shown_[static_cast<size_t>(page * width_)];
+        int column = dirtyFirst_[page];
+        while (column <= dirtyLast_[page]) {
+            if (now[column] == was[column]) {
+                ++column;
+                continue;
+            }
+            // Extend the run until an unchanged stretch longer than the split gap
+            int first = column;
+            int last = column;
+            for (int next = column + 1; next <= dirtyLast_[page] && next - last - 1 <= splitGap_; ++next) {
+                if (now[next] != was[next]) {
+                    last = next;
+                }
+            }
+            column = last + 1;
+
+            auto above = std::find_if(rects.begin() + static_cast<std::ptrdiff_t>(previousPage),
+                                      rects.begin() + static_cast<std::ptrdiff_t>(thisPage),
+                                      [&](const Rect& rect) {
+                                          return rect.lastPage == page - 1 &&
+                                                 rect.firstColumn == first && rect.lastColumn == last;
+                                      });
+            if (above != rects.begin() + static_cast<std::ptrdiff_t>(thisPage)) {
+                above->lastPage = page;
+            } else {
+                rects.push_back({first, last, page, page});
+            }
+        }
+        previousPage = thisPage;
+    }
+}
+
+bool Ssd1306::sendRects(const std::vector<Rect>& rects, std::vector<bool>& sent) {
+    sent.assign(rects.size(), false);
+    WireBatch batch;
+    ScopedTransactionBypass direct;     // D/C switches between the SPI transfers it qualifies
+    for (size_t r = 0; r < rects.size(); ++r) {
+        const Rect& rect = rects[r];
+        const uint8_t window[] = {
+            CMD_SET_COLUMN_ADDR, static_cast<uint8_t>(rect.firstColumn), static_cast<uint8_t>(rect.lastColumn),
+            CMD_SET_PAGE_ADDR, static_cast<uint8_t>(rect.firstPage), static_cast<uint8_t>(rect.lastPage)
+        };
+        // Horizontal mode fills the window column by column, then page by page
+        packet_.clear();
+        for (int page = rect.firstPage; page <= rect.lastPage; ++page) {
+            auto row = buffer_.begin() + page * width_;
+            packet_.insert(packet_.end(), row + rect.firstColumn, row + rect.lastColumn + 1);
+        }
+
+        if (wire_ != nullptr) {
+            batch.writeRegisters(address_, CONTROL_COMMANDS, window, sizeof(window));
+            batch.writeRegisters(address_, CONTROL_DATA, packet_.data(), packet_.size());
+        } else {
+            dc_->write(false);
+            if (!spi_->transferStream(window, nullptr, sizeof(window))) {
+                continue;
+            }
+            dc_->write(true);
+            sent[r] = spi_->transferStream(packet_.data(), nullptr, packet_.size());
+        }
+    }
+
+    if (wire_ != nullptr) {
+        wire_->transfer(batch);
+        for (size_t r = 0; r < rects.size(); ++r) {
+            sent[r] = batch.ok(2 * r) && batch.ok(2 * r + 1);
+        }
+    }
+    return std::all_of(sent.begin(), sent.end(), [](bool ok) { return ok; });
+}
+
+bool Ssd1306::display(bool full) {
+    std::vector<Rect> rects;
+    collectRects(full, rects);
+    lastBytes_ = 0;
+    lastRectangles_ = rects.size();
+    if (rects.empty()) {
+        std::fill(dirtyFirst_.begin(), dirtyFirst_.end(), width_);
+        std::fill(dirtyLast_.begin(), dirtyLast_.end(), -1);
+        return true;
+    }
+
+    std::vector<bool> sent;
+    bool ok = sendRects(rects, sent);
+
+    // Whatever is still dirty is exactly what failed
+    std::fill(dirtyFirst_.begin(), dirtyFirst_.end(), width_);
+    std::fill(dirtyLast_.begin(), dirtyLast_.end(), -1);
+    for (size_t r = 0; r < rects.size(); ++r) {
+        const Rect& rect = rects[r];
+        for (int page = rect.firstPage; page <= rect.lastPage; ++page) {
+            if (!sent[r]) {
+                markColumns(page, rect.firstColumn, rect.lastColumn);
+                continue;
+            }
+            size_t offset = static_cast<size_t>(page * width_ + rect.firstColumn);
+            size_t columns = static_cast<size_t>(rect.lastColumn - rect.firstColumn + 1);
+            std::memcpy(&shown_[offset], &buffer_[offset], columns);
+            lastBytes_ += columns;
+        }
+    }
+    totalBytes_ += lastBytes_;
+    if (!shownValid_) {
+        shownValid_ = ok;                      // A failed full refresh is repeated whole
+    }
+    if (!ok) {
+        PIPINPP_LOG_WARNING("Ssd1306: display update failed after " << lastBytes_
+                            << " bytes, the rest stays dirty");
+    }
+    return ok;
+}
+
+/* ------------------------------------------------------------ */
+/*                           DRAWING                            */
+/* ------------------------------------------------------------ */
+
+void Ssd1306::fill(bool on) {
+    std::fill(buffer_.begin(), buffer_.end(), on ? 0xFF : 0x00);
+    for (int page = 0; page < pages(); ++page) {
+        markColumns(page, 0, width_ - 1);
+    }
+}
+
+void Ssd1306::setPixel(int x, int y, bool on) {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_) {
+        return;
+    }
+    uint8_t& byte = buffer_[static_cast<size_t>(x + (y / 8) * width_)];
+    uint8_t bit = static_cast<uint8_t>(1u << (y % 8));
+    uint8_t value = on ? static_cast<uint8_t>(byte | bit) : static_cast<uint8_t>(byte & ~bit);
+    if (value != byte) {
+        byte = value;
+        markColumns(y / 8, x, x);
+    }
+}
+
+bool Ssd1306::getPixel(int x, int y) const {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_) {
+        return false;
+    }
+    return (buffer_[static_cast<size_t>(x + (y / 8) * width_)] >> (y % 8)) & 1;
+}
+
+void Ssd1306::fillRect(int x, int y, int w, int h, bool on) {
+    int x0 = std::max(x, 0);
+    int x1 = std::min(x + w, width_) - 1;
+    int y0 = std::max(y, 0);
+    int y1 = std::min(y + h, height_) - 1;
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+    // One mask per page instead of one read-modify-write per pixel
+    for (int page = y0 / 8; page <= y1 / 8; ++page) {
+        int top = std::max(y0 - page * 8, 0);
+        int bottom = std::min(y1 - page * 8, 7);
+        uint8_t mask = static_cast<uint8_t>((0xFFu << top) & (0xFFu >> (7 - bottom)));
+        uint8_t* row = &buffer_[static_cast<size_t>(page * width_)];
+        for (int column = x0; column <= x1; ++column) {
+            row[column] = on ? static_cast<uint8_t>(row[column] | mask)
+                             : static_cast<uint8_t>(row[column] & ~mask);
+        }
+        markColumns(page, x0, x1);
+    }
+}
+
+void Ssd1306::drawHLine(int x, int y, int w, bool on) {
+    fillRect(x, y, w, 1, on);
+}
+
+void Ssd1306::drawVLine(int x, int y, int h, bool on) {
+    fillRect(x, y, 1, h, on);
+}
+
+void Ssd1306::drawRect(int x, int y, int w, int h, bool on) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    drawHLine(x, y, w, on);
+    drawHLine(x, y + h - 1, w, on);
+    drawVLine(x, y, h, on);
+    drawVLine(x + w - 1, y, h, on);
+}
+
+void Ssd1306::drawLine(int x0, int y0, int x1, int y1, bool on) {
+    // Bresenham
+    int dx = std::abs(x1 - x0);
+    int dy = std::abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int error = dx - dy;
+    for (;;) {
+        setPixel(x0, y0, on);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int twice = 2 * error;
+        if (twice > -dy) {
+            error -= dy;
+            x0 += sx;
+        }
+        if (twice < dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void Ssd1306::drawCircle(int x0, int y0, int radius, bool on) {
+    int x = radius;
+    int y = 0;
+    int error = 0;
+    while (x >= y) {
+        setPixel(x0 + x, y0 + y, on);
+        setPixel(x0 + y, y0 + x, on);
+        setPixel(x0 - y, y0 + x, on);
+        setPixel(x0 - x, y0 + y, on);
+        setPixel(x0 - x, y0 - y, on);
+        setPixel(x0 - y, y0 - x, on);
+        setPixel(x0 + y, y0 - x, on);
+        setPixel(x0 + x, y0 - y, on);
+        ++y;
+        if (error <= 0) {
+            error += 2 * y + 1;
+        }
+        if (error > 0) {
+            --x;
+            error -= 2 * x + 1;
+        }
+    }
+}
+
+void Ssd1306::drawBitmap(int x, int y, const uint8_t* bitmap, int columns, int rows, bool on) {
+    if (bitmap == nullptr) {
+        return;
+    }
+    for (int row = 0; row < rows; ++row) {
+        const uint8_t* band = bitmap + (row / 8) * columns;
+        for (int column = 0; column < columns; ++column) {
+            if ((band[column] >> (row % 8)) & 1) {
+                setPixel(x + column, y + row, on);
+            }
+        }
+    }
+}
+
+} // namespace pipinpp
@@ -0,0 +1,256 @@
+/**
+ * @file stepper.cpp
+ * @brief Stepper ramp planning and multi-axis move compilation
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "stepper.hpp"
+#include "exceptions.hpp"
+#include "board.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr size_t SCURVE_SEGMENTS = 1024;
+
+struct Edge {
+    uint64_t timeNs;
+    uint32_t setMask;
+    uint32_t clearMask;
+};
+
+uint64_t isqrt(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+// Velocity fraction (Q16) against ramp distance fraction for a smoothstep
+// velocity profile: v(u) = 3u^2 - 2u^3 over normalized time u, so the
+// distance covered is x(u) = 2u^3 - u^4. Built once by bisection.
+const std::array<uint32_t, SCURVE_SEGMENTS + 1>& sCurveTable() {
+    static const std::array<uint32_t, SCURVE_SEGMENTS + 1> table = [] {
+        std::array<uint32_t, SCURVE_SEGMENTS + 1> t{};
+        for (size_t k = 0; k <= SCURVE_SEGMENTS; ++k) {
+            double x = static_cast<double>(k) / SCURVE_SEGMENTS;
+            double lo = 0.0;
+            double hi = 1.0;
+            for (int i = 0; i < 48; ++i) {
+                double mid = (lo + hi) / 2;
+                (2 * mid * mid * mid - mid * mid * mid * mid < x ? lo : hi) = mid;
+            }
+            double u = (lo + hi) / 2;
+            t[k] = static_cast<uint32_t>(std::lround((3 * u * u - 2 * u * u * u) * 65536.0));
+        }
+        return t;
+    }();
+    return table;
+}
+
+void validateAxis(const StepperAxis& axis) {
+    const StepperProfile& profile = axis.profile;
+    if (profile.maxStepsPerSec == 0 || profile.maxStepsPerSec > STEPPER_MAX_STEPS_PER_SEC) {
+        throw InvalidPinError(axis.stepPin, "Stepper speed must be 1-" +
+                              std::to_string(STEPPER_MAX_STEPS_PER_SEC) + " steps/s");
+    }
+    if (profile.accelStepsPerSec2 == 0) {
+        throw InvalidPinError(axis.stepPin, "Stepper acceleration must be positive");
+    }
+    if (axis.pulseNs == 0 || 2ull * axis.pulseNs * profile.maxStepsPerSec > 1000000000ull) {
+        throw InvalidPinError(axis.stepPin, "STEP pulse must be shorter than half the step interval");
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Ramp Planning
+// ============================================================================
+
+std::vector<uint32_t> StepperDriver::planIntervals(uint64_t steps, const StepperProfile& profile) {
+    if (steps < 2) {
+        return {};
+    }
+
+    const uint64_t vmax = std::clamp<uint64_t>(profile.maxStepsPerSec, 1, STEPPER_MAX_STEPS_PER_SEC);
+    const uint64_t accel = std::max<uint64_t>(profile.accelStepsPerSec2, 1);
+    const uint64_t vmaxQ8 = vmax << 8;
+    const uint64_t floorQ8 = std::max<uint64_t>(static_cast<uint64_t>(profile.startStepsPerSec) << 8, 1);
+    const uint64_t rampSteps = std::max<uint64_t>((vmax * vmax) / (2 * accel), 1);  // v^2 = 2 a d
+    const auto& table = sCurveTable();
+
+    std::vector<uint32_t> intervals(steps - 1);
+    for (uint64_t n = 0; n + 1 < steps; ++n) {
+        // Distance from the nearer end of the move, sampled mid-interval
+        const uint64_t d = std::min(n, steps - 2 - n);
+        uint64_t vQ8 = vmaxQ8;
+        if (d < rampSteps) {
+            if (profile.ramp == StepperRamp::TRAPEZOID) {
+                vQ8 = isqrt((accel * (2 * d + 1)) << 16);       // sqrt(2 a (d + 1/2)) in Q8
+            } else {
+                const uint64_t num = (2 * d + 1) * SCURVE_SEGMENTS;
+                const uint64_t den = 2 * rampSteps;
+                const uint64_t index = num / den;
+                const uint64_t frac = ((num % den) << 16) / den;
+                uint64_t f = table[index];
+                if (index < SCURVE_SEGMENTS) {
+                    f += ((table[index + 1] - table[index]) * frac) >> 16;
+                }
+                vQ8 = (vmax * f) >> 8;
+            }
+            vQ8 = std::min(std::max(vQ8, floorQ8), vmaxQ8);
+        }
+        const uint64_t intervalNs = (1000000000ull << 8) / vQ8;
+        intervals[n] = static_cast<uint32_t>(std::min<uint64_t>(intervalNs, std::numeric_limits<uint32_t>::max()));
+    }
+    return intervals;
+}
+
+// ============================================================================
+// StepperDriver Implementation
+// ============================================================================
+
+std::vector<int> StepperDriver::collectPins(const std::vector<StepperAxis>& axes) {
+    if (axes.empty()) {
+        throw InvalidPinError("StepperDriver needs at least one axis");
+    }
+    std::vector<int> pins;
+    for (const StepperAxis& axis : axes) {
+        validateAxis(axis);
+        pins.push_back(axis.stepPin);
+        pins.push_back(axis.dirPin);
+    }
+    return pins;
+}
+
+StepperDriver::StepperDriver(const std::vector<StepperAxis>& axes, WaveBackend backend,
+                             const std::string& chipname)
+    : axes_(axes), sequencer_(collectPins(axes), backend, chipname), positions_(axes.size(), 0) {
+}
+
+StepperMove StepperDriver::compileMove(const std::vector<StepperAxis>& axes,
+                                       const std::vector<int64_t>& steps, bool coordinated) {
+    if (steps.size() != axes.size()) {
+        throw std::invalid_argument("StepperDriver::compileMove: one step count per axis is required");
+    }
+    for (const StepperAxis& axis : axes) {
+        if (!isValidGpioPin(axis.stepPin) || !isValidGpioPin(axis.dirPin)) {
+            throw InvalidPinError(axis.stepPin, "Valid range is 0-27 for STEP/DIR pins");
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> plans(axes.size());
+    std::vector<uint64_t> spans(axes.size(), 0);
+    uint64_t longest = 0;
+    uint64_t setupNs = 0;
+    uint64_t totalSteps = 0;
+    Edge direction{0, 0, 0};
+    for (size_t i = 0; i < axes.size(); ++i) {
+        if (steps[i] == 0) {
+            continue;
+        }
+        uint64_t count = static_cast<uint64_t>(steps[i] < 0 ? -steps[i] : steps[i]);
+        plans[i] = planIntervals(count, axes[i].profile);
+        for (uint32_t interval : plans[i]) {
+            spans[i] += interval;
+        }
+        longest = std::max(longest, spans[i]);
+        setupNs = std::max<uint64_t>(setupNs, axes[i].dirSetupNs);
+        totalSteps += count;
+
+        bool high = (steps[i] > 0) != axes[i].invertDir;
+        (high ? direction.setMask : direction.clearMask) |= 1u << axes[i].dirPin;
+    }
+
+    std::vector<Edge> edges;
+    edges.reserve(2 * totalSteps + 1);
+    edges.push_back(direction);
+    for (size_t i = 0; i < axes.size(); ++i) {
+        if (steps[i] == 0) {
+            continue;
+        }
+        // Time-stretch shorter axes so every axis ends with the longest one
+        double scale = (coordinated && spans[i] > 0) ? static_cast<double>(longest) / spans[i] : 1.0;
+        uint32_t stepBit = 1u << axes[i].stepPin;
+        uint64_t count = plans[i].size() + 1;
+        uint64_t elapsed = 0;
+        for (uint64_t k = 0; k < count; ++k) {
+            uint64_t t = setupNs + static_cast<uint64_t>(std::llround(elapsed * scale));
+            edges.push_back({t, stepBit, 0});
+            edges.push_back({t + axes[i].pulseNs, 0, stepBit});
+            if (k + 1 < count) {
+                elapsed += plans[i][k];
+            }
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const Edge& a, const Edge& b) { return a.timeNs < b.timeNs; });
+
+    auto wave = std::make_shared<Wave>();
+    if (totalSteps > 0) {
+        uint64_t nowNs = 0;
+        for (const Edge& edge : edges) {
+            wave->delay(edge.timeNs - nowNs);
+            nowNs = edge.timeNs;
+            wave->set(edge.setMask).clear(edge.clearMask);
+        }
+    }
+    return StepperMove{wave, steps};
+}
+
+bool StepperDriver::move(const StepperMove& plannedMove) {
+    if (!plannedMove.wave || plannedMove.steps.size() != axes_.size()) {
+        return false;
+    }
+    if (plannedMove.wave->empty()) {
+        return true;   // Nothing to do
+    }
+    if (!sequencer_.play(plannedMove.wave, 1)) {
+        return false;
+    }
+    for (size_t i = 0; i < axes_.size(); ++i) {
+        positions_[i] += plannedMove.steps[i];
+    }
+    return true;
+}
+
+} // namespace pipinpp
@@ -0,0 +1,158 @@
+/**
+ * @file thread_policy.cpp
+ * @brief Implementation of the PiPinPP thread scheduling policy
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thread_policy.hpp"
+#include "exceptions.hpp"
+#include "log.hpp"
+#include "rt_audit.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace pipinpp {
+
+// ThreadPolicyManager Implementation
+
+ThreadPolicyManager& ThreadPolicyManager::getInstance() {
+    static ThreadPolicyManager instance;
+    return instance;
+}
+
+void ThreadPolicyManager::setPolicy(const ThreadPolicy& policy) {
+    if (policy.priority < 0 || policy.priority > 99) {
+        throw InvalidPinError("Thread priority must be 0-99 (got " + std::to_string(policy.priority) + ")");
+    }
+    if (policy.cpu < -1) {
+        throw InvalidPinError("Thread CPU must be -1 or a CPU index (got " + std::to_string(policy.cpu) + ")");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+
+    // Memory locking is process-wide, so it is handled here rather than per thread
+    if (policy.lockMemory && !memoryLocked_) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            memoryLocked_ = true;
+            memoryMessage_.clear();
+            PIPINPP_LOG_INFO("Locked process memory (mlockall)");
+        } else {
+            memoryMessage_ = std::string("mlockall failed: ") + strerror(errno);
+            PIPINPP_LOG_WARNING(memoryMessage_);
+        }
+    } else if (!policy.lockMemory && memoryLocked_) {
+        munlockall();
+        memoryLocked_ = false;
+        memoryMessage_.clear();
+    }
+}
+
+ThreadPolicy ThreadPolicyManager::getPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+ThreadPolicyStatus ThreadPolicyManager::applyToCurrentThread(const std::string& name, bool realtime) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ThreadPolicyStatus status;
+    status.requested = policy_;
+    status.applied = true;
+    status.memoryLocked = memoryLocked_;
+    if (policy_.lockMemory && !memoryLocked_) {
+        status.message = memoryMessage_;
+    }
+
+    // Kernel keeps at most 15 characters
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+
+    if (policy_.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        if (policy_.cpu >= CPU_SETSIZE) {
+            status.message += (status.message.empty() ? "" : "; ");
+            status.message += "CPU " + std::to_string(policy_.cpu) + " out of range";
+        } else {
+            CPU_SET(policy_.cpu, &cpus);
+            int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+            if (rc == 0) {
+                status.affinityGranted = true;
+            } else {
+                status.message += (status.message.empty() ? "" : "; ");
+                status.message += "affinity to CPU " + std::to_string(policy_.cpu) + " failed: " + strerror(rc);
+            }
+        }
+    }
+
+    if (policy_.priority > 0) {
+        sched_param param{};
+        param.sched_priority = policy_.priority;
+        int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc == 0) {
+            status.realtimeGranted = true;
+        } else {
+            status.message += (status.message.empty() ? "" : "; ");
+            status.message += "SCHED_FIFO " + std::to_string(policy_.priority) + " failed: " + strerror(rc) +
+                              " (needs CAP_SYS_NICE or an rtprio limit)";
+        }
+    }
+
+    if (status.granted()) {
+        if (!policy_.isDefault()) {
+            PIPINPP_LOG_DEBUG("Thread " << name << " running with priority " << policy_.priority
+                              << ", cpu " << policy_.cpu);
+        }
+    } else {
+        PIPINPP_LOG_WARNING("Thread " << name << " policy not fully granted: " << status.message);
+    }
+
+    statuses_[name] = status;
+    if (realtime) {
+        rt_audit::markCurrentThread(name.c_str());
+    }
+    return status;
+}
+
+ThreadPolicyStatus ThreadPolicyManager::getStatus(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = statuses_.find(name);
+    if (it == statuses_.end()) {
+        ThreadPolicyStatus status;
+        status.requested = policy_;
+        return status;
+    }
+    return it->second;
+}
+
+std::vector<std::pair<std::string, ThreadPolicyStatus>> ThreadPolicyManager::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<std::pair<std::string, ThreadPolicyStatus>>(statuses_.begin(), statuses_.end());
+}
+
+} // namespace pipinpp
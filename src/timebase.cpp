@@ -0,0 +1,71 @@
+/**
+ * @file timebase.cpp
+ * @brief Timebase epoch and tick conversion setup
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "timebase.hpp"
+
+namespace pipinpp {
+
+namespace {
+
+detail::TimebaseState makeTimebase() {
+    detail::TimebaseState state;
+    state.epochTicks = readCycleCounter();
+#if defined(PIPINPP_TIMEBASE_ARM_TIMER)
+    const unsigned __int128 one = static_cast<unsigned __int128>(1) << 48;
+    const uint64_t hz = cycleCounterHz();
+    state.nsPerTickQ48 = static_cast<uint64_t>(one * 1000000000u / hz);
+    state.usPerTickQ48 = static_cast<uint64_t>(one * 1000000u / hz);
+    state.msPerTickQ48 = static_cast<uint64_t>(one * 1000u / hz);
+#else
+    // Ticks are nanoseconds; the readers divide directly
+    state.nsPerTickQ48 = 1ull << 48;
+    state.usPerTickQ48 = (1ull << 48) / 1000;
+    state.msPerTickQ48 = (1ull << 48) / 1000000;
+#endif
+    return state;
+}
+
+} // namespace
+
+uint64_t cycleCounterHz() {
+#if defined(PIPINPP_TIMEBASE_ARM_TIMER)
+    uint64_t hz;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(hz));
+    return hz;
+#else
+    return 1000000000ull;
+#endif
+}
+
+namespace detail {
+
+// Highest user priority, so the epoch is set before other static initializers call millis()
+__attribute__((init_priority(101))) const TimebaseState timebaseState = makeTimebase();
+
+} // namespace detail
+
+} // namespace pipinpp
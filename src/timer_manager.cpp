@@ -0,0 +1,419 @@
+/**
+ * @file timer_manager.cpp
+ * @brief Implementation of the fixed-rate periodic task scheduler
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "timer_manager.hpp"
+#include "log.hpp"
+#include "precise_delay.hpp"
+#include "thread_policy.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace pipinpp {
+
+namespace {
+
+/// Longest accepted period, keeping deadline arithmetic far from overflow
+constexpr uint64_t MAX_PERIOD_US = static_cast<uint64_t>(std::numeric_limits<int64_t>::max() / 4000);
+
+/// Task whose callback this thread is running (lets a callback cancel itself)
+thread_local const void* currentTask = nullptr;
+
+void drain(int fd) {
+    uint64_t value;
+    while (read(fd, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value))) {
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// TimerManager Implementation
+// ============================================================================
+
+TimerManager& TimerManager::getInstance() {
+    static TimerManager instance;
+    return instance;
+}
+
+TimerManager::TimerManager(size_t poolThreads)
+    : poolThreads_(poolThreads ? poolThreads : 1),
+      spinNs_(0),
+      nextId_(1),
+      running_(false),
+      timerFd_(-1),
+      wakeupFd_(-1) {
+}
+
+TimerManager::~TimerManager() {
+    shutdown();
+}
+
+int TimerManager::every(uint64_t periodUs, TimerCallback callback, TimerExecution execution) {
+    if (periodUs == 0 || periodUs > MAX_PERIOD_US) {
+        PIPINPP_LOG_ERROR("Invalid timer period " << periodUs << " us");
+        return -1;
+    }
+    if (!callback) {
+        PIPINPP_LOG_ERROR("Timer task needs a callback");
+        return -1;
+    }
+
+    auto task = std::make_shared<Task>();
+    task->periodNs = static_cast<int64_t>(periodUs) * 1000;
+    task->callback = std::move(callback);
+    task->execution = execution;
+
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ensureThread();
+        if (!running_.load(std::memory_order_acquire)) {
+            return -1;
+        }
+        if (execution == TimerExecution::POOL) {
+            ensurePool();
+        }
+        id = nextId_++;
+        task->id = id;
+        task->nextNs = monotonicNowNs() + task->periodNs;
+        tasks_[id] = task;
+    }
+    wake();
+    return id;
+}
+
+bool TimerManager::cancel(int id) {
+    std::shared_ptr<Task> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tasks_.find(id);
+        if (it == tasks_.end()) {
+            return false;
+        }
+        task = it->second;
+        tasks_.erase(it);
+        task->cancelled.store(true);
+    }
+    waitIdle(task);
+    return true;
+}
+
+bool TimerManager::setPeriod(int id, uint64_t periodUs) {
+    if (periodUs == 0 || periodUs > MAX_PERIOD_US) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) {
+        return false;
+    }
+    it->second->periodNs = static_cast<int64_t>(periodUs) * 1000;
+    return true;
+}
+
+TimerStats TimerManager::getStats(int id) const {
+    std::shared_ptr<Task> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tasks_.find(id);
+        if (it == tasks_.end()) {
+            return TimerStats();
+        }
+        task = it->second;
+    }
+    std::lock_guard<std::mutex> lock(task->statsMutex);
+    return task->stats;
+}
+
+bool TimerManager::resetStats(int id) {
+    std::shared_ptr<Task> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tasks_.find(id);
+        if (it == tasks_.end()) {
+            return false;
+        }
+        task = it->second;
+    }
+    std::lock_guard<std::mutex> lock(task->statsMutex);
+    task->stats = TimerStats();
+    return true;
+}
+
+size_t TimerManager::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void TimerManager::clear() {
+    std::map<int, std::shared_ptr<Task>> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        removed.swap(tasks_);
+        for (auto& entry : removed) {
+            entry.second->cancelled.store(true);
+        }
+    }
+    for (auto& entry : removed) {
+        waitIdle(entry.second);
+    }
+}
+
+void TimerManager::ensureThread() {
+    if (running_.load(std::memory_order_acquire)) {
+        return;
+    }
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    wakeupFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (timerFd_ < 0 || wakeupFd_ < 0) {
+        PIPINPP_LOG_ERROR("TimerManager: cannot create timer descriptors: " << std::strerror(errno));
+        if (timerFd_ >= 0) {
+            close(timerFd_);
+        }
+        if (wakeupFd_ >= 0) {
+            close(wakeupFd_);
+        }
+        timerFd_ = wakeupFd_ = -1;
+        return;
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&TimerManager::timerLoop, this);
+}
+
+void TimerManager::ensurePool() {
+    if (!pool_.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < poolThreads_; ++i) {
+        pool_.emplace_back(&TimerManager::poolLoop, this);
+    }
+}
+
+void TimerManager::wake() {
+    const uint64_t one = 1;
+    if (wakeupFd_ >= 0 && write(wakeupFd_, &one, sizeof(one)) < 0) {
+        // Counter saturated: a wake-up is already pending
+    }
+}
+
+void TimerManager::timerLoop() {
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-timer");
+
+    while (running_.load(std::memory_order_acquire)) {
+        int64_t next = -1;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& entry : tasks_) {
+                if (next < 0 || entry.second->nextNs < next) {
+                    next = entry.second->nextNs;
+                }
+            }
+        }
+
+        // Absolute deadline, so time spent in callbacks never shifts the grid
+        const int64_t spin = spinNs_.load(std::memory_order_relaxed);
+        itimerspec spec{};
+        if (next >= 0) {
+            const int64_t armNs = std::max<int64_t>(next - spin, 1);
+            spec.it_value.tv_sec = static_cast<time_t>(armNs / 1000000000LL);
+            spec.it_value.tv_nsec = static_cast<long>(armNs % 1000000000LL);
+        }
+        timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+        pollfd fds[2] = {{timerFd_, POLLIN, 0}, {wakeupFd_, POLLIN, 0}};
+        if (next < 0 || monotonicNowNs() < next - spin) {
+            if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+                PIPINPP_LOG_ERROR("TimerManager poll failed: " << std::strerror(errno));
+                break;
+            }
+        }
+        drain(timerFd_);
+        if (fds[1].revents & POLLIN) {
+            // Tasks changed; the earliest deadline may have moved
+            drain(wakeupFd_);
+            continue;
+        }
+        if (!running_.load(std::memory_order_acquire) || next < 0) {
+            continue;
+        }
+        if (spin > 0) {
+            preciseSleepUntilNs(next);
+        }
+
+        const int64_t now = monotonicNowNs();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& entry : tasks_) {
+                Task& task = *entry.second;
+                if (task.nextNs > now) {
+                    continue;
+                }
+                // Fixed rate: releases that already passed are skipped, not run in a burst
+                const int64_t missed = (now - task.nextNs) / task.periodNs;
+                const int64_t release = task.nextNs + missed * task.periodNs;
+                task.nextNs = release + task.periodNs;
+                if (missed > 0) {
+                    std::lock_guard<std::mutex> statsLock(task.statsMutex);
+                    task.stats.overruns += static_cast<uint64_t>(missed);
+                }
+                due_.push_back({entry.second, release});
+            }
+        }
+        std::sort(due_.begin(), due_.end(),
+                  [](const Job& a, const Job& b) { return a.releaseNs < b.releaseNs; });
+
+        for (Job& job : due_) {
+            Task& task = *job.task;
+            bool idle = false;
+            if (!task.running.compare_exchange_strong(idle, true)) {
+                // Previous pool run still busy
+                std::lock_guard<std::mutex> statsLock(task.statsMutex);
+                ++task.stats.overruns;
+                continue;
+            }
+            if (task.cancelled.load()) {
+                finish(task);
+                continue;
+            }
+            if (task.execution == TimerExecution::POOL) {
+                {
+                    std::lock_guard<std::mutex> lock(poolMutex_);
+                    jobs_.push_back(std::move(job));
+                }
+                poolCv_.notify_one();
+            } else {
+                run(task, job.releaseNs);
+            }
+        }
+        due_.clear();
+    }
+}
+
+void TimerManager::poolLoop() {
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-timer-pool");
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(poolMutex_);
+            poolCv_.wait(lock, [this] { return !jobs_.empty() || !running_.load(std::memory_order_acquire); });
+            if (jobs_.empty()) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        if (job.task->cancelled.load()) {
+            finish(*job.task);
+        } else {
+            run(*job.task, job.releaseNs);
+        }
+    }
+}
+
+void TimerManager::run(Task& task, int64_t releaseNs) {
+    currentTask = &task;
+    const int64_t start = monotonicNowNs();
+    try {
+        task.callback();
+    } catch (const std::exception& e) {
+        PIPINPP_LOG_ERROR("Timer task " << task.id << " threw: " << e.what());
+        (void)e;
+    } catch (...) {
+        PIPINPP_LOG_ERROR("Timer task " << task.id << " threw an unknown exception");
+    }
+    const int64_t end = monotonicNowNs();
+    currentTask = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(task.statsMutex);
+        TimerStats& stats = task.stats;
+        const int64_t lateness = start - releaseNs;
+        if (stats.runs == 0) {
+            stats.minLatenessNs = stats.maxLatenessNs = lateness;
+        } else {
+            stats.minLatenessNs = std::min(stats.minLatenessNs, lateness);
+            stats.maxLatenessNs = std::max(stats.maxLatenessNs, lateness);
+        }
+        ++stats.runs;
+        stats.lastLatenessNs = lateness;
+        stats.totalLatenessNs += lateness;
+        stats.lastRunNs = end - start;
+        stats.maxRunNs = std::max(stats.maxRunNs, stats.lastRunNs);
+    }
+    finish(task);
+}
+
+void TimerManager::finish(Task& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task.running.store(false);
+    }
+    idle_.notify_all();
+}
+
+void TimerManager::waitIdle(const std::shared_ptr<Task>& task) {
+    if (currentTask == task.get()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [&task] { return !task->running.load(); });
+}
+
+void TimerManager::shutdown() {
+    clear();
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        running_.store(false, std::memory_order_release);
+    }
+    poolCv_.notify_all();
+    wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (auto& worker : pool_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    pool_.clear();
+    if (timerFd_ >= 0) {
+        close(timerFd_);
+    }
+    if (wakeupFd_ >= 0) {
+        close(wakeupFd_);
+    }
+    timerFd_ = wakeupFd_ = -1;
+}
+
+} // namespace pipinpp
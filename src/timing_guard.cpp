@@ -0,0 +1,416 @@
+/**
+ * @file timing_guard.cpp
+ * @brief Implementation of TimingGuard
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "timing_guard.hpp"
+#include "log.hpp"
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace pipinpp {
+
+namespace {
+
+const char* const PERFORMANCE = "performance";
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+bool readFile(const std::string& path, std::string& value) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    value = trim(text.str());
+    return true;
+}
+
+/**
+ * @brief Write a sysfs/procfs attribute; the kernel reports rejection from write()
+ * @return false with errno set
+ */
+bool writeFile(const std::string& path, const std::string& value) {
+    int fd = open(path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    std::string line = value + "\n";
+    ssize_t written = write(fd, line.data(), line.size());
+    int error = errno;
+    close(fd);
+    if (written != static_cast<ssize_t>(line.size())) {
+        errno = written < 0 ? error : EIO;
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> listDirectory(const std::string& path, const std::string& prefix) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return names;
+    }
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) == 0 && name.size() > prefix.size()) {
+            names.push_back(name);
+        }
+    }
+    closedir(dir);
+    // policy2 before policy10
+    std::sort(names.begin(), names.end(), [&prefix](const std::string& a, const std::string& b) {
+        return std::atoi(a.c_str() + prefix.size()) < std::atoi(b.c_str() + prefix.size());
+    });
+    return names;
+}
+
+void addMessage(std::string& message, const std::string& text) {
+    message += (message.empty() ? "" : "; ") + text;
+}
+
+} // namespace
+
+TimingGuard::TimingGuard(const TimingGuardOptions& options) : options_(options) {
+    if (options.maxLatencyUs < -1) {
+        throw std::invalid_argument("TimingGuard latency limit must be -1 or >= 0 us");
+    }
+    if (options.irqCpu < -1) {
+        throw std::invalid_argument("TimingGuard IRQ CPU must be -1 or a CPU index");
+    }
+    status_.requested = options;
+}
+
+TimingGuard::~TimingGuard() {
+    restore();
+}
+
+std::vector<std::string> TimingGuard::governorFiles() const {
+    const std::string base = path("/sys/devices/system/cpu/cpufreq/");
+    std::vector<std::string> files;
+    for (const std::string& policy : listDirectory(base, "policy")) {
+        files.push_back(base + policy + "/scaling_governor");
+    }
+    return files;
+}
+
+std::vector<std::pair<int, std::string>> TimingGuard::matchingIrqs() const {
+    std::vector<std::pair<int, std::string>> irqs;
+    std::ifstream file(path("/proc/interrupts"));
+    std::string line;
+    if (!std::getline(file, line)) {
+        return irqs;
+    }
+    std::istringstream header(line);
+    std::string column;
+    size_t cpus = 0;
+    while (header >> column) {
+        ++cpus;
+    }
+
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string number;
+        fields >> number;
+        if (number.size() < 2 || number.back() != ':' || !std::isdigit(static_cast<unsigned char>(number[0]))) {
+            continue;   // IPI, LOC, Err...
+        }
+        std::string count;
+        for (size_t i = 0; i < cpus && fields >> count; ++i) {
+        }
+        std::string rest;
+        std::getline(fields, rest);
+        rest = trim(rest);
+
+        const std::string lower = toLower(rest);
+        bool match = std::any_of(options_.irqNames.begin(), options_.irqNames.end(),
+                                 [&lower](const std::string& name) {
+                                     return !name.empty() && lower.find(toLower(name)) != std::string::npos;
+                                 });
+        if (match) {
+            // The last column is the device name
+            size_t space = rest.find_last_of(" \t");
+            irqs.emplace_back(std::atoi(number.c_str()), space == std::string::npos ? rest : rest.substr(space + 1));
+        }
+    }
+    return irqs;
+}
+
+std::vector<TimingCheck> TimingGuard::check() const {
+    std::vector<TimingCheck> checks;
+
+    // cpufreq governor
+    {
+        TimingCheck governor;
+        governor.name = "cpufreq governor";
+        std::set<std::string> values;
+        for (const std::string& file : governorFiles()) {
+            std::string value;
+            if (readFile(file, value)) {
+                values.insert(value);
+            }
+        }
+        governor.available = !values.empty();
+        governor.ok = !options_.performanceGovernor ||
+                      (values.size() == 1 && *values.begin() == PERFORMANCE);
+        for (const std::string& value : values) {
+            governor.detail += (governor.detail.empty() ? "" : ", ") + value;
+        }
+        if (!governor.available) {
+            governor.detail = "no cpufreq policies";
+            governor.ok = true;
+        }
+        checks.push_back(governor);
+    }
+
+    // PM QoS latency limit and the idle states it rules out
+    {
+        TimingCheck latency;
+        latency.name = "idle latency";
+        const std::string qos = path("/dev/cpu_dma_latency");
+        latency.available = access(qos.c_str(), F_OK) == 0;
+        int32_t limit = -1;
+        int fd = open(qos.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            if (read(fd, &limit, sizeof(limit)) != static_cast<ssize_t>(sizeof(limit))) {
+                limit = -1;
+            }
+            close(fd);
+        }
+
+        bool statesKnown = false;
+        std::vector<std::string> deepStates;
+        const std::string idle = path("/sys/devices/system/cpu/cpu0/cpuidle/");
+        for (const std::string& state : listDirectory(idle, "state")) {
+            std::string name;
+            std::string exitLatency;
+            if (!readFile(idle + state + "/name", name) || !readFile(idle + state + "/latency", exitLatency)) {
+                continue;
+            }
+            statesKnown = true;
+            if (options_.maxLatencyUs >= 0 && std::atol(exitLatency.c_str()) > options_.maxLatencyUs) {
+                deepStates.push_back(name + " (" + exitLatency + " us)");
+            }
+        }
+
+        if (!latency.available) {
+            latency.detail = "no /dev/cpu_dma_latency";
+        } else if (limit < 0) {
+            latency.detail = "limit unreadable (needs root)";
+        } else if (limit >= 2000000000) {
+            latency.detail = "no limit";
+        } else {
+            latency.detail = "limit " + std::to_string(limit) + " us";
+        }
+        // Fine if the limit is already low enough, or no idle state is slower than it
+        latency.ok = !latency.available || options_.maxLatencyUs < 0 ||
+                     (limit >= 0 && limit <= options_.maxLatencyUs) || (statesKnown && deepStates.empty());
+        if (!deepStates.empty()) {
+            latency.detail += ", idle states slower than " + std::to_string(options_.maxLatencyUs) + " us:";
+            for (const std::string& state : deepStates) {
+                latency.detail += " " + state;
+            }
+        }
+        checks.push_back(latency);
+    }
+
+    // IRQ affinity
+    {
+        TimingCheck affinity;
+        affinity.name = "IRQ affinity";
+        const std::vector<std::pair<int, std::string>> irqs = matchingIrqs();
+        affinity.available = !irqs.empty();
+        affinity.ok = true;
+        for (const auto& irq : irqs) {
+            std::string cpus;
+            if (!readFile(path("/proc/irq/" + std::to_string(irq.first) + "/smp_affinity_list"), cpus)) {
+                cpus = "?";
+            }
+            if (options_.irqCpu >= 0 && cpus != std::to_string(options_.irqCpu)) {
+                affinity.ok = false;
+            }
+            affinity.detail += (affinity.detail.empty() ? "" : ", ") + std::to_string(irq.first) + " " +
+                               irq.second + " on CPU " + cpus;
+        }
+        if (!affinity.available) {
+            affinity.detail = "no matching interrupts";
+        }
+        checks.push_back(affinity);
+    }
+
+    return checks;
+}
+
+TimingGuardStatus TimingGuard::apply() {
+    TimingGuardStatus status;
+    status.requested = options_;
+    status.applied = true;
+
+    if (options_.performanceGovernor) {
+        const std::vector<std::string> files = governorFiles();
+        status.governorGranted = !files.empty();
+        if (files.empty()) {
+            addMessage(status.message, "no cpufreq policies");
+        }
+        for (const std::string& file : files) {
+            std::string current;
+            if (!readFile(file, current)) {
+                status.governorGranted = false;
+                addMessage(status.message, "cannot read " + file);
+                continue;
+            }
+            if (current == PERFORMANCE) {
+                continue;
+            }
+            if (!writeFile(file, PERFORMANCE)) {
+                status.governorGranted = false;
+                addMessage(status.message, "cannot set " + file + ": " + strerror(errno));
+                continue;
+            }
+            bool saved = std::any_of(savedGovernors_.begin(), savedGovernors_.end(),
+                                     [&file](const std::pair<std::string, std::string>& entry) {
+                                         return entry.first == file;
+                                     });
+            if (!saved) {
+                savedGovernors_.emplace_back(file, current);
+            }
+            PIPINPP_LOG_INFO("TimingGuard: " << file << " " << current << " -> " << PERFORMANCE);
+        }
+    }
+
+    if (options_.maxLatencyUs >= 0) {
+        if (latencyFd_ < 0) {
+            latencyFd_ = open(path("/dev/cpu_dma_latency").c_str(), O_RDWR | O_CLOEXEC);
+        }
+        // The request is the value written and lasts until the fd is closed
+        int32_t limit = options_.maxLatencyUs;
+        if (latencyFd_ >= 0 && lseek(latencyFd_, 0, SEEK_SET) >= 0 &&
+            write(latencyFd_, &limit, sizeof(limit)) == static_cast<ssize_t>(sizeof(limit))) {
+            status.latencyGranted = true;
+            PIPINPP_LOG_INFO("TimingGuard: CPU latency limit " << limit << " us");
+        } else {
+            addMessage(status.message, std::string("cannot request a CPU latency limit: ") + strerror(errno));
+            if (latencyFd_ >= 0) {
+                close(latencyFd_);
+                latencyFd_ = -1;
+            }
+        }
+    }
+
+    if (options_.irqCpu >= 0) {
+        const std::string target = std::to_string(options_.irqCpu);
+        const std::vector<std::pair<int, std::string>> irqs = matchingIrqs();
+        status.irqGranted = true;
+        for (const auto& irq : irqs) {
+            const std::string file = path("/proc/irq/" + std::to_string(irq.first) + "/smp_affinity_list");
+            std::string current;
+            if (!readFile(file, current)) {
+                status.irqGranted = false;
+                addMessage(status.message, "cannot read the affinity of IRQ " + std::to_string(irq.first));
+                continue;
+            }
+            if (current == target) {
+                continue;
+            }
+            if (!writeFile(file, target)) {
+                // EIO: the interrupt controller cannot route this one per CPU
+                status.irqGranted = false;
+                addMessage(status.message, "cannot move IRQ " + std::to_string(irq.first) + " (" + irq.second +
+                                           ") to CPU " + target + ": " + strerror(errno));
+                continue;
+            }
+            bool saved = std::any_of(savedAffinity_.begin(), savedAffinity_.end(),
+                                     [&irq](const std::pair<int, std::string>& entry) {
+                                         return entry.first == irq.first;
+                                     });
+            if (!saved) {
+                savedAffinity_.emplace_back(irq.first, current);
+            }
+            status.steeredIrqs.push_back(irq.first);
+            PIPINPP_LOG_INFO("TimingGuard: IRQ " << irq.first << " (" << irq.second << ") " << current
+                             << " -> " << target);
+        }
+    }
+
+    if (!status.granted()) {
+        PIPINPP_LOG_WARNING("TimingGuard: " << status.message);
+    }
+    status_ = status;
+    return status;
+}
+
+void TimingGuard::restore() {
+    for (auto it = savedGovernors_.rbegin(); it != savedGovernors_.rend(); ++it) {
+        if (!writeFile(it->first, it->second)) {
+            PIPINPP_LOG_WARNING("TimingGuard: cannot restore " << it->first << " to " << it->second << ": "
+                                << strerror(errno));
+        }
+    }
+    savedGovernors_.clear();
+
+    for (auto it = savedAffinity_.rbegin(); it != savedAffinity_.rend(); ++it) {
+        const std::string file = path("/proc/irq/" + std::to_string(it->first) + "/smp_affinity_list");
+        if (!writeFile(file, it->second)) {
+            PIPINPP_LOG_WARNING("TimingGuard: cannot restore IRQ " << it->first << " to CPU " << it->second
+                                << ": " << strerror(errno));
+        }
+    }
+    savedAffinity_.clear();
+
+    if (latencyFd_ >= 0) {
+        close(latencyFd_);
+        latencyFd_ = -1;
+    }
+    status_ = TimingGuardStatus();
+    status_.requested = options_;
+}
+
+} // namespace pipinpp
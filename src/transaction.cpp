@@ -0,0 +1,297 @@
+/**
+ * @file transaction.cpp
+ * @brief Implementation of Transaction
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "transaction.hpp"
+#include "ArduinoCompat.hpp"
+#include "HardwarePWM.hpp"
+#include "backend.hpp"
+#include "board.hpp"
+#include "chip_registry.hpp"
+#include "exceptions.hpp"
+#include "gpiomem.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace pipinpp {
+
+namespace {
+
+// Small transactions are the norm; this covers them without a reallocation
+constexpr size_t RESERVED_CHANGES = 16;
+
+} // namespace
+
+Transaction::Transaction()
+    : uncaughtAtOpen_(std::uncaught_exceptions()) {
+    if (current_) {
+        outer_ = current_;
+        return;
+    }
+    lines_.reserve(RESERVED_CHANGES);
+    current_ = this;
+}
+
+Transaction::~Transaction() {
+    if (outer_) {
+        return;
+    }
+    // Only an exception thrown inside this scope discards; one already in
+    // flight when it opened (a destructor cleaning up) must not
+    if (std::uncaught_exceptions() > uncaughtAtOpen_) {
+        discard();
+    } else {
+        try {
+            commit();
+        } catch (const std::exception& e) {
+            PIPINPP_LOG_ERROR("Transaction commit failed: " << e.what());
+        }
+    }
+    current_ = nullptr;
+}
+
+void Transaction::commit() {
+    if (outer_) {
+        return;
+    }
+
+    // Take the changes first, and stop recording: the calls below write for real
+    std::vector<LineWrite> lines;
+    std::vector<PwmChange> pwms;
+    std::vector<std::pair<int, int>> analog;
+    lines.swap(lines_);
+    pwms.swap(pwms_);
+    analog.swap(analog_);
+    lines_.reserve(RESERVED_CHANGES);
+
+    struct Resume {
+        Transaction* self;
+        ~Resume() { current_ = self; }
+    } resume{this};
+    current_ = nullptr;
+
+    std::string failed;
+    auto fail = [&failed](const std::string& what) { failed += (failed.empty() ? "" : ", ") + what; };
+
+    // Register fast path: one set and one clear store per register block
+    std::vector<bool> done(lines.size(), false);
+    std::vector<bool> written(lines.size(), false);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (done[i] || !lines[i].fastPath) {
+            continue;
+        }
+        uint32_t setMask = 0;
+        uint32_t clearMask = 0;
+        for (size_t j = i; j < lines.size(); ++j) {
+            if (!done[j] && lines[j].fastPath == lines[i].fastPath) {
+                (lines[j].value ? setMask : clearMask) |= lines[j].mask;
+                done[j] = true;
+                written[j] = true;
+            }
+        }
+        if (setMask) {
+            lines[i].fastPath->set(setMask);
+        }
+        if (clearMask) {
+            lines[i].fastPath->clear(clearMask);
+        }
+    }
+
+    // Line requests: one set-values call per request
+    std::vector<unsigned int> offsets;
+    std::unique_ptr<bool[]> values(new bool[lines.size()]);
+    std::vector<size_t> members;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (done[i]) {
+            continue;
+        }
+        offsets.clear();
+        members.clear();
+        for (size_t j = i; j < lines.size(); ++j) {
+            if (!done[j] && lines[j].request == lines[i].request) {
+                values[offsets.size()] = lines[j].value;
+                offsets.push_back(lines[j].offset);
+                members.push_back(j);
+                done[j] = true;
+            }
+        }
+        if (lines[i].request->setValues(offsets.data(), values.get(), offsets.size()) == 0) {
+            for (size_t j : members) {
+                written[j] = true;
+            }
+        } else {
+            for (size_t j : members) {
+                fail("GPIO " + std::to_string(lines[j].offset) + " on " + lines[j].chip->name());
+            }
+        }
+    }
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (written[i]) {
+            lines[i].chip->outputShadow().record(lines[i].offset, lines[i].value);
+        }
+    }
+
+    for (const PwmChange& change : pwms) {
+        double percent = change.duty == DutyKind::PERCENT ? change.percent : -1.0;
+        uint64_t ns = change.duty == DutyKind::NS ? change.ns : std::numeric_limits<uint64_t>::max();
+        if (!change.pwm->applyChange(change.frequencyHz, percent, ns)) {
+            fail("pwmchip" + std::to_string(change.pwm->chip_) + "/pwm" + std::to_string(change.pwm->channel_));
+        }
+    }
+
+    for (const auto& write : analog) {
+        try {
+            analogWrite(write.first, write.second);
+        } catch (const std::exception& e) {
+            fail("analogWrite(" + std::to_string(write.first) + "): " + e.what());
+        }
+    }
+
+    if (!failed.empty()) {
+        throw GpioAccessError(failed, "Transaction commit failed");
+    }
+}
+
+void Transaction::discard() {
+    if (outer_) {
+        return;
+    }
+    lines_.clear();
+    pwms_.clear();
+    analog_.clear();
+}
+
+size_t Transaction::pendingLines() const {
+    return outer_ ? outer_->pendingLines() : lines_.size();
+}
+
+size_t Transaction::pendingPwm() const {
+    return outer_ ? outer_->pendingPwm() : pwms_.size() + analog_.size();
+}
+
+void Transaction::recordLine(GpioChip* chip, LineRequest* request, GpioMem* fastPath, uint32_t mask,
+                             unsigned int offset, bool value) {
+    for (LineWrite& line : lines_) {
+        if (line.chip == chip && line.offset == offset) {
+            line.request = request;
+            line.fastPath = fastPath;
+            line.mask = mask;
+            line.value = value;
+            return;
+        }
+    }
+    lines_.push_back(LineWrite{chip, request, fastPath, mask, offset, value});
+}
+
+int Transaction::pendingLevel(const GpioChip* chip, unsigned int offset) const {
+    for (const LineWrite& line : lines_) {
+        if (line.chip == chip && line.offset == offset) {
+            return line.value ? 1 : 0;
+        }
+    }
+    return -1;
+}
+
+void Transaction::forgetRequest(const LineRequest* request) {
+    for (size_t i = lines_.size(); i-- > 0;) {
+        if (lines_[i].request == request) {
+            lines_.erase(lines_.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+}
+
+Transaction::PwmChange& Transaction::pwmEntry(HardwarePWM* pwm) {
+    for (PwmChange& change : pwms_) {
+        if (change.pwm == pwm) {
+            return change;
+        }
+    }
+    PwmChange change;
+    change.pwm = pwm;
+    pwms_.push_back(change);
+    return pwms_.back();
+}
+
+void Transaction::recordPwmFrequency(HardwarePWM* pwm, uint32_t frequencyHz) {
+    PwmChange& change = pwmEntry(pwm);
+    // setFrequency() keeps the percentage, so a pending duty in ns becomes one
+    if (change.duty == DutyKind::NS) {
+        uint64_t periodNs = change.frequencyHz ? 1000000000ULL / change.frequencyHz : pwm->getPeriodNs();
+        change.percent = periodNs ? 100.0 * static_cast<double>(std::min(change.ns, periodNs)) / periodNs : 0.0;
+        change.duty = DutyKind::PERCENT;
+    }
+    change.frequencyHz = frequencyHz;
+}
+
+void Transaction::recordPwmDutyPercent(HardwarePWM* pwm, double percent) {
+    PwmChange& change = pwmEntry(pwm);
+    change.duty = DutyKind::PERCENT;
+    change.percent = percent;
+}
+
+void Transaction::recordPwmDutyNs(HardwarePWM* pwm, uint64_t nanoseconds) {
+    PwmChange& change = pwmEntry(pwm);
+    change.duty = DutyKind::NS;
+    change.ns = nanoseconds;
+}
+
+void Transaction::forgetPwm(const HardwarePWM* pwm) {
+    for (size_t i = pwms_.size(); i-- > 0;) {
+        if (pwms_[i].pwm == pwm) {
+            pwms_.erase(pwms_.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+}
+
+void Transaction::recordAnalogWrite(int pin, int value) {
+    if (!isValidGpioPin(pin)) {
+        throw InvalidPinError("Invalid pin number: " + std::to_string(pin) +
+                              " (must be 0-27 for Raspberry Pi)");
+    }
+    for (auto& write : analog_) {
+        if (write.first == pin) {
+            write.second = value;
+            return;
+        }
+    }
+    analog_.emplace_back(pin, value);
+}
+
+ScopedTransactionBypass::ScopedTransactionBypass() noexcept
+    : suspended_(Transaction::current_) {
+    Transaction::current_ = nullptr;
+}
+
+ScopedTransactionBypass::~ScopedTransactionBypass() {
+    Transaction::current_ = suspended_;
+}
+
+} // namespace pipinpp
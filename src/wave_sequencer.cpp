@@ -0,0 +1,570 @@
+/**
+ * @file wave_sequencer.cpp
+ * @brief Wave compilation and thread/DMA playback
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wave_sequencer.hpp"
+#include "PinGroup.hpp"
+#include "chip_registry.hpp"
+#include "dma.hpp"
+#include "exceptions.hpp"
+#include "board.hpp"
+#include "gpiomem.hpp"
+#include "log.hpp"
+#include "pio.hpp"
+#include "thread_policy.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <time.h>
+
+namespace pipinpp {
+
+namespace {
+
+constexpr uint32_t VALID_PIN_MASK = uint32_t(gpioBit(BUILD_BOARD.gpioCount) - 1);  // GPIO 0-27
+constexpr uint32_t DMA_CLOCK_HZ = 10000000;       // PWM clock for the DMA tick
+constexpr uint32_t FIFO_DEPTH = 16;               // Words the DMA can run ahead of the PWM
+
+void validateMask(uint32_t mask) {
+    if (mask & ~VALID_PIN_MASK) {
+        throw InvalidPinError("Wave pin mask has pins outside 0-27");
+    }
+}
+
+int64_t monotonicNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+int64_t toNs(const timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+} // namespace
+
+// ============================================================================
+// Wave Implementation
+// ============================================================================
+
+WaveStep& Wave::openStep() {
+    if (steps_.empty() || steps_.back().delayNs != 0) {
+        steps_.push_back(WaveStep());
+    }
+    return steps_.back();
+}
+
+Wave& Wave::set(uint32_t mask) {
+    validateMask(mask);
+    if (mask != 0) {
+        WaveStep& step = openStep();
+        step.setMask |= mask;
+        step.clearMask &= ~mask;
+        pinMask_ |= mask;
+    }
+    return *this;
+}
+
+Wave& Wave::clear(uint32_t mask) {
+    validateMask(mask);
+    if (mask != 0) {
+        WaveStep& step = openStep();
+        step.clearMask |= mask;
+        step.setMask &= ~mask;
+        pinMask_ |= mask;
+    }
+    return *this;
+}
+
+Wave& Wave::write(int pin, bool level) {
+    if (!isValidGpioPin(pin)) {
+        throw InvalidPinError(pin, "Valid range is 0-27 for waves");
+    }
+    return level ? set(1u << pin) : clear(1u << pin);
+}
+
+Wave& Wave::delay(uint64_t ns) {
+    if (ns == 0) {
+        return *this;
+    }
+    if (steps_.empty()) {
+        steps_.push_back(WaveStep());   // Leading delay before the first write
+    }
+    durationNs_ += ns;
+    while (ns > 0) {
+        WaveStep& step = steps_.back();
+        uint64_t room = std::numeric_limits<uint32_t>::max() - step.delayNs;
+        uint64_t take = std::min(ns, room);
+        step.delayNs += static_cast<uint32_t>(take);
+        ns -= take;
+        if (ns > 0) {
+            steps_.push_back(WaveStep());
+        }
+    }
+    return *this;
+}
+
+Wave& Wave::add(const WaveStep& step) {
+    set(step.setMask);
+    clear(step.clearMask);
+    return delay(step.delayNs);
+}
+
+Wave& Wave::append(const Wave& other) {
+    for (const WaveStep& step : other.steps_) {
+        add(step);
+    }
+    return *this;
+}
+
+// ============================================================================
+// WaveSequencer Implementation
+// ============================================================================
+
+WaveSequencer::WaveSequencer(const std::vector<int>& pins, WaveBackend backend,
+                             const std::string& chipname, int dmaChannel)
+    : pinMask_(0), fastPath_(nullptr), backend_(WaveBackend::THREAD),
+      spinNs_(PWM_SPIN_THRESHOLD_NS), playing_(false), stats_(),
+      dmaRepeat_(0), dmaStartBus_(0), tickRange_(0), pioLevels_(0) {
+    if (pins.empty()) {
+        throw InvalidPinError("WaveSequencer needs at least one pin");
+    }
+    for (int pin : pins) {
+        if (!isValidGpioPin(pin)) {
+            throw InvalidPinError(pin, "Valid range is 0-27 for WaveSequencer");
+        }
+        pinMask_ |= 1u << pin;
+    }
+
+    if ((backend == WaveBackend::PIO || backend == WaveBackend::AUTO) && beginPio()) {
+        return;
+    }
+    if (backend == WaveBackend::PIO) {
+        PIPINPP_LOG_WARNING("WaveSequencer: PIO backend unavailable, using the timing thread");
+    }
+
+    // Ascending order, so group bit i is the i-th pin of pinMask_
+    std::vector<int> sorted(pins);
+    std::sort(sorted.begin(), sorted.end());
+    group_.reset(new PinGroup(sorted, PinDirection::OUTPUT, chipname));
+    fastPath_ = GpioMem::forChipLabel(ChipRegistry::getInstance().acquire(chipname)->label());
+
+    if ((backend == WaveBackend::DMA || backend == WaveBackend::AUTO) && !beginDma(dmaChannel) &&
+        backend == WaveBackend::DMA) {
+        PIPINPP_LOG_WARNING("WaveSequencer: DMA backend unavailable, using the timing thread");
+    }
+}
+
+WaveSequencer::~WaveSequencer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopLocked();
+}
+
+bool WaveSequencer::beginDma(int dmaChannel) {
+    if (!isDmaSupported()) {
+        return false;
+    }
+    if (dmaChannel < 0 || dmaChannel > 14) {
+        PIPINPP_LOG_ERROR("Invalid DMA channel " << dmaChannel << ": valid range is 0-14");
+        return false;
+    }
+
+    try {
+        pacer_.reset(new PwmPacer());
+        dma_.reset(new DmaChannel(dmaChannel));
+    } catch (const PinError& e) {
+        PIPINPP_LOG_ERROR("WaveSequencer DMA unavailable: " << e.what());
+        (void)e; // Only used when logging is enabled
+        dma_.reset();
+        pacer_.reset();
+        return false;
+    }
+
+    uint32_t clockHz = pacer_->setClock(DMA_CLOCK_HZ);
+    if (clockHz == 0) {
+        dma_.reset();
+        pacer_.reset();
+        return false;
+    }
+    uint64_t range = (static_cast<uint64_t>(WAVE_DMA_TICK_NS) * clockHz + 500000000) / 1000000000;
+    tickRange_ = static_cast<uint32_t>(std::max<uint64_t>(range, 1));
+    backend_ = WaveBackend::DMA;
+    return true;
+}
+
+bool WaveSequencer::beginPio() {
+    if (!PioStateMachine::isSupported()) {
+        return false;
+    }
+
+    // OUT PINS covers the span of the pins; only pins in pinMask_ are handed to the PIO
+    const int low = __builtin_ctz(pinMask_);
+    const int high = 31 - __builtin_clz(pinMask_);
+    PioSmConfig config;
+    config.outBase = low;
+    config.outCount = static_cast<uint8_t>(high - low + 1);
+    config.pinMask = pinMask_;
+    config.fifoJoin = PioFifoJoin::TX;
+    pio_.reset(new PioStateMachine());
+    if (!pio_->begin(pioWaveProgram(), config)) {
+        pio_.reset();
+        return false;
+    }
+    backend_ = WaveBackend::PIO;
+    return true;
+}
+
+bool WaveSequencer::buildDmaChain(const Wave& wave, uint32_t repeat) {
+    const std::vector<WaveStep>& steps = wave.steps();
+    std::vector<uint32_t> ticks(steps.size());
+    uint64_t delayBlocks = 0;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        ticks[i] = static_cast<uint32_t>((static_cast<uint64_t>(steps[i].delayNs) + WAVE_DMA_TICK_NS / 2) /
+                                         WAVE_DMA_TICK_NS);
+        if (ticks[i] > 0) {
+            ++delayBlocks;
+        }
+    }
+
+    // Layout: [FIFO prefill][per pass: set, clear, delay per step][set/clear masks][FIFO word]
+    const uint64_t passes = repeat == 0 ? 1 : repeat;
+    const uint64_t blocksPerPass = 2 * steps.size() + delayBlocks;
+    const uint64_t blocks = 1 + passes * blocksPerPass;
+    const uint64_t bytes = blocks * sizeof(DmaControlBlock) + steps.size() * 2 * sizeof(uint32_t) +
+                           sizeof(uint32_t);
+    if (bytes > WAVE_DMA_MAX_BYTES) {
+        PIPINPP_LOG_ERROR("Wave of " << steps.size() << " steps x " << passes << " passes needs "
+                          << bytes << " bytes of DMA memory (" << WAVE_DMA_MAX_BYTES << " max)");
+        return false;
+    }
+
+    dmaWave_.reset();
+    memory_.reset();
+    try {
+        memory_.reset(new DmaMemory(static_cast<size_t>(bytes)));
+    } catch (const PinError& e) {
+        PIPINPP_LOG_ERROR("WaveSequencer DMA memory unavailable: " << e.what());
+        (void)e; // Only used when logging is enabled
+        return false;
+    }
+
+    auto* cbs = static_cast<DmaControlBlock*>(memory_->virt());
+    auto* masks = reinterpret_cast<uint32_t*>(cbs + blocks);
+    uint32_t* fifoWord = masks + 2 * steps.size();
+    for (size_t i = 0; i < steps.size(); ++i) {
+        masks[2 * i] = steps[i].setMask;
+        masks[2 * i + 1] = steps[i].clearMask;
+    }
+
+    const uint32_t setBus = dma::busAddress(dma::GPIO_OFFSET, dma::GPSET0);
+    const uint32_t clearBus = dma::busAddress(dma::GPIO_OFFSET, dma::GPCLR0);
+    const uint32_t gpioTi = dma::DMA_TI_NO_WIDE_BURSTS | dma::DMA_TI_WAIT_RESP;
+    const uint32_t delayTi = gpioTi | dma::DMA_TI_DEST_DREQ |
+                             (dma::DMA_PERMAP_PWM << dma::DMA_TI_PERMAP_SHIFT);
+    const uint32_t fifoBus = memory_->busAddress(fifoWord);
+
+    // The source address is not incremented, so a delay of N ticks is one
+    // block writing the same word N times into the paced FIFO. The prefill
+    // block fills the FIFO first so the very first delay is paced too.
+    size_t n = 0;
+    auto emit = [&](uint32_t ti, uint32_t source, uint32_t dest, uint32_t length) {
+        cbs[n] = {ti, source, dest, length, 0, memory_->busAddress(&cbs[n + 1]), {0, 0}};
+        ++n;
+    };
+    emit(delayTi, fifoBus, PwmPacer::fifoBusAddress(), FIFO_DEPTH * 4);
+    for (uint64_t pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < steps.size(); ++i) {
+            emit(gpioTi, memory_->busAddress(masks + 2 * i), setBus, 4);
+            emit(gpioTi, memory_->busAddress(masks + 2 * i + 1), clearBus, 4);
+            if (ticks[i] > 0) {
+                emit(delayTi, fifoBus, PwmPacer::fifoBusAddress(), ticks[i] * 4);
+            }
+        }
+    }
+    cbs[n - 1].nextConbk = repeat == 0 ? memory_->busAddress(&cbs[1]) : 0;
+
+    dmaStartBus_ = memory_->busAddress(cbs);
+    return true;
+}
+
+bool WaveSequencer::play(std::shared_ptr<const Wave> wave, uint32_t repeat) {
+    if (!wave || wave->empty()) {
+        return false;
+    }
+    if (wave->pinMask() & ~pinMask_) {
+        PIPINPP_LOG_ERROR("Wave drives pins outside this WaveSequencer");
+        return false;
+    }
+    if (repeat == 0 && wave->durationNs() == 0) {
+        PIPINPP_LOG_ERROR("A wave with no delays cannot repeat forever");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopLocked();
+
+    if (backend_ == WaveBackend::PIO) {
+        return playPio(std::move(wave), repeat);
+    }
+    if (backend_ == WaveBackend::DMA) {
+        if (dmaWave_ != wave || dmaRepeat_ != repeat) {
+            if (!buildDmaChain(*wave, repeat)) {
+                return false;
+            }
+            dmaWave_ = wave;
+            dmaRepeat_ = repeat;
+        }
+        pacer_->startFifo(0, tickRange_);
+        dma_->start(dmaStartBus_);
+        return true;
+    }
+
+    // Without register access, translate each step to group bits up front
+    std::vector<GroupStep> groupSteps;
+    if (!fastPath_) {
+        const std::vector<unsigned int>& offsets = group_->pins();
+        groupSteps.reserve(wave->size());
+        for (const WaveStep& step : wave->steps()) {
+            GroupStep groupStep{0, 0};
+            for (size_t bit = 0; bit < offsets.size(); ++bit) {
+                uint32_t pinBit = 1u << offsets[bit];
+                if ((step.setMask | step.clearMask) & pinBit) {
+                    groupStep.mask |= 1ull << bit;
+                }
+                if (step.setMask & pinBit) {
+                    groupStep.values |= 1ull << bit;
+                }
+            }
+            groupSteps.push_back(groupStep);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
+        stats_ = WaveStats();
+    }
+    playing_ = true;
+    thread_ = std::thread(&WaveSequencer::playLoop, this, std::move(wave), std::move(groupSteps), repeat);
+    return true;
+}
+
+bool WaveSequencer::playPio(std::shared_ptr<const Wave> wave, uint32_t repeat) {
+    // Per step: absolute levels from the lowest pin up, then the delay in cycles
+    const int base = __builtin_ctz(pinMask_);
+    const double cyclesPerNs = pio_->getClockHz() / 1e9;
+    auto encodePass = [&](uint32_t& levels) {
+        std::vector<uint32_t> words;
+        words.reserve(2 * wave->size());
+        for (const WaveStep& step : wave->steps()) {
+            levels = (levels | step.setMask) & ~step.clearMask;
+            uint64_t cycles = static_cast<uint64_t>(std::llround(step.delayNs * cyclesPerNs));
+            words.push_back(levels >> base);
+            words.push_back(cycles > PIO_WAVE_STEP_CYCLES ? static_cast<uint32_t>(cycles - PIO_WAVE_STEP_CYCLES) : 0);
+        }
+        return words;
+    };
+
+    // Later passes start from the levels the first one ends with
+    uint32_t levels = pioLevels_;
+    std::vector<uint32_t> first = encodePass(levels);
+    std::vector<uint32_t> rest;
+    if (repeat != 1) {
+        rest = encodePass(levels);
+    }
+    pioLevels_ = levels;
+
+    {
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
+        stats_ = WaveStats();
+    }
+    playing_ = true;
+    thread_ = std::thread(&WaveSequencer::pioLoop, this, std::move(first), std::move(rest), repeat,
+                          wave->steps().back().delayNs);
+    return true;
+}
+
+void WaveSequencer::pioLoop(std::vector<uint32_t> first, std::vector<uint32_t> rest, uint32_t repeat,
+                            uint32_t holdNs) {
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-wave");
+
+    const size_t chunkWords = 2 * WAVE_PIO_CHUNK_STEPS;
+    WaveStats stats;
+    bool active = true;
+    for (uint64_t pass = 0; active && (repeat == 0 || pass < repeat); ++pass) {
+        const std::vector<uint32_t>& words = pass == 0 ? first : rest;
+        for (size_t offset = 0; offset < words.size(); offset += chunkWords) {
+            if (!playing_ || !pio_->write(words.data() + offset, std::min(chunkWords, words.size() - offset))) {
+                active = false;
+                break;
+            }
+        }
+        if (active) {
+            ++stats.passes;
+            stats.steps += words.size() / 2;
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_ = stats;
+        }
+    }
+
+    // Let the queued steps play out, then hold the last one for its delay
+    while (active && playing_ && !pio_->isTxEmpty()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    const auto holdEnd = std::chrono::steady_clock::now() + std::chrono::nanoseconds(holdNs);
+    while (active && playing_ && std::chrono::steady_clock::now() < holdEnd) {
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+            holdEnd - std::chrono::steady_clock::now(), std::chrono::milliseconds(1)));
+    }
+
+    finishPlaying(stats);
+}
+
+void WaveSequencer::playLoop(std::shared_ptr<const Wave> wave, std::vector<GroupStep> groupSteps,
+                             uint32_t repeat) {
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-wave");
+
+    const std::vector<WaveStep>& steps = wave->steps();
+    const int64_t durationNs = static_cast<int64_t>(wave->durationNs());
+    PwmEdgeClock clock(spinNs_.load(std::memory_order_relaxed));
+    WaveStats stats;
+    bool active = true;
+
+    for (uint64_t pass = 0; active && (repeat == 0 || pass < repeat); ++pass) {
+        if (pass > 0) {
+            clock.nextCycle(durationNs);
+        }
+        int64_t offsetNs = 0;
+        for (size_t i = 0; i < steps.size(); ++i) {
+            if (!clock.waitUntil(offsetNs, playing_)) {
+                active = false;
+                break;
+            }
+            int64_t latenessNs = monotonicNs() - (toNs(clock.cycleStart()) + offsetNs);
+            applyStep(steps[i], groupSteps.empty() ? nullptr : &groupSteps[i]);
+
+            ++stats.steps;
+            if (latenessNs >= WAVE_LATE_THRESHOLD_NS) {
+                ++stats.lateSteps;
+            }
+            stats.maxLatenessNs = std::max(stats.maxLatenessNs, latenessNs);
+            offsetNs += steps[i].delayNs;
+        }
+        if (active) {
+            ++stats.passes;
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_ = stats;
+        }
+    }
+
+    // Hold the last step for its delay, so back-to-back plays keep timing
+    if (active) {
+        clock.waitUntil(durationNs, playing_);
+    }
+
+    finishPlaying(stats);
+}
+
+void WaveSequencer::finishPlaying(const WaveStats& stats) {
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_ = stats;
+    }
+    playing_ = false;
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+    }
+    done_.notify_all();
+}
+
+void WaveSequencer::applyStep(const WaveStep& step, const GroupStep* groupStep) {
+    if (groupStep) {
+        group_->writeMask(groupStep->mask, groupStep->values);
+        return;
+    }
+    if (step.setMask) {
+        fastPath_->set(step.setMask);
+    }
+    if (step.clearMask) {
+        fastPath_->clear(step.clearMask);
+    }
+}
+
+bool WaveSequencer::wait(uint32_t timeoutMs) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    if (backend_ == WaveBackend::DMA) {
+        while (dma_->isActive()) {
+            if (timeoutMs != 0 && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    auto finished = [this] { return !playing_.load(); };
+    if (timeoutMs == 0) {
+        done_.wait(lock, finished);
+        return true;
+    }
+    return done_.wait_until(lock, deadline, finished);
+}
+
+void WaveSequencer::stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopLocked();
+}
+
+void WaveSequencer::stopLocked() {
+    if (backend_ == WaveBackend::DMA) {
+        dma_->stop();
+        pacer_->stop();
+        return;
+    }
+    playing_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (pio_) {
+        pio_->restart();    // Drop steps still queued in the FIFO
+    }
+}
+
+bool WaveSequencer::isPlaying() const {
+    if (backend_ == WaveBackend::DMA) {
+        return dma_->isActive();
+    }
+    return playing_;
+}
+
+WaveStats WaveSequencer::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
+
+} // namespace pipinpp
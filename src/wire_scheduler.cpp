@@ -0,0 +1,289 @@
+/**
+ * @file wire_scheduler.cpp
+ * @brief Implementation of background I2C register polling
+ * @author Barbatos6669
+ * @date 2025
+ *
+ * Copyright (c) 2025 HobbyHacker
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wire_scheduler.hpp"
+#include "log.hpp"
+#include "thread_policy.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace pipinpp {
+
+namespace {
+
+int64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// ============================================================================
+// WireScheduler Implementation
+// ============================================================================
+
+WireScheduler::WireScheduler(WireClass& wire)
+    : wire_(wire), running_(false) {
+    for (auto& slot : slots_) {
+        for (auto& word : slot.words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+WireScheduler::~WireScheduler() {
+    stop();
+}
+
+int64_t WireScheduler::nextDeadline(int64_t deadlineNs, int64_t periodNs, int64_t nowNs) {
+    int64_t next = deadlineNs + periodNs;
+    if (nowNs - next >= periodNs) {
+        return nowNs + periodNs;  // Missed whole periods: don't burst to catch up
+    }
+    return next;
+}
+
+int WireScheduler::addPoll(uint8_t address, uint8_t reg, size_t length, uint32_t periodUs) {
+    if (length == 0 || length > WIRE_SNAPSHOT_MAX_BYTES || periodUs < WIRE_SCHEDULER_MIN_PERIOD_US) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(configMutex_);
+
+    for (size_t i = 0; i < WIRE_SCHEDULER_MAX_POLLS; ++i) {
+        PollConfig& poll = polls_[i];
+        if (poll.active) {
+            continue;
+        }
+
+        // Empty snapshot, then make the slot visible to readers
+        Slot& slot = slots_[i];
+        slot.active.store(false, std::memory_order_relaxed);
+        uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (auto& word : slot.words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+        slot.length.store(static_cast<uint32_t>(length), std::memory_order_relaxed);
+        slot.timestampNs.store(0, std::memory_order_relaxed);
+        slot.sequence.store(0, std::memory_order_relaxed);
+        slot.status.store(0, std::memory_order_relaxed);
+        slot.consecutiveErrors.store(0, std::memory_order_relaxed);
+        slot.seq.store(seq + 2, std::memory_order_release);
+        slot.active.store(true, std::memory_order_release);
+
+        poll.active = true;
+        poll.address = address;
+        poll.reg = reg;
+        poll.length = length;
+        poll.periodNs = static_cast<int64_t>(periodUs) * 1000;
+        poll.deadlineNs = monotonicNs();
+        poll.generation++;
+
+        wake_.notify_all();
+        return static_cast<int>(i);
+    }
+
+    PIPINPP_LOG_WARNING("WireScheduler: no free poll slots");
+    return -1;
+}
+
+bool WireScheduler::removePoll(int id) {
+    if (id < 0 || static_cast<size_t>(id) >= WIRE_SCHEDULER_MAX_POLLS) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(configMutex_);
+    if (!polls_[id].active) {
+        return false;
+    }
+    polls_[id].active = false;
+    slots_[id].active.store(false, std::memory_order_release);
+    return true;
+}
+
+size_t WireScheduler::getPollCount() const {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    return static_cast<size_t>(std::count_if(std::begin(polls_), std::end(polls_),
+                                             [](const PollConfig& poll) { return poll.active; }));
+}
+
+bool WireScheduler::start() {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    if (running_.load()) {
+        return true;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    running_.store(true);
+    thread_ = std::thread(&WireScheduler::pollThread, this);
+    return true;
+}
+
+void WireScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        running_.store(false);
+        wake_.notify_all();
+    }
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+        thread_.join();
+    }
+}
+
+bool WireScheduler::isRunning() const {
+    return running_.load();
+}
+
+bool WireScheduler::latest(int id, WireSnapshot& out) const {
+    if (id < 0 || static_cast<size_t>(id) >= WIRE_SCHEDULER_MAX_POLLS) {
+        return false;
+    }
+
+    const Slot& slot = slots_[id];
+    if (!slot.active.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    uint64_t words[DATA_WORDS];
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;  // Publish in progress
+        }
+        for (size_t i = 0; i < DATA_WORDS; ++i) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        out.length = slot.length.load(std::memory_order_relaxed);
+        out.timestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+        out.sequence = slot.sequence.load(std::memory_order_relaxed);
+        out.status = slot.status.load(std::memory_order_relaxed);
+        out.consecutiveErrors = slot.consecutiveErrors.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = slot.seq.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    std::memcpy(out.data, words, sizeof(out.data));
+    return out.sequence > 0;
+}
+
+void WireScheduler::publish(size_t index, const uint8_t* data, size_t length, int status, int64_t nowNs) {
+    Slot& slot = slots_[index];
+
+    // Single writer (the poll thread, or addPoll() under configMutex_)
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (status == 0) {
+        uint64_t words[DATA_WORDS] = {};
+        std::memcpy(words, data, length);
+        for (size_t i = 0; i < DATA_WORDS; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.consecutiveErrors.store(0, std::memory_order_relaxed);
+    } else {
+        // Keep the last good data
+        slot.consecutiveErrors.store(slot.consecutiveErrors.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+    }
+    slot.timestampNs.store(nowNs, std::memory_order_relaxed);
+    slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot.status.store(status, std::memory_order_relaxed);
+
+    slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+void WireScheduler::pollThread() {
+    PIPINPP_LOG_DEBUG("WireScheduler thread started");
+    ThreadPolicyManager::getInstance().applyToCurrentThread("pipinpp-i2c" + std::to_string(wire_.getBusNumber()));
+
+    WireBatch batch;
+    uint8_t buffers[WIRE_SCHEDULER_MAX_POLLS][WIRE_SNAPSHOT_MAX_BYTES];
+    size_t due[WIRE_SCHEDULER_MAX_POLLS];
+    uint32_t generations[WIRE_SCHEDULER_MAX_POLLS];
+
+    std::unique_lock<std::mutex> lock(configMutex_);
+    while (running_.load()) {
+        int64_t now = monotonicNs();
+
+        // Everything due now goes into one batch
+        batch.clear();
+        size_t dueCount = 0;
+        for (size_t i = 0; i < WIRE_SCHEDULER_MAX_POLLS; ++i) {
+            PollConfig& poll = polls_[i];
+            if (!poll.active || poll.deadlineNs > now) {
+                continue;
+            }
+            batch.readRegisters(poll.address, poll.reg, buffers[i], poll.length);
+            due[dueCount] = i;
+            generations[dueCount] = poll.generation;
+            dueCount++;
+            poll.deadlineNs = nextDeadline(poll.deadlineNs, poll.periodNs, now);
+        }
+
+        if (dueCount > 0) {
+            lock.unlock();
+            wire_.transfer(batch);
+            int64_t done = monotonicNs();
+            lock.lock();
+
+            for (size_t n = 0; n < dueCount; ++n) {
+                size_t i = due[n];
+                if (polls_[i].active && polls_[i].generation == generations[n]) {
+                    publish(i, buffers[i], polls_[i].length, batch.status(n), done);
+                }
+            }
+        }
+
+        int64_t wakeNs = INT64_MAX;
+        for (const auto& poll : polls_) {
+            if (poll.active) {
+                wakeNs = std::min(wakeNs, poll.deadlineNs);
+            }
+        }
+
+        if (!running_.load()) {
+            break;
+        }
+        if (wakeNs == INT64_MAX) {
+            wake_.wait(lock);
+        } else if (wakeNs > monotonicNs()) {
+            wake_.wait_until(lock, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(wakeNs)));
+        }
+    }
+
+    PIPINPP_LOG_DEBUG("WireScheduler thread stopped");
+}
+
+} // namespace pipinpp
@@ -226,6 +226,40 @@ TEST_F(AdvancedIOTest, ShiftOutLSBFIRSTBasic)
     );
 }
 
+TEST_F(AdvancedIOTest, ShiftOutBufferValidatesArguments)
+{
+    EXPECT_THROW(shiftOutBuffer(99, 17, MSBFIRST, nullptr, 0), InvalidPinError);
+    EXPECT_THROW(shiftOutBuffer(17, 18, MSBFIRST, nullptr, 4), std::invalid_argument);
+    EXPECT_THROW(shiftInBuffer(17, -1, MSBFIRST, nullptr, 0), InvalidPinError);
+    EXPECT_THROW(shiftInBuffer(17, 18, MSBFIRST, nullptr, 4), std::invalid_argument);
+}
+
+TEST_F(AdvancedIOTest, ShiftOutBufferChain)
+{
+    if (!hasGPIO)
+    {
+        GTEST_SKIP() << "GPIO hardware not available";
+    }
+
+    const int DATA_PIN = 17;
+    const int CLOCK_PIN = 27;
+
+    pinMode(DATA_PIN, OUTPUT);
+    pinMode(CLOCK_PIN, OUTPUT);
+
+    uint8_t frame[4] = {0x00, 0xFF, 0x0F, 0xF1};
+    EXPECT_NO_THROW(shiftOutBuffer(DATA_PIN, CLOCK_PIN, MSBFIRST, frame, sizeof(frame)));
+    EXPECT_NO_THROW(shiftOutBuffer(DATA_PIN, CLOCK_PIN, LSBFIRST, frame, sizeof(frame), 500));
+    EXPECT_EQ(digitalRead(CLOCK_PIN), LOW);
+
+    // Data pin must be an output
+    pinMode(DATA_PIN, INPUT);
+    EXPECT_THROW(shiftOutBuffer(DATA_PIN, CLOCK_PIN, MSBFIRST, frame, sizeof(frame)), PinError);
+
+    uint8_t in[4];
+    EXPECT_NO_THROW(shiftInBuffer(DATA_PIN, CLOCK_PIN, MSBFIRST, in, sizeof(in)));
+}
+
 // ============================================================================
 // shiftIn() Tests
 // ============================================================================
@@ -0,0 +1,55 @@
+/**
+ * @file gtest_board.cpp
+ * @brief GoogleTest unit tests for the compile-time board profiles
+ *
+ * Most checks are static_asserts: if the tables or BoardPin stop being
+ * constant expressions, this file stops compiling.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "board.hpp"
+#include "exceptions.hpp"
+#include "pin.hpp"
+
+using namespace pipinpp;
+
+static_assert(isValidGpioPin(0) && isValidGpioPin(27), "header GPIOs are valid");
+static_assert(!isValidGpioPin(-1) && !isValidGpioPin(28), "only header GPIOs are valid");
+static_assert(BOARD_PI4.isHardwarePwm(18) && !BOARD_PI4.isHardwarePwm(17), "PWM table");
+static_assert(BOARD_PI5.registerLayout == GpioMemLayout::RP1, "Pi 5 GPIO is behind RP1");
+static_assert(&boardProfileFor(Platform::RASPBERRY_PI_4) == &BOARD_PI4, "platform lookup");
+static_assert(&boardProfileFor(Platform::BEAGLEBONE) == &BOARD_GENERIC, "unknown boards are generic");
+
+using Led = BoardPin<17>;
+using Fan = BoardPin<18, BOARD_PI5>;
+static_assert(Led::number == 17 && Led::mask == (1u << 17), "pin constants");
+static_assert(!Led::hardwarePwm && Led::spi, "GPIO17 is SPI1 CE1, not PWM");
+static_assert(Fan::hardwarePwm && &Fan::board == &BOARD_PI5, "explicit board");
+
+TEST(BoardTest, ProfilesShareTheHeaderLayout) {
+    for (const BoardProfile* board : {&BOARD_PI3, &BOARD_PI4, &BOARD_PI5, &BOARD_ZERO2, &BOARD_CM4}) {
+        EXPECT_EQ(board->gpioCount, BOARD_GENERIC.gpioCount) << board->name;
+        EXPECT_EQ(board->hardwarePwmPins, BOARD_GENERIC.hardwarePwmPins) << board->name;
+        EXPECT_EQ(board->i2cBus, 1) << board->name;
+        EXPECT_EQ(&boardProfileFor(board->platform), board) << board->name;
+    }
+}
+
+TEST(BoardTest, CapabilityMasks) {
+    EXPECT_TRUE(BUILD_BOARD.isI2c(2));
+    EXPECT_TRUE(BUILD_BOARD.isI2c(3));
+    EXPECT_TRUE(BUILD_BOARD.isSpi(10));
+    EXPECT_TRUE(BUILD_BOARD.isUart(14));
+    EXPECT_TRUE(BUILD_BOARD.isReserved(0));
+    EXPECT_FALSE(BUILD_BOARD.isReserved(17));
+    EXPECT_FALSE(BUILD_BOARD.isHardwarePwm(64));
+    EXPECT_EQ(gpioBit(-1), 0u);
+}
+
+TEST(BoardTest, RuntimeValidationFollowsBuildBoard) {
+    EXPECT_THROW(Pin(BUILD_BOARD.gpioCount, PinDirection::OUTPUT), InvalidPinError);
+    EXPECT_THROW(Pin(-1, PinDirection::OUTPUT), InvalidPinError);
+}
@@ -0,0 +1,239 @@
+/**
+ * @file gtest_board_config.cpp
+ * @brief GoogleTest unit tests for BoardConfig and Board
+ *
+ * Parses JSON configs (shorthand and full entries, syntax and schema
+ * errors with their positions, fractions under a comma-decimal locale),
+ * validates conflicts, and brings Boards up
+ * on SimulatedHardware: lines grouped per chip, initial levels, buses,
+ * interrupts by name and a PWM channel that cannot be started.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "board_config.hpp"
+#include "bus_registry.hpp"
+#include "exceptions.hpp"
+#include "sim_backend.hpp"
+#include <atomic>
+#include <chrono>
+#include <clocale>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace pipinpp;
+
+namespace {
+
+const char* const FULL_CONFIG = R"({
+  // Comments are allowed
+  "chip": "gpiochip0",
+  "outputs": { "led": 17, "relay": { "pin": 27, "initial": 1 } },
+  "inputs": { "button": { "pin": 22, "mode": "pullup" }, "limit": 23 },
+  "interrupts": { "door": { "pin": 5, "edge": "falling", "debounceUs": 5000 } },
+  "pwm": { "fan": { "pin": 18, "frequency": 25000, "duty": 40 } },
+  "i2c": { "sensors": 1 },
+  "spi": { "adc": { "bus": 0, "cs": 1 } }
+})";
+
+class BoardConfigTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sim().reset();
+        sim().install();
+    }
+
+    void TearDown() override {
+        closeAllBuses();
+        sim().reset();
+        sim().uninstall();
+    }
+
+    static SimulatedHardware& sim() { return SimulatedHardware::getInstance(); }
+
+    static std::string errorOf(const std::string& json) {
+        try {
+            BoardConfig::fromJson(json);
+        } catch (const std::invalid_argument& e) {
+            return e.what();
+        }
+        return std::string();
+    }
+};
+
+} // namespace
+
+TEST_F(BoardConfigTest, ParsesEverySection) {
+    BoardConfig config = BoardConfig::fromJson(FULL_CONFIG);
+    EXPECT_EQ(config.chipname, "gpiochip0");
+    ASSERT_EQ(config.lines.size(), 4u);
+    EXPECT_EQ(config.lines[0].name, "led");
+    EXPECT_EQ(config.lines[0].pin, 17);
+    EXPECT_EQ(config.lines[0].mode, PinMode::OUTPUT);
+    EXPECT_FALSE(config.lines[0].initial);
+    EXPECT_TRUE(config.lines[1].initial);
+    EXPECT_EQ(config.lines[2].mode, PinMode::INPUT_PULLUP);
+    EXPECT_EQ(config.lines[3].mode, PinMode::INPUT);
+
+    ASSERT_EQ(config.interrupts.size(), 1u);
+    EXPECT_EQ(config.interrupts[0].mode, InterruptMode::FALLING);
+    EXPECT_EQ(config.interrupts[0].debounceUs, 5000u);
+
+    ASSERT_EQ(config.pwms.size(), 1u);
+    EXPECT_EQ(config.pwms[0].chip, 0);
+    EXPECT_EQ(config.pwms[0].channel, 0);
+    EXPECT_EQ(config.pwms[0].frequencyHz, 25000u);
+    EXPECT_DOUBLE_EQ(config.pwms[0].dutyCycle, 40.0);
+
+    ASSERT_EQ(config.i2cBuses.size(), 1u);
+    EXPECT_EQ(config.i2cBuses[0].bus, 1);
+    ASSERT_EQ(config.spiDevices.size(), 1u);
+    EXPECT_EQ(config.spiDevices[0].cs, 1);
+    EXPECT_NO_THROW(config.validate());
+}
+
+TEST_F(BoardConfigTest, ErrorsNameTheirPosition) {
+    EXPECT_NE(errorOf("{\n  \"outputs\": { \"led\": 17,, }\n}").find("line 2, column 26"), std::string::npos);
+    EXPECT_NE(errorOf("{ \"outputs\": { \"led\": { \"pin\": 17, \"speed\": 3 } } }").find("unknown field \"speed\""),
+              std::string::npos);
+    EXPECT_NE(errorOf("{ \"motors\": {} }").find("unknown section"), std::string::npos);
+    EXPECT_NE(errorOf("{ \"inputs\": { \"b\": { \"pin\": 4, \"mode\": \"up\" } } }").find("column 40"),
+              std::string::npos);
+    EXPECT_FALSE(errorOf("{ \"pwm\": { \"fan\": { \"pin\": 17 } } }").empty());     // No PWM on GPIO 17
+    EXPECT_FALSE(errorOf("[").empty());
+}
+
+TEST_F(BoardConfigTest, FractionsIgnoreTheLocale) {
+    const char* previous = std::setlocale(LC_NUMERIC, nullptr);
+    std::string saved = previous ? previous : "C";
+    bool commaLocale = false;
+    for (const char* name : {"de_DE.UTF-8", "fr_FR.UTF-8", "de_DE", "fr_FR"}) {
+        if (std::setlocale(LC_NUMERIC, name) && std::string(std::localeconv()->decimal_point) == ",") {
+            commaLocale = true;
+            break;
+        }
+    }
+    if (!commaLocale) {
+        std::setlocale(LC_NUMERIC, saved.c_str());
+        GTEST_SKIP() << "No locale with a comma decimal point installed";
+    }
+
+    std::string error;
+    double duty = 0.0;
+    try {
+        duty = BoardConfig::fromJson(R"({ "pwm": { "fan": { "pin": 18, "duty": 12.5 } } })").pwms.at(0).dutyCycle;
+    } catch (const std::invalid_argument& e) {
+        error = e.what();
+    }
+    std::setlocale(LC_NUMERIC, saved.c_str());
+    EXPECT_EQ(error, "");
+    EXPECT_DOUBLE_EQ(duty, 12.5);
+}
+
+TEST_F(BoardConfigTest, ValidateRejectsConflicts) {
+    BoardConfig sharedPin;
+    sharedPin.output("a", 17).input("b", 17);
+    EXPECT_THROW(sharedPin.validate(), InvalidPinError);
+
+    BoardConfig sharedName;
+    sharedName.output("a", 17).i2c("a", 1);
+    EXPECT_THROW(sharedName.validate(), std::invalid_argument);
+
+    BoardConfig badPin;
+    badPin.output("a", 99);
+    EXPECT_THROW(badPin.validate(), InvalidPinError);
+
+    // Same offset on another chip is a different line
+    BoardConfig twoChips;
+    twoChips.output("a", 17);
+    twoChips.lines.push_back(BoardLineSpec{"b", 17, "gpiochip4", PinMode::INPUT, false});
+    EXPECT_NO_THROW(twoChips.validate());
+
+    EXPECT_THROW(BoardConfig().pwm("fan", 17, 1000), InvalidPinError);
+}
+
+TEST_F(BoardConfigTest, LinesShareOneRequestPerChip) {
+    BoardConfig config;
+    config.output("led", 17).output("relay", 27, true).input("button", 22, PinMode::INPUT_PULLUP);
+    Board board(config);
+
+    const BoardStartupReport& report = board.getStartupReport();
+    EXPECT_EQ(report.lineRequests, 1u);
+    EXPECT_EQ(report.lines, 3u);
+    EXPECT_GE(report.totalNs, report.linesNs);
+    EXPECT_EQ(report.parseNs, 0u);
+
+    EXPECT_EQ(sim().getLevel(17), 0);
+    EXPECT_EQ(sim().getLevel(27), 1);
+}
+
+TEST_F(BoardConfigTest, LinesReadAndWrite) {
+    auto board = Board::fromJson(R"({ "outputs": { "led": 17 }, "inputs": { "button": 22 } })");
+    EXPECT_GT(board->getStartupReport().parseNs, 0u);
+
+    BoardLine& led = board->line("led");
+    EXPECT_TRUE(led.isOutput());
+    EXPECT_TRUE(led.write(true));
+    EXPECT_EQ(sim().getLevel(17), 1);
+    EXPECT_TRUE(led.toggle());
+    EXPECT_EQ(sim().getLevel(17), 0);
+
+    BoardLine& button = board->line("button");
+    EXPECT_FALSE(button.write(true));
+    sim().setInput(22, true);
+    EXPECT_EQ(button.read(), 1);
+    sim().setInput(22, false);
+    EXPECT_EQ(button.read(), 0);
+
+    EXPECT_THROW(board->line("missing"), std::invalid_argument);
+}
+
+TEST_F(BoardConfigTest, BoardOwnsItsLines) {
+    {
+        Board board(BoardConfig().output("led", 17));
+        EXPECT_THROW(Pin(17, PinDirection::OUTPUT), std::exception);
+    }
+    EXPECT_NO_THROW(Pin(17, PinDirection::OUTPUT));
+}
+
+TEST_F(BoardConfigTest, BusesOpenOnce) {
+    sim().addI2cDevice(1, 0x48);
+    sim().addSpiDevice(0, 1);
+    BoardConfig config;
+    config.i2c("sensors", 1).i2c("sensorsAgain", 1).spi("adc", 0, 1);
+    Board board(config);
+
+    EXPECT_EQ(board.getStartupReport().buses, 2u);
+    EXPECT_EQ(&board.i2c("sensors"), &board.i2c("sensorsAgain"));
+    EXPECT_EQ(&board.i2c("sensors"), &I2CBus(1));
+    EXPECT_EQ(&board.spi("adc"), &SPIBus(0, 1));
+    EXPECT_THROW(board.spi("sensors"), std::invalid_argument);
+}
+
+TEST_F(BoardConfigTest, InterruptsAttachByName) {
+    Board board(BoardConfig().interrupt("door", 5, InterruptMode::RISING));
+    std::atomic<int> calls{0};
+    board.attachInterrupt("door", [&calls] { calls.fetch_add(1); });
+
+    sim().setInput(5, true);
+    sim().setInput(5, false);
+    sim().setInput(5, true);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (calls.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(calls.load(), 2);
+
+    board.detachInterrupt("door");
+    EXPECT_THROW(board.attachInterrupt("window", [] {}), std::invalid_argument);
+}
+
+TEST_F(BoardConfigTest, MissingPwmChipFailsAndReleasesLines) {
+    BoardConfig config;
+    config.output("led", 17).pwmChannel("fan", 9, 0, 1000);
+    EXPECT_THROW(Board{config}, GpioAccessError);
+    EXPECT_NO_THROW(Pin(17, PinDirection::OUTPUT));     // Released by the failed Board
+}
@@ -0,0 +1,226 @@
+/**
+ * @file gtest_buffer_pool.cpp
+ * @brief GoogleTest unit tests for BufferPool and allocation-free bus transactions
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "buffer_pool.hpp"
+#include "SPI.hpp"
+#include "Serial.hpp"
+#include "Wire.hpp"
+#include "sim_backend.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace pipinpp;
+
+// Count every allocation in this process so tests can assert a code path makes none
+namespace {
+std::atomic<size_t> g_allocations{0};
+}
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+/**
+ * @brief Allocations made while running @p body
+ */
+template <typename F>
+size_t allocationsDuring(F&& body) {
+    size_t before = g_allocations.load();
+    body();
+    return g_allocations.load() - before;
+}
+
+} // namespace
+
+TEST(BufferPoolTest, HandsOutEachBlockOnce) {
+    BufferPool pool(100, 3);
+    EXPECT_EQ(pool.blockSize(), 100u);
+    EXPECT_EQ(pool.blockCount(), 3u);
+    EXPECT_EQ(pool.available(), 3u);
+
+    PooledBuffer a = pool.acquire();
+    PooledBuffer b = pool.acquire();
+    PooledBuffer c = pool.acquire();
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(a.capacity(), 100u);
+    EXPECT_NE(a.data(), b.data());
+    EXPECT_NE(b.data(), c.data());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b.data()) % alignof(std::max_align_t), 0u);
+
+    PooledBuffer none = pool.acquire();
+    EXPECT_FALSE(none);
+    EXPECT_EQ(none.capacity(), 0u);
+    EXPECT_EQ(pool.getExhaustedCount(), 1u);
+
+    uint8_t* reused = b.data();
+    b.reset();
+    EXPECT_FALSE(b);
+    EXPECT_EQ(pool.available(), 1u);
+    PooledBuffer d = std::move(none);
+    d = pool.acquire();
+    EXPECT_EQ(d.data(), reused);
+
+    EXPECT_THROW(BufferPool(0, 4), std::invalid_argument);
+    EXPECT_THROW(BufferPool(64, 0), std::invalid_argument);
+}
+
+TEST(BufferPoolTest, AcquireAndReleaseNeverAllocate) {
+    BufferPool pool(256, 4);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&] {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < 1000; ++i) {
+                PooledBuffer buffer = pool.acquire();
+                if (buffer) {
+                    buffer.data()[0] = static_cast<uint8_t>(i);
+                }
+            }
+        });
+    }
+    size_t allocations = allocationsDuring([&] {
+        go.store(true);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(pool.available(), 4u);
+}
+
+class SteadyStateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+    }
+
+    void TearDown() override {
+        SPI.end();
+        Wire.end();
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+};
+
+TEST_F(SteadyStateTest, WireTransactionsDoNotAllocate) {
+    SimulatedHardware::getInstance().addI2cDevice(1, 0x48);
+    ASSERT_TRUE(Wire.begin(1));
+    uint8_t config[2] = {0x12, 0x34};
+    uint8_t reading[4] = {};
+    WireBatch batch;
+    batch.reserve(8, 32);
+
+    auto round = [&] {
+        Wire.writeRegisters(0x48, 0x01, config, sizeof(config));
+        Wire.readRegisters(0x48, 0x01, reading, sizeof(reading));
+        Wire.beginTransmission(0x48);
+        Wire.write(0x02);
+        Wire.endTransmission(true);
+        Wire.requestFrom(0x48, 2, true);
+        while (Wire.available()) {
+            Wire.read();
+        }
+        batch.clear();
+        batch.writeRegister(0x48, 0x03, 0x56);
+        batch.readRegisters(0x48, 0x01, reading, sizeof(reading));
+        Wire.transfer(batch);
+    };
+    round();                                        // Warm-up (metrics registration)
+    EXPECT_EQ(allocationsDuring([&] {
+        for (int i = 0; i < 100; ++i) {
+            round();
+        }
+    }), 0u);
+    EXPECT_EQ(reading[0], 0x12);
+    EXPECT_TRUE(batch.ok(1));
+}
+
+TEST_F(SteadyStateTest, SpiTransfersDoNotAllocate) {
+    SimulatedHardware::getInstance().addSpiDevice(0, 0);
+    ASSERT_TRUE(SPI.begin());
+    uint8_t tx[64];
+    uint8_t rx[64];
+    for (size_t i = 0; i < sizeof(tx); ++i) {
+        tx[i] = static_cast<uint8_t>(i);
+    }
+    SpiSegment segments[3];
+    segments[0].tx = tx;
+    segments[0].length = 1;
+    segments[1].tx = tx + 1;
+    segments[1].rx = rx;
+    segments[1].length = 32;
+    segments[2].rx = rx + 32;
+    segments[2].length = 32;
+
+    auto round = [&] {
+        SPI.transfer(0xA5);
+        SPI.transfer(tx, rx, sizeof(tx));
+        SPI.transferBatch(segments, 3);
+    };
+    round();
+    EXPECT_EQ(allocationsDuring([&] {
+        for (int i = 0; i < 100; ++i) {
+            round();
+        }
+    }), 0u);
+}
+
+TEST(SerialSteadyStateTest, ReadBytesUntilFillsCallerBuffer) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        GTEST_SKIP() << "Pseudo-terminals not available";
+    }
+    SerialPort port;
+    ASSERT_TRUE(port.begin(115200, ptsname(master)));
+    port.setTimeout(200);
+
+    const char input[] = "T:25\nHUMIDITY:40\n";
+    ASSERT_EQ(::write(master, input, sizeof(input) - 1), static_cast<ssize_t>(sizeof(input) - 1));
+
+    uint8_t line[8];
+    size_t first = 0;
+    size_t second = 0;
+    size_t allocations = allocationsDuring([&] {
+        first = port.readBytesUntil('\n', line, sizeof(line));
+    });
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(line), first), "T:25");
+
+    second = port.readBytesUntil('\n', line, sizeof(line));   // Stops at capacity
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(line), second), "HUMIDITY");
+    EXPECT_EQ(port.readStringUntil('\n'), ":40");
+    EXPECT_EQ(port.readBytesUntil('\n', nullptr, 4), 0u);
+
+    port.end();
+    ::close(master);
+}
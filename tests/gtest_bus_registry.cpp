@@ -0,0 +1,109 @@
+/**
+ * @file gtest_bus_registry.cpp
+ * @brief GoogleTest unit tests for the per-bus SPI/I2C registry
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "bus_registry.hpp"
+#include "exceptions.hpp"
+#include "sim_backend.hpp"
+#include "thread_policy.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace pipinpp;
+
+namespace {
+
+/**
+ * @brief Handler that waits until the other bus is inside its transfer too
+ */
+SimulatedHardware::SpiHandler meetOther(std::atomic<int>& inside, std::atomic<bool>& met) {
+    return [&inside, &met](const uint8_t*, uint8_t*, size_t) {
+        inside.fetch_add(1);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (inside.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        if (inside.load() >= 2) {
+            met.store(true);
+        }
+    };
+}
+
+} // namespace
+
+class BusRegistryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+    }
+
+    void TearDown() override {
+        closeAllBuses();
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+};
+
+TEST_F(BusRegistryTest, ReturnsOneObjectPerBus) {
+    SimulatedHardware::getInstance().addSpiDevice(0, 0);
+    SimulatedHardware::getInstance().addSpiDevice(0, 1);
+    SimulatedHardware::getInstance().addI2cDevice(1, 0x48);
+    SimulatedHardware::getInstance().addI2cDevice(3, 0x48);
+
+    SPIClass& a = SPIBus(0, 0);
+    EXPECT_EQ(&SPIBus(0, 0), &a);
+    EXPECT_NE(&SPIBus(0, 1), &a);
+    EXPECT_NE(&a, &SPI);
+    EXPECT_TRUE(a.isInitialized());
+
+    WireClass& i2c1 = I2CBus(1);
+    EXPECT_EQ(&I2CBus(1), &i2c1);
+    EXPECT_NE(&I2CBus(3), &i2c1);
+    EXPECT_EQ(I2CBus(3).getBusNumber(), 3);
+}
+
+TEST_F(BusRegistryTest, MissingBusThrows) {
+    EXPECT_THROW(SPIBus(2, 0), GpioAccessError);
+    EXPECT_THROW(I2CBus(7), GpioAccessError);
+
+    SimulatedHardware::getInstance().addSpiDevice(2, 0);
+    EXPECT_NO_THROW(SPIBus(2, 0));                  // Failure was not cached
+}
+
+TEST_F(BusRegistryTest, DifferentBusesTransferInParallel) {
+    std::atomic<int> inside{0};
+    std::atomic<bool> met{false};
+    SimulatedHardware::getInstance().addSpiDevice(0, 0, meetOther(inside, met));
+    SimulatedHardware::getInstance().addSpiDevice(1, 0, meetOther(inside, met));
+
+    SPIClass& first = SPIBus(0, 0);
+    SPIClass& second = SPIBus(1, 0);
+    std::thread other([&] { first.transfer(0x01); });
+    second.transfer(0x02);
+    other.join();
+    EXPECT_TRUE(met.load());                        // Both transfers were in flight at once
+}
+
+TEST_F(BusRegistryTest, EachBusHasItsOwnWorker) {
+    SimulatedHardware::getInstance().addSpiDevice(1, 0);
+    SPIClass& bus = SPIBus(1, 0);
+
+    uint8_t tx[2] = {0xAA, 0x55};
+    SpiTransaction transaction;
+    SpiSegment segment;
+    segment.tx = tx;
+    segment.length = sizeof(tx);
+    transaction.segments.push_back(segment);
+    std::atomic<bool> done{false};
+    ASSERT_TRUE(bus.submit(transaction, [&](bool ok) { done.store(ok); }));
+    bus.waitForPending();
+    EXPECT_TRUE(done.load());
+    EXPECT_TRUE(ThreadPolicyManager::getInstance().getStatus("pipinpp-spi1.0").applied);
+}
@@ -0,0 +1,192 @@
+/**
+ * @file gtest_capture.cpp
+ * @brief GoogleTest unit tests for CaptureSession and capture conversion
+ *
+ * Records injected edges from SimulatedHardware into ring files and
+ * checks ordering, wrap-around, stopWhenFull accounting, and the VCD and
+ * sigrok exports.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "capture.hpp"
+#include "sim_backend.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace pipinpp;
+
+namespace {
+
+class CaptureTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sim().reset();
+        sim().install();
+        path_ = "/tmp/pipinpp_gtest_capture_" + std::to_string(::getpid());
+    }
+
+    void TearDown() override {
+        sim().reset();
+        sim().uninstall();
+        std::remove(path_.c_str());
+        std::remove((path_ + ".vcd").c_str());
+        std::remove((path_ + ".sr").c_str());
+    }
+
+    static SimulatedHardware& sim() { return SimulatedHardware::getInstance(); }
+
+    static bool waitForRecords(const CaptureSession& capture, uint64_t expected) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (capture.getRecordCount() + capture.getLostCount() < expected) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    CaptureOptions options(std::vector<int> pins, size_t capacity) const {
+        CaptureOptions opt;
+        opt.pins = std::move(pins);
+        opt.path = path_;
+        opt.capacity = capacity;
+        return opt;
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(CaptureTest, RejectsInvalidOptions) {
+    CaptureSession capture;
+    EXPECT_FALSE(capture.start(options({}, 16)));
+    EXPECT_FALSE(capture.start(options({17, 17}, 16)));
+    EXPECT_FALSE(capture.start(options({17}, 0)));
+    EXPECT_FALSE(capture.isRunning());
+}
+
+TEST_F(CaptureTest, RecordsEdgesInOrder) {
+    sim().setInput(27, true);
+    CaptureSession capture;
+    ASSERT_TRUE(capture.start(options({17, 27}, 64)));
+
+    sim().injectEdges(17, 4, 1000);
+    ASSERT_TRUE(waitForRecords(capture, 4));
+    sim().injectEdges(27, 2, 1000);
+    ASSERT_TRUE(waitForRecords(capture, 6));
+    capture.stop();
+    EXPECT_FALSE(capture.isRunning());
+
+    CaptureData data;
+    ASSERT_TRUE(readCapture(path_, data));
+    EXPECT_EQ(data.pins, (std::vector<int>{17, 27}));
+    EXPECT_EQ(data.initialLevels, (std::vector<int>{0, 1}));
+    EXPECT_FALSE(data.wrapped);
+    EXPECT_EQ(data.lostCount, 0u);
+    EXPECT_GE(data.stopNs, data.startNs);
+    ASSERT_EQ(data.records.size(), 6u);
+    for (size_t i = 1; i < data.records.size(); ++i) {
+        EXPECT_LE(data.records[i - 1].timestampNs, data.records[i].timestampNs);
+    }
+    EXPECT_EQ(data.records[0].pin, 17);
+    EXPECT_EQ(data.records[0].level, 1);
+    EXPECT_EQ(data.records[4].pin, 27);
+    EXPECT_EQ(data.records[4].level, 0);    // Was high
+}
+
+TEST_F(CaptureTest, RingKeepsNewestRecords) {
+    CaptureSession capture;
+    ASSERT_TRUE(capture.start(options({5}, 8)));
+    sim().injectEdges(5, 20, 1000);
+    ASSERT_TRUE(waitForRecords(capture, 20));
+    EXPECT_EQ(capture.getRecordCount(), 20u);
+    capture.stop();
+
+    CaptureData data;
+    ASSERT_TRUE(readCapture(path_, data));
+    EXPECT_TRUE(data.wrapped);
+    ASSERT_EQ(data.records.size(), 8u);
+    EXPECT_EQ(data.records.front().lineSeqno, 13u);
+    EXPECT_EQ(data.records.back().lineSeqno, 20u);
+    EXPECT_EQ(data.startNs, data.records.front().timestampNs);
+    // Edge 13 rises (odd edges rise from low), so the pin was low before it
+    EXPECT_EQ(data.records.front().level, 1);
+    EXPECT_EQ(data.initialLevels[0], 0);
+}
+
+TEST_F(CaptureTest, StopWhenFullCountsTheRest) {
+    CaptureOptions opt = options({6}, 8);
+    opt.stopWhenFull = true;
+    CaptureSession capture;
+    ASSERT_TRUE(capture.start(opt));
+    sim().injectEdges(6, 12, 1000);
+    ASSERT_TRUE(waitForRecords(capture, 12));
+    EXPECT_EQ(capture.getRecordCount(), 8u);
+    EXPECT_EQ(capture.getLostCount(), 4u);
+    capture.stop();
+
+    CaptureData data;
+    ASSERT_TRUE(readCapture(path_, data));
+    EXPECT_FALSE(data.wrapped);
+    EXPECT_EQ(data.lostCount, 4u);
+    ASSERT_EQ(data.records.size(), 8u);
+    EXPECT_EQ(data.records.front().lineSeqno, 1u);
+}
+
+TEST_F(CaptureTest, KernelOverflowIsCountedAsLost) {
+    CaptureOptions opt = options({13}, 64);
+    opt.eventBufferSize = 4;
+    CaptureSession capture;
+    ASSERT_TRUE(capture.start(opt));
+    sim().injectEdges(13, 2, 1000);
+    ASSERT_TRUE(waitForRecords(capture, 2));
+    sim().injectEdges(13, 10, 1000);     // Buffer keeps the newest 4
+    ASSERT_TRUE(waitForRecords(capture, 12));
+    EXPECT_EQ(capture.getRecordCount(), 6u);
+    EXPECT_EQ(capture.getLostCount(), 6u);
+}
+
+TEST_F(CaptureTest, ConvertsToVcdAndSigrok) {
+    CaptureSession capture;
+    ASSERT_TRUE(capture.start(options({17, 18}, 64)));
+    sim().injectEdges(18, 4, 100000);
+    ASSERT_TRUE(waitForRecords(capture, 4));
+    capture.stop();
+
+    CaptureData data;
+    ASSERT_TRUE(readCapture(path_, data));
+
+    ASSERT_TRUE(writeVcd(data, path_ + ".vcd"));
+    std::ifstream vcd(path_ + ".vcd");
+    std::stringstream text;
+    text << vcd.rdbuf();
+    EXPECT_NE(text.str().find("$var wire 1 ! gpio17 $end"), std::string::npos);
+    EXPECT_NE(text.str().find("$var wire 1 \" gpio18 $end"), std::string::npos);
+    EXPECT_NE(text.str().find("1\"\n"), std::string::npos);
+
+    ASSERT_TRUE(writeSigrok(data, path_ + ".sr", 1000000));
+    std::ifstream sr(path_ + ".sr", std::ios::binary);
+    std::string zip((std::istreambuf_iterator<char>(sr)), std::istreambuf_iterator<char>());
+    ASSERT_GT(zip.size(), 4u);
+    EXPECT_EQ(zip.substr(0, 4), std::string("PK\x03\x04", 4));
+    EXPECT_NE(zip.find("samplerate=1 MHz"), std::string::npos);
+    EXPECT_NE(zip.find("probe2=gpio18"), std::string::npos);
+    EXPECT_NE(zip.find(std::string("PK\x05\x06", 4)), std::string::npos);
+}
+
+TEST_F(CaptureTest, MissingOrForeignFilesAreRejected) {
+    CaptureData data;
+    EXPECT_FALSE(readCapture(path_, data));
+    std::ofstream(path_) << "not a capture";
+    EXPECT_FALSE(readCapture(path_, data));
+}
@@ -0,0 +1,85 @@
+/**
+ * @file gtest_chip_registry.cpp
+ * @brief GoogleTest unit tests for the shared GPIO chip registry
+ *
+ * Tests that chip handles are shared and reference-counted. Tests that
+ * need /dev/gpiochip0 are skipped when it is not available.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "chip_registry.hpp"
+#include "pin.hpp"
+#include "exceptions.hpp"
+
+using namespace pipinpp;
+
+TEST(ChipRegistryTest, SingletonInstance) {
+    EXPECT_EQ(&ChipRegistry::getInstance(), &ChipRegistry::getInstance());
+}
+
+TEST(ChipRegistryTest, MissingChipThrows) {
+    size_t before = ChipRegistry::getInstance().openCount();
+    EXPECT_THROW(ChipRegistry::getInstance().acquire("gpiochip_does_not_exist"), GpioAccessError);
+    EXPECT_EQ(ChipRegistry::getInstance().openCount(), before);
+}
+
+TEST(OutputShadowTest, TracksClaimedLinesOnly) {
+    OutputShadow shadow(70);
+    EXPECT_EQ(shadow.level(17), -1);
+
+    shadow.claim(17, false);
+    shadow.claim(65, true);
+    EXPECT_EQ(shadow.level(17), 0);
+    EXPECT_EQ(shadow.level(65), 1);
+    EXPECT_EQ(shadow.owned(0), uint64_t{1} << 17);
+    EXPECT_EQ(shadow.levels(1), uint64_t{1} << 1);
+
+    shadow.record(17, true);
+    EXPECT_EQ(shadow.level(17), 1);
+    EXPECT_EQ(shadow.levels(0), uint64_t{1} << 17);
+
+    shadow.release(17);
+    EXPECT_EQ(shadow.level(17), -1);
+    EXPECT_EQ(shadow.owned(0), 0u);
+    EXPECT_EQ(shadow.level(200), -1);   // Out of range is never tracked
+}
+
+class ChipRegistryHardwareTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        try {
+            ChipRegistry::getInstance().acquire("gpiochip0");
+        }
+        catch (const GpioAccessError& e) {
+            GTEST_SKIP() << "GPIO hardware not available: " << e.what();
+        }
+    }
+};
+
+TEST_F(ChipRegistryHardwareTest, SameNameSharesHandle) {
+    auto a = ChipRegistry::getInstance().acquire("gpiochip0");
+    auto b = ChipRegistry::getInstance().acquire("/dev/gpiochip0");
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_EQ(a->name(), "gpiochip0");
+    EXPECT_GT(a->numLines(), 0u);
+}
+
+TEST_F(ChipRegistryHardwareTest, ClosesWhenLastUserReleases) {
+    size_t before = ChipRegistry::getInstance().openCount();
+    {
+        auto chip = ChipRegistry::getInstance().acquire("gpiochip0");
+        EXPECT_EQ(ChipRegistry::getInstance().openCount(), before + 1);
+    }
+    EXPECT_EQ(ChipRegistry::getInstance().openCount(), before);
+}
+
+TEST_F(ChipRegistryHardwareTest, PinsShareOneChip) {
+    Pin a(17, PinDirection::OUTPUT);
+    size_t withOne = ChipRegistry::getInstance().openCount();
+    Pin b(27, PinDirection::OUTPUT);
+    Pin c(22, PinDirection::OUTPUT);
+    EXPECT_EQ(ChipRegistry::getInstance().openCount(), withOne);
+}
@@ -0,0 +1,174 @@
+/**
+ * @file gtest_coro.cpp
+ * @brief GoogleTest unit tests for the C++20 coroutine awaitables
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "coro.hpp"
+#include "ArduinoCompat.hpp"
+#include "sim_backend.hpp"
+#include <chrono>
+#include <stdexcept>
+
+using namespace pipinpp;
+using namespace std::chrono_literals;
+
+class CoroTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+    }
+
+    void TearDown() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+
+    /**
+     * @brief runOnce() until @p done or two seconds pass
+     */
+    static void runUntil(EventLoop& loop, const std::function<bool()>& done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            loop.runOnce(50);
+        }
+    }
+};
+
+namespace {
+
+coro::Task<int> twice(EventLoop& loop, int value) {
+    co_await coro::sleepFor(loop, 1ms);
+    co_return value * 2;
+}
+
+coro::Task<> failing(EventLoop& loop) {
+    co_await coro::sleepFor(loop, 1ms);
+    throw std::runtime_error("device gone");
+}
+
+coro::Task<> sleeper(EventLoop& loop, std::chrono::microseconds first, int& done) {
+    co_await coro::sleepFor(loop, first);
+    co_await coro::sleepFor(loop, 1ms);
+    ++done;
+}
+
+} // namespace
+
+TEST_F(CoroTest, TasksAwaitTasksAndSleep) {
+    EventLoop loop;
+    int result = 0;
+    bool caught = false;
+    auto start = std::chrono::steady_clock::now();
+    auto body = [&]() -> coro::Task<> {
+        int a = co_await twice(loop, 3);
+        co_await coro::sleepFor(loop, 5ms);
+        result = a + co_await twice(loop, 10);
+        try {
+            co_await failing(loop);
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+    };
+    coro::spawn(body());           // body outlives the coroutine; a temporary would dangle
+    EXPECT_EQ(result, 0);                  // Suspended at the first sleep
+    runUntil(loop, [&] { return caught; });
+    EXPECT_EQ(result, 26);
+    EXPECT_TRUE(caught);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 7ms);
+    EXPECT_EQ(loop.size(), 0u);
+}
+
+TEST_F(CoroTest, EdgeWaitMatchesModeOrTimesOut) {
+    EventLoop loop;
+    Pin input(17, PinDirection::INPUT);
+    std::optional<PinEdgeEvent> timedOut = PinEdgeEvent{};
+    std::optional<PinEdgeEvent> falling;
+    bool finished = false;
+    auto body = [&]() -> coro::Task<> {
+        timedOut = co_await coro::edge(loop, input, RISING, 10ms);
+        loop.after(1000, [] { SimulatedHardware::getInstance().setInput(17, true); });
+        loop.after(3000, [] { SimulatedHardware::getInstance().setInput(17, false); });
+        falling = co_await coro::edge(loop, input, FALLING, 1s);   // Skips the rising edge
+        finished = true;
+    };
+    coro::spawn(body());
+    runUntil(loop, [&] { return finished; });
+    EXPECT_FALSE(timedOut.has_value());
+    ASSERT_TRUE(falling.has_value());
+    EXPECT_FALSE(falling->rising);
+    EXPECT_EQ(loop.size(), 0u);            // Pin and timeout sources removed
+}
+
+TEST_F(CoroTest, RegisterReadsRunOffTheLoopThread) {
+    SimulatedHardware::getInstance().addI2cDevice(1, 0x76);
+    SimulatedHardware::getInstance().setI2cRegister(1, 0x76, 0xD0, 0x58);
+    SimulatedHardware::getInstance().setI2cRegister(1, 0x76, 0xD1, 0x59);
+    ASSERT_TRUE(Wire.begin(1));
+
+    EventLoop loop;
+    uint8_t id[2] = {0, 0};
+    int count = 0;
+    bool written = false;
+    auto body = [&]() -> coro::Task<> {
+        count = co_await coro::readRegisters(loop, Wire, 0x76, 0xD0, id, sizeof(id));
+        const uint8_t config = 0x27;
+        written = co_await coro::writeRegisters(loop, Wire, 0x76, 0xF4, &config, 1);
+    };
+    coro::spawn(body());
+    runUntil(loop, [&] { return written; });
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(id[0], 0x58);
+    EXPECT_EQ(id[1], 0x59);
+    EXPECT_TRUE(written);
+    EXPECT_EQ(SimulatedHardware::getInstance().getI2cRegister(1, 0x76, 0xF4), 0x27);
+    Wire.end();
+}
+
+TEST_F(CoroTest, SpiTransferResumesOnCompletion) {
+    SimulatedHardware::getInstance().addSpiDevice(0, 0, [](const uint8_t* tx, uint8_t* rx, size_t length) {
+        for (size_t i = 0; i < length && rx != nullptr; ++i) {
+            rx[i] = static_cast<uint8_t>(tx[i] + 1);
+        }
+    });
+    ASSERT_TRUE(SPI.begin(0, 0));
+
+    EventLoop loop;
+    uint8_t tx[3] = {1, 2, 3};
+    uint8_t rx[3] = {0, 0, 0};
+    bool ok = false;
+    bool finished = false;
+    auto body = [&]() -> coro::Task<> {
+        SpiTransaction transaction;
+        SpiSegment segment;
+        segment.tx = tx;
+        segment.rx = rx;
+        segment.length = sizeof(tx);
+        transaction.segments.push_back(segment);
+        ok = co_await coro::transfer(loop, SPI, transaction);
+        finished = true;
+    };
+    coro::spawn(body());
+    runUntil(loop, [&] { return finished; });
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(rx[0], 2);
+    EXPECT_EQ(rx[2], 4);
+    SPI.end();
+}
+
+TEST_F(CoroTest, HundredsOfWaitersShareOneThread) {
+    EventLoop loop;
+    const int count = 500;
+    int done = 0;
+    for (int i = 0; i < count; ++i) {
+        coro::spawn(sleeper(loop, std::chrono::microseconds(100 + i % 50), done));
+    }
+    EXPECT_EQ(loop.size(), static_cast<size_t>(count));
+    runUntil(loop, [&] { return done == count; });
+    EXPECT_EQ(done, count);
+    EXPECT_EQ(loop.size(), 0u);
+}
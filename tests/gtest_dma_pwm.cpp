@@ -0,0 +1,106 @@
+/**
+ * @file gtest_dma_pwm.cpp
+ * @brief GoogleTest unit tests for DMA-paced PWM
+ *
+ * Tests pin mapping, clock divisor selection and argument validation.
+ * Playback needs root and a BCM283x/BCM2711 board, so those tests skip
+ * when the registers cannot be mapped.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "DmaPWM.hpp"
+#include "exceptions.hpp"
+#include <thread>
+#include <chrono>
+
+using namespace pipinpp;
+
+TEST(DmaPWMTest, GpioToChannelMapping) {
+    int channel = -1;
+    uint32_t alt = 0;
+
+    EXPECT_TRUE(DmaPWM::gpioToChannel(12, channel, alt));
+    EXPECT_EQ(channel, 0);
+    EXPECT_EQ(alt, 4u);   // ALT0
+    EXPECT_TRUE(DmaPWM::gpioToChannel(13, channel, alt));
+    EXPECT_EQ(channel, 1);
+    EXPECT_TRUE(DmaPWM::gpioToChannel(18, channel, alt));
+    EXPECT_EQ(channel, 0);
+    EXPECT_EQ(alt, 2u);   // ALT5
+    EXPECT_TRUE(DmaPWM::gpioToChannel(19, channel, alt));
+    EXPECT_EQ(channel, 1);
+
+    EXPECT_FALSE(DmaPWM::gpioToChannel(17, channel, alt));
+    EXPECT_FALSE(DmaPWM::gpioToChannel(-1, channel, alt));
+}
+
+TEST(DmaPWMTest, InvalidPinThrows) {
+    EXPECT_THROW(DmaPWM(17), InvalidPinError);
+    EXPECT_THROW(DmaPWM(18, 15), InvalidPinError);
+    EXPECT_THROW(DmaPWM(18, -1), InvalidPinError);
+}
+
+TEST(DmaPWMTest, ClockDivisor) {
+    uint32_t divisor = 0;
+
+    // 19.2 MHz crystal: 8 kHz * 240 = 1.92 MHz → divisor 10
+    EXPECT_TRUE(DmaPWM::computeClockDivisor(19200000, 8000, 240, divisor));
+    EXPECT_EQ(divisor, 10u);
+
+    // 54 MHz crystal: 50 kHz * 100 = 5 MHz → nearest divisor 11
+    EXPECT_TRUE(DmaPWM::computeClockDivisor(54000000, 50000, 100, divisor));
+    EXPECT_EQ(divisor, 11u);
+
+    // Too fast (divisor < 2), too slow (divisor > 4095), degenerate range
+    EXPECT_FALSE(DmaPWM::computeClockDivisor(19200000, 100000, 1000, divisor));
+    EXPECT_FALSE(DmaPWM::computeClockDivisor(19200000, 1, 2, divisor));
+    EXPECT_FALSE(DmaPWM::computeClockDivisor(19200000, 1000, 1, divisor));
+    EXPECT_FALSE(DmaPWM::computeClockDivisor(19200000, 0, 100, divisor));
+}
+
+TEST(DmaPWMTest, PlayBeforeBeginFails) {
+    DmaPWM pwm(18);
+    uint32_t samples[] = {1, 2, 3};
+
+    EXPECT_FALSE(pwm.isBegun());
+    EXPECT_FALSE(pwm.play(samples, 3));
+    EXPECT_FALSE(pwm.setDutyCycle(50.0));
+    EXPECT_FALSE(pwm.isPlaying());
+    EXPECT_EQ(pwm.getSampleRate(), 0u);
+    pwm.end();   // Safe without begin()
+}
+
+TEST(DmaPWMTest, ControlBlockLayout) {
+    EXPECT_EQ(sizeof(DmaControlBlock), 32u);
+    EXPECT_EQ(alignof(DmaControlBlock), 32u);
+    EXPECT_EQ(PwmPacer::fifoBusAddress(), 0x7E20C018u);
+}
+
+TEST(DmaPWMTest, PlaysSequenceOnHardware) {
+    DmaPWM pwm(18);
+    if (!pwm.begin(10000, 100)) {
+        GTEST_SKIP() << "DMA PWM not available (needs root on a Pi 0-4)";
+    }
+    EXPECT_EQ(pwm.getRange(), 100u);
+    EXPECT_GT(pwm.getSampleRate(), 0u);
+
+    std::vector<uint32_t> ramp;
+    for (uint32_t i = 0; i <= 100; ++i) {
+        ramp.push_back(i);
+    }
+    ASSERT_TRUE(pwm.play(ramp, true));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(pwm.isPlaying());
+    EXPECT_FALSE(pwm.hasError());
+
+    ASSERT_TRUE(pwm.play(ramp, false));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));   // 101 samples at 10 kHz ≈ 10 ms
+    EXPECT_FALSE(pwm.isPlaying());
+
+    EXPECT_TRUE(pwm.setDutyCycle(25.0));
+    pwm.end();
+    EXPECT_FALSE(pwm.isBegun());
+}
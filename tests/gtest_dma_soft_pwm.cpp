@@ -0,0 +1,83 @@
+/**
+ * @file gtest_dma_soft_pwm.cpp
+ * @brief GoogleTest unit tests for DMA-timed multi-pin software PWM
+ *
+ * Tests tick rounding, memory sizing and argument validation. Running the
+ * DMA chain needs root on a Pi 0-4, so those tests skip elsewhere.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "dma_soft_pwm.hpp"
+#include "exceptions.hpp"
+
+using namespace pipinpp;
+
+TEST(DmaSoftPWMTest, WidthToTicks) {
+    EXPECT_EQ(DmaSoftPWM::widthToTicks(0, 10, 2000), 0u);
+    EXPECT_EQ(DmaSoftPWM::widthToTicks(1500, 10, 2000), 150u);
+    EXPECT_EQ(DmaSoftPWM::widthToTicks(1504, 10, 2000), 150u);
+    EXPECT_EQ(DmaSoftPWM::widthToTicks(1505, 10, 2000), 151u);
+    EXPECT_EQ(DmaSoftPWM::widthToTicks(20000, 10, 2000), 2000u);
+    EXPECT_EQ(DmaSoftPWM::widthToTicks(50000, 10, 2000), 2000u);   // Clamped to 100%
+}
+
+TEST(DmaSoftPWMTest, MemoryBytes) {
+    // 3 control blocks + 2 mask words per tick, plus the FIFO word
+    EXPECT_EQ(DmaSoftPWM::memoryBytes(2000), 2000u * (3 * 32 + 8) + 4);
+    EXPECT_LE(DmaSoftPWM::memoryBytes(DMA_SOFT_PWM_MAX_TICKS), 1024u * 1024u + 64u * 1024u);
+}
+
+TEST(DmaSoftPWMTest, InvalidPinThrows) {
+    auto& pwm = DmaSoftPWM::getInstance();
+    EXPECT_THROW(pwm.setDutyCycle(28, 50.0), InvalidPinError);
+    EXPECT_THROW(pwm.setDutyCycle(-1, 50.0), InvalidPinError);
+    EXPECT_THROW(pwm.setPulseWidthUs(40, 1500), InvalidPinError);
+    EXPECT_FALSE(pwm.stopPWM(28));
+    EXPECT_FALSE(pwm.isActive(28));
+    EXPECT_EQ(pwm.getDutyCycle(28), -1.0);
+}
+
+TEST(DmaSoftPWMTest, InvalidTimingRejected) {
+    auto& pwm = DmaSoftPWM::getInstance();
+    pwm.end();
+    EXPECT_FALSE(pwm.begin(20000, 1));       // Step too short
+    EXPECT_FALSE(pwm.begin(20005, 10));      // Not a multiple of the step
+    EXPECT_FALSE(pwm.begin(200000, 10));     // Too many steps
+    EXPECT_FALSE(pwm.begin(20000, 10, 15));  // Invalid DMA channel
+    EXPECT_FALSE(pwm.isBegun());
+    EXPECT_EQ(pwm.getCycleUs(), 0u);
+}
+
+TEST(DmaSoftPWMTest, InvalidDutyRejected) {
+    auto& pwm = DmaSoftPWM::getInstance();
+    EXPECT_FALSE(pwm.setDutyCycle(17, -1.0));
+    EXPECT_FALSE(pwm.setDutyCycle(17, 100.5));
+    EXPECT_FALSE(pwm.isActive(17));
+}
+
+TEST(DmaSoftPWMTest, ChannelsOnHardware) {
+    auto& pwm = DmaSoftPWM::getInstance();
+    if (!pwm.begin(20000, 10)) {
+        GTEST_SKIP() << "DMA PWM not available (needs root on a Pi 0-4)";
+    }
+
+    EXPECT_TRUE(pwm.setPulseWidthUs(17, 1500));
+    EXPECT_TRUE(pwm.setDutyCycle(27, 25.0));
+    EXPECT_TRUE(pwm.isActive(17));
+    EXPECT_EQ(pwm.getActiveCount(), 2u);
+    EXPECT_DOUBLE_EQ(pwm.getDutyCycle(17), 7.5);
+    EXPECT_DOUBLE_EQ(pwm.getDutyCycle(27), 25.0);
+
+    EXPECT_TRUE(pwm.setDutyCycle(27, 100.0));
+    EXPECT_TRUE(pwm.setDutyCycle(27, 0.0));
+    EXPECT_TRUE(pwm.stopPWM(27));
+    EXPECT_FALSE(pwm.isActive(27));
+    EXPECT_FALSE(pwm.begin(10000, 10));      // Different timing while running
+
+    pwm.end();
+    EXPECT_FALSE(pwm.isBegun());
+    EXPECT_EQ(pwm.getActiveCount(), 0u);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file gtest_edge_queue.cpp
+ * @brief GoogleTest unit tests for EdgeQueue
+ *
+ * Queues edges injected through SimulatedHardware and checks ordering,
+ * eventfd readiness, overflow accounting and detaching.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "edge_queue.hpp"
+#include "sim_backend.hpp"
+#include <poll.h>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+class EdgeQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sim().reset();
+        sim().install();
+    }
+
+    void TearDown() override {
+        sim().reset();
+        sim().uninstall();
+    }
+
+    static SimulatedHardware& sim() { return SimulatedHardware::getInstance(); }
+
+    static bool readable(int fd, int timeoutMs) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        return ::poll(&pfd, 1, timeoutMs) == 1;
+    }
+};
+
+} // namespace
+
+TEST_F(EdgeQueueTest, QueuesEdgesFromSeveralPins) {
+    EdgeQueue queue(64);
+    queue.attach(5, InterruptMode::CHANGE);
+    queue.attach(6, InterruptMode::RISING);
+    EXPECT_EQ(queue.getPins(), (std::vector<int>{5, 6}));
+
+    sim().injectEdges(5, 4, 1000);
+    sim().setInput(6, true);
+    sim().setInput(6, false);       // Falling: filtered
+
+    std::vector<EdgeEvent> events(16);
+    size_t total = 0;
+    while (total < 5 && queue.wait(2000)) {
+        total += queue.poll(events.data() + total, events.size() - total);
+    }
+    ASSERT_EQ(total, 5u);
+    int pin5 = 0;
+    for (size_t i = 0; i < total; ++i) {
+        if (events[i].pin == 5) {
+            EXPECT_EQ(events[i].lineSeqno, static_cast<unsigned long>(++pin5));
+        } else {
+            EXPECT_EQ(events[i].pin, 6);
+            EXPECT_EQ(events[i].type, EdgeType::RISING);
+        }
+    }
+    EXPECT_EQ(queue.getDroppedCount(), 0u);
+}
+
+TEST_F(EdgeQueueTest, EventFdTracksPendingEvents) {
+    EdgeQueue queue(64);
+    queue.attach(13, InterruptMode::CHANGE);
+    EXPECT_FALSE(readable(queue.fd(), 0));
+    EXPECT_FALSE(queue.wait(0));
+
+    sim().injectEdges(13, 6, 1000);
+    ASSERT_TRUE(readable(queue.fd(), 2000));
+
+    EdgeEvent events[4];
+    while (queue.size() < 6) {
+        ASSERT_TRUE(queue.wait(2000));
+    }
+    EXPECT_EQ(queue.poll(events, 4), 4u);
+    EXPECT_TRUE(readable(queue.fd(), 0));   // Two left
+    EXPECT_EQ(queue.poll(events, 4), 2u);
+    EXPECT_FALSE(readable(queue.fd(), 0));
+}
+
+TEST_F(EdgeQueueTest, FullQueueDropsAndCounts) {
+    EdgeQueue queue(8);
+    queue.attach(19, InterruptMode::CHANGE, 64);
+    sim().injectEdges(19, 20, 1000);
+    while (queue.size() + queue.getDroppedCount() < 20) {
+        ASSERT_TRUE(queue.wait(2000));
+    }
+    EXPECT_EQ(queue.size(), 8u);
+    EXPECT_EQ(queue.getDroppedCount(), 12u);
+
+    EdgeEvent events[16];
+    ASSERT_EQ(queue.poll(events, 16), 8u);
+    EXPECT_EQ(events[0].lineSeqno, 1u);     // The oldest are kept
+}
+
+TEST_F(EdgeQueueTest, DetachStopsQueueingAndFreesThePin) {
+    EdgeQueue queue(64);
+    queue.attach(21, InterruptMode::CHANGE);
+    EXPECT_THROW(queue.attach(21, InterruptMode::CHANGE), std::exception);
+    EXPECT_TRUE(queue.detach(21));
+    EXPECT_FALSE(queue.detach(21));
+    EXPECT_FALSE(InterruptManager::getInstance().isAttached(21));
+
+    sim().setInput(21, true);
+    EXPECT_FALSE(queue.wait(20));
+}
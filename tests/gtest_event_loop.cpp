@@ -0,0 +1,139 @@
+/**
+ * @file gtest_event_loop.cpp
+ * @brief GoogleTest unit tests for the single-threaded epoll EventLoop
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "event_loop.hpp"
+#include "sim_backend.hpp"
+#include <sys/epoll.h>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace pipinpp;
+
+class EventLoopTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+    }
+
+    void TearDown() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+
+    /**
+     * @brief runOnce() until @p done or two seconds pass
+     */
+    static void runUntil(EventLoop& loop, const std::function<bool()>& done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            loop.runOnce(50);
+        }
+    }
+};
+
+TEST_F(EventLoopTest, DeliversPinEdges) {
+    EventLoop loop;
+    Pin input(17, PinDirection::INPUT);
+    std::vector<PinEdgeEvent> edges;
+    int id = loop.addPin(input, [&](const PinEdgeEvent& edge) { edges.push_back(edge); });
+    ASSERT_GT(id, 0);
+    EXPECT_TRUE(input.edgeEventsEnabled());
+    EXPECT_GE(input.getEventFd(), 0);
+
+    SimulatedHardware::getInstance().setInput(17, true);
+    SimulatedHardware::getInstance().setInput(17, false);
+    runUntil(loop, [&] { return edges.size() >= 2; });
+    ASSERT_EQ(edges.size(), 2u);
+    EXPECT_TRUE(edges[0].rising);
+    EXPECT_FALSE(edges[1].rising);
+    EXPECT_LE(edges[0].timestampNs, edges[1].timestampNs);
+
+    Pin output(18, PinDirection::OUTPUT);
+    EXPECT_EQ(loop.addPin(output, [](const PinEdgeEvent&) {}), -1);
+    EXPECT_EQ(output.getEventFd(), -1);
+}
+
+TEST_F(EventLoopTest, RunsTimersAtFixedRate) {
+    EventLoop loop;
+    int ticks = 0;
+    int once = 0;
+    int periodic = loop.every(2000, [&] { ++ticks; });
+    ASSERT_GT(periodic, 0);
+    ASSERT_GT(loop.after(1000, [&] { ++once; }), 0);
+    EXPECT_EQ(loop.size(), 2u);
+
+    runUntil(loop, [&] { return ticks >= 5; });
+    EXPECT_GE(ticks, 5);
+    EXPECT_EQ(once, 1);
+    EXPECT_EQ(loop.size(), 1u);            // One-shot removed itself
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));   // Miss some periods
+    loop.runOnce(50);
+    EXPECT_GE(loop.getTimerOverruns(periodic), 1u);
+    EXPECT_EQ(loop.every(0, [] {}), -1);
+}
+
+TEST_F(EventLoopTest, WatchesUserFdsAndAllowsRemovalFromCallbacks) {
+    EventLoop loop;
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    int reads = 0;
+    int id = -1;
+    id = loop.addFd(fds[0], EPOLLIN, [&](uint32_t events) {
+        EXPECT_TRUE(events & EPOLLIN);
+        char byte;
+        EXPECT_EQ(read(fds[0], &byte, 1), 1);
+        ++reads;
+        loop.remove(id);                   // Removing itself is safe
+    });
+    ASSERT_GT(id, 0);
+
+    ASSERT_EQ(write(fds[1], "xy", 2), 2);
+    EXPECT_EQ(loop.runOnce(1000), 1);
+    EXPECT_EQ(reads, 1);
+    EXPECT_EQ(loop.runOnce(20), 0);        // Still readable, but no longer watched
+    EXPECT_FALSE(loop.remove(id));
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_F(EventLoopTest, StopWakesRunFromAnotherThread) {
+    EventLoop loop;
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        loop.stop();
+    });
+    loop.run();                            // Returns instead of blocking forever
+    stopper.join();
+
+    loop.stop();                           // Pending stop: next run() returns at once
+    loop.run();
+    SUCCEED();
+}
+
+TEST_F(EventLoopTest, PostAndRunBlockingCompleteOnTheLoopThread) {
+    EventLoop loop;
+    std::thread::id loopThread = std::this_thread::get_id();
+    std::thread::id workThread;
+    bool posted = false;
+    bool done = false;
+
+    std::thread poster([&] { loop.post([&] { posted = std::this_thread::get_id() == loopThread; }); });
+    poster.join();
+    loop.runBlocking([&] { workThread = std::this_thread::get_id(); },
+                     [&] { done = std::this_thread::get_id() == loopThread; });
+    runUntil(loop, [&] { return posted && done; });
+    EXPECT_TRUE(posted);
+    EXPECT_TRUE(done);
+    EXPECT_NE(workThread, loopThread);
+    EXPECT_EQ(loop.size(), 0u);            // Posted calls are not sources
+}
@@ -777,3 +777,81 @@ TEST_F(EventPWMTest, StressLongRunDuration) {
         GTEST_SKIP() << "GPIO access unavailable: " << e.what();
     }
 }
+
+// ============================================================================
+// EventPWMSchedule Tests (no hardware: edge heap only)
+// ============================================================================
+
+// 10 kHz: 100000 ns period
+constexpr int64_t SCHEDULE_PERIOD_NS = 100000;
+
+TEST(EventPWMScheduleTest, HalfDutyAlternatesHighAndLow) {
+    EventPWMSchedule schedule;
+    schedule.add(128, 10000);
+    schedule.restart(0);
+    
+    uint64_t mask = 0;
+    uint64_t values = 0;
+    schedule.takeDue(0, mask, values);
+    EXPECT_EQ(mask, 1u);
+    EXPECT_EQ(values, 1u);
+    
+    // Falling edge at 128/255 of the period
+    int64_t fall = schedule.nextDeadlineNs();
+    EXPECT_EQ(fall, SCHEDULE_PERIOD_NS * 128 / 255);
+    schedule.takeDue(fall, mask, values);
+    EXPECT_EQ(mask, 1u);
+    EXPECT_EQ(values, 0u);
+    
+    EXPECT_EQ(schedule.nextDeadlineNs(), SCHEDULE_PERIOD_NS);
+}
+
+// Rising and falling edge in one coalesced write: the line must end LOW
+TEST(EventPWMScheduleTest, CoalescedShortPulseEndsLow) {
+    EventPWMSchedule schedule;
+    schedule.add(1, 10000);                     // 392 ns on-time, under EDGE_COALESCE_NS
+    schedule.restart(0);
+    
+    uint64_t mask = 0;
+    uint64_t values = 0;
+    schedule.takeDue(0, mask, values);
+    EXPECT_EQ(mask, 1u);
+    EXPECT_EQ(values, 0u);
+    EXPECT_EQ(schedule.nextDeadlineNs(), SCHEDULE_PERIOD_NS);
+}
+
+TEST(EventPWMScheduleTest, CoalescedEdgesOnlyClearTheirOwnLine) {
+    EventPWMSchedule schedule;
+    schedule.add(1, 10000);
+    schedule.add(128, 10000);
+    schedule.restart(0);
+    
+    uint64_t mask = 0;
+    uint64_t values = 0;
+    schedule.takeDue(0, mask, values);
+    EXPECT_EQ(mask, 3u);
+    EXPECT_EQ(values, 2u);
+}
+
+TEST(EventPWMScheduleTest, HeldChannelRestartsOnUpdate) {
+    EventPWMSchedule schedule;
+    schedule.add(255, 10000);
+    schedule.restart(0);
+    
+    uint64_t mask = 0;
+    uint64_t values = 0;
+    schedule.takeDue(0, mask, values);
+    EXPECT_EQ(values, 1u);
+    EXPECT_TRUE(schedule.idle());
+    
+    EXPECT_TRUE(schedule.update(0, 0, 10000, 5000));
+    EXPECT_EQ(schedule.nextDeadlineNs(), 5000);
+    schedule.takeDue(5000, mask, values);
+    EXPECT_EQ(mask, 1u);
+    EXPECT_EQ(values, 0u);
+    EXPECT_TRUE(schedule.idle());
+    
+    // A running channel picks the change up at its next cycle instead
+    schedule.update(0, 64, 10000, 6000);
+    EXPECT_FALSE(schedule.update(0, 128, 10000, 7000));
+}
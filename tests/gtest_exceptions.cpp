@@ -33,6 +33,9 @@
 #include "pin.hpp"
 #include "ArduinoCompat.hpp"
 #include "exceptions.hpp"
+#include "SPI.hpp"
+#include "Wire.hpp"
+#include "error_code.hpp"
 #include <gtest/gtest.h>
 
 /**
@@ -171,3 +174,34 @@ TEST(ExceptionTest, ExceptionsInheritFromStdException) {
         EXPECT_NE(std::string(e.what()).length(), 0);
     }
 }
+
+/**
+ * Test the exception-free variants: error codes instead of throws
+ */
+TEST(ErrorCodeTest, TryVariantsReportErrorsWithoutThrowing) {
+    using pipinpp::GpioErrc;
+    int value = -1;
+    EXPECT_EQ(tryDigitalWrite(999, HIGH), GpioErrc::INVALID_PIN);
+    EXPECT_EQ(tryDigitalRead(-1, value), GpioErrc::INVALID_PIN);
+    EXPECT_EQ(tryDigitalWrite(26, HIGH), GpioErrc::NOT_CONFIGURED);
+    EXPECT_EQ(tryDigitalToggle(26), GpioErrc::NOT_CONFIGURED);
+    EXPECT_EQ(value, -1);
+
+    uint8_t buffer[4] = {};
+    pipinpp::SPIClass spi;
+    EXPECT_EQ(spi.tryTransfer(buffer, buffer, sizeof(buffer)), GpioErrc::NOT_OPEN);
+    EXPECT_EQ(spi.tryTransfer(nullptr, nullptr, sizeof(buffer)), GpioErrc::INVALID_ARGUMENT);
+
+    pipinpp::WireClass wire;
+    EXPECT_EQ(wire.tryReadRegisters(0x68, 0x3B, buffer, sizeof(buffer)), GpioErrc::NOT_OPEN);
+    EXPECT_EQ(wire.tryWriteRegisters(0x68, 0x1B, buffer, 0), GpioErrc::INVALID_ARGUMENT);
+}
+
+TEST(ErrorCodeTest, CategoryMapsToPortableConditions) {
+    std::error_code error = pipinpp::GpioErrc::INVALID_PIN;
+    EXPECT_STREQ(error.category().name(), "pipinpp");
+    EXPECT_EQ(error, std::errc::invalid_argument);
+    EXPECT_EQ(std::error_code(pipinpp::GpioErrc::NOT_OPEN), std::errc::bad_file_descriptor);
+    EXPECT_FALSE(error.message().empty());
+    EXPECT_FALSE(std::error_code());
+}
@@ -0,0 +1,140 @@
+/**
+ * @file gtest_fade_engine.cpp
+ * @brief GoogleTest unit tests for FadeEngine
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "fade_engine.hpp"
+#include "exceptions.hpp"
+#include "timebase.hpp"
+#include "timer_manager.hpp"
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+struct Recorder {
+    std::map<int, std::vector<uint8_t>> writes;
+
+    FadeOutput output() {
+        return [this](int pin, uint8_t value) { writes[pin].push_back(value); };
+    }
+};
+
+constexpr int64_t MS = 1000000;
+
+} // namespace
+
+TEST(FadeEngineTest, CurvesHitTheirEndpoints) {
+    for (FadeCurve curve : {FadeCurve::LINEAR, FadeCurve::EASE_IN, FadeCurve::EASE_OUT, FadeCurve::EASE_IN_OUT}) {
+        EXPECT_EQ(FadeEngine::curveProgress(curve, 0), 0u);
+        EXPECT_EQ(FadeEngine::curveProgress(curve, 65536), 65536u);
+        uint32_t previous = 0;
+        for (uint32_t p = 0; p <= 65536; p += 512) {
+            uint32_t value = FadeEngine::curveProgress(curve, p);
+            ASSERT_GE(value, previous);             // Monotonic
+            previous = value;
+        }
+    }
+    EXPECT_EQ(FadeEngine::curveProgress(FadeCurve::EASE_IN, 32768), 16384u);
+    EXPECT_EQ(FadeEngine::curveProgress(FadeCurve::EASE_OUT, 32768), 49152u);
+    EXPECT_EQ(FadeEngine::curveProgress(FadeCurve::EASE_IN_OUT, 32768), 32768u);
+}
+
+TEST(FadeEngineTest, GammaTable) {
+    Recorder recorder;
+    TimerManager timers;
+    FadeEngine engine(recorder.output(), &timers);
+    EXPECT_EQ(engine.gammaCorrect(0), 0);
+    EXPECT_EQ(engine.gammaCorrect(255), 255);
+    EXPECT_LT(engine.gammaCorrect(128), 64);       // 2.2: half brightness is ~22% duty
+    EXPECT_FALSE(engine.setGamma(0.0));
+    EXPECT_TRUE(engine.setGamma(1.0));
+    EXPECT_EQ(engine.gammaCorrect(128), 128);
+}
+
+TEST(FadeEngineTest, StepsLinearFadeAndSkipsUnchangedValues) {
+    Recorder recorder;
+    TimerManager timers;
+    FadeEngine engine(recorder.output(), &timers);
+    engine.setGamma(1.0);
+    engine.setTickUs(1000000);                     // Keep the timer out of the way
+
+    const int64_t start = monotonicNowNs();
+    engine.fadeTo(17, 200, 1000);
+    EXPECT_TRUE(engine.isFading(17));
+    EXPECT_EQ(engine.getActiveCount(), 1u);
+
+    EXPECT_TRUE(engine.step(start + 500 * MS));
+    EXPECT_NEAR(engine.getBrightness(17), 100, 1);
+    EXPECT_TRUE(engine.step(start + 500 * MS));    // Same value: not written again
+    ASSERT_EQ(recorder.writes[17].size(), 1u);
+
+    EXPECT_FALSE(engine.step(start + 1500 * MS));
+    EXPECT_EQ(recorder.writes[17].back(), 200);
+    EXPECT_FALSE(engine.isFading(17));
+    EXPECT_EQ(engine.getActiveCount(), 0u);
+
+    // A new fade starts from where the pin is
+    const int64_t second = monotonicNowNs();
+    engine.fadeTo(17, 0, 1000, FadeCurve::EASE_IN);
+    engine.step(second + 500 * MS);
+    EXPECT_NEAR(engine.getBrightness(17), 150, 1);   // A quarter of the way down
+}
+
+TEST(FadeEngineTest, SetAndStop) {
+    Recorder recorder;
+    TimerManager timers;
+    FadeEngine engine(recorder.output(), &timers);
+    engine.setGamma(1.0);
+
+    engine.set(18, 77);
+    EXPECT_EQ(recorder.writes[18], std::vector<uint8_t>{77});
+    EXPECT_EQ(engine.getBrightness(18), 77);
+
+    engine.fadeTo(18, 255, 60000);
+    EXPECT_TRUE(engine.stop(18));
+    EXPECT_FALSE(engine.stop(18));
+    EXPECT_FALSE(engine.step(monotonicNowNs() + 30000 * MS));
+    EXPECT_EQ(engine.getBrightness(18), 77);
+
+    EXPECT_THROW(engine.fadeTo(99, 1, 10), InvalidPinError);
+    EXPECT_THROW(engine.set(-1, 1), InvalidPinError);
+}
+
+TEST(FadeEngineTest, TimerRunsManyFadesThenGoesIdle) {
+    std::mutex mutex;
+    std::map<int, uint8_t> last;
+    TimerManager timers;
+    FadeEngine engine([&](int pin, uint8_t value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        last[pin] = value;
+    }, &timers);
+    engine.setTickUs(2000);
+
+    for (int pin = 0; pin < 24; ++pin) {
+        engine.fadeTo(pin, 255, 50, static_cast<FadeCurve>(pin % 4));
+    }
+    EXPECT_EQ(timers.size(), 1u);                   // One task for every pin
+    for (int i = 0; i < 200 && engine.getActiveCount() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(engine.getActiveCount(), 0u);
+    for (int i = 0; i < 100 && timers.size() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(timers.size(), 0u);                   // Idle: task cancelled
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(last.size(), 24u);
+    for (const auto& entry : last) {
+        EXPECT_EQ(entry.second, 255) << "pin " << entry.first;
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file gtest_fast_pin.cpp
+ * @brief GoogleTest unit tests for FastPin / StaticPin
+ *
+ * The simulated chip has no register mapping, so the libgpiod variant is
+ * exercised end to end and the GPIOMEM variant is checked to refuse
+ * construction rather than fall back.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "fast_pin.hpp"
+#include "sim_backend.hpp"
+#include <type_traits>
+
+using namespace pipinpp;
+
+static_assert(FastPin<PinBackend::LIBGPIOD, 17>::mask == (1u << 17), "mask is a constant");
+static_assert(StaticPin<4>::backend == PinBackend::GPIOMEM, "StaticPin uses registers");
+static_assert(!std::is_copy_constructible<StaticPin<4>>::value, "one owner per line");
+
+namespace {
+
+class FastPinTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sim().reset();
+        sim().install();
+    }
+
+    void TearDown() override {
+        sim().reset();
+        sim().uninstall();
+    }
+
+    static SimulatedHardware& sim() { return SimulatedHardware::getInstance(); }
+};
+
+} // namespace
+
+TEST_F(FastPinTest, SetClearToggle) {
+    FastPin<PinBackend::LIBGPIOD, 17> pin;
+    EXPECT_EQ(sim().getLevel(17), 0);
+
+    pin.set();
+    EXPECT_EQ(sim().getLevel(17), 1);
+    EXPECT_TRUE(pin.getOutputState());
+    pin.clear();
+    EXPECT_EQ(sim().getLevel(17), 0);
+
+    pin.toggle();
+    EXPECT_EQ(sim().getLevel(17), 1);
+    pin.toggle();
+    EXPECT_EQ(sim().getLevel(17), 0);
+    EXPECT_EQ(sim().getWriteCount(17), 4u);
+}
+
+TEST_F(FastPinTest, ReadsInput) {
+    FastPin<PinBackend::LIBGPIOD, 22> pin(PinMode::INPUT);
+    sim().setInput(22, true);
+    EXPECT_EQ(pin.read(), 1);
+    sim().setInput(22, false);
+    EXPECT_EQ(pin.read(), 0);
+}
+
+TEST_F(FastPinTest, ReleasesLineOnDestruction) {
+    {
+        FastPin<PinBackend::LIBGPIOD, 5> pin;
+        EXPECT_THROW((FastPin<PinBackend::LIBGPIOD, 5>()), GpioAccessError);
+    }
+    EXPECT_NO_THROW((FastPin<PinBackend::LIBGPIOD, 5>()));
+}
+
+TEST_F(FastPinTest, RegisterBackendDoesNotFallBack) {
+    EXPECT_THROW(StaticPin<6>(), GpioAccessError);
+    // The line was released again
+    EXPECT_NO_THROW((FastPin<PinBackend::LIBGPIOD, 6>()));
+}
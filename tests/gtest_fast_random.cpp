@@ -0,0 +1,135 @@
+/**
+ * @file gtest_fast_random.cpp
+ * @brief GoogleTest unit tests for the per-thread random() engines
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "ArduinoCompat.hpp"
+#include "fast_random.hpp"
+#include <climits>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+std::vector<long> draw(size_t count) {
+    std::vector<long> values(count);
+    for (long& value : values) {
+        value = random(1000000);
+    }
+    return values;
+}
+
+std::vector<long> drawOnNewThread(uint32_t index) {
+    std::vector<long> values;
+    std::thread worker([&] {
+        setRandomStreamIndex(index);
+        values = draw(16);
+    });
+    worker.join();
+    return values;
+}
+
+} // namespace
+
+TEST(FastRandomTest, SameSeedRepeatsSequence) {
+    randomSeed(42);
+    std::vector<long> first = draw(64);
+    randomSeed(42);
+    EXPECT_EQ(draw(64), first);
+    randomSeed(43);
+    EXPECT_NE(draw(64), first);
+}
+
+TEST(FastRandomTest, StreamIndexReproducesAcrossThreads) {
+    randomSeed(7);
+    std::vector<long> a = drawOnNewThread(3);
+    std::vector<long> b = drawOnNewThread(3);
+    std::vector<long> c = drawOnNewThread(4);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+
+    // The seed changes every stream
+    randomSeed(8);
+    EXPECT_NE(drawOnNewThread(3), a);
+}
+
+TEST(FastRandomTest, ThreadsGetDistinctStreams) {
+    randomSeed(1);
+    constexpr int THREADS = 4;
+    std::vector<std::vector<long>> results(THREADS);
+    std::vector<uint32_t> indices(THREADS);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < 10000; ++i) {   // Concurrent callers, no shared lock
+                random(10);
+            }
+            results[t] = draw(16);
+            indices[t] = getRandomStreamIndex();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(std::set<uint32_t>(indices.begin(), indices.end()).size(), static_cast<size_t>(THREADS));
+    EXPECT_EQ(std::set<std::vector<long>>(results.begin(), results.end()).size(), static_cast<size_t>(THREADS));
+}
+
+TEST(FastRandomTest, RangesAndEdgeCases) {
+    randomSeed(99);
+    EXPECT_EQ(random(0), 0);
+    EXPECT_EQ(random(-5), 0);
+    EXPECT_EQ(random(10, 10), 10);
+    EXPECT_EQ(random(10, 3), 10);
+    for (int i = 0; i < 1000; ++i) {
+        long value = random(-3, 4);
+        ASSERT_GE(value, -3);
+        ASSERT_LT(value, 4);
+        long wide = random(LONG_MIN, LONG_MAX);   // Range wider than a long
+        ASSERT_LT(wide, LONG_MAX);
+        long big = random(1L << 40);
+        ASSERT_GE(big, 0);
+        ASSERT_LT(big, 1L << 40);
+    }
+}
+
+TEST(FastRandomTest, RoughlyUniform) {
+    randomSeed(2025);
+    constexpr int BUCKETS = 10;
+    constexpr int SAMPLES = 100000;
+    int counts[BUCKETS] = {};
+    for (int i = 0; i < SAMPLES; ++i) {
+        ++counts[random(BUCKETS)];
+    }
+    for (int count : counts) {
+        EXPECT_NEAR(count, SAMPLES / BUCKETS, SAMPLES / BUCKETS / 10);
+    }
+}
+
+TEST(FastRandomTest, FillRandomMatchesRangeAndSequence) {
+    randomSeed(5);
+    std::vector<long> values(1000);
+    fillRandom(values.data(), values.size(), -2, 3);
+    std::set<long> seen(values.begin(), values.end());
+    EXPECT_EQ(seen, (std::set<long>{-2, -1, 0, 1, 2}));
+
+    fillRandom(values.data(), 4, 9, 9);
+    EXPECT_EQ(values[0], 9);
+    EXPECT_EQ(values[3], 9);
+
+    // Same seed, same bytes; odd lengths fill the tail
+    uint8_t a[13] = {}, b[13] = {};
+    randomSeed(6);
+    fillRandom(a, sizeof(a));
+    randomSeed(6);
+    fillRandom(b, sizeof(b));
+    EXPECT_EQ(std::vector<uint8_t>(a, a + 13), std::vector<uint8_t>(b, b + 13));
+    EXPECT_NE(std::vector<uint8_t>(a, a + 13), std::vector<uint8_t>(13, 0));
+}
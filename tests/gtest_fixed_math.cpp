@@ -0,0 +1,114 @@
+/**
+ * @file gtest_fixed_math.cpp
+ * @brief GoogleTest unit tests for block map()/constrain() and FixedMap
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "ArduinoCompat.hpp"
+#include "fixed_math.hpp"
+#include <cstdlib>
+#include <vector>
+
+using pipinpp::FixedMap;
+
+namespace {
+
+struct Ranges {
+    long inMin, inMax, outMin, outMax;
+};
+
+// ADC widths, reversed and negative ranges, expansion and compression
+const Ranges RANGES[] = {
+    {0, 1023, 0, 255},     {0, 4095, 0, 3300},       {-32768, 32767, 0, 1000},
+    {0, 1023, 255, 0},     {1023, 0, -100, 100},     {-100, 100, -32768, 32767},
+    {0, 3, 0, 1},          {0, 100, 0, 1000000},     {-50, -10, -200, -20},
+    {7, 7, 42, 99},
+};
+
+std::vector<int16_t> everyInt16() {
+    std::vector<int16_t> values;
+    for (int v = INT16_MIN; v <= INT16_MAX; ++v) {
+        values.push_back(static_cast<int16_t>(v));
+    }
+    return values;
+}
+
+int16_t saturate(long v) {
+    return static_cast<int16_t>(v < INT16_MIN ? INT16_MIN : (v > INT16_MAX ? INT16_MAX : v));
+}
+
+} // namespace
+
+TEST(FixedMathTest, ScalarHelpersAreConstexpr) {
+    static_assert(map(512, 0, 1023, 0, 255) == 127, "map() folds at compile time");
+    static_assert(constrain(300, 0, 255) == 255, "constrain() folds at compile time");
+    static_assert(constrain(5, 10, 0) == 10, "inverted range keeps its behaviour");
+    constexpr FixedMap adc(0, 4095, 0, 3300);
+    static_assert(adc(4095) == 3300, "FixedMap folds at compile time");
+    static_assert(FixedMap(5, 5, 9, 10)(123) == 9, "empty input range maps to out_min");
+    SUCCEED();
+}
+
+TEST(FixedMathTest, BlockMapMatchesScalarMap) {
+    std::vector<int16_t> in = everyInt16();
+    std::vector<int16_t> out(in.size());
+    for (const Ranges& r : RANGES) {
+        map(in.data(), out.data(), in.size(), r.inMin, r.inMax, r.outMin, r.outMax);
+        for (size_t i = 0; i < in.size(); ++i) {
+            ASSERT_EQ(out[i], saturate(map(in[i], r.inMin, r.inMax, r.outMin, r.outMax)))
+                << "x=" << in[i] << " range " << r.inMin << ".." << r.inMax << " -> " << r.outMin << ".." << r.outMax;
+        }
+    }
+
+    // Too large for the exact double path: takes the scalar fallback
+    int16_t small[3] = {0, 1, 2};
+    map(small, small, 3, 0, 2, 0, 1L << 50);   // In place
+    EXPECT_EQ(small[0], 0);
+    EXPECT_EQ(small[1], INT16_MAX);
+}
+
+TEST(FixedMathTest, BlockConstrainMatchesScalar) {
+    std::vector<int16_t> in = everyInt16();
+    std::vector<int16_t> out(in.size());
+    constrain(in.data(), out.data(), in.size(), -100, 2000);
+    for (size_t i = 0; i < in.size(); ++i) {
+        ASSERT_EQ(out[i], constrain(in[i], -100, 2000));
+    }
+    constrain(in.data(), in.data(), in.size(), 10, 0);   // Inverted range, in place
+    EXPECT_EQ(in.front(), 10);
+    EXPECT_EQ(in.back(), 0);
+
+    float values[4] = {-1.5f, 0.25f, 0.75f, 9.0f};
+    constrain(values, values, 4, 0.0f, 1.0f);
+    EXPECT_FLOAT_EQ(values[0], 0.0f);
+    EXPECT_FLOAT_EQ(values[1], 0.25f);
+    EXPECT_FLOAT_EQ(values[3], 1.0f);
+}
+
+TEST(FixedMathTest, FixedMapIsExactWithinItsBound) {
+    // 10- and 12-bit ADC ranges are well within 2^shift(): identical to map()
+    const Ranges adcRanges[] = {{0, 1023, 0, 255}, {0, 4095, 0, 3300}, {0, 1023, 255, 0}, {0, 3, 0, 1}};
+    for (const Ranges& r : adcRanges) {
+        FixedMap fixed(r.inMin, r.inMax, r.outMin, r.outMax);
+        for (long x = std::min(r.inMin, r.inMax); x <= std::max(r.inMin, r.inMax); ++x) {
+            ASSERT_EQ(fixed(x), map(x, r.inMin, r.inMax, r.outMin, r.outMax)) << "x=" << x;
+        }
+    }
+}
+
+TEST(FixedMathTest, FixedMapStaysWithinOneStepOfMap) {
+    std::vector<int16_t> in = everyInt16();
+    std::vector<int16_t> out(in.size());
+    for (const Ranges& r : RANGES) {
+        FixedMap fixed(r.inMin, r.inMax, r.outMin, r.outMax);
+        fixed.apply(in.data(), out.data(), in.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            long exact = map(in[i], r.inMin, r.inMax, r.outMin, r.outMax);
+            ASSERT_LE(std::labs(fixed(in[i]) - exact), 1) << "x=" << in[i] << " range " << r.inMin << ".." << r.inMax;
+            ASSERT_EQ(out[i], saturate(fixed(in[i])));
+        }
+    }
+}
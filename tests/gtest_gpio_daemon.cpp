@@ -0,0 +1,180 @@
+/**
+ * @file gtest_gpio_daemon.cpp
+ * @brief GoogleTest unit tests for the pipinppd daemon and its client backend
+ *
+ * Runs a GpioDaemon on simulated chips in the test process and connects
+ * GpioDaemonClient to it, so Pin, InterruptManager and PWMManager go
+ * through the socket and the shared rings: queued writes, reads, lines
+ * shared by two requests, per-holder edge filtering and release.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "gpio_daemon.hpp"
+#include "interrupts.hpp"
+#include "pin.hpp"
+#include "pwm.hpp"
+#include "sim_backend.hpp"
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+using namespace pipinpp;
+
+namespace {
+
+class GpioDaemonTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sim().reset();
+        path_ = "/tmp/pipinppd-test-" + std::to_string(getpid()) + ".sock";
+        daemon_ = std::make_unique<GpioDaemon>(
+            path_, [](const std::string& name) { return sim().openChip(name); });
+        ASSERT_TRUE(daemon_->start());
+        ASSERT_TRUE(GpioDaemonClient::getInstance().connect(path_));
+    }
+
+    void TearDown() override {
+        GpioDaemonClient::getInstance().disconnect();
+        daemon_.reset();
+        sim().reset();
+    }
+
+    static SimulatedHardware& sim() { return SimulatedHardware::getInstance(); }
+
+    static bool eventually(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    std::string path_;
+    std::unique_ptr<GpioDaemon> daemon_;
+};
+
+} // namespace
+
+TEST_F(GpioDaemonTest, ClientConnects) {
+    EXPECT_TRUE(daemon_->isRunning());
+    EXPECT_TRUE(GpioDaemonClient::getInstance().isConnected());
+    EXPECT_EQ(daemon_->getClientCount(), 1u);
+}
+
+TEST_F(GpioDaemonTest, ConnectFailsWithoutDaemon) {
+    GpioDaemonClient::getInstance().disconnect();
+    EXPECT_FALSE(GpioDaemonClient::getInstance().connect("/tmp/pipinppd-test-missing.sock"));
+    EXPECT_FALSE(GpioDaemonClient::getInstance().isConnected());
+}
+
+TEST_F(GpioDaemonTest, OutputWritesReachTheDaemonsLines) {
+    Pin out(17, PinDirection::OUTPUT);
+    EXPECT_TRUE(out.write(true));
+    EXPECT_TRUE(eventually([] { return sim().getLevel(17) == 1; }));
+    EXPECT_TRUE(out.write(false));
+    EXPECT_TRUE(eventually([] { return sim().getLevel(17) == 0; }));
+    EXPECT_EQ(daemon_->getRequestCount(), 1u);
+}
+
+TEST_F(GpioDaemonTest, ReadsFollowQueuedWrites) {
+    Pin out(17, PinDirection::OUTPUT);
+    for (int i = 0; i < 100; ++i) {
+        out.write(i % 2 == 0);
+    }
+    // The read is queued behind the writes, so it sees the last one
+    Pin in(27, PinDirection::INPUT);
+    sim().setInput(27, true);
+    EXPECT_EQ(in.read(), 1);
+    EXPECT_EQ(sim().getLevel(17), 0);
+    EXPECT_EQ(sim().getWriteCount(17), 100u);
+    EXPECT_EQ(GpioDaemonClient::getInstance().getFailedWrites(), 0u);
+}
+
+TEST_F(GpioDaemonTest, TwoRequestsShareOneLine) {
+    Pin writer(22, PinDirection::OUTPUT);
+    Pin reader(22, PinDirection::INPUT);    // The kernel alone would refuse this
+    EXPECT_TRUE(writer.write(true));
+    EXPECT_EQ(reader.read(), 1);
+    EXPECT_TRUE(writer.write(false));
+    EXPECT_EQ(reader.read(), 0);
+}
+
+TEST_F(GpioDaemonTest, ReleasingTheLastHolderReleasesTheLine) {
+    {
+        Pin writer(22, PinDirection::OUTPUT);
+        Pin reader(22, PinDirection::INPUT);
+        EXPECT_EQ(daemon_->getRequestCount(), 2u);
+    }
+    EXPECT_EQ(daemon_->getRequestCount(), 0u);
+
+    // Free again: a fresh request reconfigures it as an input
+    Pin in(22, PinDirection::INPUT);
+    sim().setInput(22, true);
+    EXPECT_EQ(in.read(), 1);
+}
+
+TEST_F(GpioDaemonTest, DisconnectedClientIsForgotten) {
+    GpioDaemonClient::getInstance().disconnect();
+    EXPECT_TRUE(eventually([this] { return daemon_->getClientCount() == 0; }));
+}
+
+TEST_F(GpioDaemonTest, InterruptCallbacksFireFromForwardedEdges) {
+    std::atomic<int> calls{0};
+    InterruptManager::getInstance().attachInterrupt(
+        6, [&calls] { calls.fetch_add(1); }, InterruptMode::RISING);
+
+    sim().setInput(6, true);
+    sim().setInput(6, false);   // Falling: not asked for
+    sim().setInput(6, true);
+    EXPECT_TRUE(eventually([&calls] { return calls.load() >= 2; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(calls.load(), 2);
+
+    InterruptManager::getInstance().detachInterrupt(6);
+}
+
+TEST_F(GpioDaemonTest, EachHolderGetsOnlyItsEdges) {
+    std::atomic<int> rising{0};
+    InterruptManager::getInstance().attachInterrupt(
+        13, [&rising] { rising.fetch_add(1); }, InterruptMode::RISING);
+    Pin watcher(13, PinDirection::INPUT);
+    ASSERT_TRUE(watcher.enableEdgeEvents());
+
+    sim().setInput(13, true);
+    sim().setInput(13, false);
+    sim().setInput(13, true);
+
+    PinEdgeEvent events[8];
+    int total = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (total < 3 && std::chrono::steady_clock::now() < deadline) {
+        int n = watcher.waitEdgeEvents(events + total, 8 - static_cast<size_t>(total), 100000000);
+        ASSERT_GE(n, 0);
+        total += n;
+    }
+    ASSERT_EQ(total, 3);
+    EXPECT_TRUE(events[0].rising);
+    EXPECT_FALSE(events[1].rising);
+    EXPECT_TRUE(events[2].rising);
+    EXPECT_TRUE(eventually([&rising] { return rising.load() >= 2; }));
+    EXPECT_EQ(rising.load(), 2);
+
+    InterruptManager::getInstance().detachInterrupt(13);
+}
+
+TEST_F(GpioDaemonTest, SoftwarePwmRunsThroughTheDaemon) {
+    PWMManager& pwm = PWMManager::getInstance();
+    pwm.startPWM(18, 128, 500);
+    EXPECT_TRUE(eventually([] { return sim().getWriteCount(18) >= 20; }));
+    EXPECT_TRUE(pwm.stopPWM(18));
+    EXPECT_EQ(GpioDaemonClient::getInstance().getFailedWrites(), 0u);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file gtest_gpiomem.cpp
+ * @brief GoogleTest unit tests for the /dev/gpiomem register backend
+ *
+ * Layout detection runs everywhere; register access tests are skipped
+ * when no GPIO hardware is available.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "gpiomem.hpp"
+#include "pin.hpp"
+#include "exceptions.hpp"
+
+using namespace pipinpp;
+
+TEST(GpioMemLayoutTest, DetectsBcmLabels) {
+    EXPECT_EQ(GpioMem::layoutForLabel("pinctrl-bcm2835"), GpioMemLayout::BCM2835);
+    EXPECT_EQ(GpioMem::layoutForLabel("pinctrl-bcm2711"), GpioMemLayout::BCM2835);
+}
+
+TEST(GpioMemLayoutTest, DetectsRp1Label) {
+    EXPECT_EQ(GpioMem::layoutForLabel("pinctrl-rp1"), GpioMemLayout::RP1);
+}
+
+TEST(GpioMemLayoutTest, RejectsUnknownControllers) {
+    EXPECT_EQ(GpioMem::layoutForLabel(""), GpioMemLayout::NONE);
+    EXPECT_EQ(GpioMem::layoutForLabel("gpio-mockup-A"), GpioMemLayout::NONE);
+    EXPECT_EQ(GpioMem::layoutForLabel("raspberrypi-exp-gpio"), GpioMemLayout::NONE);
+    EXPECT_EQ(GpioMem::forChipLabel("gpio-mockup-A"), nullptr);
+}
+
+class GpioMemHardwareTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        try {
+            Pin probe(17, PinDirection::OUTPUT);
+        }
+        catch (const GpioAccessError& e) {
+            GTEST_SKIP() << "GPIO hardware not available: " << e.what();
+        }
+    }
+};
+
+TEST_F(GpioMemHardwareTest, DefaultBackendIsLibgpiod) {
+    Pin pin(17, PinDirection::OUTPUT);
+    EXPECT_EQ(pin.getBackend(), PinBackend::LIBGPIOD);
+}
+
+TEST_F(GpioMemHardwareTest, GpiomemWriteReadBack) {
+    Pin pin(17, PinDirection::OUTPUT, "gpiochip0", PinBackend::GPIOMEM);
+    // Either backend must behave identically
+    EXPECT_TRUE(pin.write(true));
+    EXPECT_EQ(pin.read(), 1);
+    EXPECT_TRUE(pin.write(false));
+    EXPECT_EQ(pin.read(), 0);
+}
+
+TEST_F(GpioMemHardwareTest, GpiomemInputRejectsWrite) {
+    Pin pin(17, PinMode::INPUT_PULLDOWN, "gpiochip0", PinBackend::GPIOMEM);
+    EXPECT_FALSE(pin.write(true));
+    EXPECT_GE(pin.read(), 0);
+}
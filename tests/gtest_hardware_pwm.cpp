@@ -10,6 +10,7 @@
 
 #include <gtest/gtest.h>
 #include "HardwarePWM.hpp"
+#include "exceptions.hpp"
 #include <thread>
 #include <vector>
 
@@ -329,6 +330,64 @@ TEST_F(HardwarePWMTest, ServoFrequencyWithHardware) {
     servo.end();
 }
 
+// HardwarePWMGroup tests
+
+TEST_F(HardwarePWMTest, GroupRejectsInvalidChannels) {
+    HardwarePWM pwm(0, 0);
+    EXPECT_THROW(HardwarePWMGroup({}), InvalidPinError);
+    EXPECT_THROW(HardwarePWMGroup({&pwm, nullptr}), InvalidPinError);
+    
+    HardwarePWMGroup group({&pwm});
+    EXPECT_EQ(group.size(), 1U);
+}
+
+TEST_F(HardwarePWMTest, GroupStagingValidation) {
+    HardwarePWM pwm0(0, 0);
+    HardwarePWM pwm1(0, 1);
+    HardwarePWMGroup group({&pwm0, &pwm1});
+    
+    EXPECT_FALSE(group.stageDutyCycleNs(2, 1000));   // Out of range
+    EXPECT_FALSE(group.stagePeriodNs(0, 0));         // Invalid period
+    EXPECT_FALSE(group.stageDutyCycle(0, 50.0));     // No period known yet
+    EXPECT_TRUE(group.stagePeriodNs(0, 20000000));
+    EXPECT_TRUE(group.stageDutyCycle(0, 50.0));      // Uses staged period
+}
+
+TEST_F(HardwarePWMTest, GroupCommitWithoutBeginFails) {
+    HardwarePWM pwm0(0, 0);
+    HardwarePWM pwm1(0, 1);
+    HardwarePWMGroup group({&pwm0, &pwm1});
+    
+    EXPECT_TRUE(group.stageDutyCycleNs(0, 1000));
+    EXPECT_TRUE(group.stageDutyCycleNs(1, 2000));
+    EXPECT_FALSE(group.commit());
+    EXPECT_EQ(group.getLastCommitSkewNs(), 0U);
+    
+    // Nothing staged: trivially succeeds
+    EXPECT_TRUE(group.commit());
+}
+
+TEST_F(HardwarePWMTest, GroupCommitWithHardware) {
+    GTEST_SKIP() << "Hardware test - requires /sys/class/pwm access";
+    
+    HardwarePWM left(0, 0);
+    HardwarePWM right(0, 1);
+    ASSERT_TRUE(left.begin(20000, 0.0));
+    ASSERT_TRUE(right.begin(20000, 0.0));
+    
+    HardwarePWMGroup motors({&left, &right});
+    EXPECT_TRUE(motors.stageDutyCycle(0, 60.0));
+    EXPECT_TRUE(motors.stageDutyCycle(1, 40.0));
+    EXPECT_TRUE(motors.commit());
+    
+    EXPECT_NEAR(left.getDutyCycle(), 60.0, 0.1);
+    EXPECT_NEAR(right.getDutyCycle(), 40.0, 0.1);
+    EXPECT_GT(motors.getLastCommitSkewNs(), 0U);
+    
+    left.end();
+    right.end();
+}
+
 // Main function
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
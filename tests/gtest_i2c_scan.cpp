@@ -0,0 +1,182 @@
+/**
+ * @file gtest_i2c_scan.cpp
+ * @brief GoogleTest unit tests for the concurrent multi-bus I2C scan
+ *
+ * Tests the scan result cache (and that planted or symlinked cache files
+ * are neither trusted nor written through) and scanning of buses that do
+ * not exist.
+ * Scans of real buses are skipped when no /dev/i2c-N is present.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "i2c_scan.hpp"
+#include "Wire.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace pipinpp;
+
+class I2cScanTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        cachePath = "/tmp/pipinpp-gtest-i2c-scan-" + std::to_string(getpid()) + ".cache";
+        std::remove(cachePath.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(cachePath.c_str());
+    }
+
+    std::string cachePath;
+};
+
+// ============================================================================
+// Cache Tests
+// ============================================================================
+
+TEST_F(I2cScanTest, CacheRoundTrip) {
+    std::vector<I2cBusScan> saved(2);
+    saved[0].bus = 1;
+    saved[0].ok = true;
+    saved[0].devices = {0x3C, 0x68, 0x76};
+    saved[1].bus = 20;
+    saved[1].ok = false;
+
+    ASSERT_TRUE(saveI2cScanCache(cachePath, saved));
+
+    std::vector<I2cBusScan> loaded;
+    ASSERT_TRUE(loadI2cScanCache(cachePath, 60, loaded));
+    ASSERT_EQ(loaded.size(), 2u);
+    EXPECT_EQ(loaded[0].bus, 1);
+    EXPECT_TRUE(loaded[0].ok);
+    EXPECT_EQ(loaded[0].devices, saved[0].devices);
+    EXPECT_EQ(loaded[1].bus, 20);
+    EXPECT_FALSE(loaded[1].ok);
+    EXPECT_TRUE(loaded[1].devices.empty());
+}
+
+TEST_F(I2cScanTest, MissingCacheIsRejected) {
+    std::vector<I2cBusScan> loaded;
+    EXPECT_FALSE(loadI2cScanCache(cachePath, 60, loaded));
+}
+
+TEST_F(I2cScanTest, StaleCacheIsRejected) {
+    ASSERT_TRUE(saveI2cScanCache(cachePath, {}));
+    std::vector<I2cBusScan> loaded;
+    EXPECT_FALSE(loadI2cScanCache(cachePath, -1, loaded));
+}
+
+TEST_F(I2cScanTest, ForeignCacheIsRejected) {
+    {
+        std::ofstream file(cachePath);
+        file << "something else\n";
+    }
+    std::vector<I2cBusScan> loaded;
+    EXPECT_FALSE(loadI2cScanCache(cachePath, 60, loaded));
+}
+
+TEST_F(I2cScanTest, PlantedCacheIsRejected) {
+    std::vector<I2cBusScan> saved(1);
+    saved[0].bus = 1;
+    saved[0].ok = true;
+    ASSERT_TRUE(saveI2cScanCache(cachePath, saved));
+    std::vector<I2cBusScan> loaded;
+
+    ASSERT_EQ(chmod(cachePath.c_str(), 0666), 0);        // Anyone could have written it
+    EXPECT_FALSE(loadI2cScanCache(cachePath, 60, loaded));
+
+    std::string target = cachePath + ".target";
+    ASSERT_EQ(rename(cachePath.c_str(), target.c_str()), 0);
+    ASSERT_EQ(chmod(target.c_str(), 0600), 0);
+    ASSERT_EQ(symlink(target.c_str(), cachePath.c_str()), 0);
+    EXPECT_FALSE(loadI2cScanCache(cachePath, 60, loaded));
+    std::remove(target.c_str());
+}
+
+TEST_F(I2cScanTest, SaveDoesNotFollowSymlinks) {
+    std::string victim = cachePath + ".victim";
+    std::ofstream(victim) << "keep me\n";
+    ASSERT_EQ(symlink(victim.c_str(), cachePath.c_str()), 0);
+
+    ASSERT_TRUE(saveI2cScanCache(cachePath, {}));
+    std::ifstream file(victim);
+    std::string line;
+    std::getline(file, line);
+    EXPECT_EQ(line, "keep me");
+
+    struct stat st;
+    ASSERT_EQ(lstat(cachePath.c_str(), &st), 0);
+    EXPECT_TRUE(S_ISREG(st.st_mode));                    // The link was replaced
+    EXPECT_EQ(st.st_mode & 0777, 0600u);
+    std::remove(victim.c_str());
+}
+
+TEST_F(I2cScanTest, DefaultCacheIsPrivate) {
+    std::string path = i2cScanDefaultCachePath();
+    if (path.empty()) {
+        GTEST_SKIP() << "No private runtime directory";
+    }
+    EXPECT_NE(path.rfind("/tmp/", 0), 0u);
+    struct stat st;
+    ASSERT_EQ(lstat(path.substr(0, path.rfind('/')).c_str(), &st), 0);
+    EXPECT_EQ(st.st_uid, geteuid());
+    EXPECT_EQ(st.st_mode & 0022, 0u);
+}
+
+TEST_F(I2cScanTest, CachedResultsAreReused) {
+    std::vector<I2cBusScan> saved(1);
+    saved[0].bus = 9999;
+    saved[0].ok = true;
+    saved[0].devices = {0x48};
+    ASSERT_TRUE(saveI2cScanCache(cachePath, saved));
+
+    I2cScanOptions options;
+    options.buses = {9999};
+    options.cachePath = cachePath;
+
+    // Bus 9999 does not exist, so a device can only come from the cache
+    auto results = scanI2cBuses(options);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].ok);
+    EXPECT_EQ(results[0].devices, std::vector<uint8_t>{0x48});
+
+    options.refresh = true;
+    results = scanI2cBuses(options);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_FALSE(results[0].ok);
+}
+
+// ============================================================================
+// Scan Tests
+// ============================================================================
+
+TEST_F(I2cScanTest, MissingBusesReportNotOk) {
+    I2cScanOptions options;
+    options.buses = {9998, 9999, 9998};   // Duplicates collapse
+
+    auto results = scanI2cBuses(options);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].bus, 9998);
+    EXPECT_EQ(results[1].bus, 9999);
+    EXPECT_FALSE(results[0].ok);
+    EXPECT_FALSE(results[1].ok);
+}
+
+TEST_F(I2cScanTest, ScanAllBusesMatchesAvailableBuses) {
+    std::vector<int> buses = WireClass::availableBuses();
+    if (buses.empty()) {
+        GTEST_SKIP() << "I2C hardware not available";
+    }
+
+    auto results = scanI2cBuses();
+    ASSERT_EQ(results.size(), buses.size());
+    for (size_t i = 0; i < buses.size(); ++i) {
+        EXPECT_EQ(results[i].bus, buses[i]);
+    }
+}
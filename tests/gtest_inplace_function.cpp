@@ -0,0 +1,98 @@
+/**
+ * @file gtest_inplace_function.cpp
+ * @brief GoogleTest unit tests for the allocation-free InplaceFunction
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "inplace_function.hpp"
+#include "interrupts.hpp"
+#include <memory>
+
+using namespace pipinpp;
+
+namespace {
+
+int g_calls = 0;
+
+void countCall() {
+    ++g_calls;
+}
+
+/**
+ * @brief Callable that counts its live copies
+ */
+struct Tracked {
+    explicit Tracked(int& live) : live_(&live) { ++*live_; }
+    Tracked(const Tracked& other) : live_(other.live_) { ++*live_; }
+    Tracked(Tracked&& other) noexcept : live_(other.live_) { ++*live_; }
+    ~Tracked() { --*live_; }
+    int operator()(int value) const { return value + 1; }
+    int* live_;
+};
+
+} // namespace
+
+TEST(InplaceFunctionTest, StoresPointersLambdasAndStdFunctions) {
+    g_calls = 0;
+    InplaceFunction<void(), 32> pointer = countCall;
+    pointer();
+    EXPECT_EQ(g_calls, 1);
+
+    int total = 0;
+    int step = 5;
+    InplaceFunction<void(), 32> lambda = [&total, step] { total += step; };
+    lambda();
+    lambda();
+    EXPECT_EQ(total, 10);
+
+    std::function<int(int)> doubler = [](int value) { return value * 2; };
+    InplaceFunction<int(int), sizeof(std::function<int(int)>)> wrapped = doubler;
+    EXPECT_EQ(wrapped(21), 42);
+}
+
+TEST(InplaceFunctionTest, NullCallablesAreEmpty) {
+    void (*none)() = nullptr;
+    InplaceFunction<void(), 16> fromNull = none;
+    InplaceFunction<void(), 32> fromEmpty = std::function<void()>();
+    InplaceFunction<void(), 16> defaulted;
+    EXPECT_FALSE(fromNull);
+    EXPECT_FALSE(fromEmpty);
+    EXPECT_FALSE(defaulted);
+    EXPECT_THROW(defaulted(), std::bad_function_call);
+}
+
+TEST(InplaceFunctionTest, CopiesMovesAndDestroysTheCallable) {
+    int live = 0;
+    {
+        InplaceFunction<int(int), 16> first = Tracked(live);
+        EXPECT_EQ(live, 1);
+        InplaceFunction<int(int), 16> copy = first;
+        EXPECT_EQ(live, 2);
+        InplaceFunction<int(int), 16> moved = std::move(first);
+        EXPECT_EQ(live, 2);                // Source released its copy
+        EXPECT_FALSE(first);
+        EXPECT_EQ(moved(1), 2);
+        copy = nullptr;
+        EXPECT_EQ(live, 1);
+        moved = copy;
+        EXPECT_EQ(live, 0);
+    }
+    EXPECT_EQ(live, 0);
+}
+
+TEST(InplaceFunctionTest, InterruptCallbacksHoldCommonCaptures) {
+    // A std::function, a shared_ptr plus a pin number, or a few references fit
+    EXPECT_GE(InterruptCallback::capacity(), sizeof(std::function<void()>));
+    auto state = std::make_shared<int>(0);
+    int pin = 17;
+    InterruptCallback callback = [state, pin] { *state += pin; };
+    callback();
+    EXPECT_EQ(*state, 17);
+    EdgeBatchCallback batch = [state](EdgeEventSpan events) { *state += static_cast<int>(events.size()); };
+    EdgeEvent event{};
+    batch(EdgeEventSpan(&event, 1));
+    EXPECT_EQ(*state, 18);
+}
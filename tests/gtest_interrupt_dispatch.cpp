@@ -0,0 +1,239 @@
+/**
+ * @file gtest_interrupt_dispatch.cpp
+ * @brief GoogleTest unit tests for queued interrupt callbacks and kernel buffer overflow
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "interrupts.hpp"
+#include "exceptions.hpp"
+#include "sim_backend.hpp"
+#include "thread_policy.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace pipinpp;
+
+class InterruptDispatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sim().reset();
+        sim().install();
+    }
+
+    void TearDown() override {
+        for (int pin : {5, 6, 12, 13}) {
+            manager().detachInterrupt(pin);
+            manager().setCallbackDispatch(pin, CallbackDispatch::INLINE);
+        }
+        manager().setAdaptiveEventBuffer(false);
+        sim().reset();
+        sim().uninstall();
+    }
+
+    static SimulatedHardware& sim() { return SimulatedHardware::getInstance(); }
+    static InterruptManager& manager() { return InterruptManager::getInstance(); }
+
+    /**
+     * @brief Poll @p done for up to two seconds
+     */
+    static bool waitUntil(const std::function<bool()>& done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+};
+
+TEST_F(InterruptDispatchTest, RejectsInvalidSettings) {
+    EXPECT_EQ(manager().getCallbackDispatch(5), CallbackDispatch::INLINE);
+    EXPECT_THROW(manager().setCallbackDispatch(99, CallbackDispatch::POOL), InvalidPinError);
+    EXPECT_THROW(manager().setCallbackDispatch(5, CallbackDispatch::POOL, 0), InvalidPinError);
+    EXPECT_THROW(manager().setCallbackPoolThreads(0), InvalidPinError);
+
+    manager().setCallbackDispatch(5, CallbackDispatch::DEDICATED);
+    EXPECT_EQ(manager().getCallbackDispatch(5), CallbackDispatch::DEDICATED);
+    CallbackQueueStats stats;
+    EXPECT_FALSE(manager().getCallbackQueueStats(5, stats));    // Not attached
+}
+
+TEST_F(InterruptDispatchTest, SlowCallbackDoesNotDelayOtherPins) {
+    std::atomic<bool> release{false};
+    std::atomic<int> slowCalls{0};
+    std::atomic<int> fastCalls{0};
+    manager().setCallbackDispatch(5, CallbackDispatch::DEDICATED);
+    manager().attachInterrupt(5, [&] {
+        slowCalls.fetch_add(1);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }, InterruptMode::RISING);
+    manager().attachInterrupt(6, [&] { fastCalls.fetch_add(1); }, InterruptMode::RISING);
+
+    sim().setInput(5, true);
+    ASSERT_TRUE(waitUntil([&] { return slowCalls.load() == 1; }));
+    sim().setInput(6, true);                                     // Monitor is not stuck in pin 5
+    EXPECT_TRUE(waitUntil([&] { return fastCalls.load() == 1; }));
+    EXPECT_TRUE(ThreadPolicyManager::getInstance().getStatus("pipinpp-irqcb5").applied);
+
+    release.store(true);
+    manager().detachInterrupt(5);                                // Waits for the callback
+    EXPECT_EQ(slowCalls.load(), 1);
+}
+
+TEST_F(InterruptDispatchTest, PoolKeepsEachPinInOrder) {
+    std::mutex mutex;
+    std::vector<unsigned long> seen[2];
+    auto record = [&](int index) {
+        return [&, index](EdgeEventSpan events) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const EdgeEvent& event : events) {
+                seen[index].push_back(event.lineSeqno);
+            }
+        };
+    };
+    manager().setCallbackDispatch(12, CallbackDispatch::POOL);
+    manager().setCallbackDispatch(13, CallbackDispatch::POOL);
+    manager().attachInterruptBatch(12, record(0), InterruptMode::CHANGE, 256);
+    manager().attachInterruptBatch(13, record(1), InterruptMode::CHANGE, 256);
+
+    const int edges = 200;
+    for (int i = 0; i < edges; ++i) {
+        sim().setInput(12, i % 2 == 0);
+        sim().setInput(13, i % 2 == 0);
+    }
+    ASSERT_TRUE(waitUntil([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return seen[0].size() == edges && seen[1].size() == edges;
+    }));
+    for (const auto& sequence : seen) {
+        for (size_t i = 1; i < sequence.size(); ++i) {
+            ASSERT_LT(sequence[i - 1], sequence[i]);
+        }
+    }
+    CallbackQueueStats stats;
+    ASSERT_TRUE(manager().getCallbackQueueStats(12, stats));
+    EXPECT_EQ(stats.delivered, static_cast<uint64_t>(edges));
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.depth, 0u);
+}
+
+TEST_F(InterruptDispatchTest, FullQueueDropsAndCounts) {
+    std::atomic<bool> release{false};
+    std::atomic<int> calls{0};
+    manager().setCallbackDispatch(5, CallbackDispatch::DEDICATED, 4);
+    manager().attachInterrupt(5, [&] {
+        calls.fetch_add(1);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }, InterruptMode::CHANGE);
+
+    sim().setInput(5, true);
+    ASSERT_TRUE(waitUntil([&] { return calls.load() == 1; }));   // Worker is now stuck
+    const uint64_t edges = 20;
+    for (uint64_t i = 1; i < edges; ++i) {
+        sim().setInput(5, i % 2 == 0);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));   // Stay within the kernel buffer
+    }
+    CallbackQueueStats stats;
+    ASSERT_TRUE(waitUntil([&] {
+        return manager().getCallbackQueueStats(5, stats) && stats.dropped + stats.depth == edges - 1;
+    })) << "dropped " << stats.dropped << " depth " << stats.depth;
+    EXPECT_EQ(stats.capacity, 4u);
+    EXPECT_EQ(stats.depth, 4u);
+    EXPECT_EQ(stats.maxDepth, 4u);
+
+    release.store(true);
+    ASSERT_TRUE(waitUntil([&] {
+        return manager().getCallbackQueueStats(5, stats) && stats.delivered + stats.dropped == edges;
+    }));
+    EXPECT_EQ(calls.load(), 5);
+}
+
+TEST_F(InterruptDispatchTest, QueuedCallbackCanDetachItself) {
+    std::atomic<int> calls{0};
+    manager().setCallbackDispatch(6, CallbackDispatch::POOL);
+    manager().attachInterrupt(6, [&] {
+        calls.fetch_add(1);
+        manager().detachInterrupt(6);
+    }, InterruptMode::CHANGE);
+
+    sim().setInput(6, true);
+    ASSERT_TRUE(waitUntil([&] { return !manager().isAttached(6); }));
+    sim().setInput(6, false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(calls.load(), 1);
+
+    manager().attachInterrupt(6, [&] { calls.fetch_add(1); }, InterruptMode::RISING);  // Pin is free again
+    sim().setInput(6, true);
+    EXPECT_TRUE(waitUntil([&] { return calls.load() == 2; }));
+}
+
+TEST_F(InterruptDispatchTest, CountsKernelOverflowAndGrowsTheBuffer) {
+    std::atomic<bool> release{false};
+    std::atomic<int> calls{0};
+    manager().setAdaptiveEventBuffer(true, 64);
+    manager().attachInterrupt(5, [&] {
+        if (calls.fetch_add(1) == 0) {
+            while (!release.load()) {                            // Stall the monitor thread
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }, InterruptMode::CHANGE);
+    EXPECT_EQ(manager().getEventBufferSize(5), DEFAULT_EVENT_BUFFER_SIZE);
+
+    sim().setInput(5, true);
+    ASSERT_TRUE(waitUntil([&] { return calls.load() == 1; }));
+    for (int i = 1; i < 41; ++i) {
+        sim().setInput(5, i % 2 == 0);                           // 40 edges into a 16-edge buffer
+    }
+    release.store(true);
+    ASSERT_TRUE(waitUntil([&] { return manager().getEventBufferSize(5) == 32; }));
+    EXPECT_EQ(manager().getLostEvents(5), 24u);
+    EXPECT_EQ(calls.load(), 17);
+
+    // A burst the grown buffer holds is not lost
+    release.store(false);
+    calls.store(0);
+    sim().setInput(5, false);
+    ASSERT_TRUE(waitUntil([&] { return calls.load() == 1; }));
+    for (int i = 1; i < 25; ++i) {
+        sim().setInput(5, i % 2 != 0);
+    }
+    release.store(true);
+    ASSERT_TRUE(waitUntil([&] { return calls.load() == 25; }));
+    EXPECT_EQ(manager().getLostEvents(5), 24u);
+    EXPECT_EQ(manager().getEventBufferSize(5), 32u);
+}
+
+TEST_F(InterruptDispatchTest, OverflowIsCountedWithoutAdaptiveSizing) {
+    std::atomic<bool> release{false};
+    std::atomic<int> calls{0};
+    manager().attachInterruptBatch(6, [&](EdgeEventSpan) {
+        calls.fetch_add(1);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }, InterruptMode::RISING, 4);
+
+    sim().setInput(6, true);
+    ASSERT_TRUE(waitUntil([&] { return calls.load() == 1; }));
+    for (int i = 0; i < 10; ++i) {
+        sim().setInput(6, false);
+        sim().setInput(6, true);                                 // 10 rising edges, 4 kept
+    }
+    release.store(true);
+    ASSERT_TRUE(waitUntil([&] { return manager().getLostEvents(6) == 6; }));
+    EXPECT_EQ(manager().getEventBufferSize(6), 4u);
+}
@@ -483,3 +483,272 @@ TEST_F(InterruptTest, InterruptCleanupOnExit) {
         GTEST_SKIP() << "GPIO access not available: " << e.what();
     }
 }
+
+// Test: Batch attach rejects invalid arguments before touching hardware
+TEST_F(InterruptTest, AttachInterruptBatchInvalidArguments) {
+    auto& manager = InterruptManager::getInstance();
+    auto batch = [](EdgeEventSpan) {};
+    
+    EXPECT_THROW(manager.attachInterruptBatch(99, batch, InterruptMode::RISING), InvalidPinError);
+    EXPECT_THROW(manager.attachInterruptBatch(17, nullptr, InterruptMode::RISING), InvalidPinError);
+    EXPECT_THROW(manager.attachInterruptBatch(17, batch, InterruptMode::RISING, 0), InvalidPinError);
+    EXPECT_THROW(manager.attachInterruptBatch(17, batch, InterruptMode::RISING, 4096), InvalidPinError);
+    EXPECT_FALSE(manager.isAttached(17));
+}
+
+// Test: EdgeEventSpan iterates the underlying storage
+TEST_F(InterruptTest, EdgeEventSpanIteration) {
+    EdgeEvent events[3] = {
+        {17, EdgeType::RISING, 1000, 1, 1},
+        {17, EdgeType::FALLING, 2000, 2, 2},
+        {17, EdgeType::RISING, 3000, 3, 3},
+    };
+    EdgeEventSpan span(events, 3);
+    
+    EXPECT_EQ(span.size(), 3u);
+    EXPECT_FALSE(span.empty());
+    EXPECT_EQ(span[1].type, EdgeType::FALLING);
+    
+    uint64_t total = 0;
+    for (const EdgeEvent& e : span) {
+        total += e.timestampNs;
+    }
+    EXPECT_EQ(total, 6000u);
+}
+
+// Test: Batch callback delivers timestamps and edge types (loopback)
+TEST_F(InterruptTest, AttachInterruptBatchDeliversTimestamps) {
+    auto& manager = InterruptManager::getInstance();
+    std::atomic<int> rising{0};
+    std::atomic<int> falling{0};
+    std::atomic<bool> ordered{true};
+    std::atomic<uint64_t> lastTimestamp{0};
+    
+    try {
+        pinMode(27, OUTPUT);
+        digitalWrite(27, LOW);
+        
+        manager.attachInterruptBatch(17, [&](EdgeEventSpan events) {
+            for (const EdgeEvent& e : events) {
+                if (e.timestampNs < lastTimestamp.load()) {
+                    ordered = false;
+                }
+                lastTimestamp = e.timestampNs;
+                (e.type == EdgeType::RISING ? rising : falling)++;
+            }
+        }, InterruptMode::CHANGE, 64);
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+    
+    std::this_thread::sleep_for(100ms);
+    for (int i = 0; i < 5; ++i) {
+        digitalWrite(27, HIGH);
+        digitalWrite(27, LOW);
+    }
+    std::this_thread::sleep_for(100ms);
+    manager.detachInterrupt(17);
+    
+    if (rising == 0 && falling == 0) {
+        GTEST_SKIP() << "Interrupt not triggered - may need GPIO loopback (connect GPIO17 to GPIO27)";
+    }
+    EXPECT_TRUE(ordered.load()) << "Kernel timestamps should be monotonic";
+    EXPECT_EQ(rising.load(), 5);
+    EXPECT_EQ(falling.load(), 5);
+}
+
+// Test: Merge option toggles and defaults to one request per pin
+TEST_F(InterruptTest, MergeRequestsToggle) {
+    auto& manager = InterruptManager::getInstance();
+    
+    EXPECT_FALSE(manager.getMergeRequests());
+    manager.setMergeRequests(true);
+    EXPECT_TRUE(manager.getMergeRequests());
+    manager.setMergeRequests(false);
+    EXPECT_FALSE(manager.getMergeRequests());
+}
+
+// Test: Merged pins attach and detach independently
+TEST_F(InterruptTest, MergedRequestsAttachDetach) {
+    auto& manager = InterruptManager::getInstance();
+    manager.setMergeRequests(true);
+    
+    try {
+        manager.attachInterrupt(17, []() {}, InterruptMode::RISING);
+        manager.attachInterruptBatch(22, [](EdgeEventSpan) {}, InterruptMode::CHANGE);
+    } catch (const GpioAccessError& e) {
+        manager.detachInterrupt(17);
+        manager.setMergeRequests(false);
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+    
+    EXPECT_TRUE(manager.isAttached(17));
+    EXPECT_TRUE(manager.isAttached(22));
+    EXPECT_EQ(manager.getActiveCount(), 2u);
+    
+    // Removing one pin re-requests the other
+    EXPECT_TRUE(manager.detachInterrupt(17));
+    EXPECT_FALSE(manager.isAttached(17));
+    EXPECT_TRUE(manager.isAttached(22));
+    
+    // The released line can be attached again
+    EXPECT_NO_THROW(manager.attachInterrupt(17, []() {}, InterruptMode::FALLING));
+    
+    EXPECT_TRUE(manager.detachInterrupt(17));
+    EXPECT_TRUE(manager.detachInterrupt(22));
+    EXPECT_EQ(manager.getActiveCount(), 0u);
+    
+    manager.setMergeRequests(false);
+}
+
+// Test: Debounce period is kept per pin and validated
+TEST_F(InterruptTest, DebouncePeriodPerPin) {
+    auto& manager = InterruptManager::getInstance();
+    
+    EXPECT_THROW(manager.setDebounce(-1, 1000), InvalidPinError);
+    EXPECT_THROW(manager.setDebounce(28, 1000), InvalidPinError);
+    
+    EXPECT_EQ(manager.getDebounce(17), 0u);
+    manager.setDebounce(17, 5000);
+    EXPECT_EQ(manager.getDebounce(17), 5000u);
+    EXPECT_FALSE(manager.isSoftwareDebounce(17));    // Not attached
+    manager.setDebounce(17, 0);
+    EXPECT_EQ(manager.getDebounce(17), 0u);
+}
+
+// Test: Debounce applies to attached and later attached interrupts
+TEST_F(InterruptTest, DebounceOnAttachedInterrupt) {
+    auto& manager = InterruptManager::getInstance();
+    manager.setDebounce(17, 2000);
+    
+    try {
+        manager.attachInterrupt(17, []() {}, InterruptMode::CHANGE);
+    } catch (const GpioAccessError& e) {
+        manager.setDebounce(17, 0);
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+    
+    EXPECT_NO_THROW(manager.setDebounce(17, 10000));
+    EXPECT_EQ(manager.getDebounce(17), 10000u);
+    EXPECT_NO_THROW(manager.setDebounce(17, 0));
+    EXPECT_FALSE(manager.isSoftwareDebounce(17));
+    EXPECT_TRUE(manager.detachInterrupt(17));
+}
+
+// ============================================================================
+// FREQUENCY COUNTER TESTS
+// ============================================================================
+
+namespace {
+
+EdgeEvent makeEdge(EdgeType type, uint64_t timestampNs, unsigned long lineSeqno) {
+    EdgeEvent event{};
+    event.pin = 5;
+    event.type = type;
+    event.timestampNs = timestampNs;
+    event.globalSeqno = lineSeqno;
+    event.lineSeqno = lineSeqno;
+    return event;
+}
+
+} // namespace
+
+TEST(FrequencyTrackerTest, PeriodFrequencyAndDuty) {
+    FrequencyTracker tracker;
+    unsigned long seqno = 1;
+    
+    // 1 kHz, 25% duty
+    for (uint64_t cycle = 0; cycle < 5; ++cycle) {
+        uint64_t start = 1000000000ull + cycle * 1000000;
+        tracker.onEdge(makeEdge(EdgeType::RISING, start, seqno++));
+        tracker.onEdge(makeEdge(EdgeType::FALLING, start + 250000, seqno++));
+    }
+    tracker.onEdge(makeEdge(EdgeType::RISING, 1005000000ull, seqno++));
+    
+    const FrequencySnapshot& stats = tracker.stats();
+    EXPECT_EQ(stats.edges, 11u);
+    EXPECT_EQ(stats.cycles, 5u);
+    EXPECT_EQ(stats.periodNs, 1000000u);
+    EXPECT_EQ(stats.averagePeriodNs, 1000000u);
+    EXPECT_EQ(stats.minPeriodNs, 1000000u);
+    EXPECT_EQ(stats.maxPeriodNs, 1000000u);
+    EXPECT_EQ(stats.highNs, 250000u);
+    EXPECT_DOUBLE_EQ(stats.frequencyHz, 1000.0);
+    EXPECT_DOUBLE_EQ(stats.dutyCycle, 25.0);
+    EXPECT_EQ(stats.jitter[0], 5u);
+    EXPECT_EQ(stats.missedEdges, 0u);
+    EXPECT_EQ(stats.lastEdgeNs, 1005000000ull);
+}
+
+TEST(FrequencyTrackerTest, JitterHistogramAndMinMax) {
+    FrequencyTracker tracker;
+    tracker.onEdge(makeEdge(EdgeType::RISING, 0, 1));
+    tracker.onEdge(makeEdge(EdgeType::RISING, 1000000, 2));     // Sets the average
+    tracker.onEdge(makeEdge(EdgeType::RISING, 2003000, 3));     // 3 µs late: bucket 2
+    tracker.onEdge(makeEdge(EdgeType::RISING, 2903000, 4));     // ~100 µs early: bucket 7
+    
+    const FrequencySnapshot& stats = tracker.stats();
+    EXPECT_EQ(stats.cycles, 3u);
+    EXPECT_EQ(stats.jitter[0], 1u);
+    EXPECT_EQ(stats.jitter[2], 1u);
+    EXPECT_EQ(stats.jitter[7], 1u);
+    EXPECT_EQ(stats.minPeriodNs, 900000u);
+    EXPECT_EQ(stats.maxPeriodNs, 1003000u);
+    
+    EXPECT_EQ(FrequencyTracker::jitterBucket(999), 0u);
+    EXPECT_EQ(FrequencyTracker::jitterBucket(1000), 1u);
+    EXPECT_EQ(FrequencyTracker::jitterBucket(16384000), FREQUENCY_JITTER_BUCKETS - 1);
+    EXPECT_EQ(FrequencyTracker::jitterBucket(UINT64_MAX), FREQUENCY_JITTER_BUCKETS - 1);
+}
+
+TEST(FrequencyTrackerTest, SequenceGapDiscardsCycle) {
+    FrequencyTracker tracker;
+    tracker.onEdge(makeEdge(EdgeType::RISING, 0, 1));
+    tracker.onEdge(makeEdge(EdgeType::FALLING, 500000, 2));
+    // Edges 3-4 lost: this rising edge is not one period after the first
+    tracker.onEdge(makeEdge(EdgeType::RISING, 2000000, 5));
+    EXPECT_EQ(tracker.stats().cycles, 0u);
+    EXPECT_EQ(tracker.stats().missedEdges, 2u);
+    
+    tracker.onEdge(makeEdge(EdgeType::RISING, 3000000, 6));
+    EXPECT_EQ(tracker.stats().cycles, 1u);
+    EXPECT_EQ(tracker.stats().periodNs, 1000000u);
+    
+    tracker.reset();
+    EXPECT_EQ(tracker.stats().edges, 0u);
+    EXPECT_EQ(tracker.stats().cycles, 0u);
+}
+
+TEST(FrequencyCounterTest, RejectsInvalidPins) {
+    auto& counter = FrequencyCounter::getInstance();
+    EXPECT_THROW(counter.addPin(-1), InvalidPinError);
+    EXPECT_THROW(counter.addPin(28), InvalidPinError);
+    EXPECT_FALSE(counter.removePin(99));
+    EXPECT_FALSE(counter.isCounting(5));
+    
+    FrequencySnapshot snapshot;
+    EXPECT_FALSE(counter.read(5, snapshot));
+    EXPECT_NO_THROW(counter.reset(99));
+}
+
+TEST(FrequencyCounterTest, CountsIdlePin) {
+    auto& counter = FrequencyCounter::getInstance();
+    try {
+        counter.addPin(27);
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+    
+    EXPECT_TRUE(counter.isCounting(27));
+    EXPECT_TRUE(InterruptManager::getInstance().isAttached(27));
+    EXPECT_THROW(counter.addPin(27), GpioAccessError);
+    
+    FrequencySnapshot snapshot;
+    ASSERT_TRUE(counter.read(27, snapshot));
+    EXPECT_EQ(snapshot.cycles, 0u);
+    EXPECT_DOUBLE_EQ(snapshot.frequencyHz, 0.0);
+    
+    EXPECT_TRUE(counter.removePin(27));
+    EXPECT_FALSE(counter.isCounting(27));
+    EXPECT_FALSE(InterruptManager::getInstance().isAttached(27));
+}
@@ -0,0 +1,153 @@
+/**
+ * @file gtest_log.cpp
+ * @brief GoogleTest unit tests for the asynchronous ring-buffer logger
+ *
+ * Tests deferred formatting of every operand type, the runtime level,
+ * per-site rate limiting, truncation and messages from several threads.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+// Exercise the real macros whatever the build's logging option is
+#ifndef PIPINPP_ENABLE_LOGGING
+#define PIPINPP_ENABLE_LOGGING
+#endif
+#ifndef PIPINPP_LOG_LEVEL
+#define PIPINPP_LOG_LEVEL 0
+#endif
+
+#include <gtest/gtest.h>
+#include "log.hpp"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pipinpp;
+
+class LogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        savedLevel_ = getLogLevel();
+        setLogLevel(LogLevel::DEBUG);
+        setLogRateLimit(0);
+        setLogSink([this](LogLevel level, const std::string& message) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            levels_.push_back(level);
+            messages_.push_back(message);
+        });
+    }
+
+    void TearDown() override {
+        flushLog();
+        setLogSink(LogSink());
+        setLogRateLimit(DEFAULT_LOG_RATE_LIMIT);
+        setLogLevel(savedLevel_);
+    }
+
+    std::vector<std::string> messages() {
+        flushLog();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+
+    LogLevel savedLevel_ = LogLevel::INFO;
+    std::mutex mutex_;
+    std::vector<LogLevel> levels_;
+    std::vector<std::string> messages_;
+};
+
+TEST_F(LogTest, FormatsOperandsLikeIostreams) {
+    const std::string name = "pin";
+    const char* missing = nullptr;
+    PIPINPP_LOG_INFO(name << ' ' << 17 << " -" << 3 << " " << 2.5 << " " << true << " "
+                     << static_cast<uint64_t>(99) << " 0x" << std::hex << 255 << std::dec << " " << 8
+                     << " " << missing);
+    auto out = messages();
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0], "pin 17 -3 2.5 1 99 0xff 8 (null)");
+    EXPECT_EQ(levels_[0], LogLevel::INFO);
+}
+
+TEST_F(LogTest, RuntimeLevelFilters) {
+    setLogLevel(LogLevel::WARNING);
+    PIPINPP_LOG_DEBUG("debug");
+    PIPINPP_LOG_INFO("info");
+    PIPINPP_LOG_WARNING("warning");
+    PIPINPP_LOG_ERROR("error");
+    auto out = messages();
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0], "warning");
+    EXPECT_EQ(out[1], "error");
+
+    setLogLevel(LogLevel::OFF);
+    PIPINPP_LOG_ERROR("hidden");
+    EXPECT_EQ(messages().size(), 2u);
+}
+
+TEST_F(LogTest, OperandsNotEvaluatedWhenFiltered) {
+    setLogLevel(LogLevel::ERROR);
+    int evaluations = 0;
+    PIPINPP_LOG_INFO("count " << ++evaluations);
+    EXPECT_EQ(evaluations, 0);
+}
+
+TEST_F(LogTest, RateLimitSuppressesRepeats) {
+    setLogRateLimit(5);
+    auto logRepeat = [](int i) { PIPINPP_LOG_INFO("repeat " << i); };   // One call site
+    for (int i = 0; i < 100; ++i) {
+        logRepeat(i);
+    }
+    auto out = messages();
+    ASSERT_EQ(out.size(), 5u);
+    EXPECT_EQ(out[4], "repeat 4");
+
+    // Next window: the first accepted message reports what was dropped
+    std::this_thread::sleep_for(std::chrono::milliseconds(1050));
+    logRepeat(100);
+    out = messages();
+    ASSERT_GE(out.size(), 6u);
+    EXPECT_NE(out[5].find("(95 similar messages suppressed)"), std::string::npos);
+}
+
+TEST_F(LogTest, LongMessagesAreTruncated) {
+    const std::string longText(2000, 'x');
+    PIPINPP_LOG_WARNING(longText);
+    auto out = messages();
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_LT(out[0].size(), detail::LOG_MAX_RECORD_BYTES + 4);
+    EXPECT_EQ(out[0].substr(out[0].size() - 3), "...");
+}
+
+TEST_F(LogTest, MessagesFromManyThreadsArrive) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 25; ++i) {
+                PIPINPP_LOG_DEBUG("thread " << t << " message " << i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(messages().size(), 100u);
+}
+
+TEST_F(LogTest, BackgroundThreadWritesWithoutFlush) {
+    PIPINPP_LOG_ERROR("async");
+    for (int i = 0; i < 100; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!messages_.empty()) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT_EQ(messages_.size(), 1u);
+    EXPECT_EQ(messages_[0], "async");
+}
@@ -0,0 +1,157 @@
+/**
+ * @file gtest_metrics.cpp
+ * @brief GoogleTest unit tests for the metrics registry and exporters
+ *
+ * Tests histogram bucket boundaries, quantile accuracy, registration,
+ * snapshots, reset, the Prometheus/JSON exporters and the recording macros.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+// Exercise the real macros whatever the build's metrics option is
+#ifndef PIPINPP_ENABLE_METRICS
+#define PIPINPP_ENABLE_METRICS
+#endif
+
+#include <gtest/gtest.h>
+#include "metrics.hpp"
+#include <thread>
+#include <vector>
+
+using namespace pipinpp::metrics;
+
+TEST(MetricsTest, BucketBoundsContainTheirValues) {
+    const uint64_t values[] = {0, 1, 31, 32, 33, 63, 64, 65, 1000, 123456789, UINT64_MAX};
+    for (uint64_t v : values) {
+        size_t index = Histogram::bucketIndex(v);
+        ASSERT_LT(index, HISTOGRAM_BUCKETS);
+        EXPECT_LE(Histogram::bucketLowerBound(index), v);
+        EXPECT_GE(Histogram::bucketUpperBound(index), v);
+    }
+    // Buckets tile the range without gaps
+    for (size_t i = 1; i < HISTOGRAM_BUCKETS; ++i) {
+        ASSERT_EQ(Histogram::bucketLowerBound(i), Histogram::bucketUpperBound(i - 1) + 1) << "bucket " << i;
+    }
+    EXPECT_EQ(Histogram::bucketUpperBound(HISTOGRAM_BUCKETS - 1), UINT64_MAX);
+}
+
+TEST(MetricsTest, QuantilesWithinBucketResolution) {
+    Histogram& h = histogram("test_quantiles");
+    h.reset();
+    for (uint64_t v = 1; v <= 10000; ++v) {
+        h.record(v);
+    }
+    Snapshot all = snapshot();
+    const HistogramSnapshot* snap = all.findHistogram("test_quantiles");
+    ASSERT_NE(snap, nullptr);
+    EXPECT_EQ(snap->count, 10000u);
+    EXPECT_EQ(snap->max, 10000u);
+    EXPECT_DOUBLE_EQ(snap->mean(), 5000.5);
+    const double qs[] = {0.5, 0.9, 0.99};
+    for (double q : qs) {
+        double expected = q * 10000;
+        EXPECT_NEAR(static_cast<double>(snap->quantile(q)), expected, expected * 0.04) << "q=" << q;
+    }
+    EXPECT_EQ(snap->quantile(1.0), 10000u);
+}
+
+TEST(MetricsTest, CountersRegisterOnceAndReset) {
+    Counter& a = counter("test_events", "Things that happened");
+    Counter& b = counter("test_events");
+    EXPECT_EQ(&a, &b);
+    a.reset();
+    a.add();
+    b.add(4);
+
+    Snapshot snap = snapshot();
+    const CounterSnapshot* c = snap.findCounter("test_events");
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(c->value, 5u);
+    EXPECT_EQ(c->help, "Things that happened");
+    EXPECT_EQ(snap.findCounter("test_missing"), nullptr);
+
+    reset();
+    EXPECT_EQ(a.value(), 0u);
+    EXPECT_NE(snapshot().findCounter("test_events"), nullptr);
+}
+
+TEST(MetricsTest, ConcurrentRecordingLosesNothing) {
+    Histogram& h = histogram("test_concurrent");
+    h.reset();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&h] {
+            for (uint64_t i = 0; i < 10000; ++i) {
+                h.record(i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(h.count(), 40000u);
+    Snapshot snap = snapshot();
+    ASSERT_NE(snap.findHistogram("test_concurrent"), nullptr);
+    EXPECT_EQ(snap.findHistogram("test_concurrent")->max, 9999u);
+}
+
+TEST(MetricsTest, PrometheusExport) {
+    counter("test_prom_counter", "A counter").reset();
+    counter("test_prom_counter").add(3);
+    Histogram& h = histogram("test_prom_hist", "A histogram");
+    h.reset();
+    h.record(10);
+
+    std::string text = toPrometheus(snapshot());
+    EXPECT_NE(text.find("# HELP pipinpp_test_prom_counter_total A counter\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE pipinpp_test_prom_counter_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("pipinpp_test_prom_counter_total 3\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE pipinpp_test_prom_hist summary\n"), std::string::npos);
+    EXPECT_NE(text.find("pipinpp_test_prom_hist{quantile=\"0.99\"} 10\n"), std::string::npos);
+    EXPECT_NE(text.find("pipinpp_test_prom_hist_count 1\n"), std::string::npos);
+    EXPECT_NE(text.find("pipinpp_test_prom_hist_sum 10\n"), std::string::npos);
+
+    EXPECT_NE(toPrometheus(snapshot(), "app_").find("app_test_prom_counter_total 3\n"), std::string::npos);
+}
+
+TEST(MetricsTest, JsonExport) {
+    counter("test_json_counter").reset();
+    counter("test_json_counter").add(7);
+    Histogram& h = histogram("test_json_hist");
+    h.reset();
+    h.record(20);
+
+    std::string json = toJson(snapshot());
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"test_json_counter\":7"), std::string::npos);
+    EXPECT_NE(json.find("\"test_json_hist\":{\"count\":1,\"sum\":20,\"max\":20"), std::string::npos);
+    EXPECT_NE(json.find("\"p99\":20"), std::string::npos);
+}
+
+TEST(MetricsTest, MacrosRecord) {
+    counter("test_macro_count").reset();
+    histogram("test_macro_hist").reset();
+    histogram("test_macro_scope").reset();
+
+    for (int i = 0; i < 3; ++i) {
+        PIPINPP_METRIC_COUNT("test_macro_count", 2);
+        PIPINPP_METRIC_RECORD("test_macro_hist", 100);
+        PIPINPP_METRIC_TIME_SCOPE("test_macro_scope");
+    }
+    EXPECT_EQ(counter("test_macro_count").value(), 6u);
+    EXPECT_EQ(histogram("test_macro_hist").count(), 3u);
+    EXPECT_EQ(histogram("test_macro_scope").count(), 3u);
+    EXPECT_GT(PIPINPP_METRIC_NOW_NS(), 0);
+}
+
+TEST(MetricsTest, BuiltinMetricsHaveHelp) {
+    // Registering a built-in name without help picks up the library's description
+    histogram("spi_transfer_ns");
+    Snapshot snap = snapshot();
+    EXPECT_GT(snap.timestampNs, 0u);
+    const HistogramSnapshot* spi = snap.findHistogram("spi_transfer_ns");
+    ASSERT_NE(spi, nullptr);
+    EXPECT_FALSE(spi->help.empty());
+}
@@ -0,0 +1,126 @@
+/**
+ * @file gtest_neopixel.cpp
+ * @brief GoogleTest unit tests for NeoPixel SPI encoding
+ *
+ * Tests the 3- and 4-bit encodings, channel ordering, brightness scaling
+ * and frame layout without hardware, and sending a frame when an SPI bus
+ * can be opened (skipped otherwise).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "neopixel.hpp"
+#include "SPI.hpp"
+#include "exceptions.hpp"
+#include "pio.hpp"
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+// Decode SPI bytes back to colour bytes by sampling the middle SPI bit of each LED bit
+std::vector<uint8_t> decode(const uint8_t* data, size_t colourBytes, unsigned bitsPerBit) {
+    std::vector<uint8_t> out;
+    size_t bit = 0;
+    for (size_t i = 0; i < colourBytes; ++i) {
+        uint8_t value = 0;
+        for (int b = 0; b < 8; ++b, bit += bitsPerBit) {
+            size_t sample = bit + 1;                               // Second SPI bit decides
+            bool level = (data[sample / 8] >> (7 - sample % 8)) & 1;
+            EXPECT_TRUE((data[bit / 8] >> (7 - bit % 8)) & 1);     // Every LED bit starts HIGH
+            value = static_cast<uint8_t>((value << 1) | level);
+        }
+        out.push_back(value);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(NeoPixelEncodeTest, ThreeBitPatterns) {
+    const uint8_t bytes[] = {0x00, 0xFF, 0x80};
+    uint8_t out[9];
+    ASSERT_EQ(NeoPixelStrip::encode(bytes, 3, NeoPixelEncoding::BITS_3, out), 9u);
+
+    const uint8_t expected[] = {0x92, 0x49, 0x24, 0xDB, 0x6D, 0xB6, 0xD2, 0x49, 0x24};
+    for (size_t i = 0; i < 9; ++i) {
+        EXPECT_EQ(out[i], expected[i]) << "byte " << i;
+    }
+}
+
+TEST(NeoPixelEncodeTest, RoundTripsEveryValue) {
+    std::vector<uint8_t> values(256);
+    for (int v = 0; v < 256; ++v) {
+        values[v] = static_cast<uint8_t>(v);
+    }
+    for (auto encoding : {NeoPixelEncoding::BITS_3, NeoPixelEncoding::BITS_4}) {
+        unsigned bits = encoding == NeoPixelEncoding::BITS_4 ? 4 : 3;
+        std::vector<uint8_t> out(values.size() * bits);
+        ASSERT_EQ(NeoPixelStrip::encode(values.data(), values.size(), encoding, out.data()), out.size());
+        EXPECT_EQ(decode(out.data(), values.size(), bits), values);
+    }
+}
+
+TEST(NeoPixelStripTest, FrameLayoutAndChannelOrder) {
+    SPIClass bus;
+    NeoPixelStrip strip(2, bus);
+    EXPECT_EQ(strip.size(), 2u);
+    // 2 LEDs x 3 colour bytes x 3 SPI bytes + 300 µs at 2.4 MHz (90 bytes)
+    EXPECT_EQ(strip.frame().size(), 18u + 90u);
+
+    strip.setPixelColor(0, 0x11, 0x22, 0x33);
+    strip.setPixelColor(1, NeoPixelStrip::color(0xAA, 0xBB, 0xCC));
+    strip.setPixelColor(5, 0xFFFFFFFF);                              // Ignored
+    EXPECT_EQ(strip.getPixelColor(0), 0x112233u);
+    EXPECT_EQ(strip.getPixelColor(1), 0xAABBCCu);
+    EXPECT_EQ(strip.getPixelColor(5), 0u);
+    EXPECT_FALSE(strip.show());                                      // Bus not begun
+
+    NeoPixelStrip rgbw(1, bus, NeoPixelEncoding::BITS_4, NeoPixelOrder::GRBW, 50);
+    EXPECT_EQ(rgbw.frame().size(), 16u + 20u);
+    rgbw.setPixelColor(0, 1, 2, 3, 4);
+    EXPECT_EQ(rgbw.getPixelColor(0), 0x04010203u);
+}
+
+TEST(NeoPixelStripTest, FillAndClear) {
+    SPIClass bus;
+    NeoPixelStrip strip(4, bus);
+    strip.fill(0x0000FF, 1, 2);
+    EXPECT_EQ(strip.getPixelColor(0), 0u);
+    EXPECT_EQ(strip.getPixelColor(1), 0xFFu);
+    EXPECT_EQ(strip.getPixelColor(2), 0xFFu);
+    EXPECT_EQ(strip.getPixelColor(3), 0u);
+    strip.clear();
+    EXPECT_EQ(strip.getPixelColor(2), 0u);
+}
+
+TEST(NeoPixelStripTest, SendsEncodedFrame) {
+    SPIClass bus;
+    if (!bus.begin(0, 0)) {
+        GTEST_SKIP() << "SPI bus 0 not available";
+    }
+    NeoPixelStrip strip(3, bus);
+    strip.setPixelColor(0, 0xFF, 0x00, 0x80);                        // GRB: 00 FF 80
+    strip.setBrightness(127);
+    EXPECT_TRUE(strip.show());
+    EXPECT_EQ(decode(strip.frame().data(), 3, 3), (std::vector<uint8_t>{0x00, 0x7F, 0x40}));
+
+    EXPECT_TRUE(strip.showAsync());
+    bus.waitForPending();
+    EXPECT_FALSE(strip.isBusy());
+    bus.end();
+}
+
+TEST(NeoPixelStripTest, PinConstructorNeedsPioOrMosi) {
+    EXPECT_THROW(NeoPixelStrip(28, 10), InvalidPinError);
+    try {
+        NeoPixelStrip strip(18, 10);
+        EXPECT_TRUE(strip.usesPio());
+        EXPECT_TRUE(strip.frame().empty());
+    } catch (const GpioAccessError&) {
+        EXPECT_FALSE(PioStateMachine::isSupported());
+    }
+}
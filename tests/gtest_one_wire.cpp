@@ -0,0 +1,87 @@
+/**
+ * @file gtest_one_wire.cpp
+ * @brief GoogleTest unit tests for the 1-Wire master
+ *
+ * CRC8 and DS18B20 scratchpad decoding are checked against datasheet
+ * values. The simulated chip has no pull-up model, so bus-level tests
+ * only cover a line that never goes HIGH.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "one_wire.hpp"
+#include "exceptions.hpp"
+#include "sim_backend.hpp"
+#include <cmath>
+
+using namespace pipinpp;
+
+TEST(OneWireCrcTest, MatchesMaximExample) {
+    // ROM code from Maxim application note 27
+    const uint8_t rom[8] = {0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xA2};
+    EXPECT_EQ(oneWireCrc8(rom, 7), 0xA2);
+    EXPECT_EQ(oneWireCrc8(rom, 8), 0);
+    EXPECT_EQ(oneWireCrc8(nullptr, 0), 0);
+}
+
+TEST(OneWireCrcTest, DetectsSingleBitErrors) {
+    uint8_t rom[8] = {0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xA2};
+    for (int bit = 0; bit < 64; ++bit) {
+        rom[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+        EXPECT_NE(oneWireCrc8(rom, 8), 0) << "bit " << bit;
+        rom[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+    }
+}
+
+TEST(OneWireDs18b20Test, DecodesDatasheetTemperatures) {
+    uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE] = {0, 0, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0};
+    auto celsius = [&](uint8_t lsb, uint8_t msb) {
+        scratchpad[0] = lsb;
+        scratchpad[1] = msb;
+        return OneWireBus::scratchpadToCelsius(scratchpad);
+    };
+    EXPECT_FLOAT_EQ(celsius(0x50, 0x05), 85.0f);      // Power-on value
+    EXPECT_FLOAT_EQ(celsius(0x91, 0x01), 25.0625f);
+    EXPECT_FLOAT_EQ(celsius(0x5E, 0xFF), -10.125f);
+    EXPECT_FLOAT_EQ(celsius(0x90, 0xFC), -55.0f);
+
+    scratchpad[4] = 0x1F;                              // 9-bit: low 3 bits undefined
+    EXPECT_FLOAT_EQ(celsius(0x97, 0x01), 25.0f);
+}
+
+class OneWireSimTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+    }
+
+    void TearDown() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+};
+
+TEST_F(OneWireSimTest, BusHeldLowHasNoDevices) {
+    OneWireBus bus(4);
+    EXPECT_FALSE(bus.reset());
+    EXPECT_FALSE(bus.select(0x28FF000000000001ULL));
+
+    std::vector<uint64_t> roms;
+    EXPECT_EQ(bus.search(roms, ONEWIRE_SEARCH_ROM, 0), -1);
+    EXPECT_TRUE(roms.empty());
+
+    std::vector<float> celsius;
+    EXPECT_EQ(bus.readTemperatures({0x28FF000000000001ULL}, celsius), 0u);
+    ASSERT_EQ(celsius.size(), 1u);
+    EXPECT_TRUE(std::isnan(celsius[0]));
+}
+
+TEST_F(OneWireSimTest, OwnsItsLine) {
+    OneWireBus bus(4);
+    EXPECT_EQ(bus.pin().getOutputState(), -1);     // Released between slots
+    EXPECT_THROW(Pin(4, PinDirection::OUTPUT), std::exception);
+    EXPECT_THROW(OneWireBus(64), InvalidPinError);
+}
@@ -239,5 +239,35 @@ TEST_F(PinHardwareTest, RapidToggle) {
     });
 }
 
+/**
+ * Test debounce on inputs only, kept across edge event changes
+ */
+TEST_F(PinHardwareTest, DebounceInputOnly) {
+    Pin led(17, PinDirection::OUTPUT);
+    EXPECT_FALSE(led.setDebounce(5000));
+    EXPECT_EQ(led.getDebounce(), 0u);
+    
+    Pin button(27, PinMode::INPUT_PULLUP);
+    EXPECT_TRUE(button.setDebounce(5000));
+    EXPECT_EQ(button.getDebounce(), 5000u);
+    EXPECT_TRUE(button.enableEdgeEvents());
+    EXPECT_EQ(button.getDebounce(), 5000u);
+    EXPECT_TRUE(button.setDebounce(0));
+    EXPECT_FALSE(button.isSoftwareDebounce());
+}
+
+/**
+ * Test bulk shifting requires the right directions
+ */
+TEST_F(PinHardwareTest, ShiftOutAndIn) {
+    Pin data(17, PinDirection::OUTPUT);
+    Pin clock(27, PinDirection::OUTPUT);
+    const uint8_t frame[2] = {0x81, 0x7E};
+    EXPECT_TRUE(data.shiftOut(clock, true, frame, sizeof(frame)));
+    EXPECT_EQ(clock.read(), 0);
+    EXPECT_EQ(data.read(), 0);          // Last bit of 0x7E MSB first
+    EXPECT_FALSE(clock.shiftIn(data, true, nullptr, 0));   // Data pin is not an input
+}
+
 // Note: analogRead and analogWrite are not yet implemented
 // so we skip those tests for now
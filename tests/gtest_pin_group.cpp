@@ -0,0 +1,145 @@
+/**
+ * @file gtest_pin_group.cpp
+ * @brief GoogleTest unit tests for PinGroup multi-line requests
+ *
+ * Tests pin list validation and the lane transpose (run everywhere) and
+ * single-request writes/reads (skipped when /dev/gpiochip0 is not available).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "PinGroup.hpp"
+#include "exceptions.hpp"
+
+// Validation happens before any hardware access, so these run in CI
+
+TEST(PinGroupValidationTest, EmptyListThrows) {
+    EXPECT_THROW(PinGroup({}, PinDirection::OUTPUT), InvalidPinError);
+}
+
+TEST(PinGroupValidationTest, OutOfRangePinThrows) {
+    EXPECT_THROW(PinGroup({17, 28}, PinDirection::OUTPUT), InvalidPinError);
+    EXPECT_THROW(PinGroup({-1}, PinMode::INPUT), InvalidPinError);
+}
+
+TEST(PinGroupValidationTest, DuplicatePinThrows) {
+    EXPECT_THROW(PinGroup({17, 18, 17}, PinDirection::OUTPUT), InvalidPinError);
+}
+
+TEST(PinGroupValidationTest, TooManyPinsThrows) {
+    std::vector<int> pins(PinGroup::MAX_PINS + 1, 17);
+    EXPECT_THROW(PinGroup(pins, PinDirection::OUTPUT), InvalidPinError);
+}
+
+TEST(PinGroupTransposeTest, MatchesBitByBitTranspose) {
+    uint8_t bytes[19];
+    for (size_t i = 0; i < sizeof(bytes); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 73 + 5);
+    }
+
+    for (size_t lanes : {1u, 4u, 8u, 9u, 19u}) {
+        for (bool msbFirst : {true, false}) {
+            uint64_t masks[8];
+            PinGroup::transposeLanes(bytes, lanes, msbFirst, masks);
+            for (int j = 0; j < 8; ++j) {
+                int bit = msbFirst ? 7 - j : j;
+                uint64_t expected = 0;
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    expected |= uint64_t{((bytes[lane] >> bit) & 1u)} << lane;
+                }
+                EXPECT_EQ(masks[j], expected) << lanes << " lanes, clock " << j;
+            }
+        }
+    }
+}
+
+// Hardware tests
+class PinGroupHardwareTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        try {
+            PinGroup probe({17}, PinDirection::OUTPUT);
+        }
+        catch (const GpioAccessError& e) {
+            GTEST_SKIP() << "GPIO hardware not available: " << e.what();
+        }
+    }
+};
+
+TEST_F(PinGroupHardwareTest, SizeAndOrder) {
+    PinGroup bus({17, 27, 22}, PinDirection::OUTPUT);
+    ASSERT_EQ(bus.size(), 3u);
+    EXPECT_EQ(bus.pins()[0], 17u);
+    EXPECT_EQ(bus.pins()[1], 27u);
+    EXPECT_EQ(bus.pins()[2], 22u);
+}
+
+TEST_F(PinGroupHardwareTest, WriteAndReadBack) {
+    PinGroup bus({17, 27, 22}, PinDirection::OUTPUT);
+    EXPECT_TRUE(bus.writeAll(0b101));
+    EXPECT_EQ(bus.readAll(), 0b101);
+
+    // Only bit 1 changes, bits 0 and 2 keep their state
+    EXPECT_TRUE(bus.writeMask(0b010, 0b010));
+    EXPECT_EQ(bus.readAll(), 0b111);
+
+    EXPECT_TRUE(bus.writeAll(0));
+    EXPECT_EQ(bus.readAll(), 0);
+}
+
+TEST_F(PinGroupHardwareTest, EmptyMaskIsNoOp) {
+    PinGroup bus({17, 27}, PinDirection::OUTPUT);
+    EXPECT_TRUE(bus.writeMask(0, 0xFF));
+}
+
+TEST_F(PinGroupHardwareTest, BitOperationsUseTheShadow) {
+    PinGroup bus({17, 27, 22}, PinDirection::OUTPUT);
+    EXPECT_EQ(bus.getOutputState(), 0);
+
+    EXPECT_TRUE(bus.setBits(0b101));
+    EXPECT_EQ(bus.getOutputState(), 0b101);
+    EXPECT_TRUE(bus.toggleBits(0b011));
+    EXPECT_EQ(bus.getOutputState(), 0b110);
+    EXPECT_TRUE(bus.clearBits(0b100));
+    EXPECT_EQ(bus.getOutputState(), 0b010);
+    EXPECT_EQ(bus.readAll(), 0b010);
+    EXPECT_TRUE(bus.clearBits(0b101));            // Already low: no write
+    EXPECT_EQ(bus.getOutputState(), 0b010);
+}
+
+TEST_F(PinGroupHardwareTest, WriteOnInputGroupFails) {
+    PinGroup inputs({17, 27}, PinMode::INPUT_PULLDOWN);
+    EXPECT_FALSE(inputs.writeAll(0b11));
+    EXPECT_FALSE(inputs.writeMask(0b01, 0b01));
+    EXPECT_EQ(inputs.getOutputState(), -1);
+    EXPECT_GE(inputs.readAll(), 0);
+}
+
+TEST_F(PinGroupHardwareTest, ShiftOutLeavesClockLow) {
+    PinGroup bus({17, 27}, PinDirection::OUTPUT);
+    const uint8_t frame[3] = {0xA5, 0x01, 0x80};
+    EXPECT_TRUE(bus.shiftOut(0, 1, true, frame, sizeof(frame)));
+    EXPECT_EQ(bus.readAll() & 0b10, 0);           // Clock idles low
+    EXPECT_EQ(bus.readAll() & 0b01, 0);           // Last bit of 0x80 MSB first
+
+    EXPECT_TRUE(bus.shiftOut(0, 1, false, frame, sizeof(frame), 100));
+    EXPECT_EQ(bus.readAll(), 0b01);               // Last bit of 0x80 LSB first
+
+    EXPECT_FALSE(bus.shiftOut(0, 0, true, frame, 1));
+    EXPECT_FALSE(bus.shiftOut(0, 2, true, frame, 1));
+    EXPECT_FALSE(bus.shiftOut(0, 1, true, nullptr, 1));
+    EXPECT_TRUE(bus.shiftOut(0, 1, true, nullptr, 0));
+}
+
+TEST_F(PinGroupHardwareTest, ShiftOutLanesInLockstep) {
+    PinGroup chains({17, 27, 22}, PinDirection::OUTPUT);
+    const uint8_t frame[2 * 2] = {0x01, 0x80, 0x03, 0x02};   // Lane 0: 01 03, lane 1: 80 02
+    EXPECT_TRUE(chains.shiftOutLanes(2, 2, true, frame, 2));
+    EXPECT_EQ(chains.readAll(), 0b001);              // Last bits: lane 0 = 1, lane 1 = 0, clock low
+
+    EXPECT_FALSE(chains.shiftOutLanes(0, 2, true, frame, 2));
+    EXPECT_FALSE(chains.shiftOutLanes(2, 1, true, frame, 2));   // Clock inside the lanes
+    EXPECT_FALSE(chains.shiftOutLanes(2, 3, true, frame, 2));
+}
@@ -0,0 +1,413 @@
+/**
+ * @file gtest_pio.cpp
+ * @brief GoogleTest unit tests for PIO instruction encoding and the built-in programs
+ *
+ * The built-in programs are run on a small cycle-level model of a state
+ * machine (the subset of PIO they use), so their timing and decoding are
+ * checked without a Raspberry Pi 5.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "pio.hpp"
+#include "quadrature_encoder.hpp"
+#include <deque>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+/**
+ * One state machine: executes a PioProgram loaded at offset 0, one
+ * instruction per cycle plus delays, and records the pin levels after
+ * every cycle.
+ */
+class SimStateMachine {
+public:
+    SimStateMachine(const PioProgram& program, const PioSmConfig& config)
+        : program_(program), config_(config) {}
+
+    void exec(uint16_t instruction) { execute(instruction, true); }
+
+    void cycle() {
+        if (delay_ > 0) {
+            --delay_;
+        } else {
+            execute(program_.instructions().at(pc_), false);
+        }
+        trace.push_back(pins);
+    }
+
+    void run(size_t cycles) {
+        for (size_t i = 0; i < cycles; ++i) {
+            cycle();
+        }
+    }
+
+    std::deque<uint32_t> tx;
+    std::deque<uint32_t> rx;
+    uint32_t pins = 0;                   ///< Output levels, or input levels read by IN
+    std::vector<uint32_t> trace;
+    uint32_t x = 0, y = 0, isr = 0, osr = 0;
+
+private:
+    void execute(uint16_t instruction, bool forced) {
+        const unsigned field = (instruction >> 8) & 0x1f;
+        const unsigned sideBits = program_.sidesetBits();
+        const unsigned delayBits = 5 - sideBits - (program_.sidesetOptional() ? 1 : 0);
+        if (sideBits > 0 && (!program_.sidesetOptional() || (field & 0x10)) && config_.sidesetBase >= 0) {
+            uint32_t value = (field >> delayBits) & ((1u << sideBits) - 1);
+            uint32_t mask = ((1u << sideBits) - 1) << config_.sidesetBase;
+            pins = (pins & ~mask) | (value << config_.sidesetBase);
+        }
+
+        const unsigned arg1 = (instruction >> 5) & 7;
+        const unsigned arg2 = instruction & 0x1f;
+        unsigned next = pc_ == program_.wrap() ? program_.wrapTarget() : pc_ + 1;
+        bool stalled = false;
+
+        switch (instruction >> 13) {
+            case 0: {   // JMP
+                bool take = false;
+                switch (arg1) {
+                    case 0: take = true; break;
+                    case 1: take = x == 0; break;
+                    case 2: take = x != 0; --x; break;
+                    case 3: take = y == 0; break;
+                    case 4: take = y != 0; --y; break;
+                    case 5: take = x != y; break;
+                    default: ADD_FAILURE() << "JMP condition " << arg1 << " not modelled"; break;
+                }
+                if (take) {
+                    next = arg2;
+                }
+                break;
+            }
+            case 3: {   // OUT
+                if (config_.autopull && osrCount_ >= config_.pullThreshold) {
+                    if (tx.empty()) {
+                        stalled = true;
+                        break;
+                    }
+                    osr = tx.front();
+                    tx.pop_front();
+                    osrCount_ = 0;
+                }
+                const unsigned n = arg2 == 0 ? 32 : arg2;
+                const uint32_t mask = n == 32 ? 0xffffffffu : ((1u << n) - 1);
+                uint32_t data;
+                if (config_.outShiftRight) {
+                    data = osr & mask;
+                    osr = n == 32 ? 0 : osr >> n;
+                } else {
+                    data = n == 32 ? osr : osr >> (32 - n);
+                    osr = n == 32 ? 0 : osr << n;
+                }
+                osrCount_ += n;
+                switch (arg1) {
+                    case 0: pins = data << config_.outBase; break;
+                    case 1: x = data; break;
+                    case 2: y = data; break;
+                    case 3: break;
+                    case 6: isr = data; isrCount_ = n; break;
+                    default: ADD_FAILURE() << "OUT destination " << arg1 << " not modelled"; break;
+                }
+                break;
+            }
+            case 4: {   // PUSH / PULL
+                const bool block = instruction & 0x20;
+                if (instruction & 0x80) {
+                    if (tx.empty()) {
+                        if (block) {
+                            stalled = true;
+                        } else {
+                            osr = x;
+                            osrCount_ = 0;
+                        }
+                    } else {
+                        osr = tx.front();
+                        tx.pop_front();
+                        osrCount_ = 0;
+                    }
+                } else {
+                    if (rx.size() < 8) {
+                        rx.push_back(isr);
+                    } else if (block) {
+                        stalled = true;
+                        break;
+                    }
+                    isr = 0;
+                    isrCount_ = 0;
+                }
+                break;
+            }
+            case 2: {   // IN
+                const unsigned n = arg2 == 0 ? 32 : arg2;
+                uint32_t value = source(arg1);
+                if (n < 32) {
+                    value &= (1u << n) - 1;
+                }
+                if (config_.inShiftRight) {
+                    isr = (n == 32 ? 0 : isr >> n) | (value << (32 - n));
+                } else {
+                    isr = (n == 32 ? 0 : isr << n) | value;
+                }
+                isrCount_ += n;
+                break;
+            }
+            case 5: {   // MOV
+                uint32_t value = source(instruction & 7);
+                const unsigned op = (instruction >> 3) & 3;
+                if (op == 1) {
+                    value = ~value;
+                } else if (op == 2) {
+                    uint32_t reversed = 0;
+                    for (int bit = 0; bit < 32; ++bit) {
+                        reversed |= ((value >> bit) & 1u) << (31 - bit);
+                    }
+                    value = reversed;
+                }
+                switch (arg1) {
+                    case 1: x = value; break;
+                    case 2: y = value; break;
+                    case 5: next = value & 0x1f; break;
+                    case 6: isr = value; isrCount_ = 0; break;
+                    case 7: osr = value; osrCount_ = 0; break;
+                    default: ADD_FAILURE() << "MOV destination " << arg1 << " not modelled"; break;
+                }
+                break;
+            }
+            default:
+                ADD_FAILURE() << "Instruction 0x" << std::hex << instruction << " not modelled";
+                break;
+        }
+
+        if (forced) {
+            if ((instruction >> 13) == 0 || ((instruction >> 13) == 5 && arg1 == 5)) {
+                pc_ = next;
+            }
+            return;
+        }
+        if (!stalled) {
+            pc_ = next;
+            delay_ = field & ((1u << delayBits) - 1);
+        }
+    }
+
+    uint32_t source(unsigned index) const {
+        switch (index) {
+            case 0: return config_.inBase >= 0 ? pins >> config_.inBase : pins;
+            case 1: return x;
+            case 2: return y;
+            case 3: return 0;
+            case 6: return isr;
+            case 7: return osr;
+            default: ADD_FAILURE() << "Source " << index << " not modelled"; return 0;
+        }
+    }
+
+    PioProgram program_;
+    PioSmConfig config_;
+    unsigned pc_ = 0;
+    unsigned delay_ = 0;
+    unsigned osrCount_ = 32;   // Empty: the first autopull refills
+    unsigned isrCount_ = 0;
+};
+
+// Lengths of consecutive runs of one level of @p bit in a trace, starting at index @p from
+std::vector<std::pair<bool, size_t>> runs(const std::vector<uint32_t>& trace, int bit, size_t from = 0) {
+    std::vector<std::pair<bool, size_t>> result;
+    for (size_t i = from; i < trace.size(); ++i) {
+        bool level = (trace[i] >> bit) & 1;
+        if (result.empty() || result.back().first != level) {
+            result.push_back({level, 0});
+        }
+        ++result.back().second;
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(PioEncodingTest, InstructionsMatchPioasm) {
+    static_assert(pioJmp(PioJmp::Y_DEC, 3) == 0x0083, "jmp y--, 3");
+    static_assert(pioJmp(PioJmp::X_NE_Y, 5) == 0x00a5, "jmp x!=y, 5");
+    static_assert(pioWait(true, PioWaitSource::PIN, 0) == 0x20a0, "wait 1 pin 0");
+    static_assert(pioIn(PioInSource::PINS, 2) == 0x4002, "in pins, 2");
+    static_assert(pioOut(PioOutDest::X, 1) == 0x6021, "out x, 1");
+    static_assert(pioOut(PioOutDest::ISR, 32) == 0x60c0, "out isr, 32");
+    static_assert(pioPush(false, false) == 0x8000, "push noblock");
+    static_assert(pioPull() == 0x80a0, "pull block");
+    static_assert(pioMov(PioMovDest::PC, PioMovSource::ISR) == 0xa0a6, "mov pc, isr");
+    static_assert(pioMov(PioMovDest::Y, PioMovSource::Y, PioMovOp::INVERT) == 0xa04a, "mov y, ~y");
+    static_assert(pioNop() == 0xa042, "nop");
+    static_assert(pioIrq(false, true, 4) == 0xc024, "irq wait 4");
+    static_assert(pioSet(PioSetDest::PINDIRS, 1) == 0xe081, "set pindirs, 1");
+    SUCCEED();
+}
+
+TEST(PioEncodingTest, BuiltInProgramsMatchPicoExamples) {
+    // pioasm output of pico-examples ws2812.pio and pwm.pio
+    EXPECT_EQ(pioWs2812Program().instructions(), (std::vector<uint16_t>{0x6221, 0x1123, 0x1400, 0xa442}));
+    EXPECT_EQ(pioPwmProgram().instructions(),
+              (std::vector<uint16_t>{0x9080, 0xa027, 0xa046, 0x00a5, 0x1806, 0xa042, 0x0083}));
+
+    PioProgram quadrature = pioQuadratureProgram();
+    EXPECT_EQ(quadrature.origin(), 0);
+    EXPECT_EQ(quadrature.size(), 26u);
+    EXPECT_EQ(quadrature.wrapTarget(), 17);
+    EXPECT_EQ(quadrature.wrap(), 25);
+}
+
+TEST(PioProgramTest, RejectsWhatDoesNotEncode) {
+    EXPECT_THROW(PioProgram(5, true), std::invalid_argument);
+
+    PioProgram sideset(2);
+    EXPECT_EQ(sideset.maxDelay(), 7);
+    EXPECT_THROW(sideset.add(pioNop(), 8, 0), std::invalid_argument);
+    EXPECT_THROW(sideset.add(pioNop()), std::invalid_argument);          // Side-set required
+    EXPECT_THROW(sideset.add(pioNop(), 0, 4), std::invalid_argument);    // Too wide
+
+    PioProgram plain;
+    EXPECT_THROW(plain.add(pioNop(), 0, 1), std::invalid_argument);
+    for (size_t i = 0; i < PIO_MAX_INSTRUCTIONS; ++i) {
+        plain.add(pioNop(), 31);
+    }
+    EXPECT_THROW(plain.add(pioNop()), std::invalid_argument);
+    EXPECT_THROW(pioParallelOutputProgram(0), std::invalid_argument);
+}
+
+TEST(PioProgramTest, StateMachineFailsCleanlyWithoutPio) {
+    if (PioStateMachine::isSupported()) {
+        GTEST_SKIP() << "PIO present";
+    }
+    PioStateMachine sm;
+    EXPECT_FALSE(sm.begin(pioWs2812Program(), PioSmConfig()));
+    EXPECT_FALSE(sm.isBegun());
+    EXPECT_FALSE(sm.put(1));
+    uint32_t word;
+    EXPECT_FALSE(sm.tryGet(word));
+    sm.end();
+}
+
+TEST(PioProgramSimTest, Ws2812BitTiming) {
+    PioSmConfig config;
+    config.sidesetBase = 0;
+    config.outShiftRight = false;
+    config.autopull = true;
+    config.pullThreshold = 24;
+    SimStateMachine sm(pioWs2812Program(), config);
+    const uint32_t pixel = 0xA5C30F;
+    sm.tx.push_back(pixel << 8);
+    sm.run(24 * PIO_WS2812_CYCLES_PER_BIT + 20);
+
+    // Every bit: HIGH 2 cycles for 0 or 7 for 1, period exactly 10 cycles
+    auto levels = runs(sm.trace, 0);
+    uint32_t decoded = 0;
+    size_t bits = 0;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        if (!levels[i].first) {
+            continue;
+        }
+        ASSERT_TRUE(levels[i].second == 2 || levels[i].second == 7) << "HIGH for " << levels[i].second;
+        decoded = (decoded << 1) | (levels[i].second == 7 ? 1u : 0u);
+        ++bits;
+        if (bits < 24) {
+            ASSERT_LT(i + 1, levels.size());
+            EXPECT_EQ(levels[i].second + levels[i + 1].second, PIO_WS2812_CYCLES_PER_BIT);
+        }
+    }
+    EXPECT_EQ(bits, 24u);
+    EXPECT_EQ(decoded, pixel);
+    EXPECT_EQ(sm.trace.back() & 1, 0u);    // LOW while waiting for data (latch)
+}
+
+TEST(PioProgramSimTest, QuadratureMatchesDecoder) {
+    PioSmConfig config;
+    config.inBase = 4;
+    config.inCount = 2;
+    config.inShiftRight = false;
+    SimStateMachine sm(pioQuadratureProgram(), config);
+
+    // Random walk over the four states with occasional double steps (invalid)
+    std::mt19937 rng(7);
+    uint8_t state = 0;            // QuadratureDecoder order: (A << 1) | B
+    auto setPins = [&](uint8_t s) { sm.pins = static_cast<uint32_t>((((s >> 1) & 1) | ((s & 1) << 1)) << 4); };
+    setPins(state);
+    sm.exec(pioIn(PioInSource::PINS, 2));
+    sm.exec(pioMov(PioMovDest::OSR, PioMovSource::ISR));
+
+    static const uint8_t GRAY[4] = {0, 2, 3, 1};   // Counting-up order
+    int position = 0;
+    int64_t expected = 0;
+    uint32_t latest = 0;
+    for (int i = 0; i < 2000; ++i) {
+        int move = static_cast<int>(rng() % 7) - 3;   // -3..3 positions: some are invalid jumps
+        move = (move == 3 || move == -3) ? 2 : move;
+        int next = ((position + move) % 4 + 4) % 4;
+        uint8_t nextState = GRAY[next];
+        int step = QuadratureDecoder::transition(state, nextState);
+        if (step == 1 || step == -1) {
+            expected += step;
+        }
+        position = next;
+        state = nextState;
+        setPins(state);
+        sm.run(20);
+        ASSERT_FALSE(sm.rx.empty());
+        latest = sm.rx.back();    // The host drains the FIFO and keeps the newest count
+        sm.rx.clear();
+    }
+    EXPECT_EQ(static_cast<int32_t>(latest), expected);
+    EXPECT_NE(expected, 0);
+}
+
+TEST(PioProgramSimTest, PwmDutyCycle) {
+    PioSmConfig config;
+    config.sidesetBase = 3;
+    SimStateMachine sm(pioPwmProgram(), config);
+    const uint32_t period = 99;
+    sm.tx.push_back(period);
+    sm.exec(pioPull(false, false));
+    sm.exec(pioOut(PioOutDest::ISR, 32));
+    sm.tx.push_back(25);
+    sm.run(5000);
+
+    size_t high = 0;
+    auto levels = runs(sm.trace, 3, 1000);      // Complete periods only: skip the first and last run
+    for (size_t i = 1; i + 2 < levels.size(); ++i) {
+        if (levels[i].first) {
+            high = levels[i].second;
+            size_t cycleLength = levels[i].second + levels[i + 1].second;
+            EXPECT_NEAR(static_cast<double>(high) / cycleLength, 0.26, 0.02);
+        }
+    }
+    EXPECT_GT(high, 0u);
+}
+
+TEST(PioProgramSimTest, WaveStepsHoldForDelayPlusOverhead) {
+    PioSmConfig config;
+    config.outBase = 0;
+    config.outCount = 32;
+    SimStateMachine sm(pioWaveProgram(), config);
+    const uint32_t delays[] = {0, 10, 3, 50};
+    const uint32_t levels[] = {0x1, 0x3, 0x2, 0x0};
+    for (int i = 0; i < 4; ++i) {
+        sm.tx.push_back(levels[i]);
+        sm.tx.push_back(delays[i]);
+    }
+    sm.run(200);
+
+    auto held = runs(sm.trace, 0);
+    // Bit 0: 0 for 1 cycle (pull), then HIGH through steps 0 and 1, then LOW
+    ASSERT_GE(held.size(), 3u);
+    EXPECT_EQ(held[1].second, (delays[0] + PIO_WAVE_STEP_CYCLES) + (delays[1] + PIO_WAVE_STEP_CYCLES));
+    auto bit1 = runs(sm.trace, 1);
+    ASSERT_GE(bit1.size(), 3u);
+    EXPECT_EQ(bit1[1].second, (delays[1] + PIO_WAVE_STEP_CYCLES) + (delays[2] + PIO_WAVE_STEP_CYCLES));
+}
@@ -9,7 +9,10 @@
 
 #include <gtest/gtest.h>
 #include "platform.hpp"
+#include <cstdio>
 #include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace pipinpp;
 
@@ -339,6 +342,109 @@ TEST_F(PlatformTest, SupportedPlatforms) {
     }
 }
 
+// Narrow getters agree with the full capability set
+TEST_F(PlatformTest, LazyGettersMatchCapabilities) {
+    auto& platform = PlatformInfo::instance();
+    const auto& caps = platform.getCapabilities();
+    
+    EXPECT_EQ(platform.getGPIOChips().size(), caps.gpioChips.size());
+    EXPECT_EQ(platform.getI2CBuses().size(), caps.i2cBuses.size());
+    EXPECT_EQ(platform.getPWMChannels().size(), caps.pwmChannels.size());
+    EXPECT_EQ(platform.getPeripheralBase(), caps.peripheralBase);
+    EXPECT_FALSE(platform.getKernelVersion().empty());
+}
+
+// Cache file round trip
+TEST_F(PlatformTest, CacheRoundTrip) {
+    std::string path = "/tmp/pipinpp_gtest_platform_" + std::to_string(::getpid());
+    
+    PlatformCapabilities caps{};
+    caps.gpioChips.push_back({"gpiochip0", "pinctrl-rp1", 54, true});
+    caps.gpioChips.push_back({"gpiochip1", "label with spaces", 8, false});
+    caps.i2cBuses.push_back({20, "/dev/i2c-20", true});
+    caps.pwmChannels.push_back({0, 1, 19, "/sys/class/pwm/pwmchip0", false});
+    caps.totalGPIOPins = 62;
+    caps.hasDMASupport = true;
+    caps.peripheralBase = 0xFE000000;
+    ASSERT_TRUE(savePlatformCache(path, Platform::RASPBERRY_PI_5, caps));
+    
+    Platform platform = Platform::UNKNOWN;
+    PlatformCapabilities loaded{};
+    ASSERT_TRUE(loadPlatformCache(path, platform, loaded));
+    EXPECT_EQ(platform, Platform::RASPBERRY_PI_5);
+    ASSERT_EQ(loaded.gpioChips.size(), 2u);
+    EXPECT_EQ(loaded.gpioChips[0].label, "pinctrl-rp1");
+    EXPECT_EQ(loaded.gpioChips[1].label, "label with spaces");
+    EXPECT_FALSE(loaded.gpioChips[1].available);
+    EXPECT_EQ(loaded.totalGPIOPins, 62);
+    ASSERT_EQ(loaded.i2cBuses.size(), 1u);
+    EXPECT_EQ(loaded.i2cBuses[0].devicePath, "/dev/i2c-20");
+    ASSERT_EQ(loaded.pwmChannels.size(), 1u);
+    EXPECT_EQ(loaded.pwmChannels[0].gpioPin, 19);
+    EXPECT_EQ(loaded.pwmChannels[0].sysfsPath, "/sys/class/pwm/pwmchip0");
+    EXPECT_TRUE(loaded.hasDMASupport);
+    EXPECT_EQ(loaded.peripheralBase, 0u);      // Not stored: derived from the model
+    
+    std::remove(path.c_str());
+}
+
+// Caches from another boot (or kernel, or user) are ignored
+TEST_F(PlatformTest, CacheWithStaleKeyIsRejected) {
+    std::string path = "/tmp/pipinpp_gtest_platform_stale_" + std::to_string(::getpid());
+    Platform platform = Platform::UNKNOWN;
+    PlatformCapabilities caps{};
+    
+    EXPECT_FALSE(loadPlatformCache(path, platform, caps));
+    
+    std::ofstream(path) << "pipinpp-platform 1\nnot-this-boot 1.0 0\nplatform 3\ndma 0 0\n";
+    EXPECT_FALSE(loadPlatformCache(path, platform, caps));
+    
+    std::ofstream(path) << "something else\n";
+    EXPECT_FALSE(loadPlatformCache(path, platform, caps));
+    
+    std::remove(path.c_str());
+}
+
+// A cache someone else could have written is not trusted
+TEST_F(PlatformTest, PlantedCacheIsRejected) {
+    std::string path = "/tmp/pipinpp_gtest_platform_planted_" + std::to_string(::getpid());
+    PlatformCapabilities caps{};
+    ASSERT_TRUE(savePlatformCache(path, Platform::RASPBERRY_PI_4, caps));
+    
+    Platform platform = Platform::UNKNOWN;
+    ASSERT_EQ(::chmod(path.c_str(), 0666), 0);
+    EXPECT_FALSE(loadPlatformCache(path, platform, caps));
+    
+    std::string link = path + ".link";
+    ASSERT_EQ(::chmod(path.c_str(), 0600), 0);
+    ASSERT_EQ(::symlink(path.c_str(), link.c_str()), 0);
+    EXPECT_FALSE(loadPlatformCache(link, platform, caps));
+    EXPECT_TRUE(loadPlatformCache(path, platform, caps));
+    
+    std::remove(link.c_str());
+    std::remove(path.c_str());
+}
+
+// refresh() writes the cache, and it matches live detection
+TEST_F(PlatformTest, RefreshWritesCache) {
+    std::string path = "/tmp/pipinpp_gtest_platform_refresh_" + std::to_string(::getpid());
+    auto& platform = PlatformInfo::instance();
+    platform.setCachePath(path);
+    EXPECT_EQ(platform.getCachePath(), path);
+    platform.refresh();
+    EXPECT_FALSE(platform.isFromCache());
+    
+    Platform cached = Platform::UNKNOWN;
+    PlatformCapabilities caps{};
+    ASSERT_TRUE(loadPlatformCache(path, cached, caps));
+    EXPECT_EQ(cached, platform.getPlatform());
+    EXPECT_EQ(caps.gpioChips.size(), platform.getGPIOChips().size());
+    EXPECT_EQ(caps.i2cBuses.size(), platform.getI2CBuses().size());
+    
+    platform.setCachePath("");
+    std::remove(path.c_str());
+}
+
 int main(int argc, char** argv) 
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,79 @@
+/**
+ * @file gtest_precise_delay.cpp
+ * @brief GoogleTest unit tests for calibrated sleep-then-spin delays
+ *
+ * Tests timespec arithmetic, the spin counter, calibration bounds and that
+ * delays and deadlines are never early (and not grossly late).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "precise_delay.hpp"
+
+using namespace pipinpp;
+
+TEST(PreciseDelayTest, AddNsNormalizes) {
+    timespec ts{10, 999999000};
+    addNs(ts, 2000);
+    EXPECT_EQ(ts.tv_sec, 11);
+    EXPECT_EQ(ts.tv_nsec, 1000);
+
+    addNs(ts, -3000);
+    EXPECT_EQ(ts.tv_sec, 10);
+    EXPECT_EQ(ts.tv_nsec, 999998000);
+
+    addNs(ts, 2500000000LL);
+    EXPECT_EQ(ts.tv_sec, 13);
+    EXPECT_EQ(ts.tv_nsec, 499998000);
+}
+
+TEST(PreciseDelayTest, CycleCounterAdvances) {
+    EXPECT_GT(cycleCounterHz(), 0u);
+    uint64_t a = readCycleCounter();
+    preciseDelayUs(200);
+    uint64_t b = readCycleCounter();
+    EXPECT_GT(b, a);
+    // At least 200 µs worth of ticks
+    EXPECT_GE((b - a) * 1000000000ull / cycleCounterHz(), 199000u);
+}
+
+TEST(PreciseDelayTest, CalibrationWithinBounds) {
+    PreciseDelayCalibration cal = calibratePreciseDelay(8);
+    EXPECT_GE(cal.maxOvershootNs, cal.medianOvershootNs);
+    EXPECT_GE(cal.spinNs, PRECISE_DELAY_MIN_SPIN_NS);
+    EXPECT_LE(cal.spinNs, PRECISE_DELAY_MAX_SPIN_NS);
+    EXPECT_EQ(cal.counterHz, cycleCounterHz());
+
+    PreciseDelayCalibration current = getPreciseDelayCalibration();
+    EXPECT_EQ(current.medianOvershootNs, cal.medianOvershootNs);
+    EXPECT_GE(current.spinNs, PRECISE_DELAY_MIN_SPIN_NS);
+}
+
+TEST(PreciseDelayTest, NeverEarly) {
+    for (uint64_t ns : {0ull, 1000ull, 50000ull, 500000ull, 3000000ull}) {
+        int64_t start = monotonicNowNs();
+        preciseDelayNs(ns);
+        int64_t elapsed = monotonicNowNs() - start;
+        EXPECT_GE(elapsed, static_cast<int64_t>(ns));
+        EXPECT_LT(elapsed, static_cast<int64_t>(ns) + 20000000) << "delay of " << ns << " ns";
+    }
+}
+
+TEST(PreciseDelayTest, SleepUntilDeadline) {
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    for (int i = 0; i < 5; ++i) {
+        addNs(deadline, 300000);
+        preciseSleepUntil(deadline);
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        EXPECT_TRUE(now.tv_sec > deadline.tv_sec ||
+                    (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec));
+    }
+
+    int64_t start = monotonicNowNs();
+    preciseSleepUntilNs(start - 1000000);             // Already passed
+    EXPECT_LT(monotonicNowNs() - start, 1000000);
+}
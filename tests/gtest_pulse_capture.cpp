@@ -0,0 +1,100 @@
+/**
+ * @file gtest_pulse_capture.cpp
+ * @brief GoogleTest unit tests for edge-timestamp pulse measurement
+ *
+ * Tests the edge-to-pulse state machine without hardware, argument
+ * validation of PulseCapture, and capture/measurement on a real input
+ * when GPIO is available (skipped otherwise).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "pulse_capture.hpp"
+#include "exceptions.hpp"
+#include "pin.hpp"
+
+using namespace pipinpp;
+
+TEST(PulseTrackerTest, WidthsFromConsecutiveEdges) {
+    PulseTracker tracker;
+    Pulse pulse;
+
+    EXPECT_FALSE(tracker.onEdge(true, 1000, pulse));     // First edge only starts
+    ASSERT_TRUE(tracker.onEdge(false, 59000, pulse));
+    EXPECT_TRUE(pulse.level);
+    EXPECT_EQ(pulse.startNs, 1000u);
+    EXPECT_EQ(pulse.widthNs, 58000u);
+
+    ASSERT_TRUE(tracker.onEdge(true, 100000, pulse));
+    EXPECT_FALSE(pulse.level);
+    EXPECT_EQ(pulse.startNs, 59000u);
+    EXPECT_EQ(pulse.widthNs, 41000u);
+}
+
+TEST(PulseTrackerTest, SameDirectionEdgeRestarts) {
+    PulseTracker tracker;
+    Pulse pulse;
+
+    tracker.onEdge(true, 1000, pulse);
+    EXPECT_FALSE(tracker.onEdge(true, 5000, pulse));     // Falling edge was lost
+    ASSERT_TRUE(tracker.onEdge(false, 7000, pulse));
+    EXPECT_EQ(pulse.startNs, 5000u);
+    EXPECT_EQ(pulse.widthNs, 2000u);
+}
+
+TEST(PulseTrackerTest, ResetForgetsPreviousEdge) {
+    PulseTracker tracker;
+    Pulse pulse;
+
+    tracker.onEdge(true, 1000, pulse);
+    tracker.reset();
+    EXPECT_FALSE(tracker.onEdge(false, 2000, pulse));
+    EXPECT_TRUE(tracker.onEdge(true, 2500, pulse));
+    EXPECT_FALSE(pulse.level);
+    EXPECT_EQ(pulse.widthNs, 500u);
+}
+
+TEST(PulseCaptureTest, RejectsInvalidArguments) {
+    EXPECT_THROW(PulseCapture(-1), InvalidPinError);
+    EXPECT_THROW(PulseCapture(99), InvalidPinError);
+    EXPECT_THROW(PulseCapture(17, 0), InvalidPinError);
+}
+
+TEST(PulseCaptureTest, TimesOutWithoutEdges) {
+    try {
+        PulseCapture capture(17, 4);
+        Pulse pulse;
+        EXPECT_FALSE(capture.waitPulse(true, 20000, pulse));
+        EXPECT_EQ(capture.pulseIn(true, 20000), 0u);
+        EXPECT_EQ(capture.available(), 0u);
+        EXPECT_FALSE(capture.read(pulse));
+        EXPECT_EQ(capture.getPin(), 17);
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
+
+TEST(PulseCaptureTest, MeasurePulseTimesOutOnIdleInput) {
+    try {
+        Pin input(17, PinMode::INPUT_PULLDOWN);
+        EXPECT_EQ(measurePulse(input, true, 20000), 0);
+        EXPECT_TRUE(input.edgeEventsEnabled());
+        EXPECT_GE(input.read(), 0);                          // Still readable with edges on
+        EXPECT_TRUE(input.enableEdgeEvents(false));
+        EXPECT_FALSE(input.edgeEventsEnabled());
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
+
+TEST(PulseCaptureTest, OutputPinsCannotReportEdges) {
+    try {
+        Pin output(17, PinDirection::OUTPUT);
+        EXPECT_FALSE(output.enableEdgeEvents());
+        EXPECT_EQ(measurePulse(output, true, 1000), -1);
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @file gtest_pwm_backend.cpp
+ * @brief GoogleTest unit tests for per-pin PWM backend selection
+ *
+ * Tests backend choice by pin and frequency, preferred-backend fallback,
+ * argument validation and routing through analogWrite() where GPIO is
+ * available.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "pwm_backend.hpp"
+#include "ArduinoCompat.hpp"
+#include "exceptions.hpp"
+
+using namespace pipinpp;
+
+class PwmBackendTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        PwmRouter::getInstance().setPreferredBackend(PwmBackend::AUTO);
+    }
+};
+
+TEST_F(PwmBackendTest, BackendNames) {
+    EXPECT_STREQ(pwmBackendName(PwmBackend::AUTO), "auto");
+    EXPECT_STREQ(pwmBackendName(PwmBackend::HARDWARE), "hardware");
+    EXPECT_STREQ(pwmBackendName(PwmBackend::DMA), "dma");
+    EXPECT_STREQ(pwmBackendName(PwmBackend::EVENT), "event");
+    EXPECT_STREQ(pwmBackendName(PwmBackend::SOFTWARE), "software");
+}
+
+TEST_F(PwmBackendTest, PlainPinUsesSharedEventThread) {
+    // GPIO17 has no PWM channel and DMA PWM is not begun
+    auto& router = PwmRouter::getInstance();
+    EXPECT_EQ(router.select(17), PwmBackend::EVENT);
+    EXPECT_EQ(router.select(17, 1000), PwmBackend::EVENT);
+}
+
+TEST_F(PwmBackendTest, OutOfRangeFrequencyUsesPerPinThread) {
+    auto& router = PwmRouter::getInstance();
+    EXPECT_EQ(router.select(17, 20), PwmBackend::SOFTWARE);
+    EXPECT_EQ(router.select(17, 20000), PwmBackend::SOFTWARE);
+}
+
+TEST_F(PwmBackendTest, PreferredBackendFallsBackWhenUnusable) {
+    auto& router = PwmRouter::getInstance();
+    router.setPreferredBackend(PwmBackend::SOFTWARE);
+    EXPECT_EQ(router.getPreferredBackend(), PwmBackend::SOFTWARE);
+    EXPECT_EQ(router.select(17), PwmBackend::SOFTWARE);
+
+    router.setPreferredBackend(PwmBackend::DMA);
+    EXPECT_EQ(router.select(17), PwmBackend::EVENT);
+}
+
+TEST_F(PwmBackendTest, InvalidPinThrows) {
+    EXPECT_THROW(PwmRouter::getInstance().write(-1, 128), InvalidPinError);
+    EXPECT_THROW(PwmRouter::getInstance().write(28, 128), InvalidPinError);
+}
+
+TEST_F(PwmBackendTest, IdlePinHasNoBackend) {
+    auto& router = PwmRouter::getInstance();
+    EXPECT_EQ(router.getBackend(5), PwmBackend::AUTO);
+    EXPECT_FALSE(router.isActive(5));
+    EXPECT_FALSE(router.stop(5));
+}
+
+TEST_F(PwmBackendTest, AnalogWriteIsRouted) {
+    try {
+        analogWrite(17, 128);
+        auto& router = PwmRouter::getInstance();
+        EXPECT_EQ(router.getBackend(17), PwmBackend::EVENT);
+        analogWrite(17, 64);
+        EXPECT_EQ(router.getActiveCount(), 1u);
+        EXPECT_TRUE(router.stop(17));
+        EXPECT_FALSE(router.isActive(17));
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
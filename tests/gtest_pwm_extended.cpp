@@ -12,6 +12,7 @@
 #include <gtest/gtest.h>
 #include "ArduinoCompat.hpp"
 #include "exceptions.hpp"
+#include "pwm.hpp"
 #include <thread>
 #include <chrono>
 
@@ -430,3 +431,45 @@ TEST_F(PWMExtendedTest, PWMPatternGeneration) {
         GTEST_SKIP() << "GPIO access not available: " << e.what();
     }
 }
+
+// ============================================================================
+// CHANNEL HANDLES
+// ============================================================================
+
+// Test: Handles of inactive pins are empty
+TEST_F(PWMExtendedTest, ChannelHandleEmptyWhenInactive) {
+    PWMChannelHandle none;
+    EXPECT_FALSE(none);
+    EXPECT_EQ(none.getPin(), -1);
+    EXPECT_FALSE(none.setDutyCycle(128));
+    EXPECT_EQ(none.getDutyCycle(), -1);
+
+    PWMChannelHandle idle = PWMManager::getInstance().channel(5);
+    EXPECT_FALSE(idle.isActive());
+    EXPECT_FALSE(idle.setFrequency(1000));
+    EXPECT_EQ(idle.getFrequency(), -1);
+}
+
+// Test: Handle updates are visible to the manager and stop with the channel
+TEST_F(PWMExtendedTest, ChannelHandleUpdates) {
+    try {
+        auto& manager = PWMManager::getInstance();
+        manager.startPWM(19, 10);
+        PWMChannelHandle handle = manager.channel(19);
+        ASSERT_TRUE(handle);
+        EXPECT_EQ(handle.getPin(), 19);
+
+        EXPECT_TRUE(handle.setDutyCycle(300));
+        EXPECT_EQ(handle.getDutyCycle(), 255);
+        EXPECT_EQ(manager.getDutyCycle(19), 255);
+        EXPECT_TRUE(handle.setFrequency(1000));
+        EXPECT_EQ(manager.getFrequency(19), 1000);
+        std::this_thread::sleep_for(20ms);
+
+        EXPECT_TRUE(manager.stopPWM(19));
+        EXPECT_FALSE(handle);
+        EXPECT_FALSE(handle.setDutyCycle(64));
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file gtest_pwm_timing.cpp
+ * @brief GoogleTest unit tests for integer nanosecond PWM edge scheduling
+ *
+ * Tests PwmTiming conversions and PwmEdgeClock deadline chaining. No GPIO
+ * hardware is required.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "pwm_timing.hpp"
+#include <atomic>
+
+using namespace pipinpp;
+
+namespace {
+
+int64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+int64_t toNs(const timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+} // namespace
+
+TEST(PwmTimingTest, EightBitDuty) {
+    PwmTiming timing = PwmTiming::fromDuty8Bit(1000, 255);
+    EXPECT_EQ(timing.periodNs, 1000000);
+    EXPECT_EQ(timing.onNs, 1000000);
+    EXPECT_TRUE(timing.alwaysHigh());
+
+    timing = PwmTiming::fromDuty8Bit(1000, 0);
+    EXPECT_TRUE(timing.alwaysLow());
+
+    timing = PwmTiming::fromDuty8Bit(490, 128);
+    EXPECT_EQ(timing.periodNs, 2040816);
+    EXPECT_EQ(timing.onNs, (2040816LL * 128) / 255);
+    EXPECT_FALSE(timing.alwaysLow());
+    EXPECT_FALSE(timing.alwaysHigh());
+}
+
+TEST(PwmTimingTest, PercentDuty) {
+    PwmTiming timing = PwmTiming::fromPercent(1000.0, 25.0);
+    EXPECT_EQ(timing.periodNs, 1000000);
+    EXPECT_EQ(timing.onNs, 250000);
+
+    // Out-of-range duty is clamped
+    EXPECT_TRUE(PwmTiming::fromPercent(1000.0, 150.0).alwaysHigh());
+    EXPECT_TRUE(PwmTiming::fromPercent(1000.0, -5.0).alwaysLow());
+}
+
+TEST(PwmEdgeClockTest, CycleStartAdvancesByExactPeriods) {
+    PwmEdgeClock clock(0);
+    int64_t start = toNs(clock.cycleStart());
+
+    // Periods long enough that a loaded machine does not wake a whole
+    // period late, which would (correctly) resync instead
+    std::atomic<bool> active{true};
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(clock.waitUntil(10000000, active));
+        clock.nextCycle(10000000);
+    }
+
+    // Wakeup lateness does not accumulate into the cycle start
+    EXPECT_EQ(toNs(clock.cycleStart()) - start, 5 * 10000000);
+}
+
+TEST(PwmEdgeClockTest, WaitReachesDeadline) {
+    PwmEdgeClock clock;
+    std::atomic<bool> active{true};
+
+    EXPECT_TRUE(clock.waitUntil(2000000, active));
+    EXPECT_GE(nowNs(), toNs(clock.cycleStart()) + 2000000);
+}
+
+TEST(PwmEdgeClockTest, InactiveAbortsWait) {
+    PwmEdgeClock clock;
+    std::atomic<bool> active{false};
+
+    int64_t before = nowNs();
+    EXPECT_FALSE(clock.waitUntil(1000000000, active));
+    EXPECT_LT(nowNs() - before, 100000000);
+}
+
+TEST(PwmEdgeClockTest, ResynchronizesWhenFarBehind) {
+    PwmEdgeClock clock(0);
+    std::atomic<bool> active{true};
+
+    // Simulate a thread that stalled for many periods
+    clock.waitUntil(5000000, active);
+    clock.nextCycle(1000000);
+
+    EXPECT_GE(toNs(clock.cycleStart()), nowNs() - 1000000);
+}
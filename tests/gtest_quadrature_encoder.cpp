@@ -0,0 +1,175 @@
+/**
+ * @file gtest_quadrature_encoder.cpp
+ * @brief GoogleTest unit tests for the quadrature encoder decoder
+ *
+ * Tests the state table, counting in both directions, lost-event detection,
+ * velocity estimation and decay without hardware, plus argument validation
+ * and construction of QuadratureEncoder when GPIO is available (skipped
+ * otherwise).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "quadrature_encoder.hpp"
+#include "exceptions.hpp"
+
+using namespace pipinpp;
+
+namespace {
+
+constexpr int PIN_A = 5;
+constexpr int PIN_B = 6;
+
+// Feeds edges with consecutive sequence numbers and advancing timestamps
+struct EdgeFeeder {
+    explicit EdgeFeeder(QuadratureDecoder& d) : decoder(d) {}
+
+    int edge(int pin, bool rising, uint64_t advanceNs = 1000000, unsigned long skip = 0) {
+        nowNs += advanceNs;
+        seqno += 1 + skip;
+        EdgeEvent event{pin, rising ? EdgeType::RISING : EdgeType::FALLING, nowNs, seqno, seqno};
+        return decoder.onEdge(event);
+    }
+
+    // One full cycle forward (A leads B) from state 00
+    void forwardCycle(uint64_t advanceNs = 1000000) {
+        edge(PIN_A, true, advanceNs);
+        edge(PIN_B, true, advanceNs);
+        edge(PIN_A, false, advanceNs);
+        edge(PIN_B, false, advanceNs);
+    }
+
+    QuadratureDecoder& decoder;
+    uint64_t nowNs = 0;
+    unsigned long seqno = 0;
+};
+
+} // namespace
+
+TEST(QuadratureDecoderTest, TransitionTable) {
+    EXPECT_EQ(QuadratureDecoder::transition(0b00, 0b10), 1);
+    EXPECT_EQ(QuadratureDecoder::transition(0b10, 0b11), 1);
+    EXPECT_EQ(QuadratureDecoder::transition(0b11, 0b01), 1);
+    EXPECT_EQ(QuadratureDecoder::transition(0b01, 0b00), 1);
+    EXPECT_EQ(QuadratureDecoder::transition(0b00, 0b01), -1);
+    EXPECT_EQ(QuadratureDecoder::transition(0b01, 0b11), -1);
+    EXPECT_EQ(QuadratureDecoder::transition(0b11, 0b10), -1);
+    EXPECT_EQ(QuadratureDecoder::transition(0b10, 0b00), -1);
+    for (uint8_t s = 0; s < 4; ++s) {
+        EXPECT_EQ(QuadratureDecoder::transition(s, s), 0);
+    }
+    EXPECT_EQ(QuadratureDecoder::transition(0b00, 0b11), QUADRATURE_INVALID_TRANSITION);
+    EXPECT_EQ(QuadratureDecoder::transition(0b01, 0b10), QUADRATURE_INVALID_TRANSITION);
+}
+
+TEST(QuadratureDecoderTest, CountsBothDirections) {
+    QuadratureDecoder decoder(PIN_A, PIN_B);
+    EdgeFeeder feed(decoder);
+
+    feed.forwardCycle();
+    feed.forwardCycle();
+    EXPECT_EQ(decoder.position(), 8);
+    EXPECT_EQ(decoder.state(), 0b00);
+
+    // Reverse: B leads A
+    EXPECT_EQ(feed.edge(PIN_B, true), -1);
+    EXPECT_EQ(feed.edge(PIN_A, true), -1);
+    EXPECT_EQ(feed.edge(PIN_B, false), -1);
+    EXPECT_EQ(decoder.position(), 5);
+    EXPECT_EQ(decoder.invalidCount(), 0u);
+    EXPECT_EQ(decoder.missedCount(), 0u);
+}
+
+TEST(QuadratureDecoderTest, StartsFromGivenState) {
+    QuadratureDecoder decoder(PIN_A, PIN_B);
+    decoder.setState(0b11);
+    EdgeFeeder feed(decoder);
+
+    EXPECT_EQ(feed.edge(PIN_A, false), 1);   // 11 -> 01
+    EXPECT_EQ(decoder.position(), 1);
+    EXPECT_EQ(feed.edge(7, true), 0);        // Other lines are ignored
+}
+
+TEST(QuadratureDecoderTest, CountsLostAndInvalidEvents) {
+    QuadratureDecoder decoder(PIN_A, PIN_B);
+    EdgeFeeder feed(decoder);
+
+    feed.edge(PIN_A, true);
+    EXPECT_EQ(feed.edge(PIN_A, true, 1000000, 2), 0);   // Falling and one more lost
+    EXPECT_EQ(decoder.missedCount(), 2u);
+    EXPECT_EQ(decoder.invalidCount(), 1u);
+    EXPECT_EQ(decoder.position(), 1);
+
+    decoder.reset();
+    EXPECT_EQ(decoder.position(), 0);
+    EXPECT_EQ(decoder.missedCount(), 0u);
+    EXPECT_EQ(decoder.invalidCount(), 0u);
+}
+
+TEST(QuadratureDecoderTest, VelocityOverWindow) {
+    QuadratureDecoder decoder(PIN_A, PIN_B, 10000000);
+    EdgeFeeder feed(decoder);
+
+    // One count per millisecond forward
+    for (int i = 0; i < 10; ++i) {
+        feed.forwardCycle(1000000);
+    }
+    EXPECT_NEAR(decoder.velocity(), 1000.0, 1e-6);
+    EXPECT_NEAR(decoder.velocity(feed.nowNs + 5000000), 1000.0, 1e-6);
+
+    // Stopped: bounded by one count per elapsed time
+    EXPECT_NEAR(decoder.velocity(feed.nowNs + 1000000000), 1.0, 1e-9);
+
+    decoder.setPosition(-100);
+    EXPECT_EQ(decoder.position(), -100);
+    feed.nowNs += 1000000000;                          // Pause, then reverse
+    for (int i = 0; i < 3; ++i) {
+        feed.edge(PIN_B, true);
+        feed.edge(PIN_A, true);
+        feed.edge(PIN_B, false);
+        feed.edge(PIN_A, false);
+    }
+    EXPECT_EQ(decoder.position(), -112);
+    EXPECT_NEAR(decoder.velocity(), -1000.0, 1e-6);
+}
+
+TEST(QuadratureDecoderTest, DecayKeepsSign) {
+    EXPECT_DOUBLE_EQ(QuadratureDecoder::decayVelocity(-500.0, 0, 1000, 10000), -500.0);
+    EXPECT_DOUBLE_EQ(QuadratureDecoder::decayVelocity(-500.0, 0, 100000000, 10000), -10.0);
+    EXPECT_DOUBLE_EQ(QuadratureDecoder::decayVelocity(2.0, 0, 100000000, 10000), 2.0);
+}
+
+TEST(QuadratureDecoderTest, HardwareCountsFeedVelocity) {
+    QuadratureDecoder decoder(0, 1, 1000000);
+    decoder.onSteps(5, 1000000);
+    decoder.onSteps(100, 3000000);      // 100 counts in 2 ms
+    EXPECT_EQ(decoder.position(), 105);
+    EXPECT_DOUBLE_EQ(decoder.velocity(), 50000.0);
+    decoder.onSteps(0, 4000000);        // No change: not a step
+    EXPECT_EQ(decoder.lastStepNs(), 3000000u);
+}
+
+TEST(QuadratureEncoderTest, RejectsInvalidArguments) {
+    EXPECT_THROW(QuadratureEncoder(-1, 6), InvalidPinError);
+    EXPECT_THROW(QuadratureEncoder(5, 99), InvalidPinError);
+    EXPECT_THROW(QuadratureEncoder(5, 5), InvalidPinError);
+    EXPECT_THROW(QuadratureEncoder(5, 6, true, 0), InvalidPinError);
+}
+
+TEST(QuadratureEncoderTest, IdleEncoderReadsZero) {
+    try {
+        QuadratureEncoder encoder(PIN_A, PIN_B);
+        EXPECT_EQ(encoder.read(), 0);
+        EXPECT_EQ(encoder.getVelocity(), 0.0);
+        encoder.write(1234);
+        EXPECT_EQ(encoder.read(), 1234);
+        encoder.reset();
+        EXPECT_EQ(encoder.read(), 0);
+        EXPECT_EQ(encoder.getPinA(), PIN_A);
+        EXPECT_EQ(encoder.getPinB(), PIN_B);
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
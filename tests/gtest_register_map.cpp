@@ -0,0 +1,151 @@
+/**
+ * @file gtest_register_map.cpp
+ * @brief GoogleTest unit tests for the cached I2C register map
+ *
+ * Runs against a simulated register-file device on bus 1; bus traffic is
+ * counted with RegisterMap::getTransactions().
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "register_map.hpp"
+#include "sim_backend.hpp"
+
+using namespace pipinpp;
+
+namespace {
+constexpr uint8_t DEVICE = 0x76;
+}
+
+class RegisterMapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+        SimulatedHardware::getInstance().addI2cDevice(1, DEVICE);
+        ASSERT_TRUE(Wire.begin(1));
+    }
+
+    void TearDown() override {
+        Wire.end();
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+
+    int deviceRegister(uint8_t reg) {
+        return SimulatedHardware::getInstance().getI2cRegister(1, DEVICE, reg);
+    }
+};
+
+TEST_F(RegisterMapTest, FlushCoalescesDirtyRuns) {
+    RegisterMap map(DEVICE);
+    map.set(0x10, 0x11);
+    map.set(0x11, 0x22);
+    map.set(0x12, 0x33);
+    map.set(0x20, 0x44);
+    EXPECT_EQ(map.dirtyCount(), 4u);
+    EXPECT_EQ(map.getTransactions(), 0u);
+
+    EXPECT_TRUE(map.flush());
+    EXPECT_EQ(map.getTransactions(), 2u);       // 0x10-0x12 and 0x20
+    EXPECT_EQ(map.dirtyCount(), 0u);
+    EXPECT_EQ(deviceRegister(0x10), 0x11);
+    EXPECT_EQ(deviceRegister(0x11), 0x22);
+    EXPECT_EQ(deviceRegister(0x12), 0x33);
+    EXPECT_EQ(deviceRegister(0x20), 0x44);
+
+    EXPECT_TRUE(map.flush());                   // Nothing dirty: no traffic
+    EXPECT_EQ(map.getTransactions(), 2u);
+}
+
+TEST_F(RegisterMapTest, MergeGapBridgesCachedRegisters) {
+    SimulatedHardware::getInstance().setI2cRegister(1, DEVICE, 0x01, 0xAA);
+    RegisterMap map(DEVICE);
+    map.setMergeGap(1);
+    ASSERT_TRUE(map.load(0x00, 4));
+    EXPECT_EQ(map.getTransactions(), 1u);
+
+    map.set(0x00, 0x5A);
+    map.set(0x02, 0xA5);
+    EXPECT_TRUE(map.flush());
+    EXPECT_EQ(map.getTransactions(), 2u);       // One write bridging 0x01
+    EXPECT_EQ(deviceRegister(0x00), 0x5A);
+    EXPECT_EQ(deviceRegister(0x01), 0xAA);      // Rewritten with its own value
+    EXPECT_EQ(deviceRegister(0x02), 0xA5);
+
+    map.invalidate(0x01);                       // Uncached gap is not bridged
+    map.set(0x00, 0x01);
+    map.set(0x02, 0x02);
+    EXPECT_TRUE(map.flush());
+    EXPECT_EQ(map.getTransactions(), 4u);
+}
+
+TEST_F(RegisterMapTest, UpdateReadsOnlyUncachedRegisters) {
+    SimulatedHardware::getInstance().setI2cRegister(1, DEVICE, 0xF4, 0xF0);
+    RegisterMap map(DEVICE);
+
+    EXPECT_TRUE(map.update(0xF4, 0x03, 0x03));
+    EXPECT_EQ(map.getTransactions(), 1u);       // Read of the uncached register
+    EXPECT_EQ(map.read(0xF4), 0xF3);
+    EXPECT_EQ(deviceRegister(0xF4), 0xF0);      // Not written until flush()
+
+    EXPECT_TRUE(map.update(0xF4, 0xE0, 0x20));
+    EXPECT_EQ(map.getTransactions(), 1u);       // Served from the cache
+    EXPECT_TRUE(map.flush());
+    EXPECT_EQ(deviceRegister(0xF4), 0x33);
+    EXPECT_EQ(map.getTransactions(), 2u);
+}
+
+TEST_F(RegisterMapTest, VolatileRegistersAreAlwaysRead) {
+    RegisterMap map(DEVICE);
+    map.setVolatile(0xF3);
+    EXPECT_TRUE(map.isVolatile(0xF3));
+
+    SimulatedHardware::getInstance().setI2cRegister(1, DEVICE, 0xF3, 0x08);
+    EXPECT_EQ(map.read(0xF3), 0x08);
+    SimulatedHardware::getInstance().setI2cRegister(1, DEVICE, 0xF3, 0x00);
+    EXPECT_EQ(map.read(0xF3), 0x00);
+    EXPECT_EQ(map.getTransactions(), 2u);
+
+    SimulatedHardware::getInstance().setI2cRegister(1, DEVICE, 0xD0, 0x58);
+    EXPECT_EQ(map.read(0xD0), 0x58);
+    SimulatedHardware::getInstance().setI2cRegister(1, DEVICE, 0xD0, 0x00);
+    EXPECT_EQ(map.read(0xD0), 0x58);            // Cached
+    EXPECT_EQ(map.getTransactions(), 3u);
+}
+
+TEST_F(RegisterMapTest, UnchangedValueIsNotDirty) {
+    RegisterMap map(DEVICE);
+    ASSERT_TRUE(map.load(0x40, 2));
+    map.set(0x40, 0x00);
+    EXPECT_FALSE(map.isDirty(0x40));
+    map.set(0x41, 0x01);
+    EXPECT_TRUE(map.isDirty(0x41));
+    EXPECT_EQ(map.dirtyCount(), 1u);
+}
+
+TEST_F(RegisterMapTest, FailedFlushKeepsRegistersDirty) {
+    RegisterMap map(DEVICE);
+    map.set(0x10, 0x42);
+    Wire.end();
+    EXPECT_FALSE(map.flush());
+    EXPECT_TRUE(map.isDirty(0x10));
+
+    ASSERT_TRUE(Wire.begin(1));
+    EXPECT_TRUE(map.flush());
+    EXPECT_FALSE(map.isDirty(0x10));
+    EXPECT_EQ(deviceRegister(0x10), 0x42);
+}
+
+TEST_F(RegisterMapTest, RejectsOutOfRangeAccess) {
+    RegisterMap map(DEVICE, 16);
+    EXPECT_EQ(map.size(), 16u);
+    EXPECT_FALSE(map.load(0x0F, 2));
+    uint8_t buffer[2];
+    EXPECT_FALSE(map.read(0x10, buffer, 1));
+    EXPECT_FALSE(map.update(0x10, 0xFF, 0x00));
+    map.set(0x10, 0x01);
+    EXPECT_EQ(map.dirtyCount(), 0u);
+}
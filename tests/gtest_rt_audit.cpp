@@ -0,0 +1,150 @@
+/**
+ * @file gtest_rt_audit.cpp
+ * @brief GoogleTest unit tests for the real-time allocation/lock audit
+ *
+ * Hook tests only run in a -DPIPINPP_ENABLE_RT_AUDIT=ON build; otherwise
+ * they check that the API stays an inert no-op.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "rt_audit.hpp"
+#include "SPI.hpp"
+#include "metrics.hpp"
+#include "sim_backend.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+using namespace pipinpp;
+
+namespace {
+
+void* volatile g_sink = nullptr;   // Keeps test allocations from being optimized away
+
+uint64_t countOf(rt_audit::ViolationKind kind, const char* thread) {
+    uint64_t total = 0;
+    for (const auto& violation : rt_audit::violations()) {
+        if (violation.kind == kind && violation.thread == thread) {
+            total += violation.count;
+        }
+    }
+    return total;
+}
+
+} // namespace
+
+class RtAuditTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!rt_audit::enabled()) {
+            return;
+        }
+        rt_audit::reset();
+    }
+
+    void TearDown() override {
+        rt_audit::unmarkCurrentThread();
+    }
+};
+
+TEST_F(RtAuditTest, DisabledBuildIsInert) {
+    if (rt_audit::enabled()) {
+        GTEST_SKIP() << "Built with PIPINPP_ENABLE_RT_AUDIT";
+    }
+    rt_audit::markCurrentThread("test");
+    EXPECT_FALSE(rt_audit::isCurrentThreadMarked());
+    g_sink = std::malloc(32);
+    std::free(g_sink);
+    EXPECT_TRUE(rt_audit::violations().empty());
+    EXPECT_NE(rt_audit::report().find("disabled"), std::string::npos);
+}
+
+TEST_F(RtAuditTest, RecordsAllocationsOnlyOnMarkedThreads) {
+    if (!rt_audit::enabled()) {
+        GTEST_SKIP() << "Needs -DPIPINPP_ENABLE_RT_AUDIT=ON";
+    }
+    metrics::Counter& total = metrics::counter("rt_audit_allocations");
+    uint64_t before = total.value();
+
+    g_sink = std::malloc(32);                       // Not marked: ignored
+    std::free(g_sink);
+    EXPECT_EQ(countOf(rt_audit::ViolationKind::ALLOCATION, "audit-test"), 0u);
+
+    {
+        rt_audit::ScopedRealtime rt("audit-test");
+        EXPECT_TRUE(rt_audit::isCurrentThreadMarked());
+        for (int i = 0; i < 3; ++i) {
+            g_sink = std::malloc(32);               // One call site, three times
+            std::free(g_sink);
+        }
+        {
+            rt_audit::ScopedAllow allow;
+            g_sink = std::malloc(32);               // Accepted: not recorded
+            std::free(g_sink);
+        }
+    }
+    EXPECT_FALSE(rt_audit::isCurrentThreadMarked());
+
+    EXPECT_EQ(countOf(rt_audit::ViolationKind::ALLOCATION, "audit-test"), 3u);
+    EXPECT_EQ(total.value() - before, 3u);
+    auto found = rt_audit::violations();
+    ASSERT_FALSE(found.empty());
+    EXPECT_EQ(found[0].count, 3u);                  // Most frequent first
+    EXPECT_FALSE(found[0].symbols.empty());
+    EXPECT_NE(rt_audit::report().find("allocation x3 on thread 'audit-test'"), std::string::npos);
+
+    rt_audit::reset();
+    EXPECT_TRUE(rt_audit::violations().empty());
+}
+
+TEST_F(RtAuditTest, DistinguishesFreeAndContendedLocks) {
+    if (!rt_audit::enabled()) {
+        GTEST_SKIP() << "Needs -DPIPINPP_ENABLE_RT_AUDIT=ON";
+    }
+    std::mutex mutex;
+    rt_audit::markCurrentThread("audit-lock");
+    { std::lock_guard<std::mutex> lock(mutex); }
+
+    std::atomic<bool> held{false};
+    std::thread holder([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        held.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    while (!held.load()) {
+        std::this_thread::yield();
+    }
+    { std::lock_guard<std::mutex> lock(mutex); }    // Waits for the holder
+    rt_audit::unmarkCurrentThread();
+    holder.join();
+
+    EXPECT_GE(countOf(rt_audit::ViolationKind::LOCK, "audit-lock"), 1u);
+    EXPECT_EQ(countOf(rt_audit::ViolationKind::LOCK_WAIT, "audit-lock"), 1u);
+}
+
+TEST_F(RtAuditTest, LibraryThreadsAreMarked) {
+    SimulatedHardware::getInstance().reset();
+    SimulatedHardware::getInstance().install();
+    SimulatedHardware::getInstance().addSpiDevice(0, 0);
+    SPIClass spi;
+    ASSERT_TRUE(spi.begin(0, 0));
+
+    uint8_t tx[2] = {0x01, 0x02};
+    SpiTransaction transaction;
+    SpiSegment segment;
+    segment.tx = tx;
+    segment.length = sizeof(tx);
+    transaction.segments.push_back(segment);
+    std::atomic<int> marked{-1};
+    ASSERT_TRUE(spi.submit(transaction, [&](bool) { marked.store(rt_audit::isCurrentThreadMarked() ? 1 : 0); }));
+    spi.waitForPending();
+    EXPECT_EQ(marked.load(), rt_audit::enabled() ? 1 : 0);
+
+    spi.end();
+    SimulatedHardware::getInstance().reset();
+    SimulatedHardware::getInstance().uninstall();
+}
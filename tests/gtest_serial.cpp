@@ -13,6 +13,12 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <mutex>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 using namespace pipinpp;
 
@@ -44,6 +50,11 @@ TEST_F(SerialTest, InitiallyNotOpen)
     EXPECT_FALSE(Serial.isOpen());
 }
 
+TEST_F(SerialTest, FdIsInvalidWhenClosed)
+{
+    EXPECT_EQ(Serial.getFd(), -1);
+}
+
 TEST_F(SerialTest, BeginReturnsBoolean)
 {
     // Should return false if device doesn't exist
@@ -382,6 +393,492 @@ TEST_F(SerialTest, RepeatedBeginEndCycle)
     EXPECT_FALSE(Serial.isOpen());
 }
 
+// ============================================================================
+// Receive Thread Tests (pseudo-terminal, no hardware required)
+// ============================================================================
+
+/**
+ * Pseudo-terminal pair: tests write to the master, SerialPort opens the slave
+ */
+class SerialPtyTest : public ::testing::Test 
+{
+protected:
+    void SetUp() override 
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            GTEST_SKIP() << "Pseudo-terminals not available";
+        }
+        slavePath = ptsname(master);
+    }
+    
+    void TearDown() override 
+    {
+        port.endFrameMode();
+        port.endRxThread();
+        port.endTxThread();
+        port.end();
+        if (master >= 0) {
+            ::close(master);
+        }
+    }
+    
+    void send(const std::vector<uint8_t>& data) 
+    {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::write(master, data.data() + sent, data.size() - sent);
+            if (n <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+    
+    // Everything the port writes within @p waitMs of the last byte
+    std::string receive(int waitMs = 200) 
+    {
+        std::string result;
+        char buffer[1024];
+        struct pollfd pfd;
+        pfd.fd = master;
+        pfd.events = POLLIN;
+        while (::poll(&pfd, 1, result.empty() ? waitMs : 20) > 0) {
+            ssize_t n = ::read(master, buffer, sizeof(buffer));
+            if (n <= 0) {
+                break;
+            }
+            result.append(buffer, static_cast<size_t>(n));
+        }
+        return result;
+    }
+    
+    // Wait until the port reports at least @p count bytes
+    bool waitAvailable(int count) 
+    {
+        for (int i = 0; i < 1000 && port.available() < count; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return port.available() >= count;
+    }
+    
+    // Write directly until the pty's output buffer is full (nobody reads the master)
+    size_t fillDriver() 
+    {
+        std::vector<uint8_t> block(4096, '.');
+        size_t total = 0;
+        size_t n;
+        while ((n = port.write(block.data(), block.size())) > 0) {
+            total += n;
+        }
+        return total;
+    }
+    
+    int master = -1;
+    std::string slavePath;
+    SerialPort port;
+};
+
+TEST_F(SerialPtyTest, RxThreadEnabledBeforeBegin)
+{
+    EXPECT_TRUE(port.beginRxThread());
+    EXPECT_FALSE(port.isRxThreadRunning());
+    
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    EXPECT_TRUE(port.isRxThreadRunning());
+    
+    port.end();
+    EXPECT_FALSE(port.isRxThreadRunning());
+    
+    ASSERT_TRUE(port.begin(115200, slavePath));  // Still enabled
+    EXPECT_TRUE(port.isRxThreadRunning());
+    
+    port.endRxThread();
+    EXPECT_FALSE(port.isRxThreadRunning());
+    EXPECT_TRUE(port.isOpen());
+}
+
+TEST_F(SerialPtyTest, RxThreadAvailablePeekAndRead)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    ASSERT_TRUE(port.beginRxThread());
+    
+    send({'h', 'e', 'l', 'l', 'o', '\n'});
+    ASSERT_TRUE(waitAvailable(6));
+    
+    EXPECT_EQ(port.peek(), 'h');
+    EXPECT_EQ(port.available(), 6);
+    EXPECT_EQ(port.readStringUntil('\n'), "hello");
+    EXPECT_EQ(port.available(), 0);
+}
+
+TEST_F(SerialPtyTest, RxThreadReceivesBulkData)
+{
+    ASSERT_TRUE(port.begin(921600, slavePath));
+    ASSERT_TRUE(port.beginRxThread());
+    port.setTimeout(2000);
+    
+    // Avoid '\r', which the tty's ICRNL input mapping rewrites
+    std::vector<uint8_t> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i % 251);
+        if (data[i] == '\r') {
+            data[i] = 0;
+        }
+    }
+    
+    // ~1 MB/s: paced like a (fast) UART rather than a memory copy
+    std::thread writer([&]() {
+        for (size_t offset = 0; offset < data.size(); offset += 1000) {
+            send(std::vector<uint8_t>(data.begin() + offset, data.begin() + offset + 1000));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    
+    std::vector<uint8_t> received(data.size());
+    size_t total = 0;
+    while (total < received.size()) {
+        size_t n = port.readBytes(received.data() + total, received.size() - total);
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+    writer.join();
+    
+    EXPECT_EQ(total, data.size());
+    EXPECT_EQ(received, data);
+    EXPECT_EQ(port.getRxOverflowCount(), 0u);
+}
+
+TEST_F(SerialPtyTest, RxThreadCountsOverflow)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    ASSERT_TRUE(port.beginRxThread(16));
+    
+    send(std::vector<uint8_t>(200, 'x'));
+    for (int i = 0; i < 1000 && port.getRxOverflowCount() < 184; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    EXPECT_EQ(port.available(), 16);
+    EXPECT_EQ(port.getRxOverflowCount(), 184u);
+}
+
+TEST_F(SerialPtyTest, RxThreadReadTimesOut)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    ASSERT_TRUE(port.beginRxThread());
+    port.setTimeout(50);
+    
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(port.read(), -1);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    
+    EXPECT_GE(elapsed, std::chrono::milliseconds(40));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+}
+
+TEST_F(SerialPtyTest, RxThreadWakesBlockedReader)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    ASSERT_TRUE(port.beginRxThread());
+    port.setTimeout(2000);
+    
+    std::thread writer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        send({'A'});
+    });
+    EXPECT_EQ(port.read(), 'A');
+    writer.join();
+}
+
+TEST_F(SerialPtyTest, ReadBytesWithoutRxThread)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    port.setTimeout(500);
+    
+    send({1, 2, 3, 4});
+    uint8_t buffer[4] = {0};
+    EXPECT_EQ(port.readBytes(buffer, sizeof(buffer)), 4u);
+    EXPECT_EQ(buffer[0], 1);
+    EXPECT_EQ(buffer[3], 4);
+}
+
+TEST_F(SerialPtyTest, PrintFormatsWithoutChangingOutput)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    
+    port.print(-42);
+    port.print(",");
+    port.print(255, HEX);
+    port.print(",");
+    port.print(-5L, BIN);
+    port.print(",");
+    port.print(3.14159, 3);
+    port.print(",");
+    port.println(7u);
+    
+    EXPECT_EQ(receive(), "-42,FF,101,3.142,7\r\n");
+}
+
+TEST_F(SerialPtyTest, TxBufferingHoldsPartialLine)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    port.setTxBuffering(SERIAL_TX_BUFFER_SIZE);
+    
+    EXPECT_EQ(port.print("ax="), 3u);
+    EXPECT_EQ(port.print(12), 2u);
+    EXPECT_EQ(port.getTxPending(), 5u);
+    EXPECT_EQ(receive(20), "");          // Nothing written yet
+    
+    EXPECT_EQ(port.println(), 2u);       // End of line writes everything
+    EXPECT_EQ(port.getTxPending(), 0u);
+    EXPECT_EQ(receive(), "ax=12\r\n");
+}
+
+TEST_F(SerialPtyTest, TxBufferingFlushesAtThreshold)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    port.setTxBuffering(4);
+    
+    port.print("ab");
+    EXPECT_EQ(port.getTxPending(), 2u);
+    port.print("cd");
+    EXPECT_EQ(port.getTxPending(), 0u);
+    EXPECT_EQ(receive(), "abcd");
+    
+    port.print("e");
+    port.flush();
+    EXPECT_EQ(receive(), "e");
+}
+
+TEST_F(SerialPtyTest, RawWriteKeepsOrderWithBufferedPrint)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    port.setTxBuffering(SERIAL_TX_BUFFER_SIZE);
+    
+    port.print("x");
+    port.write(static_cast<uint8_t>('y'));
+    EXPECT_EQ(receive(), "xy");
+}
+
+TEST_F(SerialPtyTest, LongLinesBypassBuffer)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    
+    std::string line(SERIAL_TX_BUFFER_SIZE + 100, 'z');
+    EXPECT_EQ(port.println(line), line.size() + 2);
+    EXPECT_EQ(receive(), line + "\r\n");
+}
+
+TEST_F(SerialPtyTest, TxThreadEnabledBeforeBegin)
+{
+    EXPECT_TRUE(port.beginTxThread());
+    EXPECT_FALSE(port.isTxThreadRunning());
+    
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    EXPECT_TRUE(port.isTxThreadRunning());
+    
+    port.endTxThread();
+    EXPECT_FALSE(port.isTxThreadRunning());
+    EXPECT_FALSE(port.beginTxThread(0));
+}
+
+TEST_F(SerialPtyTest, TxThreadKeepsOrderAndFlushes)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    ASSERT_TRUE(port.beginTxThread(64));
+    
+    std::string expected;
+    for (int i = 0; i < 200; ++i) {
+        port.print("n=");
+        port.println(i);
+        port.write(static_cast<uint8_t>('.'));
+        expected += "n=" + std::to_string(i) + "\r\n.";
+    }
+    std::string line(SERIAL_TX_BUFFER_SIZE + 100, 'z');
+    port.println(line);
+    expected += line + "\r\n";
+    
+    std::string received;
+    std::thread reader([&]() { received = receive(); });
+    port.flush();
+    EXPECT_EQ(port.getTxQueued(), 0u);
+    reader.join();
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(port.getTxDroppedCount(), 0u);
+}
+
+TEST_F(SerialPtyTest, TxThreadErrorPolicyRejectsWhenFull)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    port.setTimeout(50);
+    ASSERT_GT(fillDriver(), 0u);
+    ASSERT_TRUE(port.beginTxThread(16, SerialBackpressure::ERROR));
+    
+    std::vector<uint8_t> data(10, 'a');
+    EXPECT_EQ(port.write(data.data(), data.size()), 10u);
+    EXPECT_EQ(port.write(data.data(), data.size()), 0u);   // Would not fit: nothing queued
+    EXPECT_EQ(port.getTxQueued(), 10u);
+}
+
+TEST_F(SerialPtyTest, TxThreadDropOldestKeepsNewest)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    port.setTimeout(50);
+    ASSERT_GT(fillDriver(), 0u);
+    ASSERT_TRUE(port.beginTxThread(16, SerialBackpressure::DROP_OLDEST));
+    
+    std::vector<uint8_t> older(16, 'a');
+    std::vector<uint8_t> newer(8, 'b');
+    EXPECT_EQ(port.write(older.data(), older.size()), 16u);
+    EXPECT_EQ(port.write(newer.data(), newer.size()), 8u);
+    EXPECT_EQ(port.getTxQueued(), 16u);
+    EXPECT_EQ(port.getTxDroppedCount(), 8u);
+    
+    // Drain the pty: the queue then goes out as 8 'a' followed by 8 'b'
+    std::string received;
+    std::thread reader([&]() { received = receive(); });
+    port.flush();
+    reader.join();
+    ASSERT_GE(received.size(), 16u);
+    EXPECT_EQ(received.substr(received.size() - 16), "aaaaaaaabbbbbbbb");
+}
+
+TEST_F(SerialPtyTest, TxThreadBlockPolicyWaitsForRoom)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    size_t filled = fillDriver();
+    ASSERT_TRUE(port.beginTxThread(16, SerialBackpressure::BLOCK));
+    
+    std::string received;
+    std::thread reader([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        received = receive();
+    });
+    std::vector<uint8_t> data(100, 'c');
+    EXPECT_EQ(port.write(data.data(), data.size()), 100u);  // Returns once the reader made room
+    port.flush();
+    reader.join();
+    EXPECT_EQ(received.size(), filled + 100);
+    EXPECT_EQ(port.getTxDroppedCount(), 0u);
+}
+
+TEST_F(SerialPtyTest, TxThreadEndGivesUpOnStuckPort)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    port.setTimeout(50);
+    fillDriver();
+    ASSERT_TRUE(port.beginTxThread(16));
+    port.print("stuck");
+    
+    auto start = std::chrono::steady_clock::now();
+    port.end();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_FALSE(port.isTxThreadRunning());
+}
+
+TEST_F(SerialPtyTest, FrameModeDecodesFromReceiveThread)
+{
+    std::mutex framesMutex;
+    std::vector<std::vector<uint8_t>> frames;
+    ASSERT_TRUE(port.beginFrameMode(FrameEncoding::COBS, FrameCrc::CRC16, [&](FrameView frame) {
+        std::lock_guard<std::mutex> lock(framesMutex);
+        frames.emplace_back(frame.begin(), frame.end());
+    }));
+    EXPECT_TRUE(port.isFrameMode());
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    EXPECT_TRUE(port.isRxThreadRunning());
+    
+    // Two frames split mid-frame across writes, one corrupted in between
+    std::vector<uint8_t> first = {0x00, 0x01, 0x02};
+    std::vector<uint8_t> second(300, 0x5A);
+    std::vector<uint8_t> stream(maxEncodedFrameSize(FrameEncoding::COBS, FrameCrc::CRC16, 300) * 3);
+    size_t n = encodeFrame(FrameEncoding::COBS, FrameCrc::CRC16, first.data(), first.size(), stream.data(), stream.size());
+    size_t bad = encodeFrame(FrameEncoding::COBS, FrameCrc::CRC16, first.data(), first.size(), stream.data() + n, stream.size() - n);
+    stream[n + 2] ^= 0x80;
+    n += bad;
+    n += encodeFrame(FrameEncoding::COBS, FrameCrc::CRC16, second.data(), second.size(), stream.data() + n, stream.size() - n);
+    send(std::vector<uint8_t>(stream.begin(), stream.begin() + 5));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    send(std::vector<uint8_t>(stream.begin() + 5, stream.begin() + n));
+    
+    for (int i = 0; i < 1000 && port.getFrameStats().frames < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::lock_guard<std::mutex> lock(framesMutex);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0], first);
+    EXPECT_EQ(frames[1], second);
+    EXPECT_EQ(port.getFrameStats().crcErrors, 1u);
+    EXPECT_EQ(port.available(), 0);
+}
+
+TEST_F(SerialPtyTest, WriteFrameEncodesPayload)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    uint8_t payload[] = {0x01, 0xC0, 0x02};
+    EXPECT_EQ(port.writeFrame(payload, sizeof(payload)), 0u);   // Not in frame mode
+    
+    ASSERT_TRUE(port.beginFrameMode(FrameEncoding::SLIP, FrameCrc::NONE, [](FrameView) {}, 8));
+    EXPECT_EQ(port.writeFrame(payload, sizeof(payload)), 6u);
+    EXPECT_EQ(receive(), std::string("\xC0\x01\xDB\xDC\x02\xC0", 6));
+    
+    uint8_t tooLong[9] = {};
+    EXPECT_EQ(port.writeFrame(tooLong, sizeof(tooLong)), 0u);
+    
+    port.endFrameMode();
+    EXPECT_FALSE(port.isFrameMode());
+    EXPECT_FALSE(port.isRxThreadRunning());
+}
+
+TEST_F(SerialPtyTest, StandardBaudRateReadsBack)
+{
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    EXPECT_EQ(port.getBaudRate(), 115200u);
+    EXPECT_EQ(port.getActualBaudRate(), 115200u);
+}
+
+TEST_F(SerialPtyTest, CustomBaudRatesUseTermios2)
+{
+    // DMX and an MCU link rate: neither 250000 nor 3100000 has a Bxxx constant
+    for (unsigned long baud : {250000ul, 3100000ul}) {
+        ASSERT_TRUE(port.begin(baud, slavePath)) << baud;
+        EXPECT_EQ(port.getBaudRate(), baud);
+        EXPECT_EQ(port.getActualBaudRate(), baud);   // A pty keeps the exact rate
+        
+        // Still raw 8N1
+        port.print("ok");
+        EXPECT_EQ(receive(), "ok");
+    }
+    
+    EXPECT_FALSE(port.begin(0, slavePath));
+}
+
+TEST_F(SerialPtyTest, LowLatencyNeedsRealUart)
+{
+    EXPECT_FALSE(port.setLowLatency());      // Not open
+    ASSERT_TRUE(port.begin(115200, slavePath));
+    EXPECT_FALSE(port.setLowLatency());      // A pty has neither TIOCSSERIAL nor a latency timer
+    EXPECT_TRUE(port.isOpen());
+}
+
+TEST_F(SerialTest, ActualBaudRateZeroWhenNotOpen)
+{
+    SerialPort port;
+    EXPECT_EQ(port.getActualBaudRate(), 0u);
+}
+
+TEST_F(SerialTest, ReadBytesReturnsZeroWhenNotOpen)
+{
+    uint8_t buffer[4];
+    Serial.setTimeout(0);
+    EXPECT_EQ(Serial.readBytes(buffer, sizeof(buffer)), 0u);
+    EXPECT_EQ(Serial.readBytes(nullptr, 4), 0u);
+    Serial.setTimeout(1000);
+}
+
 // ============================================================================
 // Main
 // ============================================================================
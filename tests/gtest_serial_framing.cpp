@@ -0,0 +1,182 @@
+/**
+ * @file gtest_serial_framing.cpp
+ * @brief GoogleTest unit tests for COBS/SLIP framing and CRC routines
+ *
+ * Tests CRC check values, known COBS encodings, SLIP escaping, round trips
+ * through arbitrary stream splits and error counting. No hardware is required.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "serial_framing.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+std::vector<uint8_t> encode(FrameEncoding encoding, FrameCrc crc, const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> out(maxEncodedFrameSize(encoding, crc, payload.size()));
+    size_t n = encodeFrame(encoding, crc, payload.data(), payload.size(), out.data(), out.size());
+    out.resize(n);
+    return out;
+}
+
+// Collects every delivered frame
+struct Collector {
+    explicit Collector(FrameDecoder& decoder) {
+        decoder.setCallback([this](FrameView frame) {
+            frames.emplace_back(frame.begin(), frame.end());
+        });
+    }
+    std::vector<std::vector<uint8_t>> frames;
+};
+
+} // namespace
+
+TEST(SerialFramingTest, CrcCheckValues) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(crc16Ccitt(check, sizeof(check)), 0x29B1);
+    EXPECT_EQ(crc32(check, sizeof(check)), 0xCBF43926u);
+
+    // Chaining gives the same result as one pass
+    EXPECT_EQ(crc32(check + 4, 5, crc32(check, 4)), 0xCBF43926u);
+    EXPECT_EQ(crc16Ccitt(check + 4, 5, crc16Ccitt(check, 4)), 0x29B1);
+    EXPECT_EQ(crc32(nullptr, 0), 0u);
+}
+
+TEST(SerialFramingTest, CobsKnownEncodings) {
+    typedef std::vector<uint8_t> Bytes;
+    EXPECT_EQ(encode(FrameEncoding::COBS, FrameCrc::NONE, Bytes{0x00}), (Bytes{0x01, 0x01, 0x00}));
+    EXPECT_EQ(encode(FrameEncoding::COBS, FrameCrc::NONE, Bytes{0x11, 0x22, 0x00, 0x33}),
+              (Bytes{0x03, 0x11, 0x22, 0x02, 0x33, 0x00}));
+    EXPECT_EQ(encode(FrameEncoding::COBS, FrameCrc::NONE, Bytes{0x11, 0x00, 0x00, 0x00}),
+              (Bytes{0x02, 0x11, 0x01, 0x01, 0x01, 0x00}));
+
+    // 254 non-zero bytes: one full block, then an empty one
+    Bytes full(254, 0x42);
+    Bytes encoded = encode(FrameEncoding::COBS, FrameCrc::NONE, full);
+    ASSERT_EQ(encoded.size(), 257u);
+    EXPECT_EQ(encoded[0], 0xFF);
+    EXPECT_EQ(encoded[255], 0x01);
+    EXPECT_EQ(encoded[256], 0x00);
+}
+
+TEST(SerialFramingTest, SlipEscapesSpecialBytes) {
+    typedef std::vector<uint8_t> Bytes;
+    EXPECT_EQ(encode(FrameEncoding::SLIP, FrameCrc::NONE, Bytes{0x01, 0xC0, 0xDB, 0x02}),
+              (Bytes{0xC0, 0x01, 0xDB, 0xDC, 0xDB, 0xDD, 0x02, 0xC0}));
+}
+
+TEST(SerialFramingTest, EncodeRejectsSmallBuffer) {
+    uint8_t payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t out[8];
+    EXPECT_EQ(encodeFrame(FrameEncoding::COBS, FrameCrc::NONE, payload, sizeof(payload), out, sizeof(out)), 0u);
+    EXPECT_EQ(encodeFrame(FrameEncoding::SLIP, FrameCrc::CRC16, payload, sizeof(payload), out, sizeof(out)), 0u);
+}
+
+TEST(SerialFramingTest, RoundTripAcrossArbitrarySplits) {
+    const FrameEncoding encodings[] = {FrameEncoding::COBS, FrameEncoding::SLIP};
+    const FrameCrc crcs[] = {FrameCrc::NONE, FrameCrc::CRC16, FrameCrc::CRC32};
+
+    std::vector<std::vector<uint8_t>> payloads;
+    for (size_t length : {1u, 2u, 253u, 254u, 255u, 600u}) {
+        std::vector<uint8_t> payload(length);
+        for (size_t i = 0; i < length; ++i) {
+            payload[i] = static_cast<uint8_t>((i * 37) ^ (i >> 3));   // Includes 0x00, 0xC0, 0xDB
+        }
+        payloads.push_back(payload);
+    }
+
+    for (FrameEncoding encoding : encodings) {
+        for (FrameCrc crc : crcs) {
+            std::vector<uint8_t> stream;
+            for (const auto& payload : payloads) {
+                auto encoded = encode(encoding, crc, payload);
+                stream.insert(stream.end(), encoded.begin(), encoded.end());
+            }
+
+            for (size_t step : {1u, 3u, 64u, 4096u}) {
+                FrameDecoder decoder(encoding, crc);
+                Collector collector(decoder);
+                for (size_t offset = 0; offset < stream.size(); offset += step) {
+                    decoder.feed(stream.data() + offset, std::min(step, stream.size() - offset));
+                }
+                EXPECT_EQ(collector.frames, payloads) << "step " << step;
+                EXPECT_EQ(decoder.getStats().frames, payloads.size());
+                EXPECT_EQ(decoder.getStats().crcErrors, 0u);
+                EXPECT_EQ(decoder.getStats().framingErrors, 0u);
+            }
+        }
+    }
+}
+
+TEST(SerialFramingTest, CorruptedFrameCountsCrcError) {
+    std::vector<uint8_t> payload = {0x10, 0x20, 0x30, 0x40};
+    for (FrameCrc crc : {FrameCrc::CRC16, FrameCrc::CRC32}) {
+        auto encoded = encode(FrameEncoding::SLIP, crc, payload);
+        auto corrupted = encoded;
+        corrupted[2] ^= 0x01;
+
+        FrameDecoder decoder(FrameEncoding::SLIP, crc);
+        Collector collector(decoder);
+        decoder.feed(corrupted.data(), corrupted.size());
+        decoder.feed(encoded.data(), encoded.size());
+
+        ASSERT_EQ(collector.frames.size(), 1u);
+        EXPECT_EQ(collector.frames[0], payload);
+        EXPECT_EQ(decoder.getStats().crcErrors, 1u);
+    }
+}
+
+TEST(SerialFramingTest, OversizedFrameIsDropped) {
+    FrameDecoder decoder(FrameEncoding::COBS, FrameCrc::NONE, 16);
+    Collector collector(decoder);
+
+    auto big = encode(FrameEncoding::COBS, FrameCrc::NONE, std::vector<uint8_t>(40, 0x55));
+    auto small = encode(FrameEncoding::COBS, FrameCrc::NONE, std::vector<uint8_t>(16, 0x66));
+    decoder.feed(big.data(), big.size());
+    decoder.feed(small.data(), small.size());
+
+    ASSERT_EQ(collector.frames.size(), 1u);
+    EXPECT_EQ(collector.frames[0], std::vector<uint8_t>(16, 0x66));
+    EXPECT_EQ(decoder.getStats().framingErrors, 1u);
+}
+
+TEST(SerialFramingTest, ResyncsAfterTruncatedCobsBlock) {
+    FrameDecoder decoder(FrameEncoding::COBS);
+    Collector collector(decoder);
+
+    // Code byte promises 5 data bytes, delimiter arrives after 2
+    const uint8_t truncated[] = {0x06, 0x01, 0x02, 0x00};
+    decoder.feed(truncated, sizeof(truncated));
+    auto good = encode(FrameEncoding::COBS, FrameCrc::NONE, {0x09});
+    decoder.feed(good.data(), good.size());
+
+    ASSERT_EQ(collector.frames.size(), 1u);
+    EXPECT_EQ(collector.frames[0], std::vector<uint8_t>{0x09});
+    EXPECT_EQ(decoder.getStats().framingErrors, 1u);
+}
+
+TEST(SerialFramingTest, SlipBadEscapeAndResetDiscardFrame) {
+    FrameDecoder decoder(FrameEncoding::SLIP);
+    Collector collector(decoder);
+
+    const uint8_t badEscape[] = {0xC0, 0x01, 0xDB, 0x05, 0x02, 0xC0};
+    decoder.feed(badEscape, sizeof(badEscape));
+    EXPECT_EQ(decoder.getStats().framingErrors, 1u);
+
+    const uint8_t partial[] = {0xC0, 0x07, 0x08};
+    decoder.feed(partial, sizeof(partial));
+    decoder.reset();
+    const uint8_t rest[] = {0x09, 0xC0};
+    decoder.feed(rest, sizeof(rest));
+
+    ASSERT_EQ(collector.frames.size(), 1u);
+    EXPECT_EQ(collector.frames[0], std::vector<uint8_t>{0x09});
+}
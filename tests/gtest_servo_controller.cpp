@@ -0,0 +1,199 @@
+/**
+ * @file gtest_servo_controller.cpp
+ * @brief GoogleTest unit tests for ServoController
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "servo_controller.hpp"
+#include "exceptions.hpp"
+#include "timer_manager.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+constexpr int64_t TICK_NS = 1000000;   // 1 ms simulated steps
+
+ServoConfig limits(double velocity, double acceleration) {
+    ServoConfig config;
+    config.maxVelocity = velocity;
+    config.maxAcceleration = acceleration;
+    return config;
+}
+
+/// Steps until the servo stops; returns simulated seconds taken
+double runToRest(ServoController& servos, int id, double* peakVelocity = nullptr, double* peakAccel = nullptr) {
+    double previous = servos.getVelocity(id);
+    int ticks = 0;
+    while (servos.isMoving(id) && ticks < 100000) {
+        servos.step(TICK_NS);
+        ++ticks;
+        const double velocity = servos.getVelocity(id);
+        if (peakVelocity) {
+            *peakVelocity = std::max(*peakVelocity, std::fabs(velocity));
+        }
+        if (peakAccel && servos.isMoving(id)) {     // The arrival tick settles from below 2a*dt
+            *peakAccel = std::max(*peakAccel, std::fabs(velocity - previous) / 1e-3);
+        }
+        previous = velocity;
+    }
+    return ticks * 1e-3;
+}
+
+} // namespace
+
+TEST(ServoControllerTest, AngleToPulse) {
+    ServoConfig config;
+    EXPECT_EQ(ServoController::angleToPulseNs(config, 0.0), 1000000u);
+    EXPECT_EQ(ServoController::angleToPulseNs(config, 90.0), 1500000u);
+    EXPECT_EQ(ServoController::angleToPulseNs(config, 180.0), 2000000u);
+    EXPECT_EQ(ServoController::angleToPulseNs(config, 400.0), 2000000u);    // Clamped
+
+    config.minPulseUs = 2400;                                               // Reversed servo
+    config.maxPulseUs = 600;
+    EXPECT_EQ(ServoController::angleToPulseNs(config, 0.0), 2400000u);
+    EXPECT_EQ(ServoController::angleToPulseNs(config, 180.0), 600000u);
+}
+
+TEST(ServoControllerTest, TrapezoidRespectsLimits) {
+    TimerManager timers;
+    ServoController servos(&timers);
+    servos.setTickUs(1000000);                      // Keep the timer out of the way
+    std::vector<uint64_t> pulses;
+    int id = servos.attach([&](uint64_t ns) { pulses.push_back(ns); return true; }, limits(90.0, 180.0), 0.0);
+    ASSERT_EQ(pulses.size(), 1u);                   // Initial position written
+    EXPECT_EQ(pulses[0], 1000000u);
+
+    ASSERT_TRUE(servos.moveTo(id, 90.0));
+    double peakVelocity = 0.0, peakAccel = 0.0;
+    double seconds = runToRest(servos, id, &peakVelocity, &peakAccel);
+
+    // 0.5 s ramp up (22.5 deg), 0.5 s cruise (45 deg), 0.5 s ramp down
+    EXPECT_NEAR(seconds, 1.5, 0.03);
+    EXPECT_LE(peakVelocity, 90.0 + 1e-9);
+    EXPECT_LE(peakAccel, 180.0 + 1e-6);
+    EXPECT_DOUBLE_EQ(servos.getAngle(id), 90.0);
+    EXPECT_EQ(servos.getVelocity(id), 0.0);
+    EXPECT_EQ(pulses.back(), 1500000u);
+
+    // At rest nothing is rewritten
+    size_t written = pulses.size();
+    servos.step(TICK_NS);
+    EXPECT_EQ(pulses.size(), written);
+}
+
+TEST(ServoControllerTest, WaypointsDwellAndPerWaypointLimits) {
+    TimerManager timers;
+    ServoController servos(&timers);
+    servos.setTickUs(1000000);
+    int id = servos.attach([](uint64_t) { return true; }, limits(0.0, 0.0), 90.0);   // Unlimited
+
+    ServoWaypoint first;
+    first.angle = 180.0;
+    first.dwellMs = 100;
+    ServoWaypoint second;
+    second.angle = 0.0;
+    second.maxVelocity = 100.0;                     // 1.8 s at constant speed
+    ASSERT_TRUE(servos.addWaypoint(id, first));
+    ASSERT_TRUE(servos.addWaypoint(id, second));
+
+    servos.step(TICK_NS);
+    EXPECT_DOUBLE_EQ(servos.getAngle(id), 180.0);   // Unlimited: there in one tick
+    EXPECT_TRUE(servos.isMoving(id));               // Dwelling
+    for (int i = 0; i < 99; ++i) {
+        servos.step(TICK_NS);
+    }
+    EXPECT_DOUBLE_EQ(servos.getAngle(id), 180.0);   // Still holding for the last tick of the dwell
+    double seconds = runToRest(servos, id);
+    EXPECT_NEAR(seconds, 1.8, 0.01);
+    EXPECT_DOUBLE_EQ(servos.getAngle(id), 0.0);
+}
+
+TEST(ServoControllerTest, RedirectAndStopAreSmooth) {
+    TimerManager timers;
+    ServoController servos(&timers);
+    servos.setTickUs(1000000);
+    int id = servos.attach([](uint64_t) { return true; }, limits(90.0, 180.0), 0.0);
+
+    servos.moveTo(id, 180.0);
+    for (int i = 0; i < 700; ++i) {
+        servos.step(TICK_NS);                       // Cruising at 90 deg/s
+    }
+    ASSERT_NEAR(servos.getVelocity(id), 90.0, 1e-6);
+
+    // Reversing decelerates through zero instead of jumping
+    servos.moveTo(id, 0.0);
+    double peakAccel = 0.0;
+    runToRest(servos, id, nullptr, &peakAccel);
+    EXPECT_LE(peakAccel, 180.0 + 1e-6);
+    EXPECT_DOUBLE_EQ(servos.getAngle(id), 0.0);
+
+    // stop() brakes to rest v^2 / 2a beyond where it was
+    servos.moveTo(id, 180.0);
+    for (int i = 0; i < 700; ++i) {
+        servos.step(TICK_NS);
+    }
+    const double position = servos.getAngle(id);
+    ASSERT_TRUE(servos.stop(id));
+    runToRest(servos, id);
+    EXPECT_NEAR(servos.getAngle(id), position + 90.0 * 90.0 / 360.0, 0.2);
+}
+
+TEST(ServoControllerTest, ValidationAndFailures) {
+    TimerManager timers;
+    ServoController servos(&timers);
+    ServoConfig bad;
+    bad.maxAngle = bad.minAngle;
+    EXPECT_THROW(servos.attach([](uint64_t) { return true; }, bad), std::invalid_argument);
+    EXPECT_THROW(servos.attach(ServoOutput()), std::invalid_argument);
+    EXPECT_THROW(servos.attachDma(40), InvalidPinError);
+    EXPECT_FALSE(servos.moveTo(99, 10.0));
+    EXPECT_FALSE(servos.stop(99));
+    EXPECT_FALSE(servos.detach(99));
+
+    bool fail = false;
+    int id = servos.attach([&](uint64_t) { return !fail; }, limits(90.0, 180.0));
+    servos.moveTo(id, 0.0);
+    servos.step(TICK_NS);
+    fail = true;
+    servos.step(TICK_NS);
+    EXPECT_FALSE(servos.isMoving(id));              // Dead output stops the motion
+    EXPECT_TRUE(servos.detach(id));
+}
+
+TEST(ServoControllerTest, TimerMovesManyServosThenGoesIdle) {
+    TimerManager timers;
+    ServoController servos(&timers);
+    servos.setTickUs(2000);
+    constexpr int SERVOS = 16;
+    std::atomic<uint64_t> writes{0};
+    std::vector<int> ids;
+    for (int i = 0; i < SERVOS; ++i) {
+        ids.push_back(servos.attach([&](uint64_t) { writes.fetch_add(1); return true; }, limits(1800.0, 36000.0), 0.0));
+    }
+    for (int i = 0; i < SERVOS; ++i) {
+        servos.moveTo(ids[i], 10.0 * i);
+    }
+    EXPECT_EQ(timers.size(), 1u);                   // One task for every servo
+    for (int i = 0; i < 200 && servos.getMovingCount() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(servos.getMovingCount(), 0u);
+    for (int i = 0; i < 100 && timers.size() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(timers.size(), 0u);
+    for (int i = 0; i < SERVOS; ++i) {
+        EXPECT_DOUBLE_EQ(servos.getAngle(ids[i]), 10.0 * i);
+    }
+    EXPECT_GT(writes.load(), static_cast<uint64_t>(SERVOS));
+}
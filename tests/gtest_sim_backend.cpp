@@ -0,0 +1,292 @@
+/**
+ * @file gtest_sim_backend.cpp
+ * @brief GoogleTest unit tests for the simulated hardware backend
+ *
+ * Runs Pin, InterruptManager, SPIClass, WireClass and the Arduino pin
+ * table unchanged against SimulatedHardware: output writes, loopback
+ * edges, injected bursts, line conflicts, SPI echo, I2C register access
+ * and pinMode() racing digitalWrite()/digitalRead().
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "sim_backend.hpp"
+#include "ArduinoCompat.hpp"
+#include "SPI.hpp"
+#include "Wire.hpp"
+#include "chip_registry.hpp"
+#include "exceptions.hpp"
+#include "interrupts.hpp"
+#include "pin.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+class SimBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sim().reset();
+        sim().install();
+    }
+
+    void TearDown() override {
+        sim().reset();
+        sim().uninstall();
+    }
+
+    static SimulatedHardware& sim() { return SimulatedHardware::getInstance(); }
+
+    static bool waitFor(const std::atomic<int>& value, int expected) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (value.load() < expected) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+TEST_F(SimBackendTest, OutputWritesReachTheSimulation) {
+    Pin out(17, PinDirection::OUTPUT);
+    EXPECT_EQ(out.getBackend(), PinBackend::LIBGPIOD);
+    EXPECT_TRUE(out.write(true));
+    EXPECT_EQ(sim().getLevel(17), 1);
+    EXPECT_TRUE(out.write(false));
+    EXPECT_EQ(sim().getLevel(17), 0);
+    EXPECT_EQ(sim().getWriteCount(17), 2u);
+}
+
+TEST_F(SimBackendTest, ToggleUsesTheOutputShadow) {
+    auto chip = ChipRegistry::getInstance().acquire("gpiochip0");
+    {
+        Pin out(17, PinDirection::OUTPUT);
+        EXPECT_EQ(out.getOutputState(), 0);
+        EXPECT_EQ(chip->outputShadow().level(17), 0);
+
+        EXPECT_TRUE(out.toggle());
+        EXPECT_EQ(sim().getLevel(17), 1);
+        EXPECT_EQ(out.getOutputState(), 1);
+        EXPECT_TRUE(out.toggle());
+        EXPECT_EQ(sim().getLevel(17), 0);
+        EXPECT_EQ(sim().getWriteCount(17), 2u);
+
+        Pin in(27, PinDirection::INPUT);
+        EXPECT_EQ(in.getOutputState(), -1);
+        EXPECT_FALSE(in.toggle());
+    }
+    EXPECT_EQ(chip->outputShadow().level(17), -1);
+}
+
+TEST_F(SimBackendTest, ReconfigureKeepsTheLineRequest) {
+    auto chip = ChipRegistry::getInstance().acquire("gpiochip0");
+    Pin bus(4, PinMode::INPUT_PULLUP);
+    EXPECT_EQ(bus.getOutputState(), -1);
+
+    EXPECT_TRUE(bus.reconfigure(PinMode::OUTPUT));
+    EXPECT_EQ(chip->outputShadow().level(4), 0);
+    EXPECT_TRUE(bus.write(true));
+    EXPECT_EQ(sim().getLevel(4), 1);
+
+    EXPECT_TRUE(bus.reconfigure(PinMode::INPUT));
+    EXPECT_EQ(chip->outputShadow().level(4), -1);
+    EXPECT_FALSE(bus.write(false));
+    sim().setInput(4, false);
+    EXPECT_EQ(bus.read(), 0);
+
+    // Still the only owner of the line
+    EXPECT_THROW(Pin(4, PinDirection::OUTPUT), std::exception);
+}
+
+TEST_F(SimBackendTest, NoexceptAccessReportsErrorCodes) {
+    Pin out(17, PinDirection::OUTPUT);
+    Pin in(27, PinDirection::INPUT);
+    EXPECT_FALSE(out.writeNoexcept(true));
+    EXPECT_EQ(sim().getLevel(17), 1);
+    EXPECT_EQ(in.writeNoexcept(true), GpioErrc::WRONG_DIRECTION);
+
+    int level = -1;
+    sim().setInput(27, true);
+    EXPECT_FALSE(in.readNoexcept(level));
+    EXPECT_EQ(level, 1);
+}
+
+TEST_F(SimBackendTest, InputsReadDrivenLevel) {
+    Pin in(27, PinDirection::INPUT);
+    EXPECT_EQ(in.read(), 0);
+    sim().setInput(27, true);
+    EXPECT_EQ(in.read(), 1);
+}
+
+TEST_F(SimBackendTest, LineCanOnlyBeRequestedOnce) {
+    Pin first(22, PinDirection::OUTPUT);
+    EXPECT_THROW(Pin(22, PinDirection::INPUT), std::exception);
+}
+
+TEST_F(SimBackendTest, LoopbackRaisesPinEdgeEvents) {
+    sim().connect(17, 27);
+    Pin out(17, PinDirection::OUTPUT);
+    Pin in(27, PinDirection::INPUT);
+    ASSERT_TRUE(in.enableEdgeEvents());
+
+    out.write(true);
+    out.write(false);
+    PinEdgeEvent events[4];
+    ASSERT_EQ(in.waitEdgeEvents(events, 4, 100000000), 2);
+    EXPECT_TRUE(events[0].rising);
+    EXPECT_FALSE(events[1].rising);
+    EXPECT_LE(events[0].timestampNs, events[1].timestampNs);
+
+    EXPECT_EQ(in.waitEdgeEvents(events, 4, 1000000), 0);
+}
+
+TEST_F(SimBackendTest, InjectedEdgesCarryModeledTimestamps) {
+    Pin in(5, PinDirection::INPUT);
+    ASSERT_TRUE(in.enableEdgeEvents());
+    sim().injectEdges(5, 10, 1000);
+
+    std::vector<PinEdgeEvent> events(16);
+    ASSERT_EQ(in.waitEdgeEvents(events.data(), events.size(), 100000000), 10);
+    for (int i = 1; i < 10; ++i) {
+        EXPECT_EQ(events[i].timestampNs - events[i - 1].timestampNs, 1000u);
+        EXPECT_NE(events[i].rising, events[i - 1].rising);
+    }
+}
+
+TEST_F(SimBackendTest, InterruptCallbacksFireFromSimulatedEdges) {
+    std::atomic<int> calls{0};
+    InterruptManager::getInstance().attachInterrupt(
+        6, [&calls] { calls.fetch_add(1); }, InterruptMode::RISING);
+
+    sim().setInput(6, true);
+    sim().setInput(6, false);   // Falling: filtered by the request
+    sim().setInput(6, true);
+    EXPECT_TRUE(waitFor(calls, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(calls.load(), 2);
+
+    InterruptManager::getInstance().detachInterrupt(6);
+}
+
+TEST_F(SimBackendTest, EdgeGeneratorRunsUntilStopped) {
+    std::atomic<int> calls{0};
+    InterruptManager::getInstance().attachInterrupt(
+        13, [&calls] { calls.fetch_add(1); }, InterruptMode::CHANGE);
+
+    int id = sim().startEdgeGenerator(13, 2000.0);
+    ASSERT_GT(id, 0);
+    EXPECT_TRUE(waitFor(calls, 20));
+    sim().stopEdgeGenerator(id);
+    InterruptManager::getInstance().detachInterrupt(13);
+}
+
+TEST_F(SimBackendTest, SpiEchoesByDefaultAndRunsHandlers) {
+    sim().addSpiDevice(0, 0);
+    ASSERT_TRUE(SPI.begin(0, 0));
+    EXPECT_EQ(SPI.transfer(0x5A), 0x5A);
+    SPI.end();
+    EXPECT_EQ(sim().getSpiTransferCount(0, 0), 1u);
+
+    sim().addSpiDevice(0, 1, [](const uint8_t* tx, uint8_t* rx, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            rx[i] = static_cast<uint8_t>(~tx[i]);
+        }
+    });
+    ASSERT_TRUE(SPI.begin(0, 1));
+    uint8_t tx[3] = {0x00, 0x0F, 0xFF};
+    uint8_t rx[3] = {};
+    SPI.transfer(tx, rx, sizeof(tx));
+    EXPECT_EQ(rx[0], 0xFF);
+    EXPECT_EQ(rx[1], 0xF0);
+    EXPECT_EQ(rx[2], 0x00);
+    SPI.end();
+
+    EXPECT_FALSE(SPI.begin(1, 0));  // Not added
+}
+
+TEST_F(SimBackendTest, I2cRegistersAndMissingDevices) {
+    sim().addI2cDevice(1, 0x76);
+    sim().setI2cRegister(1, 0x76, 0xD0, 0x58);
+    ASSERT_TRUE(Wire.begin(1));
+
+    EXPECT_TRUE(Wire.exists(0x76));
+    EXPECT_FALSE(Wire.exists(0x77));
+    EXPECT_EQ(Wire.readRegister(0x76, 0xD0), 0x58);
+    EXPECT_TRUE(Wire.writeRegister(0x76, 0xF4, 0x27));
+    EXPECT_EQ(sim().getI2cRegister(1, 0x76, 0xF4), 0x27);
+    EXPECT_EQ(Wire.readRegister(0x77, 0xD0), -1);
+    Wire.end();
+}
+
+TEST_F(SimBackendTest, PinModeRacesWithDigitalWriteAndRead) {
+    pinMode(20, OUTPUT);
+    pinMode(21, INPUT);
+    const uint64_t writesBefore = sim().getWriteCount(20);
+
+    constexpr int WRITERS = 2;
+    constexpr int WRITES = 5000;
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+    std::atomic<int> writes{0};
+
+    // Reconfigure both pins over and over while they are in use
+    std::thread reconfigurer([&] {
+        for (int i = 0; !done.load(); ++i) {
+            try {
+                pinMode(20, OUTPUT);
+                pinMode(21, (i % 2) ? INPUT_PULLUP : INPUT);
+            } catch (const std::exception&) {
+                failures.fetch_add(1);
+            }
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < WRITERS; ++w) {
+        workers.emplace_back([&, w] {
+            for (int i = 0; i < WRITES; ++i) {
+                try {
+                    digitalWrite(20, ((i + w) % 2) != 0);
+                    writes.fetch_add(1);
+                } catch (const std::exception&) {
+                    failures.fetch_add(1);
+                }
+            }
+        });
+    }
+    std::thread reader([&] {
+        while (!done.load()) {
+            try {
+                int level = digitalRead(21);
+                if (level != 0 && level != 1) {
+                    failures.fetch_add(1);
+                }
+            } catch (const std::exception&) {
+                failures.fetch_add(1);
+            }
+        }
+    });
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    done.store(true);
+    reconfigurer.join();
+    reader.join();
+
+    // No call saw a missing or freed pin, and every write reached the line
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(writes.load(), WRITERS * WRITES);
+    EXPECT_EQ(sim().getWriteCount(20) - writesBefore, static_cast<uint64_t>(WRITERS * WRITES));
+    EXPECT_EQ(getMode(20), ArduinoPinMode::OUTPUT);
+}
@@ -9,9 +9,13 @@
 #include <gtest/gtest.h>
 #include "ArduinoCompat.hpp"  // For MSBFIRST/LSBFIRST constants
 #include "SPI.hpp"
+#include <linux/spi/spidev.h>
 #include <thread>
 #include <vector>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 
 using namespace pipinpp;
 
@@ -392,6 +396,274 @@ TEST_F(SPITest, BitOrderConstantsValid)
     EXPECT_EQ(LSBFIRST, 0);
 }
 
+/**
+ * @brief Test batched transfer fails cleanly without begin() or segments
+ */
+TEST_F(SPITest, TransferBatchRequiresInitAndSegments) 
+{
+    uint8_t tx[2] = {0x01, 0x02};
+    SpiSegment seg;
+    seg.tx = tx;
+    seg.length = sizeof(tx);
+    
+    EXPECT_FALSE(SPI.transferBatch(&seg, 1));
+    EXPECT_FALSE(SPI.transferBatch(std::vector<SpiSegment>{}));
+    
+    if (SPI.begin())
+    {
+        EXPECT_FALSE(SPI.transferBatch(nullptr, 1));
+        EXPECT_FALSE(SPI.transferBatch(&seg, 0));
+    }
+}
+
+/**
+ * @brief Test batch limit matches the ioctl size field
+ */
+TEST_F(SPITest, BatchLimitFitsIoctl) 
+{
+    EXPECT_EQ(SPI_MAX_BATCH_SEGMENTS, ((1u << _IOC_SIZEBITS) - 1) / sizeof(spi_ioc_transfer));
+}
+
+/**
+ * @brief Test a multi-segment batch with per-segment settings
+ */
+TEST_F(SPITest, TransferBatchSegments) 
+{
+    if (!SPI.begin()) 
+    {
+        GTEST_SKIP() << "SPI hardware not available";
+    }
+    
+    uint8_t cmd[1] = {0x9F};
+    uint8_t rx[3] = {0};
+    std::vector<uint8_t> bulk(600, 0xAA);
+    
+    std::vector<SpiSegment> segs(3);
+    segs[0].tx = cmd;
+    segs[0].length = sizeof(cmd);
+    segs[1].rx = rx;
+    segs[1].length = sizeof(rx);
+    segs[1].delayUs = 5;
+    segs[1].csChange = true;
+    segs[2].tx = bulk.data();
+    segs[2].length = bulk.size();
+    segs[2].speedHz = 1000000;
+    
+    EXPECT_TRUE(SPI.transferBatch(segs));
+    
+    // More segments than one ioctl can carry
+    std::vector<SpiSegment> many(SPI_MAX_BATCH_SEGMENTS + 10, segs[0]);
+    EXPECT_TRUE(SPI.transferBatch(many));
+}
+
+/**
+ * @brief Test streaming transfer validation and default size limit
+ */
+TEST_F(SPITest, TransferStreamRequiresInit) 
+{
+    std::vector<uint8_t> frame(8192, 0x11);
+    
+    EXPECT_FALSE(SPI.transferStream(frame.data(), nullptr, frame.size()));
+    EXPECT_GT(SPI.getMaxTransferSize(), 0u);
+    
+    if (SPI.begin())
+    {
+        EXPECT_FALSE(SPI.transferStream(nullptr, nullptr, frame.size()));
+        EXPECT_FALSE(SPI.transferStream(frame.data(), nullptr, 0));
+    }
+}
+
+/**
+ * @brief Test buffers larger than spidev bufsiz are split and succeed
+ */
+TEST_F(SPITest, TransferStreamLargeFrame) 
+{
+    if (!SPI.begin()) 
+    {
+        GTEST_SKIP() << "SPI hardware not available";
+    }
+    
+    // 150 KB framebuffer, several times the default 4096-byte bufsiz
+    std::vector<uint8_t> frame(150 * 1024, 0x5A);
+    std::vector<uint8_t> rx(frame.size());
+    EXPECT_TRUE(SPI.transferStream(frame.data(), rx.data(), frame.size()));
+    EXPECT_TRUE(SPI.transferStream(frame.data(), nullptr, frame.size()));
+    
+    // Oversized segments inside a batch are split too
+    SpiSegment segs[2];
+    segs[0].tx = frame.data();
+    segs[0].length = 1;
+    segs[0].csChange = true;
+    segs[1].tx = frame.data();
+    segs[1].length = SPI.getMaxTransferSize() * 3 + 7;
+    EXPECT_TRUE(SPI.transferBatch(segs, 2));
+}
+
+/**
+ * @brief Test async transactions complete (with false) on a closed bus
+ */
+TEST_F(SPITest, SubmitOnClosedBusCompletesWithFailure) 
+{
+    uint8_t tx[2] = {0xAB, 0xCD};
+    SpiTransaction txn;
+    txn.segments.resize(1);
+    txn.segments[0].tx = tx;
+    txn.segments[0].length = sizeof(tx);
+    
+    std::atomic<int> failures{0};
+    ASSERT_TRUE(SPI.submit(txn, [&](bool ok) { if (!ok) failures++; }));
+    ASSERT_TRUE(SPI.submit(txn, [&](bool ok) { if (!ok) failures++; }));
+    SPI.waitForPending();
+    
+    EXPECT_EQ(failures.load(), 2);
+    EXPECT_EQ(SPI.getPendingCount(), 0u);
+    
+    // Empty or invalid transactions are rejected up front
+    EXPECT_FALSE(SPI.submit(SpiTransaction()));
+    txn.settings.dataMode = 7;
+    EXPECT_FALSE(SPI.submit(txn));
+}
+
+/**
+ * @brief Test HIGH priority transactions overtake queued NORMAL ones
+ */
+TEST_F(SPITest, SubmitHighPriorityRunsFirst) 
+{
+    if (!SPI.begin()) 
+    {
+        GTEST_SKIP() << "SPI hardware not available";
+    }
+    
+    std::vector<uint8_t> frame(64 * 1024, 0x00);
+    uint8_t cmd[4] = {0};
+    
+    SpiTransaction bulk;
+    bulk.segments.resize(1);
+    bulk.segments[0].tx = frame.data();
+    bulk.segments[0].length = frame.size();
+    
+    SpiTransaction sensor;
+    sensor.priority = SpiPriority::HIGH;
+    sensor.settings = SPISettings(1000000, MSBFIRST, SPI_MODE3);
+    sensor.segments.resize(1);
+    sensor.segments[0].tx = cmd;
+    sensor.segments[0].length = sizeof(cmd);
+    
+    std::mutex orderMutex;
+    std::vector<int> order;
+    auto record = [&](int id) {
+        return [&, id](bool ok) {
+            EXPECT_TRUE(ok);
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(id);
+        };
+    };
+    
+    // First bulk occupies the thread; the sensor read jumps the other two
+    ASSERT_TRUE(SPI.submit(bulk, record(1)));
+    ASSERT_TRUE(SPI.submit(bulk, record(2)));
+    ASSERT_TRUE(SPI.submit(bulk, record(3)));
+    ASSERT_TRUE(SPI.submit(sensor, record(4)));
+    SPI.waitForPending();
+    
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_LT(std::find(order.begin(), order.end(), 4) - order.begin(),
+              std::find(order.begin(), order.end(), 3) - order.begin());
+}
+
+/**
+ * @brief Test end() fails transactions that have not run yet
+ */
+TEST_F(SPITest, EndCancelsQueuedTransactions) 
+{
+    SpiTransaction txn;
+    uint8_t tx[1] = {0};
+    txn.segments.resize(1);
+    txn.segments[0].tx = tx;
+    txn.segments[0].length = 1;
+    
+    std::atomic<int> completions{0};
+    for (int i = 0; i < 50; ++i) 
+    {
+        SPI.submit(txn, [&](bool) { completions++; });
+    }
+    SPI.end();
+    
+    EXPECT_EQ(completions.load(), 50);
+    EXPECT_EQ(SPI.getPendingCount(), 0u);
+}
+
+/**
+ * @brief Test SPISettings defaults and comparison
+ */
+TEST_F(SPITest, SPISettingsDefaultsAndEquality) 
+{
+    SPISettings defaults;
+    EXPECT_EQ(defaults.clock, 4000000u);
+    EXPECT_EQ(defaults.bitOrder, MSBFIRST);
+    EXPECT_EQ(defaults.dataMode, SPI_MODE0);
+    
+    EXPECT_EQ(SPISettings(1000000, MSBFIRST, SPI_MODE3), SPISettings(1000000, MSBFIRST, SPI_MODE3));
+    EXPECT_NE(SPISettings(1000000, MSBFIRST, SPI_MODE3), SPISettings(1000000, LSBFIRST, SPI_MODE3));
+    EXPECT_NE(SPISettings(1000000), SPISettings(2000000));
+}
+
+/**
+ * @brief Test beginTransaction applies the clock and endTransaction is safe
+ */
+TEST_F(SPITest, BeginTransactionAppliesSettings) 
+{
+    SPI.beginTransaction(SPISettings(2000000, MSBFIRST, SPI_MODE1));
+    EXPECT_EQ(SPI.getClock(), 2000000u);
+    SPI.endTransaction();
+    SPI.endTransaction();  // Unbalanced end is ignored
+    
+    if (!SPI.begin()) 
+    {
+        GTEST_SKIP() << "SPI hardware not available";
+    }
+    
+    uint8_t data[2] = {0x12, 0x34};
+    SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE3));
+    EXPECT_EQ(SPI.getClock(), 1000000u);
+    SPI.transfer(data, sizeof(data));
+    SPI.endTransaction();
+    
+    // Switching devices back and forth only changes what differs
+    for (int i = 0; i < 10; ++i) 
+    {
+        SPI.beginTransaction(SPISettings(8000000, MSBFIRST, SPI_MODE0));
+        SPI.transfer(data, sizeof(data));
+        SPI.endTransaction();
+        SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE3));
+        SPI.transfer(data, sizeof(data));
+        SPI.endTransaction();
+    }
+    EXPECT_TRUE(SPI.isInitialized());
+}
+
+/**
+ * @brief Test an open transaction holds back the asynchronous queue
+ */
+TEST_F(SPITest, TransactionBlocksQueue) 
+{
+    uint8_t tx[1] = {0};
+    SpiTransaction txn;
+    txn.segments.resize(1);
+    txn.segments[0].tx = tx;
+    txn.segments[0].length = 1;
+    
+    std::atomic<bool> done{false};
+    SPI.beginTransaction(SPISettings());
+    ASSERT_TRUE(SPI.submit(txn, [&](bool) { done = true; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done.load());
+    SPI.endTransaction();
+    
+    SPI.waitForPending();
+    EXPECT_TRUE(done.load());
+}
+
 /**
  * @brief Main entry point for tests
  */
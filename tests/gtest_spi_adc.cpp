@@ -0,0 +1,165 @@
+/**
+ * @file gtest_spi_adc.cpp
+ * @brief GoogleTest unit tests for prepared SPI messages and the ADC sampler
+ *
+ * A simulated spidev answers each 3-byte frame like an MCP3008 whose
+ * channel n reads n * 100 + 7.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "spi_adc.hpp"
+#include "sim_backend.hpp"
+#include <stdexcept>
+
+using namespace pipinpp;
+
+namespace {
+
+uint16_t channelValue(int channel) {
+    return static_cast<uint16_t>(channel * 100 + 7);
+}
+
+void mcp3008(const uint8_t* tx, uint8_t* rx, size_t length) {
+    if (length != 3 || rx == nullptr) {
+        return;
+    }
+    uint16_t value = channelValue((tx[1] >> 4) & 0x07);
+    rx[0] = 0xFF;                          // Undriven bits must be masked off
+    rx[1] = static_cast<uint8_t>(0xFC | (value >> 8));
+    rx[2] = static_cast<uint8_t>(value);
+}
+
+} // namespace
+
+TEST(SpiAdcCodecTest, EncodesDatasheetCommands) {
+    uint8_t frame[3];
+    SpiAdcSampler::encode(SpiAdcChip::MCP3008, 5, false, frame);
+    EXPECT_EQ(frame[0], 0x01);
+    EXPECT_EQ(frame[1], 0xD0);             // SGL=1, D2..D0=101
+    SpiAdcSampler::encode(SpiAdcChip::MCP3008, 1, true, frame);
+    EXPECT_EQ(frame[1], 0x10);
+    SpiAdcSampler::encode(SpiAdcChip::MCP3208, 6, false, frame);
+    EXPECT_EQ(frame[0], 0x07);             // START, SGL, D2
+    EXPECT_EQ(frame[1], 0x80);             // D1 D0 = 10
+    EXPECT_EQ(frame[2], 0x00);
+}
+
+TEST(SpiAdcCodecTest, DecodesOnlyTheResultBits) {
+    const uint8_t raw[] = {0xFF, 0xFF, 0xFF,  0x00, 0xFE, 0x34,  0x12, 0xF1, 0x00};
+    uint16_t samples[3];
+    SpiAdcSampler::decode(SpiAdcChip::MCP3008, raw, samples, 3);
+    EXPECT_EQ(samples[0], 1023);
+    EXPECT_EQ(samples[1], 0x234);
+    EXPECT_EQ(samples[2], 0x100);
+    SpiAdcSampler::decode(SpiAdcChip::MCP3208, raw, samples, 3);
+    EXPECT_EQ(samples[0], 4095);
+    EXPECT_EQ(samples[1], 0xE34);
+    EXPECT_EQ(samples[2], 0x100);
+}
+
+TEST(SpiAdcCodecTest, RejectsInvalidConfig) {
+    SpiAdcConfig config;
+    config.channels = {};
+    EXPECT_THROW(SpiAdcSampler(SPI, config), std::invalid_argument);
+    config.channels = {8};
+    EXPECT_THROW(SpiAdcSampler(SPI, config), std::invalid_argument);
+    config.channels = {0};
+    config.blockCount = 1;
+    EXPECT_THROW(SpiAdcSampler(SPI, config), std::invalid_argument);
+}
+
+class SpiAdcSimTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+        SimulatedHardware::getInstance().addSpiDevice(0, 0, mcp3008);
+        ASSERT_TRUE(SPI.begin(0, 0));
+    }
+
+    void TearDown() override {
+        SPI.end();
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+};
+
+TEST_F(SpiAdcSimTest, PreparedMessageSplitsAtTheTransferLimit) {
+    std::vector<uint8_t> tx(3 * 1024), rx(3 * 1024);
+    std::vector<SpiSegment> frames(1024);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        frames[i].tx = &tx[3 * i];
+        frames[i].rx = &rx[3 * i];
+        frames[i].length = 3;
+        frames[i].csChange = true;
+    }
+    SpiPreparedMessage message;
+    ASSERT_TRUE(SPI.prepare(frames.data(), frames.size(), message));
+    EXPECT_EQ(message.transferCount(), 1024u);
+    EXPECT_EQ(message.ioctlCount(), 3u);   // 511 + 511 + 2
+
+    EXPECT_TRUE(SPI.transferPrepared(message));
+    EXPECT_TRUE(SPI.transferPrepared(message));
+    EXPECT_EQ(SimulatedHardware::getInstance().getSpiTransferCount(0, 0), 2048u);
+
+    SPI.end();
+    EXPECT_FALSE(SPI.transferPrepared(message));
+    EXPECT_FALSE(SPI.prepare(frames.data(), frames.size(), message));
+    EXPECT_TRUE(message.empty());
+}
+
+TEST_F(SpiAdcSimTest, DeliversScannedBlocksInOrder) {
+    SpiAdcConfig config;
+    config.channels = {0, 3};
+    config.samplesPerBlock = 64;
+    config.blockCount = 4;
+    SpiAdcSampler adc(SPI, config);
+    ASSERT_TRUE(adc.start());
+    EXPECT_FALSE(adc.start());
+    EXPECT_EQ(adc.readChannel(0), -1);     // Bus belongs to the sampler
+
+    for (uint64_t expected = 0; expected < 10; ++expected) {
+        const SpiAdcBlock* block = adc.acquire(2000);
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(block->sequence, expected);
+        ASSERT_EQ(block->count, 64u);
+        for (size_t i = 0; i < block->count; ++i) {
+            ASSERT_EQ(block->samples[i], channelValue(i % 2 == 0 ? 0 : 3)) << "sample " << i;
+        }
+        EXPECT_LE(block->startNs, block->endNs);
+        adc.release(block);
+    }
+    adc.stop();
+    EXPECT_FALSE(adc.isRunning());
+    EXPECT_GE(adc.getBlockCount(), 10u);
+    EXPECT_EQ(adc.getErrors(), 0u);
+    EXPECT_EQ(adc.readChannel(5), channelValue(5));
+}
+
+TEST_F(SpiAdcSimTest, HoldingEveryBlockPausesSampling) {
+    SpiAdcConfig config;
+    config.samplesPerBlock = 16;
+    config.blockCount = 2;
+    SpiAdcSampler adc(SPI, config);
+    ASSERT_TRUE(adc.start());
+
+    const SpiAdcBlock* first = adc.acquire(2000);
+    const SpiAdcBlock* second = adc.acquire(2000);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(adc.acquire(20), nullptr);   // Nothing left to sample into
+    EXPECT_GE(adc.getOverruns(), 1u);
+    EXPECT_EQ(adc.getBlockCount(), 2u);
+
+    adc.release(first);
+    const SpiAdcBlock* next = adc.acquire(2000);
+    ASSERT_NE(next, nullptr);
+    EXPECT_EQ(next->sequence, 2u);
+    EXPECT_TRUE(next->gapBefore);
+    adc.release(next);
+    adc.release(second);
+    adc.stop();
+}
@@ -0,0 +1,104 @@
+/**
+ * @file gtest_spsc_ring.cpp
+ * @brief GoogleTest unit tests for the lock-free SPSC ring buffer
+ *
+ * Tests capacity rounding, wraparound, partial push/pop and a two-thread
+ * producer/consumer run. No hardware is required.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "spsc_ring.hpp"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace pipinpp;
+
+TEST(SpscRingTest, CapacityRoundsUpToPowerOfTwo) {
+    EXPECT_EQ(SpscRing<uint8_t>(0).capacity(), 2u);
+    EXPECT_EQ(SpscRing<uint8_t>(5).capacity(), 8u);
+    EXPECT_EQ(SpscRing<uint8_t>(64).capacity(), 64u);
+}
+
+TEST(SpscRingTest, PushStopsWhenFull) {
+    SpscRing<uint8_t> ring(4);
+    uint8_t data[6] = {1, 2, 3, 4, 5, 6};
+
+    EXPECT_EQ(ring.push(data, 6), 4u);
+    EXPECT_EQ(ring.size(), 4u);
+    EXPECT_EQ(ring.push(data, 1), 0u);
+}
+
+TEST(SpscRingTest, PeekDoesNotConsume) {
+    SpscRing<uint8_t> ring(4);
+    uint8_t value = 0;
+    EXPECT_FALSE(ring.peek(value));
+
+    uint8_t data[2] = {7, 8};
+    ring.push(data, 2);
+    EXPECT_TRUE(ring.peek(value));
+    EXPECT_EQ(value, 7);
+    EXPECT_EQ(ring.size(), 2u);
+}
+
+TEST(SpscRingTest, WrapsAround) {
+    SpscRing<uint8_t> ring(4);
+    uint8_t data[3] = {1, 2, 3};
+    uint8_t out[4] = {0};
+
+    ring.push(data, 3);
+    EXPECT_EQ(ring.pop(out, 2), 2u);
+
+    uint8_t more[3] = {4, 5, 6};
+    EXPECT_EQ(ring.push(more, 3), 3u);  // Spans the end of the buffer
+    EXPECT_EQ(ring.pop(out, 4), 4u);
+    EXPECT_EQ(out[0], 3);
+    EXPECT_EQ(out[1], 4);
+    EXPECT_EQ(out[3], 6);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, ClearDiscardsEverything) {
+    SpscRing<uint8_t> ring(8);
+    uint8_t data[5] = {1, 2, 3, 4, 5};
+    ring.push(data, 5);
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.push(data, 5), 5u);
+}
+
+TEST(SpscRingTest, ProducerConsumerPreservesOrder) {
+    SpscRing<uint32_t> ring(256);
+    constexpr uint32_t COUNT = 200000;
+
+    std::thread producer([&]() {
+        uint32_t next = 0;
+        while (next < COUNT) {
+            uint32_t batch[16];
+            size_t n = 0;
+            while (n < 16 && next + n < COUNT) {
+                batch[n] = next + static_cast<uint32_t>(n);
+                n++;
+            }
+            next += static_cast<uint32_t>(ring.push(batch, n));
+        }
+    });
+
+    uint32_t expected = 0;
+    bool inOrder = true;
+    while (expected < COUNT) {
+        uint32_t out[32];
+        size_t n = ring.pop(out, 32);
+        for (size_t i = 0; i < n; ++i) {
+            inOrder = inOrder && (out[i] == expected);
+            expected++;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_TRUE(ring.empty());
+}
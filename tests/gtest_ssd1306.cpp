@@ -0,0 +1,251 @@
+/**
+ * @file gtest_ssd1306.cpp
+ * @brief GoogleTest unit tests for the SSD1306 framebuffer driver
+ *
+ * The SPI tests run the driver against a small model of the controller
+ * (D/C line, column/page window, horizontal addressing) attached to a
+ * simulated spidev, so the panel contents can be compared with the
+ * framebuffer after partial updates.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "ssd1306.hpp"
+#include "sim_backend.hpp"
+#include <cstring>
+#include <stdexcept>
+
+using namespace pipinpp;
+
+namespace {
+
+constexpr int DC_PIN = 25;
+
+/**
+ * @brief Just enough of the SSD1306 to follow windowed data writes
+ */
+struct PanelModel {
+    uint8_t ram[8][128] = {};
+    std::vector<uint8_t> command;
+    int columnStart = 0, columnEnd = 127, pageStart = 0, pageEnd = 7;
+    int column = 0, page = 0;
+    size_t dataBytes = 0;
+
+    void receive(const uint8_t* tx, size_t length) {
+        bool data = SimulatedHardware::getInstance().getLevel(DC_PIN) == 1;
+        for (size_t i = 0; i < length; ++i) {
+            data ? writeData(tx[i]) : writeCommand(tx[i]);
+        }
+    }
+
+    void writeCommand(uint8_t byte) {
+        command.push_back(byte);
+        if (command[0] == 0x21 && command.size() == 3) {
+            columnStart = column = command[1];
+            columnEnd = command[2];
+            command.clear();
+        } else if (command[0] == 0x22 && command.size() == 3) {
+            pageStart = page = command[1];
+            pageEnd = command[2];
+            command.clear();
+        } else if (command[0] != 0x21 && command[0] != 0x22) {
+            command.clear();                   // Other commands are not modelled
+        }
+    }
+
+    void writeData(uint8_t byte) {
+        ram[page][column] = byte;
+        ++dataBytes;
+        if (++column > columnEnd) {
+            column = columnStart;
+            if (++page > pageEnd) {
+                page = pageStart;
+            }
+        }
+    }
+};
+
+} // namespace
+
+class Ssd1306SpiTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+        SimulatedHardware::getInstance().addSpiDevice(0, 0, [this](const uint8_t* tx, uint8_t*, size_t length) {
+            panel.receive(tx, length);
+        });
+        ASSERT_TRUE(SPI.begin(0, 0));
+    }
+
+    void TearDown() override {
+        SPI.end();
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+
+    bool panelMatches(const Ssd1306& oled) const {
+        for (int page = 0; page < oled.pages(); ++page) {
+            if (std::memcmp(panel.ram[page], oled.buffer() + page * oled.width(), oled.width()) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    PanelModel panel;
+};
+
+TEST_F(Ssd1306SpiTest, FirstDisplayIsAFullFrame) {
+    Ssd1306 oled(SPI, DC_PIN);
+    ASSERT_TRUE(oled.begin());
+    oled.drawRect(0, 0, 128, 64);
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 1024u);
+    EXPECT_EQ(oled.getLastUpdateRectangles(), 1u);
+    EXPECT_TRUE(panelMatches(oled));
+
+    ASSERT_TRUE(oled.display());               // Nothing changed
+    EXPECT_EQ(oled.getLastUpdateBytes(), 0u);
+    EXPECT_EQ(oled.getLastUpdateRectangles(), 0u);
+}
+
+TEST_F(Ssd1306SpiTest, SendsOnlyChangedBytes) {
+    Ssd1306 oled(SPI, DC_PIN);
+    ASSERT_TRUE(oled.begin());
+    oled.drawRect(14, 50, 102, 10);
+    ASSERT_TRUE(oled.display());
+
+    size_t before = panel.dataBytes;
+    oled.fillRect(15, 51, 10, 8);              // Progress bar: pages 6 and 7
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateRectangles(), 1u);
+    EXPECT_EQ(oled.getLastUpdateBytes(), 20u);
+    EXPECT_EQ(panel.dataBytes - before, 20u);
+    EXPECT_TRUE(panelMatches(oled));
+
+    oled.setPixel(0, 0);                       // Far apart: two windows
+    oled.setPixel(127, 63);
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateRectangles(), 2u);
+    EXPECT_EQ(oled.getLastUpdateBytes(), 2u);
+    EXPECT_TRUE(panelMatches(oled));
+}
+
+TEST_F(Ssd1306SpiTest, RedrawingTheSameFrameSendsNothing) {
+    Ssd1306 oled(SPI, DC_PIN);
+    ASSERT_TRUE(oled.begin());
+    auto frame = [&](int x) {
+        oled.clear();
+        oled.drawRect(0, 0, 128, 64);
+        oled.drawCircle(x, 32, 5);
+    };
+    frame(40);
+    ASSERT_TRUE(oled.display());
+
+    frame(40);
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 0u);
+
+    frame(42);                                 // Ball moved two columns
+    ASSERT_TRUE(oled.display());
+    EXPECT_GT(oled.getLastUpdateBytes(), 0u);
+    EXPECT_LE(oled.getLastUpdateBytes(), 2u * 13u);
+    EXPECT_TRUE(panelMatches(oled));
+}
+
+TEST_F(Ssd1306SpiTest, SplitGapControlsRunMerging) {
+    Ssd1306 oled(SPI, DC_PIN);
+    ASSERT_TRUE(oled.begin());
+    ASSERT_TRUE(oled.display());
+
+    oled.setPixel(10, 0);
+    oled.setPixel(15, 0);
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateRectangles(), 1u);   // 4-byte gap is resent
+    EXPECT_EQ(oled.getLastUpdateBytes(), 6u);
+
+    oled.setSplitGap(0);
+    oled.setPixel(20, 0);
+    oled.setPixel(25, 0);
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateRectangles(), 2u);
+    EXPECT_EQ(oled.getLastUpdateBytes(), 2u);
+    EXPECT_TRUE(panelMatches(oled));
+}
+
+TEST_F(Ssd1306SpiTest, DirectBufferWritesNeedMarkDirty) {
+    Ssd1306 oled(SPI, DC_PIN, -1, 128, 32);
+    ASSERT_TRUE(oled.begin());
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 512u);
+
+    oled.buffer()[3 * 128 + 7] = 0xFF;
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 0u);
+    oled.markDirty(7, 24, 1, 8);
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 1u);
+    EXPECT_TRUE(panelMatches(oled));
+
+    oled.invalidate();
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 512u);
+}
+
+class Ssd1306I2cTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().install();
+        SimulatedHardware::getInstance().addI2cDevice(1, SSD1306_I2C_ADDRESS);
+        ASSERT_TRUE(Wire.begin(1));
+    }
+
+    void TearDown() override {
+        Wire.end();
+        SimulatedHardware::getInstance().reset();
+        SimulatedHardware::getInstance().uninstall();
+    }
+};
+
+TEST_F(Ssd1306I2cTest, FailedUpdateStaysDirty) {
+    Ssd1306 oled;
+    ASSERT_TRUE(oled.begin());
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 1024u);
+
+    oled.drawHLine(0, 8, 16);
+    Wire.end();
+    EXPECT_FALSE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 0u);
+
+    ASSERT_TRUE(Wire.begin(1));
+    ASSERT_TRUE(oled.display());
+    EXPECT_EQ(oled.getLastUpdateBytes(), 16u);
+    EXPECT_EQ(oled.getTotalBytes(), 1040u);
+}
+
+TEST(Ssd1306Test, RejectsUnsupportedGeometry) {
+    EXPECT_THROW(Ssd1306(128, 60), std::invalid_argument);
+    EXPECT_THROW(Ssd1306(0, 64), std::invalid_argument);
+    EXPECT_THROW(Ssd1306(132, 64), std::invalid_argument);
+    EXPECT_NO_THROW(Ssd1306(64, 48));
+}
+
+TEST(Ssd1306Test, DrawsIntoThePageLayout) {
+    Ssd1306 oled(128, 64);
+    oled.setPixel(3, 10);
+    EXPECT_EQ(oled.buffer()[128 + 3], 0x04);
+    EXPECT_TRUE(oled.getPixel(3, 10));
+    oled.fillRect(0, 4, 2, 8);                 // Rows 4-11 span pages 0 and 1
+    EXPECT_EQ(oled.buffer()[0], 0xF0);
+    EXPECT_EQ(oled.buffer()[128], 0x0F);
+    oled.fillRect(0, 4, 2, 8, false);
+    EXPECT_EQ(oled.buffer()[0], 0x00);
+    oled.setPixel(-1, 0);                      // Clipped
+    oled.setPixel(0, 64);
+    EXPECT_FALSE(oled.getPixel(-1, 0));
+}
@@ -0,0 +1,154 @@
+/**
+ * @file gtest_stepper.cpp
+ * @brief GoogleTest unit tests for stepper ramp planning and move compilation
+ *
+ * Tests trapezoid and S-curve interval planning, multi-axis timelines and
+ * coordinated moves without hardware, plus construction and a short move
+ * when GPIO is available (skipped otherwise).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "stepper.hpp"
+#include "exceptions.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace pipinpp;
+
+namespace {
+
+StepperProfile makeProfile(uint32_t speed, uint32_t accel, StepperRamp ramp = StepperRamp::TRAPEZOID) {
+    StepperProfile profile;
+    profile.maxStepsPerSec = speed;
+    profile.accelStepsPerSec2 = accel;
+    profile.ramp = ramp;
+    return profile;
+}
+
+// Times of every rising edge on a pin when the wave is played from t = 0
+std::vector<uint64_t> risingEdges(const Wave& wave, int pin) {
+    std::vector<uint64_t> times;
+    uint64_t now = 0;
+    for (const WaveStep& step : wave.steps()) {
+        if (step.setMask & (1u << pin)) {
+            times.push_back(now);
+        }
+        now += step.delayNs;
+    }
+    return times;
+}
+
+} // namespace
+
+TEST(StepperPlanTest, TrapezoidRampsToCruiseAndBack) {
+    // 10000 steps/s at 100000 steps/s^2: 500 steps to reach cruise speed
+    auto intervals = StepperDriver::planIntervals(2000, makeProfile(10000, 100000));
+    ASSERT_EQ(intervals.size(), 1999u);
+
+    EXPECT_EQ(intervals[1000], 100000u);                   // Cruise: 100 µs
+    EXPECT_EQ(intervals.front(), intervals.back());         // Symmetric
+    EXPECT_GT(intervals[0], intervals[1]);
+    for (size_t n = 1; n < 500; ++n) {
+        EXPECT_LE(intervals[n], intervals[n - 1]) << "at " << n;
+    }
+
+    // Matches v = sqrt(2 a d) within integer rounding
+    double expected = 1e9 / std::sqrt(100000.0 * (2 * 100 + 1));
+    EXPECT_NEAR(intervals[100], expected, 5.0);
+}
+
+TEST(StepperPlanTest, ShortMoveNeverReachesCruise) {
+    auto intervals = StepperDriver::planIntervals(100, makeProfile(10000, 100000));
+    ASSERT_EQ(intervals.size(), 99u);
+    EXPECT_GT(*std::min_element(intervals.begin(), intervals.end()), 100000u);
+    EXPECT_TRUE(StepperDriver::planIntervals(1, makeProfile(10000, 100000)).empty());
+}
+
+TEST(StepperPlanTest, SCurveStartsSofterAndKeepsRampLength) {
+    auto trapezoid = StepperDriver::planIntervals(2000, makeProfile(10000, 100000));
+    auto scurve = StepperDriver::planIntervals(2000, makeProfile(10000, 100000, StepperRamp::S_CURVE));
+    ASSERT_EQ(scurve.size(), trapezoid.size());
+
+    EXPECT_GT(scurve[0], trapezoid[0]);                     // Zero jerk at the start
+    EXPECT_EQ(scurve[500], 100000u);                        // Same ramp distance
+    for (size_t n = 1; n < 500; ++n) {
+        EXPECT_LE(scurve[n], scurve[n - 1]) << "at " << n;
+    }
+}
+
+TEST(StepperPlanTest, StartSpeedBoundsFirstInterval) {
+    StepperProfile profile = makeProfile(10000, 100000, StepperRamp::S_CURVE);
+    profile.startStepsPerSec = 1000;
+    auto intervals = StepperDriver::planIntervals(2000, profile);
+    EXPECT_LE(intervals.front(), 1000000u);
+}
+
+TEST(StepperMoveTest, TwoAxesShareOneTimeline) {
+    std::vector<StepperAxis> axes = {{20, 21, makeProfile(10000, 100000)},
+                                     {19, 26, makeProfile(10000, 100000)}};
+    axes[1].invertDir = true;
+
+    StepperMove move = StepperDriver::compileMove(axes, {400, -200});
+    ASSERT_TRUE(move.wave);
+    const Wave& wave = *move.wave;
+
+    EXPECT_EQ(wave.steps()[0].setMask, (1u << 21) | (1u << 26));   // Positive, and inverted negative
+    EXPECT_EQ(wave.pinMask(), (1u << 19) | (1u << 20) | (1u << 21) | (1u << 26));
+
+    auto x = risingEdges(wave, 20);
+    auto y = risingEdges(wave, 19);
+    ASSERT_EQ(x.size(), 400u);
+    ASSERT_EQ(y.size(), 200u);
+    EXPECT_EQ(x.front(), 5000u);                            // After the DIR setup time
+    EXPECT_EQ(y.front(), 5000u);
+    EXPECT_NEAR(static_cast<double>(y.back()), static_cast<double>(x.back()), 2.0);   // Coordinated
+
+    StepperMove independent = StepperDriver::compileMove(axes, {400, -200}, false);
+    auto yFree = risingEdges(*independent.wave, 19);
+    EXPECT_LT(yFree.back(), x.back());
+    EXPECT_EQ(independent.steps, (std::vector<int64_t>{400, -200}));
+}
+
+TEST(StepperMoveTest, IdleAxesAreUntouched) {
+    std::vector<StepperAxis> axes = {{20, 21, makeProfile(10000, 100000)},
+                                     {19, 26, makeProfile(10000, 100000)}};
+    StepperMove move = StepperDriver::compileMove(axes, {-3, 0});
+    EXPECT_EQ(move.wave->pinMask(), (1u << 20) | (1u << 21));
+    EXPECT_EQ(move.wave->steps()[0].clearMask, 1u << 21);
+    EXPECT_EQ(risingEdges(*move.wave, 20).size(), 3u);
+
+    EXPECT_TRUE(StepperDriver::compileMove(axes, {0, 0}).wave->empty());
+    EXPECT_THROW(StepperDriver::compileMove(axes, {1}), std::invalid_argument);
+}
+
+TEST(StepperDriverTest, RejectsInvalidAxes) {
+    EXPECT_THROW(StepperDriver(std::vector<StepperAxis>{}), InvalidPinError);
+    EXPECT_THROW(StepperDriver({{20, 21, makeProfile(0, 1000)}}), InvalidPinError);
+    EXPECT_THROW(StepperDriver({{20, 21, makeProfile(1000, 0)}}), InvalidPinError);
+    EXPECT_THROW(StepperDriver({{20, 21, makeProfile(400000, 1000)}}), InvalidPinError);
+
+    StepperAxis longPulse{20, 21, makeProfile(200000, 1000)};
+    longPulse.pulseNs = 5000;                                // Longer than half of 5 µs
+    EXPECT_THROW(StepperDriver({longPulse}), InvalidPinError);
+}
+
+TEST(StepperDriverTest, ShortMoveUpdatesPosition) {
+    try {
+        StepperDriver driver({{20, 21, makeProfile(20000, 200000)}});
+        ASSERT_TRUE(driver.move({50}));
+        EXPECT_TRUE(driver.wait(2000));
+        EXPECT_EQ(driver.getPosition(0), 50);
+
+        StepperMove back = driver.compileMove({-50});
+        ASSERT_TRUE(driver.move(back));
+        EXPECT_TRUE(driver.wait(2000));
+        EXPECT_EQ(driver.getPosition(0), 0);
+        EXPECT_THROW(driver.getPosition(1), std::out_of_range);
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
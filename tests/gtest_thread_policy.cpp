@@ -0,0 +1,119 @@
+/**
+ * @file gtest_thread_policy.cpp
+ * @brief GoogleTest unit tests for the PiPinPP thread scheduling policy
+ *
+ * Tests validation and status reporting. Real-time scheduling and memory
+ * locking depend on privileges, so those tests only check that the result
+ * is reported consistently.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "thread_policy.hpp"
+#include "exceptions.hpp"
+#include <thread>
+
+using namespace pipinpp;
+
+class ThreadPolicyTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        ThreadPolicyManager::getInstance().setPolicy(ThreadPolicy());
+    }
+};
+
+TEST_F(ThreadPolicyTest, DefaultPolicyIsGranted) {
+    auto& manager = ThreadPolicyManager::getInstance();
+    manager.setPolicy(ThreadPolicy());
+    EXPECT_TRUE(manager.getPolicy().isDefault());
+
+    ThreadPolicyStatus status;
+    std::thread([&] { status = manager.applyToCurrentThread("test-default"); }).join();
+
+    EXPECT_TRUE(status.applied);
+    EXPECT_TRUE(status.granted());
+    EXPECT_TRUE(status.message.empty());
+}
+
+TEST_F(ThreadPolicyTest, InvalidPolicyThrows) {
+    auto& manager = ThreadPolicyManager::getInstance();
+
+    ThreadPolicy policy;
+    policy.priority = 100;
+    EXPECT_THROW(manager.setPolicy(policy), InvalidPinError);
+
+    policy.priority = -1;
+    EXPECT_THROW(manager.setPolicy(policy), InvalidPinError);
+
+    policy.priority = 0;
+    policy.cpu = -2;
+    EXPECT_THROW(manager.setPolicy(policy), InvalidPinError);
+}
+
+TEST_F(ThreadPolicyTest, AffinityToFirstCpu) {
+    auto& manager = ThreadPolicyManager::getInstance();
+    ThreadPolicy policy;
+    policy.cpu = 0;
+    manager.setPolicy(policy);
+
+    int cpu = -1;
+    ThreadPolicyStatus status;
+    std::thread([&] {
+        status = manager.applyToCurrentThread("test-affinity");
+        cpu = sched_getcpu();
+    }).join();
+
+    if (!status.affinityGranted) {
+        GTEST_SKIP() << "CPU affinity not permitted: " << status.message;
+    }
+    EXPECT_TRUE(status.granted());
+    EXPECT_EQ(cpu, 0);
+}
+
+TEST_F(ThreadPolicyTest, UnavailableCpuIsReported) {
+    auto& manager = ThreadPolicyManager::getInstance();
+    ThreadPolicy policy;
+    policy.cpu = 100000;
+    manager.setPolicy(policy);
+
+    ThreadPolicyStatus status;
+    std::thread([&] { status = manager.applyToCurrentThread("test-badcpu"); }).join();
+
+    EXPECT_TRUE(status.applied);
+    EXPECT_FALSE(status.affinityGranted);
+    EXPECT_FALSE(status.granted());
+    EXPECT_FALSE(status.message.empty());
+}
+
+TEST_F(ThreadPolicyTest, RealtimeResultIsConsistent) {
+    auto& manager = ThreadPolicyManager::getInstance();
+    ThreadPolicy policy;
+    policy.priority = 10;
+    manager.setPolicy(policy);
+
+    ThreadPolicyStatus status;
+    std::thread([&] { status = manager.applyToCurrentThread("test-rt"); }).join();
+
+    EXPECT_TRUE(status.applied);
+    EXPECT_EQ(status.granted(), status.realtimeGranted);
+    EXPECT_EQ(status.message.empty(), status.realtimeGranted);
+}
+
+TEST_F(ThreadPolicyTest, StatusIsRecordedByName) {
+    auto& manager = ThreadPolicyManager::getInstance();
+
+    EXPECT_FALSE(manager.getStatus("test-never-started").applied);
+
+    std::thread([&] { manager.applyToCurrentThread("test-recorded"); }).join();
+    EXPECT_TRUE(manager.getStatus("test-recorded").applied);
+
+    bool found = false;
+    for (const auto& entry : manager.report()) {
+        if (entry.first == "test-recorded") {
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file gtest_timebase.cpp
+ * @brief GoogleTest unit tests for the shared monotonic timebase
+ *
+ * Tests that millis(), micros() and timebaseNanos() share one epoch, are
+ * monotonic and track CLOCK_MONOTONIC.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "timebase.hpp"
+#include "ArduinoCompat.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace pipinpp;
+
+TEST(TimebaseTest, UnitsShareOneEpoch) {
+    uint64_t ns = timebaseNanos();
+    uint64_t us = timebaseMicros();
+    uint64_t ms = timebaseMillis();
+
+    EXPECT_GE(us, ns / 1000);
+    EXPECT_LT(us - ns / 1000, 1000u);
+    EXPECT_GE(ms, ns / 1000000);
+    EXPECT_LE(ms - ns / 1000000, 1u);
+
+    unsigned long arduinoMicros = micros();
+    unsigned long arduinoMillis = millis();
+    EXPECT_LE(arduinoMillis, arduinoMicros / 1000 + 1);
+    EXPECT_GE(arduinoMillis + 1, arduinoMicros / 1000);
+}
+
+TEST(TimebaseTest, MonotonicAndTracksClock) {
+    uint64_t previous = timebaseNanos();
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t now = timebaseNanos();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+
+    int64_t clockStart = monotonicNowNs();
+    uint64_t start = timebaseNanos();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int64_t clockElapsed = monotonicNowNs() - clockStart;
+    int64_t elapsed = static_cast<int64_t>(timebaseNanos() - start);
+
+    EXPECT_GE(elapsed, 20000000);
+    EXPECT_NEAR(static_cast<double>(elapsed), static_cast<double>(clockElapsed), 200000.0);
+}
+
+TEST(TimebaseTest, CounterFrequencyIsKnown) {
+    EXPECT_GT(cycleCounterHz(), 1000000u);
+    uint64_t a = readCycleCounter();
+    uint64_t b = readCycleCounter();
+    EXPECT_GE(b, a);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file gtest_timer_manager.cpp
+ * @brief GoogleTest unit tests for the fixed-rate periodic task scheduler
+ *
+ * Tests argument validation, fixed-rate release counts, skipped releases,
+ * pool execution, statistics and cancellation (including from a callback).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "timer_manager.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace pipinpp;
+
+TEST(TimerManagerTest, RejectsInvalidTasks) {
+    TimerManager timers;
+    EXPECT_EQ(timers.every(0, [] {}), -1);
+    EXPECT_EQ(timers.every(1000, TimerCallback()), -1);
+    EXPECT_EQ(timers.size(), 0u);
+    EXPECT_FALSE(timers.cancel(42));
+    EXPECT_FALSE(timers.setPeriod(42, 1000));
+    EXPECT_FALSE(timers.resetStats(42));
+    EXPECT_EQ(timers.getStats(42).runs, 0u);
+}
+
+TEST(TimerManagerTest, FixedRateDoesNotDrift) {
+    TimerManager timers;
+    std::atomic<int> count{0};
+    // Work of 3 ms per 10 ms period would add up to 390 ms over 30 delay() loops
+    const int id = timers.every(10000, [&count] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        ++count;
+    });
+    ASSERT_GT(id, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(305));
+    EXPECT_TRUE(timers.cancel(id));
+    EXPECT_GE(count.load(), 27);
+    EXPECT_LE(count.load(), 30);
+    EXPECT_EQ(timers.size(), 0u);
+}
+
+TEST(TimerManagerTest, StatsTrackRunsAndLateness) {
+    TimerManager timers;
+    const int id = timers.every(2000, [] {});
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    TimerStats stats = timers.getStats(id);
+    EXPECT_GE(stats.runs, 15u);
+    EXPECT_GE(stats.minLatenessNs, 0);
+    EXPECT_GE(stats.maxLatenessNs, stats.minLatenessNs);
+    EXPECT_EQ(stats.jitterNs(), stats.maxLatenessNs - stats.minLatenessNs);
+    EXPECT_GE(stats.meanLatenessNs(), static_cast<double>(stats.minLatenessNs));
+
+    EXPECT_TRUE(timers.resetStats(id));
+    EXPECT_LT(timers.getStats(id).runs, stats.runs);
+}
+
+TEST(TimerManagerTest, SlowCallbackSkipsReleases) {
+    TimerManager timers;
+    std::atomic<int> count{0};
+    // 25 ms of work per 10 ms period: two releases missed per run
+    const int id = timers.every(10000, [&count] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(25));
+        ++count;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const TimerStats stats = timers.getStats(id);
+    timers.cancel(id);
+    EXPECT_LE(count.load(), 8);
+    EXPECT_GE(stats.overruns, stats.runs);
+    EXPECT_GE(stats.maxRunNs, 25000000);
+}
+
+TEST(TimerManagerTest, PoolTasksRunOffTheTimerThread) {
+    TimerManager timers(1);
+    std::atomic<int> fast{0};
+    std::atomic<int> slow{0};
+    const int fastId = timers.every(5000, [&fast] { ++fast; });
+    // Blocks its worker for 50 ms per run without delaying the fast task
+    const int slowId = timers.every(10000, [&slow] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ++slow;
+    }, TimerExecution::POOL);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const TimerStats slowStats = timers.getStats(slowId);
+    timers.clear();
+    EXPECT_GE(fast.load(), 30);
+    EXPECT_GE(slow.load(), 2);
+    EXPECT_LE(slow.load(), 5);
+    EXPECT_GT(slowStats.overruns, 0u);
+    EXPECT_EQ(timers.getStats(fastId).runs, 0u);
+    EXPECT_EQ(timers.size(), 0u);
+}
+
+TEST(TimerManagerTest, CallbackCanCancelItself) {
+    TimerManager timers;
+    std::atomic<int> count{0};
+    std::atomic<int> id{-1};
+    id = timers.every(1000, [&] {
+        if (++count == 3) {
+            timers.cancel(id.load());
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(count.load(), 3);
+    EXPECT_EQ(timers.size(), 0u);
+}
+
+TEST(TimerManagerTest, SetPeriodTakesEffect) {
+    TimerManager timers;
+    std::atomic<int> count{0};
+    const int id = timers.every(50000, [&count] { ++count; });
+    EXPECT_TRUE(timers.setPeriod(id, 2000));
+    EXPECT_FALSE(timers.setPeriod(id, 0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    timers.cancel(id);
+    EXPECT_GE(count.load(), 20);
+}
+
+TEST(TimerManagerTest, SpinTailKeepsReleasesOnTime) {
+    TimerManager timers;
+    timers.setSpin(200000);
+    const int id = timers.every(5000, [] {});
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const TimerStats stats = timers.getStats(id);
+    timers.cancel(id);
+    EXPECT_GE(stats.runs, 8u);
+    EXPECT_GE(stats.minLatenessNs, 0);
+}
@@ -0,0 +1,187 @@
+/**
+ * @file gtest_timing_guard.cpp
+ * @brief GoogleTest unit tests for TimingGuard
+ *
+ * Builds a fake /sys, /proc and /dev tree under a temporary directory and
+ * points TimingGuardOptions::sysRoot at it: checks, governor switching,
+ * the PM QoS request, IRQ steering by name, refused settings and restore.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "timing_guard.hpp"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace pipinpp;
+
+namespace {
+
+class TimingGuardTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char pattern[] = "/tmp/pipinpp-timing-XXXXXX";
+        ASSERT_NE(mkdtemp(pattern), nullptr);
+        root_ = pattern;
+
+        for (int policy : {0, 4}) {
+            const std::string dir = "/sys/devices/system/cpu/cpufreq/policy" + std::to_string(policy);
+            put(dir + "/scaling_governor", "ondemand\n");
+            put(dir + "/scaling_available_governors", "ondemand performance powersave\n");
+        }
+        put("/sys/devices/system/cpu/cpu0/cpuidle/state0/name", "WFI\n");
+        put("/sys/devices/system/cpu/cpu0/cpuidle/state0/latency", "1\n");
+        put("/sys/devices/system/cpu/cpu0/cpuidle/state1/name", "cpu-sleep\n");
+        put("/sys/devices/system/cpu/cpu0/cpuidle/state1/latency", "800\n");
+
+        int32_t noLimit = 2000000000;
+        put("/dev/cpu_dma_latency", std::string(reinterpret_cast<const char*>(&noLimit), sizeof(noLimit)));
+
+        put("/proc/interrupts",
+            "           CPU0       CPU1       CPU2       CPU3\n"
+            " 11:      52931      41852      37411      44182     GICv2  30 Level     arch_timer\n"
+            " 35:          0          0          0          0     GICv2 145 Level     fe204000.spi\n"
+            " 40:        120          0          0          0     GICv2 149 Level     fe804000.i2c\n"
+            " 56:         10          0          0          0  pinctrl-bcm2835  17 Edge      PiPinPP\n"
+            "IPI0:        14         12         10         11       Rescheduling interrupts\n");
+        for (int irq : {11, 35, 40, 56}) {
+            put("/proc/irq/" + std::to_string(irq) + "/smp_affinity_list", "0-3\n");
+        }
+    }
+
+    void TearDown() override {
+        std::string command = "rm -rf '" + root_ + "'";
+        ASSERT_EQ(std::system(command.c_str()), 0);
+    }
+
+    void put(const std::string& path, const std::string& content) {
+        std::string full = root_ + path;
+        for (size_t slash = full.find('/', root_.size() + 1); slash != std::string::npos;
+             slash = full.find('/', slash + 1)) {
+            mkdir(full.substr(0, slash).c_str(), 0755);
+        }
+        std::ofstream(full, std::ios::binary) << content;
+    }
+
+    std::string get(const std::string& path) const {
+        std::ifstream file(root_ + path, std::ios::binary);
+        std::stringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    TimingGuardOptions options() const {
+        TimingGuardOptions result;
+        result.sysRoot = root_;
+        result.maxLatencyUs = 20;
+        result.irqCpu = 2;
+        return result;
+    }
+
+    std::string root_;
+};
+
+} // namespace
+
+TEST_F(TimingGuardTest, CheckReportsEachSetting) {
+    TimingGuard guard(options());
+    auto checks = guard.check();
+    ASSERT_EQ(checks.size(), 3u);
+
+    EXPECT_EQ(checks[0].name, "cpufreq governor");
+    EXPECT_TRUE(checks[0].available);
+    EXPECT_FALSE(checks[0].ok);
+    EXPECT_EQ(checks[0].detail, "ondemand");
+
+    EXPECT_TRUE(checks[1].available);
+    EXPECT_FALSE(checks[1].ok);
+    EXPECT_NE(checks[1].detail.find("no limit"), std::string::npos);
+    EXPECT_NE(checks[1].detail.find("cpu-sleep (800 us)"), std::string::npos);
+    EXPECT_EQ(checks[1].detail.find("WFI"), std::string::npos);
+
+    EXPECT_TRUE(checks[2].available);
+    EXPECT_FALSE(checks[2].ok);
+    EXPECT_NE(checks[2].detail.find("35 fe204000.spi on CPU 0-3"), std::string::npos);
+    EXPECT_NE(checks[2].detail.find("56 PiPinPP"), std::string::npos);
+    EXPECT_EQ(checks[2].detail.find("arch_timer"), std::string::npos);
+}
+
+TEST_F(TimingGuardTest, ApplyAndRestore) {
+    {
+        TimingGuard guard(options());
+        TimingGuardStatus status = guard.apply();
+        EXPECT_TRUE(status.granted()) << status.message;
+        EXPECT_EQ(status.steeredIrqs, (std::vector<int>{35, 40, 56}));
+
+        EXPECT_EQ(get("/sys/devices/system/cpu/cpufreq/policy0/scaling_governor"), "performance\n");
+        EXPECT_EQ(get("/sys/devices/system/cpu/cpufreq/policy4/scaling_governor"), "performance\n");
+        EXPECT_EQ(get("/proc/irq/56/smp_affinity_list"), "2\n");
+        EXPECT_EQ(get("/proc/irq/11/smp_affinity_list"), "0-3\n");
+
+        std::string qos = get("/dev/cpu_dma_latency");
+        ASSERT_EQ(qos.size(), sizeof(int32_t));
+        int32_t limit = 0;
+        std::memcpy(&limit, qos.data(), sizeof(limit));
+        EXPECT_EQ(limit, 20);
+
+        for (const TimingCheck& check : guard.check()) {
+            EXPECT_TRUE(check.ok) << check.name << ": " << check.detail;
+        }
+
+        // Applying again keeps the original values for restore()
+        EXPECT_TRUE(guard.apply().granted());
+    }
+    EXPECT_EQ(get("/sys/devices/system/cpu/cpufreq/policy0/scaling_governor"), "ondemand\n");
+    EXPECT_EQ(get("/proc/irq/35/smp_affinity_list"), "0-3\n");
+    EXPECT_EQ(get("/proc/irq/56/smp_affinity_list"), "0-3\n");
+}
+
+TEST_F(TimingGuardTest, RefusedSettingsAreReported) {
+    TimingGuardOptions opts = options();
+    opts.irqNames = {"nonexistent"};
+    put("/proc/irq/35/smp_affinity_list", "0-3\n");
+    unlink((root_ + "/dev/cpu_dma_latency").c_str());
+    unlink((root_ + "/sys/devices/system/cpu/cpufreq/policy4/scaling_governor").c_str());
+
+    TimingGuard guard(opts);
+    TimingGuardStatus status = guard.apply();
+    EXPECT_FALSE(status.granted());
+    EXPECT_FALSE(status.governorGranted);       // policy4 has no governor file left
+    EXPECT_NE(status.message.find("policy4"), std::string::npos);
+    EXPECT_EQ(get("/sys/devices/system/cpu/cpufreq/policy0/scaling_governor"), "performance\n");
+    EXPECT_FALSE(status.latencyGranted);
+    EXPECT_TRUE(status.irqGranted);             // Nothing matched, nothing to move
+    EXPECT_NE(status.message.find("CPU latency"), std::string::npos);
+}
+
+TEST_F(TimingGuardTest, NothingRequestedChangesNothing) {
+    TimingGuardOptions opts;
+    opts.sysRoot = root_;
+    opts.performanceGovernor = false;
+    opts.maxLatencyUs = -1;
+    TimingGuard guard(opts);
+    EXPECT_TRUE(guard.apply().granted());
+    EXPECT_EQ(get("/sys/devices/system/cpu/cpufreq/policy0/scaling_governor"), "ondemand\n");
+    EXPECT_EQ(get("/proc/irq/35/smp_affinity_list"), "0-3\n");
+    for (const TimingCheck& check : guard.check()) {
+        EXPECT_TRUE(check.ok) << check.name;
+    }
+}
+
+TEST_F(TimingGuardTest, RejectsInvalidOptions) {
+    TimingGuardOptions opts;
+    opts.irqCpu = -2;
+    EXPECT_THROW(TimingGuard{opts}, std::invalid_argument);
+    opts.irqCpu = -1;
+    opts.maxLatencyUs = -5;
+    EXPECT_THROW(TimingGuard{opts}, std::invalid_argument);
+}
@@ -0,0 +1,353 @@
+/**
+ * @file gtest_transaction.cpp
+ * @brief GoogleTest unit tests for Transaction
+ *
+ * Runs Pin, digitalWrite() and Board lines on SimulatedHardware inside
+ * transactions: deferred writes, last write wins, pending levels for
+ * toggle(), one set-values call per shared request, shiftOut()/shiftIn()
+ * clock pulses that bypass the transaction, nesting, discard on
+ * exceptions (but not on one already unwinding when the transaction
+ * opened), and pins released before the commit. PWM commits run against a
+ * fake sysfs tree, with inotify recording the order of attribute writes.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "transaction.hpp"
+#include "ArduinoCompat.hpp"
+#include "HardwarePWM.hpp"
+#include "board_config.hpp"
+#include "exceptions.hpp"
+#include "pin.hpp"
+#include "sim_backend.hpp"
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace pipinpp;
+
+namespace {
+
+class TransactionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sim().reset();
+        sim().install();
+    }
+
+    void TearDown() override {
+        sim().reset();
+        sim().uninstall();
+    }
+
+    static SimulatedHardware& sim() { return SimulatedHardware::getInstance(); }
+};
+
+class TransactionPwmTest : public TransactionTest {
+protected:
+    void SetUp() override {
+        TransactionTest::SetUp();
+        char pattern[] = "/tmp/pipinpp-txn-pwm-XXXXXX";
+        ASSERT_NE(mkdtemp(pattern), nullptr);
+        root_ = pattern;
+
+        // Already exported, so begin() finds the attributes without a kernel
+        std::string dir = root_;
+        for (const char* part : {"/sys", "/class", "/pwm", "/pwmchip0", "/pwm0"}) {
+            dir += part;
+            ASSERT_EQ(mkdir(dir.c_str(), 0755), 0);
+        }
+        for (const char* attribute : {"period", "duty_cycle", "enable"}) {
+            std::ofstream(dir + "/" + attribute) << "0";
+        }
+
+        inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        ASSERT_GE(inotify_, 0);
+        ASSERT_GE(inotify_add_watch(inotify_, dir.c_str(), IN_MODIFY), 0);
+    }
+
+    void TearDown() override {
+        if (inotify_ >= 0) {
+            close(inotify_);
+        }
+        std::string command = "rm -rf '" + root_ + "'";
+        EXPECT_EQ(std::system(command.c_str()), 0);
+        TransactionTest::TearDown();
+    }
+
+    // Attributes written since the last call, in order
+    std::vector<std::string> writes() {
+        std::vector<std::string> names;
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(inotify_, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + length;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                names.emplace_back(event->name);
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        return names;
+    }
+
+    std::string root_;
+    int inotify_ = -1;
+};
+
+// Drives an output to a safe level from its destructor, in a transaction
+struct SafeStateGuard {
+    Pin& pin;
+    ~SafeStateGuard() {
+        Transaction txn;
+        pin.write(false);
+    }
+};
+
+} // namespace
+
+TEST_F(TransactionTest, WritesWaitForTheEndOfTheScope) {
+    Pin a(17, PinDirection::OUTPUT);
+    Pin b(27, PinDirection::OUTPUT);
+    {
+        Transaction txn;
+        EXPECT_EQ(Transaction::current(), &txn);
+        EXPECT_TRUE(a.write(true));
+        EXPECT_TRUE(b.write(true));
+        EXPECT_EQ(txn.pendingLines(), 2u);
+        EXPECT_EQ(sim().getLevel(17), 0);
+        EXPECT_EQ(sim().getLevel(27), 0);
+    }
+    EXPECT_EQ(Transaction::current(), nullptr);
+    EXPECT_EQ(sim().getLevel(17), 1);
+    EXPECT_EQ(sim().getLevel(27), 1);
+    EXPECT_EQ(a.getOutputState(), 1);
+}
+
+TEST_F(TransactionTest, LastWriteWins) {
+    Pin out(17, PinDirection::OUTPUT);
+    const uint64_t before = sim().getWriteCount(17);
+    {
+        Transaction txn;
+        out.write(true);
+        out.write(false);
+        out.write(true);
+        EXPECT_EQ(txn.pendingLines(), 1u);
+    }
+    EXPECT_EQ(sim().getWriteCount(17), before + 1);
+    EXPECT_EQ(sim().getLevel(17), 1);
+}
+
+TEST_F(TransactionTest, ToggleSeesPendingWrites) {
+    pinMode(24, OUTPUT);
+    digitalWrite(24, LOW);
+    {
+        Transaction txn;
+        digitalWrite(24, HIGH);
+        digitalToggle(24);              // From the pending HIGH
+        digitalToggle(24);
+        EXPECT_EQ(sim().getLevel(24), 0);
+    }
+    EXPECT_EQ(sim().getLevel(24), 1);
+}
+
+TEST_F(TransactionTest, CommitAppliesAndKeepsRecording) {
+    Pin out(17, PinDirection::OUTPUT);
+    Transaction txn;
+    out.write(true);
+    txn.commit();
+    EXPECT_EQ(sim().getLevel(17), 1);
+    EXPECT_EQ(txn.pendingLines(), 0u);
+
+    out.write(false);
+    EXPECT_EQ(sim().getLevel(17), 1);
+    txn.discard();
+    txn.commit();
+    EXPECT_EQ(sim().getLevel(17), 1);
+}
+
+TEST_F(TransactionTest, BoardLinesChangeTogether) {
+    BoardConfig config;
+    config.output("in1", 17).output("in2", 27).output("enable", 5);
+    Board board(config);
+
+    sim().connect(17, 22);
+    sim().connect(27, 23);
+    Pin watch1(22, PinDirection::INPUT);
+    Pin watch2(23, PinDirection::INPUT);
+    ASSERT_TRUE(watch1.enableEdgeEvents());
+    ASSERT_TRUE(watch2.enableEdgeEvents());
+
+    {
+        Transaction txn;
+        board.line("in1").write(true);
+        board.line("in2").write(true);
+        board.line("enable").write(true);
+    }
+    EXPECT_EQ(sim().getLevel(5), 1);
+
+    PinEdgeEvent first;
+    PinEdgeEvent second;
+    ASSERT_EQ(watch1.waitEdgeEvents(&first, 1, 1000000000), 1);
+    ASSERT_EQ(watch2.waitEdgeEvents(&second, 1, 1000000000), 1);
+    EXPECT_TRUE(first.rising);
+    EXPECT_TRUE(second.rising);
+    EXPECT_EQ(first.timestampNs, second.timestampNs);    // One set-values call
+}
+
+TEST_F(TransactionTest, NestedTransactionsJoin) {
+    Pin out(17, PinDirection::OUTPUT);
+    {
+        Transaction outer;
+        {
+            Transaction inner;
+            EXPECT_TRUE(inner.isJoined());
+            EXPECT_EQ(Transaction::current(), &outer);
+            out.write(true);
+            inner.commit();             // Nothing: the outer one commits
+            EXPECT_EQ(inner.pendingLines(), 1u);
+        }
+        EXPECT_EQ(sim().getLevel(17), 0);
+        EXPECT_EQ(outer.pendingLines(), 1u);
+    }
+    EXPECT_EQ(sim().getLevel(17), 1);
+}
+
+TEST_F(TransactionTest, ExceptionDiscardsPendingWrites) {
+    Pin out(17, PinDirection::OUTPUT);
+    try {
+        Transaction txn;
+        out.write(true);
+        throw std::runtime_error("abort");
+    } catch (const std::runtime_error&) {
+    }
+    EXPECT_EQ(sim().getLevel(17), 0);
+    EXPECT_EQ(Transaction::current(), nullptr);
+}
+
+TEST_F(TransactionTest, TransactionOpenedDuringUnwindingCommits) {
+    Pin out(17, PinDirection::OUTPUT);
+    out.write(true);
+    try {
+        SafeStateGuard guard{out};
+        throw std::runtime_error("fault");
+    } catch (const std::runtime_error&) {
+    }
+    EXPECT_EQ(sim().getLevel(17), 0);
+    EXPECT_EQ(Transaction::current(), nullptr);
+}
+
+TEST_F(TransactionTest, ShiftOutAndShiftInPulseTheClockImmediately) {
+    pinMode(12, OUTPUT);
+    pinMode(13, OUTPUT);
+    pinMode(16, INPUT);
+    const uint64_t before = sim().getWriteCount(13);
+    Transaction txn;
+    shiftOut(12, 13, MSBFIRST, 0xA5);
+    EXPECT_EQ(sim().getWriteCount(13), before + 16);
+    EXPECT_EQ(sim().getLevel(12), 1);    // Last bit of 0xA5, already on the line
+
+    shiftIn(16, 13, MSBFIRST);
+    EXPECT_EQ(sim().getWriteCount(13), before + 32);
+    EXPECT_EQ(txn.pendingLines(), 0u);
+}
+
+TEST_F(TransactionTest, ReleasedPinIsForgotten) {
+    Transaction txn;
+    {
+        Pin out(17, PinDirection::OUTPUT);
+        out.write(true);
+        EXPECT_EQ(txn.pendingLines(), 1u);
+    }
+    EXPECT_EQ(txn.pendingLines(), 0u);
+    EXPECT_NO_THROW(txn.commit());
+}
+
+TEST_F(TransactionTest, InputsAreNotDeferred) {
+    Pin in(22, PinDirection::INPUT);
+    Transaction txn;
+    EXPECT_FALSE(in.write(true));
+    EXPECT_EQ(txn.pendingLines(), 0u);
+}
+
+TEST_F(TransactionTest, PwmAndAnalogWriteAreRecorded) {
+    Transaction txn;
+    HardwarePWM pwm(9, 0);              // Not started: refused as without a transaction
+    EXPECT_FALSE(pwm.setDutyCycle(50.0));
+    EXPECT_EQ(txn.pendingPwm(), 0u);
+
+    analogWrite(18, 100);
+    analogWrite(18, 200);
+    EXPECT_EQ(txn.pendingPwm(), 1u);
+    EXPECT_THROW(analogWrite(99, 10), InvalidPinError);
+    txn.discard();
+    EXPECT_EQ(txn.pendingPwm(), 0u);
+}
+
+TEST_F(TransactionPwmTest, ShrinkingDutyIsWrittenBeforeThePeriod) {
+    HardwarePWM pwm(0, 0, root_);
+    ASSERT_TRUE(pwm.begin(1000, 50.0));     // 1000000 ns period, 500000 ns duty
+    writes();
+    {
+        Transaction txn;
+        pwm.setFrequency(2000);
+        pwm.setDutyCycle(10.0);
+        EXPECT_EQ(txn.pendingPwm(), 1u);
+        EXPECT_TRUE(writes().empty());
+    }
+    EXPECT_EQ(writes(), (std::vector<std::string>{"enable", "duty_cycle", "period", "enable"}));
+    EXPECT_EQ(pwm.getPeriodNs(), 500000u);
+    EXPECT_EQ(pwm.getDutyCycleNs(), 50000u);
+}
+
+TEST_F(TransactionPwmTest, GrowingDutyIsWrittenAfterThePeriod) {
+    HardwarePWM pwm(0, 0, root_);
+    ASSERT_TRUE(pwm.begin(1000, 50.0));
+    writes();
+    {
+        Transaction txn;
+        pwm.setDutyCycle(75.0);         // Order of the calls does not matter
+        pwm.setFrequency(500);
+    }
+    EXPECT_EQ(writes(), (std::vector<std::string>{"enable", "period", "duty_cycle", "enable"}));
+    EXPECT_EQ(pwm.getPeriodNs(), 2000000u);
+    EXPECT_EQ(pwm.getDutyCycleNs(), 1500000u);
+}
+
+TEST_F(TransactionPwmTest, UnchangedValuesAreNotWritten) {
+    HardwarePWM pwm(0, 0, root_);
+    ASSERT_TRUE(pwm.begin(1000, 50.0));
+    Transaction txn;
+    pwm.setFrequency(2000);
+    pwm.setDutyCycle(10.0);
+    txn.commit();
+    writes();
+
+    pwm.setFrequency(2000);
+    pwm.setDutyCycle(10.0);
+    txn.commit();
+    EXPECT_TRUE(writes().empty());
+
+    pwm.setDutyCycle(20.0);             // Same period: the duty cycle alone
+    txn.commit();
+    EXPECT_EQ(writes(), std::vector<std::string>{"duty_cycle"});
+    EXPECT_EQ(pwm.getDutyCycleNs(), 100000u);
+}
+
+TEST_F(TransactionPwmTest, PendingDutyInNsKeepsItsPercentage) {
+    HardwarePWM pwm(0, 0, root_);
+    ASSERT_TRUE(pwm.begin(1000, 50.0));
+    {
+        Transaction txn;
+        pwm.setDutyCycleNs(250000);     // 25% of the current period
+        pwm.setFrequency(2000);         // Still 25%, of the new period
+    }
+    EXPECT_EQ(pwm.getPeriodNs(), 500000u);
+    EXPECT_EQ(pwm.getDutyCycleNs(), 125000u);
+}
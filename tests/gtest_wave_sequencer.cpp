@@ -0,0 +1,141 @@
+/**
+ * @file gtest_wave_sequencer.cpp
+ * @brief GoogleTest unit tests for wave compilation and playback
+ *
+ * Tests step merging, delay splitting, pin masks and durations without
+ * hardware, argument validation of WaveSequencer, and playback on real
+ * outputs when GPIO is available (skipped otherwise).
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "wave_sequencer.hpp"
+#include "exceptions.hpp"
+#include "pio.hpp"
+#include <limits>
+
+using namespace pipinpp;
+
+TEST(WaveTest, WritesWithoutDelayShareAStep) {
+    Wave wave;
+    wave.write(17, true).write(27, true).write(27, false).delay(2000)
+        .set(1u << 22).delay(500).delay(1500);
+
+    ASSERT_EQ(wave.size(), 2u);
+    EXPECT_EQ(wave.steps()[0].setMask, 1u << 17);
+    EXPECT_EQ(wave.steps()[0].clearMask, 1u << 27);       // Last write to a pin wins
+    EXPECT_EQ(wave.steps()[0].delayNs, 2000u);
+    EXPECT_EQ(wave.steps()[1].setMask, 1u << 22);
+    EXPECT_EQ(wave.steps()[1].delayNs, 2000u);            // Consecutive delays add up
+    EXPECT_EQ(wave.pinMask(), (1u << 17) | (1u << 22) | (1u << 27));
+    EXPECT_EQ(wave.durationNs(), 4000u);
+}
+
+TEST(WaveTest, LeadingAndLongDelays) {
+    Wave wave;
+    const uint64_t longNs = static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) + 10;
+    wave.delay(100).write(4, true).delay(longNs);
+
+    ASSERT_EQ(wave.size(), 3u);
+    EXPECT_EQ(wave.steps()[0].setMask | wave.steps()[0].clearMask, 0u);
+    EXPECT_EQ(wave.steps()[0].delayNs, 100u);
+    EXPECT_EQ(wave.steps()[1].delayNs, std::numeric_limits<uint32_t>::max());
+    EXPECT_EQ(wave.steps()[2].setMask | wave.steps()[2].clearMask, 0u);
+    EXPECT_EQ(wave.steps()[2].delayNs, 10u);
+    EXPECT_EQ(wave.durationNs(), 100 + longNs);
+}
+
+TEST(WaveTest, AppendMatchesBuildingInPlace) {
+    Wave bit;
+    bit.write(5, true).delay(300).write(5, false).delay(700);
+
+    Wave twice;
+    twice.append(bit).append(bit);
+    ASSERT_EQ(twice.size(), 4u);
+    EXPECT_EQ(twice.durationNs(), 2000u);
+    EXPECT_EQ(twice.steps()[2].setMask, 1u << 5);
+
+    Wave raw;
+    raw.add({1u << 5, 0, 300}).add({0, 1u << 5, 0}).add({0, 0, 700});
+    ASSERT_EQ(raw.size(), 2u);
+    EXPECT_EQ(raw.steps()[1].clearMask, 1u << 5);
+    EXPECT_EQ(raw.steps()[1].delayNs, 700u);
+}
+
+TEST(WaveTest, RejectsPinsOutsideBankZero) {
+    Wave wave;
+    EXPECT_THROW(wave.write(28, true), InvalidPinError);
+    EXPECT_THROW(wave.write(-1, false), InvalidPinError);
+    EXPECT_THROW(wave.set(1u << 30), InvalidPinError);
+    EXPECT_TRUE(wave.empty());
+}
+
+TEST(WaveSequencerTest, RejectsInvalidPins) {
+    EXPECT_THROW(WaveSequencer(std::vector<int>{}), InvalidPinError);
+    EXPECT_THROW(WaveSequencer({17, 28}), InvalidPinError);
+    EXPECT_THROW(WaveSequencer({-3}), InvalidPinError);
+}
+
+TEST(WaveSequencerTest, PlaysAndReplaysCachedWave) {
+    try {
+        WaveSequencer sequencer({17, 27});
+        EXPECT_EQ(sequencer.getPinMask(), (1u << 17) | (1u << 27));
+
+        auto wave = std::make_shared<Wave>();
+        wave->write(17, true).write(27, false).delay(20000)
+             .write(17, false).write(27, true).delay(80000);
+
+        ASSERT_TRUE(sequencer.play(wave, 5));
+        EXPECT_TRUE(sequencer.wait(2000));
+        EXPECT_FALSE(sequencer.isPlaying());
+        if (sequencer.getBackend() != WaveBackend::DMA) {
+            WaveStats stats = sequencer.getStats();
+            EXPECT_EQ(stats.passes, 5u);
+            EXPECT_EQ(stats.steps, 10u);
+        }
+
+        ASSERT_TRUE(sequencer.play(wave, 0));                 // Same wave, forever
+        EXPECT_TRUE(sequencer.isPlaying());
+        EXPECT_FALSE(sequencer.wait(20));
+        sequencer.stop();
+        EXPECT_FALSE(sequencer.isPlaying());
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
+
+TEST(WaveSequencerTest, AutoPrefersPio) {
+    try {
+        WaveSequencer sequencer({17, 27}, WaveBackend::AUTO);
+        if (PioStateMachine::isSupported()) {
+            EXPECT_EQ(sequencer.getBackend(), WaveBackend::PIO);
+        } else {
+            EXPECT_NE(sequencer.getBackend(), WaveBackend::PIO);
+            EXPECT_NE(sequencer.getBackend(), WaveBackend::AUTO);
+        }
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
+
+TEST(WaveSequencerTest, RefusesUnplayableWaves) {
+    try {
+        WaveSequencer sequencer({17});
+        auto foreign = std::make_shared<Wave>();
+        foreign->write(18, true).delay(1000);
+        EXPECT_FALSE(sequencer.play(foreign));
+
+        auto instant = std::make_shared<Wave>();
+        instant->write(17, true);
+        EXPECT_FALSE(sequencer.play(instant, 0));           // Would never yield
+        EXPECT_TRUE(sequencer.play(instant, 1));
+        EXPECT_TRUE(sequencer.wait(1000));
+
+        EXPECT_FALSE(sequencer.play(std::make_shared<Wave>()));
+        EXPECT_FALSE(sequencer.play(nullptr));
+    } catch (const GpioAccessError& e) {
+        GTEST_SKIP() << "GPIO access not available: " << e.what();
+    }
+}
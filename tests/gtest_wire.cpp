@@ -41,6 +41,7 @@
 
 #include <Wire.hpp>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <thread>
 #include <vector>
 #include <chrono>
@@ -287,6 +288,162 @@ TEST_F(WireTest, WriteRegisterHandlesInvalidDevice) {
     EXPECT_FALSE(result);
 }
 
+TEST_F(WireTest, ReadRegistersRejectsInvalidArguments) {
+    uint8_t buffer[4];
+    
+    // Argument checks happen before any bus access
+    EXPECT_EQ(Wire.readRegisters(0x68, 0x3B, nullptr, 4), -1);
+    EXPECT_EQ(Wire.readRegisters(0x68, 0x3B, buffer, 0), -1);
+}
+
+TEST_F(WireTest, WriteRegistersRejectsInvalidArguments) {
+    uint8_t data[256] = {0};
+    
+    EXPECT_FALSE(Wire.writeRegisters(0x68, 0x1B, nullptr, 2));
+    EXPECT_FALSE(Wire.writeRegisters(0x68, 0x1B, data, 0));
+    EXPECT_FALSE(Wire.writeRegisters(0x68, 0x1B, data, sizeof(data)));  // No room for reg
+}
+
+TEST_F(WireTest, RegisterAccessFailsWhenNotInitialized) {
+    Wire.end();
+    uint8_t buffer[2];
+    
+    EXPECT_EQ(Wire.readRegisters(0x68, 0x3B, buffer, 2), -1);
+    EXPECT_FALSE(Wire.writeRegisters(0x68, 0x1B, buffer, 2));
+}
+
+TEST_F(WireTest, RepeatedStartReadHandlesInvalidDevice) {
+    if (!hardwareAvailable) {
+        GTEST_SKIP() << "I2C hardware not available";
+    }
+    
+    Wire.begin();
+    
+    // Deferred write + read goes out as one combined transaction
+    Wire.beginTransmission(0x00);
+    Wire.write(0x00);
+    Wire.endTransmission(false);
+    EXPECT_EQ(Wire.requestFrom(0x00, 2, true), 0u);
+    EXPECT_EQ(Wire.available(), 0u);
+    
+    uint8_t buffer[2];
+    EXPECT_EQ(Wire.readRegisters(0x00, 0x00, buffer, 2), -1);
+}
+
+TEST_F(WireTest, BatchCountsOperationsAndMessages) {
+    uint8_t accel[6];
+    uint8_t value = 0;
+    uint8_t config[2] = {0x00, 0x18};
+    WireBatch batch;
+    
+    EXPECT_EQ(batch.readRegisters(0x68, 0x3B, accel, 6), 0);
+    EXPECT_EQ(batch.writeRegisters(0x68, 0x1B, config, 2), 1);
+    EXPECT_EQ(batch.readRegister(0x48, 0x00, &value), 2);
+    EXPECT_EQ(batch.read(0x50, accel, 2), 3);
+    
+    EXPECT_EQ(batch.size(), 4u);
+    EXPECT_EQ(batch.messageCount(), 6u);  // Register reads take two messages
+    EXPECT_EQ(batch.status(0), -1);       // Not transferred yet
+    EXPECT_FALSE(batch.ok(0));
+    
+    batch.clear();
+    EXPECT_EQ(batch.size(), 0u);
+    EXPECT_EQ(batch.messageCount(), 0u);
+}
+
+TEST_F(WireTest, BatchRejectsInvalidOperations) {
+    uint8_t buffer[4];
+    WireBatch batch;
+    
+    EXPECT_EQ(batch.readRegisters(0x68, 0x3B, nullptr, 4), -1);
+    EXPECT_EQ(batch.readRegisters(0x68, 0x3B, buffer, 0), -1);
+    EXPECT_EQ(batch.write(0x68, nullptr, 2), -1);
+    EXPECT_EQ(batch.read(0x68, buffer, 70000), -1);  // Beyond i2c_msg length
+    EXPECT_EQ(batch.size(), 0u);
+    EXPECT_EQ(batch.status(5), -1);
+}
+
+TEST_F(WireTest, BatchTransferFailsWhenNotInitialized) {
+    Wire.end();
+    uint8_t buffer[2];
+    WireBatch batch;
+    batch.readRegisters(0x68, 0x3B, buffer, 2);
+    batch.writeRegister(0x68, 0x6B, 0x00);
+    
+    EXPECT_EQ(Wire.transfer(batch), 0u);
+    EXPECT_FALSE(batch.ok(0));
+    EXPECT_GT(batch.status(1), 0);
+}
+
+TEST_F(WireTest, BatchTransferSplitsAtMessageLimit) {
+    if (!hardwareAvailable) {
+        GTEST_SKIP() << "I2C hardware not available";
+    }
+    
+    Wire.begin();
+    
+    // 30 register reads = 60 messages, more than one ioctl can carry
+    uint8_t buffers[30][2];
+    WireBatch batch;
+    for (auto& buffer : buffers) {
+        batch.readRegisters(0x00, 0x00, buffer, 2);
+    }
+    EXPECT_GT(batch.messageCount(), WIRE_BATCH_MAX_MESSAGES);
+    
+    // Reserved address: nothing ACKs, every operation reports an error
+    EXPECT_EQ(Wire.transfer(batch), 0u);
+    for (size_t i = 0; i < batch.size(); i++) {
+        EXPECT_GT(batch.status(i), 0);
+    }
+}
+
+TEST_F(WireTest, SmbusBlockRejectsInvalidLengths) {
+    uint8_t buffer[WireClass::SMBUS_BLOCK_MAX + 1] = {0};
+    
+    EXPECT_EQ(Wire.smbusReadI2cBlockData(0x68, 0x3B, nullptr, 6), -1);
+    EXPECT_EQ(Wire.smbusReadI2cBlockData(0x68, 0x3B, buffer, 0), -1);
+    EXPECT_EQ(Wire.smbusReadI2cBlockData(0x68, 0x3B, buffer, sizeof(buffer)), -1);
+    EXPECT_FALSE(Wire.smbusWriteI2cBlockData(0x68, 0x1B, buffer, sizeof(buffer)));
+}
+
+TEST_F(WireTest, SmbusFailsWhenNotInitialized) {
+    Wire.end();
+    
+    EXPECT_EQ(Wire.smbusReadByteData(0x68, 0x75), -1);
+    EXPECT_EQ(Wire.smbusReadWordData(0x68, 0x3B), -1);
+    EXPECT_FALSE(Wire.smbusWriteByteData(0x68, 0x6B, 0x00));
+    EXPECT_FALSE(Wire.smbusWriteWordData(0x68, 0x6B, 0x0000));
+}
+
+TEST_F(WireTest, SmbusHandlesInvalidDevice) {
+    if (!hardwareAvailable) {
+        GTEST_SKIP() << "I2C hardware not available";
+    }
+    
+    Wire.begin();
+    
+    // Same address twice exercises the cached I2C_SLAVE path
+    EXPECT_EQ(Wire.smbusReadByteData(0x00, 0x00), -1);
+    EXPECT_EQ(Wire.smbusReadByteData(0x00, 0x01), -1);
+    EXPECT_FALSE(Wire.smbusWriteByteData(0x00, 0x00, 0xFF));
+}
+
+TEST_F(WireTest, ProbeFailsWhenNotInitialized) {
+    Wire.end();
+    EXPECT_FALSE(Wire.probe(0x68));
+    EXPECT_FALSE(Wire.probe(0x50, I2cProbeMode::READ_BYTE));
+    EXPECT_FALSE(Wire.exists(0x68));
+    EXPECT_EQ(Wire.getBusNumber(), -1);
+}
+
+TEST_F(WireTest, AvailableBusesAreSorted) {
+    std::vector<int> buses = WireClass::availableBuses();
+    EXPECT_TRUE(std::is_sorted(buses.begin(), buses.end()));
+    for (int bus : buses) {
+        EXPECT_GE(bus, 0);
+    }
+}
+
 // ============================================================================
 // Error Handling Tests
 // ============================================================================
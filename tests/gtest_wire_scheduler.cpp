@@ -0,0 +1,156 @@
+/**
+ * @file gtest_wire_scheduler.cpp
+ * @brief GoogleTest unit tests for background I2C register polling
+ *
+ * Tests poll bookkeeping, deadline chaining and snapshot publishing. The
+ * scheduler is run against an un-begun Wire bus, so every poll publishes an
+ * error snapshot and no I2C hardware is required.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <gtest/gtest.h>
+#include "wire_scheduler.hpp"
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+using namespace pipinpp;
+
+namespace {
+
+// Wait until a poll has published at least @p count snapshots
+bool waitForSequence(const WireScheduler& scheduler, int id, uint64_t count, WireSnapshot& snap) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (scheduler.latest(id, snap) && snap.sequence >= count) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+} // namespace
+
+class WireSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Wire.end();
+    }
+};
+
+// ============================================================================
+// Deadline Tests
+// ============================================================================
+
+TEST_F(WireSchedulerTest, NextDeadlineAdvancesByOnePeriod) {
+    EXPECT_EQ(WireScheduler::nextDeadline(1000, 500, 1000), 1500);
+    EXPECT_EQ(WireScheduler::nextDeadline(1000, 500, 1700), 1500);  // Late, still in phase
+}
+
+TEST_F(WireSchedulerTest, NextDeadlineSkipsMissedPeriods) {
+    // Three periods late: no back-to-back catch-up polls
+    EXPECT_EQ(WireScheduler::nextDeadline(1000, 500, 3000), 3500);
+}
+
+// ============================================================================
+// Poll Management Tests
+// ============================================================================
+
+TEST_F(WireSchedulerTest, AddPollValidatesArguments) {
+    WireScheduler scheduler;
+    EXPECT_EQ(scheduler.addPoll(0x68, 0x3B, 0, 1000), -1);
+    EXPECT_EQ(scheduler.addPoll(0x68, 0x3B, WIRE_SNAPSHOT_MAX_BYTES + 1, 1000), -1);
+    EXPECT_EQ(scheduler.addPoll(0x68, 0x3B, 6, WIRE_SCHEDULER_MIN_PERIOD_US - 1), -1);
+    EXPECT_EQ(scheduler.getPollCount(), 0u);
+}
+
+TEST_F(WireSchedulerTest, AddPollFailsWhenFull) {
+    WireScheduler scheduler;
+    for (size_t i = 0; i < WIRE_SCHEDULER_MAX_POLLS; ++i) {
+        EXPECT_EQ(scheduler.addPoll(0x68, static_cast<uint8_t>(i), 1, 1000), static_cast<int>(i));
+    }
+    EXPECT_EQ(scheduler.addPoll(0x68, 0x00, 1, 1000), -1);
+    EXPECT_EQ(scheduler.getPollCount(), WIRE_SCHEDULER_MAX_POLLS);
+}
+
+TEST_F(WireSchedulerTest, RemovePollFreesSlot) {
+    WireScheduler scheduler;
+    int id = scheduler.addPoll(0x68, 0x3B, 6, 1000);
+    ASSERT_GE(id, 0);
+
+    EXPECT_TRUE(scheduler.removePoll(id));
+    EXPECT_FALSE(scheduler.removePoll(id));
+    EXPECT_FALSE(scheduler.removePoll(-1));
+    EXPECT_EQ(scheduler.getPollCount(), 0u);
+    EXPECT_EQ(scheduler.addPoll(0x48, 0x00, 2, 1000), id);
+}
+
+TEST_F(WireSchedulerTest, LatestFalseBeforeFirstPoll) {
+    WireScheduler scheduler;
+    int id = scheduler.addPoll(0x68, 0x3B, 6, 1000);
+    WireSnapshot snap;
+    EXPECT_FALSE(scheduler.latest(id, snap));  // Not started
+    EXPECT_FALSE(scheduler.latest(99, snap));
+}
+
+// ============================================================================
+// Polling Thread Tests
+// ============================================================================
+
+TEST_F(WireSchedulerTest, StartStopIdempotent) {
+    WireScheduler scheduler;
+    EXPECT_TRUE(scheduler.start());
+    EXPECT_TRUE(scheduler.start());
+    EXPECT_TRUE(scheduler.isRunning());
+    scheduler.stop();
+    scheduler.stop();
+    EXPECT_FALSE(scheduler.isRunning());
+}
+
+TEST_F(WireSchedulerTest, PublishesErrorSnapshotsWithoutBus) {
+    WireScheduler scheduler;
+    int id = scheduler.addPoll(0x68, 0x3B, 6, 1000);
+    ASSERT_TRUE(scheduler.start());
+
+    WireSnapshot snap;
+    ASSERT_TRUE(waitForSequence(scheduler, id, 3, snap));
+    EXPECT_FALSE(snap.ok());
+    EXPECT_EQ(snap.status, ENODEV);
+    EXPECT_EQ(snap.length, 6u);
+    EXPECT_GE(snap.consecutiveErrors, 3u);
+    EXPECT_GT(snap.timestampNs, 0);
+
+    scheduler.stop();
+}
+
+TEST_F(WireSchedulerTest, PollAddedWhileRunningIsPolled) {
+    WireScheduler scheduler;
+    ASSERT_TRUE(scheduler.start());
+
+    int id = scheduler.addPoll(0x48, 0x00, 2, 1000);
+    WireSnapshot snap;
+    EXPECT_TRUE(waitForSequence(scheduler, id, 1, snap));
+
+    scheduler.removePoll(id);
+    EXPECT_FALSE(scheduler.latest(id, snap));
+    scheduler.stop();
+}
+
+TEST_F(WireSchedulerTest, SlowPollRunsLessOften) {
+    WireScheduler scheduler;
+    int fast = scheduler.addPoll(0x68, 0x3B, 6, 1000);      // 1 kHz
+    int slow = scheduler.addPoll(0x48, 0x00, 2, 200000);    // 5 Hz
+    ASSERT_TRUE(scheduler.start());
+
+    WireSnapshot fastSnap;
+    ASSERT_TRUE(waitForSequence(scheduler, fast, 50, fastSnap));
+
+    WireSnapshot slowSnap;
+    ASSERT_TRUE(scheduler.latest(slow, slowSnap));
+    EXPECT_LT(slowSnap.sequence, fastSnap.sequence);
+
+    scheduler.stop();
+}
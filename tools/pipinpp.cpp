@@ -13,31 +13,54 @@
  *   pipinpp pwm <pin> <value> - Set PWM duty cycle (0-255)
  *   pipinpp toggle <pin>      - Toggle pin state
  *   pipinpp blink <pin> <ms>  - Blink pin at interval
- *   pipinpp i2c scan          - Scan I2C bus for devices
+ *   pipinpp i2c scan [all]    - Scan I2C bus(es) for devices
  *   pipinpp i2c read <addr> <reg> - Read I2C register
  *   pipinpp i2c write <addr> <reg> <val> - Write I2C register
  *   pipinpp spi test          - SPI loopback test
+ *   pipinpp bench latency|jitter|throughput - Loopback timing characterization
+ *   pipinpp tune [-- command] - Hold low-jitter CPU/IRQ settings, restore on exit
  *   pipinpp test              - Run all self-tests
  * 
  * @copyright Copyright (c) 2025 PiPinPP Project
  * @license MIT License
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <cstdlib>
+#include <cstring>
 #include <csignal>
 #include <unistd.h>
+#include <sys/wait.h>
 #include <sys/stat.h>
 #include <grp.h>
 #include <pwd.h>
 
 #include "ArduinoCompat.hpp"
 #include "Wire.hpp"
+#include "i2c_scan.hpp"
 #include "SPI.hpp"
+#include "capture.hpp"
+#include "dma_soft_pwm.hpp"
+#include "interrupts.hpp"
 #include "platform.hpp"
+#include "pwm_backend.hpp"
+#include "timebase.hpp"
+#include "timing_guard.hpp"
 
 using namespace std;
 using namespace pipinpp;
@@ -116,7 +139,7 @@ void print_usage()
 {
     cout << "Usage: pipinpp <command> [arguments]\n\n";
     cout << COLOR_BOLD << "Information Commands:\n" << COLOR_RESET;
-    cout << "  info                    Show platform and hardware details\n";
+    cout << "  info [--refresh]        Show platform and hardware details (--refresh re-detects)\n";
     cout << "  version                 Show version information\n";
     cout << "  help                    Show this help message\n\n";
     
@@ -129,7 +152,8 @@ void print_usage()
     cout << "  pwm <pin> <value>       Set PWM duty cycle (0-255)\n\n";
     
     cout << COLOR_BOLD << "I2C Commands:\n" << COLOR_RESET;
-    cout << "  i2c scan                Scan I2C bus for devices\n";
+    cout << "  i2c scan [bus...|all]   Scan I2C bus(es) for devices (buses in parallel)\n";
+    cout << "       [--cached|--refresh]  Reuse/rewrite results cached this boot\n";
     cout << "  i2c read <addr> <reg>   Read I2C register (hex)\n";
     cout << "  i2c write <addr> <reg> <val>  Write I2C register (hex)\n\n";
     
@@ -139,9 +163,21 @@ void print_usage()
     
     cout << COLOR_BOLD << "Testing Commands:\n" << COLOR_RESET;
     cout << "  test                    Run all self-tests\n";
-    cout << "  benchmark               GPIO speed benchmark\n";
-    cout << "  monitor <pin> [ms]      Monitor pin transitions (default 10 ms)\n";
-    cout << "  doctor                  Run environment diagnostics\n\n";
+    cout << "  benchmark [gpiomem]     GPIO speed benchmark (gpiomem: direct registers)\n";
+    cout << "  bench latency           Output-to-interrupt round trip (loopback wire)\n";
+    cout << "  bench jitter            PWM period jitter per backend (loopback wire)\n";
+    cout << "  bench throughput        Toggle rate per backend (libgpiod/gpiomem/dma)\n";
+    cout << "       [--out N] [--in N] [--samples N] [--freq HZ] [--seconds S]\n";
+    cout << "       [--backend NAME] [--save FILE] [--compare FILE]\n";
+    cout << "  monitor <pin,...>       Print edges with kernel timestamps (Ctrl+C stops)\n";
+    cout << "       [--vcd FILE] [--bin FILE] [--quiet]  Capture for a logic-analyser viewer\n";
+    cout << "  capture record <pin,...> <file>  Record edges into a ring file\n";
+    cout << "       [--capacity N] [--seconds S] [--stop-when-full]\n";
+    cout << "  capture convert <file> <out.vcd|out.sr> [--samplerate HZ]\n";
+    cout << "  capture info <file>     Summarize a capture\n";
+    cout << "  doctor                  Run environment diagnostics (incl. timing settings)\n";
+    cout << "  tune [-- command]       Performance governor, CPU latency limit and IRQ affinity\n";
+    cout << "       [--latency US] [--irq-cpu N] [--keep-governor]  until Ctrl+C or the command exits\n\n";
     
     cout << COLOR_BOLD << "Examples:\n" << COLOR_RESET;
     cout << "  pipinpp mode 17 out     # Set GPIO17 as output\n";
@@ -150,11 +186,17 @@ void print_usage()
     cout << "  pipinpp blink 17 1000   # Blink GPIO17 at 1 second intervals\n";
     cout << "  pipinpp pwm 18 128      # Set GPIO18 PWM to 50% duty cycle\n";
     cout << "  pipinpp i2c scan        # Scan I2C bus for devices\n";
+    cout << "  pipinpp i2c scan all --cached  # Every bus, cached for hot restarts\n";
+    cout << "  pipinpp bench latency --save rt.txt   # GPIO17 wired to GPIO27\n";
+    cout << "  sudo pipinpp tune --irq-cpu 2 -- ./benchmark_jitter\n";
 }
 
-void cmd_info() 
+void cmd_info(bool refresh) 
 {
     PlatformInfo& platform = PlatformInfo::instance();
+    if (refresh) {
+        platform.refresh();
+    }
     
     cout << COLOR_BOLD << "\nPlatform Information:\n" << COLOR_RESET;
     cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
@@ -295,41 +337,73 @@ void cmd_pwm(int pin, int value)
     }
 }
 
-void cmd_i2c_scan() 
+void print_i2c_grid(const vector<uint8_t>& devices)
+{
+    cout << "     0  1  2  3  4  5  6  7  8  9  a  b  c  d  e  f\n";
+    cout << "00:         ";
+    
+    for (int addr = 3; addr < 0x78; addr++) {
+        if (addr % 16 == 0) {
+            cout << "\n" << hex << setw(2) << setfill('0') << (addr & 0xF0) << ": ";
+        }
+        
+        if (find(devices.begin(), devices.end(), addr) != devices.end()) {
+            cout << COLOR_GREEN << setw(2) << setfill('0') << hex << addr << COLOR_RESET << " ";
+        } else {
+            cout << "-- ";
+        }
+    }
+    cout << dec << "\n\n";
+}
+
+void cmd_i2c_scan(const vector<int>& buses, bool allBuses, bool cached, bool refresh) 
 {
     try {
-        if (!Wire.begin()) {
-            cerr << COLOR_RED << "Error: Failed to initialize I2C" << COLOR_RESET << endl;
-            exit(1);
+        I2cScanOptions options;
+        options.buses = buses;
+        if (!allBuses && buses.empty()) {
+            // Same bus Wire.begin() picks
+            if (!Wire.begin()) {
+                cerr << COLOR_RED << "Error: Failed to initialize I2C" << COLOR_RESET << endl;
+                exit(1);
+            }
+            options.buses.push_back(Wire.getBusNumber());
+            Wire.end();
+        }
+        if (cached || refresh) {
+            options.cachePath = i2cScanDefaultCachePath();
+            options.refresh = refresh;
         }
         
-        cout << "Scanning I2C bus...\n";
-        cout << "     0  1  2  3  4  5  6  7  8  9  a  b  c  d  e  f\n";
-        cout << "00:         ";
+        vector<I2cBusScan> results = scanI2cBuses(options);
+        if (results.empty()) {
+            cerr << COLOR_RED << "Error: No I2C buses found" << COLOR_RESET << endl;
+            exit(1);
+        }
         
-        int count = 0;
-        for (int addr = 3; addr < 0x78; addr++) {
-            if (addr % 16 == 0) {
-                cout << "\n" << hex << setw(2) << setfill('0') << (addr & 0xF0) << ": ";
-            }
-            
-            if (Wire.exists(addr)) {
-                cout << COLOR_GREEN << setw(2) << setfill('0') << hex << addr << COLOR_RESET << " ";
-                count++;
-            } else {
-                cout << "-- ";
+        size_t count = 0;
+        bool anyOpened = false;
+        for (const auto& bus : results) {
+            cout << "Scanning I2C bus " << bus.bus << " (/dev/i2c-" << bus.bus << ")...\n";
+            if (!bus.ok) {
+                cout << COLOR_YELLOW << "  Could not open bus" << COLOR_RESET << "\n\n";
+                continue;
             }
+            anyOpened = true;
+            print_i2c_grid(bus.devices);
+            count += bus.devices.size();
         }
         
-        cout << dec << "\n\n";
+        if (!anyOpened) {
+            cerr << COLOR_RED << "Error: Failed to initialize I2C" << COLOR_RESET << endl;
+            exit(1);
+        }
         if (count > 0) {
             cout << COLOR_GREEN << "Found " << count << " device(s)" << COLOR_RESET << endl;
         } else {
             cout << COLOR_YELLOW << "No I2C devices found" << COLOR_RESET << endl;
         }
         
-        Wire.end();
-        
     } catch (const exception& e) {
         cerr << COLOR_RED << "Error: " << e.what() << COLOR_RESET << endl;
         exit(1);
@@ -376,25 +450,48 @@ void cmd_i2c_write(uint8_t addr, uint8_t reg, uint8_t value)
     }
 }
 
-void cmd_benchmark() 
+void cmd_benchmark(bool useGpiomem) 
 {
     const int TEST_PIN = 17;
     const int ITERATIONS = 100000;
     
     try {
-        pinMode(TEST_PIN, OUTPUT);
-        
         cout << "Running GPIO speed benchmark...\n";
         cout << "Pin: GPIO" << TEST_PIN << "\n";
-        cout << "Iterations: " << ITERATIONS << "\n\n";
+        cout << "Iterations: " << ITERATIONS << "\n";
+        
+        unsigned long start = 0;
+        unsigned long elapsed = 0;
         
-        // Benchmark digitalWrite
-        unsigned long start = micros();
-        for (int i = 0; i < ITERATIONS; i++) {
-            digitalWrite(TEST_PIN, HIGH);
-            digitalWrite(TEST_PIN, LOW);
+        if (useGpiomem) {
+            // Benchmark Pin::write() on the /dev/gpiomem register backend
+            Pin pin(TEST_PIN, PinDirection::OUTPUT, "gpiochip0", PinBackend::GPIOMEM);
+            if (pin.getBackend() != PinBackend::GPIOMEM) {
+                cout << COLOR_YELLOW << "Direct register access unavailable, using libgpiod" << COLOR_RESET << "\n";
+            }
+            cout << "Backend: " << (pin.getBackend() == PinBackend::GPIOMEM ? "gpiomem" : "libgpiod") << "\n\n";
+            
+            start = micros();
+            for (int i = 0; i < ITERATIONS; i++) {
+                pin.write(true);
+                pin.write(false);
+            }
+            elapsed = micros() - start;
+        } else {
+            // Benchmark digitalWrite
+            pinMode(TEST_PIN, OUTPUT);
+            cout << "Backend: digitalWrite (libgpiod)\n\n";
+            
+            start = micros();
+            for (int i = 0; i < ITERATIONS; i++) {
+                digitalWrite(TEST_PIN, HIGH);
+                digitalWrite(TEST_PIN, LOW);
+            }
+            elapsed = micros() - start;
+        }
+        if (elapsed == 0) {
+            elapsed = 1;
         }
-        unsigned long elapsed = micros() - start;
         
         double togglesPerSecond = (ITERATIONS * 2.0) / (elapsed / 1000000.0);
         double usPerToggle = elapsed / (ITERATIONS * 2.0);
@@ -410,42 +507,813 @@ void cmd_benchmark()
     }
 }
 
-void cmd_monitor(int pin, int intervalMs)
+// ============================================================================
+// monitor: edge events on many pins, optional VCD / binary capture
+// ============================================================================
+
+struct MonitorOptions
+{
+    vector<int> pins;
+    string vcdPath;             ///< Value Change Dump for GTKWave / PulseView
+    string binPath;             ///< Streamed capture file (capture.hpp format, no ring)
+    bool quiet = false;         ///< No per-edge console output
+};
+
+/**
+ * @brief Writes edges as a Value Change Dump (1 ns timescale, relative to the start)
+ */
+class VcdWriter
 {
-    if (intervalMs < 1)
+public:
+    bool open(const string& path, const vector<int>& pins, const vector<int>& levels, uint64_t startNs)
     {
-        intervalMs = 1;
+        file_.open(path);
+        if (!file_) {
+            return false;
+        }
+        startNs_ = startNs;
+        file_ << "$version PiPinPP pipinpp monitor " << VERSION << " $end\n"
+              << "$timescale 1ns $end\n"
+              << "$scope module gpio $end\n";
+        for (size_t i = 0; i < pins.size(); i++) {
+            ids_[pins[i]] = identifier(i);
+            file_ << "$var wire 1 " << ids_[pins[i]] << " gpio" << pins[i] << " $end\n";
+        }
+        file_ << "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n";
+        for (size_t i = 0; i < pins.size(); i++) {
+            file_ << levels[i] << ids_[pins[i]] << "\n";
+        }
+        file_ << "$end\n";
+        return static_cast<bool>(file_);
     }
 
-    try
+    void write(uint64_t timestampNs, int pin, bool level)
     {
-        pinMode(pin, INPUT);
-        signal(SIGINT, signal_handler);
+        const uint64_t t = timestampNs > startNs_ ? timestampNs - startNs_ : 0;
+        if (t != lastTime_) {
+            file_ << "#" << t << "\n";
+            lastTime_ = t;
+        }
+        file_ << (level ? '1' : '0') << ids_[pin] << "\n";
+    }
 
-        int lastValue = digitalRead(pin);
-        unsigned long lastChange = millis();
+private:
+    /// Short printable VCD identifiers: "!", "\"", ... then two characters
+    static string identifier(size_t index)
+    {
+        string id;
+        do {
+            id += static_cast<char>('!' + index % 94);
+            index /= 94;
+        } while (index > 0);
+        return id;
+    }
 
-        cout << "Monitoring GPIO" << pin << " (interval " << intervalMs << " ms). Press Ctrl+C to stop." << endl;
-        cout << "Initial state: " << lastValue << endl;
+    ofstream file_;
+    std::map<int, string> ids_;
+    uint64_t startNs_ = 0;
+    uint64_t lastTime_ = 0;
+};
 
-        while (running)
-        {
-            int value = digitalRead(pin);
-            if (value != lastValue)
+string format_duration(uint64_t ns)
+{
+    ostringstream out;
+    out << fixed << setprecision(3);
+    if (ns < 1000) {
+        out << ns << " ns";
+    } else if (ns < 1000000) {
+        out << ns / 1e3 << " us";
+    } else if (ns < 1000000000) {
+        out << ns / 1e6 << " ms";
+    } else {
+        out << ns / 1e9 << " s";
+    }
+    return out.str();
+}
+
+vector<int> parse_pin_list(const string& text)
+{
+    vector<int> pins;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        char* end = nullptr;
+        long pin = strtol(item.c_str(), &end, 10);
+        if (*end != '\0' || pin < 0 || pin > 255) {
+            throw invalid_argument("Invalid pin '" + item + "' in " + text);
+        }
+        if (find(pins.begin(), pins.end(), static_cast<int>(pin)) == pins.end()) {
+            pins.push_back(static_cast<int>(pin));
+        }
+    }
+    if (pins.empty()) {
+        throw invalid_argument("No pins given");
+    }
+    return pins;
+}
+
+/**
+ * @brief Print (and capture) every edge on the given pins until Ctrl+C
+ *
+ * Edges come from the kernel with nanosecond timestamps, so pulses of any
+ * width are seen and the process sleeps between edges. All pins share one
+ * line request, keeping edges on different pins in kernel order.
+ */
+void cmd_monitor(const MonitorOptions& opt)
+{
+    signal(SIGINT, signal_handler);
+
+    // Starting levels, read before the interrupt request takes the lines
+    vector<int> levels;
+    for (int pin : opt.pins) {
+        Pin probe(pin, PinDirection::INPUT);
+        levels.push_back(probe.read() > 0 ? 1 : 0);
+    }
+    const uint64_t startNs = static_cast<uint64_t>(monotonicNowNs());
+
+    VcdWriter vcd;
+    if (!opt.vcdPath.empty() && !vcd.open(opt.vcdPath, opt.pins, levels, startNs)) {
+        throw runtime_error("Cannot write " + opt.vcdPath);
+    }
+    ofstream bin;
+    CaptureHeader binHeader{};
+    if (!opt.binPath.empty()) {
+        bin.open(opt.binPath, ios::binary);
+        if (!bin) {
+            throw runtime_error("Cannot write " + opt.binPath);
+        }
+        initCaptureHeader(binHeader, opt.pins, levels, startNs, 0);
+        const vector<char> page(CAPTURE_HEADER_SIZE, 0);
+        bin.write(page.data(), static_cast<streamsize>(page.size()));
+    }
+
+    // Monitor thread -> this thread
+    std::mutex mutex;
+    condition_variable ready;
+    vector<EdgeEvent> pending;
+    vector<EdgeEvent> drained;
+
+    auto& interrupts = InterruptManager::getInstance();
+    const bool merged = interrupts.getMergeRequests();
+    interrupts.setMergeRequests(true);
+    for (int pin : opt.pins) {
+        interrupts.attachInterruptBatch(pin, [&](EdgeEventSpan events) {
             {
-                unsigned long now = millis();
-                cout << "[" << now << " ms] " << lastValue << " -> " << value
-                     << " (Δ" << (now - lastChange) << " ms)" << endl;
-                lastValue = value;
-                lastChange = now;
+                lock_guard<std::mutex> lock(mutex);
+                pending.insert(pending.end(), events.begin(), events.end());
             }
-            delay(intervalMs);
+            ready.notify_one();
+        }, InterruptMode::CHANGE, 256);
+    }
+    interrupts.setMergeRequests(merged);
+
+    cout << "Monitoring GPIO";
+    for (size_t i = 0; i < opt.pins.size(); i++) {
+        cout << (i ? "," : "") << opt.pins[i];
+    }
+    cout << " (initial";
+    for (size_t i = 0; i < opt.pins.size(); i++) {
+        cout << " " << opt.pins[i] << "=" << levels[i];
+    }
+    cout << "). Press Ctrl+C to stop." << endl;
+
+    std::map<int, uint64_t> lastEdgeNs;
+    std::map<int, unsigned long> lastSeqno;
+    uint64_t edges = 0;
+    uint64_t lost = 0;
+    while (running) {
+        {
+            unique_lock<std::mutex> lock(mutex);
+            // Wakes for edges; the timeout only notices Ctrl+C
+            ready.wait_for(lock, chrono::milliseconds(200), [&] { return !pending.empty(); });
+            drained.swap(pending);
         }
+        stable_sort(drained.begin(), drained.end(),
+                    [](const EdgeEvent& a, const EdgeEvent& b) { return a.timestampNs < b.timestampNs; });
+
+        for (const EdgeEvent& e : drained) {
+            const bool rising = e.type == EdgeType::RISING;
+            edges++;
+            unsigned long& seqno = lastSeqno[e.pin];
+            const unsigned long skipped = (seqno != 0 && e.lineSeqno > seqno + 1) ? e.lineSeqno - seqno - 1 : 0;
+            seqno = e.lineSeqno;
+            lost += skipped;
+
+            if (!opt.quiet) {
+                const double t = static_cast<double>(e.timestampNs - startNs) / 1e9;
+                cout << "[" << fixed << setprecision(9) << setw(14) << t << " s] GPIO" << left << setw(3) << e.pin
+                     << right << (rising ? " ↑ 1" : " ↓ 0");
+                auto previous = lastEdgeNs.find(e.pin);
+                if (previous != lastEdgeNs.end()) {
+                    cout << "  Δ" << format_duration(e.timestampNs - previous->second);
+                }
+                if (skipped) {
+                    cout << COLOR_YELLOW << "  (" << skipped << " edges lost)" << COLOR_RESET;
+                }
+                cout << "\n";
+            }
+            lastEdgeNs[e.pin] = e.timestampNs;
+
+            if (!opt.vcdPath.empty()) {
+                vcd.write(e.timestampNs, e.pin, rising);
+            }
+            if (bin.is_open()) {
+                CaptureRecord record{e.timestampNs, static_cast<uint32_t>(e.lineSeqno),
+                                     static_cast<uint8_t>(e.pin), static_cast<uint8_t>(rising), 0};
+                bin.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            }
+        }
+        drained.clear();
+        cout << flush;
     }
-    catch (const exception& e)
-    {
-        cerr << COLOR_RED << "Error: " << e.what() << COLOR_RESET << endl;
-        exit(1);
+
+    for (int pin : opt.pins) {
+        interrupts.detachInterrupt(pin);
+    }
+    cout << "\n" << edges << " edges";
+    if (lost) {
+        cout << COLOR_YELLOW << ", " << lost << " lost (kernel buffer overflow)" << COLOR_RESET;
+    }
+    cout << "\n";
+    if (!opt.vcdPath.empty()) {
+        cout << "VCD written to " << opt.vcdPath << "\n";
+    }
+    if (bin.is_open()) {
+        // Counts and stop time are only known now; a killed monitor leaves
+        // them zero and readers fall back to the file size
+        binHeader.recordCount = edges;
+        binHeader.lostCount = lost;
+        binHeader.stopNs = static_cast<uint64_t>(monotonicNowNs());
+        bin.seekp(0);
+        bin.write(reinterpret_cast<const char*>(&binHeader), sizeof(binHeader));
+        bin.close();
+        cout << "Capture written to " << opt.binPath << " (pipinpp capture convert turns it into VCD/sigrok)\n";
+    }
+}
+
+// ============================================================================
+// capture: long recordings into a memory-mapped ring file, and conversion
+// ============================================================================
+
+struct CaptureCliOptions
+{
+    CaptureOptions session;
+    double seconds = 0;         ///< Stop after this long, 0 = until Ctrl+C
+};
+
+/**
+ * @brief Record edges into a ring file until Ctrl+C, the time limit, or full
+ *
+ * Nothing is printed per edge, so this keeps up with far higher rates than
+ * monitor; progress is shown once a second.
+ */
+void cmd_capture_record(const CaptureCliOptions& opt)
+{
+    signal(SIGINT, signal_handler);
+    CaptureSession capture;
+    if (!capture.start(opt.session)) {
+        throw runtime_error("Cannot start capture to " + opt.session.path);
+    }
+    cout << "Capturing GPIO";
+    for (size_t i = 0; i < opt.session.pins.size(); i++) {
+        cout << (i ? "," : "") << opt.session.pins[i];
+    }
+    cout << " to " << opt.session.path << " (" << opt.session.capacity << " records, "
+         << (opt.session.stopWhenFull ? "stops when full" : "keeps the newest") << "). Press Ctrl+C to stop." << endl;
+
+    const auto start = chrono::steady_clock::now();
+    auto nextReport = start + chrono::seconds(1);
+    uint64_t lastCount = 0;
+    while (running) {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        const auto now = chrono::steady_clock::now();
+        const double elapsed = chrono::duration<double>(now - start).count();
+        if (opt.seconds > 0 && elapsed >= opt.seconds) {
+            break;
+        }
+        if (opt.session.stopWhenFull && capture.getRecordCount() >= opt.session.capacity) {
+            cout << "\nCapture full.";
+            break;
+        }
+        if (now >= nextReport) {
+            const uint64_t count = capture.getRecordCount();
+            cout << "\r  " << fixed << setprecision(0) << elapsed << " s  " << count << " edges ("
+                 << count - lastCount << "/s), " << capture.getLostCount() << " lost    " << flush;
+            lastCount = count;
+            nextReport += chrono::seconds(1);
+        }
+    }
+    const uint64_t count = capture.getRecordCount();
+    const uint64_t lost = capture.getLostCount();
+    capture.stop();
+
+    cout << "\n" << count << " edges";
+    if (count > opt.session.capacity && !opt.session.stopWhenFull) {
+        cout << " (newest " << opt.session.capacity << " kept)";
+    }
+    if (lost) {
+        cout << COLOR_YELLOW << ", " << lost << " lost" << COLOR_RESET;
+    }
+    cout << "\nCapture written to " << opt.session.path << "\n";
+}
+
+void cmd_capture_info(const string& path)
+{
+    CaptureData data;
+    if (!readCapture(path, data)) {
+        throw runtime_error("Cannot read capture " + path);
+    }
+    std::map<int, uint64_t> perPin;
+    for (const CaptureRecord& r : data.records) {
+        perPin[r.pin]++;
+    }
+    const uint64_t endNs = data.stopNs ? data.stopNs
+                                       : (data.records.empty() ? data.startNs : data.records.back().timestampNs);
+
+    cout << COLOR_BOLD << "Capture " << path << COLOR_RESET << "\n";
+    cout << "  Edges:     " << data.records.size() << (data.wrapped ? " (ring wrapped, oldest overwritten)" : "") << "\n";
+    cout << "  Lost:      " << data.lostCount << "\n";
+    cout << "  Duration:  " << format_duration(endNs > data.startNs ? endNs - data.startNs : 0)
+         << (data.stopNs ? "" : " (not stopped cleanly)") << "\n";
+    cout << "  Pins:\n";
+    for (size_t i = 0; i < data.pins.size(); i++) {
+        cout << "    GPIO" << left << setw(4) << data.pins[i] << right << " start=" << data.initialLevels[i]
+             << "  edges=" << perPin[data.pins[i]] << "\n";
+    }
+}
+
+/**
+ * @brief Convert a capture (ring or monitor --bin) to .vcd or .sr by extension
+ */
+void cmd_capture_convert(const string& input, const string& output, uint64_t sampleRateHz)
+{
+    CaptureData data;
+    if (!readCapture(input, data)) {
+        throw runtime_error("Cannot read capture " + input);
+    }
+    auto endsWith = [&](const string& suffix) {
+        return output.size() >= suffix.size() && output.compare(output.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    bool ok = false;
+    if (endsWith(".vcd")) {
+        ok = writeVcd(data, output);
+    } else if (endsWith(".sr")) {
+        ok = writeSigrok(data, output, sampleRateHz);
+    } else {
+        throw invalid_argument("Output must end in .vcd (GTKWave) or .sr (sigrok/PulseView)");
+    }
+    if (!ok) {
+        throw runtime_error("Cannot write " + output);
+    }
+    cout << data.records.size() << " edges on " << data.pins.size() << " pins written to " << output << "\n";
+    if (data.lostCount) {
+        cout << COLOR_YELLOW << "Note: " << data.lostCount << " edges were lost during capture" << COLOR_RESET << "\n";
+    }
+}
+
+// ============================================================================
+// bench: loopback latency, PWM jitter and toggle rate
+// ============================================================================
+
+struct BenchOptions
+{
+    int outPin = 17;            ///< Driven pin
+    int inPin = 27;             ///< Pin wired to outPin
+    int samples = 1000;         ///< Round trips / PWM periods to record
+    int frequencyHz = 1000;     ///< PWM frequency for jitter
+    double seconds = 1.0;       ///< Duration of each throughput run
+    string backend;             ///< Restrict jitter/throughput to one backend
+    string savePath;            ///< Write results as a baseline
+    string comparePath;         ///< Compare results with a saved baseline
+};
+
+/**
+ * @brief Distribution of nanosecond samples (nearest-rank percentiles)
+ */
+struct SampleSummary
+{
+    size_t count = 0;
+    int64_t min = 0;
+    int64_t p50 = 0;
+    int64_t p99 = 0;
+    int64_t p999 = 0;
+    int64_t max = 0;
+    double mean = 0.0;
+};
+
+/// Metric name -> value, in report order (saved as a baseline)
+using BenchResults = vector<pair<string, double>>;
+
+SampleSummary summarize(vector<int64_t> samples)
+{
+    SampleSummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+    sort(samples.begin(), samples.end());
+    auto rank = [&samples](double q) {
+        size_t index = static_cast<size_t>(q * static_cast<double>(samples.size()));
+        return samples[min(index, samples.size() - 1)];
+    };
+    double sum = 0.0;
+    for (int64_t v : samples) {
+        sum += static_cast<double>(v);
+    }
+    summary.count = samples.size();
+    summary.min = samples.front();
+    summary.p50 = rank(0.5);
+    summary.p99 = rank(0.99);
+    summary.p999 = rank(0.999);
+    summary.max = samples.back();
+    summary.mean = sum / static_cast<double>(samples.size());
+    return summary;
+}
+
+void print_summary_header()
+{
+    cout << COLOR_BOLD << left << setw(34) << "" << right
+         << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "p99.9" << setw(10) << "max"
+         << setw(10) << "mean" << setw(9) << "n" << COLOR_RESET << "\n";
+}
+
+void print_summary(const string& label, const SampleSummary& s)
+{
+    auto us = [](double ns) {
+        ostringstream out;
+        out << fixed << setprecision(2) << ns / 1000.0;
+        return out.str();
+    };
+    cout << left << setw(34) << (label + " (us)") << right
+         << setw(10) << us(static_cast<double>(s.p50)) << setw(10) << us(static_cast<double>(s.p99))
+         << setw(10) << us(static_cast<double>(s.p999)) << setw(10) << us(static_cast<double>(s.max))
+         << setw(10) << us(s.mean) << setw(9) << s.count << "\n";
+}
+
+void add_summary(BenchResults& results, const string& prefix, const SampleSummary& s)
+{
+    results.emplace_back(prefix + ".p50_ns", static_cast<double>(s.p50));
+    results.emplace_back(prefix + ".p99_ns", static_cast<double>(s.p99));
+    results.emplace_back(prefix + ".p999_ns", static_cast<double>(s.p999));
+    results.emplace_back(prefix + ".max_ns", static_cast<double>(s.max));
+    results.emplace_back(prefix + ".mean_ns", s.mean);
+}
+
+/**
+ * @brief Spin until @p counter moves past @p previous
+ * @return false after @p timeoutNs
+ */
+bool wait_for_count(const atomic<uint64_t>& counter, uint64_t previous, int64_t timeoutNs)
+{
+    const int64_t deadline = monotonicNowNs() + timeoutNs;
+    while (counter.load(memory_order_acquire) == previous) {
+        if (monotonicNowNs() > deadline) {
+            return false;
+        }
+        this_thread::yield();
+    }
+    return true;
+}
+
+/**
+ * @brief Toggle outPin and time the edge on inPin: kernel timestamp and callback
+ */
+void bench_latency(const BenchOptions& opt, BenchResults& results)
+{
+    cout << "Round trip GPIO" << opt.outPin << " -> GPIO" << opt.inPin
+         << ", " << opt.samples << " samples\n\n";
+
+    Pin out(opt.outPin, PinDirection::OUTPUT);
+    out.write(false);
+
+    atomic<uint64_t> edges{0};
+    atomic<int64_t> kernelNs{0};
+    atomic<int64_t> callbackNs{0};
+    auto& interrupts = InterruptManager::getInstance();
+    interrupts.attachInterruptBatch(opt.inPin, [&](EdgeEventSpan events) {
+        callbackNs.store(monotonicNowNs(), memory_order_relaxed);
+        kernelNs.store(static_cast<int64_t>(events[events.size() - 1].timestampNs), memory_order_relaxed);
+        edges.fetch_add(events.size(), memory_order_release);
+    }, InterruptMode::CHANGE);
+
+    vector<int64_t> toKernel;
+    vector<int64_t> toCallback;
+    toKernel.reserve(static_cast<size_t>(opt.samples));
+    toCallback.reserve(static_cast<size_t>(opt.samples));
+    bool value = false;
+    size_t missed = 0;
+    for (int i = 0; i < opt.samples && running; i++) {
+        const uint64_t before = edges.load(memory_order_acquire);
+        value = !value;
+        const int64_t start = monotonicNowNs();
+        out.write(value);
+        if (!wait_for_count(edges, before, 100000000)) {
+            if (toCallback.empty() && ++missed >= 3) {
+                interrupts.detachInterrupt(opt.inPin);
+                throw runtime_error("No edges on GPIO" + to_string(opt.inPin) +
+                                    "; is it wired to GPIO" + to_string(opt.outPin) + "?");
+            }
+            continue;
+        }
+        toKernel.push_back(kernelNs.load(memory_order_relaxed) - start);
+        toCallback.push_back(callbackNs.load(memory_order_relaxed) - start);
+        this_thread::sleep_for(chrono::microseconds(200));   // Idle line between samples
+    }
+    interrupts.detachInterrupt(opt.inPin);
+
+    SampleSummary kernel = summarize(toKernel);
+    SampleSummary callback = summarize(toCallback);
+    print_summary_header();
+    print_summary("write -> edge timestamp", kernel);
+    print_summary("write -> callback", callback);
+    add_summary(results, "latency.edge", kernel);
+    add_summary(results, "latency.callback", callback);
+}
+
+/**
+ * @brief Backends named by --backend (all of @p all when empty)
+ */
+vector<string> selected_backends(const BenchOptions& opt, const vector<string>& all)
+{
+    if (opt.backend.empty()) {
+        return all;
+    }
+    if (find(all.begin(), all.end(), opt.backend) == all.end()) {
+        string names;
+        for (const string& name : all) {
+            names += (names.empty() ? "" : ", ") + name;
+        }
+        throw invalid_argument("Unknown backend '" + opt.backend + "' (expected " + names + ")");
+    }
+    return {opt.backend};
+}
+
+/**
+ * @brief Deviation of each PWM period from nominal, per backend, from kernel edge timestamps
+ */
+void bench_jitter(const BenchOptions& opt, BenchResults& results)
+{
+    const vector<pair<string, PwmBackend>> all = {
+        {"software", PwmBackend::SOFTWARE}, {"event", PwmBackend::EVENT},
+        {"dma", PwmBackend::DMA}, {"hardware", PwmBackend::HARDWARE}};
+    vector<string> names;
+    for (const auto& entry : all) {
+        names.push_back(entry.first);
+    }
+    const vector<string> wanted = selected_backends(opt, names);
+    const int64_t nominalNs = 1000000000LL / opt.frequencyHz;
+
+    cout << "PWM " << opt.frequencyHz << " Hz on GPIO" << opt.outPin << " -> GPIO" << opt.inPin
+         << ", " << opt.samples << " periods per backend\n\n";
+
+    Pin in(opt.inPin, PinDirection::INPUT);
+    if (!in.enableEdgeEvents()) {
+        throw runtime_error("Cannot enable edge events on GPIO" + to_string(opt.inPin));
+    }
+
+    auto& router = PwmRouter::getInstance();
+    const PwmBackend previous = router.getPreferredBackend();
+    bool printedHeader = false;
+    for (const auto& entry : all) {
+        if (find(wanted.begin(), wanted.end(), entry.first) == wanted.end() || !running) {
+            continue;
+        }
+        bool dmaStarted = false;
+        if (entry.second == PwmBackend::DMA) {
+            // DMA qualifies only when its cycle matches the frequency
+            dmaStarted = DmaSoftPWM::getInstance().begin(static_cast<uint32_t>(nominalNs / 1000));
+        }
+        router.setPreferredBackend(entry.second);
+        PwmBackend used = PwmBackend::AUTO;
+        string reason = "not available on GPIO" + to_string(opt.outPin) + " at " +
+                        to_string(opt.frequencyHz) + " Hz";
+        try {
+            used = router.write(opt.outPin, 128, opt.frequencyHz);
+        } catch (const exception& e) {
+            reason = e.what();
+        }
+        router.setPreferredBackend(previous);
+        if (used != entry.second) {
+            router.stop(opt.outPin);
+            if (dmaStarted) {
+                DmaSoftPWM::getInstance().end();
+            }
+            cout << COLOR_YELLOW << entry.first << ": " << reason << ", skipped" << COLOR_RESET << "\n";
+            continue;
+        }
+
+        // Let the backend settle, then drop what queued meanwhile
+        this_thread::sleep_for(chrono::milliseconds(50));
+        PinEdgeEvent events[64];
+        while (in.waitEdgeEvents(events, 64, 0) > 0) {
+        }
+
+        vector<int64_t> deviation;
+        deviation.reserve(static_cast<size_t>(opt.samples));
+        uint64_t lastRising = 0;
+        const int64_t deadline = monotonicNowNs() + nominalNs * opt.samples * 2 + 1000000000LL;
+        while (deviation.size() < static_cast<size_t>(opt.samples) && running && monotonicNowNs() < deadline) {
+            int count = in.waitEdgeEvents(events, 64, 100000000);
+            for (int i = 0; i < count; i++) {
+                if (!events[i].rising) {
+                    continue;
+                }
+                if (lastRising != 0) {
+                    int64_t period = static_cast<int64_t>(events[i].timestampNs - lastRising);
+                    deviation.push_back(period > nominalNs ? period - nominalNs : nominalNs - period);
+                }
+                lastRising = events[i].timestampNs;
+            }
+        }
+        router.stop(opt.outPin);
+        if (dmaStarted) {
+            DmaSoftPWM::getInstance().end();
+        }
+
+        if (deviation.empty()) {
+            throw runtime_error("No edges on GPIO" + to_string(opt.inPin) +
+                                "; is it wired to GPIO" + to_string(opt.outPin) + "?");
+        }
+        if (!printedHeader) {
+            print_summary_header();
+            printedHeader = true;
+        }
+        SampleSummary summary = summarize(deviation);
+        print_summary(entry.first + " |period error|", summary);
+        add_summary(results, "jitter." + entry.first, summary);
+    }
+}
+
+/**
+ * @brief Writes per second for libgpiod and gpiomem, wire edges per second for DMA
+ */
+void bench_throughput(const BenchOptions& opt, BenchResults& results)
+{
+    const vector<string> wanted = selected_backends(opt, {"libgpiod", "gpiomem", "dma"});
+    const int BATCH = 1000;
+    const int64_t durationNs = static_cast<int64_t>(opt.seconds * 1e9);
+
+    cout << "Toggling GPIO" << opt.outPin << " for " << opt.seconds << " s per backend\n\n";
+    cout << COLOR_BOLD << left << setw(12) << "backend" << right << setw(16) << "toggles/s"
+         << setw(14) << "p50 ns/write" << setw(14) << "p99 ns/write" << COLOR_RESET << "\n";
+
+    for (const string& name : wanted) {
+        if (!running) {
+            break;
+        }
+        if (name == "dma") {
+            // Square wave at the shortest cycle; count edges by kernel sequence
+            // number so events dropped by a full buffer still count
+            auto& dma = DmaSoftPWM::getInstance();
+            const uint32_t stepUs = DMA_SOFT_PWM_DEFAULT_STEP_US;
+            if (!dma.begin(2 * stepUs, stepUs) || !dma.setDutyCycle(opt.outPin, 50.0)) {
+                dma.end();
+                cout << COLOR_YELLOW << left << setw(12) << name << "not available (needs root on a Pi 0-4)"
+                     << COLOR_RESET << right << "\n";
+                continue;
+            }
+            atomic<uint64_t> firstSeqno{0};
+            atomic<uint64_t> lastSeqno{0};
+            atomic<int64_t> firstNs{0};
+            atomic<int64_t> lastNs{0};
+            auto& interrupts = InterruptManager::getInstance();
+            interrupts.attachInterruptBatch(opt.inPin, [&](EdgeEventSpan events) {
+                const EdgeEvent& last = events[events.size() - 1];
+                if (firstSeqno.load(memory_order_relaxed) == 0) {
+                    firstSeqno.store(events[0].lineSeqno, memory_order_relaxed);
+                    firstNs.store(static_cast<int64_t>(events[0].timestampNs), memory_order_relaxed);
+                }
+                lastSeqno.store(last.lineSeqno, memory_order_relaxed);
+                lastNs.store(static_cast<int64_t>(last.timestampNs), memory_order_relaxed);
+            }, InterruptMode::CHANGE, 1024);
+            this_thread::sleep_for(chrono::nanoseconds(durationNs));
+            interrupts.detachInterrupt(opt.inPin);
+            dma.end();
+
+            const int64_t spanNs = lastNs.load() - firstNs.load();
+            if (spanNs <= 0) {
+                throw runtime_error("No edges on GPIO" + to_string(opt.inPin) +
+                                    "; is it wired to GPIO" + to_string(opt.outPin) + "?");
+            }
+            double rate = static_cast<double>(lastSeqno.load() - firstSeqno.load()) * 1e9 /
+                          static_cast<double>(spanNs);
+            cout << left << setw(12) << name << right << setw(16) << fixed << setprecision(0) << rate
+                 << setw(14) << "-" << setw(14) << "-" << "   (on the wire, CPU idle)\n";
+            results.emplace_back("throughput.dma.toggles_per_s", rate);
+            continue;
+        }
+
+        const PinBackend backend = name == "gpiomem" ? PinBackend::GPIOMEM : PinBackend::LIBGPIOD;
+        Pin pin(opt.outPin, PinDirection::OUTPUT, "gpiochip0", backend);
+        if (pin.getBackend() != backend) {
+            cout << COLOR_YELLOW << left << setw(12) << name << "not available (no /dev/gpiomem layout)"
+                 << COLOR_RESET << right << "\n";
+            continue;
+        }
+        vector<int64_t> perWrite;
+        uint64_t writes = 0;
+        bool value = false;
+        const int64_t start = monotonicNowNs();
+        int64_t now = start;
+        while (now - start < durationNs && running) {
+            const int64_t batchStart = now;
+            for (int i = 0; i < BATCH; i++) {
+                value = !value;
+                pin.write(value);
+            }
+            now = monotonicNowNs();
+            perWrite.push_back((now - batchStart) / BATCH);
+            writes += BATCH;
+        }
+        pin.write(false);
+        double rate = static_cast<double>(writes) * 1e9 / static_cast<double>(max<int64_t>(now - start, 1));
+        SampleSummary summary = summarize(perWrite);
+        cout << left << setw(12) << name << right << setw(16) << fixed << setprecision(0) << rate
+             << setw(14) << summary.p50 << setw(14) << summary.p99 << "\n";
+        results.emplace_back("throughput." + name + ".toggles_per_s", rate);
+        results.emplace_back("throughput." + name + ".p50_ns", static_cast<double>(summary.p50));
+        results.emplace_back("throughput." + name + ".p99_ns", static_cast<double>(summary.p99));
+    }
+}
+
+bool save_baseline(const string& path, const BenchResults& results)
+{
+    ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "# pipinpp bench baseline: " << PlatformInfo::instance().getPlatformName() << "\n";
+    file << setprecision(12);
+    for (const auto& entry : results) {
+        file << entry.first << " " << entry.second << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+void compare_baseline(const string& path, const BenchResults& results)
+{
+    ifstream file(path);
+    if (!file) {
+        throw runtime_error("Cannot read baseline " + path);
+    }
+    std::map<string, double> baseline;
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream fields(line);
+        string key;
+        double value;
+        if (fields >> key >> value) {
+            baseline[key] = value;
+        }
+    }
+
+    cout << "\n" << COLOR_BOLD << "Compared with " << path << ":\n" << COLOR_RESET;
+    cout << COLOR_BOLD << left << setw(36) << "metric" << right << setw(14) << "baseline"
+         << setw(14) << "now" << setw(10) << "change" << COLOR_RESET << "\n";
+    for (const auto& entry : results) {
+        auto it = baseline.find(entry.first);
+        if (it == baseline.end()) {
+            continue;
+        }
+        // Latencies should go down, rates up
+        const bool higherIsBetter = entry.first.find("per_s") != string::npos;
+        const double change = it->second != 0.0 ? (entry.second - it->second) / it->second * 100.0 : 0.0;
+        const bool worse = higherIsBetter ? change < -10.0 : change > 10.0;
+        const bool better = higherIsBetter ? change > 10.0 : change < -10.0;
+        cout << left << setw(36) << entry.first << right << fixed << setprecision(0)
+             << setw(14) << it->second << setw(14) << entry.second
+             << (worse ? COLOR_RED : better ? COLOR_GREEN : "")
+             << setw(9) << setprecision(1) << showpos << change << "%" << noshowpos << COLOR_RESET << "\n";
+    }
+}
+
+void cmd_bench(const string& kind, const BenchOptions& opt)
+{
+    signal(SIGINT, signal_handler);
+    BenchResults results;
+    if (kind == "latency") {
+        bench_latency(opt, results);
+    } else if (kind == "jitter") {
+        bench_jitter(opt, results);
+    } else if (kind == "throughput") {
+        bench_throughput(opt, results);
+    } else {
+        throw invalid_argument("Unknown bench '" + kind + "' (expected latency, jitter or throughput)");
+    }
+
+    if (!opt.savePath.empty()) {
+        if (!save_baseline(opt.savePath, results)) {
+            throw runtime_error("Cannot write baseline " + opt.savePath);
+        }
+        cout << "\nBaseline saved to " << opt.savePath << "\n";
+    }
+    if (!opt.comparePath.empty()) {
+        compare_baseline(opt.comparePath, results);
     }
 }
 
@@ -476,12 +1344,77 @@ void cmd_doctor()
     cout << "Default GPIO chip: " << platform.getDefaultGPIOChip() << endl;
     cout << "Default I2C bus: /dev/i2c-" << platform.getDefaultI2CBus() << endl;
 
+    cout << "\nTiming:\n";
+    for (const TimingCheck& check : TimingGuard().check()) {
+        if (!check.available) {
+            cout << COLOR_YELLOW << "- " << COLOR_RESET << check.name << ": " << check.detail << endl;
+        } else {
+            printCheck(check.name + ": " + check.detail, check.ok, "sudo pipinpp tune");
+        }
+    }
+
     cout << "\nTips:\n";
     cout << " - Run ./install.sh to install libgpiod 2.2.1 automatically\n";
     cout << " - Use pipinpp info to print board detection details\n";
     cout << " - Enable I2C/SPI via raspi-config if you use those peripherals\n";
 }
 
+int cmd_tune(const TimingGuardOptions& options, const vector<string>& command)
+{
+    TimingGuard guard(options);
+    TimingGuardStatus status = guard.apply();
+
+    auto printPart = [](const string& label, bool requested, bool granted) {
+        if (requested) {
+            cout << (granted ? COLOR_GREEN + string("✓ ") : COLOR_RED + string("✗ ")) << COLOR_RESET << label << endl;
+        }
+    };
+    printPart("performance governor", options.performanceGovernor, status.governorGranted);
+    printPart("CPU latency limit " + to_string(options.maxLatencyUs) + " us", options.maxLatencyUs >= 0,
+              status.latencyGranted);
+    printPart(to_string(status.steeredIrqs.size()) + " IRQs moved to CPU " + to_string(options.irqCpu),
+              options.irqCpu >= 0, status.irqGranted);
+    if (!status.granted()) {
+        cout << COLOR_YELLOW << status.message << COLOR_RESET << endl;
+    }
+
+    int exitCode = 0;
+    if (command.empty()) {
+        signal(SIGINT, signal_handler);
+        signal(SIGTERM, signal_handler);
+        cout << "Holding settings. Press Ctrl+C to restore...\n";
+        while (running) {
+            delay(200);
+        }
+    } else {
+        pid_t child = fork();
+        if (child == 0) {
+            vector<char*> args;
+            for (const string& arg : command) {
+                args.push_back(const_cast<char*>(arg.c_str()));
+            }
+            args.push_back(nullptr);
+            execvp(args[0], args.data());
+            cerr << "Cannot run " << command[0] << ": " << strerror(errno) << endl;
+            _exit(127);
+        }
+        if (child < 0) {
+            cerr << COLOR_RED << "fork failed: " << strerror(errno) << COLOR_RESET << endl;
+            return 1;
+        }
+        // Ctrl+C goes to the command; the settings are restored once it exits
+        signal(SIGINT, SIG_IGN);
+        int waitStatus = 0;
+        while (waitpid(child, &waitStatus, 0) < 0 && errno == EINTR) {
+        }
+        exitCode = WIFEXITED(waitStatus) ? WEXITSTATUS(waitStatus) : 128 + WTERMSIG(waitStatus);
+    }
+
+    guard.restore();
+    cout << "Settings restored.\n";
+    return exitCode;
+}
+
 int main(int argc, char* argv[]) 
 {
     if (argc < 2) {
@@ -492,6 +1425,9 @@ int main(int argc, char* argv[])
     
     string command = argv[1];
     
+    // Detection results are reused until reboot or kernel change
+    PlatformInfo::instance().setCachePath(platformDefaultCachePath());
+    
     try {
         if (command == "help" || command == "--help" || command == "-h") {
             print_banner();
@@ -501,7 +1437,7 @@ int main(int argc, char* argv[])
             cmd_version();
         }
         else if (command == "info") {
-            cmd_info();
+            cmd_info(argc >= 3 && string(argv[2]) == "--refresh");
         }
         else if (command == "read") {
             if (argc < 3) {
@@ -543,11 +1479,71 @@ int main(int argc, char* argv[])
         }
         else if (command == "monitor") {
             if (argc < 3) {
-                cerr << "Usage: pipinpp monitor <pin> [interval_ms]\n";
+                cerr << "Usage: pipinpp monitor <pin[,pin...]> [--vcd FILE] [--bin FILE] [--quiet]\n";
+                return 1;
+            }
+            MonitorOptions opt;
+            opt.pins = parse_pin_list(argv[2]);
+            for (int i = 3; i < argc; i++) {
+                string arg = argv[i];
+                if (arg == "--quiet" || arg == "-q") {
+                    opt.quiet = true;
+                } else if ((arg == "--vcd" || arg == "--bin") && i + 1 < argc) {
+                    (arg == "--vcd" ? opt.vcdPath : opt.binPath) = argv[++i];
+                } else if (isdigit(static_cast<unsigned char>(arg[0]))) {
+                    // Former polling interval: edges are now reported as they happen
+                    cerr << COLOR_YELLOW << "Note: interval argument ignored (monitor is event-driven)"
+                         << COLOR_RESET << "\n";
+                } else {
+                    cerr << "Unknown option: " << arg << "\n";
+                    return 1;
+                }
+            }
+            cmd_monitor(opt);
+        }
+        else if (command == "capture") {
+            const string subcmd = argc >= 3 ? argv[2] : "";
+            if (subcmd == "record" && argc >= 5) {
+                CaptureCliOptions opt;
+                opt.session.pins = parse_pin_list(argv[3]);
+                opt.session.path = argv[4];
+                for (int i = 5; i < argc; i++) {
+                    string arg = argv[i];
+                    if (arg == "--stop-when-full") {
+                        opt.session.stopWhenFull = true;
+                    } else if (arg == "--capacity" && i + 1 < argc) {
+                        opt.session.capacity = strtoull(argv[++i], nullptr, 10);
+                    } else if (arg == "--seconds" && i + 1 < argc) {
+                        opt.seconds = atof(argv[++i]);
+                    } else {
+                        cerr << "Unknown option: " << arg << "\n";
+                        return 1;
+                    }
+                }
+                cmd_capture_record(opt);
+            }
+            else if (subcmd == "convert" && argc >= 5) {
+                uint64_t sampleRate = 1000000;
+                for (int i = 5; i < argc; i++) {
+                    string arg = argv[i];
+                    if (arg == "--samplerate" && i + 1 < argc) {
+                        sampleRate = strtoull(argv[++i], nullptr, 10);
+                    } else {
+                        cerr << "Unknown option: " << arg << "\n";
+                        return 1;
+                    }
+                }
+                cmd_capture_convert(argv[3], argv[4], sampleRate);
+            }
+            else if (subcmd == "info" && argc >= 4) {
+                cmd_capture_info(argv[3]);
+            }
+            else {
+                cerr << "Usage: pipinpp capture record <pin[,pin...]> <file> [--capacity N] [--seconds S] [--stop-when-full]\n";
+                cerr << "       pipinpp capture convert <file> <out.vcd|out.sr> [--samplerate HZ]\n";
+                cerr << "       pipinpp capture info <file>\n";
                 return 1;
             }
-            int interval = (argc >= 4) ? atoi(argv[3]) : 10;
-            cmd_monitor(atoi(argv[2]), interval);
         }
         else if (command == "pwm") {
             if (argc < 4) {
@@ -564,7 +1560,23 @@ int main(int argc, char* argv[])
             }
             string subcmd = argv[2];
             if (subcmd == "scan") {
-                cmd_i2c_scan();
+                vector<int> buses;
+                bool allBuses = false;
+                bool cached = false;
+                bool refresh = false;
+                for (int i = 3; i < argc; i++) {
+                    string arg = argv[i];
+                    if (arg == "all") {
+                        allBuses = true;
+                    } else if (arg == "--cached") {
+                        cached = true;
+                    } else if (arg == "--refresh") {
+                        refresh = true;
+                    } else {
+                        buses.push_back(atoi(argv[i]));
+                    }
+                }
+                cmd_i2c_scan(buses, allBuses, cached, refresh);
             }
             else if (subcmd == "read") {
                 if (argc < 5) {
@@ -593,11 +1605,69 @@ int main(int argc, char* argv[])
             }
         }
         else if (command == "benchmark") {
-            cmd_benchmark();
+            bool useGpiomem = (argc >= 3 && string(argv[2]) == "gpiomem");
+            cmd_benchmark(useGpiomem);
+        }
+        else if (command == "bench") {
+            if (argc < 3) {
+                cerr << "Usage: pipinpp bench <latency|jitter|throughput> [options]\n";
+                cerr << "Options: --out N --in N --samples N --freq HZ --seconds S\n";
+                cerr << "         --backend NAME --save FILE --compare FILE\n";
+                return 1;
+            }
+            BenchOptions opt;
+            for (int i = 3; i < argc; i++) {
+                string arg = argv[i];
+                if (i + 1 >= argc) {
+                    cerr << "Missing value for " << arg << "\n";
+                    return 1;
+                }
+                string value = argv[++i];
+                if (arg == "--out") {
+                    opt.outPin = atoi(value.c_str());
+                } else if (arg == "--in") {
+                    opt.inPin = atoi(value.c_str());
+                } else if (arg == "--samples") {
+                    opt.samples = max(2, atoi(value.c_str()));
+                } else if (arg == "--freq") {
+                    opt.frequencyHz = max(1, atoi(value.c_str()));
+                } else if (arg == "--seconds") {
+                    opt.seconds = max(0.1, atof(value.c_str()));
+                } else if (arg == "--backend") {
+                    opt.backend = value;
+                } else if (arg == "--save") {
+                    opt.savePath = value;
+                } else if (arg == "--compare") {
+                    opt.comparePath = value;
+                } else {
+                    cerr << "Unknown option: " << arg << "\n";
+                    return 1;
+                }
+            }
+            cmd_bench(argv[2], opt);
         }
         else if (command == "doctor") {
             cmd_doctor();
         }
+        else if (command == "tune") {
+            TimingGuardOptions options;
+            vector<string> child;
+            for (int i = 2; i < argc; i++) {
+                string arg = argv[i];
+                if (arg == "--") {
+                    child.assign(argv + i + 1, argv + argc);
+                    break;
+                } else if (arg == "--keep-governor") {
+                    options.performanceGovernor = false;
+                } else if ((arg == "--latency" || arg == "--irq-cpu") && i + 1 < argc) {
+                    (arg == "--latency" ? options.maxLatencyUs : options.irqCpu) = atoi(argv[++i]);
+                } else {
+                    cerr << "Usage: pipinpp tune [--latency US] [--irq-cpu N] [--keep-governor] [-- command...]\n";
+                    return 1;
+                }
+            }
+            return cmd_tune(options, child);
+        }
         else {
             cerr << COLOR_RED << "Unknown command: " << command << COLOR_RESET << "\n\n";
             print_usage();
@@ -0,0 +1,91 @@
+/**
+ * @file pipinppd.cpp
+ * @brief PiPinPP GPIO sharing daemon
+ *
+ * Owns the GPIO lines and serves them to PiPinPP programs that call
+ * GpioDaemonClient::getInstance().connect(), so several processes can
+ * use the same pins (see gpio_daemon.hpp).
+ *
+ * Usage:
+ *   pipinppd [--socket <path>] [--mode <octal>]
+ *
+ *   --socket <path>  Unix socket to listen on (default /run/pipinppd.sock)
+ *   --mode <octal>   Socket permissions (default 0660: owner and group)
+ *
+ * Runs in the foreground until SIGINT or SIGTERM; clients' lines are
+ * released on exit.
+ *
+ * @copyright Copyright (c) 2025 PiPinPP Project
+ * @license MIT License
+ */
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <pthread.h>
+
+#include "gpio_daemon.hpp"
+
+using namespace std;
+using namespace pipinpp;
+
+static void print_usage()
+{
+    cout << "Usage: pipinppd [--socket <path>] [--mode <octal>]\n"
+         << "  --socket <path>  Unix socket to listen on (default " << DEFAULT_DAEMON_SOCKET << ")\n"
+         << "  --mode <octal>   Socket permissions (default 0660)\n";
+}
+
+int main(int argc, char* argv[])
+{
+    string socketPath = DEFAULT_DAEMON_SOCKET;
+    unsigned int mode = 0660;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return 0;
+        }
+        else if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        }
+        else if (arg == "--mode" && i + 1 < argc) {
+            char* end = nullptr;
+            unsigned long value = strtoul(argv[++i], &end, 8);
+            if (!end || *end != '\0' || value > 0777) {
+                cerr << "Invalid mode: " << argv[i] << "\n";
+                return 1;
+            }
+            mode = static_cast<unsigned int>(value);
+        }
+        else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    // Block the signals in every thread; the main thread waits for them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    GpioDaemon daemon(socketPath);
+    daemon.setSocketMode(mode);
+    if (!daemon.start()) {
+        cerr << "pipinppd: cannot listen on " << socketPath << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    cout << "pipinppd: serving GPIO on " << socketPath << endl;
+
+    int signal = 0;
+    sigwait(&signals, &signal);
+
+    cout << "pipinppd: " << strsignal(signal) << ", releasing lines" << endl;
+    daemon.stop();
+    return 0;
+}